@@ -0,0 +1,237 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "../src/core/Console.h"
+#include "../src/core/ContentFiltersManager.h"
+#include "../src/core/SessionsManager.h"
+#include "../src/core/SettingsManager.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtWidgets/QApplication>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace Otter;
+
+struct Request final
+{
+	QUrl baseUrl;
+	QUrl requestUrl;
+	NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+};
+
+QVector<Request> loadCorpus(const QString &path)
+{
+	const QHash<QString, NetworkManager::ResourceType> resourceTypes({{QLatin1String("document"), NetworkManager::MainFrameType}, {QLatin1String("subdocument"), NetworkManager::SubFrameType}, {QLatin1String("popup"), NetworkManager::PopupType}, {QLatin1String("stylesheet"), NetworkManager::StyleSheetType}, {QLatin1String("script"), NetworkManager::ScriptType}, {QLatin1String("image"), NetworkManager::ImageType}, {QLatin1String("object"), NetworkManager::ObjectType}, {QLatin1String("object-subrequest"), NetworkManager::ObjectSubrequestType}, {QLatin1String("xmlhttprequest"), NetworkManager::XmlHttpRequestType}, {QLatin1String("websocket"), NetworkManager::WebSocketType}});
+	QVector<Request> requests;
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return requests;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd())
+	{
+		const QString line(stream.readLine().trimmed());
+
+		if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+		{
+			continue;
+		}
+
+		const QStringList fields(line.split(QLatin1Char('\t')));
+
+		if (fields.count() < 3)
+		{
+			continue;
+		}
+
+		Request request;
+		request.baseUrl = QUrl(fields.at(0));
+		request.requestUrl = QUrl(fields.at(1));
+		request.resourceType = resourceTypes.value(fields.at(2), NetworkManager::OtherType);
+
+		requests.append(request);
+	}
+
+	return requests;
+}
+
+qint64 getPercentile(const QVector<qint64> &samples, int percentile)
+{
+	if (samples.isEmpty())
+	{
+		return 0;
+	}
+
+	return samples.at(qMin((samples.count() - 1), ((samples.count() * percentile) / 100)));
+}
+
+QString formatLatencies(const QString &title, QVector<qint64> samples)
+{
+	std::sort(samples.begin(), samples.end());
+
+	return QStringLiteral("%1: p50 %2 us, p90 %3 us, p99 %4 us, max %5 us (%6 samples)").arg(title).arg(getPercentile(samples, 50) / 1000.0, 0, 'f', 2).arg(getPercentile(samples, 90) / 1000.0, 0, 'f', 2).arg(getPercentile(samples, 99) / 1000.0, 0, 'f', 2).arg((samples.isEmpty() ? 0 : samples.last()) / 1000.0, 0, 'f', 2).arg(samples.count());
+}
+
+QString getPeakMemory()
+{
+#ifdef Q_OS_UNIX
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef Q_OS_MACOS
+		return QStringLiteral("%1 KiB").arg(usage.ru_maxrss / 1024);
+#else
+		return QStringLiteral("%1 KiB").arg(usage.ru_maxrss);
+#endif
+	}
+#endif
+
+	return QLatin1String("unknown");
+}
+
+int main(int argc, char *argv[])
+{
+	QApplication application(argc, argv);
+	application.setApplicationName(QLatin1String("otter-benchmarks"));
+
+	QCommandLineParser parser;
+	parser.addHelpOption();
+	parser.addOption(QCommandLineOption(QLatin1String("profile"), QLatin1String("Uses <path> as profile directory, rule lists are read from its contentBlocking subdirectory."), QLatin1String("path")));
+	parser.addOption(QCommandLineOption(QLatin1String("corpus"), QLatin1String("Replays requests from <path>, one tab separated first-party URL, request URL and resource type per line."), QLatin1String("path")));
+	parser.addOption(QCommandLineOption(QLatin1String("profiles"), QLatin1String("Comma separated <names> of content blocking profiles to use."), QLatin1String("names")));
+	parser.addOption(QCommandLineOption(QLatin1String("iterations"), QLatin1String("Replays the corpus <amount> times."), QLatin1String("amount"), QLatin1String("1")));
+	parser.addOption(QCommandLineOption(QLatin1String("use-cache"), QLatin1String("Keeps the results cache enabled while replaying.")));
+	parser.process(application);
+
+	QTextStream output(stdout);
+
+	if (!parser.isSet(QLatin1String("profile")) || !parser.isSet(QLatin1String("corpus")) || !parser.isSet(QLatin1String("profiles")))
+	{
+		output << parser.helpText();
+
+		return 1;
+	}
+
+	const QString profilePath(QDir(parser.value(QLatin1String("profile"))).absolutePath());
+	const QVector<Request> requests(loadCorpus(parser.value(QLatin1String("corpus"))));
+
+	if (requests.isEmpty())
+	{
+		output << "Failed to load requests corpus\n";
+
+		return 1;
+	}
+
+	Console::createInstance();
+	SettingsManager::createInstance(profilePath);
+	SessionsManager::createInstance(profilePath, profilePath + QLatin1String("/cache"), false, false);
+
+	const QStringList names(parser.value(QLatin1String("profiles")).split(QLatin1Char(','), QString::SkipEmptyParts));
+
+	SettingsManager::setOption(SettingsManager::ContentBlocking_EnableContentBlockingOption, false);
+	SettingsManager::setOption(SettingsManager::ContentBlocking_ProfilesOption, names);
+
+	if (!parser.isSet(QLatin1String("use-cache")))
+	{
+		SettingsManager::setOption(SettingsManager::ContentBlocking_ResultsCacheLimitOption, 0);
+	}
+
+	ContentFiltersManager::createInstance();
+	ContentFiltersManager::initialize();
+
+	const QVector<int> profiles(ContentFiltersManager::getProfileIdentifiers(names));
+
+	if (profiles.isEmpty())
+	{
+		output << "No content blocking profiles found\n";
+
+		return 1;
+	}
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		ContentFiltersProfile *profile(ContentFiltersManager::getProfile(profiles.at(i)));
+		QElapsedTimer timer;
+		timer.start();
+
+		profile->load();
+
+		while (!profile->isReady() && profile->getError() == ContentFiltersProfile::NoError)
+		{
+			QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+		}
+
+		output << QStringLiteral("Loaded profile %1 in %2 ms\n").arg(profile->getName()).arg(timer.elapsed());
+	}
+
+	const int iterations(qMax(1, parser.value(QLatin1String("iterations")).toInt()));
+	QVector<qint64> checkSamples;
+	checkSamples.reserve(requests.count() * iterations);
+
+	QVector<qint64> cosmeticSamples;
+	int blockedAmount(0);
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		for (int j = 0; j < requests.count(); ++j)
+		{
+			const Request &request(requests.at(j));
+			QElapsedTimer timer;
+			timer.start();
+
+			const ContentFiltersManager::CheckResult result(ContentFiltersManager::checkUrl(profiles, request.baseUrl, request.requestUrl, request.resourceType));
+
+			checkSamples.append(timer.nsecsElapsed());
+
+			if (result.isBlocked)
+			{
+				++blockedAmount;
+			}
+
+			if (request.resourceType == NetworkManager::MainFrameType)
+			{
+				timer.restart();
+
+				ContentFiltersManager::getCosmeticFilters(profiles, request.requestUrl);
+
+				cosmeticSamples.append(timer.nsecsElapsed());
+			}
+		}
+	}
+
+	output << formatLatencies(QLatin1String("checkUrl()"), checkSamples) << '\n';
+	output << formatLatencies(QLatin1String("getCosmeticFilters()"), cosmeticSamples) << '\n';
+	output << QStringLiteral("Blocked requests: %1 of %2\n").arg(blockedAmount).arg(checkSamples.count());
+	output << QStringLiteral("Peak memory: %1\n").arg(getPeakMemory());
+
+	return 0;
+}
@@ -0,0 +1,320 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "../src/core/AddonsManager.h"
+#include "../src/core/BookmarksModel.h"
+#include "../src/core/Console.h"
+#include "../src/core/CookieJar.h"
+#include "../src/core/HistoryModel.h"
+#include "../src/core/SessionsManager.h"
+#include "../src/core/SettingsManager.h"
+#include "../src/core/UserScript.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+using namespace Otter;
+
+class DataManagersBenchmark final : public QObject
+{
+	Q_OBJECT
+
+protected:
+	enum BenchmarkParameter
+	{
+		OverridesAmount = 10000,
+		UrlsRotationAmount = 1000
+	};
+
+	static void addAmounts();
+	static QUrl createUrl(int index);
+	static QString createTitle(int index);
+	QString getPath(const QString &name) const;
+
+private:
+	QTemporaryDir m_profileDirectory;
+
+private slots:
+	void initTestCase();
+	void findHistoryEntries_data();
+	void findHistoryEntries();
+	void findBookmarks_data();
+	void findBookmarks();
+	void getOption_data();
+	void getOption();
+	void getCookiesForUrl_data();
+	void getCookiesForUrl();
+	void saveSession_data();
+	void saveSession();
+	void getUserScriptsForUrl_data();
+	void getUserScriptsForUrl();
+};
+
+void DataManagersBenchmark::addAmounts()
+{
+	QTest::addColumn<int>("amount");
+
+	const QByteArray rawAmounts(qgetenv("OTTER_BENCHMARK_AMOUNTS"));
+	const QStringList amounts((rawAmounts.isEmpty() ? QLatin1String("100,1000,10000") : QString::fromLatin1(rawAmounts)).split(QLatin1Char(','), QString::SkipEmptyParts));
+
+	for (int i = 0; i < amounts.count(); ++i)
+	{
+		const int amount(amounts.at(i).trimmed().toInt());
+
+		if (amount > 0)
+		{
+			QTest::newRow(QByteArray::number(amount).constData()) << amount;
+		}
+	}
+}
+
+QUrl DataManagersBenchmark::createUrl(int index)
+{
+	return QUrl(QStringLiteral("https://www%1.example%2.com/section%3/page%4.html?query=%5").arg(index % 10).arg(index % 977).arg(index % 31).arg(index).arg(index * 7));
+}
+
+QString DataManagersBenchmark::createTitle(int index)
+{
+	return QStringLiteral("Example page %1 about topic %2").arg(index).arg(index % 97);
+}
+
+QString DataManagersBenchmark::getPath(const QString &name) const
+{
+	return QDir(m_profileDirectory.path()).filePath(name);
+}
+
+void DataManagersBenchmark::initTestCase()
+{
+	QVERIFY(m_profileDirectory.isValid());
+
+	QSettings overrides(getPath(QLatin1String("override.ini")), QSettings::IniFormat);
+
+	for (int i = 0; i < OverridesAmount; ++i)
+	{
+		overrides.setValue(QStringLiteral("host%1.example.com/Content/DefaultZoom").arg(i), 110);
+
+		if (i % 10 == 0)
+		{
+			overrides.setValue(QStringLiteral("*.example%1.org/Content/DefaultZoom").arg(i), 90);
+		}
+	}
+
+	overrides.sync();
+
+	Console::createInstance();
+	SettingsManager::createInstance(m_profileDirectory.path());
+	SessionsManager::createInstance(m_profileDirectory.path(), getPath(QLatin1String("cache")), false, false);
+}
+
+void DataManagersBenchmark::findHistoryEntries_data()
+{
+	addAmounts();
+}
+
+void DataManagersBenchmark::findHistoryEntries()
+{
+	QFETCH(int, amount);
+
+	HistoryModel model(getPath(QStringLiteral("browsingHistory-%1.dat").arg(amount)), HistoryModel::BrowsingHistory);
+	const QDateTime dateTime(QDateTime::currentDateTimeUtc());
+
+	for (int i = 0; i < amount; ++i)
+	{
+		model.addEntry(createUrl(i), createTitle(i), {}, dateTime.addSecs(-i));
+	}
+
+	QBENCHMARK
+	{
+		model.findEntries(QLatin1String("www3.example1"));
+	}
+}
+
+void DataManagersBenchmark::findBookmarks_data()
+{
+	addAmounts();
+}
+
+void DataManagersBenchmark::findBookmarks()
+{
+	QFETCH(int, amount);
+
+	BookmarksModel model(getPath(QStringLiteral("bookmarks-%1.xbel").arg(amount)), BookmarksModel::BookmarksMode);
+
+	for (int i = 0; i < amount; ++i)
+	{
+		model.addBookmark(BookmarksModel::UrlBookmark, {{BookmarksModel::UrlRole, createUrl(i)}, {BookmarksModel::TitleRole, createTitle(i)}});
+	}
+
+	QBENCHMARK
+	{
+		model.findBookmarks(QLatin1String("www3.example1"));
+	}
+}
+
+void DataManagersBenchmark::getOption_data()
+{
+	QTest::addColumn<QString>("host");
+
+	QTest::newRow("global") << QString();
+	QTest::newRow("override") << QStringLiteral("host%1.example.com").arg(OverridesAmount / 2);
+	QTest::newRow("wildcard") << QLatin1String("www.sub.example50.org");
+	QTest::newRow("missing") << QLatin1String("www.missing.example.net");
+}
+
+void DataManagersBenchmark::getOption()
+{
+	QFETCH(QString, host);
+
+	QBENCHMARK
+	{
+		SettingsManager::getOption(SettingsManager::Content_DefaultZoomOption, host);
+	}
+}
+
+void DataManagersBenchmark::getCookiesForUrl_data()
+{
+	addAmounts();
+}
+
+void DataManagersBenchmark::getCookiesForUrl()
+{
+	QFETCH(int, amount);
+
+	CookieJar cookieJar(getPath(QStringLiteral("cookies-%1.dat").arg(amount)));
+	const QDateTime expirationDate(QDateTime::currentDateTimeUtc().addDays(30));
+
+	for (int i = 0; i < amount; ++i)
+	{
+		QNetworkCookie cookie(QStringLiteral("cookie%1").arg(i).toUtf8(), QByteArray::number(i));
+		cookie.setDomain(createUrl(i).host());
+		cookie.setPath(QLatin1String("/"));
+		cookie.setExpirationDate(expirationDate);
+
+		cookieJar.forceInsertCookie(cookie);
+	}
+
+	int index(0);
+
+	QBENCHMARK
+	{
+		cookieJar.cookiesForUrl(createUrl(index));
+
+		index = ((index + 1) % UrlsRotationAmount);
+	}
+}
+
+void DataManagersBenchmark::saveSession_data()
+{
+	addAmounts();
+}
+
+void DataManagersBenchmark::saveSession()
+{
+	QFETCH(int, amount);
+
+	Session::MainWindow mainWindow;
+	mainWindow.windows.reserve(amount);
+
+	for (int i = 0; i < amount; ++i)
+	{
+		Session::Window::History::Entry entry;
+		entry.url = createUrl(i).toString();
+		entry.title = createTitle(i);
+		entry.time = QDateTime::currentDateTimeUtc();
+
+		Session::Window window;
+		window.history.entries.append(entry);
+		window.history.index = 0;
+
+		mainWindow.windows.append(window);
+	}
+
+	mainWindow.index = 0;
+
+	SessionInformation session;
+	session.path = getPath(QStringLiteral("sessions/benchmark-%1.json").arg(amount));
+	session.title = QLatin1String("Benchmark");
+	session.windows.append(mainWindow);
+	session.index = 0;
+
+	QBENCHMARK
+	{
+		SessionsManager::saveSession(session);
+	}
+}
+
+void DataManagersBenchmark::getUserScriptsForUrl_data()
+{
+	addAmounts();
+}
+
+void DataManagersBenchmark::getUserScriptsForUrl()
+{
+	QFETCH(int, amount);
+
+	const QString scriptsPath(getPath(QLatin1String("scripts")));
+
+	QDir(scriptsPath).removeRecursively();
+
+	QJsonObject metaDataObject;
+
+	for (int i = 0; i < amount; ++i)
+	{
+		const QString name(QStringLiteral("script%1").arg(i));
+		const QString scriptPath(QDir(scriptsPath).filePath(name));
+
+		QDir().mkpath(scriptPath);
+
+		QFile file(QDir(scriptPath).filePath(name + QLatin1String(".js")));
+
+		QVERIFY(file.open(QIODevice::WriteOnly));
+
+		file.write(QStringLiteral("// ==UserScript==\n// @name %1\n// @include https://%2/*\n// ==/UserScript==\n").arg(name, ((i % 20 == 0) ? QStringLiteral("*.example%1.com").arg(i % 977) : createUrl(i).host())).toUtf8());
+		file.close();
+
+		metaDataObject.insert(name, QJsonObject({{QLatin1String("isEnabled"), true}}));
+	}
+
+	QFile metaDataFile(QDir(scriptsPath).filePath(QLatin1String("scripts.json")));
+
+	QVERIFY(metaDataFile.open(QIODevice::WriteOnly));
+
+	metaDataFile.write(QJsonDocument(metaDataObject).toJson(QJsonDocument::Compact));
+	metaDataFile.close();
+
+	AddonsManager::loadUserScripts();
+
+	int index(0);
+
+	QBENCHMARK
+	{
+		UserScript::getUserScriptsForUrl(createUrl(index));
+
+		index = ((index + 1) % UrlsRotationAmount);
+	}
+}
+
+QTEST_MAIN(DataManagersBenchmark)
+
+#include "DataManagersBenchmark.moc"
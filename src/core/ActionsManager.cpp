@@ -279,6 +279,8 @@ bool KeyboardProfile::save()
 ActionsManager* ActionsManager::m_instance(nullptr);
 QMap<int, QVector<QKeySequence> > ActionsManager::m_shortcuts;
 QMultiMap<int, QPair<QVariantMap, QVector<QKeySequence> > > ActionsManager::m_extraShortcuts;
+QHash<QKeySequence, KeyboardProfile::Action> ActionsManager::m_shortcutActions;
+QVector<QKeySequence> ActionsManager::m_allowedShortcuts;
 QVector<QKeySequence> ActionsManager::m_disallowedShortcuts;
 QVector<ActionsManager::ActionDefinition> ActionsManager::m_definitions;
 int ActionsManager::m_actionIdentifierEnumerator(0);
@@ -514,10 +516,10 @@ void ActionsManager::loadProfiles()
 {
 	m_shortcuts.clear();
 	m_extraShortcuts.clear();
+	m_shortcutActions.clear();
+	m_allowedShortcuts.clear();
 
 	const QStringList profiles(SettingsManager::getOption(SettingsManager::Browser_KeyboardShortcutsProfilesOrderOption).toStringList());
-	QVector<QKeySequence> allShortcuts;
-	allShortcuts.reserve(50);
 
 	for (int i = 0; i < profiles.count(); ++i)
 	{
@@ -551,16 +553,20 @@ void ActionsManager::loadProfiles()
 				}
 
 				shortcuts.reserve(shortcuts.count() + definition.shortcuts.count());
-				allShortcuts.reserve(allShortcuts.count() + definition.shortcuts.count());
+
+				KeyboardProfile::Action shortcutAction;
+				shortcutAction.parameters = definition.parameters;
+				shortcutAction.action = definition.action;
 
 				for (int k = 0; k < definition.shortcuts.count(); ++k)
 				{
 					const QKeySequence shortcut(definition.shortcuts.at(k));
 
-					if (!allShortcuts.contains(shortcut))
+					if (!m_shortcutActions.contains(shortcut))
 					{
 						shortcuts.append(shortcut);
-						allShortcuts.append(shortcut);
+
+						m_shortcutActions[shortcut] = shortcutAction;
 					}
 				}
 
@@ -579,6 +585,18 @@ void ActionsManager::loadProfiles()
 		}
 	}
 
+	m_allowedShortcuts.reserve(m_shortcutActions.count());
+
+	QHash<QKeySequence, KeyboardProfile::Action>::const_iterator shortcutActionsIterator;
+
+	for (shortcutActionsIterator = m_shortcutActions.constBegin(); shortcutActionsIterator != m_shortcutActions.constEnd(); ++shortcutActionsIterator)
+	{
+		if (isShortcutAllowed(shortcutActionsIterator.key()))
+		{
+			m_allowedShortcuts.append(shortcutActionsIterator.key());
+		}
+	}
+
 	emit m_instance->shortcutsChanged();
 }
 
@@ -736,6 +754,16 @@ QVector<KeyboardProfile::Action> ActionsManager::getShortcutDefinitions()
 	return definitions;
 }
 
+QVector<QKeySequence> ActionsManager::getAllowedShortcuts()
+{
+	return m_allowedShortcuts;
+}
+
+KeyboardProfile::Action ActionsManager::getShortcutAction(const QKeySequence &shortcut)
+{
+	return m_shortcutActions.value(shortcut);
+}
+
 ActionsManager::ActionDefinition ActionsManager::getActionDefinition(int identifier)
 {
 	if (identifier < 0 || identifier >= m_definitions.count())
@@ -26,6 +26,7 @@
 
 #include <QtCore/QVariantMap>
 #include <QtGui/QIcon>
+#include <QtGui/QKeySequence>
 
 namespace Otter
 {
@@ -380,6 +381,8 @@ public:
 	static QVector<QKeySequence> getActionShortcuts(int identifier, const QVariantMap &parameters = {});
 	static QVector<ActionDefinition> getActionDefinitions();
 	static QVector<KeyboardProfile::Action> getShortcutDefinitions();
+	static QVector<QKeySequence> getAllowedShortcuts();
+	static KeyboardProfile::Action getShortcutAction(const QKeySequence &shortcut);
 	static ActionDefinition getActionDefinition(int identifier);
 	static int getActionIdentifier(const QString &name);
 	static bool isShortcutAllowed(const QKeySequence &shortcut, ShortcutCheck check = AllChecks, bool areSingleKeyShortcutsAllowed = true);
@@ -399,6 +402,8 @@ private:
 	static ActionsManager *m_instance;
 	static QMap<int, QVector<QKeySequence> > m_shortcuts;
 	static QMultiMap<int, QPair<QVariantMap, QVector<QKeySequence> > > m_extraShortcuts;
+	static QHash<QKeySequence, KeyboardProfile::Action> m_shortcutActions;
+	static QVector<QKeySequence> m_allowedShortcuts;
 	static QVector<QKeySequence> m_disallowedShortcuts;
 	static QVector<ActionDefinition> m_definitions;
 	static int m_actionIdentifierEnumerator;
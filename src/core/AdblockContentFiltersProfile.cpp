@@ -23,26 +23,35 @@
 #include "Console.h"
 #include "Job.h"
 #include "SessionsManager.h"
+#include "SettingsManager.h"
+#include "Tracer.h"
 
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
 
 namespace Otter
 {
 
+QHash<QVector<const AdblockContentFiltersProfile*>, std::shared_ptr<const AdblockContentFiltersProfile::MergedIndex> > AdblockContentFiltersProfile::m_mergedIndexes;
+QSet<QVector<const AdblockContentFiltersProfile*> > AdblockContentFiltersProfile::m_pendingMergedIndexes;
+QMutex AdblockContentFiltersProfile::m_mergedIndexesMutex;
 QHash<QString, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_options({{QLatin1String("third-party"), ThirdPartyOption}, {QLatin1String("stylesheet"), StyleSheetOption}, {QLatin1String("image"), ImageOption}, {QLatin1String("script"), ScriptOption}, {QLatin1String("object"), ObjectOption}, {QLatin1String("object-subrequest"), ObjectSubRequestOption}, {QLatin1String("object_subrequest"), ObjectSubRequestOption}, {QLatin1String("subdocument"), SubDocumentOption}, {QLatin1String("xmlhttprequest"), XmlHttpRequestOption}, {QLatin1String("websocket"), WebSocketOption}, {QLatin1String("popup"), PopupOption}, {QLatin1String("elemhide"), ElementHideOption}, {QLatin1String("generichide"), GenericHideOption}});
 QHash<NetworkManager::ResourceType, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
 
 AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &languages, ContentFiltersProfile::ProfileFlags flags, QObject *parent) : ContentFiltersProfile(parent),
-	m_root(nullptr),
 	m_dataFetchJob(nullptr),
+	m_loadingWatcher(nullptr),
 	m_profileSummary(profileSummary),
 	m_error(NoError),
 	m_flags(flags),
+	m_matchingEngine(TrieMatchingEngine),
 	m_wasLoaded(false)
 {
 	if (!languages.isEmpty())
@@ -68,16 +77,32 @@ AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersP
 	loadHeader();
 }
 
+AdblockContentFiltersProfile::~AdblockContentFiltersProfile()
+{
+	if (m_loadingWatcher)
+	{
+		m_loadingWatcher->waitForFinished();
+	}
+
+	removeMergedIndexes(this);
+}
+
 void AdblockContentFiltersProfile::clear()
 {
-	if (!m_wasLoaded)
+	if (m_loadingWatcher)
 	{
-		return;
+		m_loadingWatcher->waitForFinished();
+
+		handleRulesLoaded();
 	}
 
-	if (m_root)
+	std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>());
+
+	removeMergedIndexes(this);
+
+	if (!m_wasLoaded)
 	{
-		QtConcurrent::run(this, &AdblockContentFiltersProfile::deleteNode, m_root);
+		return;
 	}
 
 	m_cosmeticFiltersRules.clear();
@@ -87,6 +112,20 @@ void AdblockContentFiltersProfile::clear()
 	m_wasLoaded = false;
 }
 
+void AdblockContentFiltersProfile::load()
+{
+	if (m_wasLoaded || m_loadingWatcher || !prepareLoading())
+	{
+		return;
+	}
+
+	m_loadingWatcher = new QFutureWatcher<bool>(this);
+
+	connect(m_loadingWatcher, &QFutureWatcher<bool>::finished, this, &AdblockContentFiltersProfile::handleRulesLoaded);
+
+	m_loadingWatcher->setFuture(QtConcurrent::run(this, &AdblockContentFiltersProfile::parseRules));
+}
+
 void AdblockContentFiltersProfile::loadHeader()
 {
 	const QString path(getPath());
@@ -127,7 +166,7 @@ void AdblockContentFiltersProfile::loadHeader()
 	}
 }
 
-void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
+void AdblockContentFiltersProfile::parseRuleLine(const QString &rule, Node *root)
 {
 	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
 	{
@@ -263,7 +302,7 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		}
 	}
 
-	Node *node(m_root);
+	Node *node(root);
 
 	for (int i = 0; i < line.length(); ++i)
 	{
@@ -315,7 +354,22 @@ void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line,
 	}
 }
 
-void AdblockContentFiltersProfile::deleteNode(Node *node) const
+void AdblockContentFiltersProfile::removeStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list)
+{
+	const QStringList domains(line.at(0).split(QLatin1Char(',')));
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		const QMultiHash<QString, QString>::iterator iterator(list.find(domains.at(i), line.at(1)));
+
+		if (iterator != list.end())
+		{
+			list.erase(iterator);
+		}
+	}
+}
+
+void AdblockContentFiltersProfile::deleteNode(Node *node)
 {
 	for (int i = 0; i < node->children.count(); ++i)
 	{
@@ -330,676 +384,2125 @@ void AdblockContentFiltersProfile::deleteNode(Node *node) const
 	delete node;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const
+void AdblockContentFiltersProfile::countRule(const QString &rule, RulesStatistics &statistics, int change)
 {
-	ContentFiltersManager::CheckResult result;
-	ContentFiltersManager::CheckResult currentResult;
+	const QString line(rule.simplified());
 
-	for (int i = 0; i < subString.length(); ++i)
+	if (line.isEmpty() || line.startsWith(QLatin1Char('!')))
 	{
-		const QChar treeChar(subString.at(i));
-		bool childrenExists(false);
+		return;
+	}
 
-		currentResult = evaluateNodeRules(node, currentRule, request);
+	statistics.rulesAmount += change;
 
-		if (currentResult.isBlocked)
-		{
-			result = currentResult;
-		}
-		else if (currentResult.isException)
-		{
-			return currentResult;
-		}
+	if (line.startsWith(QLatin1String("##")))
+	{
+		statistics.genericCosmeticRulesAmount += change;
+	}
+	else if (line.contains(QLatin1String("##")) || line.contains(QLatin1String("#@#")))
+	{
+		statistics.domainCosmeticRulesAmount += change;
+	}
+	else if (line.contains(QLatin1Char('*')))
+	{
+		statistics.wildcardRulesAmount += change;
+	}
+}
 
-		for (int j = 0; j < node->children.count(); ++j)
-		{
-			const Node *nextNode(node->children.at(j));
+void AdblockContentFiltersProfile::compileTrie(const Node *root, Trie &trie)
+{
+	trie = {};
 
-			if (nextNode->value == QLatin1Char('*'))
-			{
-				const QString wildcardSubString(subString.mid(i));
+	QVector<const Node*> nodes({root});
+	QHash<QString, quint32> domains;
 
-				for (int k = 0; k < wildcardSubString.length(); ++k)
-				{
-					currentResult = checkUrlSubstring(nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
+	trie.nodes.append(Trie::Node());
 
-					if (currentResult.isBlocked)
-					{
-						result = currentResult;
-					}
-					else if (currentResult.isException)
-					{
-						return currentResult;
-					}
-				}
-			}
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		const Node *node(nodes.at(i));
+		Trie::Node compiledNode;
+		compiledNode.value = node->value;
+		compiledNode.firstChild = static_cast<quint32>(trie.nodes.count());
+		compiledNode.childrenAmount = static_cast<quint16>(qMin(node->children.count(), 0xFFFF));
+		compiledNode.firstRule = static_cast<quint32>(trie.rules.count());
+		compiledNode.rulesAmount = static_cast<quint16>(qMin(node->rules.count(), 0xFFFF));
 
-			if (nextNode->value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
-			{
-				currentResult = checkUrlSubstring(nextNode, subString.mid(i), currentRule, request);
+		for (int j = 0; j < compiledNode.childrenAmount; ++j)
+		{
+			nodes.append(node->children.at(j));
 
-				if (currentResult.isBlocked)
-				{
-					result = currentResult;
-				}
-				else if (currentResult.isException)
-				{
-					return currentResult;
-				}
-			}
+			trie.nodes.append(Trie::Node());
+		}
 
-			if (nextNode->value == treeChar)
+		for (int j = 0; j < compiledNode.rulesAmount; ++j)
+		{
+			const Node::Rule *rule(node->rules.at(j));
+			Trie::Rule compiledRule;
+			compiledRule.textPosition = static_cast<quint32>(trie.texts.length());
+			compiledRule.textLength = static_cast<quint32>(rule->rule.length());
+			compiledRule.firstDomain = static_cast<quint32>(trie.ruleDomains.count());
+			compiledRule.blockedDomainsAmount = static_cast<quint16>(qMin(rule->blockedDomains.count(), 0xFFFF));
+			compiledRule.allowedDomainsAmount = static_cast<quint16>(qMin(rule->allowedDomains.count(), 0xFFFF));
+			compiledRule.ruleOptions = rule->ruleOptions;
+			compiledRule.ruleExceptions = rule->ruleExceptions;
+			compiledRule.ruleMatch = rule->ruleMatch;
+			compiledRule.isException = rule->isException;
+			compiledRule.needsDomainCheck = rule->needsDomainCheck;
+
+			trie.texts.append(rule->rule);
+
+			const QStringList ruleDomains(rule->blockedDomains.mid(0, compiledRule.blockedDomainsAmount) + rule->allowedDomains.mid(0, compiledRule.allowedDomainsAmount));
+
+			for (int k = 0; k < ruleDomains.count(); ++k)
 			{
-				node = nextNode;
+				if (!domains.contains(ruleDomains.at(k)))
+				{
+					domains[ruleDomains.at(k)] = static_cast<quint32>(trie.domains.count());
 
-				childrenExists = true;
+					trie.domains.append(ruleDomains.at(k));
+				}
 
-				break;
+				trie.ruleDomains.append(domains.value(ruleDomains.at(k)));
 			}
-		}
 
-		if (!childrenExists)
-		{
-			return result;
+			trie.rules.append(compiledRule);
 		}
 
-		currentRule += treeChar;
+		trie.nodes[i] = compiledNode;
 	}
 
-	currentResult = evaluateNodeRules(node, currentRule, request);
+	trie.nodes.squeeze();
+	trie.rules.squeeze();
+	trie.ruleDomains.squeeze();
+	trie.texts.squeeze();
+}
 
-	if (currentResult.isBlocked)
-	{
-		result = currentResult;
-	}
-	else if (currentResult.isException)
+void AdblockContentFiltersProfile::collectRules(const Trie &trie, quint32 node, QString &pattern, QVector<TokenIndex::Entry> &entries)
+{
+	const Trie::Node &compiledNode(trie.getNode(static_cast<int>(node)));
+
+	for (quint32 i = compiledNode.firstRule; i < (compiledNode.firstRule + compiledNode.rulesAmount); ++i)
 	{
-		return currentResult;
+		TokenIndex::Entry entry;
+		entry.pattern = pattern;
+		entry.trie = &trie;
+		entry.rule = &trie.getRule(static_cast<int>(i));
+
+		entries.append(entry);
 	}
 
-	for (int i = 0; i < node->children.count(); ++i)
+	for (quint32 i = compiledNode.firstChild; i < (compiledNode.firstChild + compiledNode.childrenAmount); ++i)
 	{
-		if (node->children.at(i)->value == QLatin1Char('^'))
-		{
-			currentResult = evaluateNodeRules(node, currentRule, request);
+		pattern.append(trie.getNode(static_cast<int>(i)).value);
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
-		}
-	}
+		collectRules(trie, i, pattern, entries);
 
-	return result;
+		pattern.chop(1);
+	}
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const
+void AdblockContentFiltersProfile::buildTokenIndex(const QVector<const Trie*> &tries, TokenIndex &tokenIndex)
 {
-	switch (rule->ruleMatch)
-	{
-		case StartMatch:
-			if (!request.requestUrl.startsWith(currentRule))
-			{
-				return {};
-			}
+	tokenIndex = {};
 
-			break;
-		case EndMatch:
-			if (!request.requestUrl.endsWith(currentRule))
-			{
-				return {};
-			}
+	QVector<TokenIndex::Entry> rules;
 
-			break;
-		case ExactMatch:
-			if (request.requestUrl != currentRule)
-			{
-				return {};
-			}
+	for (int i = 0; i < tries.count(); ++i)
+	{
+		if (!tries.at(i) || tries.at(i)->isEmpty())
+		{
+			continue;
+		}
 
-			break;
-		default:
-			if (!request.requestUrl.contains(currentRule))
-			{
-				return {};
-			}
+		const int first(rules.count());
+		QString pattern;
 
-			break;
-	}
+		collectRules(*tries.at(i), 0, pattern, rules);
 
-	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
+		for (int j = first; j < rules.count(); ++j)
+		{
+			rules[j].profile = i;
+		}
+	}
 
-	if (rule->needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
+	if (rules.isEmpty())
 	{
-		return {};
+		return;
 	}
 
-	const bool hasBlockedDomains(!rule->blockedDomains.isEmpty());
-	const bool hasAllowedDomains(!rule->allowedDomains.isEmpty());
-	bool isBlocked(true);
+	QVector<QVector<TokenIndex::Token> > rulesTokens;
+	rulesTokens.reserve(rules.count());
 
-	if (hasBlockedDomains)
+	QHash<quint32, int> tokensAmount;
+
+	for (int i = 0; i < rules.count(); ++i)
 	{
-		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
+		const QVector<TokenIndex::Token> tokens(tokenizePattern(rules.at(i).pattern, rules.at(i).rule));
 
-		if (!isBlocked)
+		for (int j = 0; j < tokens.count(); ++j)
 		{
-			return {};
+			++tokensAmount[tokens.at(j).hash];
 		}
+
+		rulesTokens.append(tokens);
 	}
 
-	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
+	QVector<QPair<quint32, TokenIndex::Entry> > indexedEntries;
+	indexedEntries.reserve(rules.count());
 
-	if (rule->ruleOptions.testFlag(ThirdPartyOption) || rule->ruleExceptions.testFlag(ThirdPartyOption))
+	for (int i = 0; i < rules.count(); ++i)
 	{
-		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
-		{
-			isBlocked = rule->ruleExceptions.testFlag(ThirdPartyOption);
-		}
-		else if (!hasBlockedDomains && !hasAllowedDomains)
+		const QVector<TokenIndex::Token> &tokens(rulesTokens.at(i));
+		TokenIndex::Entry entry(rules.at(i));
+
+		if (tokens.isEmpty())
 		{
-			isBlocked = rule->ruleOptions.testFlag(ThirdPartyOption);
+			tokenIndex.untokenizedEntries.append(entry);
+
+			continue;
 		}
-	}
 
-	if (rule->ruleOptions != NoOption || rule->ruleExceptions != NoOption)
-	{
-		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
+		int bestToken(0);
 
-		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
+		for (int j = 1; j < tokens.count(); ++j)
 		{
-			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
+			const int amount(tokensAmount.value(tokens.at(j).hash));
+			const int bestAmount(tokensAmount.value(tokens.at(bestToken).hash));
 
-			if (rule->ruleOptions.testFlag(iterator.value()) || (supportsException && rule->ruleExceptions.testFlag(iterator.value())))
+			if (amount < bestAmount || (amount == bestAmount && tokens.at(j).length > tokens.at(bestToken).length))
 			{
-				if (request.resourceType == iterator.key())
-				{
-					isBlocked = (isBlocked ? rule->ruleOptions.testFlag(iterator.value()) : isBlocked);
-				}
-				else if (supportsException)
-				{
-					isBlocked = (isBlocked ? rule->ruleExceptions.testFlag(iterator.value()) : isBlocked);
-				}
-				else
-				{
-					isBlocked = false;
-				}
+				bestToken = j;
 			}
 		}
+
+		entry.tokenOffset = tokens.at(bestToken).position;
+
+		indexedEntries.append({tokens.at(bestToken).hash, entry});
 	}
-	else if (request.resourceType == NetworkManager::PopupType)
+
+	std::sort(indexedEntries.begin(), indexedEntries.end(), [&](const QPair<quint32, TokenIndex::Entry> &first, const QPair<quint32, TokenIndex::Entry> &second)
 	{
-		isBlocked = false;
+		return (first.first < second.first);
+	});
+
+	int capacity(16);
+
+	while (capacity < (tokensAmount.count() * 2))
+	{
+		capacity *= 2;
 	}
 
-	if (isBlocked)
+	tokenIndex.slots.resize(capacity);
+	tokenIndex.entries.reserve(indexedEntries.count());
+
+	const int mask(capacity - 1);
+	int slot(-1);
+
+	for (int i = 0; i < indexedEntries.count(); ++i)
 	{
-		ContentFiltersManager::CheckResult result;
-		result.rule = rule->rule;
+		const quint32 hash(indexedEntries.at(i).first);
 
-		if (rule->isException)
+		if (i == 0 || indexedEntries.at(i - 1).first != hash)
 		{
-			result.isBlocked = false;
-			result.isException = true;
+			slot = static_cast<int>(hash & static_cast<quint32>(mask));
 
-			if (rule->ruleOptions.testFlag(ElementHideOption))
-			{
-				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
-			}
-			else if (rule->ruleOptions.testFlag(GenericHideOption))
+			while (tokenIndex.slots.at(slot).hash != 0)
 			{
-				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
+				slot = ((slot + 1) & mask);
 			}
 
-			return result;
+			tokenIndex.slots[slot].hash = hash;
+			tokenIndex.slots[slot].first = i;
 		}
 
-		result.isBlocked = true;
+		++tokenIndex.slots[slot].amount;
 
-		return result;
+		tokenIndex.entries.append(indexedEntries.at(i).second);
 	}
 
-	return {};
+	tokenIndex.untokenizedEntries.squeeze();
 }
 
-void AdblockContentFiltersProfile::raiseError(const QString &message, ProfileError error)
+void AdblockContentFiltersProfile::buildElementHideIndex(const Trie &trie, ElementHideIndex &elementHideIndex)
 {
-	m_error = error;
+	elementHideIndex = {};
 
-	Console::addMessage(message, Console::OtherCategory, Console::ErrorLevel, getPath());
+	for (int i = 0; i < trie.getRulesAmount(); ++i)
+	{
+		const Trie::Rule &rule(trie.getRule(i));
 
-	emit profileModified();
+		if (!rule.isException || (!rule.ruleOptions.testFlag(ElementHideOption) && !rule.ruleOptions.testFlag(GenericHideOption)))
+		{
+			continue;
+		}
+
+		RuleOptions otherOptions(rule.ruleOptions);
+		otherOptions &= ~static_cast<quint16>(ElementHideOption | GenericHideOption);
+
+		QString host(trie.texts.mid(static_cast<int>(rule.textPosition), static_cast<int>(rule.textLength)));
+		host = host.left(host.indexOf(QLatin1Char('$'))).mid(4).toLower();
+
+		while (host.endsWith(QLatin1Char('^')) || host.endsWith(QLatin1Char('/')) || host.endsWith(QLatin1Char('|')))
+		{
+			host.chop(1);
+		}
+
+		bool isHostRule(rule.needsDomainCheck && !host.isEmpty() && otherOptions == NoOption && rule.ruleExceptions == NoOption && rule.blockedDomainsAmount == 0 && rule.allowedDomainsAmount == 0);
+
+		for (int j = 0; (isHostRule && j < host.length()); ++j)
+		{
+			const QChar character(host.at(j));
+
+			isHostRule = (character.isLetterOrNumber() || character == QLatin1Char('.') || character == QLatin1Char('-'));
+		}
+
+		if (!isHostRule)
+		{
+			elementHideIndex.hasPatternRules = true;
+
+			continue;
+		}
+
+		const ContentFiltersManager::CosmeticFiltersMode mode(rule.ruleOptions.testFlag(ElementHideOption) ? ContentFiltersManager::NoFilters : ContentFiltersManager::DomainOnlyFilters);
+
+		elementHideIndex.domains[host] = qMin(mode, elementHideIndex.domains.value(host, ContentFiltersManager::AllFilters));
+	}
 }
 
-void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
+void AdblockContentFiltersProfile::buildHostSet(const Trie &trie, HostSet &hostSet)
 {
-	if (!m_dataFetchJob)
+	hostSet = {};
+
+	for (int i = 0; i < trie.getRulesAmount(); ++i)
 	{
-		return;
-	}
+		const Trie::Rule &rule(trie.getRule(i));
 
-	QIODevice *device(m_dataFetchJob->getData());
+		if (rule.isException)
+		{
+			hostSet.hasExceptionRules = true;
 
-	m_dataFetchJob->deleteLater();
-	m_dataFetchJob = nullptr;
+			continue;
+		}
 
-	if (!isSuccess)
-	{
-		raiseError(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(device ? device->errorString() : tr("Download failure")), DownloadError);
+		QString host(trie.texts.mid(static_cast<int>(rule.textPosition), static_cast<int>(rule.textLength)).mid(2).toLower());
 
-		return;
-	}
+		if (host.endsWith(QLatin1Char('^')) || host.endsWith(QLatin1Char('/')))
+		{
+			host.chop(1);
+		}
 
-	QBuffer buffer;
-	buffer.setData(device->readAll());
-	buffer.open(QIODevice::ReadOnly | QIODevice::Text);
+		bool isHostRule(rule.needsDomainCheck && !host.isEmpty() && rule.ruleMatch == ContainsMatch && rule.ruleOptions == NoOption && rule.ruleExceptions == NoOption && rule.blockedDomainsAmount == 0 && rule.allowedDomainsAmount == 0);
 
-	const HeaderInformation information(loadHeader(&buffer));
+		for (int j = 0; (isHostRule && j < host.length()); ++j)
+		{
+			const QChar character(host.at(j));
 
-	buffer.reset();
+			isHostRule = (character.isLetterOrNumber() || character == QLatin1Char('.') || character == QLatin1Char('-'));
+		}
 
-	if (information.hasError())
-	{
-		raiseError(information.errorString, information.error);
+		if (isHostRule)
+		{
+			hostSet.hashes.append(hashHost(QStringRef(&host)));
+		}
+		else
+		{
+			hostSet.hasPatternRules = true;
+		}
+	}
 
+	if (hostSet.hashes.isEmpty())
+	{
 		return;
 	}
 
-	QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking")));
+	std::sort(hostSet.hashes.begin(), hostSet.hashes.end());
 
-	QSaveFile file(getPath());
+	hostSet.hashes.erase(std::unique(hostSet.hashes.begin(), hostSet.hashes.end()), hostSet.hashes.end());
+	hostSet.hashes.squeeze();
 
-	if (!file.open(QIODevice::WriteOnly))
-	{
-		raiseError(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), DownloadError);
+	int wordsAmount(1);
 
-		return;
+	while ((wordsAmount * 64) < (hostSet.hashes.count() * BloomFilterBitsPerHost))
+	{
+		wordsAmount *= 2;
 	}
 
-	file.write(buffer.data());
+	hostSet.bloomFilter.fill(0, wordsAmount);
 
-	m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
+	const quint64 mask((static_cast<quint64>(wordsAmount) * 64) - 1);
 
-	if (!file.commit())
+	for (int i = 0; i < hostSet.hashes.count(); ++i)
 	{
-		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
-	}
+		const quint64 hash(hostSet.hashes.at(i));
+		const quint64 step((hash >> 32) | 1);
 
-	clear();
+		for (int j = 0; j < BloomFilterProbes; ++j)
+		{
+			const quint64 bit((hash + (j * step)) & mask);
+
+			hostSet.bloomFilter[static_cast<int>(bit >> 6)] |= (static_cast<quint64>(1) << (bit & 63));
+		}
+	}
+}
+
+void AdblockContentFiltersProfile::buildMergedIndex(const QVector<const AdblockContentFiltersProfile*> &profiles, const QVector<std::shared_ptr<const Snapshot> > &snapshots)
+{
+	std::shared_ptr<MergedIndex> index(new MergedIndex());
+	index->snapshots = snapshots;
+
+	QVector<const Trie*> tries;
+	tries.reserve(snapshots.count());
+
+	for (int i = 0; i < snapshots.count(); ++i)
+	{
+		tries.append(&snapshots.at(i)->trie);
+	}
+
+	buildTokenIndex(tries, index->tokenIndex);
+
+	QMutexLocker locker(&m_mergedIndexesMutex);
+
+	if (m_pendingMergedIndexes.remove(profiles))
+	{
+		m_mergedIndexes[profiles] = index;
+	}
+}
+
+void AdblockContentFiltersProfile::removeMergedIndexes(const AdblockContentFiltersProfile *profile)
+{
+	QMutexLocker locker(&m_mergedIndexesMutex);
+	QHash<QVector<const AdblockContentFiltersProfile*>, std::shared_ptr<const MergedIndex> >::iterator iterator(m_mergedIndexes.begin());
+
+	while (iterator != m_mergedIndexes.end())
+	{
+		if (iterator.key().contains(profile))
+		{
+			iterator = m_mergedIndexes.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	QSet<QVector<const AdblockContentFiltersProfile*> >::iterator pendingIterator(m_pendingMergedIndexes.begin());
+
+	while (pendingIterator != m_pendingMergedIndexes.end())
+	{
+		if (pendingIterator->contains(profile))
+		{
+			pendingIterator = m_pendingMergedIndexes.erase(pendingIterator);
+		}
+		else
+		{
+			++pendingIterator;
+		}
+	}
+}
+
+bool AdblockContentFiltersProfile::saveCache(const QByteArray &checksum, const Snapshot &snapshot) const
+{
+	const Trie &trie(snapshot.trie);
+	const QString path(getCachePath());
+
+	if (path.isEmpty() || trie.isEmpty())
+	{
+		return true;
+	}
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(CacheMagicNumber) << static_cast<quint32>(CacheFormatVersion) << checksum << static_cast<qint32>(m_profileSummary.cosmeticFiltersMode) << m_profileSummary.areWildcardsEnabled;
+	stream << snapshot.statistics.rulesAmount << snapshot.statistics.genericCosmeticRulesAmount << snapshot.statistics.domainCosmeticRulesAmount << snapshot.statistics.wildcardRulesAmount;
+	stream << m_cosmeticFiltersRules << static_cast<quint32>(m_cosmeticFiltersDomainRules.count());
+
+	QMultiHash<QString, QString>::const_iterator iterator;
+
+	for (iterator = m_cosmeticFiltersDomainRules.constBegin(); iterator != m_cosmeticFiltersDomainRules.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << iterator.value();
+	}
+
+	stream << static_cast<quint32>(m_cosmeticFiltersDomainExceptions.count());
+
+	for (iterator = m_cosmeticFiltersDomainExceptions.constBegin(); iterator != m_cosmeticFiltersDomainExceptions.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << iterator.value();
+	}
+
+	stream << static_cast<quint32>(sizeof(Trie::Node)) << static_cast<quint32>(sizeof(Trie::Rule)) << static_cast<qint32>(QSysInfo::ByteOrder) << trie.domains << static_cast<quint32>(trie.texts.length()) << static_cast<quint32>(trie.getNodesAmount()) << static_cast<quint32>(trie.getRulesAmount()) << static_cast<quint32>(trie.getRuleDomainsAmount());
+
+	const QByteArray padding(static_cast<int>((CacheAlignment - (file.pos() % CacheAlignment)) % CacheAlignment), 0);
+
+	stream.writeRawData(padding.constData(), padding.size());
+	stream.writeRawData(reinterpret_cast<const char*>(trie.getNodes()), static_cast<int>(trie.getNodesAmount() * sizeof(Trie::Node)));
+	stream.writeRawData(reinterpret_cast<const char*>(trie.getRules()), static_cast<int>(trie.getRulesAmount() * sizeof(Trie::Rule)));
+	stream.writeRawData(reinterpret_cast<const char*>(trie.getRuleDomains()), static_cast<int>(trie.getRuleDomainsAmount() * sizeof(quint32)));
+	stream.writeRawData(reinterpret_cast<const char*>(trie.texts.constData()), static_cast<int>(trie.texts.length() * sizeof(QChar)));
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+
+		return false;
+	}
+
+	return file.commit();
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Trie &trie, int start, const ContentFiltersManager::RequestContext &context) const
+{
+	const QString &url(context.requestUrl);
+	ContentFiltersManager::CheckResult result;
+	ContentFiltersManager::CheckResult currentResult;
+	QVarLengthArray<quint32, 16> nodes;
+	QVarLengthArray<quint32, 16> nextNodes;
+	QVarLengthArray<quint32, 4> wildcardNodes;
+
+	if (trie.isEmpty())
+	{
+		return result;
+	}
+
+	nodes.append(0);
+
+	for (int position = start; position < url.length(); ++position)
+	{
+		const QChar treeChar(url.at(position));
+
+		for (int i = 0; i < wildcardNodes.count(); ++i)
+		{
+			if (!nodes.contains(wildcardNodes.at(i)))
+			{
+				nodes.append(wildcardNodes.at(i));
+			}
+		}
+
+		if (nodes.isEmpty())
+		{
+			return result;
+		}
+
+		for (int i = 0; i < nodes.count(); ++i)
+		{
+			const Trie::Node &node(trie.getNode(static_cast<int>(nodes.at(i))));
+
+			currentResult = evaluateNodeRules(trie, node, start, (position - start), context);
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
+			}
+
+			for (quint32 nextNode = node.firstChild; nextNode < (node.firstChild + node.childrenAmount); ++nextNode)
+			{
+				const QChar value(trie.getNode(static_cast<int>(nextNode)).value);
+
+				if (value == QLatin1Char('*'))
+				{
+					if (!wildcardNodes.contains(nextNode))
+					{
+						wildcardNodes.append(nextNode);
+					}
+
+					if (!nodes.contains(nextNode))
+					{
+						nodes.append(nextNode);
+					}
+				}
+
+				if (value == QLatin1Char('^') && context.preprocessedRequestUrl.isSeparator(position) && !nodes.contains(nextNode))
+				{
+					nodes.append(nextNode);
+				}
+
+				if (value == treeChar && !nextNodes.contains(nextNode))
+				{
+					nextNodes.append(nextNode);
+				}
+			}
+		}
+
+		nodes = nextNodes;
+
+		nextNodes.clear();
+	}
+
+	const int length(url.length() - start);
+
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		const Trie::Node &node(trie.getNode(static_cast<int>(nodes.at(i))));
+
+		currentResult = evaluateNodeRules(trie, node, start, length, context);
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+
+		for (quint32 j = node.firstChild; j < (node.firstChild + node.childrenAmount); ++j)
+		{
+			const Trie::Node &nextNode(trie.getNode(static_cast<int>(j)));
+
+			if (nextNode.value == QLatin1Char('^'))
+			{
+				currentResult = evaluateNodeRules(trie, nextNode, start, length, context);
+
+				if (currentResult.isBlocked)
+				{
+					result = currentResult;
+				}
+				else if (currentResult.isException)
+				{
+					return currentResult;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Trie &trie, const Trie::Rule &rule, int position, int length, const ContentFiltersManager::RequestContext &context) const
+{
+	const QString &url(context.requestUrl);
+
+	switch (rule.ruleMatch)
+	{
+		case StartMatch:
+			if (position != 0)
+			{
+				return {};
+			}
+
+			break;
+		case EndMatch:
+			if ((position + length) != url.length())
+			{
+				return {};
+			}
+
+			break;
+		case ExactMatch:
+			if (position != 0 || length != url.length())
+			{
+				return {};
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	if (rule.needsDomainCheck)
+	{
+		const int domainLength(context.preprocessedRequestUrl.findDomainSeparator(position, (position + length)) - position);
+
+		if (!context.hasRequestSubdomain(url.midRef(position, domainLength)))
+		{
+			return {};
+		}
+	}
+
+	const bool hasBlockedDomains(rule.blockedDomainsAmount > 0);
+	const bool hasAllowedDomains(rule.allowedDomainsAmount > 0);
+	bool isBlocked(true);
+
+	if (hasBlockedDomains)
+	{
+		isBlocked = resolveDomainExceptions(context.baseHost, trie, rule.firstDomain, rule.blockedDomainsAmount);
+
+		if (!isBlocked)
+		{
+			return {};
+		}
+	}
+
+	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(context.baseHost, trie, (rule.firstDomain + rule.blockedDomainsAmount), rule.allowedDomainsAmount) : isBlocked);
+
+	if (rule.ruleOptions.testFlag(ThirdPartyOption) || rule.ruleExceptions.testFlag(ThirdPartyOption))
+	{
+		if (!context.isThirdParty)
+		{
+			isBlocked = rule.ruleExceptions.testFlag(ThirdPartyOption);
+		}
+		else if (!hasBlockedDomains && !hasAllowedDomains)
+		{
+			isBlocked = rule.ruleOptions.testFlag(ThirdPartyOption);
+		}
+	}
+
+	if (rule.ruleOptions != NoOption || rule.ruleExceptions != NoOption)
+	{
+		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
+
+		for (iterator = m_resourceTypes.constBegin(); iterator != m_resourceTypes.constEnd(); ++iterator)
+		{
+			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
+
+			if (rule.ruleOptions.testFlag(iterator.value()) || (supportsException && rule.ruleExceptions.testFlag(iterator.value())))
+			{
+				if (context.resourceType == iterator.key())
+				{
+					isBlocked = (isBlocked ? rule.ruleOptions.testFlag(iterator.value()) : isBlocked);
+				}
+				else if (supportsException)
+				{
+					isBlocked = (isBlocked ? rule.ruleExceptions.testFlag(iterator.value()) : isBlocked);
+				}
+				else
+				{
+					isBlocked = false;
+				}
+			}
+		}
+	}
+	else if (context.resourceType == NetworkManager::PopupType)
+	{
+		isBlocked = false;
+	}
+
+	if (isBlocked)
+	{
+		ContentFiltersManager::CheckResult result;
+		result.rule = trie.texts.mid(static_cast<int>(rule.textPosition), static_cast<int>(rule.textLength));
+
+		if (rule.isException)
+		{
+			result.isBlocked = false;
+			result.isException = true;
+
+			if (rule.ruleOptions.testFlag(ElementHideOption))
+			{
+				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
+			}
+			else if (rule.ruleOptions.testFlag(GenericHideOption))
+			{
+				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
+			}
+
+			return result;
+		}
+
+		result.isBlocked = true;
+
+		return result;
+	}
+
+	return {};
+}
+
+void AdblockContentFiltersProfile::raiseError(const QString &message, ProfileError error)
+{
+	m_error = error;
+
+	if (!m_loadingWatcher && !getSnapshot() && !QFile::exists(getPath()))
+	{
+		std::shared_ptr<Snapshot> snapshot(new Snapshot());
+		snapshot->trie.nodes.resize(1);
+
+		std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(snapshot));
+	}
+
+	Console::addMessage(message, Console::OtherCategory, Console::ErrorLevel, getPath());
+
+	emit profileModified();
+}
+
+void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
+{
+	if (!m_dataFetchJob)
+	{
+		return;
+	}
+
+	QIODevice *device(m_dataFetchJob->getData());
+	const QString entityTag(QString::fromLatin1(m_dataFetchJob->getHeader(QByteArrayLiteral("ETag"))));
+	const QString lastModified(QString::fromLatin1(m_dataFetchJob->getHeader(QByteArrayLiteral("Last-Modified"))));
+	const int statusCode(m_dataFetchJob->getStatusCode());
+
+	m_dataFetchJob->deleteLater();
+	m_dataFetchJob = nullptr;
+
+	if (!isSuccess)
+	{
+		raiseError(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(device ? device->errorString() : tr("Download failure")), DownloadError);
+
+		return;
+	}
+
+	if (statusCode == 304 && QFile::exists(getPath()))
+	{
+		m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
+
+		emit profileModified();
+
+		return;
+	}
+
+	QBuffer buffer;
+	buffer.setData(device->readAll());
+	buffer.open(QIODevice::ReadOnly | QIODevice::Text);
+
+	const HeaderInformation information(loadHeader(&buffer));
+
+	buffer.reset();
+
+	if (information.hasError())
+	{
+		raiseError(information.errorString, information.error);
+
+		return;
+	}
+
+	QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking")));
+
+	QByteArray previousData;
+	QFile previousFile(getPath());
+
+	if (m_wasLoaded && !m_loadingWatcher && getSnapshot() && previousFile.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		previousData = previousFile.readAll();
+
+		previousFile.close();
+	}
+
+	QSaveFile file(getPath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		raiseError(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), DownloadError);
+
+		return;
+	}
+
+	file.write(buffer.data());
+
+	m_profileSummary.updateEntityTag = entityTag;
+	m_profileSummary.updateLastModified = lastModified;
+	m_profileSummary.lastUpdate = QDateTime::currentDateTimeUtc();
+
+	if (!file.commit())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+	}
+
+	if (!previousData.isEmpty())
+	{
+		loadHeader();
+
+		m_wasLoaded = false;
+		m_loadingWatcher = new QFutureWatcher<bool>(this);
+
+		connect(m_loadingWatcher, &QFutureWatcher<bool>::finished, this, &AdblockContentFiltersProfile::handleRulesLoaded);
+
+		m_loadingWatcher->setFuture(QtConcurrent::run(this, &AdblockContentFiltersProfile::applyRulesDifference, previousData));
+
+		emit profileModified();
+
+		return;
+	}
+
+	const bool wasLoaded(m_wasLoaded || m_loadingWatcher);
+
+	clear();
 	loadHeader();
 
-	if (m_wasLoaded)
+	if (wasLoaded)
+	{
+		load();
+	}
+
+	emit profileModified();
+}
+
+void AdblockContentFiltersProfile::handleRulesLoaded()
+{
+	if (!m_loadingWatcher)
+	{
+		return;
+	}
+
+	const bool isCacheSaved(m_loadingWatcher->result());
+
+	m_loadingWatcher->deleteLater();
+	m_loadingWatcher = nullptr;
+
+	m_wasLoaded = true;
+
+	if (!isCacheSaved)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save content blocking profile cache"), Console::OtherCategory, Console::WarningLevel, getCachePath());
+	}
+
+	emit profileLoaded();
+}
+
+void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile::ProfileSummary &profileSummary)
+{
+	const bool needsReload(profileSummary.cosmeticFiltersMode != m_profileSummary.cosmeticFiltersMode || profileSummary.areWildcardsEnabled != m_profileSummary.areWildcardsEnabled);
+
+	if (profileSummary.title != m_profileSummary.title)
+	{
+		m_flags |= HasCustomTitleFlag;
+	}
+	else if (!needsReload && profileSummary.updateUrl == m_profileSummary.updateUrl && profileSummary.updateInterval == m_profileSummary.updateInterval && profileSummary.category == m_profileSummary.category)
+	{
+		return;
+	}
+
+	if (m_loadingWatcher)
+	{
+		m_loadingWatcher->waitForFinished();
+
+		handleRulesLoaded();
+	}
+
+	const QString updateEntityTag(m_profileSummary.updateEntityTag);
+	const QString updateLastModified(m_profileSummary.updateLastModified);
+	const bool hasSameUpdateUrl(profileSummary.updateUrl == m_profileSummary.updateUrl);
+
+	m_profileSummary = profileSummary;
+
+	if (hasSameUpdateUrl && profileSummary.updateEntityTag.isEmpty() && profileSummary.updateLastModified.isEmpty())
+	{
+		m_profileSummary.updateEntityTag = updateEntityTag;
+		m_profileSummary.updateLastModified = updateLastModified;
+	}
+
+	if (needsReload)
+	{
+		clear();
+	}
+
+	emit profileModified();
+}
+
+QString AdblockContentFiltersProfile::getName() const
+{
+	return m_profileSummary.name;
+}
+
+QString AdblockContentFiltersProfile::getTitle() const
+{
+	return (m_profileSummary.title.isEmpty() ? tr("(Unknown)") : m_profileSummary.title);
+}
+
+QString AdblockContentFiltersProfile::getPath() const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
+}
+
+QString AdblockContentFiltersProfile::getCachePath() const
+{
+	const QString cachePath(SessionsManager::getCachePath());
+
+	if (cachePath.isEmpty())
+	{
+		return {};
+	}
+
+	return QDir::toNativeSeparators(cachePath + QLatin1String("/contentBlocking/%1.dat").arg(m_profileSummary.name));
+}
+
+QString AdblockContentFiltersProfile::getSharedCachePath() const
+{
+	if (m_sharedCachePath.isEmpty())
+	{
+		return {};
+	}
+
+	return QDir::toNativeSeparators(m_sharedCachePath + QLatin1String("/%1.dat").arg(m_profileSummary.name));
+}
+
+QDateTime AdblockContentFiltersProfile::getLastUpdate() const
+{
+	return m_profileSummary.lastUpdate;
+}
+
+QUrl AdblockContentFiltersProfile::getUpdateUrl() const
+{
+	return m_profileSummary.updateUrl;
+}
+
+std::shared_ptr<const AdblockContentFiltersProfile::Snapshot> AdblockContentFiltersProfile::getSnapshot() const
+{
+	return std::atomic_load(&m_snapshot);
+}
+
+ContentFiltersProfile::ProfileSummary AdblockContentFiltersProfile::getProfileSummary() const
+{
+	return m_profileSummary;
+}
+
+ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCosmeticFilters(const QStringList &domains, bool isDomainOnly)
+{
+	if (!m_wasLoaded)
+	{
+		loadRules();
+	}
+
+	ContentFiltersManager::CosmeticFiltersResult result;
+
+	if (!isDomainOnly)
+	{
+		result.rules = m_cosmeticFiltersRules;
+	}
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
+		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const ContentFiltersManager::RequestContext &context)
+{
+	ContentFiltersManager::CheckResult result;
+	std::shared_ptr<const Snapshot> snapshot(getSnapshot());
+
+	if (!snapshot)
+	{
+		if (QThread::currentThread() != thread())
+		{
+			QMetaObject::invokeMethod(this, "load", Qt::QueuedConnection);
+
+			return result;
+		}
+
+		loadRules();
+
+		snapshot = getSnapshot();
+
+		if (!snapshot)
+		{
+			return result;
+		}
+	}
+
+	if (snapshot->matchingEngine == TokenIndexMatchingEngine)
+	{
+		return checkUrlTokens(snapshot->tokenIndex, context);
+	}
+
+	for (int i = 0; i < context.requestUrl.length(); ++i)
+	{
+		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(snapshot->trie, i, context));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CosmeticFiltersMode AdblockContentFiltersProfile::checkCosmeticFiltersMode(const QUrl &url)
+{
+	const std::shared_ptr<const Snapshot> snapshot(getSnapshot());
+
+	if (!snapshot || snapshot->elementHideIndex.hasPatternRules)
+	{
+		return checkUrl(ContentFiltersManager::RequestContext(url, url, NetworkManager::OtherType)).comesticFiltersMode;
+	}
+
+	const QHash<QString, ContentFiltersManager::CosmeticFiltersMode> &domains(snapshot->elementHideIndex.domains);
+
+	if (domains.isEmpty())
+	{
+		return ContentFiltersManager::AllFilters;
+	}
+
+	ContentFiltersManager::CosmeticFiltersMode mode(ContentFiltersManager::AllFilters);
+	QString domain(url.host().toLower());
+
+	while (!domain.isEmpty() && mode != ContentFiltersManager::NoFilters)
+	{
+		mode = qMin(mode, domains.value(domain, ContentFiltersManager::AllFilters));
+
+		const int dotPosition(domain.indexOf(QLatin1Char('.')));
+
+		if (dotPosition < 0)
+		{
+			break;
+		}
+
+		domain = domain.mid(dotPosition + 1);
+	}
+
+	return mode;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateTokenIndexEntry(const TokenIndex::Entry &entry, int position, const ContentFiltersManager::RequestContext &context) const
+{
+	const QString &url(context.requestUrl);
+	const bool needsStart(entry.rule->ruleMatch == StartMatch || entry.rule->ruleMatch == ExactMatch);
+	const bool needsEnd(entry.rule->ruleMatch == EndMatch || entry.rule->ruleMatch == ExactMatch);
+
+	if (position >= 0)
+	{
+		if ((needsStart && position != 0) || position > url.length())
+		{
+			return {};
+		}
+
+		const int end(matchPattern(entry.pattern, context.preprocessedRequestUrl, position, needsEnd));
+
+		if (end < 0)
+		{
+			return {};
+		}
+
+		return checkRuleMatch(*entry.trie, *entry.rule, position, (end - position), context);
+	}
+
+	const int lastPosition(needsStart ? 0 : url.length());
+
+	for (int i = 0; i <= lastPosition; ++i)
+	{
+		if (entry.rule->needsDomainCheck && i > 0 && url.at(i - 1) != QLatin1Char('.') && url.at(i - 1) != QLatin1Char('/'))
+		{
+			continue;
+		}
+
+		const int end(matchPattern(entry.pattern, context.preprocessedRequestUrl, i, needsEnd));
+
+		if (end < 0)
+		{
+			continue;
+		}
+
+		const ContentFiltersManager::CheckResult result(checkRuleMatch(*entry.trie, *entry.rule, i, (end - i), context));
+
+		if (result.isBlocked || result.isException)
+		{
+			return result;
+		}
+	}
+
+	return {};
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlTokens(const TokenIndex &tokenIndex, const ContentFiltersManager::RequestContext &context) const
+{
+	ContentFiltersManager::CheckResult result;
+	ContentFiltersManager::CheckResult exceptionResult;
+	QVarLengthArray<const TokenIndex::Entry*, 16> evaluatedEntries;
+	const QString &url(context.preprocessedRequestUrl.getLowerCaseUrl());
+	int i(0);
+
+	while (i < url.length())
+	{
+		const int start(context.preprocessedRequestUrl.findTokenStart(i));
+
+		if (start >= url.length())
+		{
+			break;
+		}
+
+		i = context.preprocessedRequestUrl.findTokenEnd(start);
+
+		if ((i - start) < 2)
+		{
+			continue;
+		}
+
+		const int slot(tokenIndex.findSlot(hashToken(url, start, (i - start))));
+
+		if (slot < 0)
+		{
+			continue;
+		}
+
+		const TokenIndex::Slot &slotData(tokenIndex.slots.at(slot));
+
+		for (int j = slotData.first; j < (slotData.first + slotData.amount); ++j)
+		{
+			const TokenIndex::Entry &entry(tokenIndex.entries.at(j));
+
+			if (entry.tokenOffset < 0)
+			{
+				bool wasEvaluated(false);
+
+				for (int k = 0; k < evaluatedEntries.count(); ++k)
+				{
+					if (evaluatedEntries.at(k) == &entry)
+					{
+						wasEvaluated = true;
+
+						break;
+					}
+				}
+
+				if (wasEvaluated)
+				{
+					continue;
+				}
+
+				evaluatedEntries.append(&entry);
+			}
+			else if (start < entry.tokenOffset)
+			{
+				continue;
+			}
+
+			ContentFiltersManager::CheckResult currentResult(evaluateTokenIndexEntry(entry, ((entry.tokenOffset < 0) ? -1 : (start - entry.tokenOffset)), context));
+			currentResult.profile = entry.profile;
+
+			if (currentResult.isException)
+			{
+				if (entry.profile == 0)
+				{
+					return currentResult;
+				}
+
+				if (!exceptionResult.isException || entry.profile < exceptionResult.profile)
+				{
+					exceptionResult = currentResult;
+				}
+			}
+			else if (currentResult.isBlocked && entry.profile >= result.profile)
+			{
+				result = currentResult;
+			}
+		}
+	}
+
+	for (int j = 0; j < tokenIndex.untokenizedEntries.count(); ++j)
+	{
+		const TokenIndex::Entry &entry(tokenIndex.untokenizedEntries.at(j));
+		ContentFiltersManager::CheckResult currentResult(evaluateTokenIndexEntry(entry, -1, context));
+		currentResult.profile = entry.profile;
+
+		if (currentResult.isException)
+		{
+			if (entry.profile == 0)
+			{
+				return currentResult;
+			}
+
+			if (!exceptionResult.isException || entry.profile < exceptionResult.profile)
+			{
+				exceptionResult = currentResult;
+			}
+		}
+		else if (currentResult.isBlocked && entry.profile >= result.profile)
+		{
+			result = currentResult;
+		}
+	}
+
+	return (exceptionResult.isException ? exceptionResult : result);
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Trie &trie, const Trie::Node &node, int position, int length, const ContentFiltersManager::RequestContext &context) const
+{
+	ContentFiltersManager::CheckResult result;
+
+	for (quint32 i = node.firstRule; i < (node.firstRule + node.rulesAmount); ++i)
+	{
+		const ContentFiltersManager::CheckResult currentResult(checkRuleMatch(trie, trie.getRule(static_cast<int>(i)), position, length, context));
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+	}
+
+	return result;
+}
+
+AdblockContentFiltersProfile::HeaderInformation AdblockContentFiltersProfile::loadHeader(QIODevice *rulesDevice)
+{
+	HeaderInformation information;
+	QTextStream stream(rulesDevice);
+	stream.setCodec("UTF-8");
+
+	const QString header(stream.readLine());
+
+	if (!header.contains(QLatin1String("[Adblock"), Qt::CaseInsensitive))
+	{
+		information.errorString = QCoreApplication::translate("main", "Failed to update content blocking profile: invalid header");
+		information.error = ParseError;
+
+		return information;
+	}
+
+	int lineNumber(1);
+
+	while (!stream.atEnd())
+	{
+		const QString line(stream.readLine().trimmed());
+
+		if (line.startsWith(QLatin1String("! Title: ")))
+		{
+			information.title = line.section(QLatin1Char(':'), 1).trimmed();
+
+			continue;
+		}
+
+		if (lineNumber > 50)
+		{
+			break;
+		}
+
+		++lineNumber;
+	}
+
+	return information;
+}
+
+QHash<AdblockContentFiltersProfile::RuleType, quint32> AdblockContentFiltersProfile::loadRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary, QIODevice *rulesDevice)
+{
+	RulesStatistics statistics;
+	QTextStream stream(rulesDevice);
+	stream.setCodec("UTF-8");
+	stream.readLine();
+
+	while (!stream.atEnd())
+	{
+		countRule(stream.readLine(), statistics);
+	}
+
+	return createRulesInformation(statistics, profileSummary);
+}
+
+QHash<AdblockContentFiltersProfile::RuleType, quint32> AdblockContentFiltersProfile::getRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary) const
+{
+	const std::shared_ptr<const Snapshot> snapshot(getSnapshot());
+
+	return (snapshot ? createRulesInformation(snapshot->statistics, profileSummary) : QHash<RuleType, quint32>());
+}
+
+QHash<AdblockContentFiltersProfile::RuleType, quint32> AdblockContentFiltersProfile::createRulesInformation(const RulesStatistics &statistics, const ContentFiltersProfile::ProfileSummary &profileSummary)
+{
+	quint32 activeRulesAmount(static_cast<quint32>(statistics.rulesAmount - statistics.genericCosmeticRulesAmount - statistics.domainCosmeticRulesAmount - statistics.wildcardRulesAmount));
+
+	if (profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+	{
+		activeRulesAmount += static_cast<quint32>(statistics.genericCosmeticRulesAmount);
+	}
+
+	if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+	{
+		activeRulesAmount += static_cast<quint32>(statistics.domainCosmeticRulesAmount);
+	}
+
+	if (profileSummary.areWildcardsEnabled)
+	{
+		activeRulesAmount += static_cast<quint32>(statistics.wildcardRulesAmount);
+	}
+
+	return {{AnyRule, static_cast<quint32>(statistics.rulesAmount)}, {ActiveRule, activeRulesAmount}, {CosmeticRule, static_cast<quint32>(statistics.genericCosmeticRulesAmount + statistics.domainCosmeticRulesAmount)}, {WildcardRule, static_cast<quint32>(statistics.wildcardRulesAmount)}};
+}
+
+QVector<AdblockContentFiltersProfile::TokenIndex::Token> AdblockContentFiltersProfile::tokenizePattern(const QString &pattern, const Trie::Rule *rule)
+{
+	const QString lowerCasePattern(pattern.toLower());
+	const QString &hashedPattern((lowerCasePattern.length() == pattern.length()) ? lowerCasePattern : pattern);
+	QVector<TokenIndex::Token> tokens;
+	const bool hasStartAnchor(rule->needsDomainCheck || rule->ruleMatch == StartMatch || rule->ruleMatch == ExactMatch);
+	const bool hasEndAnchor(rule->ruleMatch == EndMatch || rule->ruleMatch == ExactMatch);
+	bool hasWildcard(false);
+	int i(0);
+
+	while (i < pattern.length())
+	{
+		if (!PreprocessedUrl::isTokenCharacter(pattern.at(i)))
+		{
+			if (pattern.at(i) == QLatin1Char('*'))
+			{
+				hasWildcard = true;
+			}
+
+			++i;
+
+			continue;
+		}
+
+		const int start(i);
+
+		while (i < pattern.length() && PreprocessedUrl::isTokenCharacter(pattern.at(i)))
+		{
+			++i;
+		}
+
+		const bool isStartBounded((start > 0) ? (pattern.at(start - 1) != QLatin1Char('*')) : hasStartAnchor);
+		const bool isEndBounded((i < pattern.length()) ? (pattern.at(i) != QLatin1Char('*')) : hasEndAnchor);
+
+		if (isStartBounded && isEndBounded && (i - start) > 1)
+		{
+			TokenIndex::Token token;
+			token.hash = hashToken(hashedPattern, start, (i - start));
+			token.position = (hasWildcard ? -1 : start);
+			token.length = (i - start);
+
+			tokens.append(token);
+		}
+	}
+
+	return tokens;
+}
+
+quint32 AdblockContentFiltersProfile::hashToken(const QString &text, int position, int length)
+{
+	quint32 hash(2166136261U);
+
+	for (int i = position; i < (position + length); ++i)
+	{
+		hash ^= text.at(i).unicode();
+		hash *= 16777619U;
+	}
+
+	return ((hash == 0) ? 1 : hash);
+}
+
+quint64 AdblockContentFiltersProfile::hashHost(const QStringRef &host)
+{
+	quint64 hash(14695981039346656037ULL);
+
+	for (int i = 0; i < host.length(); ++i)
+	{
+		hash ^= host.at(i).unicode();
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+int AdblockContentFiltersProfile::countRules(const QByteArray &data, int change, QHash<QString, int> &rules)
+{
+	QTextStream stream(data);
+	stream.setCodec("UTF-8");
+	stream.readLine(); // header
+
+	int amount(0);
+
+	while (!stream.atEnd())
 	{
-		loadRules();
+		const QString rule(stream.readLine());
+
+		if (!rule.isEmpty() && !rule.startsWith(QLatin1Char('!')))
+		{
+			rules[rule] += change;
+
+			++amount;
+		}
 	}
 
-	emit profileModified();
+	return amount;
 }
 
-void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile::ProfileSummary &profileSummary)
+int AdblockContentFiltersProfile::matchPattern(const QString &pattern, const PreprocessedUrl &preprocessedUrl, int position, bool needsEnd)
 {
-	const bool needsReload(profileSummary.cosmeticFiltersMode != m_profileSummary.cosmeticFiltersMode || profileSummary.areWildcardsEnabled != m_profileSummary.areWildcardsEnabled);
+	const QString &url(preprocessedUrl.getUrl());
+	int patternPosition(0);
+	int urlPosition(position);
+	int wildcardPatternPosition(-1);
+	int wildcardUrlPosition(-1);
 
-	if (profileSummary.title != m_profileSummary.title)
-	{
-		m_flags |= HasCustomTitleFlag;
-	}
-	else if (!needsReload && profileSummary.updateUrl == m_profileSummary.updateUrl && profileSummary.updateInterval == m_profileSummary.updateInterval && profileSummary.category == m_profileSummary.category)
+	while (true)
 	{
-		return;
-	}
+		if (patternPosition == pattern.length())
+		{
+			if (!needsEnd || urlPosition == url.length())
+			{
+				return urlPosition;
+			}
+		}
+		else if (pattern.at(patternPosition) == QLatin1Char('*'))
+		{
+			wildcardPatternPosition = patternPosition;
+			wildcardUrlPosition = urlPosition;
 
-	m_profileSummary = profileSummary;
+			++patternPosition;
 
-	if (needsReload)
-	{
-		clear();
+			continue;
+		}
+		else if (urlPosition < url.length() && (pattern.at(patternPosition) == url.at(urlPosition) || (pattern.at(patternPosition) == QLatin1Char('^') && preprocessedUrl.isSeparator(urlPosition))))
+		{
+			++patternPosition;
+			++urlPosition;
+
+			continue;
+		}
+		else if (urlPosition == url.length() && pattern.at(patternPosition) == QLatin1Char('^'))
+		{
+			++patternPosition;
+
+			continue;
+		}
+
+		if (wildcardPatternPosition < 0 || wildcardUrlPosition >= url.length())
+		{
+			return -1;
+		}
+
+		++wildcardUrlPosition;
+
+		patternPosition = (wildcardPatternPosition + 1);
+		urlPosition = wildcardUrlPosition;
 	}
+}
 
-	emit profileModified();
+QVector<QLocale::Language> AdblockContentFiltersProfile::getLanguages() const
+{
+	return m_languages;
 }
 
-QString AdblockContentFiltersProfile::getName() const
+ContentFiltersProfile::ProfileCategory AdblockContentFiltersProfile::getCategory() const
 {
-	return m_profileSummary.name;
+	return m_profileSummary.category;
 }
 
-QString AdblockContentFiltersProfile::getTitle() const
+ContentFiltersManager::CosmeticFiltersMode AdblockContentFiltersProfile::getCosmeticFiltersMode() const
 {
-	return (m_profileSummary.title.isEmpty() ? tr("(Unknown)") : m_profileSummary.title);
+	return m_profileSummary.cosmeticFiltersMode;
 }
 
-QString AdblockContentFiltersProfile::getPath() const
+ContentFiltersProfile::ProfileError AdblockContentFiltersProfile::getError() const
 {
-	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
+	return m_error;
 }
 
-QDateTime AdblockContentFiltersProfile::getLastUpdate() const
+ContentFiltersProfile::ProfileFlags AdblockContentFiltersProfile::getFlags() const
 {
-	return m_profileSummary.lastUpdate;
+	return m_flags;
 }
 
-QUrl AdblockContentFiltersProfile::getUpdateUrl() const
+quint64 AdblockContentFiltersProfile::getMemoryUsage() const
 {
-	return m_profileSummary.updateUrl;
+	const std::shared_ptr<const Snapshot> snapshot(getSnapshot());
+
+	if (!snapshot)
+	{
+		return 0;
+	}
+
+	const Trie &trie(snapshot->trie);
+	const TokenIndex &tokenIndex(snapshot->tokenIndex);
+	quint64 usage((static_cast<quint64>(trie.nodes.capacity()) * sizeof(Trie::Node)) + (static_cast<quint64>(trie.rules.capacity()) * sizeof(Trie::Rule)) + (static_cast<quint64>(trie.ruleDomains.capacity()) * sizeof(quint32)) + (static_cast<quint64>(trie.texts.capacity()) * sizeof(QChar)));
+
+	for (int i = 0; i < trie.domains.count(); ++i)
+	{
+		usage += (sizeof(QString) + (static_cast<quint64>(trie.domains.at(i).capacity()) * sizeof(QChar)));
+	}
+
+	usage += (static_cast<quint64>(tokenIndex.slots.capacity()) * sizeof(TokenIndex::Slot)) + (static_cast<quint64>(tokenIndex.entries.capacity() + tokenIndex.untokenizedEntries.capacity()) * sizeof(TokenIndex::Entry));
+
+	for (int i = 0; i < tokenIndex.entries.count(); ++i)
+	{
+		usage += (static_cast<quint64>(tokenIndex.entries.at(i).pattern.capacity()) * sizeof(QChar));
+	}
+
+	for (int i = 0; i < tokenIndex.untokenizedEntries.count(); ++i)
+	{
+		usage += (static_cast<quint64>(tokenIndex.untokenizedEntries.at(i).pattern.capacity()) * sizeof(QChar));
+	}
+
+	QHash<QString, ContentFiltersManager::CosmeticFiltersMode>::const_iterator iterator;
+
+	for (iterator = snapshot->elementHideIndex.domains.constBegin(); iterator != snapshot->elementHideIndex.domains.constEnd(); ++iterator)
+	{
+		usage += (sizeof(QString) + sizeof(ContentFiltersManager::CosmeticFiltersMode) + (static_cast<quint64>(iterator.key().capacity()) * sizeof(QChar)));
+	}
+
+	const std::shared_ptr<const HostSet> hostSet(std::atomic_load(&snapshot->hostSet));
+
+	if (hostSet)
+	{
+		usage += (static_cast<quint64>(hostSet->bloomFilter.capacity() + hostSet->hashes.capacity()) * sizeof(quint64));
+	}
+
+	return usage;
 }
 
-ContentFiltersProfile::ProfileSummary AdblockContentFiltersProfile::getProfileSummary() const
+int AdblockContentFiltersProfile::getUpdateInterval() const
 {
-	return m_profileSummary;
+	return m_profileSummary.updateInterval;
 }
 
-ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCosmeticFilters(const QStringList &domains, bool isDomainOnly)
+int AdblockContentFiltersProfile::getUpdateProgress() const
 {
-	if (!m_wasLoaded)
+	return (m_dataFetchJob ? m_dataFetchJob->getProgress() : -1);
+}
+
+bool AdblockContentFiltersProfile::create(const ContentFiltersProfile::ProfileSummary &profileSummary, QIODevice *rulesDevice, bool canOverwriteExisting)
+{
+	const QString path(SessionsManager::getWritableDataPath(QStringLiteral("contentBlocking/%1.txt")).arg(profileSummary.name));
+
+	if (SessionsManager::isReadOnly() || (!canOverwriteExisting && QFile::exists(path)))
 	{
-		loadRules();
+		Console::addMessage(QCoreApplication::translate("main", "Failed to create a content blocking profile: %1").arg(tr("File already exists")), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
 	}
 
-	ContentFiltersManager::CosmeticFiltersResult result;
+	if (rulesDevice)
+	{
+		QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking")));
 
-	if (!isDomainOnly)
+		QFile file(path);
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Failed to create a content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+			return false;
+		}
+
+		file.write(rulesDevice->readAll());
+		file.close();
+	}
+
+	ProfileFlags flags(NoFlags);
+
+	if (!profileSummary.title.isEmpty())
 	{
-		result.rules = m_cosmeticFiltersRules;
+		flags |= HasCustomTitleFlag;
 	}
 
-	for (int i = 0; i < domains.count(); ++i)
+	AdblockContentFiltersProfile *profile(new AdblockContentFiltersProfile(profileSummary, {}, flags, ContentFiltersManager::getInstance()));
+
+	ContentFiltersManager::addProfile(profile);
+
+	if (!rulesDevice && profileSummary.updateUrl.isValid())
 	{
-		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
-		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+		profile->update();
 	}
 
-	return result;
+	return true;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType)
+bool AdblockContentFiltersProfile::checkUrlMerged(const QVector<AdblockContentFiltersProfile*> &profiles, const ContentFiltersManager::RequestContext &context, ContentFiltersManager::CheckResult &result)
 {
-	ContentFiltersManager::CheckResult result;
+	if (profiles.isEmpty())
+	{
+		return false;
+	}
+
+	QVector<const AdblockContentFiltersProfile*> key;
+	key.reserve(profiles.count());
+
+	QVector<std::shared_ptr<const Snapshot> > snapshots;
+	snapshots.reserve(profiles.count());
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const std::shared_ptr<const Snapshot> snapshot(profiles.at(i)->getSnapshot());
+
+		if (!snapshot || snapshot->trie.isEmpty())
+		{
+			return false;
+		}
+
+		key.append(profiles.at(i));
+		snapshots.append(snapshot);
+	}
+
+	std::shared_ptr<const MergedIndex> index;
+
+	{
+		QMutexLocker locker(&m_mergedIndexesMutex);
+
+		index = m_mergedIndexes.value(key);
+
+		if (index && index->snapshots != snapshots)
+		{
+			m_mergedIndexes.remove(key);
+
+			index.reset();
+		}
+
+		if (!index)
+		{
+			if (!m_pendingMergedIndexes.contains(key))
+			{
+				m_pendingMergedIndexes.insert(key);
+
+				QtConcurrent::run(&AdblockContentFiltersProfile::buildMergedIndex, key, snapshots);
+			}
+
+			return false;
+		}
+	}
+
+	result = profiles.first()->checkUrlTokens(index->tokenIndex, context);
+
+	return true;
+}
+
+bool AdblockContentFiltersProfile::loadCache(const QString &path, const QByteArray &checksum, Snapshot *snapshot, bool isShared)
+{
+	if (path.isEmpty() || !QFile::exists(path))
+	{
+		return false;
+	}
+
+	std::shared_ptr<QFile> file(std::make_shared<QFile>(path));
+
+	if (!file->open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	uchar *data(file->map(0, file->size()));
+	const QByteArray mappedData(data ? QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(file->size())) : file->readAll());
+	QDataStream stream(mappedData);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+	QByteArray cachedChecksum;
+	qint32 cosmeticFiltersMode(0);
+	bool areWildcardsEnabled(false);
+
+	stream >> magicNumber >> formatVersion >> cachedChecksum >> cosmeticFiltersMode >> areWildcardsEnabled;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != CacheMagicNumber || formatVersion != CacheFormatVersion || cachedChecksum != checksum || cosmeticFiltersMode != m_profileSummary.cosmeticFiltersMode || areWildcardsEnabled != m_profileSummary.areWildcardsEnabled)
+	{
+		return false;
+	}
+
+	RulesStatistics statistics;
+	QStringList cosmeticFiltersRules;
+	QMultiHash<QString, QString> cosmeticFiltersDomainRules;
+	QMultiHash<QString, QString> cosmeticFiltersDomainExceptions;
+	quint32 amount(0);
+
+	stream >> statistics.rulesAmount >> statistics.genericCosmeticRulesAmount >> statistics.domainCosmeticRulesAmount >> statistics.wildcardRulesAmount;
+	stream >> cosmeticFiltersRules >> amount;
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString domain;
+		QString rule;
+
+		stream >> domain >> rule;
+
+		cosmeticFiltersDomainRules.insert(domain, rule);
+	}
+
+	stream >> amount;
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString domain;
+		QString rule;
+
+		stream >> domain >> rule;
+
+		cosmeticFiltersDomainExceptions.insert(domain, rule);
+	}
+
+	Trie trie;
+	quint32 nodeSize(0);
+	quint32 ruleSize(0);
+	qint32 byteOrder(0);
+	quint32 textsLength(0);
+	quint32 nodesAmount(0);
+	quint32 rulesAmount(0);
+	quint32 ruleDomainsAmount(0);
+
+	stream >> nodeSize >> ruleSize >> byteOrder >> trie.domains >> textsLength >> nodesAmount >> rulesAmount >> ruleDomainsAmount;
+
+	const qint64 headerSize(stream.device()->pos());
+	const qint64 dataPosition(headerSize + ((CacheAlignment - (headerSize % CacheAlignment)) % CacheAlignment));
+	const quint64 nodesSize(static_cast<quint64>(nodesAmount) * sizeof(Trie::Node));
+	const quint64 rulesSize(static_cast<quint64>(rulesAmount) * sizeof(Trie::Rule));
+	const quint64 ruleDomainsSize(static_cast<quint64>(ruleDomainsAmount) * sizeof(quint32));
+	const quint64 textsSize(static_cast<quint64>(textsLength) * sizeof(QChar));
+	bool isValid(stream.status() == QDataStream::Ok && nodeSize == sizeof(Trie::Node) && ruleSize == sizeof(Trie::Rule) && byteOrder == QSysInfo::ByteOrder && nodesAmount > 0 && (static_cast<quint64>(dataPosition) + nodesSize + rulesSize + ruleDomainsSize + textsSize) <= static_cast<quint64>(mappedData.size()));
+
+	if (isValid)
+	{
+		const char *nodesData(mappedData.constData() + dataPosition);
+		const char *rulesData(nodesData + nodesSize);
+		const char *ruleDomainsData(rulesData + rulesSize);
+		const char *textsData(ruleDomainsData + ruleDomainsSize);
+		const bool isAligned((reinterpret_cast<quintptr>(nodesData) % alignof(Trie::Node)) == 0 && (reinterpret_cast<quintptr>(rulesData) % alignof(Trie::Rule)) == 0 && (reinterpret_cast<quintptr>(ruleDomainsData) % alignof(quint32)) == 0 && (reinterpret_cast<quintptr>(textsData) % alignof(QChar)) == 0);
+
+		if (isShared && data && isAligned)
+		{
+			trie.mappedFile = file;
+			trie.mappedNodes = reinterpret_cast<const Trie::Node*>(nodesData);
+			trie.mappedRules = reinterpret_cast<const Trie::Rule*>(rulesData);
+			trie.mappedRuleDomains = reinterpret_cast<const quint32*>(ruleDomainsData);
+			trie.mappedNodesAmount = static_cast<int>(nodesAmount);
+			trie.mappedRulesAmount = static_cast<int>(rulesAmount);
+			trie.mappedRuleDomainsAmount = static_cast<int>(ruleDomainsAmount);
+			trie.texts = QString::fromRawData(reinterpret_cast<const QChar*>(textsData), static_cast<int>(textsLength));
+		}
+		else
+		{
+			trie.nodes.resize(static_cast<int>(nodesAmount));
+			trie.rules.resize(static_cast<int>(rulesAmount));
+			trie.ruleDomains.resize(static_cast<int>(ruleDomainsAmount));
+			trie.texts = QString(static_cast<int>(textsLength), Qt::Uninitialized);
+
+			memcpy(trie.nodes.data(), nodesData, static_cast<size_t>(nodesSize));
+			memcpy(trie.rules.data(), rulesData, static_cast<size_t>(rulesSize));
+			memcpy(trie.ruleDomains.data(), ruleDomainsData, static_cast<size_t>(ruleDomainsSize));
+			memcpy(trie.texts.data(), textsData, static_cast<size_t>(textsSize));
+		}
+	}
+
+	if (!trie.mappedFile)
+	{
+		if (data)
+		{
+			file->unmap(data);
+		}
+
+		file->close();
+	}
+
+	for (int i = 0; (isValid && i < trie.getNodesAmount()); ++i)
+	{
+		const Trie::Node &node(trie.getNode(i));
+
+		isValid = ((static_cast<quint64>(node.firstChild) + node.childrenAmount) <= nodesAmount && (static_cast<quint64>(node.firstRule) + node.rulesAmount) <= rulesAmount && (node.childrenAmount == 0 || node.firstChild > static_cast<quint32>(i)));
+	}
+
+	for (int i = 0; (isValid && i < trie.getRulesAmount()); ++i)
+	{
+		const Trie::Rule &rule(trie.getRule(i));
+
+		isValid = ((static_cast<quint64>(rule.textPosition) + rule.textLength) <= static_cast<quint64>(trie.texts.length()) && (static_cast<quint64>(rule.firstDomain) + rule.blockedDomainsAmount + rule.allowedDomainsAmount) <= ruleDomainsAmount && rule.ruleMatch >= ContainsMatch && rule.ruleMatch <= ExactMatch);
+	}
+
+	for (int i = 0; (isValid && i < trie.getRuleDomainsAmount()); ++i)
+	{
+		isValid = (trie.getRuleDomain(i) < static_cast<quint32>(trie.domains.count()));
+	}
+
+	if (!isValid)
+	{
+		return false;
+	}
+
+	snapshot->trie = trie;
+	snapshot->statistics = statistics;
+
+	m_cosmeticFiltersRules = cosmeticFiltersRules;
+	m_cosmeticFiltersDomainRules = cosmeticFiltersDomainRules;
+	m_cosmeticFiltersDomainExceptions = cosmeticFiltersDomainExceptions;
+
+	return true;
+}
+
+bool AdblockContentFiltersProfile::loadRules()
+{
+	if (m_loadingWatcher)
+	{
+		m_loadingWatcher->waitForFinished();
+
+		handleRulesLoaded();
+
+		return true;
+	}
+
+	if (m_wasLoaded)
+	{
+		return true;
+	}
 
-	if (!m_wasLoaded && !loadRules())
+	if (!prepareLoading())
 	{
-		return result;
+		return false;
 	}
 
-	const Request request(baseUrl, requestUrl, resourceType);
-
-	for (int i = 0; i < request.requestUrl.length(); ++i)
+	if (!parseRules())
 	{
-		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(m_root, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
-
-		if (currentResult.isBlocked)
-		{
-			result = currentResult;
-		}
-		else if (currentResult.isException)
-		{
-			return currentResult;
-		}
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save content blocking profile cache"), Console::OtherCategory, Console::WarningLevel, getCachePath());
 	}
 
-	return result;
+	m_wasLoaded = true;
+
+	emit profileLoaded();
+
+	return true;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const
+bool AdblockContentFiltersProfile::prepareLoading()
 {
-	ContentFiltersManager::CheckResult result;
+	m_error = NoError;
+	m_matchingEngine = ((SettingsManager::getOption(SettingsManager::ContentBlocking_MatchingEngineOption).toString() == QLatin1String("tokenIndex")) ? TokenIndexMatchingEngine : TrieMatchingEngine);
+	m_sharedCachePath = SettingsManager::getOption(SettingsManager::ContentBlocking_SharedCachePathOption).toString();
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	if (!QFile::exists(getPath()) && !m_profileSummary.updateUrl.isEmpty())
 	{
-		if (node->rules.at(i))
-		{
-			ContentFiltersManager::CheckResult currentResult(checkRuleMatch(node->rules.at(i), currentRule, request));
+		update();
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
-		}
+		return false;
 	}
 
-	return result;
+	return true;
 }
 
-AdblockContentFiltersProfile::HeaderInformation AdblockContentFiltersProfile::loadHeader(QIODevice *rulesDevice)
+bool AdblockContentFiltersProfile::parseRules()
 {
-	HeaderInformation information;
-	QTextStream stream(rulesDevice);
-	stream.setCodec("UTF-8");
+	const Tracer::Span span("AdblockContentFiltersProfile::parseRules", "contentFilters");
 
-	const QString header(stream.readLine());
+	QFile file(getPath());
+	file.open(QIODevice::ReadOnly | QIODevice::Text);
 
-	if (!header.contains(QLatin1String("[Adblock"), Qt::CaseInsensitive))
-	{
-		information.errorString = QCoreApplication::translate("main", "Failed to update content blocking profile: invalid header");
-		information.error = ParseError;
+	const QByteArray data(file.readAll());
+	const QByteArray checksum(QCryptographicHash::hash(data, QCryptographicHash::Md5));
 
-		return information;
-	}
+	file.close();
 
-	int lineNumber(1);
+	std::shared_ptr<Snapshot> snapshot(new Snapshot());
+	snapshot->matchingEngine = m_matchingEngine;
 
-	while (!stream.atEnd())
+	bool isCacheSaved(true);
+
+	if (!loadCache(getSharedCachePath(), checksum, snapshot.get(), true) && !loadCache(getCachePath(), checksum, snapshot.get(), false))
 	{
-		const QString line(stream.readLine().trimmed());
+		QTextStream stream(data);
+		stream.setCodec("UTF-8");
+		stream.readLine(); // header
 
-		if (line.startsWith(QLatin1String("! Title: ")))
+		Node *root(new Node());
+
+		while (!stream.atEnd())
 		{
-			information.title = line.section(QLatin1Char(':'), 1).trimmed();
+			const QString rule(stream.readLine());
 
-			continue;
+			parseRuleLine(rule, root);
+			countRule(rule, snapshot->statistics);
 		}
 
-		if (lineNumber > 50)
-		{
-			break;
-		}
+		compileTrie(root, snapshot->trie);
+		deleteNode(root);
 
-		++lineNumber;
+		isCacheSaved = saveCache(checksum, *snapshot);
 	}
 
-	return information;
-}
-
-QHash<AdblockContentFiltersProfile::RuleType, quint32> AdblockContentFiltersProfile::loadRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary, QIODevice *rulesDevice)
-{
-	QHash<RuleType, quint32> information({{AnyRule, 0}, {ActiveRule, 0}, {CosmeticRule, 0}, {WildcardRule, 0}});
-	QTextStream stream(rulesDevice);
-	stream.setCodec("UTF-8");
-	stream.readLine();
-
-	while (!stream.atEnd())
+	if (m_matchingEngine == TokenIndexMatchingEngine)
 	{
-		const QString line(stream.readLine().simplified());
+		buildTokenIndex({&snapshot->trie}, snapshot->tokenIndex);
+	}
 
-		if (line.isEmpty() || line.startsWith(QLatin1Char('!')))
-		{
-			continue;
-		}
+	buildElementHideIndex(snapshot->trie, snapshot->elementHideIndex);
 
-		++information[AnyRule];
+	std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(snapshot));
 
-		if (line.startsWith(QLatin1String("##")))
-		{
-			++information[CosmeticRule];
+	return isCacheSaved;
+}
 
-			if (profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
-			{
-				++information[ActiveRule];
-			}
+bool AdblockContentFiltersProfile::applyRulesDifference(const QByteArray &previousData)
+{
+	const std::shared_ptr<const Snapshot> previousSnapshot(getSnapshot());
+	QFile file(getPath());
+	file.open(QIODevice::ReadOnly | QIODevice::Text);
 
-			continue;
-		}
+	const QByteArray data(file.readAll());
+	const QByteArray checksum(QCryptographicHash::hash(data, QCryptographicHash::Md5));
 
-		if (line.contains(QLatin1String("##")))
-		{
-			++information[CosmeticRule];
+	file.close();
 
-			if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
-			{
-				++information[ActiveRule];
-			}
+	QHash<QString, int> rulesDifference;
+	const int rulesAmount(countRules(data, 1, rulesDifference));
 
-			continue;
-		}
+	countRules(previousData, -1, rulesDifference);
 
-		if (line.contains(QLatin1String("#@#")))
-		{
-			++information[CosmeticRule];
+	QStringList addedRules;
+	QHash<QString, int> removedRules;
+	int changesAmount(0);
+	QHash<QString, int>::const_iterator iterator;
 
-			if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+	for (iterator = rulesDifference.constBegin(); iterator != rulesDifference.constEnd(); ++iterator)
+	{
+		if (iterator.value() > 0)
+		{
+			for (int i = 0; i < iterator.value(); ++i)
 			{
-				++information[ActiveRule];
+				addedRules.append(iterator.key());
 			}
-
-			continue;
 		}
-
-		if (line.contains(QLatin1Char('*')))
+		else if (iterator.value() < 0)
 		{
-			++information[WildcardRule];
-
-			if (profileSummary.areWildcardsEnabled)
-			{
-				++information[ActiveRule];
-			}
-
-			continue;
+			removedRules[iterator.key()] = -iterator.value();
 		}
 
-		++information[ActiveRule];
+		changesAmount += qAbs(iterator.value());
 	}
 
-	return information;
-}
-
-QVector<QLocale::Language> AdblockContentFiltersProfile::getLanguages() const
-{
-	return m_languages;
-}
-
-ContentFiltersProfile::ProfileCategory AdblockContentFiltersProfile::getCategory() const
-{
-	return m_profileSummary.category;
-}
-
-ContentFiltersManager::CosmeticFiltersMode AdblockContentFiltersProfile::getCosmeticFiltersMode() const
-{
-	return m_profileSummary.cosmeticFiltersMode;
-}
-
-ContentFiltersProfile::ProfileError AdblockContentFiltersProfile::getError() const
-{
-	return m_error;
-}
-
-ContentFiltersProfile::ProfileFlags AdblockContentFiltersProfile::getFlags() const
-{
-	return m_flags;
-}
+	if (!previousSnapshot || changesAmount > (rulesAmount / 4))
+	{
+		m_cosmeticFiltersRules.clear();
+		m_cosmeticFiltersDomainRules.clear();
+		m_cosmeticFiltersDomainExceptions.clear();
 
-int AdblockContentFiltersProfile::getUpdateInterval() const
-{
-	return m_profileSummary.updateInterval;
-}
+		const bool isCacheSaved(parseRules());
 
-int AdblockContentFiltersProfile::getUpdateProgress() const
-{
-	return (m_dataFetchJob ? m_dataFetchJob->getProgress() : -1);
-}
+		removeMergedIndexes(this);
 
-bool AdblockContentFiltersProfile::create(const ContentFiltersProfile::ProfileSummary &profileSummary, QIODevice *rulesDevice, bool canOverwriteExisting)
-{
-	const QString path(SessionsManager::getWritableDataPath(QStringLiteral("contentBlocking/%1.txt")).arg(profileSummary.name));
+		return isCacheSaved;
+	}
 
-	if (SessionsManager::isReadOnly() || (!canOverwriteExisting && QFile::exists(path)))
+	if (changesAmount == 0)
 	{
-		Console::addMessage(QCoreApplication::translate("main", "Failed to create a content blocking profile: %1").arg(tr("File already exists")), Console::OtherCategory, Console::ErrorLevel, path);
-
-		return false;
+		return saveCache(checksum, *previousSnapshot);
 	}
 
-	if (rulesDevice)
-	{
-		QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking")));
+	QHash<QString, int>::iterator removedIterator(removedRules.begin());
 
-		QFile file(path);
+	while (removedIterator != removedRules.end())
+	{
+		const QString &rule(removedIterator.key());
+		const bool isCosmeticRule(rule.contains(QLatin1String("##")) || rule.contains(QLatin1String("#@#")));
 
-		if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		for (int i = 0; (isCosmeticRule && i < removedIterator.value()); ++i)
 		{
-			Console::addMessage(QCoreApplication::translate("main", "Failed to create a content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
-
-			return false;
+			if (rule.startsWith(QLatin1String("##")))
+			{
+				m_cosmeticFiltersRules.removeOne(rule.mid(2));
+			}
+			else if (rule.contains(QLatin1String("##")))
+			{
+				removeStyleSheetRule(rule.split(QLatin1String("##")), m_cosmeticFiltersDomainRules);
+			}
+			else
+			{
+				removeStyleSheetRule(rule.split(QLatin1String("#@#")), m_cosmeticFiltersDomainExceptions);
+			}
 		}
 
-		file.write(rulesDevice->readAll());
-		file.close();
+		if (isCosmeticRule)
+		{
+			removedIterator = removedRules.erase(removedIterator);
+		}
+		else
+		{
+			++removedIterator;
+		}
 	}
 
-	ProfileFlags flags(NoFlags);
+	const Trie &previousTrie(previousSnapshot->trie);
+	QVector<Node*> nodes(previousTrie.getNodesAmount(), nullptr);
+	nodes[0] = new Node();
 
-	if (!profileSummary.title.isEmpty())
+	for (int i = 0; i < previousTrie.getNodesAmount(); ++i)
 	{
-		flags |= HasCustomTitleFlag;
-	}
+		const Trie::Node &compiledNode(previousTrie.getNode(i));
+		Node *node(nodes.at(i));
+		node->value = compiledNode.value;
 
-	AdblockContentFiltersProfile *profile(new AdblockContentFiltersProfile(profileSummary, {}, flags, ContentFiltersManager::getInstance()));
+		for (quint32 j = 0; j < compiledNode.childrenAmount; ++j)
+		{
+			Node *childNode(new Node());
 
-	ContentFiltersManager::addProfile(profile);
+			nodes[static_cast<int>(compiledNode.firstChild + j)] = childNode;
 
-	if (!rulesDevice && profileSummary.updateUrl.isValid())
-	{
-		profile->update();
-	}
+			node->children.append(childNode);
+		}
 
-	return true;
-}
+		for (quint32 j = compiledNode.firstRule; j < (compiledNode.firstRule + compiledNode.rulesAmount); ++j)
+		{
+			const Trie::Rule &compiledRule(previousTrie.getRule(static_cast<int>(j)));
+			const QString text(previousTrie.texts.mid(static_cast<int>(compiledRule.textPosition), static_cast<int>(compiledRule.textLength)));
 
-bool AdblockContentFiltersProfile::loadRules()
-{
-	const QString path(getPath());
+			if (removedRules.value(text) > 0)
+			{
+				--removedRules[text];
 
-	m_error = NoError;
+				continue;
+			}
 
-	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
-	{
-		update();
+			Node::Rule *rule(new Node::Rule());
+			rule->rule = text;
+			rule->ruleOptions = compiledRule.ruleOptions;
+			rule->ruleExceptions = compiledRule.ruleExceptions;
+			rule->ruleMatch = compiledRule.ruleMatch;
+			rule->isException = compiledRule.isException;
+			rule->needsDomainCheck = compiledRule.needsDomainCheck;
 
-		return false;
+			for (quint32 k = 0; k < (static_cast<quint32>(compiledRule.blockedDomainsAmount) + compiledRule.allowedDomainsAmount); ++k)
+			{
+				const QString &domain(previousTrie.domains.at(static_cast<int>(previousTrie.getRuleDomain(static_cast<int>(compiledRule.firstDomain + k)))));
+
+				if (k < compiledRule.blockedDomainsAmount)
+				{
+					rule->blockedDomains.append(domain);
+				}
+				else
+				{
+					rule->allowedDomains.append(domain);
+				}
+			}
+
+			node->rules.append(rule);
+		}
 	}
 
-	m_wasLoaded = true;
+	Node *root(nodes.at(0));
 
-	if (m_domainExpression.pattern().isEmpty())
+	for (int i = 0; i < addedRules.count(); ++i)
 	{
-		m_domainExpression = QRegularExpression(QLatin1String("[:\?&/=]"));
-		m_domainExpression.optimize();
+		parseRuleLine(addedRules.at(i), root);
 	}
 
-	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
+	std::shared_ptr<Snapshot> snapshot(new Snapshot());
+	snapshot->matchingEngine = m_matchingEngine;
+	snapshot->statistics = previousSnapshot->statistics;
 
-	QTextStream stream(&file);
-	stream.setCodec("UTF-8");
-	stream.readLine(); // header
+	for (iterator = rulesDifference.constBegin(); iterator != rulesDifference.constEnd(); ++iterator)
+	{
+		if (iterator.value() != 0)
+		{
+			countRule(iterator.key(), snapshot->statistics, iterator.value());
+		}
+	}
 
-	m_root = new Node();
+	compileTrie(root, snapshot->trie);
+	deleteNode(root);
 
-	while (!stream.atEnd())
+	const bool isCacheSaved(saveCache(checksum, *snapshot));
+
+	if (m_matchingEngine == TokenIndexMatchingEngine)
 	{
-		parseRuleLine(stream.readLine());
+		buildTokenIndex({&snapshot->trie}, snapshot->tokenIndex);
 	}
 
-	file.close();
+	buildElementHideIndex(snapshot->trie, snapshot->elementHideIndex);
 
-	return true;
+	std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(snapshot));
+
+	removeMergedIndexes(this);
+
+	return isCacheSaved;
 }
 
 bool AdblockContentFiltersProfile::update(const QUrl &url)
@@ -1011,6 +2514,12 @@ bool AdblockContentFiltersProfile::update(const QUrl &url)
 
 	const QUrl updateUrl(url.isValid() ? url : m_profileSummary.updateUrl);
 
+	if (updateUrl != m_profileSummary.updateUrl)
+	{
+		m_profileSummary.updateEntityTag.clear();
+		m_profileSummary.updateLastModified.clear();
+	}
+
 	if (!updateUrl.isValid())
 	{
 		if (updateUrl.isEmpty())
@@ -1027,6 +2536,19 @@ bool AdblockContentFiltersProfile::update(const QUrl &url)
 
 	m_dataFetchJob = new DataFetchJob(updateUrl, this);
 
+	if (QFile::exists(getPath()))
+	{
+		if (!m_profileSummary.updateEntityTag.isEmpty())
+		{
+			m_dataFetchJob->setHeader(QByteArrayLiteral("If-None-Match"), m_profileSummary.updateEntityTag.toLatin1());
+		}
+
+		if (!m_profileSummary.updateLastModified.isEmpty())
+		{
+			m_dataFetchJob->setHeader(QByteArrayLiteral("If-Modified-Since"), m_profileSummary.updateLastModified.toLatin1());
+		}
+	}
+
 	connect(m_dataFetchJob, &Job::jobFinished, this, &AdblockContentFiltersProfile::handleJobFinished);
 	connect(m_dataFetchJob, &Job::progressChanged, this, &AdblockContentFiltersProfile::updateProgressChanged);
 
@@ -1048,6 +2570,13 @@ bool AdblockContentFiltersProfile::remove()
 		m_dataFetchJob = nullptr;
 	}
 
+	const QString cachePath(getCachePath());
+
+	if (!cachePath.isEmpty() && QFile::exists(cachePath))
+	{
+		QFile::remove(cachePath);
+	}
+
 	if (QFile::exists(path))
 	{
 		return QFile::remove(path);
@@ -1056,11 +2585,11 @@ bool AdblockContentFiltersProfile::remove()
 	return true;
 }
 
-bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const QStringList &ruleList) const
+bool AdblockContentFiltersProfile::resolveDomainExceptions(const QString &url, const Trie &trie, quint32 firstDomain, quint32 amount) const
 {
-	for (int i = 0; i < ruleList.count(); ++i)
+	for (quint32 i = firstDomain; i < (firstDomain + amount); ++i)
 	{
-		if (url.contains(ruleList.at(i)))
+		if (url.contains(trie.domains.at(static_cast<int>(trie.getRuleDomain(static_cast<int>(i))))))
 		{
 			return true;
 		}
@@ -1076,9 +2605,47 @@ bool AdblockContentFiltersProfile::areWildcardsEnabled() const
 
 bool AdblockContentFiltersProfile::isFraud(const QUrl &url)
 {
-	Q_UNUSED(url)
+	const std::shared_ptr<const Snapshot> snapshot(getSnapshot());
 
-	return false;
+	if (!snapshot)
+	{
+		return checkUrl(ContentFiltersManager::RequestContext(url, url, NetworkManager::MainFrameType)).isBlocked;
+	}
+
+	std::shared_ptr<const HostSet> hostSet(std::atomic_load(&snapshot->hostSet));
+
+	if (!hostSet)
+	{
+		std::shared_ptr<HostSet> newHostSet(new HostSet());
+
+		buildHostSet(snapshot->trie, *newHostSet);
+
+		hostSet = newHostSet;
+
+		std::atomic_store(&snapshot->hostSet, hostSet);
+	}
+
+	const QString host(url.host().toLower());
+	bool hasMatch(false);
+
+	for (int position = 0; (!hasMatch && position >= 0 && position < host.length()); )
+	{
+		hasMatch = hostSet->contains(hashHost(host.midRef(position)));
+
+		position = host.indexOf(QLatin1Char('.'), position);
+
+		if (position >= 0)
+		{
+			++position;
+		}
+	}
+
+	if ((hasMatch && hostSet->hasExceptionRules) || (!hasMatch && hostSet->hasPatternRules))
+	{
+		return checkUrl(ContentFiltersManager::RequestContext(url, url, NetworkManager::MainFrameType)).isBlocked;
+	}
+
+	return hasMatch;
 }
 
 bool AdblockContentFiltersProfile::isUpdating() const
@@ -1086,4 +2653,9 @@ bool AdblockContentFiltersProfile::isUpdating() const
 	return (m_dataFetchJob != nullptr);
 }
 
+bool AdblockContentFiltersProfile::isReady() const
+{
+	return static_cast<bool>(getSnapshot());
+}
+
 }
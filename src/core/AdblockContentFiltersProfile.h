@@ -24,7 +24,13 @@
 
 #include "ContentFiltersManager.h"
 
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+
+#include <algorithm>
+#include <memory>
 
 namespace Otter
 {
@@ -44,6 +50,14 @@ public:
 		WildcardRule
 	};
 
+	struct RulesStatistics final
+	{
+		qint32 rulesAmount = 0;
+		qint32 genericCosmeticRulesAmount = 0;
+		qint32 domainCosmeticRulesAmount = 0;
+		qint32 wildcardRulesAmount = 0;
+	};
+
 	struct HeaderInformation final
 	{
 		QString title;
@@ -58,8 +72,10 @@ public:
 	};
 
 	explicit AdblockContentFiltersProfile(const ProfileSummary &profileSummary, const QStringList &languages, ProfileFlags flags, QObject *parent = nullptr);
+	~AdblockContentFiltersProfile();
 
 	void clear() override;
+	void load() override;
 	void setProfileSummary(const ProfileSummary &profileSummary) override;
 	QString getName() const override;
 	QString getTitle() const override;
@@ -68,22 +84,27 @@ public:
 	QDateTime getLastUpdate() const override;
 	ProfileSummary getProfileSummary() const override;
 	ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) override;
-	ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) override;
+	ContentFiltersManager::CheckResult checkUrl(const ContentFiltersManager::RequestContext &context) override;
+	ContentFiltersManager::CosmeticFiltersMode checkCosmeticFiltersMode(const QUrl &url) override;
 	static HeaderInformation loadHeader(QIODevice *rulesDevice);
 	static QHash<RuleType, quint32> loadRulesInformation(const ProfileSummary &profileSummary, QIODevice *rulesDevice);
+	QHash<RuleType, quint32> getRulesInformation(const ProfileSummary &profileSummary) const;
 	QVector<QLocale::Language> getLanguages() const override;
 	ProfileCategory getCategory() const override;
 	ContentFiltersManager::CosmeticFiltersMode getCosmeticFiltersMode() const override;
 	ProfileError getError() const override;
 	ProfileFlags getFlags() const override;
+	quint64 getMemoryUsage() const override;
 	int getUpdateInterval() const override;
 	int getUpdateProgress() const override;
 	static bool create(const ProfileSummary &profileSummary, QIODevice *rulesDevice = nullptr, bool canOverwriteExisting = false);
+	static bool checkUrlMerged(const QVector<AdblockContentFiltersProfile*> &profiles, const ContentFiltersManager::RequestContext &context, ContentFiltersManager::CheckResult &result);
 	bool update(const QUrl &url = {}) override;
 	bool remove() override;
 	bool areWildcardsEnabled() const override;
 	bool isFraud(const QUrl &url) override;
 	bool isUpdating() const override;
+	bool isReady() const override;
 
 protected:
 	enum RuleOption : quint16
@@ -105,6 +126,19 @@ protected:
 
 	Q_DECLARE_FLAGS(RuleOptions, RuleOption)
 
+	enum CacheFormat : quint32
+	{
+		CacheMagicNumber = 0x4F414243,
+		CacheFormatVersion = 4,
+		CacheAlignment = 8
+	};
+
+	enum HostSetParameter
+	{
+		BloomFilterBitsPerHost = 12,
+		BloomFilterProbes = 4
+	};
+
 	enum RuleMatch
 	{
 		ContainsMatch = 0,
@@ -113,6 +147,12 @@ protected:
 		ExactMatch
 	};
 
+	enum MatchingEngine
+	{
+		TrieMatchingEngine = 0,
+		TokenIndexMatchingEngine
+	};
+
 	struct Node final
 	{
 		struct Rule final
@@ -132,49 +172,259 @@ protected:
 		QVarLengthArray<Rule*, 1> rules;
 	};
 
-	struct Request final
+	struct Trie final
 	{
-		QString baseHost;
-		QString requestHost;
-		QString requestUrl;
-		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+		struct Node final
+		{
+			quint32 firstChild = 0;
+			quint32 firstRule = 0;
+			quint16 childrenAmount = 0;
+			quint16 rulesAmount = 0;
+			QChar value = 0;
+		};
+
+		struct Rule final
+		{
+			quint32 textPosition = 0;
+			quint32 textLength = 0;
+			quint32 firstDomain = 0;
+			quint16 blockedDomainsAmount = 0;
+			quint16 allowedDomainsAmount = 0;
+			RuleOptions ruleOptions = NoOption;
+			RuleOptions ruleExceptions = NoOption;
+			RuleMatch ruleMatch = ContainsMatch;
+			bool isException = false;
+			bool needsDomainCheck = false;
+		};
+
+		const Node* getNodes() const
+		{
+			return (mappedNodes ? mappedNodes : nodes.constData());
+		}
+
+		const Rule* getRules() const
+		{
+			return (mappedRules ? mappedRules : rules.constData());
+		}
+
+		const quint32* getRuleDomains() const
+		{
+			return (mappedRuleDomains ? mappedRuleDomains : ruleDomains.constData());
+		}
+
+		const Node& getNode(int index) const
+		{
+			return getNodes()[index];
+		}
+
+		const Rule& getRule(int index) const
+		{
+			return getRules()[index];
+		}
+
+		quint32 getRuleDomain(int index) const
+		{
+			return getRuleDomains()[index];
+		}
+
+		int getNodesAmount() const
+		{
+			return (mappedNodes ? mappedNodesAmount : nodes.count());
+		}
+
+		int getRulesAmount() const
+		{
+			return (mappedNodes ? mappedRulesAmount : rules.count());
+		}
 
-		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), resourceType(resourceTypeValue)
+		int getRuleDomainsAmount() const
 		{
-			if (requestUrl.startsWith(QLatin1String("//")))
+			return (mappedNodes ? mappedRuleDomainsAmount : ruleDomains.count());
+		}
+
+		bool isEmpty() const
+		{
+			return (getNodesAmount() == 0);
+		}
+
+		QVector<Node> nodes;
+		QVector<Rule> rules;
+		QVector<quint32> ruleDomains;
+		QStringList domains;
+		QString texts;
+		std::shared_ptr<QFile> mappedFile;
+		const Node *mappedNodes = nullptr;
+		const Rule *mappedRules = nullptr;
+		const quint32 *mappedRuleDomains = nullptr;
+		int mappedNodesAmount = 0;
+		int mappedRulesAmount = 0;
+		int mappedRuleDomainsAmount = 0;
+	};
+
+	struct TokenIndex final
+	{
+		struct Entry final
+		{
+			QString pattern;
+			const Trie *trie = nullptr;
+			const Trie::Rule *rule = nullptr;
+			int tokenOffset = -1;
+			int profile = 0;
+		};
+
+		struct Slot final
+		{
+			quint32 hash = 0;
+			int first = 0;
+			int amount = 0;
+		};
+
+		struct Token final
+		{
+			quint32 hash = 0;
+			int position = -1;
+			int length = 0;
+		};
+
+		QVector<Slot> slots;
+		QVector<Entry> entries;
+		QVector<Entry> untokenizedEntries;
+
+		int findSlot(quint32 hash) const
+		{
+			if (slots.isEmpty())
+			{
+				return -1;
+			}
+
+			const int mask(slots.count() - 1);
+
+			for (int i = static_cast<int>(hash & static_cast<quint32>(mask)); ; i = ((i + 1) & mask))
 			{
-				requestUrl = requestUrl.mid(2);
+				if (slots.at(i).hash == hash)
+				{
+					return i;
+				}
+
+				if (slots.at(i).hash == 0)
+				{
+					return -1;
+				}
 			}
 		}
 	};
 
+	struct ElementHideIndex final
+	{
+		QHash<QString, ContentFiltersManager::CosmeticFiltersMode> domains;
+		bool hasPatternRules = false;
+	};
+
+	struct HostSet final
+	{
+		QVector<quint64> bloomFilter;
+		QVector<quint64> hashes;
+		bool hasExceptionRules = false;
+		bool hasPatternRules = false;
+
+		bool contains(quint64 hash) const
+		{
+			if (bloomFilter.isEmpty())
+			{
+				return false;
+			}
+
+			const quint64 mask((static_cast<quint64>(bloomFilter.count()) * 64) - 1);
+			const quint64 step((hash >> 32) | 1);
+
+			for (int i = 0; i < BloomFilterProbes; ++i)
+			{
+				const quint64 bit((hash + (i * step)) & mask);
+
+				if (!(bloomFilter.at(static_cast<int>(bit >> 6)) & (static_cast<quint64>(1) << (bit & 63))))
+				{
+					return false;
+				}
+			}
+
+			return std::binary_search(hashes.constBegin(), hashes.constEnd(), hash);
+		}
+	};
+
+	struct Snapshot final
+	{
+		Trie trie;
+		TokenIndex tokenIndex;
+		ElementHideIndex elementHideIndex;
+		mutable std::shared_ptr<const HostSet> hostSet;
+		RulesStatistics statistics;
+		MatchingEngine matchingEngine = TrieMatchingEngine;
+	};
+
+	struct MergedIndex final
+	{
+		QVector<std::shared_ptr<const Snapshot> > snapshots;
+		TokenIndex tokenIndex;
+	};
+
 	void loadHeader();
-	void parseRuleLine(const QString &rule);
+	void parseRuleLine(const QString &rule, Node *root);
 	void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
-	void deleteNode(Node *node) const;
-	ContentFiltersManager::CheckResult checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const;
+	void removeStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
+	static void compileTrie(const Node *root, Trie &trie);
+	static void collectRules(const Trie &trie, quint32 node, QString &pattern, QVector<TokenIndex::Entry> &entries);
+	static void buildTokenIndex(const QVector<const Trie*> &tries, TokenIndex &tokenIndex);
+	static void buildElementHideIndex(const Trie &trie, ElementHideIndex &elementHideIndex);
+	static void buildHostSet(const Trie &trie, HostSet &hostSet);
+	static void buildMergedIndex(const QVector<const AdblockContentFiltersProfile*> &profiles, const QVector<std::shared_ptr<const Snapshot> > &snapshots);
+	static void removeMergedIndexes(const AdblockContentFiltersProfile *profile);
+	static void deleteNode(Node *node);
+	static void countRule(const QString &rule, RulesStatistics &statistics, int change = 1);
+	QString getCachePath() const;
+	QString getSharedCachePath() const;
+	std::shared_ptr<const Snapshot> getSnapshot() const;
+	ContentFiltersManager::CheckResult checkUrlSubstring(const Trie &trie, int start, const ContentFiltersManager::RequestContext &context) const;
+	ContentFiltersManager::CheckResult checkRuleMatch(const Trie &trie, const Trie::Rule &rule, int position, int length, const ContentFiltersManager::RequestContext &context) const;
+	ContentFiltersManager::CheckResult evaluateNodeRules(const Trie &trie, const Trie::Node &node, int position, int length, const ContentFiltersManager::RequestContext &context) const;
+	ContentFiltersManager::CheckResult evaluateTokenIndexEntry(const TokenIndex::Entry &entry, int position, const ContentFiltersManager::RequestContext &context) const;
+	ContentFiltersManager::CheckResult checkUrlTokens(const TokenIndex &tokenIndex, const ContentFiltersManager::RequestContext &context) const;
+	static QHash<RuleType, quint32> createRulesInformation(const RulesStatistics &statistics, const ProfileSummary &profileSummary);
+	static QVector<TokenIndex::Token> tokenizePattern(const QString &pattern, const Trie::Rule *rule);
+	static quint32 hashToken(const QString &text, int position, int length);
+	static quint64 hashHost(const QStringRef &host);
+	static int countRules(const QByteArray &data, int change, QHash<QString, int> &rules);
+	static int matchPattern(const QString &pattern, const PreprocessedUrl &preprocessedUrl, int position, bool needsEnd);
+	bool loadCache(const QString &path, const QByteArray &checksum, Snapshot *snapshot, bool isShared);
+	bool saveCache(const QByteArray &checksum, const Snapshot &snapshot) const;
 	bool loadRules();
-	bool resolveDomainExceptions(const QString &url, const QStringList &ruleList) const;
+	bool prepareLoading();
+	bool parseRules();
+	bool applyRulesDifference(const QByteArray &previousData);
+	bool resolveDomainExceptions(const QString &url, const Trie &trie, quint32 firstDomain, quint32 amount) const;
 
 protected slots:
 	void raiseError(const QString &message, ProfileError error);
 	void handleJobFinished(bool isSuccess);
+	void handleRulesLoaded();
 
 private:
-	Node *m_root;
 	DataFetchJob *m_dataFetchJob;
+	QFutureWatcher<bool> *m_loadingWatcher;
 	ProfileSummary m_profileSummary;
-	QRegularExpression m_domainExpression;
+	QString m_sharedCachePath;
+	std::shared_ptr<const Snapshot> m_snapshot;
 	QStringList m_cosmeticFiltersRules;
 	QVector<QLocale::Language> m_languages;
 	QMultiHash<QString, QString> m_cosmeticFiltersDomainRules;
 	QMultiHash<QString, QString> m_cosmeticFiltersDomainExceptions;
 	ProfileError m_error;
 	ProfileFlags m_flags;
+	MatchingEngine m_matchingEngine;
 	bool m_wasLoaded;
 
+	static QHash<QVector<const AdblockContentFiltersProfile*>, std::shared_ptr<const MergedIndex> > m_mergedIndexes;
+	static QSet<QVector<const AdblockContentFiltersProfile*> > m_pendingMergedIndexes;
+	static QMutex m_mergedIndexesMutex;
 	static QHash<QString, RuleOption> m_options;
 	static QHash<NetworkManager::ResourceType, RuleOption> m_resourceTypes;
 };
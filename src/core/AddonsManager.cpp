@@ -22,6 +22,7 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "ThemesManager.h"
+#include "Tracer.h"
 #include "UserScript.h"
 #include "WebBackend.h"
 #ifdef OTTER_ENABLE_QTWEBENGINE
@@ -104,6 +105,8 @@ bool AddonsManager::m_areUserScriptsInitialized(false);
 
 AddonsManager::AddonsManager(QObject *parent) : QObject(parent)
 {
+	const Tracer::Span span("AddonsManager::registerWebBackends");
+
 #ifdef OTTER_ENABLE_QTWEBENGINE
 	registerWebBackend(new QtWebEngineWebBackend(this), QLatin1String("qtwebengine"));
 #endif
@@ -137,6 +140,7 @@ AddonsManager::AddonsManager(QObject *parent) : QObject(parent)
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Notes"), {}, QUrl(QLatin1String("about:notes")), ThemesManager::createIcon(QLatin1String("notes"), false), SpecialPageInformation::UniversalType), QLatin1String("notes"));
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Page Information"), {}, {}, ThemesManager::createIcon(QLatin1String("view-information"), false), SpecialPageInformation::SidebarPanelType), QLatin1String("pageInformation"));
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Passwords"), {}, QUrl(QLatin1String("about:passwords")), ThemesManager::createIcon(QLatin1String("dialog-password"), false), SpecialPageInformation::UniversalType), QLatin1String("passwords"));
+	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Performance"), {}, QUrl(QLatin1String("about:performance")), ThemesManager::createIcon(QLatin1String("task-ongoing"), false), SpecialPageInformation::UniversalType), QLatin1String("performance"));
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Preferences"), {}, QUrl(QLatin1String("about:preferences")), ThemesManager::createIcon(QLatin1String("configuration"), false), SpecialPageInformation::StandaloneType), QLatin1String("preferences"));
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Tab History"), {}, {}, ThemesManager::createIcon(QLatin1String("tab-history"), false), SpecialPageInformation::SidebarPanelType), QLatin1String("tabHistory"));
 	registerSpecialPage(SpecialPageInformation(QT_TRANSLATE_NOOP("addons", "Downloads"), {}, QUrl(QLatin1String("about:transfers")), ThemesManager::createIcon(QLatin1String("transfers"), false), SpecialPageInformation::UniversalType), QLatin1String("transfers"));
@@ -163,6 +167,8 @@ void AddonsManager::registerSpecialPage(const AddonsManager::SpecialPageInformat
 
 void AddonsManager::loadUserScripts()
 {
+	const Tracer::Span span("AddonsManager::loadUserScripts");
+
 	qDeleteAll(m_userScripts.values());
 
 	m_userScripts.clear();
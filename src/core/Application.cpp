@@ -22,26 +22,35 @@
 #include "AddonsManager.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "ContentFiltersManager.h"
+#include "CookieJar.h"
+#include "EventLoopWatchdog.h"
 #include "FeedsManager.h"
 #include "GesturesManager.h"
 #include "HandlersManager.h"
+#include "HistoryContentsIndex.h"
 #include "HistoryManager.h"
-#include "LongTermTimer.h"
+#include "MetricsExporter.h"
 #include "Migrator.h"
+#include "NetworkCache.h"
 #include "NetworkManagerFactory.h"
 #include "NotesManager.h"
 #include "NotificationsManager.h"
 #include "PasswordsManager.h"
+#include "PersistenceManager.h"
 #include "PlatformIntegration.h"
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
 #include "SpellCheckManager.h"
+#include "TabSuspensionManager.h"
 #include "TasksManager.h"
 #include "ToolBarsManager.h"
 #include "ThemesManager.h"
+#include "Tracer.h"
 #include "TransfersManager.h"
 #include "Utils.h"
 #include "Updater.h"
+#include "UserScript.h"
 #include "WebBackend.h"
 #ifdef Q_OS_WIN
 #include "../modules/platforms/windows/WindowsPlatformIntegration.h"
@@ -70,6 +79,8 @@
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QStorageInfo>
+#include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QTranslator>
 #include <QtGui/QDesktopServices>
 #include <QtNetwork/QLocalSocket>
@@ -77,6 +88,8 @@
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QPushButton>
 
+#include <algorithm>
+
 #define MESSAGE_IDENTIFIER ""
 #define MESSAGE_URL ""
 
@@ -94,13 +107,21 @@ QPointer<QObject> Application::m_nonMenuFocusObject(nullptr);
 QString Application::m_localePath;
 QCommandLineParser Application::m_commandLineParser;
 QVector<MainWindow*> Application::m_windows;
+QVector<QPair<QString, qint64> > Application::m_startupPhasesDurations;
+QVector<int> Application::m_eventLoopLags;
+QElapsedTimer Application::m_startupTimer;
+QElapsedTimer Application::m_eventLoopTimer;
+Application::StartupPhase Application::m_startupPhase(WindowStartupPhase);
+quint64 Application::m_slowOperationsAmount(0);
+int Application::m_eventLoopLagsPosition(0);
 bool Application::m_isAboutToQuit(false);
 bool Application::m_isFirstRun(false);
 bool Application::m_isHidden(false);
 bool Application::m_isUpdating(false);
 
 Application::Application(int &argc, char **argv) : QApplication(argc, argv),
-	m_updateCheckTimer(nullptr)
+	m_updateCheckTask(0),
+	m_eventLoopLagTimer(0)
 {
 	setApplicationName(QLatin1String("Otter"));
 	setApplicationDisplayName(QLatin1String("Otter Browser"));
@@ -108,8 +129,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	setWindowIcon(QIcon::fromTheme(QLatin1String("otter-browser"), QIcon(QLatin1String(":/icons/otter-browser.png"))));
 
 	m_instance = this;
+	m_startupTimer.start();
 
-	QString profilePath(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QLatin1String("/otter"));
 	QString cachePath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
 
 #ifdef Q_OS_DARWIN
@@ -127,85 +148,29 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	setLocale(QLatin1String("system"));
 
-	m_commandLineParser.addHelpOption();
-	m_commandLineParser.addVersionOption();
-	m_commandLineParser.addPositionalArgument(QLatin1String("url"), translate("main", "URL to open"), QLatin1String("[url]"));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("cache"), translate("main", "Uses <path> as cache directory"), QLatin1String("path"), {}));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("profile"), translate("main", "Uses <path> as profile directory"), QLatin1String("path"), {}));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("session"), translate("main", "Restores session <session> if it exists"), QLatin1String("session"), {}));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("private-session"), translate("main", "Starts private session")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("session-chooser"), translate("main", "Forces session chooser dialog")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("portable"), translate("main", "Sets profile and cache paths to directories inside the same directory as that of application binary")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("new-tab"), translate("main", "Loads URL in new tab")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("new-private-tab"), translate("main", "Loads URL in new private tab")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("new-window"), translate("main", "Loads URL in new window")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("new-private-window"), translate("main", "Loads URL in new private window")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("readonly"), translate("main", "Tells application to avoid writing data to disk")));
-	m_commandLineParser.addOption(QCommandLineOption(QLatin1String("report"), translate("main", "Prints out diagnostic report and exits application")));
-
-	QStringList arguments(Application::arguments());
-	QString argumentsPath(QDir::current().filePath(QLatin1String("arguments.txt")));
-	const QString applicationDirectoryPath(getApplicationDirectoryPath());
-
-	if (!QFile::exists(argumentsPath))
-	{
-		argumentsPath = QDir(applicationDirectoryPath).filePath(QLatin1String("arguments.txt"));
-	}
-
-	if (QFile::exists(argumentsPath))
-	{
-		QFile file(argumentsPath);
-
-		if (file.open(QIODevice::ReadOnly))
-		{
-			QStringList temporaryArguments(QString::fromLatin1(file.readAll()).trimmed().split(QLatin1Char(' '), QString::SkipEmptyParts));
-
-			if (!temporaryArguments.isEmpty())
-			{
-				if (arguments.isEmpty())
-				{
-					temporaryArguments.prepend(QFileInfo(applicationFilePath()).fileName());
-				}
-				else
-				{
-					temporaryArguments.prepend(arguments.value(0));
-				}
+	setupCommandLineParser(&m_commandLineParser);
 
-				if (arguments.count() > 1)
-				{
-					temporaryArguments.append(arguments.mid(1));
-				}
+	const QStringList arguments(loadArguments(Application::arguments()));
 
-				arguments = temporaryArguments;
-			}
+	m_commandLineParser.process(arguments);
 
-			file.close();
-		}
+	if (m_commandLineParser.isSet(QLatin1String("trace-startup")))
+	{
+		Tracer::start(QFileInfo(m_commandLineParser.value(QLatin1String("trace-startup"))).absoluteFilePath());
 	}
 
-	m_commandLineParser.process(arguments);
+	const Tracer::Span span("Application::Application");
 
 	const bool isPrivate(m_commandLineParser.isSet(QLatin1String("private-session")));
 	bool isReadOnly(m_commandLineParser.isSet(QLatin1String("readonly")));
 
-	if (m_commandLineParser.isSet(QLatin1String("portable")))
-	{
-		profilePath = applicationDirectoryPath + QLatin1String("/profile");
-		cachePath = applicationDirectoryPath + QLatin1String("/cache");
-	}
+	const QString profilePath(getProfilePath(m_commandLineParser));
 
-	if (m_commandLineParser.isSet(QLatin1String("profile")))
+	if (m_commandLineParser.isSet(QLatin1String("portable")))
 	{
-		profilePath = m_commandLineParser.value(QLatin1String("profile"));
-
-		if (!profilePath.contains(QDir::separator()))
-		{
-			profilePath = QDir(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QLatin1String("/otter/profiles/")).absoluteFilePath(profilePath);
-		}
+		cachePath = getApplicationDirectoryPath() + QLatin1String("/cache");
 	}
 
-	profilePath = QDir::toNativeSeparators(QFileInfo(profilePath).absoluteFilePath());
-
 	if (m_commandLineParser.isSet(QLatin1String("cache")))
 	{
 		cachePath = m_commandLineParser.value(QLatin1String("cache"));
@@ -251,6 +216,11 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 				reportOptions |= KeyboardShortcutsReport;
 			}
 
+			if (rawReportOptions.contains(QLatin1String("performance")))
+			{
+				reportOptions |= PerformanceReport;
+			}
+
 			if (rawReportOptions.contains(QLatin1String("paths")))
 			{
 				reportOptions |= PathsReport;
@@ -276,33 +246,10 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 		return;
 	}
 
-	QCryptographicHash hash(QCryptographicHash::Md5);
-	hash.addData(profilePath.toUtf8());
-
-	const QString serverName(applicationName() + QLatin1Char('-') + QString::fromLatin1(hash.result().toHex()));
-	QLocalSocket socket;
-	socket.connectToServer(serverName);
+	const QString serverName(getServerName(profilePath));
 
-	if (socket.waitForConnected(500))
+	if (sendArguments(serverName, arguments))
 	{
-		QStringList encodedArguments;
-		encodedArguments.reserve(arguments.count());
-
-#ifdef Q_OS_WIN
-		AllowSetForegroundWindow(ASFW_ANY);
-#endif
-
-		for (int i = 0; i < arguments.count(); ++i)
-		{
-			encodedArguments.append(QString::fromLatin1(arguments.at(i).toUtf8().toBase64()));
-		}
-
-		QTextStream stream(&socket);
-		stream << encodedArguments.join(QLatin1Char(' ')).toUtf8().toBase64();
-		stream.flush();
-
-		socket.waitForBytesWritten();
-
 		return;
 	}
 
@@ -427,16 +374,10 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	NetworkManagerFactory::createInstance();
 
-	NotesManager::createInstance();
-
 	NotificationsManager::createInstance();
 
-	PasswordsManager::createInstance();
-
 	SearchEnginesManager::createInstance();
 
-	SpellCheckManager::createInstance();
-
 	ToolBarsManager::createInstance();
 
 	TransfersManager::createInstance();
@@ -481,12 +422,12 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 	{
 		connect(new UpdateChecker(this), &UpdateChecker::finished, this, &Application::handleUpdateCheckResult);
 
-		if (!m_updateCheckTimer)
+		if (m_updateCheckTask == 0)
 		{
-			m_updateCheckTimer = new LongTermTimer(this);
-			m_updateCheckTimer->start(static_cast<quint64>(updateCheckInterval * 1000 * SECONDS_IN_DAY));
-
-			connect(m_updateCheckTimer, &LongTermTimer::timeout, this, &Application::periodicUpdateCheck);
+			m_updateCheckTask = TasksManager::registerTask(static_cast<uint>(updateCheckInterval * SECONDS_IN_DAY), true, [&]()
+			{
+				periodicUpdateCheck();
+			}, this);
 		}
 	}
 
@@ -532,6 +473,149 @@ Application::~Application()
 	}
 }
 
+void Application::setupCommandLineParser(QCommandLineParser *parser)
+{
+	parser->addHelpOption();
+	parser->addVersionOption();
+	parser->addPositionalArgument(QLatin1String("url"), translate("main", "URL to open"), QLatin1String("[url]"));
+	parser->addOption(QCommandLineOption(QLatin1String("cache"), translate("main", "Uses <path> as cache directory"), QLatin1String("path"), {}));
+	parser->addOption(QCommandLineOption(QLatin1String("profile"), translate("main", "Uses <path> as profile directory"), QLatin1String("path"), {}));
+	parser->addOption(QCommandLineOption(QLatin1String("session"), translate("main", "Restores session <session> if it exists"), QLatin1String("session"), {}));
+	parser->addOption(QCommandLineOption(QLatin1String("private-session"), translate("main", "Starts private session")));
+	parser->addOption(QCommandLineOption(QLatin1String("session-chooser"), translate("main", "Forces session chooser dialog")));
+	parser->addOption(QCommandLineOption(QLatin1String("portable"), translate("main", "Sets profile and cache paths to directories inside the same directory as that of application binary")));
+	parser->addOption(QCommandLineOption(QLatin1String("new-tab"), translate("main", "Loads URL in new tab")));
+	parser->addOption(QCommandLineOption(QLatin1String("new-private-tab"), translate("main", "Loads URL in new private tab")));
+	parser->addOption(QCommandLineOption(QLatin1String("new-window"), translate("main", "Loads URL in new window")));
+	parser->addOption(QCommandLineOption(QLatin1String("new-private-window"), translate("main", "Loads URL in new private window")));
+	parser->addOption(QCommandLineOption(QLatin1String("readonly"), translate("main", "Tells application to avoid writing data to disk")));
+	parser->addOption(QCommandLineOption(QLatin1String("report"), translate("main", "Prints out diagnostic report and exits application")));
+	parser->addOption(QCommandLineOption(QLatin1String("trace-startup"), translate("main", "Writes trace of application startup to <path> in Chrome trace event format"), QLatin1String("path"), {}));
+}
+
+QStringList Application::loadArguments(const QStringList &arguments)
+{
+	QString argumentsPath(QDir::current().filePath(QLatin1String("arguments.txt")));
+
+	if (!QFile::exists(argumentsPath))
+	{
+		argumentsPath = QDir(getApplicationDirectoryPath()).filePath(QLatin1String("arguments.txt"));
+	}
+
+	if (QFile::exists(argumentsPath))
+	{
+		QFile file(argumentsPath);
+
+		if (file.open(QIODevice::ReadOnly))
+		{
+			QStringList temporaryArguments(QString::fromLatin1(file.readAll()).trimmed().split(QLatin1Char(' '), QString::SkipEmptyParts));
+
+			if (!temporaryArguments.isEmpty())
+			{
+				if (arguments.isEmpty())
+				{
+					temporaryArguments.prepend(QFileInfo(applicationFilePath()).fileName());
+				}
+				else
+				{
+					temporaryArguments.prepend(arguments.value(0));
+				}
+
+				if (arguments.count() > 1)
+				{
+					temporaryArguments.append(arguments.mid(1));
+				}
+
+				return temporaryArguments;
+			}
+
+			file.close();
+		}
+	}
+
+	return arguments;
+}
+
+QString Application::getProfilePath(const QCommandLineParser &parser)
+{
+	QString profilePath(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QLatin1String("/otter"));
+
+	if (parser.isSet(QLatin1String("portable")))
+	{
+		profilePath = getApplicationDirectoryPath() + QLatin1String("/profile");
+	}
+
+	if (parser.isSet(QLatin1String("profile")))
+	{
+		profilePath = parser.value(QLatin1String("profile"));
+
+		if (!profilePath.contains(QDir::separator()))
+		{
+			profilePath = QDir(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + QLatin1String("/otter/profiles/")).absoluteFilePath(profilePath);
+		}
+	}
+
+	return QDir::toNativeSeparators(QFileInfo(profilePath).absoluteFilePath());
+}
+
+QString Application::getServerName(const QString &profilePath)
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(profilePath.toUtf8());
+
+	return (applicationName() + QLatin1Char('-') + QString::fromLatin1(hash.result().toHex()));
+}
+
+bool Application::sendArguments(const QString &serverName, const QStringList &arguments)
+{
+	QLocalSocket socket;
+	socket.connectToServer(serverName);
+
+	if (!socket.waitForConnected(500))
+	{
+		return false;
+	}
+
+	QStringList encodedArguments;
+	encodedArguments.reserve(arguments.count());
+
+#ifdef Q_OS_WIN
+	AllowSetForegroundWindow(ASFW_ANY);
+#endif
+
+	for (int i = 0; i < arguments.count(); ++i)
+	{
+		encodedArguments.append(QString::fromLatin1(arguments.at(i).toUtf8().toBase64()));
+	}
+
+	QTextStream stream(&socket);
+	stream << encodedArguments.join(QLatin1Char(' ')).toUtf8().toBase64();
+	stream.flush();
+
+	socket.waitForBytesWritten();
+
+	return true;
+}
+
+bool Application::forwardArguments(int &argc, char **argv)
+{
+	QCoreApplication application(argc, argv);
+	application.setApplicationName(QLatin1String("Otter"));
+
+	QCommandLineParser parser;
+
+	setupCommandLineParser(&parser);
+
+	const QStringList arguments(loadArguments(application.arguments()));
+
+	if (!parser.parse(arguments) || parser.isSet(QLatin1String("help")) || parser.isSet(QLatin1String("version")) || parser.isSet(QLatin1String("report")))
+	{
+		return false;
+	}
+
+	return sendArguments(getServerName(getProfilePath(parser)), arguments);
+}
+
 void Application::triggerAction(int identifier, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
 {
 	triggerAction(identifier, parameters, nullptr, trigger);
@@ -893,12 +977,12 @@ void Application::periodicUpdateCheck()
 
 	const int interval(SettingsManager::getOption(SettingsManager::Updates_CheckIntervalOption).toInt());
 
-	if (!m_updateCheckTimer && interval > 0 && !SettingsManager::getOption(SettingsManager::Updates_ActiveChannelsOption).toStringList().isEmpty())
+	if (m_updateCheckTask == 0 && interval > 0 && !SettingsManager::getOption(SettingsManager::Updates_ActiveChannelsOption).toStringList().isEmpty())
 	{
-		m_updateCheckTimer = new LongTermTimer(this);
-		m_updateCheckTimer->start(static_cast<quint64>(interval * 1000 * SECONDS_IN_DAY));
-
-		connect(m_updateCheckTimer, &LongTermTimer::timeout, this, &Application::periodicUpdateCheck);
+		m_updateCheckTask = TasksManager::registerTask(static_cast<uint>(interval * SECONDS_IN_DAY), true, [&]()
+		{
+			periodicUpdateCheck();
+		}, this);
 	}
 }
 
@@ -939,6 +1023,9 @@ void Application::handleAboutToQuit()
 {
 	m_isAboutToQuit = true;
 
+	Tracer::stop();
+	PersistenceManager::flush();
+
 	if (m_localServer)
 	{
 		m_localServer->close();
@@ -1103,7 +1190,7 @@ void Application::handlePositionalArguments(QCommandLineParser *parser, bool for
 			{
 				for (int i = 0; i < urls.count(); ++i)
 				{
-					mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), urls.at(i)}, {QLatin1String("needsInterpretation"), true}, {QLatin1String("hints"), QVariant(openHints)}});
+					mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), urls.at(i)}, {QLatin1String("needsInterpretation"), true}, {QLatin1String("hints"), QVariant((i == 0) ? openHints : (openHints | SessionsManager::NewTabOpen | SessionsManager::BackgroundOpen))}, {QLatin1String("isDeferred"), (i > 0)}});
 				}
 			}
 		}
@@ -1119,7 +1206,7 @@ void Application::handlePositionalArguments(QCommandLineParser *parser, bool for
 				{
 					for (int i = 0; i < urls.count(); ++i)
 					{
-						mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), urls.at(i)}, {QLatin1String("needsInterpretation"), true}, {QLatin1String("hints"), QVariant(openHints)}});
+						mainWindow->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), urls.at(i)}, {QLatin1String("needsInterpretation"), true}, {QLatin1String("hints"), QVariant((i == 0) ? openHints : (openHints | SessionsManager::NewTabOpen | SessionsManager::BackgroundOpen))}, {QLatin1String("isDeferred"), (i > 0)}});
 					}
 				}
 			});
@@ -1151,7 +1238,7 @@ void Application::handleUpdateCheckResult(const QVector<UpdateChecker::UpdateInf
 
 	if (SettingsManager::getOption(SettingsManager::Updates_AutomaticInstallOption).toBool())
 	{
-		new Updater(availableUpdates.at(latestVersionIndex), this);
+		new Updater(availableUpdates.at(latestVersionIndex), this, true);
 
 		return;
 	}
@@ -1252,6 +1339,11 @@ MainWindow* Application::createWindow(const QVariantMap &parameters, const Sessi
 
 	m_windows.prepend(mainWindow);
 
+	if (m_startupPhase == WindowStartupPhase && m_windows.count() == 1)
+	{
+		mainWindow->installEventFilter(m_instance);
+	}
+
 	const bool inBackground(parameters.contains(QLatin1String("hints")) ? SessionsManager::calculateOpenHints(parameters).testFlag(SessionsManager::BackgroundOpen) : false);
 
 	if (inBackground)
@@ -1288,6 +1380,94 @@ MainWindow* Application::createWindow(const QVariantMap &parameters, const Sessi
 	return mainWindow;
 }
 
+void Application::finishStartupPhase()
+{
+	if (m_startupPhase == OnDemandStartupPhase)
+	{
+		return;
+	}
+
+	const QString name((m_startupPhase == WindowStartupPhase) ? QLatin1String("first window") : QLatin1String("idle"));
+	const qint64 duration(m_startupTimer.restart());
+
+	m_startupPhasesDurations.append({name, duration});
+
+	Console::addMessage(QStringLiteral("Startup phase %1 took %2 ms").arg(name).arg(duration), Console::OtherCategory, Console::DebugLevel);
+
+	m_startupPhase = static_cast<StartupPhase>(m_startupPhase + 1);
+
+	if (m_startupPhase == IdleStartupPhase)
+	{
+		QTimer::singleShot(0, m_instance, []()
+		{
+			if (m_isAboutToQuit)
+			{
+				return;
+			}
+
+			SpellCheckManager::createInstance();
+
+			TabSuspensionManager::createInstance();
+
+			HistoryContentsIndex::createInstance();
+
+			EventLoopWatchdog::createInstance();
+
+			MetricsExporter::createInstance();
+
+			m_eventLoopTimer.start();
+
+			m_instance->m_eventLoopLagTimer = m_instance->startTimer(EventLoopLagInterval, Qt::PreciseTimer);
+
+			finishStartupPhase();
+
+			Tracer::stop();
+		});
+	}
+}
+
+void Application::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_eventLoopLagTimer)
+	{
+		QApplication::timerEvent(event);
+
+		return;
+	}
+
+	const int lag(qMax(0, (static_cast<int>(m_eventLoopTimer.restart()) - EventLoopLagInterval)));
+
+	if (m_eventLoopLags.count() < EventLoopLagSamplesLimit)
+	{
+		m_eventLoopLags.append(lag);
+	}
+	else
+	{
+		m_eventLoopLags[m_eventLoopLagsPosition] = lag;
+
+		m_eventLoopLagsPosition = ((m_eventLoopLagsPosition + 1) % EventLoopLagSamplesLimit);
+	}
+
+	if (lag >= SlowOperationThreshold)
+	{
+		++m_slowOperationsAmount;
+	}
+}
+
+bool Application::eventFilter(QObject *object, QEvent *event)
+{
+	if (event->type() == QEvent::Paint && m_startupPhase == WindowStartupPhase)
+	{
+		object->removeEventFilter(this);
+
+		Tracer::addInstantEvent("MainWindow::firstPaint");
+
+		finishStartupPhase();
+	}
+
+	return QApplication::eventFilter(object, event);
+}
+
 Application* Application::getInstance()
 {
 	return m_instance;
@@ -1446,7 +1626,7 @@ QString Application::createReport(ReportOptions options)
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
 		stream << QLatin1String("History");
-		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json"));
+		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat"));
 		stream.setFieldWidth(0);
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
@@ -1456,6 +1636,113 @@ QString Application::createReport(ReportOptions options)
 		stream << QLatin1String("\n\n");
 	}
 
+	if (options.testFlag(PerformanceReport))
+	{
+		const auto addRow([&](const QString &name, const QString &value)
+		{
+			stream << QLatin1String("\n\t");
+			stream.setFieldWidth(30);
+			stream << name;
+			stream << value;
+			stream.setFieldWidth(0);
+		});
+
+		stream << QLatin1String("Performance:");
+
+		if (m_startupPhase == WindowStartupPhase)
+		{
+			addRow(QLatin1String("Status"), QLatin1String("startup not finished"));
+		}
+		else
+		{
+			for (int i = 0; i < m_startupPhasesDurations.count(); ++i)
+			{
+				addRow(QStringLiteral("Startup Phase (%1)").arg(m_startupPhasesDurations.at(i).first), QStringLiteral("%1 ms").arg(m_startupPhasesDurations.at(i).second));
+			}
+
+			const quint64 residentMemorySize(m_platformIntegration ? m_platformIntegration->getResidentMemorySize() : 0);
+
+			addRow(QLatin1String("Resident Memory"), ((residentMemorySize > 0) ? Utils::formatUnit(static_cast<qint64>(residentMemorySize)) : QLatin1String("unknown")));
+
+			const HistoryModel *historyModel(HistoryManager::getBrowsingHistoryModel());
+			quint64 historyUsage(0);
+
+			for (int i = 0; i < historyModel->rowCount(); ++i)
+			{
+				const QModelIndex index(historyModel->index(i, 0));
+
+				historyUsage += ((static_cast<quint64>(index.data(HistoryModel::TitleRole).toString().size() + index.data(HistoryModel::UrlRole).toUrl().toString().size()) * sizeof(QChar)) + sizeof(QDateTime) + sizeof(quint64));
+			}
+
+			addRow(QLatin1String("History Entries"), QStringLiteral("%1 (~%2)").arg(historyModel->rowCount()).arg(Utils::formatUnit(static_cast<qint64>(historyUsage))));
+			addRow(QLatin1String("Bookmarks"), QString::number(BookmarksManager::getModel()->getBookmarksAmount()));
+
+			const QVector<QNetworkCookie> cookies(NetworkManagerFactory::getCookieJar()->getCookies());
+			qint64 cookiesUsage(0);
+
+			for (int i = 0; i < cookies.count(); ++i)
+			{
+				cookiesUsage += cookies.at(i).toRawForm().size();
+			}
+
+			addRow(QLatin1String("Cookies"), QStringLiteral("%1 (~%2)").arg(cookies.count()).arg(Utils::formatUnit(cookiesUsage)));
+
+			QVector<ContentFiltersProfile*> contentFiltersProfiles(ContentFiltersManager::getContentBlockingProfiles());
+			contentFiltersProfiles.append(ContentFiltersManager::getFraudCheckingProfiles());
+
+			quint64 contentFiltersUsage(0);
+
+			for (int i = 0; i < contentFiltersProfiles.count(); ++i)
+			{
+				contentFiltersUsage += contentFiltersProfiles.at(i)->getMemoryUsage();
+			}
+
+			addRow(QLatin1String("Compiled Content Filters"), QStringLiteral("%1 profiles (~%2)").arg(contentFiltersProfiles.count()).arg(Utils::formatUnit(static_cast<qint64>(contentFiltersUsage))));
+
+			const NetworkCache *cache(NetworkManagerFactory::getCache());
+
+			addRow(QLatin1String("Cache Index"), QStringLiteral("%1 entries (~%2, %3 on disk)").arg(cache->getEntriesAmount()).arg(Utils::formatUnit(static_cast<qint64>(cache->getIndexMemoryUsage()))).arg(Utils::formatUnit(cache->cacheSize())));
+
+			const ContentFiltersManager::ResultsCacheStatistics contentFiltersStatistics(ContentFiltersManager::getResultsCacheStatistics());
+			const quint64 contentFiltersLookups(contentFiltersStatistics.hits + contentFiltersStatistics.misses);
+			const ThemesManager::IconsCacheStatistics iconsStatistics(ThemesManager::getIconsCacheStatistics());
+			const UserScript::CachesStatistics userScriptsStatistics(UserScript::getCachesStatistics());
+
+			addRow(QLatin1String("Content Filters Cache"), QStringLiteral("%1/%2 entries, %3 hits, %4 misses (%5% hit rate)").arg(contentFiltersStatistics.amount).arg(contentFiltersStatistics.limit).arg(contentFiltersStatistics.hits).arg(contentFiltersStatistics.misses).arg(((contentFiltersLookups > 0) ? ((static_cast<double>(contentFiltersStatistics.hits) * 100) / static_cast<double>(contentFiltersLookups)) : 0), 0, 'f', 1));
+			addRow(QLatin1String("Data URI Icons Cache"), QStringLiteral("%1/%2 entries").arg(iconsStatistics.dataUriIconsAmount).arg(iconsStatistics.dataUriIconsLimit));
+			addRow(QLatin1String("User Scripts Cache"), QStringLiteral("%1/%2 entries").arg(userScriptsStatistics.urlsAmount).arg(userScriptsStatistics.urlsLimit));
+
+			QVector<int> eventLoopLags(m_eventLoopLags);
+
+			if (eventLoopLags.isEmpty())
+			{
+				addRow(QLatin1String("Event Loop Lag"), QLatin1String("no samples"));
+			}
+			else
+			{
+				std::sort(eventLoopLags.begin(), eventLoopLags.end());
+
+				const auto getPercentile([&](int percentile)
+				{
+					return eventLoopLags.at(((eventLoopLags.count() - 1) * percentile) / 100);
+				});
+
+				addRow(QLatin1String("Event Loop Lag"), QStringLiteral("p50 %1 ms, p90 %2 ms, p99 %3 ms, max %4 ms (%5 samples)").arg(getPercentile(50)).arg(getPercentile(90)).arg(getPercentile(99)).arg(eventLoopLags.last()).arg(eventLoopLags.count()));
+			}
+
+			addRow(QLatin1String("Slow Operations"), QStringLiteral("%1 (over %2 ms)").arg(m_slowOperationsAmount).arg(SlowOperationThreshold));
+
+			if (EventLoopWatchdog::isEnabled())
+			{
+				const EventLoopWatchdog::StallsStatistics stallsStatistics(EventLoopWatchdog::getStallsStatistics());
+
+				addRow(QLatin1String("Event Loop Stalls"), QStringLiteral("%1 (longest %2 ms)").arg(stallsStatistics.amount).arg(stallsStatistics.longestDuration));
+			}
+		}
+
+		stream << QLatin1String("\n\n");
+	}
+
 	if (options.testFlag(SettingsReport))
 	{
 		stream << SettingsManager::createReport();
@@ -1621,6 +1908,21 @@ QVector<MainWindow*> Application::getWindows()
 	return m_windows;
 }
 
+QVector<QPair<QString, qint64> > Application::getStartupPhasesDurations()
+{
+	return m_startupPhasesDurations;
+}
+
+QVector<int> Application::getEventLoopLags()
+{
+	return m_eventLoopLags;
+}
+
+quint64 Application::getSlowOperationsAmount()
+{
+	return m_slowOperationsAmount;
+}
+
 bool Application::canClose()
 {
 	if (TransfersManager::hasRunningTransfers() && SettingsManager::getOption(SettingsManager::Choices_WarnQuitTransfersOption).toBool())
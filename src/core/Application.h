@@ -25,6 +25,7 @@
 #include "UpdateChecker.h"
 
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QUrl>
 #include <QtWidgets/QApplication>
 #include <QtNetwork/QLocalServer>
@@ -32,7 +33,6 @@
 namespace Otter
 {
 
-class LongTermTimer;
 class MainWindow;
 class Notification;
 class PlatformIntegration;
@@ -51,8 +51,9 @@ public:
 		KeyboardShortcutsReport = 2,
 		PathsReport = 4,
 		SettingsReport = 8,
-		StandardReport = (EnvironmentReport | PathsReport | SettingsReport),
-		FullReport = (EnvironmentReport | KeyboardShortcutsReport | PathsReport | SettingsReport)
+		PerformanceReport = 16,
+		StandardReport = (EnvironmentReport | PathsReport | SettingsReport | PerformanceReport),
+		FullReport = (EnvironmentReport | KeyboardShortcutsReport | PathsReport | SettingsReport | PerformanceReport)
 	};
 
 	Q_DECLARE_FLAGS(ReportOptions, ReportOption)
@@ -79,18 +80,44 @@ public:
 	static QString getApplicationDirectoryPath();
 	ActionsManager::ActionDefinition::State getActionState(int identifier, const QVariantMap &parameters = {}) const override;
 	static QVector<MainWindow*> getWindows();
+	static QVector<QPair<QString, qint64> > getStartupPhasesDurations();
+	static QVector<int> getEventLoopLags();
+	static quint64 getSlowOperationsAmount();
 	static bool canClose();
 	static bool isAboutToQuit();
 	static bool isFirstRun();
 	static bool isHidden();
 	static bool isUpdating();
 	static bool isRunning();
+	static bool forwardArguments(int &argc, char **argv);
 
 public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
 
 protected:
+	enum StartupPhase
+	{
+		WindowStartupPhase = 0,
+		IdleStartupPhase,
+		OnDemandStartupPhase
+	};
+
+	enum EventLoopMonitorParameter
+	{
+		EventLoopLagInterval = 100,
+		EventLoopLagSamplesLimit = 600,
+		SlowOperationThreshold = 100
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	static void finishStartupPhase();
 	static void setLocale(const QString &locale);
+	static void setupCommandLineParser(QCommandLineParser *parser);
+	static QString getProfilePath(const QCommandLineParser &parser);
+	static QString getServerName(const QString &profilePath);
+	static QStringList loadArguments(const QStringList &arguments);
+	static bool sendArguments(const QString &serverName, const QStringList &arguments);
+	bool eventFilter(QObject *object, QEvent *event) override;
 
 protected slots:
 	void openUrl(const QUrl &url);
@@ -103,7 +130,8 @@ protected slots:
 private:
 	Q_DISABLE_COPY(Application)
 
-	LongTermTimer *m_updateCheckTimer;
+	quint64 m_updateCheckTask;
+	int m_eventLoopLagTimer;
 
 	static Application *m_instance;
 	static PlatformIntegration *m_platformIntegration;
@@ -116,6 +144,13 @@ private:
 	static QString m_localePath;
 	static QCommandLineParser m_commandLineParser;
 	static QVector<MainWindow*> m_windows;
+	static QVector<QPair<QString, qint64> > m_startupPhasesDurations;
+	static QVector<int> m_eventLoopLags;
+	static QElapsedTimer m_startupTimer;
+	static QElapsedTimer m_eventLoopTimer;
+	static StartupPhase m_startupPhase;
+	static quint64 m_slowOperationsAmount;
+	static int m_eventLoopLagsPosition;
 	static bool m_isAboutToQuit;
 	static bool m_isFirstRun;
 	static bool m_isHidden;
@@ -20,6 +20,7 @@
 
 #include "BookmarksManager.h"
 #include "Application.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
 
 #include <QtCore/QDateTime>
@@ -31,31 +32,23 @@ BookmarksManager* BookmarksManager::m_instance(nullptr);
 BookmarksModel* BookmarksManager::m_model(nullptr);
 qulonglong BookmarksManager::m_lastUsedFolder(0);
 
-BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent)
 {
 }
 
-void BookmarksManager::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_saveTimer)
-	{
-		killTimer(m_saveTimer);
-
-		m_saveTimer = 0;
-
-		if (m_model)
-		{
-			m_model->save(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")));
-		}
-	}
-}
-
 void BookmarksManager::createInstance()
 {
 	if (!m_instance)
 	{
 		m_instance = new BookmarksManager(QCoreApplication::instance());
+		m_model = new BookmarksModel(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")), BookmarksModel::BookmarksMode, m_instance);
+
+		PersistenceManager::registerTarget(m_instance, [](bool isBlocking)
+		{
+			return (!m_model || m_model->flushJournal(isBlocking));
+		});
+
+		connect(m_model, &BookmarksModel::modelModified, m_instance, &BookmarksManager::scheduleSave);
 	}
 }
 
@@ -66,34 +59,12 @@ void BookmarksManager::ensureInitialized()
 		createInstance();
 	}
 
-	if (!m_model)
-	{
-		m_model = new BookmarksModel(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")), BookmarksModel::BookmarksMode, m_instance);
-
-		connect(m_model, &BookmarksModel::modelModified, m_instance, &BookmarksManager::scheduleSave);
-	}
+	m_model->ensureLoaded();
 }
 
 void BookmarksManager::scheduleSave()
 {
-	if (Application::isAboutToQuit())
-	{
-		if (m_saveTimer != 0)
-		{
-			killTimer(m_saveTimer);
-
-			m_saveTimer = 0;
-		}
-
-		if (m_model)
-		{
-			m_model->save(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")));
-		}
-	}
-	else if (m_saveTimer == 0)
-	{
-		m_saveTimer = startTimer(1000);
-	}
+	PersistenceManager::markAsDirty(this);
 }
 
 void BookmarksManager::updateVisits(const QUrl &url)
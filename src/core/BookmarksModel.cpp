@@ -20,16 +20,23 @@
 
 #include "BookmarksModel.h"
 #include "Console.h"
+#include "FaviconsManager.h"
 #include "FeedsManager.h"
 #include "HistoryManager.h"
 #include "SessionsManager.h"
 #include "ThemesManager.h"
+#include "UrlsTable.h"
 #include "Utils.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QMimeData>
 #include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtWidgets/QMessageBox>
 
 namespace Otter
@@ -114,7 +121,7 @@ QString BookmarksModel::Bookmark::getTitle() const
 
 QString BookmarksModel::Bookmark::getDescription() const
 {
-	return QStandardItem::data(DescriptionRole).toString();
+	return getRawData(DescriptionRole).toString();
 }
 
 QString BookmarksModel::Bookmark::getKeyword() const
@@ -222,6 +229,11 @@ QVariant BookmarksModel::Bookmark::data(int role) const
 		return {};
 	}
 
+	if (role == DescriptionRole)
+	{
+		return getRawData(role);
+	}
+
 	if (role == Qt::AccessibleDescriptionRole && getType() == SeparatorBookmark)
 	{
 		return QLatin1String("separator");
@@ -256,6 +268,16 @@ QVariant BookmarksModel::Bookmark::data(int role) const
 
 QVariant BookmarksModel::Bookmark::getRawData(int role) const
 {
+	if (role == DescriptionRole)
+	{
+		BookmarksModel *model(qobject_cast<BookmarksModel*>(this->model()));
+
+		if (model && !model->m_deferredDescriptions.isEmpty())
+		{
+			model->loadDeferredDescriptions();
+		}
+	}
+
 	return QStandardItem::data(role);
 }
 
@@ -348,7 +370,14 @@ BookmarksModel::BookmarksModel(const QString &path, FormatMode mode, QObject *pa
 	m_rootItem(new Bookmark()),
 	m_trashItem(new Bookmark()),
 	m_importTargetItem(nullptr),
-	m_mode(mode)
+	m_loadingWatcher(nullptr),
+	m_path(path),
+	m_journalPath(QFileInfo(path).absoluteDir().filePath(QFileInfo(path).completeBaseName() + QLatin1String(".journal"))),
+	m_mode(mode),
+	m_journalRecordsAmount(0),
+	m_isJournalEnabled(false),
+	m_isSaving(false),
+	m_needsCompaction(false)
 {
 	m_rootItem->setData(RootBookmark, TypeRole);
 	m_rootItem->setDragEnabled(false);
@@ -358,56 +387,265 @@ BookmarksModel::BookmarksModel(const QString &path, FormatMode mode, QObject *pa
 
 	appendRow(m_rootItem);
 	appendRow(m_trashItem);
+
+	connect(FaviconsManager::getInstance(), &FaviconsManager::iconsDecoded, this, [&]()
+	{
+		QHash<quint64, QVector<Bookmark*> >::const_iterator iterator;
+
+		for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+		{
+			for (int i = 0; i < iterator.value().count(); ++i)
+			{
+				const QModelIndex bookmarkIndex(iterator.value().at(i)->index());
+
+				emit dataChanged(bookmarkIndex, bookmarkIndex, {Qt::DecorationRole});
+			}
+		}
+	});
 	setItemPrototype(new Bookmark());
 
 	if (!QFile::exists(path))
 	{
+		loadBookmarks({});
+
 		return;
 	}
 
-	QFile file(path);
+	m_loadingWatcher = new QFutureWatcher<BookmarksTree>(this);
+	m_loadingWatcher->setFuture(QtConcurrent::run(&BookmarksModel::readBookmarks, path, (mode == NotesMode)));
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	connect(m_loadingWatcher, &QFutureWatcher<BookmarksTree>::finished, this, &BookmarksModel::handleBookmarksLoaded);
+}
+
+BookmarksModel::~BookmarksModel()
+{
+	if (m_isJournalEnabled && (m_needsCompaction || !m_journalBuffer.isEmpty()))
+	{
+		flushJournal(true);
+	}
+	else
 	{
-		Console::addMessage(((mode == NotesMode) ? tr("Failed to open notes file: %1") : tr("Failed to open bookmarks file: %1")).arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+		m_savingFuture.waitForFinished();
+	}
 
-		return;
+	QHash<quint64, QVector<Bookmark*> >::const_iterator iterator;
+
+	for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		UrlsTable::releaseUrl(iterator.key());
 	}
+}
 
-	QXmlStreamReader reader(&file);
+void BookmarksModel::ensureLoaded()
+{
+	if (m_loadingWatcher)
+	{
+		m_loadingWatcher->waitForFinished();
 
-	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+		handleBookmarksLoaded();
+	}
+}
+
+void BookmarksModel::loadBookmarks(const BookmarksTree &tree)
+{
+	if (!tree.openErrorString.isEmpty())
 	{
-		while (reader.readNextStartElement())
-		{
-			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
-			{
-				readBookmark(&reader, m_rootItem);
-			}
-			else
-			{
-				reader.skipCurrentElement();
-			}
+		Console::addMessage(((m_mode == NotesMode) ? tr("Failed to open notes file: %1") : tr("Failed to open bookmarks file: %1")).arg(tree.openErrorString), Console::OtherCategory, Console::ErrorLevel, tree.path);
 
-			if (reader.hasError())
-			{
-				m_rootItem->removeRows(0, m_rootItem->rowCount());
+		return;
+	}
 
-				Console::addMessage(((m_mode == NotesMode) ? tr("Failed to load notes file: %1") : tr("Failed to load bookmarks file: %1")).arg(reader.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+	if (!tree.readErrorString.isEmpty())
+	{
+		Console::addMessage(((m_mode == NotesMode) ? tr("Failed to load notes file: %1") : tr("Failed to load bookmarks file: %1")).arg(tree.readErrorString), Console::OtherCategory, Console::ErrorLevel, tree.path);
 
-				QMessageBox::warning(nullptr, tr("Error"), ((m_mode == NotesMode) ? tr("Failed to load notes file.") : tr("Failed to load bookmarks file.")), QMessageBox::Close);
+		QMessageBox::warning(nullptr, tr("Error"), ((m_mode == NotesMode) ? tr("Failed to load notes file.") : tr("Failed to load bookmarks file.")), QMessageBox::Close);
 
-				return;
-			}
+		return;
+	}
+
+	if (!tree.nodes.isEmpty())
+	{
+		QVector<Bookmark*> feeds;
+		QList<QStandardItem*> topLevelBookmarks;
+
+		createBookmarks(tree, topLevelBookmarks, feeds, false, true);
+
+		m_rootItem->appendRows(topLevelBookmarks);
+
+		for (int i = 0; i < feeds.count(); ++i)
+		{
+			setupFeed(feeds.at(i));
 		}
 	}
 
+	if (QFile::exists(m_journalPath))
+	{
+		loadJournal();
+	}
+
+	m_isJournalEnabled = true;
+
 	connect(this, &BookmarksModel::itemChanged, this, &BookmarksModel::modelModified);
 	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::modelModified);
 	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::notifyBookmarkModified);
 	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::modelModified);
 	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::notifyBookmarkModified);
 	connect(this, &BookmarksModel::rowsMoved, this, &BookmarksModel::modelModified);
+	connect(this, &BookmarksModel::rowsInserted, this, &BookmarksModel::handleStructureChanged);
+	connect(this, &BookmarksModel::rowsRemoved, this, &BookmarksModel::handleStructureChanged);
+	connect(this, &BookmarksModel::rowsMoved, this, &BookmarksModel::handleStructureChanged);
+	connect(this, &BookmarksModel::modelReset, this, &BookmarksModel::handleStructureChanged);
+}
+
+int BookmarksModel::createBookmarks(const BookmarksTree &tree, QList<QStandardItem*> &topLevelBookmarks, QVector<Bookmark*> &feeds, bool isImporting, bool areDuplicatesAllowed)
+{
+	QVector<Bookmark*> bookmarks;
+	bookmarks.reserve(tree.nodes.count());
+
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	int amount(0);
+
+	m_urls.reserve(m_urls.count() + tree.nodes.count());
+	m_urlHashes.reserve(m_urlHashes.count() + tree.nodes.count());
+
+	for (int i = 0; i < tree.nodes.count(); ++i)
+	{
+		const BookmarkNode &node(tree.nodes.at(i));
+		const bool hasParent(node.parent >= 0 && node.parent < i);
+
+		if ((hasParent && !bookmarks.at(node.parent)) || (isImporting && !areDuplicatesAllowed && node.type != FolderBookmark && node.type != SeparatorBookmark && !node.url.isEmpty() && hasBookmark(QUrl(node.url))))
+		{
+			bookmarks.append(nullptr);
+
+			continue;
+		}
+
+		Bookmark *bookmark(new Bookmark());
+
+		bookmarks.append(bookmark);
+
+		++amount;
+
+		if (hasParent)
+		{
+			bookmarks.at(node.parent)->appendRow(bookmark);
+		}
+		else
+		{
+			topLevelBookmarks.append(bookmark);
+		}
+
+		bookmark->setItemData(node.type, TypeRole);
+
+		if (node.type != FolderBookmark)
+		{
+			bookmark->setDropEnabled(false);
+		}
+
+		if (node.type == SeparatorBookmark)
+		{
+			continue;
+		}
+
+		quint64 identifier(node.identifier);
+
+		if (identifier == 0 || m_identifiers.contains(identifier))
+		{
+			identifier = (m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
+		}
+
+		m_identifiers[identifier] = bookmark;
+
+		bookmark->setItemData(identifier, IdentifierRole);
+		bookmark->setItemData(((isImporting && !node.timeAdded.isValid()) ? currentDateTime : node.timeAdded), TimeAddedRole);
+		bookmark->setItemData(((isImporting && !node.timeModified.isValid()) ? currentDateTime : node.timeModified), TimeModifiedRole);
+
+		if (!node.title.isNull())
+		{
+			bookmark->setItemData(node.title, TitleRole);
+		}
+
+		if (!node.description.isNull())
+		{
+			bookmark->setItemData(node.description, DescriptionRole);
+		}
+		else if (node.isDescriptionDeferred && !isImporting)
+		{
+			m_deferredDescriptions[identifier] = i;
+		}
+
+		if (!node.keyword.isEmpty() && (!isImporting || !m_keywords.contains(node.keyword)))
+		{
+			bookmark->setItemData(node.keyword, KeywordRole);
+
+			handleKeywordChanged(bookmark, node.keyword);
+		}
+
+		if (node.type == FolderBookmark)
+		{
+			continue;
+		}
+
+		bookmark->setItemData(node.url, UrlRole);
+		bookmark->setItemData(node.timeVisited, TimeVisitedRole);
+
+		if (node.visits > 0)
+		{
+			bookmark->setItemData(node.visits, VisitsRole);
+		}
+
+		if (!node.url.isEmpty())
+		{
+			handleUrlChanged(bookmark, Utils::normalizeUrl(QUrl(node.url)));
+		}
+
+		handleTitleChanged(bookmark, node.title);
+
+		if (node.type == FeedBookmark)
+		{
+			feeds.append(bookmark);
+		}
+		else
+		{
+			bookmark->setFlags(bookmark->flags() | Qt::ItemNeverHasChildren);
+		}
+	}
+
+	m_urls.squeeze();
+	m_urlHashes.squeeze();
+
+	return amount;
+}
+
+int BookmarksModel::importBookmarks(const BookmarksTree &tree, Bookmark *target, bool areDuplicatesAllowed)
+{
+	if (!target)
+	{
+		target = m_rootItem;
+	}
+
+	QVector<Bookmark*> feeds;
+	QList<QStandardItem*> topLevelBookmarks;
+	const int amount(createBookmarks(tree, topLevelBookmarks, feeds, true, areDuplicatesAllowed));
+
+	m_keywords.squeeze();
+
+	if (topLevelBookmarks.isEmpty())
+	{
+		return 0;
+	}
+
+	target->appendRows(topLevelBookmarks);
+
+	for (int i = 0; i < feeds.count(); ++i)
+	{
+		setupFeed(feeds.at(i));
+	}
+
+	emit bookmarkModified(target);
+
+	return amount;
 }
 
 void BookmarksModel::beginImport(Bookmark *target, int estimatedUrlsAmount, int estimatedKeywordsAmount)
@@ -420,6 +658,7 @@ void BookmarksModel::beginImport(Bookmark *target, int estimatedUrlsAmount, int
 	if (estimatedUrlsAmount > 0)
 	{
 		m_urls.reserve(m_urls.count() + estimatedUrlsAmount);
+		m_urlHashes.reserve(m_urlHashes.count() + estimatedUrlsAmount);
 	}
 
 	if (estimatedKeywordsAmount > 0)
@@ -431,6 +670,7 @@ void BookmarksModel::beginImport(Bookmark *target, int estimatedUrlsAmount, int
 void BookmarksModel::endImport()
 {
 	m_urls.squeeze();
+	m_urlHashes.squeeze();
 	m_keywords.squeeze();
 
 	blockSignals(false);
@@ -529,9 +769,13 @@ void BookmarksModel::removeBookmark(Bookmark *bookmark)
 		m_identifiers.remove(identifier);
 	}
 
+	m_deferredDescriptions.remove(identifier);
+
 	if (!bookmark->data(KeywordRole).toString().isEmpty() && m_keywords.contains(bookmark->data(KeywordRole).toString()))
 	{
 		m_keywords.remove(bookmark->data(KeywordRole).toString());
+
+		removeKeywordEntry(bookmark->data(KeywordRole).toString());
 	}
 
 	emit bookmarkRemoved(bookmark, static_cast<Bookmark*>(bookmark->parent()));
@@ -541,183 +785,149 @@ void BookmarksModel::removeBookmark(Bookmark *bookmark)
 	emit modelModified();
 }
 
-void BookmarksModel::readBookmark(QXmlStreamReader *reader, Bookmark *parent)
+void BookmarksModel::readBookmark(QXmlStreamReader *reader, BookmarksTree &tree, int parent, bool areDescriptionsDeferred)
 {
-	Bookmark *bookmark(nullptr);
+	BookmarkNode node;
+	node.parent = parent;
 
-	if (reader->name() == QLatin1String("folder"))
+	if (reader->name() == QLatin1String("separator"))
 	{
-		bookmark = addBookmark(FolderBookmark, {{IdentifierRole, reader->attributes().value(QLatin1String("id")).toULongLong()}, {TimeAddedRole, readDateTime(reader, QLatin1String("added"))}, {TimeModifiedRole, readDateTime(reader, QLatin1String("modified"))}}, parent);
+		node.type = SeparatorBookmark;
+
+		tree.nodes.append(node);
 
-		while (reader->readNext())
+		reader->readNext();
+
+		return;
+	}
+
+	const bool isFolder(reader->name() == QLatin1String("folder"));
+
+	if (!isFolder && reader->name() != QLatin1String("bookmark"))
+	{
+		return;
+	}
+
+	node.identifier = reader->attributes().value(QLatin1String("id")).toULongLong();
+	node.timeAdded = readDateTime(reader, QLatin1String("added"));
+	node.timeModified = readDateTime(reader, QLatin1String("modified"));
+
+	if (isFolder)
+	{
+		node.type = FolderBookmark;
+	}
+	else
+	{
+		node.type = (reader->attributes().hasAttribute(QLatin1String("feed")) ? FeedBookmark : UrlBookmark);
+		node.url = reader->attributes().value(QLatin1String("href")).toString();
+		node.timeVisited = readDateTime(reader, QLatin1String("visited"));
+	}
+
+	const int index(tree.nodes.count());
+
+	tree.nodes.append(node);
+
+	while (reader->readNext())
+	{
+		if (reader->isStartElement())
 		{
-			if (reader->isStartElement())
+			if (reader->name() == QLatin1String("title"))
 			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), TitleRole);
-				}
-				else if (reader->name() == QLatin1String("desc"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), DescriptionRole);
-				}
-				else if (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator"))
-				{
-					readBookmark(reader, bookmark);
-				}
-				else if (reader->name() == QLatin1String("info"))
+				tree.nodes[index].title = reader->readElementText().trimmed();
+			}
+			else if (reader->name() == QLatin1String("desc"))
+			{
+				const QString description(reader->readElementText().trimmed());
+
+				if (areDescriptionsDeferred && !isFolder)
 				{
-					while (reader->readNext())
-					{
-						if (reader->isStartElement())
-						{
-							if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
-							{
-								while (reader->readNext())
-								{
-									if (reader->isStartElement())
-									{
-										if (reader->name() == QLatin1String("keyword"))
-										{
-											const QString keyword(reader->readElementText().trimmed());
-
-											if (!keyword.isEmpty())
-											{
-												bookmark->setItemData(keyword, KeywordRole);
-
-												handleKeywordChanged(bookmark, keyword);
-											}
-										}
-										else
-										{
-											reader->skipCurrentElement();
-										}
-									}
-									else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
-									{
-										break;
-									}
-								}
-							}
-							else
-							{
-								reader->skipCurrentElement();
-							}
-						}
-						else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
-						{
-							break;
-						}
-					}
+					const QString title(description.section(QLatin1Char('\n'), 0, 0).left(100));
+
+					tree.nodes[index].title = ((title == description) ? title : title + QStringLiteral("…"));
+					tree.nodes[index].isDescriptionDeferred = true;
 				}
 				else
 				{
-					reader->skipCurrentElement();
+					tree.nodes[index].description = description;
 				}
 			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("folder"))
+			else if (isFolder && (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator")))
 			{
-				break;
+				readBookmark(reader, tree, index, areDescriptionsDeferred);
 			}
-			else if (reader->hasError())
+			else if (reader->name() == QLatin1String("info"))
 			{
-				return;
-			}
-		}
-	}
-	else if (reader->name() == QLatin1String("bookmark"))
-	{
-		const bool isFeed(reader->attributes().hasAttribute(QLatin1String("feed")));
-
-		bookmark = addBookmark((isFeed ? FeedBookmark : UrlBookmark), {{IdentifierRole, reader->attributes().value(QLatin1String("id")).toULongLong()}, {UrlRole, reader->attributes().value(QLatin1String("href")).toString()}, {TimeAddedRole, readDateTime(reader, QLatin1String("added"))}, {TimeModifiedRole, readDateTime(reader, QLatin1String("modified"))}, {TimeVisitedRole, readDateTime(reader, QLatin1String("visited"))}}, parent);
-
-		while (reader->readNext())
-		{
-			if (reader->isStartElement())
-			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->setItemData(reader->readElementText().trimmed(), TitleRole);
-				}
-				else if (reader->name() == QLatin1String("desc"))
+				while (reader->readNext())
 				{
-					bookmark->setItemData(reader->readElementText().trimmed(), DescriptionRole);
-				}
-				else if (reader->name() == QLatin1String("info"))
-				{
-					while (reader->readNext())
+					if (reader->isStartElement())
 					{
-						if (reader->isStartElement())
+						if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
 						{
-							if (reader->name() == QLatin1String("metadata") && reader->attributes().value(QLatin1String("owner")).toString().startsWith(QLatin1String("http://otter-browser.org/")))
+							while (reader->readNext())
 							{
-								while (reader->readNext())
+								if (reader->isStartElement())
 								{
-									if (reader->isStartElement())
+									if (reader->name() == QLatin1String("keyword"))
+									{
+										tree.nodes[index].keyword = reader->readElementText().trimmed();
+									}
+									else if (!isFolder && reader->name() == QLatin1String("visits"))
 									{
-										if (reader->name() == QLatin1String("keyword"))
-										{
-											const QString keyword(reader->readElementText().trimmed());
-
-											if (!keyword.isEmpty())
-											{
-												bookmark->setItemData(keyword, KeywordRole);
-
-												handleKeywordChanged(bookmark, keyword);
-											}
-										}
-										else if (reader->name() == QLatin1String("visits"))
-										{
-											bookmark->setItemData(reader->readElementText().toInt(), VisitsRole);
-										}
-										else
-										{
-											reader->skipCurrentElement();
-										}
+										tree.nodes[index].visits = reader->readElementText().toInt();
 									}
-									else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
+									else
 									{
-										break;
+										reader->skipCurrentElement();
 									}
 								}
-							}
-							else
-							{
-								reader->skipCurrentElement();
+								else if (reader->isEndElement() && reader->name() == QLatin1String("metadata"))
+								{
+									break;
+								}
 							}
 						}
-						else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
+						else
 						{
-							break;
+							reader->skipCurrentElement();
 						}
 					}
-				}
-				else
-				{
-					reader->skipCurrentElement();
+					else if (reader->isEndElement() && reader->name() == QLatin1String("info"))
+					{
+						break;
+					}
 				}
 			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("bookmark"))
-			{
-				break;
-			}
-			else if (reader->hasError())
+			else
 			{
-				return;
+				reader->skipCurrentElement();
 			}
 		}
-
-		if (isFeed)
+		else if (reader->isEndElement() && reader->name() == (isFolder ? QLatin1String("folder") : QLatin1String("bookmark")))
 		{
-			setupFeed(bookmark);
+			break;
+		}
+		else if (reader->hasError())
+		{
+			return;
 		}
 	}
-	else if (reader->name() == QLatin1String("separator"))
-	{
-		addBookmark(SeparatorBookmark, {}, parent);
+}
 
-		reader->readNext();
+void BookmarksModel::writeBookmarks(QXmlStreamWriter *writer) const
+{
+	writer->setAutoFormatting(true);
+	writer->setAutoFormattingIndent(-1);
+	writer->writeStartDocument();
+	writer->writeDTD(QLatin1String("<!DOCTYPE xbel>"));
+	writer->writeStartElement(QLatin1String("xbel"));
+	writer->writeAttribute(QLatin1String("version"), QLatin1String("1.0"));
+
+	for (int i = 0; i < m_rootItem->rowCount(); ++i)
+	{
+		writeBookmark(writer, m_rootItem->getChild(i));
 	}
+
+	writer->writeEndDocument();
 }
 
 void BookmarksModel::writeBookmark(QXmlStreamWriter *writer, Bookmark *bookmark) const
@@ -840,6 +1050,154 @@ void BookmarksModel::writeBookmark(QXmlStreamWriter *writer, Bookmark *bookmark)
 	}
 }
 
+void BookmarksModel::appendJournalRecord(JournalRecordType type, Bookmark *bookmark, int role)
+{
+	if (!m_isJournalEnabled || m_needsCompaction || !bookmark || bookmark == m_rootItem || bookmark->getIdentifier() == 0)
+	{
+		return;
+	}
+
+	const Bookmark *parent(bookmark->getParent());
+
+	if (!parent || parent->getType() == FeedBookmark || bookmark->data(IsTrashedRole).toBool())
+	{
+		return;
+	}
+
+	QDataStream stream(&m_journalBuffer, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint8>(type) << bookmark->getIdentifier();
+
+	if (type == DataRecord)
+	{
+		stream << static_cast<qint32>(role) << bookmark->getRawData(role);
+	}
+	else
+	{
+		stream << parent->getIdentifier() << static_cast<qint32>(bookmark->row());
+	}
+
+	++m_journalRecordsAmount;
+}
+
+void BookmarksModel::loadJournal()
+{
+	QFile file(m_journalPath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+
+	stream >> magicNumber >> formatVersion;
+
+	m_needsCompaction = true;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != JournalMagicNumber || formatVersion != JournalFormatVersion)
+	{
+		Console::addMessage(((m_mode == NotesMode) ? tr("Failed to load notes journal: unsupported format") : tr("Failed to load bookmarks journal: unsupported format")), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
+
+		return;
+	}
+
+	while (!stream.atEnd())
+	{
+		quint8 type(UnknownRecord);
+		quint64 identifier(0);
+
+		stream >> type >> identifier;
+
+		Bookmark *bookmark((identifier > 0) ? getBookmark(identifier) : nullptr);
+
+		if (type == DataRecord)
+		{
+			qint32 role(-1);
+			QVariant value;
+
+			stream >> role >> value;
+
+			if (stream.status() != QDataStream::Ok)
+			{
+				break;
+			}
+
+			if (bookmark)
+			{
+				setData(bookmark->index(), value, role);
+			}
+		}
+		else if (type == MoveRecord)
+		{
+			quint64 parentIdentifier(0);
+			qint32 row(-1);
+
+			stream >> parentIdentifier >> row;
+
+			if (stream.status() != QDataStream::Ok)
+			{
+				break;
+			}
+
+			Bookmark *parent(getBookmark(parentIdentifier));
+
+			if (bookmark && parent && bookmark->parent() && (parent->getType() == RootBookmark || parent->getType() == FolderBookmark) && bookmark != parent && !bookmark->isAncestorOf(parent))
+			{
+				const QList<QStandardItem*> items(bookmark->parent()->takeRow(bookmark->row()));
+
+				parent->insertRow(qBound(0, static_cast<int>(row), parent->rowCount()), items);
+			}
+		}
+		else
+		{
+			stream.setStatus(QDataStream::ReadCorruptData);
+
+			break;
+		}
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		Console::addMessage(((m_mode == NotesMode) ? tr("Notes journal is damaged, trailing records were discarded") : tr("Bookmarks journal is damaged, trailing records were discarded")), Console::OtherCategory, Console::WarningLevel, m_journalPath);
+	}
+}
+
+void BookmarksModel::loadDeferredDescriptions()
+{
+	const QHash<quint64, int> deferredDescriptions(m_deferredDescriptions);
+
+	m_deferredDescriptions.clear();
+
+	const BookmarksTree tree(readBookmarks(m_path));
+
+	if (!tree.openErrorString.isEmpty() || !tree.readErrorString.isEmpty())
+	{
+		Console::addMessage(tr("Failed to load notes file: %1").arg(tree.openErrorString.isEmpty() ? tree.readErrorString : tree.openErrorString), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return;
+	}
+
+	const bool wereSignalsBlocked(blockSignals(true));
+	QHash<quint64, int>::const_iterator iterator;
+
+	for (iterator = deferredDescriptions.constBegin(); iterator != deferredDescriptions.constEnd(); ++iterator)
+	{
+		Bookmark *bookmark(getBookmark(iterator.key()));
+
+		if (bookmark && iterator.value() < tree.nodes.count())
+		{
+			bookmark->setItemData(tree.nodes.at(iterator.value()).description, DescriptionRole);
+		}
+	}
+
+	blockSignals(wereSignalsBlocked);
+}
+
 void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 {
 	if (!bookmark)
@@ -853,16 +1211,25 @@ void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 		case UrlBookmark:
 			{
 				const QUrl url(Utils::normalizeUrl(bookmark->data(UrlRole).toUrl()));
+				const quint64 urlIdentifier(UrlsTable::getIdentifier(url));
 
-				if (!url.isEmpty() && m_urls.contains(url))
+				if (urlIdentifier > 0 && m_urls.contains(urlIdentifier))
 				{
-					m_urls[url].removeAll(bookmark);
+					m_urls[urlIdentifier].removeAll(bookmark);
 
-					if (m_urls[url].isEmpty())
+					removeUrlHash(bookmark, url);
+
+					if (m_urls[urlIdentifier].isEmpty())
 					{
-						m_urls.remove(url);
+						m_urls.remove(urlIdentifier);
+
+						m_urlsIndex.removeUrl(url);
+
+						UrlsTable::releaseUrl(urlIdentifier);
 					}
 				}
+
+				handleTitleChanged(bookmark, {}, bookmark->getRawData(TitleRole).toString());
 			}
 
 			break;
@@ -891,16 +1258,27 @@ void BookmarksModel::readdBookmarkUrl(Bookmark *bookmark)
 		case UrlBookmark:
 			{
 				const QUrl url(Utils::normalizeUrl(bookmark->data(UrlRole).toUrl()));
+				const quint64 urlIdentifier(UrlsTable::retainUrl(url));
 
-				if (!url.isEmpty())
+				if (urlIdentifier > 0)
 				{
-					if (!m_urls.contains(url))
+					if (m_urls.contains(urlIdentifier))
 					{
-						m_urls[url] = {};
+						UrlsTable::releaseUrl(urlIdentifier);
+					}
+					else
+					{
+						m_urls[urlIdentifier] = {};
+
+						m_urlsIndex.addUrl(url);
 					}
 
-					m_urls[url].append(bookmark);
+					m_urls[urlIdentifier].append(bookmark);
+
+					addUrlHash(bookmark, url);
 				}
+
+				handleTitleChanged(bookmark, bookmark->getRawData(TitleRole).toString());
 			}
 
 			break;
@@ -949,6 +1327,27 @@ void BookmarksModel::emptyTrash()
 	}
 }
 
+void BookmarksModel::handleBookmarksLoaded()
+{
+	if (!m_loadingWatcher)
+	{
+		return;
+	}
+
+	const BookmarksTree tree(m_loadingWatcher->result());
+
+	m_loadingWatcher->disconnect(this);
+	m_loadingWatcher->deleteLater();
+	m_loadingWatcher = nullptr;
+
+	loadBookmarks(tree);
+}
+
+void BookmarksModel::handleStructureChanged()
+{
+	m_needsCompaction = true;
+}
+
 void BookmarksModel::handleFeedModified(Feed *feed)
 {
 	if (!hasFeed(feed->getUrl()))
@@ -969,71 +1368,159 @@ void BookmarksModel::handleFeedModified(Feed *feed)
 		return;
 	}
 
-	beginResetModel();
-	blockSignals(true);
+	beginResetModel();
+	blockSignals(true);
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		Bookmark *bookmark(bookmarks.at(i));
+		bookmark->removeRows(0, bookmark->rowCount());
+
+		const QVector<Feed::Entry> entries(feed->getEntries());
+
+		for (int j = 0; j < entries.count(); ++j)
+		{
+			const Feed::Entry &entry(entries.at(j));
+
+			if (entry.url.isValid())
+			{
+				addBookmark(UrlBookmark, {{UrlRole, entry.url}, {TitleRole, entry.title}, {DescriptionRole, feed->getEntryBody(entry.identifier).summary}}, bookmark);
+			}
+		}
+	}
+
+	blockSignals(false);
+	endResetModel();
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		emit bookmarkModified(bookmarks.at(i));
+	}
+
+	emit modelModified();
+}
+
+void BookmarksModel::handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword)
+{
+	if (!oldKeyword.isEmpty() && m_keywords.contains(oldKeyword))
+	{
+		m_keywords.remove(oldKeyword);
+
+		removeKeywordEntry(oldKeyword);
+	}
+
+	if (!newKeyword.isEmpty())
+	{
+		m_keywords[newKeyword] = bookmark;
+
+		addKeywordEntry(newKeyword, bookmark);
+	}
+}
+
+void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl)
+{
+	const quint64 oldUrlIdentifier(oldUrl.isEmpty() ? 0 : UrlsTable::getIdentifier(oldUrl));
+
+	if (oldUrlIdentifier > 0 && m_urls.contains(oldUrlIdentifier))
+	{
+		m_urls[oldUrlIdentifier].removeAll(bookmark);
+
+		removeUrlHash(bookmark, oldUrl);
+
+		if (m_urls[oldUrlIdentifier].isEmpty())
+		{
+			m_urls.remove(oldUrlIdentifier);
+
+			m_urlsIndex.removeUrl(oldUrl);
+
+			UrlsTable::releaseUrl(oldUrlIdentifier);
+		}
+	}
+
+	const quint64 newUrlIdentifier(newUrl.isEmpty() ? 0 : UrlsTable::retainUrl(newUrl));
+
+	if (newUrlIdentifier > 0)
+	{
+		if (m_urls.contains(newUrlIdentifier))
+		{
+			UrlsTable::releaseUrl(newUrlIdentifier);
+		}
+		else
+		{
+			m_urls[newUrlIdentifier] = {};
+
+			m_urlsIndex.addUrl(newUrl);
+		}
+
+		m_urls[newUrlIdentifier].append(bookmark);
+
+		addUrlHash(bookmark, newUrl);
+	}
+}
+
+void BookmarksModel::addUrlHash(Bookmark *bookmark, const QUrl &url)
+{
+	m_urlHashes[hashUrl(url)].append(bookmark);
+}
 
-	for (int i = 0; i < bookmarks.count(); ++i)
-	{
-		Bookmark *bookmark(bookmarks.at(i));
-		bookmark->removeRows(0, bookmark->rowCount());
+void BookmarksModel::removeUrlHash(Bookmark *bookmark, const QUrl &url)
+{
+	const quint64 hash(hashUrl(url));
 
-		const QVector<Feed::Entry> entries(feed->getEntries());
+	if (m_urlHashes.contains(hash))
+	{
+		m_urlHashes[hash].removeAll(bookmark);
 
-		for (int j = 0; j < entries.count(); ++j)
+		if (m_urlHashes[hash].isEmpty())
 		{
-			const Feed::Entry &entry(entries.at(j));
-
-			if (entry.url.isValid())
-			{
-				addBookmark(UrlBookmark, {{UrlRole, entry.url}, {TitleRole, entry.title}, {DescriptionRole, entry.summary}}, bookmark);
-			}
+			m_urlHashes.remove(hash);
 		}
 	}
+}
 
-	blockSignals(false);
-	endResetModel();
-
-	for (int i = 0; i < bookmarks.count(); ++i)
+void BookmarksModel::handleTitleChanged(Bookmark *bookmark, const QString &newTitle, const QString &oldTitle)
+{
+	if (!oldTitle.isEmpty())
 	{
-		emit bookmarkModified(bookmarks.at(i));
+		m_titles.remove(oldTitle.toCaseFolded(), bookmark);
 	}
 
-	emit modelModified();
+	if (!newTitle.isEmpty())
+	{
+		m_titles.insert(newTitle.toCaseFolded(), bookmark);
+	}
 }
 
-void BookmarksModel::handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword)
+void BookmarksModel::addKeywordEntry(const QString &keyword, Bookmark *bookmark)
 {
-	if (!oldKeyword.isEmpty() && m_keywords.contains(oldKeyword))
+	KeywordEntry entry;
+	entry.key = keyword.toCaseFolded();
+	entry.keyword = keyword;
+	entry.bookmark = bookmark;
+
+	const QVector<KeywordEntry>::iterator iterator(std::lower_bound(m_keywordsIndex.begin(), m_keywordsIndex.end(), entry, isKeywordEntryLess));
+
+	if (iterator != m_keywordsIndex.end() && iterator->keyword == keyword)
 	{
-		m_keywords.remove(oldKeyword);
+		iterator->bookmark = bookmark;
 	}
-
-	if (!newKeyword.isEmpty())
+	else
 	{
-		m_keywords[newKeyword] = bookmark;
+		m_keywordsIndex.insert(iterator, entry);
 	}
 }
 
-void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl)
+void BookmarksModel::removeKeywordEntry(const QString &keyword)
 {
-	if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
-	{
-		m_urls[oldUrl].removeAll(bookmark);
+	KeywordEntry entry;
+	entry.key = keyword.toCaseFolded();
+	entry.keyword = keyword;
 
-		if (m_urls[oldUrl].isEmpty())
-		{
-			m_urls.remove(oldUrl);
-		}
-	}
+	const QVector<KeywordEntry>::iterator iterator(std::lower_bound(m_keywordsIndex.begin(), m_keywordsIndex.end(), entry, isKeywordEntryLess));
 
-	if (!newUrl.isEmpty())
+	if (iterator != m_keywordsIndex.end() && iterator->keyword == keyword)
 	{
-		if (!m_urls.contains(newUrl))
-		{
-			m_urls[newUrl] = {};
-		}
-
-		m_urls[newUrl].append(bookmark);
+		m_keywordsIndex.erase(iterator);
 	}
 }
 
@@ -1095,6 +1582,11 @@ BookmarksModel::Bookmark* BookmarksModel::addBookmark(BookmarkType type, const Q
 				handleUrlChanged(bookmark, Utils::normalizeUrl(url));
 			}
 
+			if (parent->getType() != FeedBookmark)
+			{
+				handleTitleChanged(bookmark, metaData.value(TitleRole).toString());
+			}
+
 			if (type == UrlBookmark)
 			{
 				bookmark->setFlags(bookmark->flags() | Qt::ItemNeverHasChildren);
@@ -1251,6 +1743,124 @@ QDateTime BookmarksModel::readDateTime(QXmlStreamReader *reader, const QString &
 	return dateTime;
 }
 
+quint64 BookmarksModel::hashUrl(const QUrl &url)
+{
+	QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const QString scheme(normalizedUrl.scheme());
+	const int port(normalizedUrl.port());
+
+	if ((port == 80 && scheme == QLatin1String("http")) || (port == 443 && scheme == QLatin1String("https")) || (port == 21 && scheme == QLatin1String("ftp")))
+	{
+		normalizedUrl.setPort(-1);
+	}
+
+	const QString text(normalizedUrl.toString(QUrl::RemoveScheme | QUrl::StripTrailingSlash));
+	quint64 hash(14695981039346656037ULL);
+
+	for (int i = 0; i < text.length(); ++i)
+	{
+		hash ^= text.at(i).unicode();
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+bool BookmarksModel::isKeywordEntryLess(const KeywordEntry &first, const KeywordEntry &second)
+{
+	return ((first.key == second.key) ? (first.keyword < second.keyword) : (first.key < second.key));
+}
+
+BookmarksModel::BookmarksTree BookmarksModel::readBookmarks(const QString &path, bool areDescriptionsDeferred)
+{
+	BookmarksTree tree;
+	tree.path = path;
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		tree.openErrorString = file.errorString();
+
+		return tree;
+	}
+
+	QXmlStreamReader reader(&file);
+
+	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	{
+		while (reader.readNextStartElement())
+		{
+			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
+			{
+				readBookmark(&reader, tree, -1, areDescriptionsDeferred);
+			}
+			else
+			{
+				reader.skipCurrentElement();
+			}
+
+			if (reader.hasError())
+			{
+				tree.nodes.clear();
+				tree.readErrorString = reader.errorString();
+
+				break;
+			}
+		}
+	}
+
+	return tree;
+}
+
+bool BookmarksModel::writeJournal(const QString &path, const QByteArray &data)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		return false;
+	}
+
+	if (file.size() == 0)
+	{
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+		stream << static_cast<quint32>(JournalMagicNumber) << static_cast<quint32>(JournalFormatVersion);
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			return false;
+		}
+	}
+
+	return (file.write(data) == data.size() && file.flush());
+}
+
+bool BookmarksModel::writeFile(const QString &path, const QByteArray &data, const QString &journalPath)
+{
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	if (file.write(data) != data.size())
+	{
+		file.cancelWriting();
+
+		return false;
+	}
+
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	return (!QFile::exists(journalPath) || QFile::remove(journalPath));
+}
+
 QStringList BookmarksModel::mimeTypes() const
 {
 	return {QLatin1String("text/uri-list")};
@@ -1261,26 +1871,26 @@ QStringList BookmarksModel::getKeywords() const
 	return m_keywords.keys();
 }
 
-QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix) const
+QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix, const QElapsedTimer &timer, int timeBudget) const
 {
-	QVector<Bookmark*> matchedBookmarks;
+	KeywordEntry keywordEntry;
+	keywordEntry.key = prefix.toCaseFolded();
+
+	QSet<Bookmark*> matchedBookmarks;
 	QVector<BookmarkMatch> allMatches;
 	QVector<BookmarkMatch> currentMatches;
 	QMultiMap<QDateTime, BookmarkMatch> matchesMap;
-	QHash<QString, Bookmark*>::const_iterator keywordsIterator;
+	QVector<KeywordEntry>::const_iterator keywordsIterator;
 
-	for (keywordsIterator = m_keywords.constBegin(); keywordsIterator != m_keywords.constEnd(); ++keywordsIterator)
+	for (keywordsIterator = std::lower_bound(m_keywordsIndex.constBegin(), m_keywordsIndex.constEnd(), keywordEntry, isKeywordEntryLess); (keywordsIterator != m_keywordsIndex.constEnd() && keywordsIterator->key.startsWith(keywordEntry.key)); ++keywordsIterator)
 	{
-		if (keywordsIterator.key().startsWith(prefix, Qt::CaseInsensitive))
-		{
-			BookmarkMatch match;
-			match.bookmark = keywordsIterator.value();
-			match.match = keywordsIterator.key();
+		BookmarkMatch match;
+		match.bookmark = keywordsIterator->bookmark;
+		match.match = keywordsIterator->keyword;
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+		matchesMap.insert(match.bookmark->getTimeVisited(), match);
 
-			matchedBookmarks.append(match.bookmark);
-		}
+		matchedBookmarks.insert(match.bookmark);
 	}
 
 	currentMatches = matchesMap.values().toVector();
@@ -1294,27 +1904,49 @@ QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QStri
 		allMatches.append(currentMatches.at(i));
 	}
 
-	QHash<QUrl, QVector<Bookmark*> >::const_iterator urlsIterator;
+	const QVector<UrlCompletionIndex::UrlMatch> urlMatches(m_urlsIndex.findUrls(prefix, timer, timeBudget));
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	for (int i = 0; i < urlMatches.count(); ++i)
 	{
-		if (urlsIterator.value().isEmpty() || matchedBookmarks.contains(urlsIterator.value().value(0)))
+		Bookmark *bookmark(m_urls.value(UrlsTable::getIdentifier(urlMatches.at(i).url)).value(0));
+
+		if (!bookmark || matchedBookmarks.contains(bookmark))
 		{
 			continue;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		BookmarkMatch match;
+		match.bookmark = bookmark;
+		match.match = urlMatches.at(i).match;
 
-		if (!result.isEmpty())
-		{
-			BookmarkMatch match;
-			match.bookmark = urlsIterator.value().value(0);
-			match.match = result;
+		matchesMap.insert(match.bookmark->getTimeVisited(), match);
+
+		matchedBookmarks.insert(match.bookmark);
+	}
+
+	QMultiMap<QString, Bookmark*>::const_iterator titlesIterator;
+	int amount(0);
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+	for (titlesIterator = m_titles.lowerBound(keywordEntry.key); (titlesIterator != m_titles.constEnd() && titlesIterator.key().startsWith(keywordEntry.key)); ++titlesIterator)
+	{
+		++amount;
+
+		if (timeBudget >= 0 && (amount % 256) == 0 && timer.isValid() && timer.elapsed() > timeBudget)
+		{
+			break;
+		}
 
-			matchedBookmarks.append(match.bookmark);
+		if (matchedBookmarks.contains(titlesIterator.value()))
+		{
+			continue;
 		}
+
+		BookmarkMatch match;
+		match.bookmark = titlesIterator.value();
+
+		matchesMap.insert(match.bookmark->getTimeVisited(), match);
+
+		matchedBookmarks.insert(match.bookmark);
 	}
 
 	currentMatches = matchesMap.values().toVector();
@@ -1336,31 +1968,34 @@ QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, QSt
 		branch = m_rootItem;
 	}
 
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const QVector<Bookmark*> candidates(m_urlHashes.value(hashUrl(url)));
 	QVector<Bookmark*> bookmarks;
+	bookmarks.reserve(candidates.count());
 
-	for (int i = 0; i < branch->rowCount(); ++i)
+	for (int i = 0; i < candidates.count(); ++i)
 	{
-		Bookmark *bookmark(static_cast<Bookmark*>(branch->child(i)));
+		Bookmark *bookmark(candidates.at(i));
 
-		if (bookmark)
+		if (bookmark->getType() != UrlBookmark)
 		{
-			switch (bookmark->getType())
-			{
-				case FolderBookmark:
-					bookmarks.append(findUrls(url, bookmark));
+			continue;
+		}
 
-					break;
-				case UrlBookmark:
-					if (normalizedUrl == Utils::normalizeUrl(bookmark->getUrl()))
-					{
-						bookmarks.append(bookmark);
-					}
+		QStandardItem *parent(bookmark->parent());
 
-					break;
-				default:
-					break;
-			}
+		if (parent && static_cast<Bookmark*>(parent)->getType() == FeedBookmark)
+		{
+			continue;
+		}
+
+		while (parent && parent != branch)
+		{
+			parent = parent->parent();
+		}
+
+		if (parent)
+		{
+			bookmarks.append(bookmark);
 		}
 	}
 
@@ -1369,20 +2004,42 @@ QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, QSt
 
 QVector<BookmarksModel::Bookmark*> BookmarksModel::getBookmarks(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
-	QVector<BookmarksModel::Bookmark*> bookmarks;
+	return m_urlHashes.value(hashUrl(url));
+}
 
-	if (m_urls.contains(url))
-	{
-		bookmarks = m_urls[url];
-	}
+QVector<QVector<BookmarksModel::Bookmark*> > BookmarksModel::getDuplicates() const
+{
+	QVector<QVector<Bookmark*> > duplicates;
+	QHash<quint64, QVector<Bookmark*> >::const_iterator iterator;
 
-	if (url != normalizedUrl && m_urls.contains(normalizedUrl))
+	for (iterator = m_urlHashes.constBegin(); iterator != m_urlHashes.constEnd(); ++iterator)
 	{
-		bookmarks.append(m_urls[normalizedUrl]);
+		if (iterator.value().count() < 2)
+		{
+			continue;
+		}
+
+		QVector<Bookmark*> bookmarks;
+		bookmarks.reserve(iterator.value().count());
+
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			Bookmark *bookmark(iterator.value().at(i));
+			const Bookmark *parent(static_cast<Bookmark*>(bookmark->parent()));
+
+			if (bookmark->getType() == UrlBookmark && !bookmark->data(IsTrashedRole).toBool() && (!parent || parent->getType() != FeedBookmark))
+			{
+				bookmarks.append(bookmark);
+			}
+		}
+
+		if (bookmarks.count() > 1)
+		{
+			duplicates.append(bookmarks);
+		}
 	}
 
-	return bookmarks;
+	return duplicates;
 }
 
 BookmarksModel::FormatMode BookmarksModel::getFormatMode() const
@@ -1390,6 +2047,11 @@ BookmarksModel::FormatMode BookmarksModel::getFormatMode() const
 	return m_mode;
 }
 
+int BookmarksModel::getBookmarksAmount() const
+{
+	return m_identifiers.count();
+}
+
 bool BookmarksModel::moveBookmark(Bookmark *bookmark, Bookmark *newParent, int newRow)
 {
 	if (!bookmark || !newParent || bookmark == newParent || bookmark->isAncestorOf(newParent))
@@ -1416,11 +2078,17 @@ bool BookmarksModel::moveBookmark(Bookmark *bookmark, Bookmark *newParent, int n
 	}
 
 	const int previousRow(bookmark->row());
+	const bool wasTrashed(bookmark->data(IsTrashedRole).toBool());
+	const bool needsCompaction(m_needsCompaction);
 
 	if (newRow < 0)
 	{
 		newParent->appendRow(bookmark->parent()->takeRow(bookmark->row()));
 
+		m_needsCompaction = (needsCompaction || wasTrashed || bookmark->data(IsTrashedRole).toBool());
+
+		appendJournalRecord(MoveRecord, bookmark);
+
 		emit bookmarkMoved(bookmark, previousParent, previousRow);
 		emit modelModified();
 
@@ -1436,6 +2104,10 @@ bool BookmarksModel::moveBookmark(Bookmark *bookmark, Bookmark *newParent, int n
 
 	newParent->insertRow(targetRow, bookmark->parent()->takeRow(bookmark->row()));
 
+	m_needsCompaction = (needsCompaction || wasTrashed || bookmark->data(IsTrashedRole).toBool());
+
+	appendJournalRecord(MoveRecord, bookmark);
+
 	emit bookmarkMoved(bookmark, previousParent, previousRow);
 	emit modelModified();
 
@@ -1488,9 +2160,19 @@ bool BookmarksModel::dropMimeData(const QMimeData *data, Qt::DropAction action,
 	return false;
 }
 
+QByteArray BookmarksModel::getXbel() const
+{
+	QByteArray data;
+	QXmlStreamWriter writer(&data);
+
+	writeBookmarks(&writer);
+
+	return data;
+}
+
 bool BookmarksModel::save(const QString &path) const
 {
-	if (SessionsManager::isReadOnly())
+	if (SessionsManager::isReadOnly() || m_loadingWatcher)
 	{
 		return false;
 	}
@@ -1503,21 +2185,88 @@ bool BookmarksModel::save(const QString &path) const
 	}
 
 	QXmlStreamWriter writer(&file);
-	writer.setAutoFormatting(true);
-	writer.setAutoFormattingIndent(-1);
-	writer.writeStartDocument();
-	writer.writeDTD(QLatin1String("<!DOCTYPE xbel>"));
-	writer.writeStartElement(QLatin1String("xbel"));
-	writer.writeAttribute(QLatin1String("version"), QLatin1String("1.0"));
 
-	for (int i = 0; i < m_rootItem->rowCount(); ++i)
+	writeBookmarks(&writer);
+
+	return file.commit();
+}
+
+bool BookmarksModel::flushJournal(bool isBlocking)
+{
+	if (m_loadingWatcher)
 	{
-		writeBookmark(&writer, m_rootItem->getChild(i));
+		return true;
 	}
 
-	writer.writeEndDocument();
+	if (m_isSaving)
+	{
+		if (!isBlocking && m_savingFuture.isRunning())
+		{
+			return false;
+		}
+
+		m_savingFuture.waitForFinished();
 
-	return file.commit();
+		m_isSaving = false;
+
+		if (!m_savingFuture.result())
+		{
+			Console::addMessage(((m_mode == NotesMode) ? tr("Failed to save notes file") : tr("Failed to save bookmarks file")), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+			m_needsCompaction = true;
+		}
+	}
+
+	if (SessionsManager::isReadOnly())
+	{
+		m_journalBuffer.clear();
+
+		return true;
+	}
+
+	if (!m_isJournalEnabled || m_needsCompaction || m_journalRecordsAmount > 1000)
+	{
+		QByteArray data;
+		QXmlStreamWriter writer(&data);
+
+		writeBookmarks(&writer);
+
+		m_journalBuffer.clear();
+
+		m_journalRecordsAmount = 0;
+		m_needsCompaction = false;
+
+		if (isBlocking)
+		{
+			if (!writeFile(m_path, data, m_journalPath))
+			{
+				Console::addMessage(((m_mode == NotesMode) ? tr("Failed to save notes file") : tr("Failed to save bookmarks file")), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+				m_needsCompaction = true;
+			}
+
+			return true;
+		}
+
+		m_savingFuture = QtConcurrent::run(&BookmarksModel::writeFile, m_path, data, m_journalPath);
+		m_isSaving = true;
+
+		return true;
+	}
+
+	if (!m_journalBuffer.isEmpty())
+	{
+		if (!writeJournal(m_journalPath, m_journalBuffer))
+		{
+			Console::addMessage(((m_mode == NotesMode) ? tr("Failed to save notes journal") : tr("Failed to save bookmarks journal")), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
+
+			m_needsCompaction = true;
+		}
+
+		m_journalBuffer.clear();
+	}
+
+	return true;
 }
 
 bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, int role)
@@ -1532,6 +2281,8 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 	switch (role)
 	{
 		case DescriptionRole:
+			m_deferredDescriptions.remove(bookmark->getIdentifier());
+
 			if (m_mode == NotesMode)
 			{
 				const QString title(value.toString().section(QLatin1Char('\n'), 0, 0).left(100));
@@ -1539,6 +2290,13 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 				setData(index, ((title == value.toString().trimmed()) ? title : title + QStringLiteral("…")), TitleRole);
 			}
 
+			break;
+		case TitleRole:
+			if ((bookmark->getType() == FeedBookmark || bookmark->getType() == UrlBookmark) && value.toString() != bookmark->getRawData(TitleRole).toString() && !bookmark->data(IsTrashedRole).toBool())
+			{
+				handleTitleChanged(bookmark, value.toString(), bookmark->getRawData(TitleRole).toString());
+			}
+
 			break;
 		case KeywordRole:
 			if (value.toString() != index.data(KeywordRole).toString())
@@ -1562,16 +2320,24 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 
 	switch (role)
 	{
+		case IdentifierRole:
+		case TypeRole:
+			m_needsCompaction = true;
+
+			emit bookmarkModified(bookmark);
+			emit modelModified();
+
+			break;
 		case TitleRole:
 		case UrlRole:
 		case DescriptionRole:
-		case IdentifierRole:
-		case TypeRole:
 		case KeywordRole:
 		case TimeAddedRole:
 		case TimeModifiedRole:
 		case TimeVisitedRole:
 		case VisitsRole:
+			appendJournalRecord(DataRecord, bookmark, role);
+
 			emit bookmarkModified(bookmark);
 			emit modelModified();
 
@@ -1585,7 +2351,7 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 
 bool BookmarksModel::hasBookmark(const QUrl &url) const
 {
-	return (m_urls.contains(url) || m_urls.contains(Utils::normalizeUrl(url)));
+	return m_urlHashes.contains(hashUrl(url));
 }
 
 bool BookmarksModel::hasFeed(const QUrl &url) const
@@ -21,6 +21,10 @@
 #ifndef OTTER_BOOKMARKSMODEL_H
 #define OTTER_BOOKMARKSMODEL_H
 
+#include "UrlCompletionIndex.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QUrl>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -107,8 +111,34 @@ public:
 		QString match;
 	};
 
+	struct BookmarkNode final
+	{
+		QString title;
+		QString description;
+		QString keyword;
+		QString url;
+		QDateTime timeAdded;
+		QDateTime timeModified;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		BookmarkType type = UnknownBookmark;
+		int parent = -1;
+		int visits = 0;
+		bool isDescriptionDeferred = false;
+	};
+
+	struct BookmarksTree final
+	{
+		QVector<BookmarkNode> nodes;
+		QString path;
+		QString openErrorString;
+		QString readErrorString;
+	};
+
 	explicit BookmarksModel(const QString &path, FormatMode mode, QObject *parent = nullptr);
+	~BookmarksModel();
 
+	void ensureLoaded();
 	void beginImport(Bookmark *target, int estimatedUrlsAmount = 0, int estimatedKeywordsAmount = 0);
 	void endImport();
 	void trashBookmark(Bookmark *bookmark);
@@ -124,14 +154,19 @@ public:
 	QMimeData* mimeData(const QModelIndexList &indexes) const override;
 	QStringList mimeTypes() const override;
 	QStringList getKeywords() const;
-	QVector<BookmarkMatch> findBookmarks(const QString &prefix) const;
+	QVector<BookmarkMatch> findBookmarks(const QString &prefix, const QElapsedTimer &timer = {}, int timeBudget = -1) const;
 	QVector<Bookmark*> findUrls(const QUrl &url, QStandardItem *branch = nullptr) const;
 	QVector<Bookmark*> getBookmarks(const QUrl &url) const;
+	QVector<QVector<Bookmark*> > getDuplicates() const;
+	QByteArray getXbel() const;
 	FormatMode getFormatMode() const;
+	int getBookmarksAmount() const;
+	int importBookmarks(const BookmarksTree &tree, Bookmark *target = nullptr, bool areDuplicatesAllowed = true);
 	bool moveBookmark(Bookmark *bookmark, Bookmark *newParent, int newRow = -1);
 	bool canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const override;
 	bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) override;
 	bool save(const QString &path) const;
+	bool flushJournal(bool isBlocking = false);
 	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 	bool hasBookmark(const QUrl &url) const;
 	bool hasFeed(const QUrl &url) const;
@@ -141,16 +176,54 @@ public slots:
 	void emptyTrash();
 
 protected:
-	void readBookmark(QXmlStreamReader *reader, Bookmark *parent);
+	enum JournalFormat : quint32
+	{
+		JournalMagicNumber = 0x4F424D4A,
+		JournalFormatVersion = 1
+	};
+
+	enum JournalRecordType : quint8
+	{
+		UnknownRecord = 0,
+		DataRecord,
+		MoveRecord
+	};
+
+	struct KeywordEntry final
+	{
+		QString key;
+		QString keyword;
+		Bookmark *bookmark = nullptr;
+	};
+
+	void loadBookmarks(const BookmarksTree &tree);
+	int createBookmarks(const BookmarksTree &tree, QList<QStandardItem*> &topLevelBookmarks, QVector<Bookmark*> &feeds, bool isImporting, bool areDuplicatesAllowed);
+	static void readBookmark(QXmlStreamReader *reader, BookmarksTree &tree, int parent, bool areDescriptionsDeferred);
+	void writeBookmarks(QXmlStreamWriter *writer) const;
 	void writeBookmark(QXmlStreamWriter *writer, Bookmark *bookmark) const;
+	void appendJournalRecord(JournalRecordType type, Bookmark *bookmark, int role = -1);
+	void loadJournal();
+	void loadDeferredDescriptions();
 	void removeBookmarkUrl(Bookmark *bookmark);
 	void readdBookmarkUrl(Bookmark *bookmark);
 	void setupFeed(Bookmark *bookmark);
 	void handleKeywordChanged(Bookmark *bookmark, const QString &newKeyword, const QString &oldKeyword = {});
 	void handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl = {});
+	void handleTitleChanged(Bookmark *bookmark, const QString &newTitle, const QString &oldTitle = {});
+	void addUrlHash(Bookmark *bookmark, const QUrl &url);
+	void removeUrlHash(Bookmark *bookmark, const QUrl &url);
+	void addKeywordEntry(const QString &keyword, Bookmark *bookmark);
+	void removeKeywordEntry(const QString &keyword);
 	static QDateTime readDateTime(QXmlStreamReader *reader, const QString &attribute);
+	static quint64 hashUrl(const QUrl &url);
+	static bool isKeywordEntryLess(const KeywordEntry &first, const KeywordEntry &second);
+	static BookmarksTree readBookmarks(const QString &path, bool areDescriptionsDeferred = false);
+	static bool writeJournal(const QString &path, const QByteArray &data);
+	static bool writeFile(const QString &path, const QByteArray &data, const QString &journalPath);
 
 protected slots:
+	void handleBookmarksLoaded();
+	void handleStructureChanged();
 	void handleFeedModified(Feed *feed);
 	void notifyBookmarkModified(const QModelIndex &index);
 
@@ -158,12 +231,26 @@ private:
 	Bookmark *m_rootItem;
 	Bookmark *m_trashItem;
 	Bookmark *m_importTargetItem;
+	QFutureWatcher<BookmarksTree> *m_loadingWatcher;
+	QFuture<bool> m_savingFuture;
+	QString m_path;
+	QString m_journalPath;
+	QByteArray m_journalBuffer;
 	QHash<Bookmark*, QPair<QModelIndex, int> > m_trash;
 	QHash<QUrl, QVector<Bookmark*> > m_feeds;
-	QHash<QUrl, QVector<Bookmark*> > m_urls;
+	QHash<quint64, QVector<Bookmark*> > m_urls;
+	QHash<quint64, QVector<Bookmark*> > m_urlHashes;
 	QHash<QString, Bookmark*> m_keywords;
+	QVector<KeywordEntry> m_keywordsIndex;
+	QMultiMap<QString, Bookmark*> m_titles;
+	UrlCompletionIndex m_urlsIndex;
 	QMap<quint64, Bookmark*> m_identifiers;
+	QHash<quint64, int> m_deferredDescriptions;
 	FormatMode m_mode;
+	int m_journalRecordsAmount;
+	bool m_isJournalEnabled;
+	bool m_isSaving;
+	bool m_needsCompaction;
 
 signals:
 	void bookmarkAdded(Bookmark *bookmark);
@@ -0,0 +1,204 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ClosedWindowsStorage.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+
+namespace Otter
+{
+
+std::unique_ptr<QTemporaryFile> ClosedWindowsStorage::m_currentFile;
+std::unique_ptr<QTemporaryFile> ClosedWindowsStorage::m_previousFile;
+QHash<quint64, ClosedWindowsStorage::Record> ClosedWindowsStorage::m_records;
+quint64 ClosedWindowsStorage::m_identifierCounter(0);
+int ClosedWindowsStorage::m_generation(0);
+
+void ClosedWindowsStorage::storeHistory(Session::Window::History &history)
+{
+	if (history.storageIdentifier > 0 || history.entries.count() < 2 || history.index < 0 || history.index >= history.entries.count())
+	{
+		return;
+	}
+
+	if ((!m_currentFile || m_currentFile->size() >= GenerationSizeLimit) && !rotate())
+	{
+		return;
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<qint32>(history.index) << static_cast<qint32>(history.entries.count());
+
+	for (int i = 0; i < history.entries.count(); ++i)
+	{
+		const Session::Window::History::Entry &entry(history.entries.at(i));
+
+		stream << entry.url << entry.title << entry.icon << entry.time << entry.position << static_cast<qint32>(entry.zoom);
+	}
+
+	Record record;
+	record.offset = m_currentFile->size();
+	record.size = data.size();
+	record.generation = m_generation;
+
+	if (!m_currentFile->seek(record.offset) || m_currentFile->write(data) != data.size())
+	{
+		return;
+	}
+
+	++m_identifierCounter;
+
+	m_records[m_identifierCounter] = record;
+
+	const Session::Window::History::Entry entry(history.entries.at(history.index));
+
+	history.entries = {entry};
+	history.index = 0;
+	history.storageIdentifier = m_identifierCounter;
+}
+
+void ClosedWindowsStorage::storeHistories(Session::MainWindow &mainWindow)
+{
+	for (int i = 0; i < mainWindow.windows.count(); ++i)
+	{
+		storeHistory(mainWindow.windows[i].history);
+	}
+}
+
+void ClosedWindowsStorage::restoreHistory(Session::Window::History &history)
+{
+	if (history.storageIdentifier == 0)
+	{
+		return;
+	}
+
+	const Record record(m_records.take(history.storageIdentifier));
+	QTemporaryFile *file(getFile(record.generation));
+
+	history.storageIdentifier = 0;
+
+	if (!file || record.size <= 0 || !file->seek(record.offset))
+	{
+		return;
+	}
+
+	const QByteArray data(file->read(record.size));
+
+	file->seek(file->size());
+
+	if (data.size() != record.size)
+	{
+		return;
+	}
+
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	qint32 index(-1);
+	qint32 amount(0);
+
+	stream >> index >> amount;
+
+	QVector<Session::Window::History::Entry> entries;
+	entries.reserve(amount);
+
+	for (int i = 0; i < amount; ++i)
+	{
+		Session::Window::History::Entry entry;
+		qint32 zoom(100);
+
+		stream >> entry.url >> entry.title >> entry.icon >> entry.time >> entry.position >> zoom;
+
+		entry.zoom = zoom;
+
+		entries.append(entry);
+	}
+
+	if (stream.status() == QDataStream::Ok && index >= 0 && index < entries.count())
+	{
+		history.entries = entries;
+		history.index = index;
+	}
+}
+
+void ClosedWindowsStorage::restoreHistories(Session::MainWindow &mainWindow)
+{
+	for (int i = 0; i < mainWindow.windows.count(); ++i)
+	{
+		restoreHistory(mainWindow.windows[i].history);
+	}
+}
+
+void ClosedWindowsStorage::clear()
+{
+	m_currentFile.reset();
+	m_previousFile.reset();
+	m_records.clear();
+}
+
+QTemporaryFile* ClosedWindowsStorage::getFile(int generation)
+{
+	if (generation == m_generation)
+	{
+		return m_currentFile.get();
+	}
+
+	if (generation == (m_generation - 1))
+	{
+		return m_previousFile.get();
+	}
+
+	return nullptr;
+}
+
+bool ClosedWindowsStorage::rotate()
+{
+	std::unique_ptr<QTemporaryFile> file(new QTemporaryFile(QDir(QDir::tempPath()).filePath(QLatin1String("otter-closed-windows-XXXXXX.dat"))));
+
+	if (!file->open())
+	{
+		return false;
+	}
+
+	QHash<quint64, Record>::iterator iterator(m_records.begin());
+
+	while (iterator != m_records.end())
+	{
+		if (iterator.value().generation < m_generation)
+		{
+			iterator = m_records.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	m_previousFile = std::move(m_currentFile);
+	m_currentFile = std::move(file);
+
+	++m_generation;
+
+	return true;
+}
+
+}
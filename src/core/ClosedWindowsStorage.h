@@ -0,0 +1,67 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_CLOSEDWINDOWSSTORAGE_H
+#define OTTER_CLOSEDWINDOWSSTORAGE_H
+
+#include "SessionsManager.h"
+
+#include <QtCore/QTemporaryFile>
+
+#include <memory>
+
+namespace Otter
+{
+
+class ClosedWindowsStorage final
+{
+public:
+	static void storeHistory(Session::Window::History &history);
+	static void storeHistories(Session::MainWindow &mainWindow);
+	static void restoreHistory(Session::Window::History &history);
+	static void restoreHistories(Session::MainWindow &mainWindow);
+	static void clear();
+
+protected:
+	enum StorageParameter
+	{
+		GenerationSizeLimit = 4194304
+	};
+
+	struct Record final
+	{
+		qint64 offset = 0;
+		int size = 0;
+		int generation = 0;
+	};
+
+	static QTemporaryFile* getFile(int generation);
+	static bool rotate();
+
+private:
+	static std::unique_ptr<QTemporaryFile> m_currentFile;
+	static std::unique_ptr<QTemporaryFile> m_previousFile;
+	static QHash<quint64, Record> m_records;
+	static quint64 m_identifierCounter;
+	static int m_generation;
+};
+
+}
+
+#endif
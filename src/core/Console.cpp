@@ -20,15 +20,22 @@
 #include "Console.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
 Console* Console::m_instance(nullptr);
 QVector<Console::Message> Console::m_messages;
+QVector<Console::Message> Console::m_pendingMessages;
+QMutex Console::m_mutex;
+quint64 Console::m_identifierCounter(0);
+int Console::m_firstMessage(0);
 
-Console::Console(QObject *parent) : QObject(parent)
+Console::Console(QObject *parent) : QObject(parent),
+	m_notificationTimer(0)
 {
+	m_messages.reserve(MessagesLimit);
 }
 
 void Console::createInstance()
@@ -49,14 +56,82 @@ void Console::addMessage(const QString &note, MessageCategory category, MessageL
 	message.line = line;
 	message.window = window;
 
-	m_messages.append(message);
+	QMutexLocker locker(&m_mutex);
 
-	if (m_messages.count() > 1000)
+	if (!m_messages.isEmpty())
 	{
-		m_messages.removeFirst();
+		Message &lastMessage(m_messages[(m_firstMessage + m_messages.count() - 1) % m_messages.count()]);
+
+		if (lastMessage.isRepeatOf(message))
+		{
+			lastMessage.time = message.time;
+			++lastMessage.amount;
+
+			message = lastMessage;
+		}
 	}
 
-	emit m_instance->messageAdded(message);
+	if (message.amount == 1)
+	{
+		message.identifier = ++m_identifierCounter;
+
+		if (m_messages.count() < MessagesLimit)
+		{
+			m_messages.append(message);
+		}
+		else
+		{
+			m_messages[m_firstMessage] = message;
+
+			m_firstMessage = ((m_firstMessage + 1) % MessagesLimit);
+		}
+
+		m_pendingMessages.append(message);
+	}
+	else if (!m_pendingMessages.isEmpty() && m_pendingMessages.last().identifier == message.identifier)
+	{
+		m_pendingMessages.last() = message;
+	}
+	else
+	{
+		m_pendingMessages.append(message);
+	}
+
+	if (m_instance && m_pendingMessages.count() == 1)
+	{
+		QMetaObject::invokeMethod(m_instance, "scheduleNotification", Qt::AutoConnection);
+	}
+}
+
+void Console::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_notificationTimer)
+	{
+		killTimer(m_notificationTimer);
+
+		m_notificationTimer = 0;
+
+		QVector<Message> messages;
+
+		{
+			QMutexLocker locker(&m_mutex);
+
+			messages.swap(m_pendingMessages);
+		}
+
+		if (!messages.isEmpty())
+		{
+			emit messagesAdded(messages);
+		}
+	}
+}
+
+void Console::scheduleNotification()
+{
+	if (m_notificationTimer == 0)
+	{
+		m_notificationTimer = startTimer(NotificationInterval);
+	}
 }
 
 Console* Console::getInstance()
@@ -66,7 +141,22 @@ Console* Console::getInstance()
 
 QVector<Console::Message> Console::getMessages()
 {
-	return m_messages;
+	QMutexLocker locker(&m_mutex);
+
+	if (m_firstMessage == 0)
+	{
+		return m_messages;
+	}
+
+	QVector<Message> messages;
+	messages.reserve(m_messages.count());
+
+	for (int i = 0; i < m_messages.count(); ++i)
+	{
+		messages.append(m_messages.at((m_firstMessage + i) % m_messages.count()));
+	}
+
+	return messages;
 }
 
 }
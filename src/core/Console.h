@@ -21,6 +21,7 @@
 #define OTTER_CONSOLE_H
 
 #include <QtCore/QDateTime>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QVector>
 
@@ -58,8 +59,15 @@ public:
 		QString source;
 		MessageCategory category = OtherCategory;
 		MessageLevel level = UnknownLevel;
+		quint64 identifier = 0;
 		quint64 window = 0;
 		int line = -1;
+		int amount = 1;
+
+		bool isRepeatOf(const Message &other) const
+		{
+			return (line == other.line && window == other.window && category == other.category && level == other.level && note == other.note && source == other.source);
+		}
 	};
 
 	static void createInstance();
@@ -68,14 +76,31 @@ public:
 	static QVector<Console::Message> getMessages();
 
 protected:
+	enum MessagesParameter
+	{
+		MessagesLimit = 1000,
+		NotificationInterval = 16
+	};
+
 	explicit Console(QObject *parent = nullptr);
 
+	void timerEvent(QTimerEvent *event) override;
+
+protected slots:
+	void scheduleNotification();
+
 private:
+	int m_notificationTimer;
+
 	static Console *m_instance;
 	static QVector<Message> m_messages;
+	static QVector<Message> m_pendingMessages;
+	static QMutex m_mutex;
+	static quint64 m_identifierCounter;
+	static int m_firstMessage;
 
 signals:
-	void messageAdded(const Console::Message &message);
+	void messagesAdded(const QVector<Console::Message> &messages);
 };
 
 }
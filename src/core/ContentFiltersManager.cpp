@@ -23,13 +23,20 @@
 #include "Application.h"
 #include "Console.h"
 #include "JsonSettings.h"
+#include "PersistenceManager.h"
+#include "PublicSuffixList.h"
 #include "SettingsManager.h"
 #include "SessionsManager.h"
+#include "Tracer.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
@@ -37,14 +44,64 @@ namespace Otter
 ContentFiltersManager* ContentFiltersManager::m_instance(nullptr);
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_contentBlockingProfiles;
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_fraudCheckingProfiles;
+QCache<QString, ContentFiltersManager::CheckResult> ContentFiltersManager::m_resultsCache;
+QCache<QString, ContentFiltersManager::CosmeticFiltersResult> ContentFiltersManager::m_cosmeticFiltersCache;
+QHash<QString, QStringList> ContentFiltersManager::m_genericCosmeticFilters;
+QMutex ContentFiltersManager::m_resultsCacheMutex;
+QReadWriteLock ContentFiltersManager::m_profilesLock;
+ContentFiltersManager::RuleStatisticsShard ContentFiltersManager::m_ruleStatisticsShards[ContentFiltersManager::RuleStatisticsShardsAmount];
+QAtomicInt ContentFiltersManager::m_hasRuleStatisticsChanges(0);
+ContentFiltersManager::PendingRequestsPolicy ContentFiltersManager::m_pendingRequestsPolicy(HoldPendingRequestsPolicy);
+quint64 ContentFiltersManager::m_resultsCacheHits(0);
+quint64 ContentFiltersManager::m_resultsCacheMisses(0);
+quint64 ContentFiltersManager::m_resultsMatchingTime(0);
+bool ContentFiltersManager::m_areProfilesMerged(false);
+bool ContentFiltersManager::m_areRuleStatisticsEnabled(false);
 
 ContentFiltersManager::ContentFiltersManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+	m_ruleStatisticsTimer(0)
 {
+	loadRuleStatistics();
+	handleOptionChanged(SettingsManager::ContentBlocking_EnableRuleStatisticsOption, SettingsManager::getOption(SettingsManager::ContentBlocking_EnableRuleStatisticsOption));
+	handleOptionChanged(SettingsManager::ContentBlocking_PendingRequestsPolicyOption, SettingsManager::getOption(SettingsManager::ContentBlocking_PendingRequestsPolicyOption));
+	handleOptionChanged(SettingsManager::ContentBlocking_MergeProfilesOption, SettingsManager::getOption(SettingsManager::ContentBlocking_MergeProfilesOption));
+	handleOptionChanged(SettingsManager::ContentBlocking_ResultsCacheLimitOption, SettingsManager::getOption(SettingsManager::ContentBlocking_ResultsCacheLimitOption));
+
 	QTimer::singleShot(1000, this, [&]()
 	{
 		initialize();
 	});
+
+	PersistenceManager::registerTarget(this, [&](bool)
+	{
+		save();
+
+		return true;
+	});
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &ContentFiltersManager::handleOptionChanged);
+	connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [&]()
+	{
+		if (m_hasRuleStatisticsChanges.loadAcquire() != 0)
+		{
+			saveRuleStatistics();
+		}
+	});
+}
+
+void ContentFiltersManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_ruleStatisticsTimer)
+	{
+		if (m_hasRuleStatisticsChanges.loadAcquire() != 0)
+		{
+			saveRuleStatistics();
+		}
+	}
+	else
+	{
+		QObject::timerEvent(event);
+	}
 }
 
 void ContentFiltersManager::createInstance()
@@ -153,6 +210,8 @@ void ContentFiltersManager::initialize()
 
 		profileSummary.lastUpdate = QDateTime::fromString(profileObject.value(QLatin1String("lastUpdate")).toString(), Qt::ISODate);
 		profileSummary.lastUpdate.setTimeSpec(Qt::UTC);
+		profileSummary.updateEntityTag = profileObject.value(QLatin1String("updateEntityTag")).toString();
+		profileSummary.updateLastModified = profileObject.value(QLatin1String("updateLastModified")).toString();
 		profileSummary.category = categoryTitles.value(profileObject.value(QLatin1String("category")).toString());
 		profileSummary.updateInterval = profileObject.value(QLatin1String("updateInterval")).toInt();
 		profileSummary.areWildcardsEnabled = profileObject.value(QLatin1String("areWildcardsEnabled")).toBool();
@@ -168,47 +227,135 @@ void ContentFiltersManager::initialize()
 
 		ContentFiltersProfile *profile(new AdblockContentFiltersProfile(profileSummary, languages, flags, m_instance));
 
+		m_profilesLock.lockForWrite();
 		m_contentBlockingProfiles.append(profile);
+		m_profilesLock.unlock();
 
 		connect(profile, &ContentFiltersProfile::profileModified, profile, [=]()
 		{
+			clearResultsCache();
+
 			m_instance->scheduleSave();
 
 			emit m_instance->profileModified(profile->getName());
 		});
+		connect(profile, &ContentFiltersProfile::profileLoaded, profile, [=]()
+		{
+			clearResultsCache();
+
+			emit m_instance->profileLoaded(profile->getName());
+		});
 	}
 
 	m_contentBlockingProfiles.squeeze();
+
+	loadProfiles();
 }
 
-void ContentFiltersManager::timerEvent(QTimerEvent *event)
+void ContentFiltersManager::loadProfiles()
 {
-	if (event->timerId() == m_saveTimer)
+	const Tracer::Span span("ContentFiltersManager::loadProfiles", "contentFilters");
+
+	if (!SettingsManager::getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption).toBool())
 	{
-		killTimer(m_saveTimer);
+		return;
+	}
 
-		m_saveTimer = 0;
+	const QStringList names(SettingsManager::getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList());
 
-		save();
+	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+	{
+		if (names.contains(m_contentBlockingProfiles.at(i)->getName()))
+		{
+			m_contentBlockingProfiles.at(i)->load();
+		}
 	}
 }
 
 void ContentFiltersManager::scheduleSave()
 {
-	if (Application::isAboutToQuit())
+	PersistenceManager::markAsDirty(this);
+}
+
+void ContentFiltersManager::handleOptionChanged(int identifier, const QVariant &value)
+{
+	switch (identifier)
 	{
-		if (m_saveTimer != 0)
-		{
-			killTimer(m_saveTimer);
+		case SettingsManager::ContentBlocking_EnableContentBlockingOption:
+		case SettingsManager::ContentBlocking_ProfilesOption:
+			if (!m_contentBlockingProfiles.isEmpty())
+			{
+				loadProfiles();
+			}
 
-			m_saveTimer = 0;
-		}
+			break;
+		case SettingsManager::ContentBlocking_EnableRuleStatisticsOption:
+			m_areRuleStatisticsEnabled = value.toBool();
 
-		save();
-	}
-	else if (m_saveTimer == 0)
-	{
-		m_saveTimer = startTimer(1000);
+			if (m_areRuleStatisticsEnabled && m_ruleStatisticsTimer == 0)
+			{
+				m_ruleStatisticsTimer = startTimer(RuleStatisticsSaveInterval);
+			}
+			else if (!m_areRuleStatisticsEnabled && m_ruleStatisticsTimer != 0)
+			{
+				killTimer(m_ruleStatisticsTimer);
+
+				m_ruleStatisticsTimer = 0;
+
+				if (m_hasRuleStatisticsChanges.loadAcquire() != 0)
+				{
+					saveRuleStatistics();
+				}
+			}
+
+			break;
+		case SettingsManager::ContentBlocking_IgnoreHostsOption:
+			clearResultsCache();
+
+			break;
+		case SettingsManager::ContentBlocking_MatchingEngineOption:
+			for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
+			{
+				m_contentBlockingProfiles.at(i)->clear();
+			}
+
+			clearResultsCache();
+			loadProfiles();
+
+			break;
+		case SettingsManager::ContentBlocking_MergeProfilesOption:
+			m_areProfilesMerged = value.toBool();
+
+			break;
+		case SettingsManager::ContentBlocking_PendingRequestsPolicyOption:
+			{
+				const QString policy(value.toString());
+
+				if (policy == QLatin1String("allow"))
+				{
+					m_pendingRequestsPolicy = AllowPendingRequestsPolicy;
+				}
+				else if (policy == QLatin1String("block"))
+				{
+					m_pendingRequestsPolicy = BlockPendingRequestsPolicy;
+				}
+				else
+				{
+					m_pendingRequestsPolicy = HoldPendingRequestsPolicy;
+				}
+			}
+
+			break;
+		case SettingsManager::ContentBlocking_ResultsCacheLimitOption:
+			{
+				QMutexLocker locker(&m_resultsCacheMutex);
+
+				m_resultsCache.setMaxCost(qMax(0, value.toInt()));
+			}
+
+			break;
+		default:
+			break;
 	}
 }
 
@@ -258,6 +405,18 @@ void ContentFiltersManager::save()
 			profileObject.insert(QLatin1String("lastUpdate"), lastUpdate.toString(Qt::ISODate));
 		}
 
+		const ContentFiltersProfile::ProfileSummary profileSummary(profile->getProfileSummary());
+
+		if (!profileSummary.updateEntityTag.isEmpty())
+		{
+			profileObject.insert(QLatin1String("updateEntityTag"), profileSummary.updateEntityTag);
+		}
+
+		if (!profileSummary.updateLastModified.isEmpty())
+		{
+			profileObject.insert(QLatin1String("updateLastModified"), profileSummary.updateLastModified);
+		}
+
 		if (profile->getFlags().testFlag(ContentFiltersProfile::HasCustomTitleFlag))
 		{
 			profileObject.insert(QLatin1String("title"), profile->getTitle());
@@ -289,6 +448,105 @@ void ContentFiltersManager::save()
 	settings.save();
 }
 
+void ContentFiltersManager::loadRuleStatistics()
+{
+	const QJsonObject mainObject(JsonSettings(SessionsManager::getWritableDataPath(QLatin1String("contentBlockingStatistics.json"))).object());
+	QJsonObject::const_iterator profilesIterator;
+
+	for (profilesIterator = mainObject.constBegin(); profilesIterator != mainObject.constEnd(); ++profilesIterator)
+	{
+		const QJsonObject profileObject(profilesIterator.value().toObject());
+		QJsonObject::const_iterator rulesIterator;
+
+		for (rulesIterator = profileObject.constBegin(); rulesIterator != profileObject.constEnd(); ++rulesIterator)
+		{
+			const QJsonArray statisticsArray(rulesIterator.value().toArray());
+			RuleStatisticsShard &shard(m_ruleStatisticsShards[qHash(rulesIterator.key()) % RuleStatisticsShardsAmount]);
+			RuleStatistics statistics;
+			statistics.hits = static_cast<quint64>(statisticsArray.at(0).toDouble());
+			statistics.lastHitTime = static_cast<qint64>(statisticsArray.at(1).toDouble());
+
+			QMutexLocker locker(&shard.mutex);
+
+			shard.profiles[profilesIterator.key()][rulesIterator.key()] = statistics;
+		}
+	}
+}
+
+void ContentFiltersManager::saveRuleStatistics()
+{
+	QHash<QString, QJsonObject> profileObjects;
+
+	m_hasRuleStatisticsChanges.storeRelease(0);
+
+	for (int i = 0; i < RuleStatisticsShardsAmount; ++i)
+	{
+		RuleStatisticsShard &shard(m_ruleStatisticsShards[i]);
+		QMutexLocker locker(&shard.mutex);
+		QHash<QString, QHash<QString, RuleStatistics> >::const_iterator profilesIterator;
+
+		for (profilesIterator = shard.profiles.constBegin(); profilesIterator != shard.profiles.constEnd(); ++profilesIterator)
+		{
+			QJsonObject &profileObject(profileObjects[profilesIterator.key()]);
+			QHash<QString, RuleStatistics>::const_iterator rulesIterator;
+
+			for (rulesIterator = profilesIterator.value().constBegin(); rulesIterator != profilesIterator.value().constEnd(); ++rulesIterator)
+			{
+				profileObject.insert(rulesIterator.key(), QJsonArray({static_cast<double>(rulesIterator.value().hits), static_cast<double>(rulesIterator.value().lastHitTime)}));
+			}
+		}
+	}
+
+	QJsonObject mainObject;
+	QHash<QString, QJsonObject>::const_iterator iterator;
+
+	for (iterator = profileObjects.constBegin(); iterator != profileObjects.constEnd(); ++iterator)
+	{
+		mainObject.insert(iterator.key(), iterator.value());
+	}
+
+	JsonSettings settings;
+	settings.setObject(mainObject);
+	settings.save(SessionsManager::getWritableDataPath(QLatin1String("contentBlockingStatistics.json")));
+}
+
+void ContentFiltersManager::addRuleHit(int profile, const QString &rule)
+{
+	if (!m_areRuleStatisticsEnabled || profile < 0 || rule.isEmpty())
+	{
+		return;
+	}
+
+	QString name;
+
+	m_profilesLock.lockForRead();
+
+	if (profile < m_contentBlockingProfiles.count())
+	{
+		name = m_contentBlockingProfiles.at(profile)->getName();
+	}
+
+	m_profilesLock.unlock();
+
+	if (name.isEmpty())
+	{
+		return;
+	}
+
+	RuleStatisticsShard &shard(m_ruleStatisticsShards[qHash(rule) % RuleStatisticsShardsAmount]);
+
+	{
+		QMutexLocker locker(&shard.mutex);
+		RuleStatistics &statistics(shard.profiles[name][rule]);
+
+		++statistics.hits;
+
+		statistics.lastHitTime = (QDateTime::currentMSecsSinceEpoch() / 1000);
+	}
+
+	m_hasRuleStatisticsChanges.storeRelease(1);
+}
+
 void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 {
 	if (!profile)
@@ -298,6 +556,8 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 
 	bool isReplacing(false);
 
+	m_profilesLock.lockForWrite();
+
 	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
 	{
 		if (m_contentBlockingProfiles.at(i)->getName() == profile->getName())
@@ -316,11 +576,22 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 		m_contentBlockingProfiles.append(profile);
 	}
 
+	m_profilesLock.unlock();
+
 	m_instance->scheduleSave();
 
 	emit m_instance->profileAdded(profile->getName());
 
+	clearResultsCache();
+
 	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::scheduleSave);
+	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::clearResultsCache);
+	connect(profile, &ContentFiltersProfile::profileLoaded, profile, [=]()
+	{
+		clearResultsCache();
+
+		emit m_instance->profileLoaded(profile->getName());
+	});
 }
 
 void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool removeFile)
@@ -352,13 +623,27 @@ void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool r
 	localSettings.setObject(localMainObject);
 	localSettings.save();
 
+	m_profilesLock.lockForWrite();
 	m_contentBlockingProfiles.removeAll(profile);
+	m_profilesLock.unlock();
+
+	clearResultsCache();
 
 	profile->deleteLater();
 
 	emit m_instance->profileRemoved(name);
 }
 
+void ContentFiltersManager::clearResultsCache()
+{
+	m_cosmeticFiltersCache.clear();
+	m_genericCosmeticFilters.clear();
+
+	QMutexLocker locker(&m_resultsCacheMutex);
+
+	m_resultsCache.clear();
+}
+
 ContentFiltersManager* ContentFiltersManager::getInstance()
 {
 	return m_instance;
@@ -414,28 +699,141 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 		return {};
 	}
 
-	CheckResult result;
-	result.isFraud = ((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
+	const bool isRequestFraud((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
+	QString cacheKey;
 
 	for (int i = 0; i < profiles.count(); ++i)
 	{
-		if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
+		cacheKey.append(QString::number(profiles.at(i)) + QLatin1Char(','));
+	}
+
+	cacheKey.append(QString::number(resourceType) + QLatin1Char('|') + baseUrl.host() + QLatin1Char('|') + requestUrl.toString());
+
+	{
+		QMutexLocker locker(&m_resultsCacheMutex);
+		const CheckResult *cachedResult(m_resultsCache.object(cacheKey));
+
+		if (cachedResult)
+		{
+			++m_resultsCacheHits;
+
+			CheckResult result(*cachedResult);
+			result.isFraud = isRequestFraud;
+
+			locker.unlock();
+
+			addRuleHit(result.profile, result.rule);
+
+			return result;
+		}
+
+		++m_resultsCacheMisses;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	const RequestContext context(baseUrl, requestUrl, resourceType);
+	CheckResult result;
+	bool isCacheable(true);
+
+	m_profilesLock.lockForRead();
+
+	bool isMerged(false);
+
+	if (m_areProfilesMerged && profiles.count() > 1)
+	{
+		QVector<AdblockContentFiltersProfile*> mergedProfiles;
+		mergedProfiles.reserve(profiles.count());
+
+		QVector<int> mergedIdentifiers;
+		mergedIdentifiers.reserve(profiles.count());
+
+		for (int i = 0; i < profiles.count(); ++i)
 		{
-			CheckResult currentResult(m_contentBlockingProfiles.at(profiles.at(i))->checkUrl(baseUrl, requestUrl, resourceType));
-			currentResult.profile = profiles.at(i);
-			currentResult.isFraud = result.isFraud;
+			if (profiles.at(i) < 0 || profiles.at(i) >= m_contentBlockingProfiles.count())
+			{
+				continue;
+			}
+
+			AdblockContentFiltersProfile *profile(qobject_cast<AdblockContentFiltersProfile*>(m_contentBlockingProfiles.at(profiles.at(i))));
 
-			if (currentResult.isBlocked)
+			if (!profile || !profile->isReady())
 			{
-				result = currentResult;
+				mergedProfiles.clear();
+
+				break;
 			}
-			else if (currentResult.isException)
+
+			mergedProfiles.append(profile);
+			mergedIdentifiers.append(profiles.at(i));
+		}
+
+		isMerged = AdblockContentFiltersProfile::checkUrlMerged(mergedProfiles, context, result);
+
+		if (isMerged)
+		{
+			result.profile = mergedIdentifiers.value(result.profile, -1);
+		}
+	}
+
+	if (!isMerged)
+	{
+		for (int i = 0; i < profiles.count(); ++i)
+		{
+			if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
 			{
-				return currentResult;
+				ContentFiltersProfile *profile(m_contentBlockingProfiles.at(profiles.at(i)));
+
+				if (m_pendingRequestsPolicy != HoldPendingRequestsPolicy && !profile->isReady())
+				{
+					QMetaObject::invokeMethod(profile, "load", Qt::QueuedConnection);
+
+					if (m_pendingRequestsPolicy == BlockPendingRequestsPolicy)
+					{
+						result.profile = profiles.at(i);
+						result.isBlocked = true;
+					}
+
+					isCacheable = false;
+
+					continue;
+				}
+
+				CheckResult currentResult(profile->checkUrl(context));
+				currentResult.profile = profiles.at(i);
+
+				if (currentResult.isBlocked)
+				{
+					result = currentResult;
+				}
+				else if (currentResult.isException)
+				{
+					result = currentResult;
+
+					break;
+				}
 			}
 		}
 	}
 
+	m_profilesLock.unlock();
+
+	{
+		QMutexLocker locker(&m_resultsCacheMutex);
+
+		m_resultsMatchingTime += static_cast<quint64>(timer.nsecsElapsed());
+
+		if (isCacheable && m_resultsCache.maxCost() > 0)
+		{
+			m_resultsCache.insert(cacheKey, new CheckResult(result));
+		}
+	}
+
+	result.isFraud = isRequestFraud;
+
+	addRuleHit(result.profile, result.rule);
+
 	return result;
 }
 
@@ -446,14 +844,65 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 		return {};
 	}
 
-	const CosmeticFiltersMode mode(checkUrl(profiles, requestUrl, requestUrl, NetworkManager::OtherType).comesticFiltersMode);
+	CosmeticFiltersMode mode(AllFilters);
+
+	if (requestUrl.scheme() == QLatin1String("http") || requestUrl.scheme() == QLatin1String("https"))
+	{
+		for (int i = 0; (i < profiles.count() && mode != NoFilters); ++i)
+		{
+			const int index(profiles.at(i));
+
+			if (index >= 0 && index < m_contentBlockingProfiles.count())
+			{
+				mode = qMin(mode, m_contentBlockingProfiles.at(index)->checkCosmeticFiltersMode(requestUrl));
+			}
+		}
+	}
 
 	if (mode == NoFilters)
 	{
 		return {};
 	}
 
+	QString profilesKey;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		profilesKey.append(QString::number(profiles.at(i)) + QLatin1Char(','));
+	}
+
+	const QString cacheKey(profilesKey + QString::number(mode) + QLatin1Char('|') + requestUrl.host());
+	const CosmeticFiltersResult *cachedResult(m_cosmeticFiltersCache.object(cacheKey));
+
+	if (cachedResult)
+	{
+		return *cachedResult;
+	}
+
 	CosmeticFiltersResult result;
+
+	if (mode == AllFilters)
+	{
+		if (!m_genericCosmeticFilters.contains(profilesKey))
+		{
+			QStringList rules;
+
+			for (int i = 0; i < profiles.count(); ++i)
+			{
+				const int index(profiles.at(i));
+
+				if (index >= 0 && index < m_contentBlockingProfiles.count())
+				{
+					rules.append(m_contentBlockingProfiles.at(index)->getCosmeticFilters({}, false).rules);
+				}
+			}
+
+			m_genericCosmeticFilters[profilesKey] = rules;
+		}
+
+		result.rules = m_genericCosmeticFilters.value(profilesKey);
+	}
+
 	const QStringList domains(createSubdomainList(requestUrl.host()));
 
 	for (int i = 0; i < profiles.count(); ++i)
@@ -462,13 +911,46 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 
 		if (index >= 0 && index < m_contentBlockingProfiles.count())
 		{
-			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, (mode == DomainOnlyFilters)));
+			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, true));
 
 			result.rules.append(profileResult.rules);
 			result.exceptions.append(profileResult.exceptions);
 		}
 	}
 
+	if (!result.exceptions.isEmpty())
+	{
+		const QSet<QString> exceptions(result.exceptions.toSet());
+		QStringList rules;
+		rules.reserve(result.rules.count());
+
+		for (int i = 0; i < result.rules.count(); ++i)
+		{
+			if (!exceptions.contains(result.rules.at(i)))
+			{
+				rules.append(result.rules.at(i));
+			}
+		}
+
+		result.rules = rules;
+	}
+
+	result.rulesSelector = result.rules.join(QLatin1Char(','));
+	result.exceptionsSelector = result.exceptions.join(QLatin1Char(','));
+
+	if (!result.rules.isEmpty())
+	{
+		const QLatin1String declaration("{display:none !important;}\n");
+
+		for (int i = 0; i < result.rules.count(); ++i)
+		{
+			result.styleSheet.append(result.rules.at(i));
+			result.styleSheet.append(declaration);
+		}
+	}
+
+	m_cosmeticFiltersCache.insert(cacheKey, new CosmeticFiltersResult(result));
+
 	return result;
 }
 
@@ -537,6 +1019,133 @@ QVector<int> ContentFiltersManager::getProfileIdentifiers(const QStringList &nam
 	return identifiers;
 }
 
+QHash<QString, ContentFiltersManager::RuleStatistics> ContentFiltersManager::getRuleStatistics(const QString &profile)
+{
+	QHash<QString, RuleStatistics> statistics;
+
+	for (int i = 0; i < RuleStatisticsShardsAmount; ++i)
+	{
+		RuleStatisticsShard &shard(m_ruleStatisticsShards[i]);
+		QMutexLocker locker(&shard.mutex);
+		const QHash<QString, QHash<QString, RuleStatistics> >::const_iterator iterator(shard.profiles.constFind(profile));
+
+		if (iterator != shard.profiles.constEnd())
+		{
+			statistics.unite(iterator.value());
+		}
+	}
+
+	return statistics;
+}
+
+ContentFiltersManager::ResultsCacheStatistics ContentFiltersManager::getResultsCacheStatistics()
+{
+	QMutexLocker locker(&m_resultsCacheMutex);
+	ResultsCacheStatistics statistics;
+	statistics.hits = m_resultsCacheHits;
+	statistics.misses = m_resultsCacheMisses;
+	statistics.matchingTime = (m_resultsMatchingTime / 1000);
+	statistics.amount = m_resultsCache.count();
+	statistics.limit = m_resultsCache.maxCost();
+
+	return statistics;
+}
+
+bool ContentFiltersManager::exportCompactedProfile(const QString &profile, const QString &path)
+{
+	const ContentFiltersProfile *contentFiltersProfile(getProfile(profile));
+
+	if (!contentFiltersProfile)
+	{
+		return false;
+	}
+
+	QFile sourceFile(contentFiltersProfile->getPath());
+
+	if (!sourceFile.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return false;
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		return false;
+	}
+
+	const QHash<QString, RuleStatistics> statistics(getRuleStatistics(profile));
+	const QStringList keptRules(SettingsManager::getOption(SettingsManager::ContentBlocking_RuleStatisticsKeptRulesOption).toStringList());
+	const qint64 threshold((QDateTime::currentMSecsSinceEpoch() / 1000) - (static_cast<qint64>(qMax(0, SettingsManager::getOption(SettingsManager::ContentBlocking_RuleStatisticsPeriodOption).toInt())) * 86400));
+	QTextStream sourceStream(&sourceFile);
+	sourceStream.setCodec("UTF-8");
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	bool isHeader(true);
+
+	while (!sourceStream.atEnd())
+	{
+		const QString line(sourceStream.readLine().trimmed());
+
+		if (line.isEmpty())
+		{
+			continue;
+		}
+
+		if (line.startsWith(QLatin1Char('[')) || line.startsWith(QLatin1Char('!')))
+		{
+			if (isHeader)
+			{
+				stream << line << QLatin1Char('\n');
+			}
+
+			continue;
+		}
+
+		isHeader = false;
+
+		if (line.contains(QLatin1String("##")) || line.contains(QLatin1String("#@#")) || keptRules.contains(line))
+		{
+			stream << line << QLatin1Char('\n');
+
+			continue;
+		}
+
+		const QHash<QString, RuleStatistics>::const_iterator iterator(statistics.constFind(line));
+
+		if (iterator != statistics.constEnd() && iterator.value().lastHitTime >= threshold)
+		{
+			stream << line << QLatin1Char('\n');
+		}
+	}
+
+	stream.flush();
+
+	return file.commit();
+}
+
+bool ContentFiltersManager::areRuleStatisticsEnabled()
+{
+	return m_areRuleStatisticsEnabled;
+}
+
+bool ContentFiltersManager::isReady(const QVector<int> &profiles)
+{
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		const ContentFiltersProfile *profile(getProfile(profiles.at(i)));
+
+		if (profile && !profile->isReady())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool ContentFiltersManager::isFraud(const QUrl &url)
 {
 	for (int i = 0; i < m_fraudCheckingProfiles.count(); ++i)
@@ -550,6 +1159,45 @@ bool ContentFiltersManager::isFraud(const QUrl &url)
 	return false;
 }
 
+ContentFiltersManager::RequestContext::RequestContext(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()),
+	requestHost(requestUrlValue.host()),
+	requestUrl(requestUrlValue.toString()),
+	resourceType(resourceTypeValue)
+{
+	if (requestUrl.startsWith(QLatin1String("//")))
+	{
+		requestUrl = requestUrl.mid(2);
+	}
+
+	preprocessedRequestUrl = PreprocessedUrl(requestUrl);
+	requestSubdomains = createSubdomainList(requestHost);
+	requestSubdomainsHashes.reserve(requestSubdomains.count());
+
+	for (int i = 0; i < requestSubdomains.count(); ++i)
+	{
+		requestSubdomainsHashes.append(qHash(QStringRef(&requestSubdomains.at(i))));
+	}
+
+	baseHostHash = qHash(baseHost);
+	requestHostHash = qHash(requestHost);
+	isThirdParty = (!baseHost.isEmpty() && !PublicSuffixList::isSameSite(baseHost, requestHost));
+}
+
+bool ContentFiltersManager::RequestContext::hasRequestSubdomain(const QStringRef &domain) const
+{
+	const uint hash(qHash(domain));
+
+	for (int i = 0; i < requestSubdomainsHashes.count(); ++i)
+	{
+		if (requestSubdomainsHashes.at(i) == hash && requestSubdomains.at(i) == domain)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 ContentFiltersProfile::ContentFiltersProfile(QObject *parent) : QObject(parent)
 {
 }
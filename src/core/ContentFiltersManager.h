@@ -22,7 +22,12 @@
 #define OTTER_CONTENTFILTERSMANAGER_H
 
 #include "NetworkManager.h"
+#include "PreprocessedUrl.h"
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -42,6 +47,13 @@ public:
 		AllFilters
 	};
 
+	enum PendingRequestsPolicy
+	{
+		AllowPendingRequestsPolicy = 0,
+		HoldPendingRequestsPolicy,
+		BlockPendingRequestsPolicy
+	};
+
 	struct CheckResult final
 	{
 		QString rule;
@@ -52,16 +64,53 @@ public:
 		bool isFraud = false;
 	};
 
+	struct RequestContext final
+	{
+		QString baseHost;
+		QString requestHost;
+		QString requestUrl;
+		PreprocessedUrl preprocessedRequestUrl;
+		QStringList requestSubdomains;
+		QVector<uint> requestSubdomainsHashes;
+		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+		uint baseHostHash = 0;
+		uint requestHostHash = 0;
+		bool isThirdParty = false;
+
+		explicit RequestContext(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue);
+
+		bool hasRequestSubdomain(const QStringRef &domain) const;
+	};
+
 	struct CosmeticFiltersResult final
 	{
 		QStringList rules;
 		QStringList exceptions;
+		QString rulesSelector;
+		QString exceptionsSelector;
+		QString styleSheet;
+	};
+
+	struct RuleStatistics final
+	{
+		quint64 hits = 0;
+		qint64 lastHitTime = 0;
+	};
+
+	struct ResultsCacheStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+		quint64 matchingTime = 0;
+		int amount = 0;
+		int limit = 0;
 	};
 
 	static void createInstance();
 	static void initialize();
 	static void addProfile(ContentFiltersProfile *profile);
 	static void removeProfile(ContentFiltersProfile *profile, bool removeFile = false);
+	static void clearResultsCache();
 	static ContentFiltersManager* getInstance();
 	static ContentFiltersProfile* getProfile(const QString &profile);
 	static ContentFiltersProfile* getProfile(const QUrl &url);
@@ -73,26 +122,62 @@ public:
 	static QVector<ContentFiltersProfile*> getContentBlockingProfiles();
 	static QVector<ContentFiltersProfile*> getFraudCheckingProfiles();
 	static QVector<int> getProfileIdentifiers(const QStringList &names);
+	static QHash<QString, RuleStatistics> getRuleStatistics(const QString &profile);
+	static ResultsCacheStatistics getResultsCacheStatistics();
+	static bool exportCompactedProfile(const QString &profile, const QString &path);
+	static bool areRuleStatisticsEnabled();
 	static bool isFraud(const QUrl &url);
+	static bool isReady(const QVector<int> &profiles);
 
 protected:
+	enum RuleStatisticsParameter
+	{
+		RuleStatisticsShardsAmount = 8,
+		RuleStatisticsSaveInterval = 300000
+	};
+
+	struct RuleStatisticsShard final
+	{
+		QMutex mutex;
+		QHash<QString, QHash<QString, RuleStatistics> > profiles;
+	};
+
 	explicit ContentFiltersManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	void save();
+	static void loadProfiles();
+	static void loadRuleStatistics();
+	static void saveRuleStatistics();
+	static void addRuleHit(int profile, const QString &rule);
 
 protected slots:
 	void scheduleSave();
+	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
-	int m_saveTimer;
+	int m_ruleStatisticsTimer;
 
 	static ContentFiltersManager *m_instance;
 	static QVector<ContentFiltersProfile*> m_contentBlockingProfiles;
 	static QVector<ContentFiltersProfile*> m_fraudCheckingProfiles;
+	static QCache<QString, CheckResult> m_resultsCache;
+	static QCache<QString, CosmeticFiltersResult> m_cosmeticFiltersCache;
+	static QHash<QString, QStringList> m_genericCosmeticFilters;
+	static QMutex m_resultsCacheMutex;
+	static QReadWriteLock m_profilesLock;
+	static RuleStatisticsShard m_ruleStatisticsShards[RuleStatisticsShardsAmount];
+	static QAtomicInt m_hasRuleStatisticsChanges;
+	static PendingRequestsPolicy m_pendingRequestsPolicy;
+	static bool m_areProfilesMerged;
+	static bool m_areRuleStatisticsEnabled;
+	static quint64 m_resultsCacheHits;
+	static quint64 m_resultsCacheMisses;
+	static quint64 m_resultsMatchingTime;
 
 signals:
 	void profileAdded(const QString &profile);
+	void profileLoaded(const QString &profile);
 	void profileModified(const QString &profile);
 	void profileRemoved(const QString &profile);
 };
@@ -132,6 +217,8 @@ public:
 	{
 		QString name;
 		QString title;
+		QString updateEntityTag;
+		QString updateLastModified;
 		QDateTime lastUpdate;
 		QUrl updateUrl;
 		ProfileCategory category = OtherCategory;
@@ -143,6 +230,7 @@ public:
 	explicit ContentFiltersProfile(QObject *parent = nullptr);
 
 	virtual void clear() = 0;
+	Q_INVOKABLE virtual void load() = 0;
 	virtual void setProfileSummary(const ProfileSummary &profileSummary) = 0;
 	virtual QString getName() const = 0;
 	virtual QString getTitle() const = 0;
@@ -150,22 +238,26 @@ public:
 	virtual QUrl getUpdateUrl() const = 0;
 	virtual QDateTime getLastUpdate() const = 0;
 	virtual ProfileSummary getProfileSummary() const = 0;
-	virtual ContentFiltersManager::CheckResult checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType) = 0;
+	virtual ContentFiltersManager::CheckResult checkUrl(const ContentFiltersManager::RequestContext &context) = 0;
+	virtual ContentFiltersManager::CosmeticFiltersMode checkCosmeticFiltersMode(const QUrl &url) = 0;
 	virtual ContentFiltersManager::CosmeticFiltersResult getCosmeticFilters(const QStringList &domains, bool isDomainOnly) = 0;
 	virtual QVector<QLocale::Language> getLanguages() const = 0;
 	virtual ProfileCategory getCategory() const = 0;
 	virtual ContentFiltersManager::CosmeticFiltersMode getCosmeticFiltersMode() const = 0;
 	virtual ProfileError getError() const = 0;
 	virtual ProfileFlags getFlags() const = 0;
+	virtual quint64 getMemoryUsage() const = 0;
 	virtual int getUpdateInterval() const = 0;
 	virtual int getUpdateProgress() const = 0;
 	virtual bool update(const QUrl &url = {}) = 0;
 	virtual bool remove() = 0;
 	virtual bool areWildcardsEnabled() const = 0;
 	virtual bool isUpdating() const = 0;
+	virtual bool isReady() const = 0;
 	virtual bool isFraud(const QUrl &url) = 0;
 
 signals:
+	void profileLoaded();
 	void profileModified();
 	void updateProgressChanged(int progress);
 };
@@ -18,14 +18,21 @@
 **************************************************************************/
 
 #include "CookieJar.h"
-#include "Application.h"
+#include "Console.h"
+#include "PersistenceManager.h"
+#include "PublicSuffixList.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
 #include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSaveFile>
-#include <QtCore/QTimerEvent>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 namespace Otter
 {
@@ -35,65 +42,76 @@ CookieJar::CookieJar(const QString &path, QObject *parent) : QNetworkCookieJar(p
 	m_generalCookiesPolicy(AcceptAllCookies),
 	m_thirdPartyCookiesPolicy(AcceptAllCookies),
 	m_keepMode(KeepUntilExpiresMode),
-	m_saveTimer(0)
+	m_journalRecordsAmount(0),
+	m_isSaving(false),
+	m_needsCompaction(false)
 {
 	if (path.isEmpty())
 	{
 		return;
 	}
 
+	m_journalPath = QFileInfo(path).absoluteDir().filePath(QFileInfo(path).completeBaseName() + QLatin1String(".journal"));
+
+	QList<QNetworkCookie> allCookies;
 	QFile file(path);
 
-	if (!file.open(QIODevice::ReadOnly))
+	if (file.open(QIODevice::ReadOnly))
 	{
-		return;
-	}
+		QDataStream stream(&file);
+		quint32 amount(0);
 
-	QDataStream stream(&file);
-	quint32 amount;
+		stream >> amount;
 
-	stream >> amount;
+		allCookies.reserve(static_cast<int>(amount));
 
-	QList<QNetworkCookie> allCookies;
-	allCookies.reserve(static_cast<int>(amount));
+		for (quint32 i = 0; i < amount; ++i)
+		{
+			if (stream.atEnd())
+			{
+				break;
+			}
 
-	for (quint32 i = 0; i < amount; ++i)
-	{
-		QByteArray value;
+			QByteArray value;
 
-		stream >> value;
+			stream >> value;
 
-		const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
+			const QList<QNetworkCookie> cookies(QNetworkCookie::parseCookies(value));
 
-		for (int j = 0; j < cookies.count(); ++j)
-		{
-			allCookies.append(cookies.at(j));
+			for (int j = 0; j < cookies.count(); ++j)
+			{
+				allCookies.append(cookies.at(j));
+			}
 		}
 
-		if (stream.atEnd())
-		{
-			break;
-		}
+		file.close();
 	}
 
+	loadJournal(allCookies);
 	handleOptionChanged(SettingsManager::Network_CookiesPolicyOption, SettingsManager::getOption(SettingsManager::Network_CookiesPolicyOption));
 	setAllCookies(allCookies);
+	rebuildIndex();
+
+	PersistenceManager::registerTarget(this, [&](bool isBlocking)
+	{
+		removeExpiredCookies();
+
+		return flushJournal(isBlocking);
+	});
 
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &CookieJar::handleOptionChanged);
 }
 
-void CookieJar::timerEvent(QTimerEvent *event)
+CookieJar::~CookieJar()
 {
-	if (event->timerId() != m_saveTimer)
+	if (m_needsCompaction || !m_journalBuffer.isEmpty())
 	{
-		return;
+		flushJournal(true);
+	}
+	else
+	{
+		m_savingFuture.waitForFinished();
 	}
-
-	killTimer(m_saveTimer);
-
-	m_saveTimer = 0;
-
-	save();
 }
 
 void CookieJar::clearCookies(int period)
@@ -104,6 +122,11 @@ void CookieJar::clearCookies(int period)
 
 	setAllCookies({});
 
+	m_domainCookies.clear();
+	m_expirationEntries.clear();
+
+	m_needsCompaction = true;
+
 	for (int i = 0; i < cookies.count(); ++i)
 	{
 		emit cookieRemoved(cookies.at(i));
@@ -116,22 +139,170 @@ void CookieJar::scheduleSave()
 {
 	if (!m_path.isEmpty())
 	{
-		if (Application::isAboutToQuit())
+		PersistenceManager::markAsDirty(this);
+	}
+}
+
+void CookieJar::appendJournalRecord(JournalRecordType type, const QNetworkCookie &cookie)
+{
+	if (m_path.isEmpty() || m_needsCompaction)
+	{
+		return;
+	}
+
+	QDataStream stream(&m_journalBuffer, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint8>(type) << cookie.toRawForm();
+
+	++m_journalRecordsAmount;
+}
+
+void CookieJar::loadJournal(QList<QNetworkCookie> &cookies)
+{
+	QFile file(m_journalPath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+
+	stream >> magicNumber >> formatVersion;
+
+	m_needsCompaction = true;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != JournalMagicNumber || formatVersion != JournalFormatVersion)
+	{
+		Console::addMessage(tr("Failed to load cookies journal: unsupported format"), Console::NetworkCategory, Console::ErrorLevel, m_journalPath);
+
+		return;
+	}
+
+	while (!stream.atEnd())
+	{
+		quint8 type(UnknownRecord);
+		QByteArray value;
+
+		stream >> type >> value;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		if (type != InsertRecord && type != DeleteRecord)
 		{
-			if (m_saveTimer != 0)
+			stream.setStatus(QDataStream::ReadCorruptData);
+
+			break;
+		}
+
+		const QList<QNetworkCookie> recordCookies(QNetworkCookie::parseCookies(value));
+
+		for (int i = 0; i < recordCookies.count(); ++i)
+		{
+			const QNetworkCookie &cookie(recordCookies.at(i));
+
+			for (int j = 0; j < cookies.count(); ++j)
 			{
-				killTimer(m_saveTimer);
+				if (cookies.at(j).hasSameIdentifier(cookie))
+				{
+					cookies.removeAt(j);
 
-				m_saveTimer = 0;
+					break;
+				}
 			}
 
-			save();
+			if (type == InsertRecord)
+			{
+				cookies.append(cookie);
+			}
 		}
-		else if (m_saveTimer == 0)
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		Console::addMessage(tr("Cookies journal is damaged, trailing records were discarded"), Console::NetworkCategory, Console::WarningLevel, m_journalPath);
+	}
+}
+
+void CookieJar::addIndexedCookie(const QNetworkCookie &cookie)
+{
+	m_domainCookies[getDomainKey(cookie.domain())].append(cookie);
+
+	if (cookie.isSessionCookie())
+	{
+		return;
+	}
+
+	ExpirationEntry entry;
+	entry.cookie = cookie;
+	entry.expirationTime = cookie.expirationDate().toMSecsSinceEpoch();
+
+	m_expirationEntries.append(entry);
+
+	std::push_heap(m_expirationEntries.begin(), m_expirationEntries.end(), isExpirationEntryLater);
+}
+
+void CookieJar::rebuildIndex()
+{
+	const QList<QNetworkCookie> cookies(allCookies());
+
+	m_domainCookies.clear();
+	m_expirationEntries.clear();
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		addIndexedCookie(cookies.at(i));
+	}
+}
+
+void CookieJar::removeExpiredCookies()
+{
+	const qint64 currentTime(QDateTime::currentDateTimeUtc().toMSecsSinceEpoch());
+	bool hasRemovedCookies(false);
+
+	while (!m_expirationEntries.isEmpty() && m_expirationEntries.first().expirationTime < currentTime)
+	{
+		std::pop_heap(m_expirationEntries.begin(), m_expirationEntries.end(), isExpirationEntryLater);
+
+		const ExpirationEntry entry(m_expirationEntries.takeLast());
+		const QVector<QNetworkCookie> cookies(m_domainCookies.value(getDomainKey(entry.cookie.domain())));
+
+		for (int i = 0; i < cookies.count(); ++i)
 		{
-			m_saveTimer = startTimer(500);
+			const QNetworkCookie &cookie(cookies.at(i));
+
+			if (cookie.hasSameIdentifier(entry.cookie) && !cookie.isSessionCookie() && cookie.expirationDate().toMSecsSinceEpoch() == entry.expirationTime)
+			{
+				QNetworkCookieJar::deleteCookie(cookie);
+
+				takeIndexedCookie(cookie);
+				appendJournalRecord(DeleteRecord, cookie);
+
+				hasRemovedCookies = true;
+
+				emit cookieRemoved(cookie);
+
+				break;
+			}
 		}
 	}
+
+	if (m_expirationEntries.count() > (allCookies().count() * 2) + 1000)
+	{
+		rebuildIndex();
+	}
+
+	if (hasRemovedCookies)
+	{
+		scheduleSave();
+	}
 }
 
 void CookieJar::handleOptionChanged(int identifier, const QVariant &value)
@@ -169,38 +340,62 @@ void CookieJar::handleOptionChanged(int identifier, const QVariant &value)
 	}
 }
 
-void CookieJar::save()
+QString CookieJar::getPath() const
+{
+	return m_path;
+}
+
+QStringList CookieJar::getDomains() const
 {
-	if (m_path.isEmpty() || SessionsManager::isReadOnly())
+	QStringList domains;
+	domains.reserve(m_domainCookies.count());
+
+	QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator;
+
+	for (iterator = m_domainCookies.constBegin(); iterator != m_domainCookies.constEnd(); ++iterator)
 	{
-		return;
+		if (!iterator.value().isEmpty())
+		{
+			domains.append(iterator.key());
+		}
 	}
 
-	QSaveFile file(m_path);
+	return domains;
+}
 
-	if (!file.open(QIODevice::WriteOnly))
+QString CookieJar::getDomainKey(const QString &domain)
+{
+	return (domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain).toLower();
+}
+
+QNetworkCookie CookieJar::takeIndexedCookie(const QNetworkCookie &cookie)
+{
+	QHash<QString, QVector<QNetworkCookie> >::iterator iterator(m_domainCookies.find(getDomainKey(cookie.domain())));
+
+	if (iterator == m_domainCookies.end())
 	{
-		return;
+		return {};
 	}
 
-	const QList<QNetworkCookie> cookies(allCookies());
-	QDataStream stream(&file);
-	stream << static_cast<quint32>(cookies.count());
+	QVector<QNetworkCookie> &cookies(iterator.value());
+	QNetworkCookie indexedCookie;
 
 	for (int i = 0; i < cookies.count(); ++i)
 	{
-		if (!cookies.at(i).isSessionCookie())
+		if (cookies.at(i).hasSameIdentifier(cookie))
 		{
-			stream << cookies.at(i).toRawForm();
+			indexedCookie = cookies.takeAt(i);
+
+			break;
 		}
 	}
 
-	file.commit();
-}
+	if (cookies.isEmpty())
+	{
+		m_domainCookies.erase(iterator);
+	}
 
-QString CookieJar::getPath() const
-{
-	return m_path;
+	return indexedCookie;
 }
 
 QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
@@ -215,22 +410,79 @@ QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
 
 QList<QNetworkCookie> CookieJar::getCookiesForUrl(const QUrl &url) const
 {
-	return QNetworkCookieJar::cookiesForUrl(url);
+	const QString host(url.host());
+	const QString path(url.path());
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const bool isEncrypted(url.scheme() == QLatin1String("https"));
+	QList<QNetworkCookie> cookies;
+	QString domain(host.toLower());
+
+	while (!domain.isEmpty())
+	{
+		const QHash<QString, QVector<QNetworkCookie> >::const_iterator iterator(m_domainCookies.constFind(domain));
+
+		if (iterator != m_domainCookies.constEnd())
+		{
+			const QVector<QNetworkCookie> &domainCookies(iterator.value());
+
+			for (int i = 0; i < domainCookies.count(); ++i)
+			{
+				const QNetworkCookie &cookie(domainCookies.at(i));
+
+				if ((!cookie.domain().startsWith(QLatin1Char('.')) && cookie.domain() != host) || !isParentPath(path, cookie.path()) || (!cookie.isSessionCookie() && cookie.expirationDate() < currentDateTime) || (cookie.isSecure() && !isEncrypted))
+				{
+					continue;
+				}
+
+				cookies.append(cookie);
+			}
+		}
+
+		const int position(domain.indexOf(QLatin1Char('.')));
+
+		if (position < 0)
+		{
+			break;
+		}
+
+		domain = domain.mid(position + 1);
+	}
+
+	std::stable_sort(cookies.begin(), cookies.end(), [](const QNetworkCookie &first, const QNetworkCookie &second)
+	{
+		return (first.path().length() > second.path().length());
+	});
+
+	return cookies;
 }
 
 QVector<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 {
 	if (!domain.isEmpty())
 	{
-		const QList<QNetworkCookie> cookies(allCookies());
 		QVector<QNetworkCookie> domainCookies;
+		QString key(getDomainKey(domain));
 
-		for (int i = 0; i < cookies.count(); ++i)
+		while (!key.isEmpty())
 		{
-			if (cookies.at(i).domain() == domain || (cookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(cookies.at(i).domain())))
+			const QVector<QNetworkCookie> cookies(m_domainCookies.value(key));
+
+			for (int i = 0; i < cookies.count(); ++i)
+			{
+				if (cookies.at(i).domain() == domain || (cookies.at(i).domain().startsWith(QLatin1Char('.')) && domain.endsWith(cookies.at(i).domain())))
+				{
+					domainCookies.append(cookies.at(i));
+				}
+			}
+
+			const int position(key.indexOf(QLatin1Char('.')));
+
+			if (position < 0)
 			{
-				domainCookies.append(cookies.at(i));
+				break;
 			}
+
+			key = key.mid(position + 1);
 		}
 
 		return domainCookies;
@@ -239,6 +491,11 @@ QVector<QNetworkCookie> CookieJar::getCookies(const QString &domain) const
 	return allCookies().toVector();
 }
 
+QVector<QNetworkCookie> CookieJar::getDomainCookies(const QString &domain) const
+{
+	return m_domainCookies.value(getDomainKey(domain));
+}
+
 bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 {
 	if (m_generalCookiesPolicy != AcceptAllCookies)
@@ -246,10 +503,19 @@ bool CookieJar::insertCookie(const QNetworkCookie &cookie)
 		return false;
 	}
 
+	removeExpiredCookies();
+
 	const bool result(QNetworkCookieJar::insertCookie(cookie));
 
 	if (result)
 	{
+		addIndexedCookie(cookie);
+
+		if (!cookie.isSessionCookie())
+		{
+			appendJournalRecord(InsertRecord, cookie);
+		}
+
 		scheduleSave();
 
 		emit cookieAdded(cookie);
@@ -286,6 +552,11 @@ bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 
 	if (result)
 	{
+		if (!takeIndexedCookie(cookie).isSessionCookie())
+		{
+			appendJournalRecord(DeleteRecord, cookie);
+		}
+
 		scheduleSave();
 
 		emit cookieRemoved(cookie);
@@ -296,10 +567,19 @@ bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
 
 bool CookieJar::forceInsertCookie(const QNetworkCookie &cookie)
 {
+	removeExpiredCookies();
+
 	const bool result(QNetworkCookieJar::insertCookie(cookie));
 
 	if (result)
 	{
+		addIndexedCookie(cookie);
+
+		if (!cookie.isSessionCookie())
+		{
+			appendJournalRecord(InsertRecord, cookie);
+		}
+
 		scheduleSave();
 
 		emit cookieAdded(cookie);
@@ -326,6 +606,11 @@ bool CookieJar::forceDeleteCookie(const QNetworkCookie &cookie)
 
 	if (result)
 	{
+		if (!takeIndexedCookie(cookie).isSessionCookie())
+		{
+			appendJournalRecord(DeleteRecord, cookie);
+		}
+
 		scheduleSave();
 
 		emit cookieRemoved(cookie);
@@ -354,23 +639,178 @@ bool CookieJar::hasCookie(const QNetworkCookie &cookie) const
 	return false;
 }
 
-bool CookieJar::isDomainTheSame(const QUrl &first, const QUrl &second)
+bool CookieJar::isParentPath(const QString &path, const QString &reference)
 {
-	const QString firstTld(first.topLevelDomain());
-	const QString secondTld(second.topLevelDomain());
+	if ((path.isEmpty() && reference == QLatin1String("/")) || path.startsWith(reference))
+	{
+		return (path.length() == reference.length() || reference.endsWith(QLatin1Char('/')) || path.at(reference.length()) == QLatin1Char('/'));
+	}
 
-	if (firstTld != secondTld)
+	return false;
+}
+
+bool CookieJar::isExpirationEntryLater(const ExpirationEntry &first, const ExpirationEntry &second)
+{
+	return (first.expirationTime > second.expirationTime);
+}
+
+bool CookieJar::writeJournal(const QString &path, const QByteArray &data)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
 	{
 		return false;
 	}
 
-	QString firstDomain(QLatin1Char('.') + first.host().toLower());
-	firstDomain.remove((firstDomain.length() - firstTld.length()), firstTld.length());
+	if (file.size() == 0)
+	{
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+		stream << static_cast<quint32>(JournalMagicNumber) << static_cast<quint32>(JournalFormatVersion);
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			return false;
+		}
+	}
+
+	return (file.write(data) == data.size() && file.flush());
+}
+
+bool CookieJar::writeFile(const QString &path, const QByteArray &data, const QString &journalPath)
+{
+	QSaveFile file(path);
 
-	QString secondDomain(QLatin1Char('.') + second.host().toLower());
-	secondDomain.remove((secondDomain.length() - secondTld.length()), secondTld.length());
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
 
-	return firstDomain.section(QLatin1Char('.'), -1) == secondDomain.section(QLatin1Char('.'), -1);
+	if (file.write(data) != data.size())
+	{
+		file.cancelWriting();
+
+		return false;
+	}
+
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	return (!QFile::exists(journalPath) || QFile::remove(journalPath));
+}
+
+bool CookieJar::flushJournal(bool isBlocking)
+{
+	if (m_path.isEmpty())
+	{
+		return true;
+	}
+
+	if (m_isSaving)
+	{
+		if (!isBlocking && m_savingFuture.isRunning())
+		{
+			return false;
+		}
+
+		m_savingFuture.waitForFinished();
+
+		m_isSaving = false;
+
+		if (!m_savingFuture.result())
+		{
+			Console::addMessage(tr("Failed to save cookies file"), Console::NetworkCategory, Console::ErrorLevel, m_path);
+
+			m_needsCompaction = true;
+		}
+	}
+
+	if (SessionsManager::isReadOnly())
+	{
+		m_journalBuffer.clear();
+
+		return true;
+	}
+
+	if (m_needsCompaction || m_journalRecordsAmount > 1000)
+	{
+		const QList<QNetworkCookie> cookies(allCookies());
+		QVector<QByteArray> values;
+		values.reserve(cookies.count());
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			if (!cookies.at(i).isSessionCookie())
+			{
+				values.append(cookies.at(i).toRawForm());
+			}
+		}
+
+		QByteArray data;
+		QDataStream stream(&data, QIODevice::WriteOnly);
+		stream << static_cast<quint32>(values.count());
+
+		for (int i = 0; i < values.count(); ++i)
+		{
+			stream << values.at(i);
+		}
+
+		m_journalBuffer.clear();
+
+		m_journalRecordsAmount = 0;
+		m_needsCompaction = false;
+
+		if (isBlocking)
+		{
+			if (!writeFile(m_path, data, m_journalPath))
+			{
+				Console::addMessage(tr("Failed to save cookies file"), Console::NetworkCategory, Console::ErrorLevel, m_path);
+
+				m_needsCompaction = true;
+			}
+
+			return true;
+		}
+
+		m_savingFuture = QtConcurrent::run(&CookieJar::writeFile, m_path, data, m_journalPath);
+		m_isSaving = true;
+
+		return true;
+	}
+
+	if (m_journalBuffer.isEmpty())
+	{
+		return true;
+	}
+
+	const QByteArray data(m_journalBuffer);
+
+	m_journalBuffer.clear();
+
+	if (isBlocking)
+	{
+		if (!writeJournal(m_journalPath, data))
+		{
+			Console::addMessage(tr("Failed to save cookies journal"), Console::NetworkCategory, Console::ErrorLevel, m_journalPath);
+
+			m_needsCompaction = true;
+		}
+
+		return true;
+	}
+
+	m_savingFuture = QtConcurrent::run(&CookieJar::writeJournal, m_journalPath, data);
+	m_isSaving = true;
+
+	return true;
+}
+
+bool CookieJar::isDomainTheSame(const QUrl &first, const QUrl &second)
+{
+	return PublicSuffixList::isSameSite(first.host(), second.host());
 }
 
 }
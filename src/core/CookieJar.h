@@ -20,6 +20,10 @@
 #ifndef OTTER_COOKIEJAR_H
 #define OTTER_COOKIEJAR_H
 
+#include <QtCore/QFuture>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkCookie>
 #include <QtNetwork/QNetworkCookieJar>
 
@@ -54,12 +58,15 @@ public:
 	};
 
 	explicit CookieJar(const QString &path, QObject *parent = nullptr);
+	~CookieJar();
 
 	void clearCookies(int period = 0);
 	QString getPath() const;
+	QStringList getDomains() const;
 	QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const override;
 	QList<QNetworkCookie> getCookiesForUrl(const QUrl &url) const;
 	QVector<QNetworkCookie> getCookies(const QString &domain = {}) const;
+	QVector<QNetworkCookie> getDomainCookies(const QString &domain) const;
 	bool insertCookie(const QNetworkCookie &cookie) override;
 	bool updateCookie(const QNetworkCookie &cookie) override;
 	bool deleteCookie(const QNetworkCookie &cookie) override;
@@ -70,19 +77,55 @@ public:
 	static bool isDomainTheSame(const QUrl &first, const QUrl &second);
 
 protected:
-	void timerEvent(QTimerEvent *event) override;
+	enum JournalFormat : quint32
+	{
+		JournalMagicNumber = 0x4F434A4A,
+		JournalFormatVersion = 1
+	};
+
+	enum JournalRecordType : quint8
+	{
+		UnknownRecord = 0,
+		InsertRecord,
+		DeleteRecord
+	};
+
+	struct ExpirationEntry final
+	{
+		QNetworkCookie cookie;
+		qint64 expirationTime = 0;
+	};
+
 	void scheduleSave();
-	void save();
+	void appendJournalRecord(JournalRecordType type, const QNetworkCookie &cookie);
+	void loadJournal(QList<QNetworkCookie> &cookies);
+	void addIndexedCookie(const QNetworkCookie &cookie);
+	void rebuildIndex();
+	void removeExpiredCookies();
+	static QString getDomainKey(const QString &domain);
+	QNetworkCookie takeIndexedCookie(const QNetworkCookie &cookie);
+	static bool isParentPath(const QString &path, const QString &reference);
+	static bool isExpirationEntryLater(const ExpirationEntry &first, const ExpirationEntry &second);
+	static bool writeJournal(const QString &path, const QByteArray &data);
+	static bool writeFile(const QString &path, const QByteArray &data, const QString &journalPath);
+	bool flushJournal(bool isBlocking = false);
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
 	QString m_path;
+	QString m_journalPath;
+	QByteArray m_journalBuffer;
+	QFuture<bool> m_savingFuture;
+	QHash<QString, QVector<QNetworkCookie> > m_domainCookies;
+	QVector<ExpirationEntry> m_expirationEntries;
 	CookiesPolicy m_generalCookiesPolicy;
 	CookiesPolicy m_thirdPartyCookiesPolicy;
 	KeepMode m_keepMode;
-	int m_saveTimer;
+	int m_journalRecordsAmount;
+	bool m_isSaving;
+	bool m_needsCompaction;
 
 signals:
 	void cookieAdded(QNetworkCookie cookie);
@@ -0,0 +1,252 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "EventLoopWatchdog.h"
+#include "Console.h"
+#include "SettingsManager.h"
+#include "Tracer.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+EventLoopWatchdog* EventLoopWatchdog::m_instance(nullptr);
+EventLoopWatchdog::StallsStatistics EventLoopWatchdog::m_statistics;
+
+EventLoopMonitor::EventLoopMonitor(int threshold, QObject *parent) : QThread(parent),
+	m_lastHeartbeat(0),
+	m_stallName(nullptr),
+	m_stallCategory(nullptr),
+	m_isStalled(false),
+	m_threshold(threshold),
+	m_isStopping(false)
+{
+	m_timer.start();
+}
+
+EventLoopMonitor::~EventLoopMonitor()
+{
+	stop();
+}
+
+void EventLoopMonitor::run()
+{
+	const unsigned long interval(static_cast<unsigned long>(qMax(1, (m_threshold / 5))));
+
+	while (true)
+	{
+		m_mutex.lock();
+
+		if (!m_isStopping)
+		{
+			m_stopCondition.wait(&m_mutex, interval);
+		}
+
+		if (m_isStopping)
+		{
+			m_mutex.unlock();
+
+			return;
+		}
+
+		m_mutex.unlock();
+
+		if ((m_timer.elapsed() - m_lastHeartbeat) < m_threshold || (m_isStalled && m_stallName))
+		{
+			continue;
+		}
+
+		const char *name(nullptr);
+		const char *category(nullptr);
+
+		Tracer::getActiveScope(&name, &category);
+
+		m_stallName = name;
+		m_stallCategory = category;
+		m_isStalled = true;
+	}
+}
+
+void EventLoopMonitor::notifyHeartbeat()
+{
+	m_lastHeartbeat = m_timer.elapsed();
+}
+
+void EventLoopMonitor::stop()
+{
+	m_mutex.lock();
+	m_isStopping = true;
+	m_stopCondition.wakeAll();
+	m_mutex.unlock();
+
+	wait();
+}
+
+bool EventLoopMonitor::takeStallScope(const char **name, const char **category)
+{
+	if (!m_isStalled.exchange(false))
+	{
+		return false;
+	}
+
+	*name = m_stallName.exchange(nullptr);
+	*category = m_stallCategory.exchange(nullptr);
+
+	return true;
+}
+
+qint64 EventLoopMonitor::getTimestamp() const
+{
+	return m_timer.elapsed();
+}
+
+EventLoopWatchdog::EventLoopWatchdog(QObject *parent) : QObject(parent),
+	m_monitor(nullptr),
+	m_lastHeartbeat(0),
+	m_heartbeatTimer(0)
+{
+	m_statistics.histogram.fill(0, (getHistogramBounds().count() + 1));
+
+	handleOptionChanged(SettingsManager::Browser_EnableEventLoopWatchdogOption, SettingsManager::getOption(SettingsManager::Browser_EnableEventLoopWatchdogOption));
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &EventLoopWatchdog::handleOptionChanged);
+}
+
+EventLoopWatchdog::~EventLoopWatchdog()
+{
+	setEnabled(false);
+}
+
+void EventLoopWatchdog::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new EventLoopWatchdog(QCoreApplication::instance());
+	}
+}
+
+void EventLoopWatchdog::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_heartbeatTimer || !m_monitor)
+	{
+		return;
+	}
+
+	const qint64 timestamp(m_monitor->getTimestamp());
+	const qint64 duration(timestamp - m_lastHeartbeat - HeartbeatInterval);
+	const char *name(nullptr);
+	const char *category(nullptr);
+	const bool hasScope(m_monitor->takeStallScope(&name, &category));
+
+	m_lastHeartbeat = timestamp;
+
+	m_monitor->notifyHeartbeat();
+
+	if (duration >= StallThreshold)
+	{
+		registerStall(duration, (hasScope ? name : nullptr), (hasScope ? category : nullptr));
+	}
+}
+
+void EventLoopWatchdog::registerStall(qint64 duration, const char *name, const char *category)
+{
+	const QVector<int> bounds(getHistogramBounds());
+	int bucket(0);
+
+	while (bucket < bounds.count() && duration >= bounds.at(bucket))
+	{
+		++bucket;
+	}
+
+	++m_statistics.histogram[bucket];
+	++m_statistics.amount;
+
+	m_statistics.longestDuration = qMax(m_statistics.longestDuration, duration);
+
+	if (name)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Event loop was blocked for %1 ms in %2 (%3)").arg(duration).arg(QString::fromLatin1(name), QString::fromLatin1(category ? category : "unknown")), Console::OtherCategory, Console::WarningLevel);
+	}
+	else
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Event loop was blocked for %1 ms outside of instrumented scopes").arg(duration), Console::OtherCategory, Console::WarningLevel);
+	}
+}
+
+void EventLoopWatchdog::setEnabled(bool isEnabled)
+{
+	if (isEnabled == (m_monitor != nullptr))
+	{
+		return;
+	}
+
+	Tracer::setScopesTrackingEnabled(isEnabled);
+
+	if (isEnabled)
+	{
+		m_monitor = new EventLoopMonitor(StallThreshold, this);
+		m_monitor->notifyHeartbeat();
+		m_monitor->start();
+
+		m_lastHeartbeat = m_monitor->getTimestamp();
+		m_heartbeatTimer = startTimer(HeartbeatInterval, Qt::PreciseTimer);
+	}
+	else
+	{
+		killTimer(m_heartbeatTimer);
+
+		m_heartbeatTimer = 0;
+
+		m_monitor->stop();
+		m_monitor->deleteLater();
+		m_monitor = nullptr;
+	}
+}
+
+void EventLoopWatchdog::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier == SettingsManager::Browser_EnableEventLoopWatchdogOption)
+	{
+		setEnabled(value.toBool());
+	}
+}
+
+EventLoopWatchdog* EventLoopWatchdog::getInstance()
+{
+	return m_instance;
+}
+
+QVector<int> EventLoopWatchdog::getHistogramBounds()
+{
+	return {500, 1000, 2500, 5000};
+}
+
+EventLoopWatchdog::StallsStatistics EventLoopWatchdog::getStallsStatistics()
+{
+	return m_statistics;
+}
+
+bool EventLoopWatchdog::isEnabled()
+{
+	return (m_instance && m_instance->m_monitor);
+}
+
+}
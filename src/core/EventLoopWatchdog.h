@@ -0,0 +1,106 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_EVENTLOOPWATCHDOG_H
+#define OTTER_EVENTLOOPWATCHDOG_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+
+namespace Otter
+{
+
+class EventLoopMonitor final : public QThread
+{
+public:
+	explicit EventLoopMonitor(int threshold, QObject *parent = nullptr);
+	~EventLoopMonitor();
+
+	void notifyHeartbeat();
+	void stop();
+	bool takeStallScope(const char **name, const char **category);
+	qint64 getTimestamp() const;
+
+protected:
+	void run() override;
+
+private:
+	QElapsedTimer m_timer;
+	QMutex m_mutex;
+	QWaitCondition m_stopCondition;
+	std::atomic<qint64> m_lastHeartbeat;
+	std::atomic<const char*> m_stallName;
+	std::atomic<const char*> m_stallCategory;
+	std::atomic<bool> m_isStalled;
+	int m_threshold;
+	bool m_isStopping;
+};
+
+class EventLoopWatchdog final : public QObject
+{
+	Q_OBJECT
+
+public:
+	struct StallsStatistics final
+	{
+		QVector<quint64> histogram;
+		quint64 amount = 0;
+		qint64 longestDuration = 0;
+	};
+
+	static void createInstance();
+	static EventLoopWatchdog* getInstance();
+	static QVector<int> getHistogramBounds();
+	static StallsStatistics getStallsStatistics();
+	static bool isEnabled();
+
+protected:
+	enum WatchdogParameter
+	{
+		HeartbeatInterval = 50,
+		StallThreshold = 250
+	};
+
+	explicit EventLoopWatchdog(QObject *parent = nullptr);
+	~EventLoopWatchdog();
+
+	void timerEvent(QTimerEvent *event) override;
+	void setEnabled(bool isEnabled);
+	void registerStall(qint64 duration, const char *name, const char *category);
+
+protected slots:
+	void handleOptionChanged(int identifier, const QVariant &value);
+
+private:
+	EventLoopMonitor *m_monitor;
+	qint64 m_lastHeartbeat;
+	int m_heartbeatTimer;
+
+	static EventLoopWatchdog *m_instance;
+	static StallsStatistics m_statistics;
+};
+
+}
+
+#endif
@@ -0,0 +1,581 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FaviconsManager.h"
+#include "Console.h"
+#include "PersistenceManager.h"
+#include "SessionsManager.h"
+#include "Utils.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+#include <QtGui/QPixmap>
+
+#include <limits>
+
+namespace Otter
+{
+
+FaviconsManager* FaviconsManager::m_instance(nullptr);
+
+FaviconsManager::FaviconsManager(QObject *parent) : QObject(parent),
+	m_file(nullptr),
+	m_mappedData(nullptr),
+	m_decodingWatcher(new QFutureWatcher<QVector<QPair<QByteArray, QImage> > >(this)),
+	m_decodedIcons(DecodedIconsLimit),
+	m_obsoleteRecordsAmount(0)
+{
+	connect(m_decodingWatcher, &QFutureWatcher<QVector<QPair<QByteArray, QImage> > >::finished, this, &FaviconsManager::handleIconsDecoded);
+
+	loadDatabase();
+}
+
+void FaviconsManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new FaviconsManager(QCoreApplication::instance());
+
+		PersistenceManager::registerTarget(m_instance, &FaviconsManager::save);
+	}
+}
+
+void FaviconsManager::loadDatabase()
+{
+	const QString path(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")));
+
+	if (!QFile::exists(path))
+	{
+		return;
+	}
+
+	m_file = new QFile(path, this);
+
+	if (!m_file->open(QIODevice::ReadOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to open favicons database: %1").arg(m_file->errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		closeDatabase();
+
+		return;
+	}
+
+	const qint64 size(m_file->size());
+
+	if (size < 8 || size > std::numeric_limits<int>::max())
+	{
+		closeDatabase();
+
+		QFile::remove(path);
+
+		return;
+	}
+
+	QByteArray data;
+
+	m_mappedData = m_file->map(0, size);
+
+	if (m_mappedData)
+	{
+		data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_mappedData), static_cast<int>(size));
+	}
+	else
+	{
+		data = m_file->readAll();
+
+		m_file->close();
+	}
+
+	const uchar *bytes(reinterpret_cast<const uchar*>(data.constData()));
+
+	if (qFromBigEndian<quint32>(bytes) != DatabaseMagicNumber || qFromBigEndian<quint32>(bytes + 4) != DatabaseFormatVersion)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Discarding favicons database with unsupported format"), Console::OtherCategory, Console::WarningLevel, path);
+
+		closeDatabase();
+
+		QFile::remove(path);
+
+		return;
+	}
+
+	const int hashLength(QCryptographicHash::hashLength(QCryptographicHash::Md5));
+	int position(8);
+	bool isTruncated(false);
+
+	while (position < data.size())
+	{
+		const int remaining(data.size() - position);
+		const RecordType type(static_cast<RecordType>(bytes[position]));
+
+		if (type == IconRecord)
+		{
+			if (remaining < (1 + hashLength + 4))
+			{
+				isTruncated = true;
+
+				break;
+			}
+
+			const QByteArray hash(data.constData() + position + 1, hashLength);
+			const int length(static_cast<int>(qFromBigEndian<quint32>(bytes + position + 1 + hashLength)));
+			const int offset(position + 1 + hashLength + 4);
+
+			if (length < 0 || length > (data.size() - offset))
+			{
+				isTruncated = true;
+
+				break;
+			}
+
+			if (m_icons.contains(hash))
+			{
+				++m_obsoleteRecordsAmount;
+			}
+			else if (m_mappedData)
+			{
+				m_icons[hash] = QByteArray::fromRawData(data.constData() + offset, length);
+			}
+			else
+			{
+				m_icons[hash] = QByteArray(data.constData() + offset, length);
+			}
+
+			position = (offset + length);
+		}
+		else if (type == HostRecord || type == PageRecord)
+		{
+			if (remaining < (1 + 2))
+			{
+				isTruncated = true;
+
+				break;
+			}
+
+			const int length(qFromBigEndian<quint16>(bytes + position + 1));
+			const int offset(position + 1 + 2);
+
+			if ((length + hashLength) > (data.size() - offset))
+			{
+				isTruncated = true;
+
+				break;
+			}
+
+			const QString key(QString::fromUtf8(data.constData() + offset, length));
+			const QByteArray hash(data.constData() + offset + length, hashLength);
+			QHash<QString, QByteArray> &keys((type == HostRecord) ? m_hosts : m_pages);
+
+			if (keys.contains(key))
+			{
+				++m_obsoleteRecordsAmount;
+			}
+
+			keys[key] = hash;
+
+			position = (offset + length + hashLength);
+		}
+		else
+		{
+			isTruncated = true;
+
+			break;
+		}
+	}
+
+	QSet<QByteArray> usedHashes;
+	QHash<QString, QByteArray>::const_iterator iterator;
+
+	for (iterator = m_hosts.constBegin(); iterator != m_hosts.constEnd(); ++iterator)
+	{
+		usedHashes.insert(iterator.value());
+	}
+
+	for (iterator = m_pages.constBegin(); iterator != m_pages.constEnd(); ++iterator)
+	{
+		usedHashes.insert(iterator.value());
+	}
+
+	m_obsoleteRecordsAmount += (m_icons.count() - usedHashes.count());
+
+	if (isTruncated || m_obsoleteRecordsAmount > (m_hosts.count() + m_pages.count()))
+	{
+		compactDatabase();
+	}
+}
+
+void FaviconsManager::closeDatabase()
+{
+	m_decodingWatcher->waitForFinished();
+
+	if (!m_file)
+	{
+		return;
+	}
+
+	if (m_mappedData)
+	{
+		m_file->unmap(m_mappedData);
+
+		m_mappedData = nullptr;
+	}
+
+	m_file->close();
+	m_file->deleteLater();
+	m_file = nullptr;
+}
+
+void FaviconsManager::compactDatabase()
+{
+	QSet<QByteArray> usedHashes;
+	QHash<QString, QByteArray>::const_iterator keysIterator;
+
+	for (keysIterator = m_hosts.constBegin(); keysIterator != m_hosts.constEnd(); ++keysIterator)
+	{
+		usedHashes.insert(keysIterator.value());
+	}
+
+	for (keysIterator = m_pages.constBegin(); keysIterator != m_pages.constEnd(); ++keysIterator)
+	{
+		usedHashes.insert(keysIterator.value());
+	}
+
+	QHash<QByteArray, QByteArray> icons;
+	QHash<QByteArray, QByteArray>::const_iterator iconsIterator;
+
+	icons.reserve(usedHashes.count());
+
+	for (iconsIterator = m_icons.constBegin(); iconsIterator != m_icons.constEnd(); ++iconsIterator)
+	{
+		if (usedHashes.contains(iconsIterator.key()))
+		{
+			icons[iconsIterator.key()] = QByteArray(iconsIterator.value().constData(), iconsIterator.value().size());
+		}
+	}
+
+	m_icons = icons;
+
+	closeDatabase();
+
+	m_pendingRecords.clear();
+
+	for (iconsIterator = m_icons.constBegin(); iconsIterator != m_icons.constEnd(); ++iconsIterator)
+	{
+		appendIconRecord(iconsIterator.key(), iconsIterator.value());
+	}
+
+	for (keysIterator = m_hosts.constBegin(); keysIterator != m_hosts.constEnd(); ++keysIterator)
+	{
+		appendKeyRecord(HostRecord, keysIterator.key(), keysIterator.value());
+	}
+
+	for (keysIterator = m_pages.constBegin(); keysIterator != m_pages.constEnd(); ++keysIterator)
+	{
+		appendKeyRecord(PageRecord, keysIterator.key(), keysIterator.value());
+	}
+
+	QSaveFile file(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")));
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		m_pendingRecords.clear();
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream << static_cast<quint32>(DatabaseMagicNumber) << static_cast<quint32>(DatabaseFormatVersion);
+	stream.writeRawData(m_pendingRecords.constData(), m_pendingRecords.size());
+
+	if (stream.status() == QDataStream::Ok && file.commit())
+	{
+		m_obsoleteRecordsAmount = 0;
+	}
+	else
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to compact favicons database: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+	}
+
+	m_pendingRecords.clear();
+}
+
+void FaviconsManager::decodeIcons()
+{
+	if (m_decodingQueue.isEmpty() || m_decodingWatcher->isRunning())
+	{
+		return;
+	}
+
+	QVector<QPair<QByteArray, QByteArray> > blobs;
+	blobs.reserve(m_decodingQueue.count());
+
+	for (int i = 0; i < m_decodingQueue.count(); ++i)
+	{
+		blobs.append({m_decodingQueue.at(i), m_icons.value(m_decodingQueue.at(i))});
+	}
+
+	m_decodingQueue.clear();
+	m_decodingWatcher->setFuture(QtConcurrent::run(&FaviconsManager::decodeImages, blobs));
+}
+
+void FaviconsManager::appendIconRecord(const QByteArray &hash, const QByteArray &data)
+{
+	QDataStream stream(&m_pendingRecords, QIODevice::Append);
+	stream << static_cast<quint8>(IconRecord);
+	stream.writeRawData(hash.constData(), hash.size());
+	stream << static_cast<quint32>(data.size());
+	stream.writeRawData(data.constData(), data.size());
+}
+
+void FaviconsManager::appendKeyRecord(RecordType type, const QString &key, const QByteArray &hash)
+{
+	const QByteArray encodedKey(key.toUtf8().left(std::numeric_limits<quint16>::max()));
+	QDataStream stream(&m_pendingRecords, QIODevice::Append);
+	stream << static_cast<quint8>(type) << static_cast<quint16>(encodedKey.size());
+	stream.writeRawData(encodedKey.constData(), encodedKey.size());
+	stream.writeRawData(hash.constData(), hash.size());
+}
+
+void FaviconsManager::clearIcons()
+{
+	createInstance();
+
+	m_instance->closeDatabase();
+	m_instance->m_icons.clear();
+	m_instance->m_hosts.clear();
+	m_instance->m_pages.clear();
+	m_instance->m_decodedIcons.clear();
+	m_instance->m_decodingQueue.clear();
+	m_instance->m_pendingDecodes.clear();
+	m_instance->m_pendingRecords.clear();
+	m_instance->m_obsoleteRecordsAmount = 0;
+
+	QFile::remove(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")));
+
+	emit m_instance->iconsDecoded();
+}
+
+void FaviconsManager::handleIconsDecoded()
+{
+	const QVector<QPair<QByteArray, QImage> > images(m_decodingWatcher->result());
+
+	for (int i = 0; i < images.count(); ++i)
+	{
+		m_pendingDecodes.remove(images.at(i).first);
+		m_decodedIcons.insert(images.at(i).first, new QIcon(images.at(i).second.isNull() ? QIcon() : QIcon(QPixmap::fromImage(images.at(i).second))));
+	}
+
+	decodeIcons();
+
+	emit iconsDecoded();
+}
+
+void FaviconsManager::setIcon(const QUrl &url, const QIcon &icon)
+{
+	if (icon.isNull() || !url.isValid())
+	{
+		return;
+	}
+
+	const QByteArray data(encodeIcon(icon));
+
+	if (data.isEmpty())
+	{
+		return;
+	}
+
+	createInstance();
+
+	const QByteArray hash(QCryptographicHash::hash(data, QCryptographicHash::Md5));
+	const QString host(Utils::extractHost(url));
+	const QString pageKey(getPageKey(url));
+	const bool isRootPage(url.path().isEmpty() || url.path() == QLatin1String("/"));
+	bool isModified(false);
+
+	if (!m_instance->m_icons.contains(hash))
+	{
+		m_instance->m_icons[hash] = data;
+		m_instance->m_decodedIcons.insert(hash, new QIcon(icon));
+		m_instance->appendIconRecord(hash, data);
+
+		isModified = true;
+	}
+
+	if (!host.isEmpty() && (isRootPage || !m_instance->m_hosts.contains(host)))
+	{
+		if (m_instance->m_hosts.value(host) != hash)
+		{
+			m_instance->m_hosts[host] = hash;
+			m_instance->appendKeyRecord(HostRecord, host, hash);
+
+			isModified = true;
+		}
+	}
+	else if (m_instance->m_hosts.value(host) != hash || m_instance->m_pages.contains(pageKey))
+	{
+		if (m_instance->m_pages.value(pageKey) != hash)
+		{
+			m_instance->m_pages[pageKey] = hash;
+			m_instance->appendKeyRecord(PageRecord, pageKey, hash);
+
+			isModified = true;
+		}
+	}
+
+	if (isModified)
+	{
+		PersistenceManager::markAsDirty(m_instance);
+	}
+}
+
+FaviconsManager* FaviconsManager::getInstance()
+{
+	createInstance();
+
+	return m_instance;
+}
+
+QIcon FaviconsManager::getDecodedIcon(const QByteArray &hash)
+{
+	if (hash.isEmpty() || !m_instance->m_icons.contains(hash))
+	{
+		return {};
+	}
+
+	const QIcon *icon(m_instance->m_decodedIcons.object(hash));
+
+	if (icon)
+	{
+		return *icon;
+	}
+
+	if (!m_instance->m_pendingDecodes.contains(hash))
+	{
+		m_instance->m_pendingDecodes.insert(hash);
+		m_instance->m_decodingQueue.append(hash);
+
+		if (m_instance->m_decodingQueue.count() == 1)
+		{
+			QTimer::singleShot(0, m_instance, &FaviconsManager::decodeIcons);
+		}
+	}
+
+	return {};
+}
+
+QIcon FaviconsManager::getIcon(const QUrl &url)
+{
+	createInstance();
+
+	const QByteArray hash(m_instance->m_pages.value(getPageKey(url)));
+
+	return getDecodedIcon(hash.isEmpty() ? m_instance->m_hosts.value(Utils::extractHost(url)) : hash);
+}
+
+QIcon FaviconsManager::getIcon(const QString &host)
+{
+	createInstance();
+
+	return getDecodedIcon(m_instance->m_hosts.value(host));
+}
+
+QString FaviconsManager::getPageKey(const QUrl &url)
+{
+	return url.adjusted(QUrl::RemoveFragment).toString();
+}
+
+QVector<QPair<QByteArray, QImage> > FaviconsManager::decodeImages(const QVector<QPair<QByteArray, QByteArray> > &blobs)
+{
+	QVector<QPair<QByteArray, QImage> > images;
+	images.reserve(blobs.count());
+
+	for (int i = 0; i < blobs.count(); ++i)
+	{
+		images.append({blobs.at(i).first, QImage::fromData(blobs.at(i).second, "PNG")});
+	}
+
+	return images;
+}
+
+QByteArray FaviconsManager::encodeIcon(const QIcon &icon)
+{
+	const QPixmap pixmap(icon.pixmap(icon.actualSize(QSize(IconSize, IconSize))));
+
+	if (pixmap.isNull())
+	{
+		return {};
+	}
+
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+
+	if (!pixmap.save(&buffer, "PNG"))
+	{
+		return {};
+	}
+
+	return data;
+}
+
+bool FaviconsManager::save(bool isBlocking)
+{
+	Q_UNUSED(isBlocking)
+
+	if (!m_instance || m_instance->m_pendingRecords.isEmpty())
+	{
+		return true;
+	}
+
+	QFile file(SessionsManager::getWritableDataPath(QLatin1String("favicons.dat")));
+
+	if (!file.open(QIODevice::Append))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save favicons database: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+		return false;
+	}
+
+	QDataStream stream(&file);
+
+	if (file.size() == 0)
+	{
+		stream << static_cast<quint32>(DatabaseMagicNumber) << static_cast<quint32>(DatabaseFormatVersion);
+	}
+
+	stream.writeRawData(m_instance->m_pendingRecords.constData(), m_instance->m_pendingRecords.size());
+
+	if (stream.status() != QDataStream::Ok || !file.flush())
+	{
+		return false;
+	}
+
+	m_instance->m_pendingRecords.clear();
+
+	return true;
+}
+
+}
@@ -0,0 +1,105 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FAVICONSMANAGER_H
+#define OTTER_FAVICONSMANAGER_H
+
+#include <QtCore/QCache>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <QtGui/QIcon>
+#include <QtGui/QImage>
+
+class QFile;
+
+namespace Otter
+{
+
+class FaviconsManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static void clearIcons();
+	static void setIcon(const QUrl &url, const QIcon &icon);
+	static FaviconsManager* getInstance();
+	static QIcon getIcon(const QUrl &url);
+	static QIcon getIcon(const QString &host);
+
+protected:
+	enum DatabaseFormat : quint32
+	{
+		DatabaseMagicNumber = 0x4F464156,
+		DatabaseFormatVersion = 1
+	};
+
+	enum RecordType : quint8
+	{
+		IconRecord = 0,
+		HostRecord,
+		PageRecord
+	};
+
+	enum CacheParameter
+	{
+		DecodedIconsLimit = 500,
+		IconSize = 32
+	};
+
+	explicit FaviconsManager(QObject *parent);
+
+	void loadDatabase();
+	void closeDatabase();
+	void compactDatabase();
+	void decodeIcons();
+	void appendIconRecord(const QByteArray &hash, const QByteArray &data);
+	void appendKeyRecord(RecordType type, const QString &key, const QByteArray &hash);
+	static QIcon getDecodedIcon(const QByteArray &hash);
+	static QString getPageKey(const QUrl &url);
+	static QVector<QPair<QByteArray, QImage> > decodeImages(const QVector<QPair<QByteArray, QByteArray> > &blobs);
+	static QByteArray encodeIcon(const QIcon &icon);
+	static bool save(bool isBlocking);
+
+protected slots:
+	void handleIconsDecoded();
+
+private:
+	QFile *m_file;
+	uchar *m_mappedData;
+	QFutureWatcher<QVector<QPair<QByteArray, QImage> > > *m_decodingWatcher;
+	QByteArray m_pendingRecords;
+	QHash<QByteArray, QByteArray> m_icons;
+	QHash<QString, QByteArray> m_hosts;
+	QHash<QString, QByteArray> m_pages;
+	QCache<QByteArray, QIcon> m_decodedIcons;
+	QVector<QByteArray> m_decodingQueue;
+	QSet<QByteArray> m_pendingDecodes;
+	int m_obsoleteRecordsAmount;
+
+	static FaviconsManager *m_instance;
+
+signals:
+	void iconsDecoded();
+};
+
+}
+
+#endif
@@ -46,6 +46,7 @@ public:
 	{
 		QString title;
 		QString description;
+		QString errorString;
 		QUrl icon;
 		QDateTime lastUpdateTime;
 		QMimeType mimeType;
@@ -55,15 +56,12 @@ public:
 
 	explicit FeedParser();
 
-	virtual void parse(DataFetchJob *data) = 0;
+	virtual bool parse(const QByteArray &data) = 0;
 	virtual FeedInformation getInformation() const = 0;
 	static FeedParser* createParser(Feed *feed, DataFetchJob *data);
 
 protected:
 	static QString createIdentifier(const Feed::Entry &entry);
-
-signals:
-	void parsingFinished(bool isSuccess);
 };
 
 class AtomFeedParser final : public FeedParser
@@ -71,7 +69,7 @@ class AtomFeedParser final : public FeedParser
 public:
 	explicit AtomFeedParser();
 
-	void parse(DataFetchJob *data) override;
+	bool parse(const QByteArray &data) override;
 	FeedInformation getInformation() const override;
 
 protected:
@@ -86,7 +84,7 @@ class RssFeedParser final : public FeedParser
 public:
 	explicit RssFeedParser();
 
-	void parse(DataFetchJob *data) override;
+	bool parse(const QByteArray &data) override;
 	FeedInformation getInformation() const override;
 
 protected:
@@ -23,29 +23,43 @@
 #include "Console.h"
 #include "FeedParser.h"
 #include "Job.h"
-#include "LongTermTimer.h"
 #include "NotificationsManager.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#if QT_VERSION >= 0x050A00
+#include <QtCore/QRandomGenerator>
+#endif
 #include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
 Feed::Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateInterval, QObject *parent) : QObject(parent),
-	m_updateTimer(nullptr),
 	m_parser(nullptr),
 	m_title(title),
 	m_url(url),
 	m_icon(icon),
 	m_error(NoError),
+	m_iconCacheKey(0),
+	m_storedEntryBodiesAmount(0),
+	m_unreadEntriesAmount(0),
+	m_failuresAmount(0),
 	m_updateInterval(0),
 	m_updateProgress(-1),
+	m_isIndexed(false),
 	m_isUpdating(false)
 {
 	setUpdateInterval(updateInterval);
@@ -57,6 +71,11 @@ void Feed::markEntryAsRead(const QString &identifier)
 	{
 		if (m_entries.at(i).identifier == identifier)
 		{
+			if (m_entries.at(i).lastReadTime.isNull())
+			{
+				--m_unreadEntriesAmount;
+			}
+
 			m_entries[i].lastReadTime = QDateTime::currentDateTimeUtc();
 
 			emit feedModified(this);
@@ -74,8 +93,15 @@ void Feed::markEntryAsRemoved(const QString &identifier)
 		{
 			if (m_entries.at(i).identifier == identifier)
 			{
+				if (m_entries.at(i).lastReadTime.isNull())
+				{
+					--m_unreadEntriesAmount;
+				}
+
 				m_entries.removeAt(i);
 
+				removeIndexEntry(identifier);
+
 				m_removedEntries.append(identifier);
 
 				emit feedModified(this);
@@ -110,8 +136,23 @@ void Feed::setUrl(const QUrl &url)
 {
 	if (url != m_url)
 	{
+		const QString bodiesPath(getStoragePath(QLatin1String("dat")));
+		const QString iconPath(getStoragePath(QLatin1String("png")));
+
 		m_url = url;
 
+		if (QFile::exists(bodiesPath))
+		{
+			QFile::remove(getStoragePath(QLatin1String("dat")));
+			QFile::rename(bodiesPath, getStoragePath(QLatin1String("dat")));
+		}
+
+		if (QFile::exists(iconPath))
+		{
+			QFile::remove(getStoragePath(QLatin1String("png")));
+			QFile::rename(iconPath, getStoragePath(QLatin1String("png")));
+		}
+
 		update();
 
 		emit feedModified(this);
@@ -148,30 +189,250 @@ void Feed::setRemovedEntries(const QStringList &removedEntries)
 void Feed::setEntries(const QVector<Feed::Entry> &entries)
 {
 	m_entries = entries;
+	m_unreadEntriesAmount = 0;
+	m_isIndexed = false;
+
+	m_index.clear();
+	m_indexTerms.clear();
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		if (m_entries.at(i).lastReadTime.isNull())
+		{
+			++m_unreadEntriesAmount;
+		}
+	}
 }
 
-void Feed::setUpdateInterval(int interval)
+void Feed::setStoredEntryBodies(const QHash<QString, qint64> &offsets, int amount)
 {
-	if (interval != m_updateInterval)
+	m_entryBodyOffsets = offsets;
+	m_storedEntryBodiesAmount = qMax(amount, offsets.count());
+}
+
+void Feed::saveEntryBodies()
+{
+	QSet<QString> identifiers;
+	identifiers.reserve(m_entries.count());
+
+	QVector<int> pendingEntries;
+
+	for (int i = 0; i < m_entries.count(); ++i)
 	{
-		m_updateInterval = interval;
+		const Entry &entry(m_entries.at(i));
+
+		identifiers.insert(entry.identifier);
+
+		if (!entry.summary.isEmpty() || !entry.content.isEmpty())
+		{
+			pendingEntries.append(i);
+		}
+	}
 
-		if (interval <= 0 && m_updateTimer)
+	QHash<QString, qint64>::iterator iterator(m_entryBodyOffsets.begin());
+
+	while (iterator != m_entryBodyOffsets.end())
+	{
+		if (identifiers.contains(iterator.key()))
 		{
-			m_updateTimer->deleteLater();
-			m_updateTimer = nullptr;
+			++iterator;
 		}
 		else
 		{
-			if (!m_updateTimer)
+			iterator = m_entryBodyOffsets.erase(iterator);
+		}
+	}
+
+	const bool needsCompaction((m_storedEntryBodiesAmount + pendingEntries.count()) > ((m_entryBodyOffsets.count() * 2) + 100));
+
+	if (pendingEntries.isEmpty() && !needsCompaction)
+	{
+		return;
+	}
+
+	QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("feeds")));
+
+	QHash<QString, qint64> offsets;
+
+	if (needsCompaction)
+	{
+		QSaveFile file(getStoragePath(QLatin1String("dat")));
+
+		if (!file.open(QIODevice::WriteOnly))
+		{
+			return;
+		}
+
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+		stream << static_cast<quint32>(StoreMagicNumber) << static_cast<quint32>(StoreFormatVersion);
+
+		for (int i = 0; i < m_entries.count(); ++i)
+		{
+			const Entry &entry(m_entries.at(i));
+
+			if (entry.summary.isEmpty() && entry.content.isEmpty() && !m_entryBodyOffsets.contains(entry.identifier))
 			{
-				m_updateTimer = new LongTermTimer(this);
+				continue;
+			}
+
+			const EntryBody body(getEntryBody(entry.identifier));
+
+			offsets[entry.identifier] = file.pos();
 
-				connect(m_updateTimer, &LongTermTimer::timeout, this, &Feed::update);
+			stream << entry.identifier << body.summary << body.content;
+		}
+
+		if (stream.status() != QDataStream::Ok || !file.commit())
+		{
+			return;
+		}
+
+		m_storedEntryBodiesAmount = offsets.count();
+	}
+	else
+	{
+		QFile file(getStoragePath(QLatin1String("dat")));
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+		{
+			return;
+		}
+
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		if (file.size() == 0)
+		{
+			stream << static_cast<quint32>(StoreMagicNumber) << static_cast<quint32>(StoreFormatVersion);
+		}
+
+		offsets = m_entryBodyOffsets;
+
+		for (int i = 0; i < pendingEntries.count(); ++i)
+		{
+			const Entry &entry(m_entries.at(pendingEntries.at(i)));
+
+			offsets[entry.identifier] = file.pos();
+
+			stream << entry.identifier << entry.summary << entry.content;
+		}
+
+		file.close();
+
+		if (stream.status() != QDataStream::Ok || file.error() != QFileDevice::NoError)
+		{
+			return;
+		}
+
+		m_storedEntryBodiesAmount += pendingEntries.count();
+	}
+
+	m_entryBodyOffsets = offsets;
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		m_entries[i].summary.clear();
+		m_entries[i].content.clear();
+	}
+}
+
+void Feed::saveIcon()
+{
+	if (m_icon.isNull() || m_icon.cacheKey() == m_iconCacheKey)
+	{
+		return;
+	}
+
+	QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("feeds")));
+
+	if (m_icon.pixmap(m_icon.availableSizes().value(0, {16, 16})).save(getStoragePath(QLatin1String("png")), "PNG"))
+	{
+		m_iconCacheKey = m_icon.cacheKey();
+	}
+}
+
+void Feed::createIndex()
+{
+	m_index.clear();
+	m_indexTerms.clear();
+
+	QFile file(getStoragePath(QLatin1String("dat")));
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	const bool hasStoredBodies(!m_entryBodyOffsets.isEmpty() && file.open(QIODevice::ReadOnly));
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		const Entry &entry(m_entries.at(i));
+		QString summary(entry.summary);
+
+		if (summary.isEmpty() && hasStoredBodies && m_entryBodyOffsets.contains(entry.identifier) && file.seek(m_entryBodyOffsets.value(entry.identifier)))
+		{
+			QString recordIdentifier;
+			QString recordSummary;
+			QString recordContent;
+
+			stream.resetStatus();
+			stream >> recordIdentifier >> recordSummary >> recordContent;
+
+			if (stream.status() == QDataStream::Ok && recordIdentifier == entry.identifier)
+			{
+				summary = recordSummary;
 			}
+		}
+
+		addIndexEntry(entry.identifier, entry.title, summary);
+	}
 
-			m_updateTimer->start(static_cast<quint64>(interval) * 60000);
+	m_isIndexed = true;
+}
+
+void Feed::addIndexEntry(const QString &identifier, const QString &title, const QString &summary)
+{
+	const QStringList terms(createTerms(title + QLatin1Char(' ') + summary));
+
+	for (int i = 0; i < terms.count(); ++i)
+	{
+		m_index[terms.at(i)].insert(identifier);
+	}
+
+	m_indexTerms[identifier] = terms;
+}
+
+void Feed::removeIndexEntry(const QString &identifier)
+{
+	const QStringList terms(m_indexTerms.take(identifier));
+
+	for (int i = 0; i < terms.count(); ++i)
+	{
+		QMap<QString, QSet<QString> >::iterator iterator(m_index.find(terms.at(i)));
+
+		if (iterator != m_index.end())
+		{
+			iterator->remove(identifier);
+
+			if (iterator->isEmpty())
+			{
+				m_index.erase(iterator);
+			}
 		}
+	}
+}
+
+void Feed::setCacheValidators(const QByteArray &entityTag, const QByteArray &lastModified)
+{
+	m_entityTag = entityTag;
+	m_lastModified = lastModified;
+}
+
+void Feed::setUpdateInterval(int interval)
+{
+	if (interval != m_updateInterval)
+	{
+		m_updateInterval = interval;
+		m_nextUpdateTime = {};
 
 		emit feedModified(this);
 	}
@@ -179,7 +440,7 @@ void Feed::setUpdateInterval(int interval)
 
 void Feed::update()
 {
-	if (m_parser)
+	if (m_parser || m_isUpdating)
 	{
 		return;
 	}
@@ -191,6 +452,16 @@ void Feed::update()
 
 	DataFetchJob *dataJob(new DataFetchJob(m_url, this));
 
+	if (!m_entityTag.isEmpty())
+	{
+		dataJob->setHeader(QByteArrayLiteral("If-None-Match"), m_entityTag);
+	}
+
+	if (!m_lastModified.isEmpty())
+	{
+		dataJob->setHeader(QByteArrayLiteral("If-Modified-Since"), m_lastModified);
+	}
+
 	connect(dataJob, &DataFetchJob::progressChanged, this, [&](int progress)
 	{
 		m_updateProgress = progress;
@@ -199,144 +470,46 @@ void Feed::update()
 	});
 	connect(dataJob, &DataFetchJob::jobFinished, this, [=](bool isDataFetchSuccess)
 	{
-		if (isDataFetchSuccess)
+		if (isDataFetchSuccess && dataJob->getStatusCode() == 304)
+		{
+			m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+			m_updateProgress = -1;
+
+			emit updateProgressChanged(-1);
+
+			finishUpdate();
+		}
+		else if (isDataFetchSuccess)
 		{
 			m_parser = FeedParser::createParser(this, dataJob);
 
 			if (m_parser)
 			{
-				m_parser->moveToThread(&m_parserThread);
+				const QByteArray entityTag(dataJob->getHeader(QByteArrayLiteral("ETag")));
+				const QByteArray lastModified(dataJob->getHeader(QByteArrayLiteral("Last-Modified")));
+				QFutureWatcher<bool> *watcher(new QFutureWatcher<bool>(this));
 
-				connect(m_parser, &FeedParser::parsingFinished, m_parser, [&](bool isParsingSuccess)
+				connect(watcher, &QFutureWatcher<bool>::finished, this, [=]()
 				{
-					const FeedParser::FeedInformation information(m_parser->getInformation());
-
-					if (!isParsingSuccess)
-					{
-						m_error = ParseError;
-					}
+					const bool isParsingSuccess(watcher->result());
 
-					if (m_icon.isNull() && information.icon.isValid())
-					{
-						IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
-
-						connect(iconJob, &IconFetchJob::jobFinished, this, [=](bool isIconFetchSuccess)
-						{
-							if (isIconFetchSuccess)
-							{
-								setIcon(iconJob->getIcon());
-							}
-						});
-
-						iconJob->start();
-					}
-
-					if (m_title.isEmpty())
-					{
-						m_title = information.title;
-					}
+					watcher->deleteLater();
 
-					if (m_description.isEmpty())
+					if (isParsingSuccess)
 					{
-						m_description = information.description;
+						m_entityTag = entityTag;
+						m_lastModified = lastModified;
 					}
-
-					if (!information.entries.isEmpty())
+					else
 					{
-						QStringList existingRemovedEntries;
-						int amount(0);
-
-						for (int i = (information.entries.count() - 1); i >= 0; --i)
-						{
-							Feed::Entry entry(information.entries.at(i));
-
-							if (m_removedEntries.contains(entry.identifier))
-							{
-								existingRemovedEntries.append(entry.identifier);
-							}
-							else
-							{
-								bool hasEntry(false);
-
-								for (int j = 0; j < m_entries.count(); ++j)
-								{
-									const Feed::Entry existingEntry(m_entries.at(j));
-
-									if (existingEntry.identifier == entry.identifier)
-									{
-										if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
-										{
-											++amount;
-										}
-
-										entry.publicationTime = normalizeTime(entry.publicationTime);
-
-										if (entry.updateTime.isValid())
-										{
-											entry.updateTime = normalizeTime(entry.updateTime);
-										}
-
-										m_entries[j] = entry;
-
-										hasEntry = true;
-
-										break;
-									}
-								}
-
-								if (!hasEntry)
-								{
-									++amount;
-
-									entry.publicationTime = normalizeTime(entry.publicationTime);
-									entry.updateTime = normalizeTime(entry.updateTime);
-
-									m_entries.prepend(entry);
-								}
-							}
-						}
-
-						m_removedEntries = existingRemovedEntries;
-
-						if (amount > 0)
-						{
-							Notification::Message message;
-							message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
-							message.icon = getIcon();
-							message.event = NotificationsManager::FeedUpdatedEvent;
-
-							if (message.icon.isNull())
-							{
-								message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
-							}
-
-							connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
-							{
-								Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
-							});
-						}
-
-						emit entriesModified(this);
+						m_entityTag.clear();
+						m_lastModified.clear();
 					}
 
-					m_mimeType = information.mimeType;
-					m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
-					m_lastUpdateTime = information.lastUpdateTime;
-					m_categories = information.categories;
-
-					m_parserThread.exit();
-
-					m_parser->deleteLater();
-					m_parser = nullptr;
-
-					m_isUpdating = false;
-
-					emit feedModified(this);
+					handleParsingFinished(isParsingSuccess);
 				});
 
-				m_parserThread.start();
-
-				m_parser->parse(dataJob);
+				watcher->setFuture(QtConcurrent::run(m_parser, &FeedParser::parse, dataJob->getData()->readAll()));
 
 				m_updateProgress = -1;
 
@@ -345,27 +518,232 @@ void Feed::update()
 			else
 			{
 				m_error = ParseError;
-				m_isUpdating = false;
 
 				Console::addMessage(tr("Failed to parse feed: unknown feed format"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
 
-				emit feedModified(this);
+				finishUpdate();
 			}
 		}
 		else
 		{
 			m_error = DownloadError;
-			m_isUpdating = false;
 
 			Console::addMessage(tr("Failed to download feed"), Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
 
-			emit feedModified(this);
+			finishUpdate();
 		}
 	});
 
 	dataJob->start();
 }
 
+void Feed::handleParsingFinished(bool isSuccess)
+{
+	const FeedParser::FeedInformation information(m_parser->getInformation());
+
+	m_parser->deleteLater();
+	m_parser = nullptr;
+
+	if (!isSuccess)
+	{
+		m_error = ParseError;
+	}
+
+	if (!information.errorString.isEmpty())
+	{
+		Console::addMessage(information.errorString, Console::NetworkCategory, Console::ErrorLevel, m_url.toDisplayString());
+	}
+
+	if (m_icon.isNull() && information.icon.isValid())
+	{
+		IconFetchJob *iconJob(new IconFetchJob(information.icon, this));
+
+		connect(iconJob, &IconFetchJob::jobFinished, this, [=](bool isIconFetchSuccess)
+		{
+			if (isIconFetchSuccess)
+			{
+				setIcon(iconJob->getIcon());
+			}
+		});
+
+		iconJob->start();
+	}
+
+	if (m_title.isEmpty())
+	{
+		m_title = information.title;
+	}
+
+	if (m_description.isEmpty())
+	{
+		m_description = information.description;
+	}
+
+	if (!information.entries.isEmpty())
+	{
+		const QSet<QString> removedEntries(m_removedEntries.toSet());
+		QHash<QString, int> existingEntries;
+		existingEntries.reserve(m_entries.count());
+
+		for (int i = 0; i < m_entries.count(); ++i)
+		{
+			existingEntries.insert(m_entries.at(i).identifier, i);
+		}
+
+		QStringList existingRemovedEntries;
+		QVector<Feed::Entry> addedEntries;
+		int amount(0);
+
+		for (int i = (information.entries.count() - 1); i >= 0; --i)
+		{
+			Feed::Entry entry(information.entries.at(i));
+
+			if (removedEntries.contains(entry.identifier))
+			{
+				existingRemovedEntries.append(entry.identifier);
+
+				continue;
+			}
+
+			const int index(existingEntries.value(entry.identifier, -1));
+
+			if (index >= 0)
+			{
+				const Feed::Entry &existingEntry(m_entries.at(index));
+
+				if (existingEntry.lastReadTime.isNull() != entry.lastReadTime.isNull())
+				{
+					m_unreadEntriesAmount += (entry.lastReadTime.isNull() ? 1 : -1);
+				}
+
+				if ((entry.publicationTime.isValid() && existingEntry.publicationTime != entry.publicationTime) || (entry.updateTime.isValid() && existingEntry.updateTime != entry.updateTime))
+				{
+					++amount;
+				}
+				else if (m_entryBodyOffsets.contains(entry.identifier))
+				{
+					entry.summary.clear();
+					entry.content.clear();
+				}
+
+				entry.publicationTime = normalizeTime(entry.publicationTime);
+
+				if (entry.updateTime.isValid())
+				{
+					entry.updateTime = normalizeTime(entry.updateTime);
+				}
+
+				m_entries[index] = entry;
+
+				if (m_isIndexed && !entry.summary.isEmpty())
+				{
+					removeIndexEntry(entry.identifier);
+					addIndexEntry(entry.identifier, entry.title, entry.summary);
+				}
+			}
+			else if (existingEntries.contains(entry.identifier))
+			{
+				entry.publicationTime = normalizeTime(entry.publicationTime);
+
+				if (entry.updateTime.isValid())
+				{
+					entry.updateTime = normalizeTime(entry.updateTime);
+				}
+
+				addedEntries[-(index + 2)] = entry;
+			}
+			else
+			{
+				++amount;
+
+				entry.publicationTime = normalizeTime(entry.publicationTime);
+				entry.updateTime = normalizeTime(entry.updateTime);
+
+				existingEntries.insert(entry.identifier, -(addedEntries.count() + 2));
+
+				addedEntries.append(entry);
+			}
+		}
+
+		if (!addedEntries.isEmpty())
+		{
+			std::reverse(addedEntries.begin(), addedEntries.end());
+
+			for (int i = 0; i < addedEntries.count(); ++i)
+			{
+				if (addedEntries.at(i).lastReadTime.isNull())
+				{
+					++m_unreadEntriesAmount;
+				}
+
+				if (m_isIndexed)
+				{
+					addIndexEntry(addedEntries.at(i).identifier, addedEntries.at(i).title, addedEntries.at(i).summary);
+				}
+			}
+
+			m_entries = (addedEntries + m_entries);
+		}
+
+		m_removedEntries = existingRemovedEntries;
+
+		if (amount > 0)
+		{
+			Notification::Message message;
+			message.message = getTitle() + QLatin1Char('\n') + tr("%n new message(s)", nullptr, amount);
+			message.icon = getIcon();
+			message.event = NotificationsManager::FeedUpdatedEvent;
+
+			if (message.icon.isNull())
+			{
+				message.icon = ThemesManager::createIcon(QLatin1String("application-rss+xml"));
+			}
+
+			connect(NotificationsManager::createNotification(message, this), &Notification::clicked, this, [&]()
+			{
+				Application::getInstance()->triggerAction(ActionsManager::OpenUrlAction, {{QLatin1String("url"), FeedsManager::createFeedReaderUrl(getUrl())}});
+			});
+		}
+
+		emit entriesModified(this);
+	}
+
+	m_mimeType = information.mimeType;
+	m_lastSynchronizationTime = QDateTime::currentDateTimeUtc();
+	m_lastUpdateTime = information.lastUpdateTime;
+	m_categories = information.categories;
+
+	finishUpdate();
+}
+
+void Feed::finishUpdate()
+{
+	m_isUpdating = false;
+
+	if (m_error == NoError)
+	{
+		m_failuresAmount = 0;
+	}
+	else
+	{
+		++m_failuresAmount;
+	}
+
+	if (m_updateInterval > 0)
+	{
+		qint64 interval(static_cast<qint64>(m_updateInterval) * 60000);
+
+		if (m_failuresAmount > 0)
+		{
+			interval = qMax(interval, qMin((interval << qMin(m_failuresAmount, 8)), (static_cast<qint64>(BackoffIntervalLimit) * 60000)));
+		}
+
+		m_nextUpdateTime = QDateTime::currentDateTimeUtc().addMSecs(interval + FeedsManager::getJitter((interval * UpdateJitter) / 100));
+	}
+
+	emit feedModified(this);
+}
+
 QString Feed::getTitle() const
 {
 	return m_title;
@@ -403,6 +781,58 @@ QDateTime Feed::normalizeTime(const QDateTime &time)
 	return ((time.isValid() && time < currentTime) ? time : currentTime);
 }
 
+QStringList Feed::createTerms(const QString &text)
+{
+	QSet<QString> terms;
+	QString term;
+	bool isInTag(false);
+
+	for (int i = 0; i <= text.length(); ++i)
+	{
+		const QChar character((i < text.length()) ? text.at(i) : QChar());
+
+		if (isInTag)
+		{
+			isInTag = (character != QLatin1Char('>'));
+
+			continue;
+		}
+
+		if (character.isLetterOrNumber())
+		{
+			term.append(character.toLower());
+
+			continue;
+		}
+
+		if (term.length() >= MinimumTermLength && term.length() <= MaximumTermLength)
+		{
+			terms.insert(term);
+		}
+
+		term.clear();
+
+		isInTag = (character == QLatin1Char('<'));
+	}
+
+	return terms.values();
+}
+
+QByteArray Feed::getEntityTag() const
+{
+	return m_entityTag;
+}
+
+QByteArray Feed::getLastModified() const
+{
+	return m_lastModified;
+}
+
+QString Feed::getStoragePath(const QString &extension) const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("feeds/") + QString::fromLatin1(QCryptographicHash::hash(m_url.toString().toUtf8(), QCryptographicHash::Sha1).toHex()) + QLatin1Char('.') + extension);
+}
+
 QMimeType Feed::getMimeType() const
 {
 	return m_mimeType;
@@ -418,6 +848,51 @@ QStringList Feed::getRemovedEntries() const
 	return m_removedEntries;
 }
 
+Feed::EntryBody Feed::getEntryBody(const QString &identifier) const
+{
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		const Entry &entry(m_entries.at(i));
+
+		if (entry.identifier == identifier)
+		{
+			if (!entry.summary.isEmpty() || !entry.content.isEmpty())
+			{
+				return {entry.summary, entry.content};
+			}
+
+			break;
+		}
+	}
+
+	if (!m_entryBodyOffsets.contains(identifier))
+	{
+		return {};
+	}
+
+	QFile file(getStoragePath(QLatin1String("dat")));
+
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(m_entryBodyOffsets.value(identifier)))
+	{
+		return {};
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	QString recordIdentifier;
+	EntryBody body;
+
+	stream >> recordIdentifier >> body.summary >> body.content;
+
+	if (stream.status() != QDataStream::Ok || recordIdentifier != identifier)
+	{
+		return {};
+	}
+
+	return body;
+}
+
 QVector<Feed::Entry> Feed::getEntries(const QStringList &categories) const
 {
 	if (!categories.isEmpty())
@@ -451,24 +926,58 @@ QVector<Feed::Entry> Feed::getEntries(const QStringList &categories) const
 	return m_entries;
 }
 
-Feed::FeedError Feed::getError() const
+QStringList Feed::findEntries(const QString &query)
 {
-	return m_error;
-}
+	const QStringList terms(createTerms(query));
 
-int Feed::getUnreadEntriesAmount() const
-{
-	int amount(0);
+	if (terms.isEmpty())
+	{
+		return {};
+	}
 
-	for (int i = 0; i < m_entries.count(); ++i)
+	if (!m_isIndexed)
 	{
-		if (m_entries.at(i).lastReadTime.isNull())
+		createIndex();
+	}
+
+	QSet<QString> identifiers;
+
+	for (int i = 0; i < terms.count(); ++i)
+	{
+		const QString &term(terms.at(i));
+		QSet<QString> termIdentifiers;
+
+		for (QMap<QString, QSet<QString> >::const_iterator iterator(m_index.lowerBound(term)); iterator != m_index.constEnd() && iterator.key().startsWith(term); ++iterator)
 		{
-			++amount;
+			termIdentifiers.unite(iterator.value());
+		}
+
+		if (i == 0)
+		{
+			identifiers = termIdentifiers;
+		}
+		else
+		{
+			identifiers.intersect(termIdentifiers);
+		}
+
+		if (identifiers.isEmpty())
+		{
+			return {};
 		}
 	}
 
-	return amount;
+	return identifiers.values();
+}
+
+Feed::FeedError Feed::getError() const
+{
+	return m_error;
+}
+
+int Feed::getUnreadEntriesAmount() const
+{
+	return m_unreadEntriesAmount;
 }
 
 int Feed::getUpdateInterval() const
@@ -492,19 +1001,90 @@ QVector<Feed*> FeedsManager::m_feeds;
 bool FeedsManager::m_isInitialized(false);
 
 FeedsManager::FeedsManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+	m_schedulerTimer(0)
 {
 }
 
 void FeedsManager::timerEvent(QTimerEvent *event)
 {
-	if (event->timerId() == m_saveTimer)
+	if (event->timerId() == m_schedulerTimer)
 	{
-		killTimer(m_saveTimer);
+		const QDateTime currentTime(QDateTime::currentDateTimeUtc());
 
-		m_saveTimer = 0;
+		if (m_lastSchedulerTime.isValid() && m_lastSchedulerTime.msecsTo(currentTime) > (SchedulerInterval * 4))
+		{
+			for (int i = 0; i < m_feeds.count(); ++i)
+			{
+				Feed *feed(m_feeds.at(i));
 
-		save();
+				if (feed->m_nextUpdateTime.isValid() && feed->m_nextUpdateTime <= currentTime)
+				{
+					feed->m_nextUpdateTime = currentTime.addMSecs(getJitter(CatchUpWindow));
+				}
+			}
+		}
+
+		m_lastSchedulerTime = currentTime;
+
+		updateFeeds();
+	}
+}
+
+void FeedsManager::updateFeeds()
+{
+	const QDateTime currentTime(QDateTime::currentDateTimeUtc());
+	QVector<Feed*> feeds;
+	QSet<QString> hosts;
+	int amount(0);
+
+	for (int i = 0; i < m_feeds.count(); ++i)
+	{
+		Feed *feed(m_feeds.at(i));
+
+		if (feed->isUpdating())
+		{
+			hosts.insert(feed->getUrl().host());
+
+			++amount;
+
+			continue;
+		}
+
+		if (feed->getUpdateInterval() <= 0)
+		{
+			continue;
+		}
+
+		if (!feed->m_nextUpdateTime.isValid())
+		{
+			const QDateTime updateTime(feed->getLastSynchronizationTime().isValid() ? feed->getLastSynchronizationTime().addSecs(static_cast<qint64>(feed->getUpdateInterval()) * 60) : QDateTime());
+
+			feed->m_nextUpdateTime = ((updateTime.isValid() && updateTime > currentTime) ? updateTime : currentTime.addMSecs(getJitter(StartupDelay)));
+		}
+
+		if (feed->m_nextUpdateTime <= currentTime)
+		{
+			feeds.append(feed);
+		}
+	}
+
+	std::sort(feeds.begin(), feeds.end(), [&](Feed *first, Feed *second)
+	{
+		return (first->m_nextUpdateTime < second->m_nextUpdateTime);
+	});
+
+	for (int i = 0; (i < feeds.count() && amount < UpdatesLimit); ++i)
+	{
+		const QString host(feeds.at(i)->getUrl().host());
+
+		if (!hosts.contains(host))
+		{
+			hosts.insert(host);
+
+			feeds.at(i)->update();
+
+			++amount;
+		}
 	}
 }
 
@@ -513,6 +1093,13 @@ void FeedsManager::createInstance()
 	if (!m_instance)
 	{
 		m_instance = new FeedsManager(QCoreApplication::instance());
+
+		PersistenceManager::registerTarget(m_instance, [](bool)
+		{
+			m_instance->save();
+
+			return true;
+		});
 	}
 }
 
@@ -525,6 +1112,8 @@ void FeedsManager::ensureInitialized()
 
 	m_isInitialized = true;
 
+	m_instance->m_schedulerTimer = m_instance->startTimer(SchedulerInterval);
+
 	QFile file(SessionsManager::getWritableDataPath(QLatin1String("feeds.json")));
 
 	if (file.open(QIODevice::ReadOnly))
@@ -534,11 +1123,24 @@ void FeedsManager::ensureInitialized()
 		for (int i = 0; i < feedsArray.count(); ++i)
 		{
 			const QJsonObject feedObject(feedsArray.at(i).toObject());
-			Feed *feed(createFeed(QUrl(feedObject.value(QLatin1String("url")).toString()), feedObject.value(QLatin1String("title")).toString(), Utils::loadPixmapFromDataUri(feedObject.value(QLatin1String("icon")).toString()), feedObject.value(QLatin1String("updateInterval")).toInt()));
+			const QString iconData(feedObject.value(QLatin1String("icon")).toString());
+			QIcon icon;
+
+			if (iconData.startsWith(QLatin1String("data:")))
+			{
+				icon = QIcon(Utils::loadPixmapFromDataUri(iconData));
+			}
+			else if (!iconData.isEmpty())
+			{
+				icon = QIcon(QPixmap(SessionsManager::getWritableDataPath(QLatin1String("feeds/") + iconData)));
+			}
+
+			Feed *feed(createFeed(QUrl(feedObject.value(QLatin1String("url")).toString()), feedObject.value(QLatin1String("title")).toString(), icon, feedObject.value(QLatin1String("updateInterval")).toInt()));
 			feed->setDescription(feedObject.value(QLatin1String("description")).toString());
 			feed->setLastUpdateTime(QDateTime::fromString(feedObject.value(QLatin1String("lastUpdateTime")).toString(), Qt::ISODate));
 			feed->setLastSynchronizationTime(QDateTime::fromString(feedObject.value(QLatin1String("lastSynchronizationTime")).toString(), Qt::ISODate));
 			feed->setRemovedEntries(feedObject.value(QLatin1String("removedEntries")).toVariant().toStringList());
+			feed->setCacheValidators(feedObject.value(QLatin1String("entityTag")).toString().toLatin1(), feedObject.value(QLatin1String("lastModified")).toString().toLatin1());
 
 			if (feedObject.contains(QLatin1String("categories")))
 			{
@@ -554,10 +1156,17 @@ void FeedsManager::ensureInitialized()
 				feed->setCategories(categories);
 			}
 
+			if (!iconData.isEmpty() && !iconData.startsWith(QLatin1String("data:")))
+			{
+				feed->m_iconCacheKey = feed->getIcon().cacheKey();
+			}
+
 			const QJsonArray entriesArray(feedObject.value(QLatin1String("entries")).toArray());
 			QVector<Feed::Entry> entries;
 			entries.reserve(entriesArray.count());
 
+			QHash<QString, qint64> bodyOffsets;
+
 			for (int j = 0; j < entriesArray.count(); ++j)
 			{
 				const QJsonObject entryObject(entriesArray.at(j).toObject());
@@ -574,10 +1183,16 @@ void FeedsManager::ensureInitialized()
 				entry.updateTime = QDateTime::fromString(entryObject.value(QLatin1String("updateTime")).toString(), Qt::ISODate);
 				entry.categories = entryObject.value(QLatin1String("categories")).toVariant().toStringList();
 
+				if (entryObject.contains(QLatin1String("bodyOffset")))
+				{
+					bodyOffsets[entry.identifier] = static_cast<qint64>(entryObject.value(QLatin1String("bodyOffset")).toDouble());
+				}
+
 				entries.append(entry);
 			}
 
 			feed->setEntries(entries);
+			feed->setStoredEntryBodies(bodyOffsets, feedObject.value(QLatin1String("storedEntryBodies")).toInt());
 		}
 	}
 
@@ -586,26 +1201,13 @@ void FeedsManager::ensureInitialized()
 		m_model = new FeedsModel(SessionsManager::getWritableDataPath(QLatin1String("feeds.opml")), m_instance);
 
 		connect(m_model, &FeedsModel::modelModified, m_instance, &FeedsManager::scheduleSave);
+		connect(m_instance, &FeedsManager::feedModified, m_model, &FeedsModel::handleFeedModified);
 	}
 }
 
 void FeedsManager::scheduleSave()
 {
-	if (Application::isAboutToQuit())
-	{
-		if (m_saveTimer != 0)
-		{
-			killTimer(m_saveTimer);
-
-			m_saveTimer = 0;
-		}
-
-		save();
-	}
-	else if (m_saveTimer == 0)
-	{
-		m_saveTimer = startTimer(1000);
-	}
+	PersistenceManager::markAsDirty(this);
 }
 
 void FeedsManager::save()
@@ -631,13 +1233,16 @@ void FeedsManager::save()
 
 	for (int i = 0; i < m_feeds.count(); ++i)
 	{
-		const Feed *feed(m_feeds.at(i));
+		Feed *feed(m_feeds.at(i));
 
 		if (!FeedsManager::getModel()->hasFeed(feed->getUrl()) && !BookmarksManager::getModel()->hasFeed(feed->getUrl()))
 		{
 			continue;
 		}
 
+		feed->saveIcon();
+		feed->saveEntryBodies();
+
 		const QMap<QString, QString> categories(feed->getCategories());
 		QJsonObject feedObject({{QLatin1String("title"), feed->getTitle()}, {QLatin1String("url"), feed->getUrl().toString()}, {QLatin1String("updateInterval"), QString::number(feed->getUpdateInterval())}, {QLatin1String("lastSynchronizationTime"), feed->getLastUpdateTime().toString(Qt::ISODate)}, {QLatin1String("lastUpdateTime"), feed->getLastSynchronizationTime().toString(Qt::ISODate)}});
 
@@ -648,7 +1253,19 @@ void FeedsManager::save()
 
 		if (!feed->getIcon().isNull())
 		{
-			feedObject.insert(QLatin1String("icon"), Utils::savePixmapAsDataUri(feed->getIcon().pixmap(feed->getIcon().availableSizes().value(0, {16, 16}))));
+			if (feed->m_iconCacheKey == feed->getIcon().cacheKey())
+			{
+				feedObject.insert(QLatin1String("icon"), QFileInfo(feed->getStoragePath(QLatin1String("png"))).fileName());
+			}
+			else
+			{
+				feedObject.insert(QLatin1String("icon"), Utils::savePixmapAsDataUri(feed->getIcon().pixmap(feed->getIcon().availableSizes().value(0, {16, 16}))));
+			}
+		}
+
+		if (feed->m_storedEntryBodiesAmount > 0)
+		{
+			feedObject.insert(QLatin1String("storedEntryBodies"), feed->m_storedEntryBodiesAmount);
 		}
 
 		if (!categories.isEmpty())
@@ -669,6 +1286,16 @@ void FeedsManager::save()
 			feedObject.insert(QLatin1String("removedEntries"), QJsonArray::fromStringList(feed->getRemovedEntries()));
 		}
 
+		if (!feed->getEntityTag().isEmpty())
+		{
+			feedObject.insert(QLatin1String("entityTag"), QString::fromLatin1(feed->getEntityTag()));
+		}
+
+		if (!feed->getLastModified().isEmpty())
+		{
+			feedObject.insert(QLatin1String("lastModified"), QString::fromLatin1(feed->getLastModified()));
+		}
+
 		const QVector<Feed::Entry> entries(feed->getEntries());
 		QJsonArray entriesArray;
 
@@ -687,6 +1314,11 @@ void FeedsManager::save()
 				entryObject.insert(QLatin1String("content"), entry.content);
 			}
 
+			if (feed->m_entryBodyOffsets.contains(entry.identifier))
+			{
+				entryObject.insert(QLatin1String("bodyOffset"), static_cast<double>(feed->m_entryBodyOffsets.value(entry.identifier)));
+			}
+
 			if (!entry.author.isEmpty())
 			{
 				entryObject.insert(QLatin1String("author"), entry.author);
@@ -742,11 +1374,30 @@ void FeedsManager::handleFeedModified(Feed *feed)
 	if (feed)
 	{
 		emit feedModified(feed->getUrl());
+
+		if (!feed->isUpdating())
+		{
+			updateFeeds();
+		}
 	}
 
 	scheduleSave();
 }
 
+qint64 FeedsManager::getJitter(qint64 range)
+{
+	if (range <= 0)
+	{
+		return 0;
+	}
+
+#if QT_VERSION >= 0x050A00
+	return static_cast<qint64>(QRandomGenerator::global()->bounded(static_cast<double>(range)));
+#else
+	return ((static_cast<qint64>(qrand()) * range) / (static_cast<qint64>(RAND_MAX) + 1));
+#endif
+}
+
 FeedsManager* FeedsManager::getInstance()
 {
 	return m_instance;
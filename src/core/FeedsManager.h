@@ -24,14 +24,13 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QMimeType>
-#include <QtCore/QThread>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
 class FeedsManager;
 class FeedParser;
-class LongTermTimer;
 
 class Feed final : public QObject
 {
@@ -60,6 +59,12 @@ public:
 		QStringList categories;
 	};
 
+	struct EntryBody final
+	{
+		QString summary;
+		QString content;
+	};
+
 	explicit Feed(const QString &title, const QUrl &url, const QIcon &icon, int updateInterval, QObject *parent = nullptr);
 
 	void markEntryAsRead(const QString &identifier);
@@ -81,6 +86,8 @@ public:
 	QMap<QString, QString> getCategories() const;
 	QStringList getRemovedEntries() const;
 	QVector<Entry> getEntries(const QStringList &categories = {}) const;
+	QStringList findEntries(const QString &query);
+	EntryBody getEntryBody(const QString &identifier) const;
 	FeedError getError() const;
 	int getUnreadEntriesAmount() const;
 	int getUpdateInterval() const;
@@ -91,28 +98,68 @@ public slots:
 	void update();
 
 protected:
+	enum UpdateParameter
+	{
+		UpdateJitter = 10,
+		BackoffIntervalLimit = 1440
+	};
+
+	enum StoreFormat : quint32
+	{
+		StoreMagicNumber = 0x4F544645,
+		StoreFormatVersion = 1
+	};
+
+	enum IndexParameter
+	{
+		MinimumTermLength = 2,
+		MaximumTermLength = 32
+	};
+
 	void setCategories(const QMap<QString, QString> &categories);
 	void setRemovedEntries(const QStringList &removedEntries);
 	void setEntries(const QVector<Entry> &entries);
+	void setCacheValidators(const QByteArray &entityTag, const QByteArray &lastModified);
+	void setStoredEntryBodies(const QHash<QString, qint64> &offsets, int amount);
+	void saveEntryBodies();
+	void saveIcon();
+	void createIndex();
+	void addIndexEntry(const QString &identifier, const QString &title, const QString &summary);
+	void removeIndexEntry(const QString &identifier);
+	void handleParsingFinished(bool isSuccess);
+	void finishUpdate();
 	static QDateTime normalizeTime(const QDateTime &time);
+	static QStringList createTerms(const QString &text);
+	QByteArray getEntityTag() const;
+	QByteArray getLastModified() const;
+	QString getStoragePath(const QString &extension) const;
 
 private:
-	LongTermTimer *m_updateTimer;
 	FeedParser *m_parser;
-	QThread m_parserThread;
 	QString m_title;
 	QString m_description;
 	QUrl m_url;
 	QIcon m_icon;
 	QDateTime m_lastUpdateTime;
 	QDateTime m_lastSynchronizationTime;
+	QDateTime m_nextUpdateTime;
 	QMimeType m_mimeType;
 	QMap<QString, QString> m_categories;
 	QStringList m_removedEntries;
 	QVector<Entry> m_entries;
+	QHash<QString, qint64> m_entryBodyOffsets;
+	QMap<QString, QSet<QString> > m_index;
+	QHash<QString, QStringList> m_indexTerms;
+	QByteArray m_entityTag;
+	QByteArray m_lastModified;
 	FeedError m_error;
+	qint64 m_iconCacheKey;
+	int m_storedEntryBodiesAmount;
+	int m_unreadEntriesAmount;
+	int m_failuresAmount;
 	int m_updateInterval;
 	int m_updateProgress;
+	bool m_isIndexed;
 	bool m_isUpdating;
 
 signals:
@@ -137,18 +184,29 @@ public:
 	static QVector<Feed*> getFeeds();
 
 protected:
+	enum SchedulerParameter
+	{
+		SchedulerInterval = 15000,
+		UpdatesLimit = 4,
+		StartupDelay = 60000,
+		CatchUpWindow = 300000
+	};
+
 	explicit FeedsManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	static void ensureInitialized();
 	void save();
+	void updateFeeds();
+	static qint64 getJitter(qint64 range);
 
 protected slots:
 	void scheduleSave();
 	void handleFeedModified(Feed *feed);
 
 private:
-	int m_saveTimer;
+	QDateTime m_lastSchedulerTime;
+	int m_schedulerTimer;
 
 	static FeedsManager *m_instance;
 	static FeedsModel *m_model;
@@ -159,6 +217,8 @@ signals:
 	void feedAdded(const QUrl &url);
 	void feedModified(const QUrl &url);
 	void feedRemoved(const QUrl &url);
+
+friend class Feed;
 };
 
 }
@@ -149,6 +149,13 @@ QVariant FeedsModel::Entry::data(int role) const
 		}
 	}
 
+	if (role == UnreadEntriesAmountRole && (getType() == FolderEntry || getType() == RootEntry))
+	{
+		const FeedsModel *model(qobject_cast<FeedsModel*>(this->model()));
+
+		return (model ? model->getUnreadEntriesAmount(this) : 0);
+	}
+
 	if (role == IsTrashedRole)
 	{
 		QModelIndex parent(index().parent());
@@ -297,6 +304,11 @@ FeedsModel::FeedsModel(const QString &path, QObject *parent) : QStandardItemMode
 	appendRow(m_trashEntry);
 	setItemPrototype(new Entry());
 
+	connect(this, &FeedsModel::modelModified, this, [&]()
+	{
+		m_unreadEntriesAmounts.clear();
+	});
+
 	if (!QFile::exists(path))
 	{
 		return;
@@ -536,11 +548,6 @@ void FeedsModel::writeEntry(QXmlStreamWriter *writer, Entry *entry) const
 			writer->writeAttribute(QLatin1String("xmlUrl"), entry->getRawData(UrlRole).toUrl().toString());
 			writer->writeAttribute(QLatin1String("updateInterval"), QString::number(entry->getRawData(UpdateIntervalRole).toInt()));
 
-			if (!entry->getRawData(Qt::DecorationRole).isNull())
-			{
-				writer->writeAttribute(QLatin1String("icon"), Utils::savePixmapAsDataUri(entry->icon().pixmap(entry->icon().availableSizes().value(0, {16, 16}))));
-			}
-
 			break;
 		default:
 			break;
@@ -636,6 +643,31 @@ void FeedsModel::emptyTrash()
 	}
 }
 
+void FeedsModel::handleFeedModified(const QUrl &url)
+{
+	const QVector<Entry*> entries(getEntries(url));
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QModelIndex index(entries.at(i)->index());
+
+		emit dataChanged(index, index);
+
+		Entry *parent(static_cast<Entry*>(entries.at(i)->parent()));
+
+		while (parent)
+		{
+			const QModelIndex parentIndex(parent->index());
+
+			m_unreadEntriesAmounts.remove(parent);
+
+			emit dataChanged(parentIndex, parentIndex, {UnreadEntriesAmountRole});
+
+			parent = static_cast<Entry*>(parent->parent());
+		}
+	}
+}
+
 void FeedsModel::createIdentifier(FeedsModel::Entry *entry)
 {
 	const quint64 identifier(m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
@@ -835,6 +867,47 @@ QVector<FeedsModel::Entry*> FeedsModel::getEntries(const QUrl &url) const
 	return entries;
 }
 
+int FeedsModel::getUnreadEntriesAmount(const Entry *entry) const
+{
+	if (m_unreadEntriesAmounts.contains(entry))
+	{
+		return m_unreadEntriesAmounts.value(entry);
+	}
+
+	int amount(0);
+
+	for (int i = 0; i < entry->rowCount(); ++i)
+	{
+		const Entry *childEntry(static_cast<Entry*>(entry->child(i, 0)));
+
+		if (!childEntry)
+		{
+			continue;
+		}
+
+		switch (childEntry->getType())
+		{
+			case FeedEntry:
+				if (childEntry->getFeed())
+				{
+					amount += childEntry->getFeed()->getUnreadEntriesAmount();
+				}
+
+				break;
+			case FolderEntry:
+				amount += getUnreadEntriesAmount(childEntry);
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	m_unreadEntriesAmounts[entry] = amount;
+
+	return amount;
+}
+
 bool FeedsModel::moveEntry(Entry *entry, Entry *newParent, int newRow)
 {
 	if (!entry || !newParent || entry == newParent || entry->isAncestorOf(newParent))
@@ -112,6 +112,7 @@ public:
 
 public slots:
 	void emptyTrash();
+	void handleFeedModified(const QUrl &url);
 
 protected:
 	void readEntry(QXmlStreamReader *reader, Entry *parent);
@@ -120,6 +121,7 @@ protected:
 	void readdEntryUrl(Entry *entry);
 	void createIdentifier(Entry *entry);
 	void handleUrlChanged(Entry *entry, const QUrl &newUrl, const QUrl &oldUrl = {});
+	int getUnreadEntriesAmount(const Entry *entry) const;
 
 private:
 	Entry *m_rootEntry;
@@ -128,6 +130,7 @@ private:
 	QHash<Entry*, QPair<QModelIndex, int> > m_trash;
 	QHash<QUrl, QVector<Entry*> > m_urls;
 	QMap<quint64, Entry*> m_identifiers;
+	mutable QHash<const Entry*, int> m_unreadEntriesAmounts;
 
 signals:
 	void entryAdded(Entry *entry);
@@ -588,6 +588,7 @@ QPoint GesturesManager::m_lastPosition;
 QVariantMap GesturesManager::m_parameters;
 QHash<GesturesManager::GesturesContext, QVector<MouseProfile::Gesture> > GesturesManager::m_gestures;
 QHash<GesturesManager::GesturesContext, QVector<QVector<MouseProfile::Gesture::Step> > > GesturesManager::m_nativeGestures;
+QHash<GesturesManager::GesturesContext, GesturesManager::GesturesTree> GesturesManager::m_gesturesTrees;
 QVector<QInputEvent*> GesturesManager::m_events;
 QVector<MouseProfile::Gesture::Step> GesturesManager::m_steps;
 QVector<GesturesManager::GesturesContext> GesturesManager::m_contexts;
@@ -679,6 +680,119 @@ void GesturesManager::loadProfiles()
 			}
 		}
 	}
+
+	compileGestures();
+}
+
+void GesturesManager::compileGestures()
+{
+	m_gesturesTrees.clear();
+
+	QHash<GesturesContext, QVector<MouseProfile::Gesture> >::const_iterator gesturesIterator;
+
+	for (gesturesIterator = m_gestures.constBegin(); gesturesIterator != m_gestures.constEnd(); ++gesturesIterator)
+	{
+		GesturesTree &tree(m_gesturesTrees[gesturesIterator.key()]);
+		tree.nodes.append(GesturesTree::Node());
+
+		const QVector<QVector<MouseProfile::Gesture::Step> > nativeGestures(m_nativeGestures.value(gesturesIterator.key()));
+
+		tree.nativeGesturesAmount = nativeGestures.count();
+
+		for (int i = 0; i < nativeGestures.count(); ++i)
+		{
+			addGestureToTree(tree, nativeGestures.at(i), i, true);
+		}
+
+		for (int i = 0; i < gesturesIterator.value().count(); ++i)
+		{
+			addGestureToTree(tree, gesturesIterator.value().at(i).steps, (tree.nativeGesturesAmount + i), false);
+		}
+
+		tree.nodes.squeeze();
+	}
+}
+
+void GesturesManager::addGestureToTree(GesturesTree &tree, const QVector<MouseProfile::Gesture::Step> &steps, int gesture, bool isNative)
+{
+	int node(0);
+
+	for (int i = 0; i < steps.count(); ++i)
+	{
+		if (!isNative && steps.at(i).type == QEvent::MouseMove)
+		{
+			MouseGestures::ActionList moves;
+
+			for (int j = i; (j < steps.count() && steps.at(j).type == QEvent::MouseMove); ++j)
+			{
+				moves.push_back(steps.at(j).direction);
+			}
+
+			if (!tree.nodes.at(node).moves.contains(moves))
+			{
+				tree.nodes[node].moves.append(moves);
+			}
+		}
+
+		int child(-1);
+
+		for (int j = 0; j < tree.nodes.at(node).children.count(); ++j)
+		{
+			if (tree.nodes.at(tree.nodes.at(node).children.at(j)).step == steps.at(i))
+			{
+				child = tree.nodes.at(node).children.at(j);
+
+				break;
+			}
+		}
+
+		if (child < 0)
+		{
+			GesturesTree::Node childNode;
+			childNode.step = steps.at(i);
+
+			child = tree.nodes.count();
+
+			tree.nodes.append(childNode);
+			tree.nodes[node].children.append(child);
+		}
+
+		node = child;
+	}
+
+	tree.nodes[node].gestures.append(gesture);
+}
+
+void GesturesManager::matchTreeNode(const GesturesTree &tree, int node, int depth, int difference, int &lowestDifference, int &bestGesture)
+{
+	const GesturesTree::Node &treeNode(tree.nodes.at(node));
+
+	if (depth == m_steps.count())
+	{
+		for (int i = 0; i < treeNode.gestures.count(); ++i)
+		{
+			if (difference < lowestDifference || (difference == lowestDifference && treeNode.gestures.at(i) < bestGesture))
+			{
+				lowestDifference = difference;
+				bestGesture = treeNode.gestures.at(i);
+			}
+		}
+
+		return;
+	}
+
+	const bool isLast(depth == (m_steps.count() - 1));
+
+	for (int i = 0; i < treeNode.children.count(); ++i)
+	{
+		const int child(treeNode.children.at(i));
+		const int stepDifference(calculateStepDifference(tree.nodes.at(child).step, m_steps.at(depth), isLast));
+
+		if (stepDifference >= 0 && (difference + stepDifference) <= lowestDifference)
+		{
+			matchTreeNode(tree, child, (depth + 1), (difference + stepDifference), lowestDifference, bestGesture);
+		}
+	}
 }
 
 void GesturesManager::recognizeMoveStep(const QInputEvent *event)
@@ -692,27 +806,44 @@ void GesturesManager::recognizeMoveStep(const QInputEvent *event)
 
 	for (int i = 0; i < m_contexts.count(); ++i)
 	{
-		const QVector<MouseProfile::Gesture> gestures(m_gestures[m_contexts.at(i)]);
+		const QHash<GesturesContext, GesturesTree>::const_iterator iterator(m_gesturesTrees.constFind(m_contexts.at(i)));
 
-		for (int j = 0; j < gestures.count(); ++j)
+		if (iterator == m_gesturesTrees.constEnd())
 		{
-			const QVector<MouseProfile::Gesture::Step> steps(gestures.at(j).steps);
+			continue;
+		}
 
-			if (steps.count() > m_steps.count() && steps[m_steps.count()].type == QEvent::MouseMove && steps.mid(0, m_steps.count()) == m_steps)
-			{
-				MouseGestures::ActionList moves;
+		const GesturesTree &tree(iterator.value());
+		int node(0);
 
-				for (int k = m_steps.count(); (k < steps.count() && steps.at(k).type == QEvent::MouseMove); ++k)
-				{
-					moves.push_back(steps.at(k).direction);
-				}
+		for (int j = 0; (j < m_steps.count() && node >= 0); ++j)
+		{
+			const QVector<int> &children(tree.nodes.at(node).children);
+
+			node = -1;
 
-				if (!moves.empty())
+			for (int k = 0; k < children.count(); ++k)
+			{
+				if (tree.nodes.at(children.at(k)).step == m_steps.at(j))
 				{
-					possibleMoves.insert(m_recognizer->registerGesture(moves), moves);
+					node = children.at(k);
+
+					break;
 				}
 			}
 		}
+
+		if (node < 0)
+		{
+			continue;
+		}
+
+		const QVector<MouseGestures::ActionList> &moves(tree.nodes.at(node).moves);
+
+		for (int j = 0; j < moves.count(); ++j)
+		{
+			possibleMoves.insert(m_recognizer->registerGesture(moves.at(j)), moves.at(j));
+		}
 	}
 
 	const QMouseEvent *mouseEvent(static_cast<const QMouseEvent*>(event));
@@ -806,46 +937,40 @@ MouseProfile::Gesture GesturesManager::matchGesture()
 
 	for (int i = 0; i < m_contexts.count(); ++i)
 	{
-		const QVector<QVector<MouseProfile::Gesture::Step> > nativeGestures(m_nativeGestures[m_contexts.at(i)]);
+		const QHash<GesturesContext, GesturesTree>::const_iterator iterator(m_gesturesTrees.constFind(m_contexts.at(i)));
 
-		for (int j = 0; j < nativeGestures.count(); ++j)
+		if (iterator == m_gesturesTrees.constEnd())
 		{
-			const int difference(calculateGesturesDifference(nativeGestures.at(j)));
-
-			if (difference == 0)
-			{
-				MouseProfile::Gesture gesture;
-				gesture.action = NATIVE_GESTURE;
+			continue;
+		}
 
-				return gesture;
-			}
+		const GesturesTree &tree(iterator.value());
+		int contextDifference(lowestDifference);
+		int contextGesture(-1);
 
-			if (difference < lowestDifference)
-			{
-				bestGesture = {};
-				bestGesture.action = NATIVE_GESTURE;
+		matchTreeNode(tree, 0, 0, 0, contextDifference, contextGesture);
 
-				lowestDifference = difference;
-			}
+		if (contextGesture < 0 || contextDifference >= lowestDifference)
+		{
+			continue;
 		}
 
-		const QVector<MouseProfile::Gesture> gestures(m_gestures[m_contexts.at(i)]);
-
-		for (int j = 0; j < gestures.count(); ++j)
+		if (contextGesture < tree.nativeGesturesAmount)
 		{
-			const int difference(calculateGesturesDifference(gestures.at(j).steps));
-
-			if (difference == 0)
-			{
-				return gestures.at(j);
-			}
+			bestGesture = {};
+			bestGesture.action = NATIVE_GESTURE;
+		}
+		else
+		{
+			bestGesture = m_gestures[m_contexts.at(i)].at(contextGesture - tree.nativeGesturesAmount);
+		}
 
-			if (difference < lowestDifference)
-			{
-				bestGesture = gestures.at(j);
-				lowestDifference = difference;
-			}
+		if (contextDifference == 0)
+		{
+			return bestGesture;
 		}
+
+		lowestDifference = contextDifference;
 	}
 
 	return bestGesture;
@@ -887,55 +1012,41 @@ int GesturesManager::calculateLastMoveDistance(bool measureFinished)
 	return result;
 }
 
-int GesturesManager::calculateGesturesDifference(const QVector<MouseProfile::Gesture::Step> &steps)
+int GesturesManager::calculateStepDifference(const MouseProfile::Gesture::Step &matchedStep, const MouseProfile::Gesture::Step &recordedStep, bool isLast)
 {
-	if (m_steps.count() != steps.count())
-	{
-		return std::numeric_limits<int>::max();
-	}
-
 	int difference(0);
 
-	for (int i = 0; i < steps.count(); ++i)
+	if (isLast && matchedStep.type == QEvent::MouseButtonPress && recordedStep.type == QEvent::MouseButtonDblClick && matchedStep.button == recordedStep.button && matchedStep.modifiers == recordedStep.modifiers)
 	{
-		const MouseProfile::Gesture::Step matchedStep(steps.at(i));
-		const MouseProfile::Gesture::Step recordedStep(m_steps.at(i));
-		int stepDifference(0);
+		difference += 100;
+	}
 
-		if (i == (steps.count() - 1) && matchedStep.type == QEvent::MouseButtonPress && recordedStep.type == QEvent::MouseButtonDblClick && matchedStep.button == recordedStep.button && matchedStep.modifiers == recordedStep.modifiers)
+	if (recordedStep.type == matchedStep.type && (matchedStep.type == QEvent::MouseButtonPress || matchedStep.type == QEvent::MouseButtonRelease || matchedStep.type == QEvent::MouseButtonDblClick) && recordedStep.button == matchedStep.button && (recordedStep.modifiers | matchedStep.modifiers) == recordedStep.modifiers)
+	{
+		if (recordedStep.modifiers.testFlag(Qt::ControlModifier) && !matchedStep.modifiers.testFlag(Qt::ControlModifier))
 		{
-			stepDifference += 100;
+			difference += 8;
 		}
 
-		if (recordedStep.type == matchedStep.type && (matchedStep.type == QEvent::MouseButtonPress || matchedStep.type == QEvent::MouseButtonRelease || matchedStep.type == QEvent::MouseButtonDblClick) && recordedStep.button == matchedStep.button && (recordedStep.modifiers | matchedStep.modifiers) == recordedStep.modifiers)
+		if (recordedStep.modifiers.testFlag(Qt::ShiftModifier) && !matchedStep.modifiers.testFlag(Qt::ShiftModifier))
 		{
-			if (recordedStep.modifiers.testFlag(Qt::ControlModifier) && !matchedStep.modifiers.testFlag(Qt::ControlModifier))
-			{
-				stepDifference += 8;
-			}
-
-			if (recordedStep.modifiers.testFlag(Qt::ShiftModifier) && !matchedStep.modifiers.testFlag(Qt::ShiftModifier))
-			{
-				stepDifference += 4;
-			}
-
-			if (recordedStep.modifiers.testFlag(Qt::AltModifier) && !matchedStep.modifiers.testFlag(Qt::AltModifier))
-			{
-				stepDifference += 2;
-			}
+			difference += 4;
+		}
 
-			if (recordedStep.modifiers.testFlag(Qt::MetaModifier) && !matchedStep.modifiers.testFlag(Qt::MetaModifier))
-			{
-				stepDifference += 1;
-			}
+		if (recordedStep.modifiers.testFlag(Qt::AltModifier) && !matchedStep.modifiers.testFlag(Qt::AltModifier))
+		{
+			difference += 2;
 		}
 
-		if (stepDifference == 0 && matchedStep != recordedStep)
+		if (recordedStep.modifiers.testFlag(Qt::MetaModifier) && !matchedStep.modifiers.testFlag(Qt::MetaModifier))
 		{
-			return std::numeric_limits<int>::max();
+			difference += 1;
 		}
+	}
 
-		difference += stepDifference;
+	if (difference == 0 && matchedStep != recordedStep)
+	{
+		return -1;
 	}
 
 	return difference;
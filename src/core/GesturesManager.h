@@ -128,14 +128,31 @@ public:
 	static bool isTracking();
 
 protected:
+	struct GesturesTree final
+	{
+		struct Node final
+		{
+			MouseProfile::Gesture::Step step;
+			QVector<MouseGestures::ActionList> moves;
+			QVector<int> children;
+			QVector<int> gestures;
+		};
+
+		QVector<Node> nodes;
+		int nativeGesturesAmount = 0;
+	};
+
 	explicit GesturesManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
+	static void compileGestures();
+	static void addGestureToTree(GesturesTree &tree, const QVector<MouseProfile::Gesture::Step> &steps, int gesture, bool isNative);
+	static void matchTreeNode(const GesturesTree &tree, int node, int depth, int difference, int &lowestDifference, int &bestGesture);
 	static void recognizeMoveStep(const QInputEvent *event);
 	static void releaseTrackedObject();
 	static MouseProfile::Gesture matchGesture();
 	static int calculateLastMoveDistance(bool measureFinished = false);
-	static int calculateGesturesDifference(const QVector<MouseProfile::Gesture::Step> &steps);
+	static int calculateStepDifference(const MouseProfile::Gesture::Step &matchedStep, const MouseProfile::Gesture::Step &recordedStep, bool isLast);
 	static bool triggerAction(const MouseProfile::Gesture &gesture);
 	bool eventFilter(QObject *object, QEvent *event) override;
 
@@ -154,6 +171,7 @@ private:
 	static QVariantMap m_parameters;
 	static QHash<GesturesContext, QVector<MouseProfile::Gesture> > m_gestures;
 	static QHash<GesturesContext, QVector<QVector<MouseProfile::Gesture::Step> > > m_nativeGestures;
+	static QHash<GesturesContext, GesturesTree> m_gesturesTrees;
 	static QVector<MouseProfile::Gesture::Step> m_steps;
 	static QVector<QInputEvent*> m_events;
 	static QVector<GesturesContext> m_contexts;
@@ -0,0 +1,771 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryContentsIndex.h"
+#include "SessionsManager.h"
+#include "SettingsManager.h"
+#include "Tracer.h"
+#include "../ui/WebWidget.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QTimerEvent>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+HistoryContentsIndex* HistoryContentsIndex::m_instance(nullptr);
+
+HistoryContentsIndex::HistoryContentsIndex(QObject *parent) : QObject(parent),
+	m_path(SessionsManager::isReadOnly() ? QString() : SessionsManager::getWritableDataPath(QLatin1String("historyContents.dat"))),
+	m_snapshotDocumentsAmount(0),
+	m_pendingDocumentsAmount(0),
+	m_indexingTimer(0),
+	m_mergeTimer(0),
+	m_hasRemovedDocuments(false),
+	m_isEnabled(false),
+	m_isLoaded(false),
+	m_isLoading(false),
+	m_isMerging(false)
+{
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &HistoryContentsIndex::handleOptionChanged);
+	connect(&m_loadWatcher, &QFutureWatcher<IndexData>::finished, this, &HistoryContentsIndex::handleLoadFinished);
+	connect(&m_mergeWatcher, &QFutureWatcher<IndexData>::finished, this, &HistoryContentsIndex::handleMergeFinished);
+	connect(&m_termsWatcher, &QFutureWatcher<QStringList>::finished, this, &HistoryContentsIndex::handleTermsCreated);
+
+	handleOptionChanged(SettingsManager::History_EnableContentsIndexingOption, SettingsManager::getOption(SettingsManager::History_EnableContentsIndexingOption));
+}
+
+HistoryContentsIndex::~HistoryContentsIndex()
+{
+	m_termsWatcher.waitForFinished();
+	m_loadWatcher.waitForFinished();
+
+	if (m_isLoaded)
+	{
+		startMerge(true);
+	}
+
+	m_instance = nullptr;
+}
+
+void HistoryContentsIndex::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new HistoryContentsIndex(QCoreApplication::instance());
+	}
+}
+
+void HistoryContentsIndex::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_indexingTimer)
+	{
+		if (m_pendingWidgets.isEmpty())
+		{
+			killTimer(m_indexingTimer);
+
+			m_indexingTimer = 0;
+		}
+		else
+		{
+			indexNextPage();
+		}
+	}
+	else if (event->timerId() == m_mergeTimer)
+	{
+		killTimer(m_mergeTimer);
+
+		m_mergeTimer = 0;
+
+		startMerge(false);
+	}
+}
+
+void HistoryContentsIndex::scheduleIndexing(WebWidget *widget)
+{
+	if (!m_instance || !m_instance->m_isEnabled || !widget || widget->isPrivate())
+	{
+		return;
+	}
+
+	const QString scheme(widget->getUrl().scheme());
+
+	if ((scheme != QLatin1String("http") && scheme != QLatin1String("https")) || m_instance->m_pendingWidgets.contains(widget))
+	{
+		return;
+	}
+
+	m_instance->m_pendingWidgets.append(widget);
+
+	if (m_instance->m_indexingTimer == 0)
+	{
+		m_instance->m_indexingTimer = m_instance->startTimer(IndexingInterval);
+	}
+}
+
+void HistoryContentsIndex::indexNextPage()
+{
+	if (!m_isLoaded || m_termsWatcher.isRunning())
+	{
+		return;
+	}
+
+	while (!m_pendingWidgets.isEmpty())
+	{
+		WebWidget *widget(m_pendingWidgets.takeFirst());
+
+		if (!widget || widget->isPrivate() || widget->getLoadingState() != WebWidget::FinishedLoadingState)
+		{
+			continue;
+		}
+
+		const QUrl url(widget->getUrl());
+		const int position(m_documentsPositions.value(url, -1));
+
+		if (position >= 0 && (QDateTime::currentMSecsSinceEpoch() - m_documents.at(position).time) < (static_cast<qint64>(ReindexingPeriod) * 1000))
+		{
+			continue;
+		}
+
+		widget->requestDocumentText([=](const QString &text)
+		{
+			if (!m_instance || !m_instance->m_isEnabled || text.isEmpty() || m_instance->m_termsWatcher.isRunning())
+			{
+				return;
+			}
+
+			m_instance->m_termsUrl = url;
+			m_instance->m_termsWatcher.setFuture(QtConcurrent::run(&HistoryContentsIndex::createTerms, text.left(MaximumTextLength)));
+		});
+
+		return;
+	}
+}
+
+void HistoryContentsIndex::addDocument(const QUrl &url, const QStringList &terms)
+{
+	if (terms.isEmpty())
+	{
+		return;
+	}
+
+	const int previousPosition(m_documentsPositions.value(url, -1));
+
+	if (previousPosition >= 0)
+	{
+		m_documents[previousPosition].isRemoved = true;
+
+		m_hasRemovedDocuments = true;
+	}
+
+	const quint32 identifier(static_cast<quint32>(m_documents.count()));
+	Document document;
+	document.url = url;
+	document.time = QDateTime::currentMSecsSinceEpoch();
+
+	m_documents.append(document);
+	m_documentsPositions[url] = static_cast<int>(identifier);
+
+	for (int i = 0; i < terms.count(); ++i)
+	{
+		m_pendingPostings[terms.at(i)].append(identifier);
+	}
+
+	++m_pendingDocumentsAmount;
+
+	scheduleMerge();
+}
+
+void HistoryContentsIndex::clear(uint period)
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	m_instance->m_termsWatcher.waitForFinished();
+	m_instance->m_termsUrl = {};
+
+	if (m_instance->m_isLoading)
+	{
+		m_instance->m_loadWatcher.waitForFinished();
+		m_instance->handleLoadFinished();
+	}
+
+	if (m_instance->m_isMerging)
+	{
+		m_instance->m_mergeWatcher.waitForFinished();
+		m_instance->handleMergeFinished();
+	}
+
+	if (period == 0)
+	{
+		m_instance->m_documents.clear();
+		m_instance->m_documentsPositions.clear();
+		m_instance->m_postings.clear();
+		m_instance->m_pendingPostings.clear();
+		m_instance->m_pendingDocumentsAmount = 0;
+		m_instance->m_hasRemovedDocuments = false;
+
+		if (!m_instance->m_path.isEmpty())
+		{
+			QFile::remove(m_instance->m_path);
+		}
+
+		return;
+	}
+
+	const qint64 time(QDateTime::currentMSecsSinceEpoch() - (static_cast<qint64>(period) * 3600000));
+
+	for (int i = 0; i < m_instance->m_documents.count(); ++i)
+	{
+		Document &document(m_instance->m_documents[i]);
+
+		if (!document.isRemoved && document.time >= time)
+		{
+			document.isRemoved = true;
+
+			m_instance->m_documentsPositions.remove(document.url);
+			m_instance->m_hasRemovedDocuments = true;
+		}
+	}
+
+	if (m_instance->m_hasRemovedDocuments)
+	{
+		m_instance->startMerge(false);
+	}
+}
+
+void HistoryContentsIndex::scheduleMerge()
+{
+	if (m_pendingDocumentsAmount >= MergeThreshold)
+	{
+		startMerge(false);
+	}
+	else if (m_mergeTimer == 0)
+	{
+		m_mergeTimer = startTimer(MergeInterval);
+	}
+}
+
+void HistoryContentsIndex::startMerge(bool isBlocking)
+{
+	if (m_isMerging)
+	{
+		if (!isBlocking)
+		{
+			return;
+		}
+
+		m_mergeWatcher.waitForFinished();
+
+		handleMergeFinished();
+	}
+
+	if (m_pendingDocumentsAmount == 0 && !m_hasRemovedDocuments)
+	{
+		return;
+	}
+
+	if (m_mergeTimer != 0)
+	{
+		killTimer(m_mergeTimer);
+
+		m_mergeTimer = 0;
+	}
+
+	m_mergingPostings = m_pendingPostings;
+	m_snapshotDocumentsAmount = m_documents.count();
+	m_pendingPostings.clear();
+	m_pendingDocumentsAmount = 0;
+	m_hasRemovedDocuments = false;
+	m_isMerging = true;
+
+	m_mergeWatcher.setFuture(QtConcurrent::run(&HistoryContentsIndex::mergeIndex, m_documents, m_postings, m_mergingPostings, m_path));
+
+	if (isBlocking)
+	{
+		m_mergeWatcher.waitForFinished();
+
+		handleMergeFinished();
+	}
+}
+
+void HistoryContentsIndex::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier != SettingsManager::History_EnableContentsIndexingOption)
+	{
+		return;
+	}
+
+	m_isEnabled = value.toBool();
+
+	if (!m_isEnabled)
+	{
+		m_pendingWidgets.clear();
+
+		return;
+	}
+
+	if (!m_isLoaded && !m_isLoading)
+	{
+		m_isLoading = true;
+
+		m_loadWatcher.setFuture(QtConcurrent::run(&HistoryContentsIndex::loadIndex, m_path));
+	}
+}
+
+void HistoryContentsIndex::handleLoadFinished()
+{
+	if (!m_isLoading)
+	{
+		return;
+	}
+
+	const IndexData data(m_loadWatcher.result());
+
+	m_isLoading = false;
+	m_isLoaded = true;
+	m_documents = data.documents;
+	m_postings = data.postings;
+
+	for (int i = 0; i < m_documents.count(); ++i)
+	{
+		m_documentsPositions[m_documents.at(i).url] = i;
+	}
+}
+
+void HistoryContentsIndex::handleMergeFinished()
+{
+	if (!m_isMerging)
+	{
+		return;
+	}
+
+	const IndexData data(m_mergeWatcher.result());
+	const QVector<Document> documents(m_documents.mid(m_snapshotDocumentsAmount));
+	const quint32 offset(static_cast<quint32>(m_snapshotDocumentsAmount - data.documents.count()));
+
+	m_isMerging = false;
+	m_documents = data.documents + documents;
+	m_postings = data.postings;
+	m_mergingPostings.clear();
+	m_documentsPositions.clear();
+
+	QMap<QString, QVector<quint32> >::iterator iterator;
+
+	for (iterator = m_pendingPostings.begin(); iterator != m_pendingPostings.end(); ++iterator)
+	{
+		QVector<quint32> &postings(iterator.value());
+
+		for (int i = 0; i < postings.count(); ++i)
+		{
+			postings[i] -= offset;
+		}
+	}
+
+	for (int i = 0; i < m_documents.count(); ++i)
+	{
+		Document &document(m_documents[i]);
+
+		if (document.isRemoved)
+		{
+			continue;
+		}
+
+		const int previousPosition(m_documentsPositions.value(document.url, -1));
+
+		if (previousPosition >= 0)
+		{
+			m_documents[previousPosition].isRemoved = true;
+
+			m_hasRemovedDocuments = true;
+		}
+
+		m_documentsPositions[document.url] = i;
+	}
+
+	if (m_pendingDocumentsAmount > 0 || m_hasRemovedDocuments)
+	{
+		scheduleMerge();
+	}
+}
+
+void HistoryContentsIndex::handleTermsCreated()
+{
+	if (m_isEnabled && m_isLoaded && m_termsUrl.isValid())
+	{
+		addDocument(m_termsUrl, m_termsWatcher.result());
+	}
+}
+
+HistoryContentsIndex* HistoryContentsIndex::getInstance()
+{
+	return m_instance;
+}
+
+HistoryContentsIndex::IndexData HistoryContentsIndex::loadIndex(const QString &path)
+{
+	const Tracer::Span span("HistoryContentsIndex::loadIndex", "persistence");
+	IndexData data;
+	QFile file(path);
+
+	if (path.isEmpty() || !file.open(QIODevice::ReadOnly))
+	{
+		return data;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 version(0);
+	qint32 documentsAmount(0);
+
+	stream >> magicNumber >> version >> documentsAmount;
+
+	if (magicNumber != IndexMagicNumber || version != IndexFormatVersion || documentsAmount < 0)
+	{
+		return data;
+	}
+
+	data.documents.reserve(documentsAmount);
+
+	for (qint32 i = 0; i < documentsAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		Document document;
+
+		stream >> document.url >> document.time;
+
+		data.documents.append(document);
+	}
+
+	qint32 termsAmount(0);
+
+	stream >> termsAmount;
+
+	for (qint32 i = 0; i < termsAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString term;
+		QByteArray postings;
+
+		stream >> term >> postings;
+
+		data.postings.insert(term, postings);
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		return {};
+	}
+
+	return data;
+}
+
+HistoryContentsIndex::IndexData HistoryContentsIndex::mergeIndex(const QVector<Document> &documents, const QMap<QString, QByteArray> &postings, const QMap<QString, QVector<quint32> > &pendingPostings, const QString &path)
+{
+	const Tracer::Span span("HistoryContentsIndex::mergeIndex", "persistence");
+	IndexData data;
+	QVector<int> mapping(documents.count(), -1);
+
+	for (int i = 0; i < documents.count(); ++i)
+	{
+		if (!documents.at(i).isRemoved)
+		{
+			mapping[i] = data.documents.count();
+
+			data.documents.append(documents.at(i));
+		}
+	}
+
+	const auto remapPostings([&](const QVector<quint32> &source, QVector<quint32> &target)
+	{
+		for (int i = 0; i < source.count(); ++i)
+		{
+			const int position((source.at(i) < static_cast<quint32>(mapping.count())) ? mapping.at(static_cast<int>(source.at(i))) : -1);
+
+			if (position >= 0)
+			{
+				target.append(static_cast<quint32>(position));
+			}
+		}
+	});
+
+	QMap<QString, QByteArray>::const_iterator iterator;
+
+	for (iterator = postings.constBegin(); iterator != postings.constEnd(); ++iterator)
+	{
+		QVector<quint32> mergedPostings;
+
+		remapPostings(decodePostings(iterator.value()), mergedPostings);
+		remapPostings(pendingPostings.value(iterator.key()), mergedPostings);
+
+		if (!mergedPostings.isEmpty())
+		{
+			data.postings.insert(iterator.key(), encodePostings(mergedPostings));
+		}
+	}
+
+	QMap<QString, QVector<quint32> >::const_iterator pendingIterator;
+
+	for (pendingIterator = pendingPostings.constBegin(); pendingIterator != pendingPostings.constEnd(); ++pendingIterator)
+	{
+		if (postings.contains(pendingIterator.key()))
+		{
+			continue;
+		}
+
+		QVector<quint32> mergedPostings;
+
+		remapPostings(pendingIterator.value(), mergedPostings);
+
+		if (!mergedPostings.isEmpty())
+		{
+			data.postings.insert(pendingIterator.key(), encodePostings(mergedPostings));
+		}
+	}
+
+	if (path.isEmpty())
+	{
+		return data;
+	}
+
+	if (data.documents.isEmpty())
+	{
+		QFile::remove(path);
+
+		return data;
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return data;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(IndexMagicNumber) << static_cast<quint32>(IndexFormatVersion) << static_cast<qint32>(data.documents.count());
+
+	for (int i = 0; i < data.documents.count(); ++i)
+	{
+		stream << data.documents.at(i).url << data.documents.at(i).time;
+	}
+
+	stream << static_cast<qint32>(data.postings.count());
+
+	for (iterator = data.postings.constBegin(); iterator != data.postings.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << iterator.value();
+	}
+
+	file.commit();
+
+	return data;
+}
+
+QStringList HistoryContentsIndex::createTerms(const QString &text)
+{
+	QSet<QString> terms;
+	QString term;
+
+	for (int i = 0; i <= text.length(); ++i)
+	{
+		const QChar character((i < text.length()) ? text.at(i) : QChar());
+
+		if (character.isLetterOrNumber())
+		{
+			term.append(character.toLower());
+
+			continue;
+		}
+
+		if (term.length() >= MinimumTermLength && term.length() <= MaximumTermLength)
+		{
+			terms.insert(term);
+		}
+
+		term.clear();
+	}
+
+	return terms.values();
+}
+
+QByteArray HistoryContentsIndex::encodePostings(const QVector<quint32> &postings)
+{
+	QByteArray data;
+	data.reserve(postings.count() * 2);
+
+	quint32 previousIdentifier(0);
+
+	for (int i = 0; i < postings.count(); ++i)
+	{
+		quint32 value(postings.at(i) - previousIdentifier);
+
+		previousIdentifier = postings.at(i);
+
+		while (value >= 0x80)
+		{
+			data.append(static_cast<char>((value & 0x7F) | 0x80));
+
+			value >>= 7;
+		}
+
+		data.append(static_cast<char>(value));
+	}
+
+	return data;
+}
+
+QVector<quint32> HistoryContentsIndex::decodePostings(const QByteArray &data)
+{
+	QVector<quint32> postings;
+	quint32 identifier(0);
+	quint32 value(0);
+	int shift(0);
+
+	for (int i = 0; i < data.count(); ++i)
+	{
+		const quint8 byte(static_cast<quint8>(data.at(i)));
+
+		value |= (static_cast<quint32>(byte & 0x7F) << shift);
+
+		if (byte & 0x80)
+		{
+			shift += 7;
+
+			continue;
+		}
+
+		identifier += value;
+
+		postings.append(identifier);
+
+		value = 0;
+		shift = 0;
+	}
+
+	return postings;
+}
+
+QVector<QUrl> HistoryContentsIndex::findPages(const QString &query, int limit)
+{
+	if (!m_instance || !m_instance->m_isLoaded)
+	{
+		return {};
+	}
+
+	const QStringList terms(createTerms(query));
+
+	if (terms.isEmpty())
+	{
+		return {};
+	}
+
+	const Tracer::Span span("HistoryContentsIndex::findPages", "history");
+	QSet<quint32> identifiers;
+
+	for (int i = 0; i < terms.count(); ++i)
+	{
+		const QString &term(terms.at(i));
+		QSet<quint32> termIdentifiers;
+
+		for (QMap<QString, QByteArray>::const_iterator iterator(m_instance->m_postings.lowerBound(term)); iterator != m_instance->m_postings.constEnd() && iterator.key().startsWith(term); ++iterator)
+		{
+			const QVector<quint32> postings(decodePostings(iterator.value()));
+
+			for (int j = 0; j < postings.count(); ++j)
+			{
+				termIdentifiers.insert(postings.at(j));
+			}
+		}
+
+		const QVector<QMap<QString, QVector<quint32> >*> pendingPostings({&m_instance->m_mergingPostings, &m_instance->m_pendingPostings});
+
+		for (int j = 0; j < pendingPostings.count(); ++j)
+		{
+			for (QMap<QString, QVector<quint32> >::const_iterator iterator(pendingPostings.at(j)->lowerBound(term)); iterator != pendingPostings.at(j)->constEnd() && iterator.key().startsWith(term); ++iterator)
+			{
+				for (int k = 0; k < iterator.value().count(); ++k)
+				{
+					termIdentifiers.insert(iterator.value().at(k));
+				}
+			}
+		}
+
+		if (i == 0)
+		{
+			identifiers = termIdentifiers;
+		}
+		else
+		{
+			identifiers.intersect(termIdentifiers);
+		}
+
+		if (identifiers.isEmpty())
+		{
+			return {};
+		}
+	}
+
+	QVector<Document> documents;
+	documents.reserve(identifiers.count());
+
+	QSet<quint32>::const_iterator iterator;
+
+	for (iterator = identifiers.constBegin(); iterator != identifiers.constEnd(); ++iterator)
+	{
+		const quint32 identifier(*iterator);
+
+		if (identifier < static_cast<quint32>(m_instance->m_documents.count()) && !m_instance->m_documents.at(static_cast<int>(identifier)).isRemoved)
+		{
+			documents.append(m_instance->m_documents.at(static_cast<int>(identifier)));
+		}
+	}
+
+	std::sort(documents.begin(), documents.end(), [&](const Document &first, const Document &second)
+	{
+		return (first.time > second.time);
+	});
+
+	QVector<QUrl> urls;
+	urls.reserve((limit < 0) ? documents.count() : qMin(limit, documents.count()));
+
+	for (int i = 0; i < documents.count() && (limit < 0 || urls.count() < limit); ++i)
+	{
+		urls.append(documents.at(i).url);
+	}
+
+	return urls;
+}
+
+bool HistoryContentsIndex::isEnabled()
+{
+	return (m_instance && m_instance->m_isEnabled);
+}
+
+}
@@ -0,0 +1,126 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYCONTENTSINDEX_H
+#define OTTER_HISTORYCONTENTSINDEX_H
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QPointer>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class WebWidget;
+
+class HistoryContentsIndex final : public QObject
+{
+	Q_OBJECT
+
+public:
+	~HistoryContentsIndex();
+
+	static void createInstance();
+	static void scheduleIndexing(WebWidget *widget);
+	static void clear(uint period = 0);
+	static HistoryContentsIndex* getInstance();
+	static QVector<QUrl> findPages(const QString &query, int limit = -1);
+	static bool isEnabled();
+
+protected:
+	enum IndexFormat : quint32
+	{
+		IndexMagicNumber = 0x4F484349,
+		IndexFormatVersion = 1
+	};
+
+	enum IndexParameter
+	{
+		IndexingInterval = 2000,
+		MaximumTextLength = 65536,
+		MinimumTermLength = 2,
+		MaximumTermLength = 32,
+		MergeInterval = 60000,
+		MergeThreshold = 50,
+		ReindexingPeriod = 3600
+	};
+
+	struct Document final
+	{
+		QUrl url;
+		qint64 time = 0;
+		bool isRemoved = false;
+	};
+
+	struct IndexData final
+	{
+		QVector<Document> documents;
+		QMap<QString, QByteArray> postings;
+	};
+
+	explicit HistoryContentsIndex(QObject *parent);
+
+	void timerEvent(QTimerEvent *event) override;
+	void indexNextPage();
+	void addDocument(const QUrl &url, const QStringList &terms);
+	void scheduleMerge();
+	void startMerge(bool isBlocking);
+	static IndexData loadIndex(const QString &path);
+	static IndexData mergeIndex(const QVector<Document> &documents, const QMap<QString, QByteArray> &postings, const QMap<QString, QVector<quint32> > &pendingPostings, const QString &path);
+	static QStringList createTerms(const QString &text);
+	static QByteArray encodePostings(const QVector<quint32> &postings);
+	static QVector<quint32> decodePostings(const QByteArray &data);
+
+protected slots:
+	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleLoadFinished();
+	void handleMergeFinished();
+	void handleTermsCreated();
+
+private:
+	QVector<QPointer<WebWidget> > m_pendingWidgets;
+	QVector<Document> m_documents;
+	QHash<QUrl, int> m_documentsPositions;
+	QMap<QString, QByteArray> m_postings;
+	QMap<QString, QVector<quint32> > m_mergingPostings;
+	QMap<QString, QVector<quint32> > m_pendingPostings;
+	QFutureWatcher<IndexData> m_loadWatcher;
+	QFutureWatcher<IndexData> m_mergeWatcher;
+	QFutureWatcher<QStringList> m_termsWatcher;
+	QString m_path;
+	QUrl m_termsUrl;
+	int m_snapshotDocumentsAmount;
+	int m_pendingDocumentsAmount;
+	int m_indexingTimer;
+	int m_mergeTimer;
+	bool m_hasRemovedDocuments;
+	bool m_isEnabled;
+	bool m_isLoaded;
+	bool m_isLoading;
+	bool m_isMerging;
+
+	static HistoryContentsIndex *m_instance;
+};
+
+}
+
+#endif
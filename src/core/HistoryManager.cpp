@@ -21,12 +21,21 @@
 #include "HistoryManager.h"
 #include "AddonsManager.h"
 #include "Application.h"
+#include "BookmarksManager.h"
+#include "FaviconsManager.h"
+#include "HistoryContentsIndex.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "ThemesManager.h"
+#include "Tracer.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QSet>
 #include <QtCore/QTimerEvent>
 
+#include <cmath>
+
 namespace Otter
 {
 
@@ -36,14 +45,15 @@ HistoryModel* HistoryManager::m_typedHistoryModel(nullptr);
 bool HistoryManager::m_isEnabled(false);
 bool HistoryManager::m_isStoringFavicons(true);
 
-HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+HistoryManager::HistoryManager(QObject *parent) : QObject(parent)
 {
 	m_dayTimer = startTimer(QTime::currentTime().msecsTo(QTime(23, 59, 59, 999)));
 
 	handleOptionChanged(SettingsManager::History_RememberBrowsingOption);
 	handleOptionChanged(SettingsManager::History_StoreFaviconsOption);
 
+	PersistenceManager::registerTarget(this, &HistoryManager::save);
+
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &HistoryManager::handleOptionChanged);
 }
 
@@ -57,15 +67,7 @@ void HistoryManager::createInstance()
 
 void HistoryManager::timerEvent(QTimerEvent *event)
 {
-	if (event->timerId() == m_saveTimer)
-	{
-		killTimer(m_saveTimer);
-
-		m_saveTimer = 0;
-
-		save();
-	}
-	else if (event->timerId() == m_dayTimer)
+	if (event->timerId() == m_dayTimer)
 	{
 		killTimer(m_dayTimer);
 
@@ -94,34 +96,37 @@ void HistoryManager::timerEvent(QTimerEvent *event)
 
 void HistoryManager::scheduleSave()
 {
-	if (Application::isAboutToQuit())
-	{
-		if (m_saveTimer != 0)
-		{
-			killTimer(m_saveTimer);
+	PersistenceManager::markAsDirty(this);
+}
 
-			m_saveTimer = 0;
-		}
+bool HistoryManager::save(bool isBlocking)
+{
+	const Tracer::Span span("HistoryManager::save", "persistence");
+	bool isSaved(true);
 
-		save();
+	if (m_browsingHistoryModel && !m_browsingHistoryModel->flushJournal(isBlocking))
+	{
+		isSaved = false;
 	}
-	else if (m_saveTimer == 0)
+
+	if (m_typedHistoryModel && !m_typedHistoryModel->flushJournal(isBlocking))
 	{
-		m_saveTimer = startTimer(1000);
+		isSaved = false;
 	}
+
+	return isSaved;
 }
 
-void HistoryManager::save()
+double HistoryManager::calculateFrecency(int visits, const QDateTime &lastVisitTime, const QDateTime &currentTime)
 {
-	if (m_browsingHistoryModel)
+	if (!lastVisitTime.isValid())
 	{
-		m_browsingHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")));
+		return visits;
 	}
 
-	if (m_typedHistoryModel)
-	{
-		m_typedHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")));
-	}
+	const double age(qMax(qint64(0), lastVisitTime.secsTo(currentTime)) / 86400.0);
+
+	return (visits * std::pow(0.5, (age / 30)));
 }
 
 void HistoryManager::clearHistory(uint period)
@@ -138,6 +143,15 @@ void HistoryManager::clearHistory(uint period)
 
 	m_browsingHistoryModel->clearRecentEntries(period);
 	m_typedHistoryModel->clearRecentEntries(period);
+
+	HistoryContentsIndex::clear(period);
+
+	if (period == 0)
+	{
+		FaviconsManager::clearIcons();
+	}
+
+	m_instance->scheduleSave();
 }
 
 void HistoryManager::removeEntry(quint64 identifier)
@@ -192,15 +206,11 @@ void HistoryManager::updateEntry(quint64 identifier, const QUrl &url, const QStr
 		getBrowsingHistoryModel();
 	}
 
-	HistoryModel::Entry *entry(m_browsingHistoryModel->getEntry(identifier));
+	m_browsingHistoryModel->updateEntry(identifier, url, title, icon);
 
-	if (entry)
+	if (m_isStoringFavicons)
 	{
-		entry->setData(url, HistoryModel::UrlRole);
-		entry->setData(title, HistoryModel::TitleRole);
-		entry->setIcon(icon);
-
-		m_instance->scheduleSave();
+		FaviconsManager::setIcon(url, icon);
 	}
 }
 
@@ -261,7 +271,16 @@ HistoryModel* HistoryManager::getBrowsingHistoryModel()
 {
 	if (!m_browsingHistoryModel)
 	{
-		m_browsingHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")), HistoryModel::BrowsingHistory, m_instance);
+		const QString path(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat")));
+		const QString legacyPath(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")));
+		const bool needsImport(!QFile::exists(path) && QFile::exists(legacyPath));
+
+		m_browsingHistoryModel = new HistoryModel(path, HistoryModel::BrowsingHistory, m_instance);
+
+		if (needsImport)
+		{
+			m_browsingHistoryModel->importEntries(legacyPath);
+		}
 
 		connect(m_browsingHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
 	}
@@ -273,7 +292,16 @@ HistoryModel* HistoryManager::getTypedHistoryModel()
 {
 	if (!m_typedHistoryModel && m_instance)
 	{
-		m_typedHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")), HistoryModel::TypedHistory, m_instance);
+		const QString path(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.dat")));
+		const QString legacyPath(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")));
+		const bool needsImport(!QFile::exists(path) && QFile::exists(legacyPath));
+
+		m_typedHistoryModel = new HistoryModel(path, HistoryModel::TypedHistory, m_instance);
+
+		if (needsImport)
+		{
+			m_typedHistoryModel->importEntries(legacyPath);
+		}
 
 		connect(m_typedHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
 	}
@@ -293,11 +321,9 @@ QDateTime HistoryManager::getLastVisitTime(const QUrl &url)
 
 QIcon HistoryManager::getIcon(const QString &host)
 {
-	Q_UNUSED(host)
-
-///TODO
+	const QIcon icon(FaviconsManager::getIcon(host));
 
-	return ThemesManager::createIcon(QLatin1String("text-html"));
+	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : icon);
 }
 
 QIcon HistoryManager::getIcon(const QUrl &url)
@@ -322,12 +348,12 @@ QIcon HistoryManager::getIcon(const QUrl &url)
 		}
 	}
 
-///TODO
+	const QIcon icon(FaviconsManager::getIcon(url));
 
-	return ThemesManager::createIcon(QLatin1String("text-html"));
+	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : icon);
 }
 
-HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
+HistoryModel::Entry HistoryManager::getEntry(quint64 identifier)
 {
 	if (!m_browsingHistoryModel)
 	{
@@ -359,6 +385,90 @@ QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QStri
 	return entries;
 }
 
+QVector<HistoryManager::CompletionMatch> HistoryManager::findCompletions(const QString &prefix, CompletionSources sources, int limit, int timeBudget)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	const QDateTime currentTime(QDateTime::currentDateTimeUtc());
+	QVector<CompletionMatch> matches;
+
+	if (sources.testFlag(BookmarksSource))
+	{
+		const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::getModel()->findBookmarks(prefix, timer, timeBudget));
+
+		matches.reserve(bookmarks.count());
+
+		for (int i = 0; i < bookmarks.count(); ++i)
+		{
+			CompletionMatch match;
+			match.bookmark = bookmarks.at(i).bookmark;
+			match.match = bookmarks.at(i).match;
+			match.score = calculateFrecency((match.bookmark->getVisits() + 1), match.bookmark->getTimeVisited(), currentTime);
+
+			matches.append(match);
+		}
+	}
+
+	if (sources.testFlag(HistorySource) && (timeBudget < 0 || timer.elapsed() <= timeBudget))
+	{
+		if (!m_typedHistoryModel)
+		{
+			getTypedHistoryModel();
+		}
+
+		if (!m_browsingHistoryModel)
+		{
+			getBrowsingHistoryModel();
+		}
+
+		QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true, timer, timeBudget));
+		entries.append(m_browsingHistoryModel->findEntries(prefix, false, timer, timeBudget));
+
+		QSet<QUrl> urls;
+
+		matches.reserve(matches.count() + entries.count());
+
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			const QUrl url(entries.at(i).entry.getUrl());
+
+			if (urls.contains(url))
+			{
+				continue;
+			}
+
+			urls.insert(url);
+
+			CompletionMatch match;
+			match.entry = entries.at(i).entry;
+			match.match = entries.at(i).match;
+			match.score = calculateFrecency(entries.at(i).visits, entries.at(i).lastVisitTime, currentTime);
+			match.isTypedIn = entries.at(i).isTypedIn;
+
+			matches.append(match);
+		}
+	}
+
+	const auto comparator([&](const CompletionMatch &first, const CompletionMatch &second)
+	{
+		return (first.score > second.score);
+	});
+
+	if (limit >= 0 && matches.count() > limit)
+	{
+		std::partial_sort(matches.begin(), (matches.begin() + limit), matches.end(), comparator);
+
+		matches.resize(limit);
+	}
+	else
+	{
+		std::sort(matches.begin(), matches.end(), comparator);
+	}
+
+	return matches;
+}
+
 quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool isTypedIn)
 {
 	if (!m_isEnabled || !url.isValid() || !SettingsManager::getOption(SettingsManager::History_RememberBrowsingOption, Utils::extractHost(url)).toBool())
@@ -371,7 +481,7 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 		getBrowsingHistoryModel();
 	}
 
-	const quint64 identifier(m_browsingHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc())->getIdentifier());
+	const quint64 identifier(m_browsingHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc()).getIdentifier());
 
 	if (isTypedIn)
 	{
@@ -383,14 +493,11 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 		m_typedHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc());
 	}
 
-	const int limit(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
+	m_browsingHistoryModel->clearExcessEntries(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
 
-	if (limit > 0 && m_browsingHistoryModel->rowCount() > limit)
+	if (m_isStoringFavicons)
 	{
-		for (int i = (m_browsingHistoryModel->rowCount() - 1); i >= limit; --i)
-		{
-			m_browsingHistoryModel->removeEntry(m_browsingHistoryModel->index(i, 0).data(HistoryModel::IdentifierRole).toULongLong());
-		}
+		FaviconsManager::setIcon(url, icon);
 	}
 
 	return identifier;
@@ -411,4 +518,19 @@ bool HistoryManager::hasEntry(const QUrl &url)
 	return m_browsingHistoryModel->hasEntry(url);
 }
 
+bool HistoryManager::hasVisitedLink(const QString &url)
+{
+	if (!m_isEnabled)
+	{
+		return false;
+	}
+
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
+
+	return m_browsingHistoryModel->hasVisitedLink(url);
+}
+
 }
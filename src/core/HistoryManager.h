@@ -21,6 +21,7 @@
 #ifndef OTTER_HISTORYMANAGER_H
 #define OTTER_HISTORYMANAGER_H
 
+#include "BookmarksModel.h"
 #include "HistoryModel.h"
 
 #include <QtCore/QUrl>
@@ -34,6 +35,24 @@ class HistoryManager final : public QObject
 	Q_OBJECT
 
 public:
+	enum CompletionSource
+	{
+		NoSource = 0,
+		BookmarksSource = 1,
+		HistorySource = 2
+	};
+
+	Q_DECLARE_FLAGS(CompletionSources, CompletionSource)
+
+	struct CompletionMatch final
+	{
+		BookmarksModel::Bookmark *bookmark = nullptr;
+		HistoryModel::Entry entry;
+		QString match;
+		double score = 0;
+		bool isTypedIn = false;
+	};
+
 	static void createInstance();
 	static void clearHistory(uint period = 0);
 	static void removeEntry(quint64 identifier);
@@ -45,24 +64,26 @@ public:
 	static QDateTime getLastVisitTime(const QUrl &url);
 	static QIcon getIcon(const QString &host);
 	static QIcon getIcon(const QUrl &url);
-	static HistoryModel::Entry* getEntry(quint64 identifier);
+	static HistoryModel::Entry getEntry(quint64 identifier);
 	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false);
+	static QVector<CompletionMatch> findCompletions(const QString &prefix, CompletionSources sources, int limit, int timeBudget = -1);
 	static quint64 addEntry(const QUrl &url, const QString &title = {}, const QIcon &icon = {}, bool isTypedIn = false);
 	static bool hasEntry(const QUrl &url);
+	static bool hasVisitedLink(const QString &url);
 
 protected:
 	explicit HistoryManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
-	void save();
+	static double calculateFrecency(int visits, const QDateTime &lastVisitTime, const QDateTime &currentTime);
+	static bool save(bool isBlocking);
 
 protected slots:
 	void handleOptionChanged(int identifier);
 
 private:
 	int m_dayTimer;
-	int m_saveTimer;
 
 	static HistoryManager *m_instance;
 	static HistoryModel *m_browsingHistoryModel;
@@ -74,6 +95,8 @@ signals:
 	void dayChanged();
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(HistoryManager::CompletionSources)
+
 }
 
 #endif
@@ -20,125 +20,164 @@
 
 #include "HistoryModel.h"
 #include "Console.h"
-#include "JsonSettings.h"
+#include "FaviconsManager.h"
+#include "JsonWriter.h"
 #include "SessionsManager.h"
 #include "ThemesManager.h"
+#include "UrlsTable.h"
 #include "Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
 
 namespace Otter
 {
 
-HistoryModel::Entry::Entry() = default;
-
-void HistoryModel::Entry::setData(const QVariant &value, int role)
+HistoryModel::Entry::Entry(const HistoryModel *model, quint64 identifier) :
+	m_model(model),
+	m_identifier(identifier)
 {
-	if (model() && qobject_cast<HistoryModel*>(model()))
-	{
-		model()->setData(index(), value, role);
-	}
-	else
-	{
-		QStandardItem::setData(value, role);
-	}
-}
-
-void HistoryModel::Entry::setItemData(const QVariant &value, int role)
-{
-	QStandardItem::setData(value, role);
 }
 
 QString HistoryModel::Entry::getTitle() const
 {
-	return (data(TitleRole).isNull() ? QCoreApplication::translate("Otter::HistoryEntryItem", "(Untitled)") : data(TitleRole).toString());
+	const int slot(m_model ? m_model->getSlot(m_identifier) : -1);
+	const QString title((slot < 0) ? QString() : m_model->m_titlesPool.getValue(m_model->m_entryTitles.at(slot)));
+
+	return (title.isEmpty() ? QCoreApplication::translate("Otter::HistoryEntryItem", "(Untitled)") : title);
 }
 
 QUrl HistoryModel::Entry::getUrl() const
 {
-	return data(UrlRole).toUrl();
+	const int slot(m_model ? m_model->getSlot(m_identifier) : -1);
+
+	return ((slot < 0) ? QUrl() : m_model->m_urlsPool.getValue(m_model->m_entryUrls.at(slot)));
 }
 
 QDateTime HistoryModel::Entry::getTimeVisited() const
 {
-	return data(TimeVisitedRole).toDateTime();
+	const int slot(m_model ? m_model->getSlot(m_identifier) : -1);
+
+	return ((slot < 0) ? QDateTime() : QDateTime::fromMSecsSinceEpoch(m_model->m_entryTimes.at(slot), Qt::UTC));
 }
 
 QIcon HistoryModel::Entry::getIcon() const
 {
-	const QVariant iconData(data(Qt::DecorationRole));
+	QIcon icon(m_model ? m_model->m_icons.value(m_identifier) : QIcon());
+
+	if (icon.isNull() && m_model)
+	{
+		icon = FaviconsManager::getIcon(getUrl());
+	}
 
-	return (iconData.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : iconData.value<QIcon>());
+	return (icon.isNull() ? ThemesManager::createIcon(QLatin1String("text-html")) : icon);
 }
 
 quint64 HistoryModel::Entry::getIdentifier() const
 {
-	return data(IdentifierRole).toULongLong();
+	return m_identifier;
 }
 
-HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QStandardItemModel(parent),
-	m_type(type)
+bool HistoryModel::Entry::isValid() const
 {
-	QFile file(path);
+	return (m_model && m_model->getSlot(m_identifier) >= 0);
+}
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QAbstractListModel(parent),
+	m_journalPath(path),
+	m_type(type),
+	m_journalRecordsAmount(0),
+	m_isJournalEnabled(false),
+	m_isCompacting(false),
+	m_needsCompaction(false)
+{
+	if (!loadJournal())
 	{
-		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
-
-		return;
+		m_needsCompaction = true;
 	}
 
-	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
-
-	file.close();
+	m_isJournalEnabled = true;
 
-	for (int i = 0; i < historyArray.count(); ++i)
+	connect(FaviconsManager::getInstance(), &FaviconsManager::iconsDecoded, this, [&]()
 	{
-		const QJsonObject entryObject(historyArray.at(i).toObject());
-		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
-		dateTime.setTimeSpec(Qt::UTC);
-
-		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
-	}
+		if (rowCount() > 0)
+		{
+			emit dataChanged(index(0, 0), index((rowCount() - 1), 0), {Qt::DecorationRole});
+		}
+	});
+}
 
-	setSortRole(TimeVisitedRole);
-	sort(0, Qt::DescendingOrder);
+HistoryModel::~HistoryModel()
+{
+	flushJournal(true);
+	releaseUrls();
 }
 
 void HistoryModel::clearExcessEntries(int limit)
 {
-	if (limit > 0 && rowCount() > limit)
+	if (limit <= 0 || m_entryIdentifiers.count() <= limit)
 	{
-		for (int i = (rowCount() - 1); i >= limit; --i)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		return;
 	}
+
+	const int amount(m_entryIdentifiers.count() - limit);
+	QVector<quint64> identifiers;
+	identifiers.reserve(amount);
+
+	QMultiMap<qint64, quint64>::const_iterator iterator(m_timeIndex.constBegin());
+
+	for (int i = 0; i < amount && iterator != m_timeIndex.constEnd(); ++i, ++iterator)
+	{
+		identifiers.append(iterator.value());
+	}
+
+	removeEntries(identifiers);
 }
 
 void HistoryModel::clearRecentEntries(uint period)
 {
+	m_needsCompaction = true;
+
 	if (period == 0)
 	{
-		clear();
+		beginResetModel();
+
+		m_urlsIndex.clear();
+		m_visitedLinks.clear();
+		m_urlsPool.clear();
+		m_titlesPool.clear();
+		m_journalBuffer.clear();
+		m_entryIdentifiers.clear();
+		m_entryTimes.clear();
+		m_entryUrls.clear();
+		m_entryTitles.clear();
+		m_timeIndex.clear();
+		m_icons.clear();
+
+		releaseUrls();
+
+		m_journalRecordsAmount = 0;
 
-		m_urls.clear();
-		m_identifiers.clear();
+		endResetModel();
 
 		emit cleared();
 
 		return;
 	}
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
+	const qint64 currentTime(QDateTime::currentDateTimeUtc().toMSecsSinceEpoch());
+	QVector<quint64> identifiers;
+
+	for (QMultiMap<qint64, quint64>::const_iterator iterator(m_timeIndex.upperBound(currentTime - (static_cast<qint64>(period) * 3600000))); iterator != m_timeIndex.constEnd(); ++iterator)
 	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		identifiers.append(iterator.value());
 	}
+
+	removeEntries(identifiers);
 }
 
 void HistoryModel::clearOldestEntries(int period)
@@ -148,85 +187,289 @@ void HistoryModel::clearOldestEntries(int period)
 		return;
 	}
 
-	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QMultiMap<qint64, quint64>::const_iterator end(m_timeIndex.lowerBound(QDateTime(QDateTime::currentDateTimeUtc().date().addDays(-period), QTime(0, 0), Qt::UTC).toMSecsSinceEpoch()));
+	QVector<quint64> identifiers;
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
+	for (QMultiMap<qint64, quint64>::const_iterator iterator(m_timeIndex.constBegin()); iterator != end; ++iterator)
 	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().daysTo(currentDateTime) > period)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		identifiers.append(iterator.value());
 	}
+
+	removeEntries(identifiers);
 }
 
 void HistoryModel::removeEntry(quint64 identifier)
 {
-	Entry *entry(getEntry(identifier));
+	const int slot(getSlot(identifier));
+
+	if (slot < 0)
+	{
+		return;
+	}
+
+	emit entryRemoved(Entry(this, identifier));
+
+	const int row(m_entryIdentifiers.count() - slot - 1);
 
-	if (!entry)
+	beginRemoveRows({}, row, row);
+
+	removeUrl(identifier, m_urlsPool.getValue(m_entryUrls.at(slot)));
+	appendJournalRecord(RemoveRecord, slot);
+
+	m_timeIndex.remove(m_entryTimes.at(slot), identifier);
+	m_urlsPool.removeValue(m_entryUrls.at(slot));
+	m_titlesPool.removeValue(m_entryTitles.at(slot));
+	m_entryIdentifiers.remove(slot);
+	m_entryTimes.remove(slot);
+	m_entryUrls.remove(slot);
+	m_entryTitles.remove(slot);
+	m_icons.remove(identifier);
+
+	endRemoveRows();
+
+	emit modelModified();
+}
+
+void HistoryModel::removeEntries(const QVector<quint64> &identifiers)
+{
+	if (identifiers.count() < 2)
 	{
+		if (!identifiers.isEmpty())
+		{
+			removeEntry(identifiers.first());
+		}
+
 		return;
 	}
 
-	const QUrl url(Utils::normalizeUrl(entry->getUrl()));
+	QVector<quint64> removedIdentifiers(identifiers);
 
-	if (m_urls.contains(url))
+	std::sort(removedIdentifiers.begin(), removedIdentifiers.end());
+
+	beginResetModel();
+
+	int removedIndex(0);
+	int targetSlot(0);
+
+	for (int i = 0; i < m_entryIdentifiers.count(); ++i)
 	{
-		m_urls[url].removeAll(entry);
+		const quint64 identifier(m_entryIdentifiers.at(i));
+
+		while (removedIndex < removedIdentifiers.count() && removedIdentifiers.at(removedIndex) < identifier)
+		{
+			++removedIndex;
+		}
+
+		if (removedIndex < removedIdentifiers.count() && removedIdentifiers.at(removedIndex) == identifier)
+		{
+			removeUrl(identifier, m_urlsPool.getValue(m_entryUrls.at(i)));
+
+			m_timeIndex.remove(m_entryTimes.at(i), identifier);
+			m_urlsPool.removeValue(m_entryUrls.at(i));
+			m_titlesPool.removeValue(m_entryTitles.at(i));
+			m_icons.remove(identifier);
+
+			continue;
+		}
 
-		if (m_urls[url].isEmpty())
+		if (targetSlot != i)
 		{
-			m_urls.remove(url);
+			m_entryIdentifiers[targetSlot] = identifier;
+			m_entryTimes[targetSlot] = m_entryTimes.at(i);
+			m_entryUrls[targetSlot] = m_entryUrls.at(i);
+			m_entryTitles[targetSlot] = m_entryTitles.at(i);
 		}
+
+		++targetSlot;
+	}
+
+	m_entryIdentifiers.resize(targetSlot);
+	m_entryTimes.resize(targetSlot);
+	m_entryUrls.resize(targetSlot);
+	m_entryTitles.resize(targetSlot);
+
+	m_needsCompaction = true;
+
+	endResetModel();
+
+	emit entriesRemoved();
+	emit modelModified();
+}
+
+void HistoryModel::updateEntry(quint64 identifier, const QUrl &url, const QString &title, const QIcon &icon)
+{
+	const int slot(getSlot(identifier));
+
+	if (slot < 0)
+	{
+		return;
 	}
 
-	if (identifier > 0 && m_identifiers.contains(identifier))
+	const QUrl oldUrl(m_urlsPool.getValue(m_entryUrls.at(slot)));
+
+	if (url != oldUrl)
 	{
-		m_identifiers.remove(identifier);
+		removeUrl(identifier, oldUrl);
+		addUrl(identifier, url);
+
+		const quint32 urlIdentifier(m_urlsPool.addValue(url));
+
+		m_urlsPool.removeValue(m_entryUrls.at(slot));
+
+		m_entryUrls[slot] = urlIdentifier;
 	}
 
-	emit entryRemoved(entry);
+	if (title != m_titlesPool.getValue(m_entryTitles.at(slot)))
+	{
+		const quint32 titleIdentifier(m_titlesPool.addValue(title));
 
-	removeRow(entry->row());
+		m_titlesPool.removeValue(m_entryTitles.at(slot));
+
+		m_entryTitles[slot] = titleIdentifier;
+	}
 
+	if (icon.isNull())
+	{
+		m_icons.remove(identifier);
+	}
+	else
+	{
+		m_icons[identifier] = icon;
+	}
+
+	appendJournalRecord(EntryRecord, slot);
+
+	const QModelIndex index(this->index(m_entryIdentifiers.count() - slot - 1));
+
+	emit dataChanged(index, index);
+	emit entryModified(Entry(this, identifier));
 	emit modelModified();
 }
 
-HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date, quint64 identifier)
+void HistoryModel::addUrl(quint64 identifier, const QUrl &url)
 {
-	blockSignals(true);
+	const quint64 urlIdentifier(UrlsTable::retainUrl(url));
 
-	if (m_type == TypedHistory)
+	if (urlIdentifier == 0)
 	{
-		if (hasEntry(url))
-		{
-			const QUrl normalizedUrl(Utils::normalizeUrl(url));
+		return;
+	}
 
-			for (int i = 0; i < m_urls[normalizedUrl].count(); ++i)
-			{
-				removeEntry(m_urls[normalizedUrl].at(i)->getIdentifier());
-			}
+	if (m_urls.contains(urlIdentifier))
+	{
+		UrlsTable::releaseUrl(urlIdentifier);
+	}
+	else
+	{
+		m_urls[urlIdentifier] = {};
+
+		m_urlsIndex.addUrl(UrlsTable::getUrl(urlIdentifier));
+	}
+
+	m_urls[urlIdentifier].append(identifier);
+
+	m_visitedLinks.addUrl(url);
+}
+
+void HistoryModel::removeUrl(quint64 identifier, const QUrl &url)
+{
+	const quint64 urlIdentifier(UrlsTable::getIdentifier(url));
+
+	if (urlIdentifier == 0 || !m_urls.contains(urlIdentifier))
+	{
+		return;
+	}
+
+	m_urls[urlIdentifier].removeAll(identifier);
+
+	m_visitedLinks.removeUrl(url);
+
+	if (m_urls[urlIdentifier].isEmpty())
+	{
+		m_urls.remove(urlIdentifier);
+
+		m_urlsIndex.removeUrl(UrlsTable::getUrl(urlIdentifier));
+
+		UrlsTable::releaseUrl(urlIdentifier);
+	}
+}
+
+void HistoryModel::releaseUrls()
+{
+	QHash<quint64, QVector<quint64> >::const_iterator iterator;
+
+	for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+	{
+		UrlsTable::releaseUrl(iterator.key());
+	}
+
+	m_urls.clear();
+}
+
+void HistoryModel::appendJournalRecord(JournalRecordType type, int slot)
+{
+	if (!m_isJournalEnabled)
+	{
+		return;
+	}
+
+	QDataStream stream(&m_journalBuffer, (QIODevice::WriteOnly | QIODevice::Append));
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	writeJournalRecord(stream, type, slot);
+
+	++m_journalRecordsAmount;
+}
+
+void HistoryModel::writeJournalRecord(QDataStream &stream, JournalRecordType type, int slot) const
+{
+	stream << static_cast<quint8>(type) << m_entryIdentifiers.at(slot);
+
+	if (type == EntryRecord)
+	{
+		stream << m_urlsPool.getValue(m_entryUrls.at(slot)).toString() << m_titlesPool.getValue(m_entryTitles.at(slot)) << m_entryTimes.at(slot);
+	}
+}
+
+HistoryModel::Entry HistoryModel::addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date, quint64 identifier)
+{
+	if (m_type == TypedHistory && hasEntry(url))
+	{
+		const QVector<quint64> identifiers(m_urls.value(UrlsTable::getIdentifier(url)));
+
+		for (int i = 0; i < identifiers.count(); ++i)
+		{
+			removeEntry(identifiers.at(i));
 		}
 	}
 
-	Entry *entry(new Entry());
-	entry->setIcon(icon);
+	if (identifier == 0 || getSlot(identifier) >= 0)
+	{
+		identifier = (m_entryIdentifiers.isEmpty() ? 1 : (m_entryIdentifiers.last() + 1));
+	}
+
+	const int slot(static_cast<int>(std::lower_bound(m_entryIdentifiers.constBegin(), m_entryIdentifiers.constEnd(), identifier) - m_entryIdentifiers.constBegin()));
+	const int row(m_entryIdentifiers.count() - slot);
 
-	insertRow(0, entry);
-	setData(entry->index(), url, UrlRole);
-	setData(entry->index(), title, TitleRole);
-	setData(entry->index(), date, TimeVisitedRole);
+	beginInsertRows({}, row, row);
 
-	if (identifier == 0 || m_identifiers.contains(identifier))
+	m_entryIdentifiers.insert(slot, identifier);
+	m_entryTimes.insert(slot, date.toMSecsSinceEpoch());
+	m_entryUrls.insert(slot, m_urlsPool.addValue(url));
+	m_entryTitles.insert(slot, m_titlesPool.addValue(title));
+	m_timeIndex.insert(date.toMSecsSinceEpoch(), identifier);
+
+	if (!icon.isNull())
 	{
-		identifier = (m_identifiers.isEmpty() ? 1 : (m_identifiers.lastKey() + 1));
+		m_icons[identifier] = icon;
 	}
 
-	setData(entry->index(), identifier, IdentifierRole);
+	addUrl(identifier, url);
+	appendJournalRecord(EntryRecord, slot);
 
-	m_identifiers[identifier] = entry;
+	endInsertRows();
 
-	blockSignals(false);
+	const Entry entry(this, identifier);
 
 	emit entryAdded(entry);
 	emit modelModified();
@@ -234,176 +477,398 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 	return entry;
 }
 
-HistoryModel::Entry* HistoryModel::getEntry(quint64 identifier) const
+HistoryModel::Entry HistoryModel::getEntry(quint64 identifier) const
 {
-	if (m_identifiers.contains(identifier))
+	return ((getSlot(identifier) < 0) ? Entry() : Entry(this, identifier));
+}
+
+QVariant HistoryModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() < 0 || index.row() >= m_entryIdentifiers.count())
+	{
+		return {};
+	}
+
+	const int slot(m_entryIdentifiers.count() - index.row() - 1);
+
+	switch (role)
 	{
-		return m_identifiers[identifier];
+		case TitleRole:
+			return m_titlesPool.getValue(m_entryTitles.at(slot));
+		case UrlRole:
+			return m_urlsPool.getValue(m_entryUrls.at(slot));
+		case IdentifierRole:
+			return m_entryIdentifiers.at(slot);
+		case TimeVisitedRole:
+			return QDateTime::fromMSecsSinceEpoch(m_entryTimes.at(slot), Qt::UTC);
+		case Qt::DecorationRole:
+			{
+				const QIcon icon(m_icons.value(m_entryIdentifiers.at(slot)));
+
+				return (icon.isNull() ? FaviconsManager::getIcon(m_urlsPool.getValue(m_entryUrls.at(slot))) : icon);
+			}
+		default:
+			break;
 	}
 
-	return nullptr;
+	return {};
 }
 
 QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const QVector<quint64> identifiers(m_urls.value(UrlsTable::getIdentifier(url)));
+	qint64 lastVisitTime(-1);
 
-	if (!m_urls.contains(normalizedUrl))
+	for (int i = 0; i < identifiers.count(); ++i)
 	{
-		return {};
+		const int slot(getSlot(identifiers.at(i)));
+
+		if (slot >= 0 && m_entryTimes.at(slot) > lastVisitTime)
+		{
+			lastVisitTime = m_entryTimes.at(slot);
+		}
 	}
 
-	const QVector<Entry*> entries(m_urls.value(normalizedUrl));
-	QDateTime lastVisitTime;
+	return ((lastVisitTime < 0) ? QDateTime() : QDateTime::fromMSecsSinceEpoch(lastVisitTime, Qt::UTC));
+}
 
-	for (int i = 0; i < entries.count(); ++i)
+QVector<quint64> HistoryModel::getEntries(const QDateTime &from, const QDateTime &to) const
+{
+	const QMultiMap<qint64, quint64>::const_iterator begin(from.isValid() ? m_timeIndex.lowerBound(from.toMSecsSinceEpoch()) : m_timeIndex.constBegin());
+	QMultiMap<qint64, quint64>::const_iterator iterator(to.isValid() ? m_timeIndex.lowerBound(to.toMSecsSinceEpoch()) : m_timeIndex.constEnd());
+	QVector<quint64> identifiers;
+
+	while (iterator != begin)
 	{
-		const QDateTime entryLastVisitTime(entries.at(i)->getTimeVisited());
+		--iterator;
+
+		identifiers.append(iterator.value());
+	}
+
+	return identifiers;
+}
 
-		if (!lastVisitTime.isValid() || entryLastVisitTime > lastVisitTime)
+QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn, const QElapsedTimer &timer, int timeBudget) const
+{
+	const QVector<UrlCompletionIndex::UrlMatch> urlMatches(m_urlsIndex.findUrls(prefix, timer, timeBudget));
+	QVector<HistoryEntryMatch> matches;
+	matches.reserve(urlMatches.count());
+
+	for (int i = 0; i < urlMatches.count(); ++i)
+	{
+		const QVector<quint64> identifiers(m_urls.value(UrlsTable::getIdentifier(urlMatches.at(i).url)));
+		const int slot(identifiers.isEmpty() ? -1 : getSlot(identifiers.last()));
+
+		if (slot < 0)
 		{
-			lastVisitTime = entryLastVisitTime;
+			continue;
 		}
+
+		HistoryEntryMatch match;
+		match.entry = Entry(this, identifiers.at(0));
+		match.match = urlMatches.at(i).match;
+		match.lastVisitTime = QDateTime::fromMSecsSinceEpoch(m_entryTimes.at(slot), Qt::UTC);
+		match.visits = identifiers.count();
+		match.isTypedIn = markAsTypedIn;
+
+		matches.append(match);
 	}
 
-	return lastVisitTime;
+	std::sort(matches.begin(), matches.end(), [&](const HistoryEntryMatch &first, const HistoryEntryMatch &second)
+	{
+		return (first.lastVisitTime > second.lastVisitTime);
+	});
+
+	return matches;
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
+HistoryModel::HistoryType HistoryModel::getType() const
 {
-	QVector<Entry*> matchedEntries;
-	QVector<HistoryEntryMatch> allMatches;
-	QVector<HistoryEntryMatch> currentMatches;
-	QMultiMap<QDateTime, HistoryEntryMatch> matchesMap;
-	QHash<QUrl, QVector<Entry*> >::const_iterator urlsIterator;
+	return m_type;
+}
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+bool HistoryModel::writeJournal(const QString &path, const QByteArray &data, bool isAppending)
+{
+	if (isAppending)
 	{
-		if (urlsIterator.value().isEmpty() || matchedEntries.contains(urlsIterator.value().value(0)))
+		QFile file(path);
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
 		{
-			continue;
+			return false;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		return (file.write(data) == data.size() && file.flush());
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	if (file.write(data) != data.size())
+	{
+		file.cancelWriting();
+
+		return false;
+	}
+
+	return file.commit();
+}
+
+bool HistoryModel::loadJournal()
+{
+	QFile file(m_journalPath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+
+	stream >> magicNumber >> formatVersion;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != JournalMagicNumber || formatVersion != JournalFormatVersion)
+	{
+		Console::addMessage(tr("Failed to load history file: unsupported format"), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
+
+		return false;
+	}
 
-		if (!result.isEmpty())
+	while (!stream.atEnd())
+	{
+		quint8 type(UnknownRecord);
+		quint64 identifier(0);
+
+		stream >> type >> identifier;
+
+		if (type == EntryRecord)
 		{
-			HistoryEntryMatch match;
-			match.entry = urlsIterator.value().value(0);
-			match.match = result;
+			QString url;
+			QString title;
+			qint64 timeVisited(0);
 
-			if (markAsTypedIn)
+			stream >> url >> title >> timeVisited;
+
+			if (stream.status() != QDataStream::Ok)
 			{
-				match.isTypedIn = true;
+				break;
 			}
 
-			matchesMap.insert(match.entry->data(TimeVisitedRole).toDateTime(), match);
+			if (getSlot(identifier) >= 0)
+			{
+				updateEntry(identifier, QUrl(url), title);
+			}
+			else
+			{
+				addEntry(QUrl(url), title, {}, QDateTime::fromMSecsSinceEpoch(timeVisited, Qt::UTC), identifier);
+			}
+		}
+		else if (type == RemoveRecord && stream.status() == QDataStream::Ok)
+		{
+			removeEntry(identifier);
+		}
+		else
+		{
+			stream.setStatus(QDataStream::ReadCorruptData);
 
-			matchedEntries.append(match.entry);
+			break;
 		}
+
+		++m_journalRecordsAmount;
 	}
 
-	currentMatches = matchesMap.values().toVector();
+	if (stream.status() != QDataStream::Ok)
+	{
+		Console::addMessage(tr("History file is damaged, trailing records were discarded"), Console::OtherCategory, Console::WarningLevel, m_journalPath);
 
-	matchesMap.clear();
+		m_needsCompaction = true;
+	}
 
-	allMatches.reserve(currentMatches.count());
+	return true;
+}
+
+bool HistoryModel::importEntries(const QString &path)
+{
+	QFile file(path);
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
 	{
-		allMatches.append(currentMatches.at(i));
+		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
 	}
 
-	return allMatches;
-}
+	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
 
-HistoryModel::HistoryType HistoryModel::getType() const
-{
-	return m_type;
+	file.close();
+
+	const bool isJournalEnabled(m_isJournalEnabled);
+
+	m_isJournalEnabled = false;
+
+	for (int i = 0; i < historyArray.count(); ++i)
+	{
+		const QJsonObject entryObject(historyArray.at(i).toObject());
+		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
+		dateTime.setTimeSpec(Qt::UTC);
+
+		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
+	}
+
+	m_isJournalEnabled = isJournalEnabled;
+	m_needsCompaction = true;
+
+	return true;
 }
 
-bool HistoryModel::save(const QString &path) const
+bool HistoryModel::exportEntries(const QString &path) const
 {
-	if (SessionsManager::isReadOnly())
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
 	{
 		return false;
 	}
 
-	QJsonArray historyArray;
+	JsonWriter writer(&file);
+	writer.writeStartArray();
 
-	for (int i = 0; i < rowCount(); ++i)
+	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		const QModelIndex index(this->index(i, 0));
 
 		if (index.isValid())
 		{
-			historyArray.prepend(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
+			writer.writeValue(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
 		}
 	}
 
-	JsonSettings settings;
-	settings.setArray(historyArray);
+	writer.writeEndArray();
 
-	return settings.save(path);
+	return (!writer.hasError() && file.commit());
 }
 
-bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int role)
+bool HistoryModel::flushJournal(bool isBlocking)
 {
-	Entry *entry(static_cast<Entry*>(itemFromIndex(index)));
+	if (m_isCompacting)
+	{
+		if (!isBlocking && m_compactionFuture.isRunning())
+		{
+			return false;
+		}
+
+		m_compactionFuture.waitForFinished();
 
-	if (!entry)
+		m_isCompacting = false;
+
+		if (!m_compactionFuture.result())
+		{
+			Console::addMessage(tr("Failed to save history file"), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
+
+			m_needsCompaction = true;
+		}
+	}
+
+	if (SessionsManager::isReadOnly() || m_journalPath.isEmpty())
 	{
-		return QStandardItemModel::setData(index, value, role);
+		m_journalBuffer.clear();
+
+		return true;
 	}
 
-	if (role == UrlRole && value.toUrl() != index.data(UrlRole).toUrl())
+	if (m_needsCompaction || m_journalRecordsAmount > ((rowCount() * 2) + 1000))
 	{
-		const QUrl oldUrl(Utils::normalizeUrl(index.data(UrlRole).toUrl()));
-		const QUrl newUrl(Utils::normalizeUrl(value.toUrl()));
+		QByteArray data;
+		QDataStream stream(&data, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_6);
+		stream << static_cast<quint32>(JournalMagicNumber) << static_cast<quint32>(JournalFormatVersion);
 
-		if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
+		for (int i = 0; i < m_entryIdentifiers.count(); ++i)
 		{
-			m_urls[oldUrl].removeAll(entry);
-
-			if (m_urls[oldUrl].isEmpty())
-			{
-				m_urls.remove(oldUrl);
-			}
+			writeJournalRecord(stream, EntryRecord, i);
 		}
 
-		if (!newUrl.isEmpty())
+		m_journalBuffer.clear();
+
+		m_journalRecordsAmount = rowCount();
+		m_needsCompaction = false;
+
+		if (isBlocking)
 		{
-			if (!m_urls.contains(newUrl))
+			if (!writeJournal(m_journalPath, data, false))
 			{
-				m_urls[newUrl] = QVector<Entry*>();
+				Console::addMessage(tr("Failed to save history file"), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
+
+				m_needsCompaction = true;
 			}
 
-			m_urls[newUrl].append(entry);
+			return true;
 		}
-	}
 
-	entry->setItemData(value, role);
+		m_compactionFuture = QtConcurrent::run(&HistoryModel::writeJournal, m_journalPath, data, false);
+		m_isCompacting = true;
 
-	switch (role)
+		return true;
+	}
+
+	if (!m_journalBuffer.isEmpty())
 	{
-		case TitleRole:
-		case UrlRole:
-		case IdentifierRole:
-		case TimeVisitedRole:
-			emit entryModified(entry);
-			emit modelModified();
+		if (!writeJournal(m_journalPath, m_journalBuffer, true))
+		{
+			Console::addMessage(tr("Failed to save history file"), Console::OtherCategory, Console::ErrorLevel, m_journalPath);
 
-			break;
-		default:
-			break;
+			m_needsCompaction = true;
+		}
+
+		m_journalBuffer.clear();
 	}
 
 	return true;
 }
 
+int HistoryModel::getSlot(quint64 identifier) const
+{
+	const QVector<quint64>::const_iterator iterator(std::lower_bound(m_entryIdentifiers.constBegin(), m_entryIdentifiers.constEnd(), identifier));
+
+	return ((iterator == m_entryIdentifiers.constEnd() || *iterator != identifier) ? -1 : static_cast<int>(iterator - m_entryIdentifiers.constBegin()));
+}
+
+int HistoryModel::getEntriesAmount(const QDateTime &from, const QDateTime &to) const
+{
+	QMultiMap<qint64, quint64>::const_iterator iterator(from.isValid() ? m_timeIndex.lowerBound(from.toMSecsSinceEpoch()) : m_timeIndex.constBegin());
+	const QMultiMap<qint64, quint64>::const_iterator end(to.isValid() ? m_timeIndex.lowerBound(to.toMSecsSinceEpoch()) : m_timeIndex.constEnd());
+	int amount(0);
+
+	while (iterator != end)
+	{
+		++iterator;
+		++amount;
+	}
+
+	return amount;
+}
+
+int HistoryModel::rowCount(const QModelIndex &index) const
+{
+	return (index.isValid() ? 0 : m_entryIdentifiers.count());
+}
+
 bool HistoryModel::hasEntry(const QUrl &url) const
 {
-	return m_urls.contains(Utils::normalizeUrl(url));
+	return m_urls.contains(UrlsTable::getIdentifier(url));
+}
+
+bool HistoryModel::hasVisitedLink(const QString &url) const
+{
+	return m_visitedLinks.contains(url);
 }
 
 }
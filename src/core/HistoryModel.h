@@ -21,14 +21,21 @@
 #ifndef OTTER_HISTORYMODEL_H
 #define OTTER_HISTORYMODEL_H
 
+#include "UrlCompletionIndex.h"
+#include "VisitedLinksSet.h"
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QFuture>
+#include <QtCore/QMap>
 #include <QtCore/QUrl>
-#include <QtGui/QStandardItemModel>
+#include <QtGui/QIcon>
 
 namespace Otter
 {
 
-class HistoryModel final : public QStandardItemModel
+class HistoryModel final : public QAbstractListModel
 {
 	Q_OBJECT
 
@@ -47,55 +54,189 @@ public:
 		TypedHistory
 	};
 
-	class Entry final : public QStandardItem
+	class Entry final
 	{
 	public:
-		void setData(const QVariant &value, int role) override;
-		void setItemData(const QVariant &value, int role);
+		Entry() = default;
+
 		QString getTitle() const;
 		QUrl getUrl() const;
 		QDateTime getTimeVisited() const;
 		QIcon getIcon() const;
 		quint64 getIdentifier() const;
+		bool isValid() const;
 
 	protected:
-		explicit Entry();
+		explicit Entry(const HistoryModel *model, quint64 identifier);
+
+	private:
+		const HistoryModel *m_model = nullptr;
+		quint64 m_identifier = 0;
 
 	friend class HistoryModel;
 	};
 
 	struct HistoryEntryMatch final
 	{
-		Entry *entry = nullptr;
+		Entry entry;
 		QString match;
+		QDateTime lastVisitTime;
+		int visits = 0;
 		bool isTypedIn = false;
 	};
 
 	explicit HistoryModel(const QString &path, HistoryType type, QObject *parent = nullptr);
+	~HistoryModel();
 
 	void clearExcessEntries(int limit);
 	void clearRecentEntries(uint period);
 	void clearOldestEntries(int period);
 	void removeEntry(quint64 identifier);
-	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
-	Entry* getEntry(quint64 identifier) const;
+	void updateEntry(quint64 identifier, const QUrl &url, const QString &title, const QIcon &icon = {});
+	Entry addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
+	Entry getEntry(quint64 identifier) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 	QDateTime getLastVisitTime(const QUrl &url) const;
-	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	QVector<quint64> getEntries(const QDateTime &from, const QDateTime &to) const;
+	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false, const QElapsedTimer &timer = {}, int timeBudget = -1) const;
 	HistoryType getType() const;
+	int getEntriesAmount(const QDateTime &from, const QDateTime &to) const;
+	int rowCount(const QModelIndex &index = {}) const override;
 	bool hasEntry(const QUrl &url) const;
-	bool save(const QString &path) const;
-	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+	bool hasVisitedLink(const QString &url) const;
+	bool importEntries(const QString &path);
+	bool exportEntries(const QString &path) const;
+	bool flushJournal(bool isBlocking = false);
+
+protected:
+	enum JournalFormat : quint32
+	{
+		JournalMagicNumber = 0x4F48494A,
+		JournalFormatVersion = 1
+	};
+
+	enum JournalRecordType : quint8
+	{
+		UnknownRecord = 0,
+		EntryRecord,
+		RemoveRecord
+	};
+
+	template<typename T>
+	class ValuesPool final
+	{
+	public:
+		quint32 addValue(const T &value)
+		{
+			const typename QHash<T, quint32>::const_iterator iterator(m_identifiers.constFind(value));
+
+			if (iterator != m_identifiers.constEnd())
+			{
+				++m_references[static_cast<int>(iterator.value())];
+
+				return iterator.value();
+			}
+
+			quint32 identifier(0);
+
+			if (m_freeIdentifiers.isEmpty())
+			{
+				identifier = static_cast<quint32>(m_values.count());
+
+				m_values.append(value);
+				m_references.append(1);
+			}
+			else
+			{
+				identifier = m_freeIdentifiers.takeLast();
+
+				m_values[static_cast<int>(identifier)] = value;
+				m_references[static_cast<int>(identifier)] = 1;
+			}
+
+			m_identifiers.insert(value, identifier);
+
+			return identifier;
+		}
+
+		void removeValue(quint32 identifier)
+		{
+			const int index(static_cast<int>(identifier));
+
+			if (index >= m_references.count() || m_references.at(index) == 0)
+			{
+				return;
+			}
+
+			--m_references[index];
+
+			if (m_references.at(index) == 0)
+			{
+				m_identifiers.remove(m_values.at(index));
+
+				m_values[index] = T();
+
+				m_freeIdentifiers.append(identifier);
+			}
+		}
+
+		void clear()
+		{
+			m_values.clear();
+			m_references.clear();
+			m_freeIdentifiers.clear();
+			m_identifiers.clear();
+		}
+
+		const T& getValue(quint32 identifier) const
+		{
+			return m_values.at(static_cast<int>(identifier));
+		}
+
+	private:
+		QVector<T> m_values;
+		QVector<quint32> m_references;
+		QVector<quint32> m_freeIdentifiers;
+		QHash<T, quint32> m_identifiers;
+	};
+
+	void addUrl(quint64 identifier, const QUrl &url);
+	void removeUrl(quint64 identifier, const QUrl &url);
+	void removeEntries(const QVector<quint64> &identifiers);
+	void releaseUrls();
+	void appendJournalRecord(JournalRecordType type, int slot);
+	void writeJournalRecord(QDataStream &stream, JournalRecordType type, int slot) const;
+	static bool writeJournal(const QString &path, const QByteArray &data, bool isAppending);
+	int getSlot(quint64 identifier) const;
+	bool loadJournal();
 
 private:
-	QHash<QUrl, QVector<Entry*> > m_urls;
-	QMap<quint64, Entry*> m_identifiers;
+	UrlCompletionIndex m_urlsIndex;
+	VisitedLinksSet m_visitedLinks;
+	ValuesPool<QUrl> m_urlsPool;
+	ValuesPool<QString> m_titlesPool;
+	QString m_journalPath;
+	QByteArray m_journalBuffer;
+	QFuture<bool> m_compactionFuture;
+	QVector<quint64> m_entryIdentifiers;
+	QVector<qint64> m_entryTimes;
+	QVector<quint32> m_entryUrls;
+	QVector<quint32> m_entryTitles;
+	QMultiMap<qint64, quint64> m_timeIndex;
+	QHash<quint64, QIcon> m_icons;
+	QHash<quint64, QVector<quint64> > m_urls;
 	HistoryType m_type;
+	int m_journalRecordsAmount;
+	bool m_isJournalEnabled;
+	bool m_isCompacting;
+	bool m_needsCompaction;
 
 signals:
 	void cleared();
-	void entryAdded(Entry *entry);
-	void entryModified(Entry *entry);
-	void entryRemoved(Entry *entry);
+	void entryAdded(const HistoryModel::Entry &entry);
+	void entryModified(const HistoryModel::Entry &entry);
+	void entryRemoved(const HistoryModel::Entry &entry);
+	void entriesRemoved();
 	void modelModified();
 };
 
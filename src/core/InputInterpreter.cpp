@@ -19,26 +19,78 @@
 **************************************************************************/
 
 #include "InputInterpreter.h"
+#include "Application.h"
 #include "BookmarksManager.h"
+#include "NetworkManagerFactory.h"
 #include "SearchEnginesManager.h"
 #include "SettingsManager.h"
+#include "Tracer.h"
 #include "Utils.h"
+#include "../ui/Window.h"
 
-#include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QTimer>
-#include <QtNetwork/QHostInfo>
 
 namespace Otter
 {
 
+QHash<Window*, int> InputInterpreter::m_hostLookups;
+
 InputInterpreter::InputInterpreter(QObject *parent) : QObject(parent)
 {
 }
 
+void InputInterpreter::redirectOnHostLookup(const InterpreterResult &result, Window *window)
+{
+#if QT_VERSION >= 0x050900
+	if (!result.isHostLookupPending || !window || window->getType() != QLatin1String("web"))
+	{
+		return;
+	}
+
+	if (m_hostLookups.contains(window))
+	{
+		QHostInfo::abortHostLookup(m_hostLookups.take(window));
+	}
+
+	const QUrl url(result.url);
+	const QString host(url.host());
+	const int lookupIdentifier(QHostInfo::lookupHost(host, window, [=](const QHostInfo &information)
+	{
+		NetworkManagerFactory::cacheHostInformation(host, information);
+
+		if (m_hostLookups.value(window, -1) != information.lookupId())
+		{
+			return;
+		}
+
+		m_hostLookups.remove(window);
+
+		if (isHostResolved(information))
+		{
+			window->setUrl(url);
+		}
+	}));
+
+	m_hostLookups[window] = lookupIdentifier;
+
+	QTimer::singleShot(SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt(), Application::getInstance(), [=]()
+	{
+		if (m_hostLookups.value(window, -1) == lookupIdentifier)
+		{
+			QHostInfo::abortHostLookup(m_hostLookups.take(window));
+		}
+	});
+#else
+	Q_UNUSED(result)
+	Q_UNUSED(window)
+#endif
+}
+
 InputInterpreter::InterpreterResult InputInterpreter::interpret(const QString &text, InterpreterFlags flags)
 {
+	const Tracer::Span span("InputInterpreter::interpret", "input");
 	InterpreterResult result;
 
 	if (text.isEmpty())
@@ -126,46 +178,25 @@ InputInterpreter::InterpreterResult InputInterpreter::interpret(const QString &t
 	}
 
 #if QT_VERSION >= 0x050900
-	if (!flags.testFlag(NoHostLookupFlag))
+	if (!flags.testFlag(NoHostLookupFlag) && url.isValid() && SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt() > 0)
 	{
-		const int lookupTimeout(SettingsManager::getOption(SettingsManager::AddressField_HostLookupTimeoutOption).toInt());
+		QHostInfo information;
 
-		if (url.isValid() && lookupTimeout > 0)
+		if (NetworkManagerFactory::getHostInformation(url.host(), information))
 		{
-			QEventLoop eventLoop;
-			const int lookupIdentifier(QHostInfo::lookupHost(url.host(), [&](const QHostInfo &information)
-			{
-				if (information.error() == QHostInfo::NoError)
-				{
-					result.url = QUrl::fromUserInput(text);
-					result.type = InterpreterResult::UrlType;
-				}
-
-				eventLoop.quit();
-			}));
-
-			QTimer timer;
-			timer.setSingleShot(true);
-
-			connect(&timer, &QTimer::timeout, [&]()
-			{
-				QHostInfo::abortHostLookup(lookupIdentifier);
-
-				eventLoop.quit();
-			});
-
-			timer.start(lookupTimeout);
-
-			if (result.type == InterpreterResult::UnknownType)
+			if (isHostResolved(information))
 			{
-				eventLoop.exec();
-			}
+				result.url = url;
+				result.type = InterpreterResult::UrlType;
 
-			if (result.type == InterpreterResult::UrlType)
-			{
 				return result;
 			}
 		}
+		else
+		{
+			result.url = url;
+			result.isHostLookupPending = true;
+		}
 	}
 #endif
 
@@ -175,4 +206,9 @@ InputInterpreter::InterpreterResult InputInterpreter::interpret(const QString &t
 	return result;
 }
 
+bool InputInterpreter::isHostResolved(const QHostInfo &information)
+{
+	return (information.error() == QHostInfo::NoError && !information.addresses().isEmpty());
+}
+
 }
@@ -23,9 +23,13 @@
 
 #include "BookmarksModel.h"
 
+#include <QtNetwork/QHostInfo>
+
 namespace Otter
 {
 
+class Window;
+
 class InputInterpreter final : public QObject
 {
 	Q_OBJECT
@@ -56,6 +60,7 @@ public:
 		QString searchQuery;
 		QUrl url;
 		ResultType type = UnknownType;
+		bool isHostLookupPending = false;
 
 		bool isValid() const
 		{
@@ -65,7 +70,14 @@ public:
 
 	explicit InputInterpreter(QObject *parent = nullptr);
 
+	static void redirectOnHostLookup(const InterpreterResult &result, Window *window);
 	static InterpreterResult interpret(const QString &text, InterpreterFlags flags = NoFlags);
+
+protected:
+	static bool isHostResolved(const QHostInfo &information);
+
+private:
+	static QHash<Window*, int> m_hostLookups;
 };
 
 }
@@ -18,13 +18,30 @@
 **************************************************************************/
 
 #include "Job.h"
+#include "BookmarksManager.h"
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
+#include "SessionsManager.h"
 #include "Utils.h"
 
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimer>
+#include <QtCore/QtMath>
+#include <QtPrintSupport/QPrinter>
+
 namespace Otter
 {
 
+QHash<QString, FetchTask*> FetchTask::m_tasks;
+QHash<QString, IconFetchJob::StoredIcon> IconFetchJob::m_store;
+bool IconFetchJob::m_isStoreLoaded(false);
+QVector<QPointer<PrintJob> > PrintJob::m_pendingJobs;
+QSet<PrintJob*> PrintJob::m_runningJobs;
+
 Job::Job(QObject *parent) : QObject(parent),
 	m_progress(-1)
 {
@@ -45,7 +62,510 @@ int Job::getProgress() const
 	return m_progress;
 }
 
+BookmarksCheckJob::BookmarksCheckJob(QObject *parent) : Job(parent),
+	m_checkedAmount(0),
+	m_schedulingTimer(0),
+	m_isRunning(false)
+{
+}
+
+BookmarksCheckJob::~BookmarksCheckJob()
+{
+	abortReplies();
+}
+
+void BookmarksCheckJob::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_schedulingTimer)
+	{
+		const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+		QVector<QNetworkReply*> timedOutReplies;
+		QHash<QNetworkReply*, PendingRequest>::const_iterator iterator;
+
+		for (iterator = m_replies.constBegin(); iterator != m_replies.constEnd(); ++iterator)
+		{
+			if ((currentTime - iterator.value().startTime) > RequestTimeout)
+			{
+				timedOutReplies.append(iterator.key());
+			}
+		}
+
+		for (int i = 0; i < timedOutReplies.count(); ++i)
+		{
+			timedOutReplies.at(i)->abort();
+		}
+
+		scheduleRequests();
+	}
+	else
+	{
+		Job::timerEvent(event);
+	}
+}
+
+void BookmarksCheckJob::start()
+{
+	if (m_isRunning)
+	{
+		return;
+	}
+
+	QHash<QUrl, int> positions;
+	QVector<BookmarksModel::Bookmark*> folders({BookmarksManager::getModel()->getRootItem()});
+
+	m_links.clear();
+	m_hostQueues.clear();
+	m_hostAccessTimes.clear();
+	m_hosts.clear();
+	m_activeHosts.clear();
+	m_checkedAmount = 0;
+
+	while (!folders.isEmpty())
+	{
+		const BookmarksModel::Bookmark *folder(folders.takeLast());
+
+		for (int i = 0; i < folder->rowCount(); ++i)
+		{
+			BookmarksModel::Bookmark *bookmark(folder->getChild(i));
+
+			if (!bookmark)
+			{
+				continue;
+			}
+
+			if (bookmark->getType() == BookmarksModel::FolderBookmark)
+			{
+				folders.append(bookmark);
+
+				continue;
+			}
+
+			const QUrl url(bookmark->getUrl());
+
+			if (bookmark->getType() != BookmarksModel::UrlBookmark || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")) || url.host().isEmpty())
+			{
+				continue;
+			}
+
+			const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+			if (!positions.contains(normalizedUrl))
+			{
+				LinkInformation link;
+				link.url = url;
+
+				positions[normalizedUrl] = m_links.count();
+
+				m_links.append(link);
+
+				PendingRequest request;
+				request.url = url;
+				request.link = (m_links.count() - 1);
+
+				enqueueRequest(request);
+			}
+
+			m_links[positions[normalizedUrl]].bookmarks.append(bookmark->getIdentifier());
+		}
+	}
+
+	m_isRunning = true;
+
+	setProgress(0);
+
+	if (m_links.isEmpty())
+	{
+		m_isRunning = false;
+
+		setProgress(100);
+
+		emit jobFinished(true);
+
+		return;
+	}
+
+	m_schedulingTimer = startTimer(SchedulingInterval);
+
+	scheduleRequests();
+}
+
+void BookmarksCheckJob::cancel()
+{
+	if (!m_isRunning)
+	{
+		return;
+	}
+
+	abortReplies();
+
+	m_hostQueues.clear();
+	m_hosts.clear();
+	m_activeHosts.clear();
+	m_isRunning = false;
+
+	emit jobFinished(false);
+}
+
+void BookmarksCheckJob::abortReplies()
+{
+	QHash<QNetworkReply*, PendingRequest>::const_iterator iterator;
+
+	for (iterator = m_replies.constBegin(); iterator != m_replies.constEnd(); ++iterator)
+	{
+		disconnect(iterator.key(), nullptr, this, nullptr);
+
+		iterator.key()->abort();
+		iterator.key()->deleteLater();
+	}
+
+	m_replies.clear();
+
+	if (m_schedulingTimer != 0)
+	{
+		killTimer(m_schedulingTimer);
+
+		m_schedulingTimer = 0;
+	}
+}
+
+void BookmarksCheckJob::enqueueRequest(const PendingRequest &request)
+{
+	const QString host(request.url.host().toLower());
+
+	if (!m_hostQueues.contains(host))
+	{
+		m_hosts.append(host);
+	}
+
+	m_hostQueues[host].enqueue(request);
+}
+
+void BookmarksCheckJob::scheduleRequests()
+{
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	int i(0);
+
+	while (m_replies.count() < ConcurrentRequestsLimit && i < m_hosts.count())
+	{
+		const QString host(m_hosts.at(i));
+
+		if (m_activeHosts.contains(host) || (m_hostAccessTimes.contains(host) && (currentTime - m_hostAccessTimes[host]) < HostRequestInterval))
+		{
+			++i;
+
+			continue;
+		}
+
+		QQueue<PendingRequest> &queue(m_hostQueues[host]);
+		const PendingRequest request(queue.dequeue());
+
+		if (queue.isEmpty())
+		{
+			m_hostQueues.remove(host);
+			m_hosts.removeAt(i);
+		}
+		else
+		{
+			m_hosts.move(i, (m_hosts.count() - 1));
+		}
+
+		startRequest(request);
+	}
+}
+
+void BookmarksCheckJob::startRequest(const PendingRequest &request)
+{
+	const QString host(request.url.host().toLower());
+	QNetworkRequest networkRequest(request.url);
+	networkRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	networkRequest.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+
+	if (request.isFallback)
+	{
+		networkRequest.setRawHeader(QByteArrayLiteral("Range"), QByteArrayLiteral("bytes=0-0"));
+	}
+
+	QNetworkReply *reply(NetworkManagerFactory::createRequest(networkRequest, (request.isFallback ? QNetworkAccessManager::GetOperation : QNetworkAccessManager::HeadOperation), true));
+	PendingRequest startedRequest(request);
+	startedRequest.startTime = QDateTime::currentMSecsSinceEpoch();
+
+	m_replies[reply] = startedRequest;
+	m_hostAccessTimes[host] = startedRequest.startTime;
+
+	m_activeHosts.insert(host);
+
+	if (request.isFallback)
+	{
+		connect(reply, &QNetworkReply::readyRead, reply, &QNetworkReply::abort);
+	}
+
+	connect(reply, &QNetworkReply::finished, this, [=]()
+	{
+		handleReplyFinished(reply);
+	});
+}
+
+void BookmarksCheckJob::handleReplyFinished(QNetworkReply *reply)
+{
+	if (!m_replies.contains(reply))
+	{
+		return;
+	}
+
+	const PendingRequest request(m_replies.take(reply));
+	const int statusCode(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+	LinkInformation &link(m_links[request.link]);
+	link.statusCode = statusCode;
+
+	reply->deleteLater();
+
+	m_activeHosts.remove(request.url.host().toLower());
+
+	if (statusCode >= 300 && statusCode < 400 && reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl().isValid())
+	{
+		const QUrl redirectionUrl(request.url.resolved(reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl()));
+
+		if (request.redirections < RedirectionsLimit && (redirectionUrl.scheme() == QLatin1String("http") || redirectionUrl.scheme() == QLatin1String("https")))
+		{
+			PendingRequest redirectionRequest;
+			redirectionRequest.url = redirectionUrl;
+			redirectionRequest.link = request.link;
+			redirectionRequest.redirections = (request.redirections + 1);
+
+			link.redirectionUrl = redirectionUrl;
+			link.isPermanentRedirection = (link.isPermanentRedirection && (statusCode == 301 || statusCode == 308));
+
+			enqueueRequest(redirectionRequest);
+			scheduleRequests();
+
+			return;
+		}
+
+		link.state = BrokenLinkState;
+		link.errorString = tr("Too many redirections");
+	}
+	else if ((statusCode == 405 || statusCode == 501) && !request.isFallback)
+	{
+		PendingRequest fallbackRequest(request);
+		fallbackRequest.isFallback = true;
+
+		enqueueRequest(fallbackRequest);
+		scheduleRequests();
+
+		return;
+	}
+	else if (statusCode >= 200 && statusCode < 300)
+	{
+		link.state = ((link.redirectionUrl.isValid() && link.isPermanentRedirection) ? RedirectedLinkState : ValidLinkState);
+	}
+	else if (statusCode >= 400)
+	{
+		link.state = BrokenLinkState;
+		link.errorString = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
+	}
+	else
+	{
+		link.state = UnreachableLinkState;
+		link.errorString = ((reply->error() == QNetworkReply::OperationCanceledError) ? tr("Request timed out") : reply->errorString());
+	}
+
+	finishLink(request.link);
+	scheduleRequests();
+}
+
+void BookmarksCheckJob::finishLink(int link)
+{
+	++m_checkedAmount;
+
+	setProgress(qFloor((m_checkedAmount * 100.0) / m_links.count()));
+
+	emit linkChecked(link);
+
+	if (m_checkedAmount >= m_links.count())
+	{
+		abortReplies();
+
+		m_isRunning = false;
+
+		emit jobFinished(true);
+	}
+}
+
+BookmarksCheckJob::LinkInformation BookmarksCheckJob::getLink(int index) const
+{
+	return m_links.value(index);
+}
+
+QVector<BookmarksCheckJob::LinkInformation> BookmarksCheckJob::getLinks() const
+{
+	return m_links;
+}
+
+int BookmarksCheckJob::getLinksAmount() const
+{
+	return m_links.count();
+}
+
+bool BookmarksCheckJob::isRunning() const
+{
+	return m_isRunning;
+}
+
+BufferedNetworkReply::BufferedNetworkReply(const QNetworkReply *reply, const QByteArray &data, QObject *parent) : QNetworkReply(parent),
+	m_content(data),
+	m_offset(0)
+{
+	setRequest(reply->request());
+	setUrl(reply->url());
+	setOperation(reply->operation());
+	setError(reply->error(), reply->errorString());
+
+	const QList<QNetworkReply::RawHeaderPair> rawHeaders(reply->rawHeaderPairs());
+
+	for (int i = 0; i < rawHeaders.count(); ++i)
+	{
+		setRawHeader(rawHeaders.at(i).first, rawHeaders.at(i).second);
+	}
+
+	const QVector<QNetworkRequest::Attribute> attributes({QNetworkRequest::HttpStatusCodeAttribute, QNetworkRequest::HttpReasonPhraseAttribute, QNetworkRequest::RedirectionTargetAttribute, QNetworkRequest::SourceIsFromCacheAttribute});
+
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		setAttribute(attributes.at(i), reply->attribute(attributes.at(i)));
+	}
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+	setFinished(true);
+}
+
+void BufferedNetworkReply::abort()
+{
+}
+
+qint64 BufferedNetworkReply::bytesAvailable() const
+{
+	return (m_content.size() - m_offset);
+}
+
+qint64 BufferedNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_content.size())
+	{
+		const qint64 number(qMin(maxSize, (m_content.size() - m_offset)));
+
+		memcpy(data, (m_content.constData() + m_offset), static_cast<size_t>(number));
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+bool BufferedNetworkReply::isSequential() const
+{
+	return true;
+}
+
+FetchTask::FetchTask(const QNetworkRequest &request, bool isPrivate, const QString &key) : QObject(QCoreApplication::instance()),
+	m_reply(NetworkManagerFactory::createRequest(request, QNetworkAccessManager::GetOperation, isPrivate)),
+	m_key(key)
+{
+	connect(m_reply, &QNetworkReply::downloadProgress, this, &FetchTask::progressChanged);
+	connect(m_reply, &QNetworkReply::finished, this, &FetchTask::handleReplyFinished);
+}
+
+FetchTask::~FetchTask()
+{
+	if (m_tasks.value(m_key) == this)
+	{
+		m_tasks.remove(m_key);
+	}
+
+	m_reply->deleteLater();
+}
+
+void FetchTask::handleReplyFinished()
+{
+	if (m_tasks.value(m_key) == this)
+	{
+		m_tasks.remove(m_key);
+	}
+
+	m_data = m_reply->readAll();
+
+	emit finished();
+}
+
+void FetchTask::addJob(FetchJob *job)
+{
+	if (!m_jobs.contains(job))
+	{
+		m_jobs.append(job);
+	}
+}
+
+void FetchTask::removeJob(FetchJob *job)
+{
+	m_jobs.removeAll(job);
+
+	if (!m_jobs.isEmpty())
+	{
+		return;
+	}
+
+	if (m_tasks.value(m_key) == this)
+	{
+		m_tasks.remove(m_key);
+	}
+
+	if (!m_reply->isFinished())
+	{
+		m_reply->blockSignals(true);
+		m_reply->abort();
+	}
+
+	deleteLater();
+}
+
+FetchTask* FetchTask::getTask(const QNetworkRequest &request, bool isPrivate)
+{
+	const QString key(createKey(request, isPrivate));
+
+	if (m_tasks.contains(key))
+	{
+		return m_tasks[key];
+	}
+
+	FetchTask *task(new FetchTask(request, isPrivate, key));
+
+	m_tasks[key] = task;
+
+	return task;
+}
+
+QString FetchTask::createKey(const QNetworkRequest &request, bool isPrivate)
+{
+	const QList<QByteArray> headers(request.rawHeaderList());
+	QStringList key({request.url().toString(), (isPrivate ? QLatin1String("private") : QLatin1String("standard"))});
+	key.reserve(headers.count() + 2);
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		key.append(QString::fromLatin1(headers.at(i) + QByteArrayLiteral(": ") + request.rawHeader(headers.at(i))));
+	}
+
+	return key.join(QLatin1Char('\n'));
+}
+
+QNetworkReply* FetchTask::createReply() const
+{
+	return new BufferedNetworkReply(m_reply, m_data);
+}
+
 FetchJob::FetchJob(const QUrl &url, QObject *parent) : Job(parent),
+	m_task(nullptr),
 	m_reply(nullptr),
 	m_url(url),
 	m_sizeLimit(-1),
@@ -58,7 +578,15 @@ FetchJob::FetchJob(const QUrl &url, QObject *parent) : Job(parent),
 
 FetchJob::~FetchJob()
 {
-	m_reply->deleteLater();
+	if (m_task)
+	{
+		m_task->removeJob(this);
+	}
+
+	if (m_reply)
+	{
+		m_reply->deleteLater();
+	}
 }
 
 void FetchJob::timerEvent(QTimerEvent *event)
@@ -74,14 +602,23 @@ void FetchJob::timerEvent(QTimerEvent *event)
 
 void FetchJob::start()
 {
-	if (m_reply)
+	if (m_task || m_reply)
 	{
 		return;
 	}
 
-	m_reply = NetworkManagerFactory::createRequest(m_url, QNetworkAccessManager::GetOperation, m_isPrivate);
+	QNetworkRequest request(m_url);
+	QMap<QByteArray, QByteArray>::const_iterator iterator;
+
+	for (iterator = m_headers.constBegin(); iterator != m_headers.constEnd(); ++iterator)
+	{
+		request.setRawHeader(iterator.key(), iterator.value());
+	}
+
+	m_task = FetchTask::getTask(request, m_isPrivate);
+	m_task->addJob(this);
 
-	connect(m_reply, &QNetworkReply::downloadProgress, this, [&](qint64 bytesReceived, qint64 bytesTotal)
+	connect(m_task, &FetchTask::progressChanged, this, [&](qint64 bytesReceived, qint64 bytesTotal)
 	{
 		if (m_sizeLimit >= 0 && ((bytesReceived > m_sizeLimit) || (bytesTotal > m_sizeLimit)))
 		{
@@ -93,8 +630,13 @@ void FetchJob::start()
 			setProgress(qRound(Utils::calculatePercent(bytesReceived, bytesTotal)));
 		}
 	});
-	connect(m_reply, &QNetworkReply::finished, this, [&]()
+	connect(m_task, &FetchTask::finished, this, [&]()
 	{
+		m_reply = m_task->createReply();
+
+		m_task->removeJob(this);
+		m_task = nullptr;
+
 		const bool isSuccess(m_reply->error() == QNetworkReply::NoError);
 
 		if (isSuccess && (m_sizeLimit < 0 || m_reply->size() <= m_sizeLimit))
@@ -113,8 +655,12 @@ void FetchJob::start()
 
 void FetchJob::cancel()
 {
-	m_reply->blockSignals(true);
-	m_reply->abort();
+	if (m_task)
+	{
+		m_task->disconnect(this);
+		m_task->removeJob(this);
+		m_task = nullptr;
+	}
 
 	deleteLater();
 
@@ -151,14 +697,24 @@ void FetchJob::setPrivate(bool isPrivate)
 	m_isPrivate = isPrivate;
 }
 
+void FetchJob::setHeader(const QByteArray &header, const QByteArray &value)
+{
+	m_headers[header] = value;
+}
+
 QUrl FetchJob::getUrl() const
 {
 	return (m_reply ? m_reply->request().url() : m_url);
 }
 
+bool FetchJob::isPrivate() const
+{
+	return m_isPrivate;
+}
+
 bool FetchJob::isRunning() const
 {
-	return (m_reply != nullptr);
+	return (m_task || m_reply);
 }
 
 DataFetchJob::DataFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent),
@@ -178,6 +734,11 @@ QIODevice* DataFetchJob::getData() const
 	return m_reply;
 }
 
+QByteArray DataFetchJob::getHeader(const QByteArray &header) const
+{
+	return (m_reply ? m_reply->rawHeader(header) : QByteArray());
+}
+
 QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 {
 	QMap<QByteArray, QByteArray> headers;
@@ -191,17 +752,165 @@ QMap<QByteArray, QByteArray> DataFetchJob::getHeaders() const
 	return headers;
 }
 
-IconFetchJob::IconFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent)
+int DataFetchJob::getStatusCode() const
+{
+	return (m_reply ? m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0);
+}
+
+IconFetchJob::IconFetchJob(const QUrl &url, QObject *parent) : FetchJob(url, parent),
+	m_hasStoredIcon(false)
 {
 	setSizeLimit(20480);
 	setTimeout(5);
 }
 
+void IconFetchJob::start()
+{
+	if (isRunning())
+	{
+		return;
+	}
+
+	loadStore();
+
+	const QUrl url(getUrl());
+	const QString host(url.host().toLower());
+
+	if (m_store.contains(host) && m_store[host].url == url)
+	{
+		const StoredIcon &storedIcon(m_store[host]);
+
+		if ((QDateTime::currentMSecsSinceEpoch() - storedIcon.fetchTime) < StoreFreshnessTime)
+		{
+			QPixmap pixmap;
+
+			if (pixmap.loadFromData(storedIcon.data))
+			{
+				m_icon = QIcon(pixmap);
+
+				QTimer::singleShot(0, this, [=]()
+				{
+					deleteLater();
+
+					emit jobFinished(true);
+				});
+
+				return;
+			}
+		}
+
+		if (!storedIcon.entityTag.isEmpty())
+		{
+			setHeader(QByteArrayLiteral("If-None-Match"), storedIcon.entityTag);
+		}
+
+		if (!storedIcon.lastModified.isEmpty())
+		{
+			setHeader(QByteArrayLiteral("If-Modified-Since"), storedIcon.lastModified);
+		}
+
+		m_hasStoredIcon = true;
+	}
+
+	FetchJob::start();
+}
+
+void IconFetchJob::loadStore()
+{
+	if (m_isStoreLoaded)
+	{
+		return;
+	}
+
+	m_isStoreLoaded = true;
+
+	const QString path(getStorePath());
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+	quint32 amount(0);
+
+	stream >> magicNumber >> formatVersion >> amount;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != StoreMagicNumber || formatVersion != StoreFormatVersion)
+	{
+		return;
+	}
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString host;
+		StoredIcon storedIcon;
+
+		stream >> host >> storedIcon.url >> storedIcon.data >> storedIcon.entityTag >> storedIcon.lastModified >> storedIcon.fetchTime;
+
+		if (stream.status() == QDataStream::Ok)
+		{
+			m_store[host] = storedIcon;
+		}
+	}
+}
+
+void IconFetchJob::saveStore()
+{
+	const QString path(getStorePath());
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(StoreMagicNumber) << static_cast<quint32>(StoreFormatVersion) << static_cast<quint32>(m_store.count());
+
+	QHash<QString, StoredIcon>::const_iterator iterator;
+
+	for (iterator = m_store.constBegin(); iterator != m_store.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << iterator.value().url << iterator.value().data << iterator.value().entityTag << iterator.value().lastModified << iterator.value().fetchTime;
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+
+		return;
+	}
+
+	file.commit();
+}
+
 void IconFetchJob::handleSuccessfulReply(QNetworkReply *reply)
 {
+	const QString host(getUrl().host().toLower());
+	const bool isNotModified(m_hasStoredIcon && m_store.contains(host) && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304);
+	const QByteArray data(isNotModified ? m_store[host].data : reply->readAll());
 	QPixmap pixmap;
 
-	if (pixmap.loadFromData(reply->readAll()))
+	if (pixmap.loadFromData(data))
 	{
 		m_icon = QIcon(pixmap);
 	}
@@ -210,6 +919,42 @@ void IconFetchJob::handleSuccessfulReply(QNetworkReply *reply)
 	{
 		markAsFailure();
 	}
+	else if (!isPrivate())
+	{
+		if (isNotModified)
+		{
+			m_store[host].fetchTime = QDateTime::currentMSecsSinceEpoch();
+		}
+		else
+		{
+			StoredIcon storedIcon;
+			storedIcon.url = getUrl();
+			storedIcon.data = data;
+			storedIcon.entityTag = reply->rawHeader(QByteArrayLiteral("ETag"));
+			storedIcon.lastModified = reply->rawHeader(QByteArrayLiteral("Last-Modified"));
+			storedIcon.fetchTime = QDateTime::currentMSecsSinceEpoch();
+
+			if (m_store.count() >= StoreLimit && !m_store.contains(host))
+			{
+				QHash<QString, StoredIcon>::iterator oldestIterator(m_store.begin());
+				QHash<QString, StoredIcon>::iterator iterator;
+
+				for (iterator = m_store.begin(); iterator != m_store.end(); ++iterator)
+				{
+					if (iterator.value().fetchTime < oldestIterator.value().fetchTime)
+					{
+						oldestIterator = iterator;
+					}
+				}
+
+				m_store.erase(oldestIterator);
+			}
+
+			m_store[host] = storedIcon;
+		}
+
+		saveStore();
+	}
 
 	markAsFinished();
 }
@@ -219,4 +964,62 @@ QIcon IconFetchJob::getIcon() const
 	return m_icon;
 }
 
+QString IconFetchJob::getStorePath()
+{
+	const QString cachePath(SessionsManager::getCachePath());
+
+	return (cachePath.isEmpty() ? QString() : QDir(cachePath).filePath(QLatin1String("icons.dat")));
+}
+
+PrintJob::PrintJob(QPrinter *printer, QObject *parent) : Job(parent),
+	m_printer(printer)
+{
+}
+
+PrintJob::~PrintJob()
+{
+	if (m_runningJobs.remove(this))
+	{
+		QTimer::singleShot(0, QCoreApplication::instance(), &PrintJob::startNextJob);
+	}
+
+	delete m_printer;
+}
+
+void PrintJob::schedule(PrintJob *job)
+{
+	connect(job, &PrintJob::jobFinished, job, [=]()
+	{
+		m_runningJobs.remove(job);
+
+		job->deleteLater();
+
+		startNextJob();
+	});
+
+	m_pendingJobs.append(job);
+
+	QTimer::singleShot(0, QCoreApplication::instance(), &PrintJob::startNextJob);
+}
+
+void PrintJob::startNextJob()
+{
+	while (m_runningJobs.count() < ConcurrentJobsLimit && !m_pendingJobs.isEmpty())
+	{
+		PrintJob *job(m_pendingJobs.takeFirst());
+
+		if (job)
+		{
+			m_runningJobs.insert(job);
+
+			job->start();
+		}
+	}
+}
+
+QPrinter* PrintJob::getPrinter() const
+{
+	return m_printer;
+}
+
 }
@@ -20,9 +20,14 @@
 #ifndef OTTER_JOB_H
 #define OTTER_JOB_H
 
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtGui/QIcon>
 #include <QtNetwork/QNetworkReply>
 
+class QPrinter;
+
 namespace Otter
 {
 
@@ -51,6 +56,139 @@ signals:
 	void progressChanged(int progress);
 };
 
+class BufferedNetworkReply final : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	explicit BufferedNetworkReply(const QNetworkReply *reply, const QByteArray &data, QObject *parent = nullptr);
+
+	qint64 bytesAvailable() const override;
+	qint64 readData(char *data, qint64 maxSize) override;
+	bool isSequential() const override;
+
+public slots:
+	void abort() override;
+
+private:
+	QByteArray m_content;
+	qint64 m_offset;
+};
+
+class BookmarksCheckJob final : public Job
+{
+	Q_OBJECT
+
+public:
+	enum LinkState
+	{
+		UnknownLinkState = 0,
+		ValidLinkState,
+		RedirectedLinkState,
+		BrokenLinkState,
+		UnreachableLinkState
+	};
+
+	struct LinkInformation final
+	{
+		QUrl url;
+		QUrl redirectionUrl;
+		QString errorString;
+		QVector<quint64> bookmarks;
+		LinkState state = UnknownLinkState;
+		int statusCode = 0;
+		bool isPermanentRedirection = true;
+	};
+
+	explicit BookmarksCheckJob(QObject *parent = nullptr);
+	~BookmarksCheckJob();
+
+	LinkInformation getLink(int index) const;
+	QVector<LinkInformation> getLinks() const;
+	int getLinksAmount() const;
+	bool isRunning() const override;
+
+public slots:
+	void start() override;
+	void cancel() override;
+
+protected:
+	enum CheckParameter
+	{
+		ConcurrentRequestsLimit = 4,
+		HostRequestInterval = 1000,
+		RedirectionsLimit = 5,
+		RequestTimeout = 20000,
+		SchedulingInterval = 250
+	};
+
+	struct PendingRequest final
+	{
+		QUrl url;
+		qint64 startTime = 0;
+		int link = -1;
+		int redirections = 0;
+		bool isFallback = false;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void enqueueRequest(const PendingRequest &request);
+	void scheduleRequests();
+	void startRequest(const PendingRequest &request);
+	void handleReplyFinished(QNetworkReply *reply);
+	void finishLink(int link);
+	void abortReplies();
+
+private:
+	QVector<LinkInformation> m_links;
+	QHash<QString, QQueue<PendingRequest> > m_hostQueues;
+	QHash<QNetworkReply*, PendingRequest> m_replies;
+	QHash<QString, qint64> m_hostAccessTimes;
+	QStringList m_hosts;
+	QSet<QString> m_activeHosts;
+	int m_checkedAmount;
+	int m_schedulingTimer;
+	bool m_isRunning;
+
+signals:
+	void linkChecked(int index);
+};
+
+class FetchJob;
+
+class FetchTask final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static FetchTask* getTask(const QNetworkRequest &request, bool isPrivate);
+
+	void addJob(FetchJob *job);
+	void removeJob(FetchJob *job);
+	QNetworkReply* createReply() const;
+
+protected:
+	explicit FetchTask(const QNetworkRequest &request, bool isPrivate, const QString &key);
+	~FetchTask();
+
+	static QString createKey(const QNetworkRequest &request, bool isPrivate);
+
+protected slots:
+	void handleReplyFinished();
+
+private:
+	QNetworkReply *m_reply;
+	QString m_key;
+	QByteArray m_data;
+	QVector<FetchJob*> m_jobs;
+
+	static QHash<QString, FetchTask*> m_tasks;
+
+signals:
+	void progressChanged(qint64 bytesReceived, qint64 bytesTotal);
+	void finished();
+};
+
 class FetchJob : public Job
 {
 	Q_OBJECT
@@ -62,7 +200,9 @@ public:
 	void setTimeout(int seconds);
 	void setSizeLimit(qint64 limit);
 	void setPrivate(bool isPrivate);
+	void setHeader(const QByteArray &header, const QByteArray &value);
 	QUrl getUrl() const;
+	bool isPrivate() const;
 	bool isRunning() const override;
 
 public slots:
@@ -76,8 +216,10 @@ protected:
 	virtual void handleSuccessfulReply(QNetworkReply *reply) = 0;
 
 private:
+	FetchTask *m_task;
 	QNetworkReply *m_reply;
 	QUrl m_url;
+	QMap<QByteArray, QByteArray> m_headers;
 	qint64 m_sizeLimit;
 	int m_timeoutTimer;
 	bool m_isFinished;
@@ -93,7 +235,9 @@ public:
 	explicit DataFetchJob(const QUrl &url, QObject *parent = nullptr);
 
 	QIODevice* getData() const;
+	QByteArray getHeader(const QByteArray &header) const;
 	QMap<QByteArray, QByteArray> getHeaders() const;
+	int getStatusCode() const;
 
 protected:
 	void handleSuccessfulReply(QNetworkReply *reply) override;
@@ -111,11 +255,68 @@ public:
 
 	QIcon getIcon() const;
 
+public slots:
+	void start() override;
+
 protected:
+	enum StoreFormat : quint32
+	{
+		StoreMagicNumber = 0x4F494353,
+		StoreFormatVersion = 1
+	};
+
+	enum StoreParameter
+	{
+		StoreLimit = 500,
+		StoreFreshnessTime = 604800000
+	};
+
+	struct StoredIcon final
+	{
+		QUrl url;
+		QByteArray data;
+		QByteArray entityTag;
+		QByteArray lastModified;
+		qint64 fetchTime = 0;
+	};
+
 	void handleSuccessfulReply(QNetworkReply *reply) override;
+	static void loadStore();
+	static void saveStore();
+	static QString getStorePath();
 
 private:
 	QIcon m_icon;
+	bool m_hasStoredIcon;
+
+	static QHash<QString, StoredIcon> m_store;
+	static bool m_isStoreLoaded;
+};
+
+class PrintJob : public Job
+{
+	Q_OBJECT
+
+public:
+	explicit PrintJob(QPrinter *printer, QObject *parent = nullptr);
+	~PrintJob();
+
+	static void schedule(PrintJob *job);
+	QPrinter* getPrinter() const;
+
+protected:
+	enum QueueParameter
+	{
+		ConcurrentJobsLimit = 2
+	};
+
+	static void startNextJob();
+
+private:
+	QPrinter *m_printer;
+
+	static QVector<QPointer<PrintJob> > m_pendingJobs;
+	static QSet<PrintJob*> m_runningJobs;
 };
 
 }
@@ -0,0 +1,196 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "JsonWriter.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace Otter
+{
+
+JsonWriter::JsonWriter(QIODevice *device) :
+	m_device(device),
+	m_isExpectingValue(false),
+	m_hasError(!device)
+{
+}
+
+void JsonWriter::writeStartObject()
+{
+	writeStartContainer('{');
+}
+
+void JsonWriter::writeEndObject()
+{
+	writeEndContainer('}');
+}
+
+void JsonWriter::writeStartArray()
+{
+	writeStartContainer('[');
+}
+
+void JsonWriter::writeEndArray()
+{
+	writeEndContainer(']');
+}
+
+void JsonWriter::writeStartContainer(char character)
+{
+	writeSeparator();
+	writeData(QByteArray(1, character));
+
+	m_containers.append(false);
+}
+
+void JsonWriter::writeEndContainer(char character)
+{
+	if (m_containers.isEmpty())
+	{
+		m_hasError = true;
+
+		return;
+	}
+
+	const bool hasElements(m_containers.takeLast());
+	QByteArray data;
+
+	if (hasElements)
+	{
+		data.append('\n');
+		data.append(QByteArray(m_containers.count(), '\t'));
+	}
+
+	data.append(character);
+
+	if (m_containers.isEmpty())
+	{
+		data.append('\n');
+	}
+
+	writeData(data);
+}
+
+void JsonWriter::writeName(const QString &name)
+{
+	writeSeparator();
+
+	QByteArray data(QJsonDocument(QJsonArray({name})).toJson(QJsonDocument::Compact));
+	data = data.mid(1, (data.count() - 2));
+	data.append(": ");
+
+	writeData(data);
+
+	m_isExpectingValue = true;
+}
+
+void JsonWriter::writeValue(const QJsonValue &value)
+{
+	writeSeparator();
+
+	QByteArray data;
+
+	if (value.isObject() || value.isArray())
+	{
+		const QByteArray document(value.isObject() ? QJsonDocument(value.toObject()).toJson(QJsonDocument::Indented) : QJsonDocument(value.toArray()).toJson(QJsonDocument::Indented));
+		const QByteArray indentation(m_containers.count(), '\t');
+		int lineStartPosition(0);
+
+		data.reserve(document.count());
+
+		while (lineStartPosition < document.count())
+		{
+			int lineEndPosition(document.indexOf('\n', lineStartPosition));
+
+			if (lineEndPosition < 0)
+			{
+				lineEndPosition = document.count();
+			}
+
+			int spacesAmount(0);
+
+			while ((lineStartPosition + spacesAmount) < lineEndPosition && document.at(lineStartPosition + spacesAmount) == ' ')
+			{
+				++spacesAmount;
+			}
+
+			if (lineStartPosition > 0)
+			{
+				data.append('\n');
+				data.append(indentation);
+			}
+
+			data.append(QByteArray((spacesAmount / 4), '\t'));
+			data.append(document.mid((lineStartPosition + spacesAmount), (lineEndPosition - lineStartPosition - spacesAmount)));
+
+			lineStartPosition = (lineEndPosition + 1);
+		}
+	}
+	else
+	{
+		data = QJsonDocument(QJsonArray({value})).toJson(QJsonDocument::Compact);
+		data = data.mid(1, (data.count() - 2));
+	}
+
+	if (m_containers.isEmpty())
+	{
+		data.append('\n');
+	}
+
+	writeData(data);
+}
+
+void JsonWriter::writeSeparator()
+{
+	if (m_isExpectingValue)
+	{
+		m_isExpectingValue = false;
+
+		return;
+	}
+
+	if (m_containers.isEmpty())
+	{
+		return;
+	}
+
+	QByteArray data(m_containers.last() ? ",\n" : "\n");
+	data.append(QByteArray(m_containers.count(), '\t'));
+
+	m_containers.last() = true;
+
+	writeData(data);
+}
+
+void JsonWriter::writeData(const QByteArray &data)
+{
+	if (!m_hasError && m_device->write(data) != data.count())
+	{
+		m_hasError = true;
+	}
+}
+
+bool JsonWriter::hasError() const
+{
+	return m_hasError;
+}
+
+}
@@ -0,0 +1,58 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_JSONWRITER_H
+#define OTTER_JSONWRITER_H
+
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonValue>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class JsonWriter final
+{
+public:
+	explicit JsonWriter(QIODevice *device);
+
+	void writeStartObject();
+	void writeEndObject();
+	void writeStartArray();
+	void writeEndArray();
+	void writeName(const QString &name);
+	void writeValue(const QJsonValue &value);
+	bool hasError() const;
+
+protected:
+	void writeStartContainer(char character);
+	void writeEndContainer(char character);
+	void writeSeparator();
+	void writeData(const QByteArray &data);
+
+private:
+	QIODevice *m_device;
+	QVector<bool> m_containers;
+	bool m_isExpectingValue;
+	bool m_hasError;
+};
+
+}
+
+#endif
@@ -31,84 +31,30 @@
 namespace Otter
 {
 
+ListingNetworkReply::ListingTemplate ListingNetworkReply::m_template;
+QHash<QString, QString> ListingNetworkReply::m_iconsData;
+
 ListingNetworkReply::ListingNetworkReply(const QNetworkRequest &request, QObject *parent) : QNetworkReply(parent)
 {
 	setRequest(request);
 }
 
-QByteArray ListingNetworkReply::createListing(const QString &title, const QVector<ListingNetworkReply::NavigationEntry> &navigation, const QVector<ListingNetworkReply::ListingEntry> &entries)
+QString ListingNetworkReply::createEntries(const QVector<ListingNetworkReply::ListingEntry> &entries, int start, int amount, QString &style)
 {
-	const QRegularExpression entryExpression(QLatin1String("<!--entry:begin-->(.*)<!--entry:end-->"), (QRegularExpression::DotMatchesEverythingOption | QRegularExpression::MultilineOption));
-	QFile file(SessionsManager::getReadableDataPath(QLatin1String("files/listing.html")));
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
-
-	QTextStream stream(&file);
-	stream.setCodec("UTF-8");
-
-	QString navigationHtml;
+	const QString entryTemplate(getTemplate().entry);
 	QString entriesHtml;
-	QString listingTemplate(stream.readAll());
-	const QString entryTemplate(entryExpression.match(listingTemplate).captured(1));
+	const int end(qMin((start + amount), entries.count()));
 
-	listingTemplate.replace(entryExpression, QLatin1String("{entries}"));
-
-	for (int i = 0; i < navigation.count(); ++i)
-	{
-		navigationHtml.append(QStringLiteral("<a href=\"%1\">%2</a>").arg(navigation[i].url.toString(), navigation[i].name) + ((i < (navigation.count() - 1)) ? QLatin1String("&shy;") : QString()));
-	}
-
-	QHash<QString, QIcon> icons;
-	const QFileIconProvider iconProvider;
-
-	for (int i = 0; i < entries.count(); ++i)
+	for (int i = start; i < end; ++i)
 	{
 		const ListingEntry &entry(entries.at(i));
+		const QString iconName(entry.mimeType.name());
 
-		if (!icons.contains(entry.mimeType.name()))
+		if (!m_definedIcons.contains(iconName))
 		{
-			QIcon icon;
-
-			switch (entry.type)
-			{
-				case ListingEntry::DirectoryType:
-					icon = iconProvider.icon(QFileIconProvider::Folder);
-
-					break;
-				case ListingEntry::DriveType:
-					icon = iconProvider.icon(QFileIconProvider::Drive);
-
-					break;
-				case ListingEntry::FileType:
-					icon = iconProvider.icon(QFileIconProvider::File);
-
-					break;
-				default:
-					break;
-			}
-
-			icon = QIcon::fromTheme(entry.mimeType.iconName(), icon);
-
-			if (icon.isNull())
-			{
-				switch (entry.type)
-				{
-					case ListingEntry::DriveType:
-					case ListingEntry::DirectoryType:
-						icon = ThemesManager::createIcon(QLatin1String("inode-directory"), false);
-
-						break;
-					case ListingEntry::FileType:
-						icon = ThemesManager::createIcon(QLatin1String("unknown"), false);
+			m_definedIcons.insert(iconName);
 
-						break;
-					default:
-						icon = ThemesManager::createIcon((entry.isSymlink ? QLatin1String("link") : QLatin1String("unknown")), false);
-
-						break;
-				}
-			}
-
-			icons[entry.mimeType.name()] = icon;
+			style.append(QStringLiteral("tr td:first-child.icon_%1\n{\n\tbackground-image:url(\"data:image/png;base64,%2\");\n}\n").arg(Utils::createIdentifier(iconName), getIconData(entry)));
 		}
 
 		QStringList classes;
@@ -127,12 +73,12 @@ QByteArray ListingNetworkReply::createListing(const QString &title, const QVecto
 			classes.append(QLatin1String("link"));
 		}
 
-		classes.append(QLatin1String("icon_") + Utils::createIdentifier(entry.mimeType.name()));
+		classes.append(QLatin1String("icon_") + Utils::createIdentifier(iconName));
 
 		QHash<QString, QString> variables;
 		variables[QLatin1String("class")] = classes.join(QLatin1Char(' '));
 		variables[QLatin1String("url")] = entry.url.toString().toHtmlEscaped();
-		variables[QLatin1String("mimeType")] = entry.mimeType.name().toHtmlEscaped();
+		variables[QLatin1String("mimeType")] = iconName.toHtmlEscaped();
 		variables[QLatin1String("name")] = entry.name.toHtmlEscaped();
 		variables[QLatin1String("comment")] = entry.mimeType.comment().toHtmlEscaped();
 		variables[QLatin1String("size")] = ((entry.type == ListingEntry::FileType) ? Utils::formatUnit(entry.size, false, 2) : QString());
@@ -141,33 +87,152 @@ QByteArray ListingNetworkReply::createListing(const QString &title, const QVecto
 		entriesHtml.append(Utils::substitutePlaceholders(entryTemplate, variables));
 	}
 
-	QString styleHtml;
-	const int iconSize(16 * qCeil(Application::getInstance()->devicePixelRatio()));
-	QHash<QString, QIcon>::iterator iterator;
+	return entriesHtml;
+}
 
-	for (iterator = icons.begin(); iterator != icons.end(); ++iterator)
-	{
-		QByteArray byteArray;
-		QBuffer buffer(&byteArray);
+QByteArray ListingNetworkReply::createListing(const QString &title, const QVector<ListingNetworkReply::NavigationEntry> &navigation, const QVector<ListingNetworkReply::ListingEntry> &entries)
+{
+	QString style;
+	const QString entriesHtml(createEntries(entries, 0, entries.count(), style));
+
+	return (createListingHeader(title, navigation, style) + entriesHtml.toUtf8() + createListingFooter());
+}
 
-		iterator.value().pixmap(iconSize, iconSize).save(&buffer, "PNG");
+QByteArray ListingNetworkReply::createListingHeader(const QString &title, const QVector<ListingNetworkReply::NavigationEntry> &navigation, const QString &style) const
+{
+	QString navigationHtml;
 
-		styleHtml.append(QStringLiteral("tr td:first-child.icon_%1\n{\n\tbackground-image:url(\"data:image/png;base64,%2\");\n}\n").arg(Utils::createIdentifier(iterator.key()), QString::fromLatin1(byteArray.toBase64())));
+	for (int i = 0; i < navigation.count(); ++i)
+	{
+		navigationHtml.append(QStringLiteral("<a href=\"%1\">%2</a>").arg(navigation[i].url.toString(), navigation[i].name) + ((i < (navigation.count() - 1)) ? QLatin1String("&shy;") : QString()));
 	}
 
 	QHash<QString, QString> variables;
 	variables[QLatin1String("title")] = title.toHtmlEscaped();
 	variables[QLatin1String("description")] = tr("Directory Contents").toHtmlEscaped();
 	variables[QLatin1String("dir")] = (Application::isLeftToRight() ? QLatin1String("ltr") : QLatin1String("rtl"));
-	variables[QLatin1String("style")] = styleHtml;
+	variables[QLatin1String("style")] = style;
 	variables[QLatin1String("navigation")] = navigationHtml;
-	variables[QLatin1String("entries")] = entriesHtml;
 	variables[QLatin1String("headerName")] = tr("Name").toHtmlEscaped();
 	variables[QLatin1String("headerType")] = tr("Type").toHtmlEscaped();
 	variables[QLatin1String("headerSize")] = tr("Size").toHtmlEscaped();
 	variables[QLatin1String("headerDate")] = tr("Date").toHtmlEscaped();
 
-	return Utils::substitutePlaceholders(listingTemplate, variables).toUtf8();
+	return Utils::substitutePlaceholders(getTemplate().header, variables).toUtf8();
+}
+
+QByteArray ListingNetworkReply::createListingEntries(const QVector<ListingNetworkReply::ListingEntry> &entries, int start, int amount)
+{
+	QString style;
+	const QString entriesHtml(createEntries(entries, start, amount, style));
+
+	if (style.isEmpty())
+	{
+		return entriesHtml.toUtf8();
+	}
+
+	return (QLatin1String("<style type=\"text/css\">\n") + style + QLatin1String("</style>\n") + entriesHtml).toUtf8();
+}
+
+QByteArray ListingNetworkReply::createListingFooter() const
+{
+	return getTemplate().footer.toUtf8();
+}
+
+QString ListingNetworkReply::getIconData(const ListingEntry &entry)
+{
+	const QString iconName(entry.mimeType.name());
+
+	if (m_iconsData.contains(iconName))
+	{
+		return m_iconsData[iconName];
+	}
+
+	QIcon icon;
+	const QFileIconProvider iconProvider;
+
+	switch (entry.type)
+	{
+		case ListingEntry::DirectoryType:
+			icon = iconProvider.icon(QFileIconProvider::Folder);
+
+			break;
+		case ListingEntry::DriveType:
+			icon = iconProvider.icon(QFileIconProvider::Drive);
+
+			break;
+		case ListingEntry::FileType:
+			icon = iconProvider.icon(QFileIconProvider::File);
+
+			break;
+		default:
+			break;
+	}
+
+	icon = QIcon::fromTheme(entry.mimeType.iconName(), icon);
+
+	if (icon.isNull())
+	{
+		switch (entry.type)
+		{
+			case ListingEntry::DriveType:
+			case ListingEntry::DirectoryType:
+				icon = ThemesManager::createIcon(QLatin1String("inode-directory"), false);
+
+				break;
+			case ListingEntry::FileType:
+				icon = ThemesManager::createIcon(QLatin1String("unknown"), false);
+
+				break;
+			default:
+				icon = ThemesManager::createIcon((entry.isSymlink ? QLatin1String("link") : QLatin1String("unknown")), false);
+
+				break;
+		}
+	}
+
+	const int iconSize(16 * qCeil(Application::getInstance()->devicePixelRatio()));
+	QByteArray byteArray;
+	QBuffer buffer(&byteArray);
+
+	icon.pixmap(iconSize, iconSize).save(&buffer, "PNG");
+
+	const QString data(QString::fromLatin1(byteArray.toBase64()));
+
+	m_iconsData[iconName] = data;
+
+	return data;
+}
+
+const ListingNetworkReply::ListingTemplate& ListingNetworkReply::getTemplate()
+{
+	if (!m_template.header.isEmpty())
+	{
+		return m_template;
+	}
+
+	const QRegularExpression entryExpression(QLatin1String("<!--entry:begin-->(.*)<!--entry:end-->"), (QRegularExpression::DotMatchesEverythingOption | QRegularExpression::MultilineOption));
+	QFile file(SessionsManager::getReadableDataPath(QLatin1String("files/listing.html")));
+	file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	const QString listingTemplate(stream.readAll());
+	const QRegularExpressionMatch match(entryExpression.match(listingTemplate));
+
+	if (!match.hasMatch())
+	{
+		m_template.header = listingTemplate;
+
+		return m_template;
+	}
+
+	m_template.header = listingTemplate.left(match.capturedStart());
+	m_template.entry = match.captured(1);
+	m_template.footer = listingTemplate.mid(match.capturedEnd());
+
+	return m_template;
 }
 
 }
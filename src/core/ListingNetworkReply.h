@@ -21,6 +21,7 @@
 #define OTTER_LISTINGNETWORKREPLY_H
 
 #include <QtCore/QMimeType>
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 #include <QtNetwork/QNetworkReply>
 
@@ -60,7 +61,26 @@ protected:
 		bool isSymlink = false;
 	};
 
+	struct ListingTemplate final
+	{
+		QString header;
+		QString entry;
+		QString footer;
+	};
+
+	QString createEntries(const QVector<ListingEntry> &entries, int start, int amount, QString &style);
 	QByteArray createListing(const QString &title, const QVector<NavigationEntry> &navigation, const QVector<ListingEntry> &entries);
+	QByteArray createListingHeader(const QString &title, const QVector<NavigationEntry> &navigation, const QString &style = {}) const;
+	QByteArray createListingEntries(const QVector<ListingEntry> &entries, int start, int amount);
+	QByteArray createListingFooter() const;
+	static QString getIconData(const ListingEntry &entry);
+	static const ListingTemplate& getTemplate();
+
+private:
+	QSet<QString> m_definedIcons;
+
+	static ListingTemplate m_template;
+	static QHash<QString, QString> m_iconsData;
 
 signals:
 	void listingError();
@@ -25,12 +25,16 @@
 #include <QtCore/QDir>
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace Otter
 {
 
 LocalListingNetworkReply::LocalListingNetworkReply(const QNetworkRequest &request, QObject *parent) : ListingNetworkReply(request, parent),
-	m_offset(0)
+	m_listingWatcher(nullptr),
+	m_offset(0),
+	m_entriesOffset(0),
+	m_isFinished(false)
 {
 	setRequest(request);
 	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
@@ -65,6 +69,8 @@ LocalListingNetworkReply::LocalListingNetworkReply(const QNetworkRequest &reques
 		setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
 		setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
 
+		m_isFinished = true;
+
 		QTimer::singleShot(0, this, [&]()
 		{
 			emit listingError();
@@ -75,16 +81,12 @@ LocalListingNetworkReply::LocalListingNetworkReply(const QNetworkRequest &reques
 		return;
 	}
 
-	QMimeDatabase mimeDatabase;
 	QVector<NavigationEntry> navigation;
 #ifdef Q_OS_WIN32
 	const bool isListingDevices(request.url().toLocalFile() == QLatin1String("/"));
-	const QFileInfoList rawEntries(isListingDevices ? QDir::drives() : directory.entryInfoList((QDir::AllEntries | QDir::Hidden), (QDir::Name | QDir::DirsFirst)));
 #else
-	const QFileInfoList rawEntries(directory.entryInfoList((QDir::AllEntries | QDir::Hidden), (QDir::Name | QDir::DirsFirst)));
+	const bool isListingDevices(false);
 #endif
-	QVector<ListingEntry> entries;
-	entries.reserve(rawEntries.count());
 
 	do
 	{
@@ -113,46 +115,82 @@ LocalListingNetworkReply::LocalListingNetworkReply(const QNetworkRequest &reques
 	navigation.prepend(rootEntry);
 #endif
 
-	for (int i = 0; i < rawEntries.count(); ++i)
-	{
-		if (rawEntries.at(i).fileName() == QLatin1String(".") || rawEntries.at(i).fileName() == QLatin1String(".."))
-		{
-			continue;
-		}
+	m_content = createListingHeader(QFileInfo(request.url().toLocalFile()).canonicalFilePath(), navigation);
+	m_listingWatcher = new QFutureWatcher<QVector<ListingEntry> >(this);
 
-		ListingEntry entry;
-		entry.name = rawEntries.at(i).fileName();
-		entry.url = QUrl::fromUserInput(rawEntries.at(i).filePath());
-		entry.timeModified = rawEntries.at(i).lastModified();
-		entry.mimeType = mimeDatabase.mimeTypeForFile(rawEntries.at(i).filePath());
-		entry.type = (rawEntries.at(i).isRoot() ? ListingEntry::DriveType : (rawEntries.at(i).isDir() ? ListingEntry::DirectoryType : ListingEntry::FileType));
-		entry.size = rawEntries.at(i).size();
-		entry.isSymlink = rawEntries.at(i).isSymLink();
+	setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
 
-#ifdef Q_OS_WIN32
-		if (isListingDevices)
+	connect(m_listingWatcher, &QFutureWatcher<QVector<ListingEntry> >::finished, this, &LocalListingNetworkReply::handleEntriesListed);
+
+	m_listingWatcher->setFuture(QtConcurrent::run(&LocalListingNetworkReply::listEntries, request.url().toLocalFile(), isListingDevices));
+
+	QTimer::singleShot(0, this, [&]()
+	{
+		if (bytesAvailable() > 0)
 		{
-			entry.name = rawEntries.at(i).filePath().remove(QLatin1Char('/'));
+			emit readyRead();
 		}
-#endif
+	});
+}
 
-		entries.append(entry);
+void LocalListingNetworkReply::appendEntries()
+{
+	if (m_isFinished)
+	{
+		return;
 	}
 
-	m_content = createListing(QFileInfo(request.url().toLocalFile()).canonicalFilePath(), navigation, entries);
+	const int amount(qMin(static_cast<int>(ListingBatchSize), (m_entries.count() - m_entriesOffset)));
 
-	setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
-	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+	m_content.append(createListingEntries(m_entries, m_entriesOffset, amount));
 
-	QTimer::singleShot(0, this, [&]()
+	m_entriesOffset += amount;
+
+	if (m_entriesOffset < m_entries.count())
 	{
+		emit downloadProgress(m_entriesOffset, m_entries.count());
 		emit readyRead();
-		emit finished();
-	});
+
+		QTimer::singleShot(0, this, &LocalListingNetworkReply::appendEntries);
+
+		return;
+	}
+
+	m_content.append(createListingFooter());
+	m_entries.clear();
+
+	m_isFinished = true;
+
+	emit readyRead();
+	emit finished();
+}
+
+void LocalListingNetworkReply::handleEntriesListed()
+{
+	if (m_isFinished)
+	{
+		return;
+	}
+
+	m_entries = m_listingWatcher->result();
+
+	appendEntries();
 }
 
 void LocalListingNetworkReply::abort()
 {
+	if (m_isFinished)
+	{
+		return;
+	}
+
+	m_entries.clear();
+
+	m_isFinished = true;
+
+	setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+
+	emit finished();
 }
 
 qint64 LocalListingNetworkReply::bytesAvailable() const
@@ -170,10 +208,92 @@ qint64 LocalListingNetworkReply::readData(char *data, qint64 maxSize)
 
 		m_offset += number;
 
+		if (m_offset >= m_content.size())
+		{
+			m_content.clear();
+			m_offset = 0;
+		}
+
 		return number;
 	}
 
-	return -1;
+	return (m_isFinished ? -1 : 0);
+}
+
+QVector<ListingNetworkReply::ListingEntry> LocalListingNetworkReply::listEntries(const QString &path, bool isListingDevices)
+{
+	const QDir directory(path);
+#ifdef Q_OS_WIN32
+	const QFileInfoList rawEntries(isListingDevices ? QDir::drives() : directory.entryInfoList((QDir::AllEntries | QDir::Hidden), (QDir::Name | QDir::DirsFirst)));
+#else
+	Q_UNUSED(isListingDevices)
+
+	const QFileInfoList rawEntries(directory.entryInfoList((QDir::AllEntries | QDir::Hidden), (QDir::Name | QDir::DirsFirst)));
+#endif
+	const QString directoryMimeTypeKey(QLatin1String("/"));
+	QMimeDatabase mimeDatabase;
+	QHash<QString, QMimeType> mimeTypes;
+	QVector<ListingEntry> entries;
+	entries.reserve(rawEntries.count());
+
+	for (int i = 0; i < rawEntries.count(); ++i)
+	{
+		const QFileInfo &information(rawEntries.at(i));
+
+		if (information.fileName() == QLatin1String(".") || information.fileName() == QLatin1String(".."))
+		{
+			continue;
+		}
+
+		const bool isDirectory(information.isDir());
+		const QString mimeTypeKey(isDirectory ? directoryMimeTypeKey : information.completeSuffix());
+
+		ListingEntry entry;
+		entry.name = information.fileName();
+		entry.url = QUrl::fromUserInput(information.filePath());
+		entry.timeModified = information.lastModified();
+		entry.type = (information.isRoot() ? ListingEntry::DriveType : (isDirectory ? ListingEntry::DirectoryType : ListingEntry::FileType));
+		entry.size = information.size();
+		entry.isSymlink = information.isSymLink();
+
+		if (mimeTypes.contains(mimeTypeKey))
+		{
+			entry.mimeType = mimeTypes[mimeTypeKey];
+		}
+		else if (isDirectory || mimeTypeKey.isEmpty())
+		{
+			entry.mimeType = mimeDatabase.mimeTypeForFile(information);
+
+			if (isDirectory)
+			{
+				mimeTypes[mimeTypeKey] = entry.mimeType;
+			}
+		}
+		else
+		{
+			entry.mimeType = mimeDatabase.mimeTypeForFile(information, QMimeDatabase::MatchExtension);
+
+			if (entry.mimeType.isDefault())
+			{
+				entry.mimeType = mimeDatabase.mimeTypeForFile(information);
+			}
+			else
+			{
+				mimeTypes[mimeTypeKey] = entry.mimeType;
+			}
+		}
+
+#ifdef Q_OS_WIN32
+		if (isListingDevices)
+		{
+			entry.name = information.filePath().remove(QLatin1Char('/'));
+		}
+#endif
+
+		entries.append(entry);
+	}
+
+	return entries;
 }
 
 bool LocalListingNetworkReply::isSequential() const
@@ -23,6 +23,8 @@
 
 #include "ListingNetworkReply.h"
 
+#include <QtCore/QFutureWatcher>
+
 namespace Otter
 {
 
@@ -40,9 +42,25 @@ public:
 public slots:
 	void abort() override;
 
+protected:
+	enum ListingParameter
+	{
+		ListingBatchSize = 500
+	};
+
+	static QVector<ListingEntry> listEntries(const QString &path, bool isListingDevices);
+
+protected slots:
+	void appendEntries();
+	void handleEntriesListed();
+
 private:
+	QFutureWatcher<QVector<ListingEntry> > *m_listingWatcher;
+	QVector<ListingEntry> m_entries;
 	QByteArray m_content;
 	qint64 m_offset;
+	int m_entriesOffset;
+	bool m_isFinished;
 };
 
 }
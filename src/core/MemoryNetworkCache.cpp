@@ -0,0 +1,260 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "MemoryNetworkCache.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QBuffer>
+
+namespace Otter
+{
+
+MemoryNetworkCache::MemoryNetworkCache(QObject *parent) : QAbstractNetworkCache(parent),
+	m_size(0),
+	m_maximumSize(SettingsManager::getOption(SettingsManager::Cache_PrivateMemoryCacheLimitOption).toInt() * 1024),
+	m_accessCounter(0)
+{
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &MemoryNetworkCache::handleOptionChanged);
+}
+
+MemoryNetworkCache::~MemoryNetworkCache()
+{
+	qDeleteAll(m_devices.keys());
+}
+
+void MemoryNetworkCache::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier == SettingsManager::Cache_PrivateMemoryCacheLimitOption)
+	{
+		m_maximumSize = (value.toInt() * 1024);
+
+		evictEntries();
+	}
+}
+
+void MemoryNetworkCache::insert(QIODevice *device)
+{
+	if (!m_devices.contains(device))
+	{
+		return;
+	}
+
+	const QNetworkCacheMetaData metaData(m_devices.take(device));
+	const QByteArray data(static_cast<QBuffer*>(device)->data());
+	const bool isDiscarded(m_discardedDevices.remove(device));
+
+	delete device;
+
+	if (isDiscarded)
+	{
+		return;
+	}
+
+	removeEntry(metaData.url());
+
+	const qint64 size(data.size() + getMetaDataSize(metaData));
+
+	if (size > (m_maximumSize / EntrySizeDivisor))
+	{
+		return;
+	}
+
+	++m_accessCounter;
+
+	Entry entry;
+	entry.metaData = metaData;
+	entry.data = data;
+	entry.size = size;
+	entry.accessCounter = m_accessCounter;
+
+	m_entries[metaData.url()] = entry;
+	m_accessOrder[m_accessCounter] = metaData.url();
+	m_size += size;
+
+	evictEntries();
+}
+
+void MemoryNetworkCache::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+	const QHash<QUrl, Entry>::iterator iterator(m_entries.find(metaData.url()));
+
+	if (iterator == m_entries.end())
+	{
+		return;
+	}
+
+	const qint64 size(iterator->data.size() + getMetaDataSize(metaData));
+
+	m_size += (size - iterator->size);
+
+	iterator->metaData = metaData;
+	iterator->size = size;
+
+	evictEntries();
+}
+
+void MemoryNetworkCache::removeEntry(const QUrl &url)
+{
+	const QHash<QUrl, Entry>::iterator iterator(m_entries.find(url));
+
+	if (iterator != m_entries.end())
+	{
+		m_size -= iterator->size;
+
+		m_accessOrder.remove(iterator->accessCounter);
+		m_entries.erase(iterator);
+	}
+}
+
+void MemoryNetworkCache::evictEntries()
+{
+	while (m_size > m_maximumSize && !m_accessOrder.isEmpty())
+	{
+		removeEntry(m_accessOrder.first());
+	}
+}
+
+void MemoryNetworkCache::clear()
+{
+	QHash<QIODevice*, QNetworkCacheMetaData>::const_iterator iterator;
+
+	for (iterator = m_devices.constBegin(); iterator != m_devices.constEnd(); ++iterator)
+	{
+		m_discardedDevices.insert(iterator.key());
+	}
+
+	m_entries.clear();
+	m_accessOrder.clear();
+	m_size = 0;
+}
+
+QIODevice* MemoryNetworkCache::prepare(const QNetworkCacheMetaData &metaData)
+{
+	if (m_maximumSize <= 0 || !metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk())
+	{
+		return nullptr;
+	}
+
+	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.compare(QByteArrayLiteral("Content-Length"), Qt::CaseInsensitive) == 0)
+		{
+			if (headers.at(i).second.toLongLong() > (m_maximumSize / EntrySizeDivisor))
+			{
+				return nullptr;
+			}
+
+			break;
+		}
+	}
+
+	QBuffer *buffer(new QBuffer());
+	buffer->open(QIODevice::ReadWrite);
+
+	m_devices[buffer] = metaData;
+
+	return buffer;
+}
+
+QIODevice* MemoryNetworkCache::data(const QUrl &url)
+{
+	const QHash<QUrl, Entry>::iterator iterator(m_entries.find(url));
+
+	if (iterator == m_entries.end())
+	{
+		return nullptr;
+	}
+
+	++m_accessCounter;
+
+	m_accessOrder.remove(iterator->accessCounter);
+	m_accessOrder[m_accessCounter] = url;
+
+	iterator->accessCounter = m_accessCounter;
+
+	QBuffer *buffer(new QBuffer());
+	buffer->setData(iterator->data);
+	buffer->open(QIODevice::ReadOnly);
+
+	return buffer;
+}
+
+QNetworkCacheMetaData MemoryNetworkCache::metaData(const QUrl &url)
+{
+	return m_entries.value(url).metaData;
+}
+
+qint64 MemoryNetworkCache::cacheSize() const
+{
+	return m_size;
+}
+
+qint64 MemoryNetworkCache::maximumCacheSize() const
+{
+	return m_maximumSize;
+}
+
+qint64 MemoryNetworkCache::getMetaDataSize(const QNetworkCacheMetaData &metaData)
+{
+	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+	qint64 size(metaData.url().toEncoded().size());
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		size += (headers.at(i).first.size() + headers.at(i).second.size());
+	}
+
+	return size;
+}
+
+int MemoryNetworkCache::getEntriesAmount() const
+{
+	return m_entries.count();
+}
+
+bool MemoryNetworkCache::remove(const QUrl &url)
+{
+	QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator(m_devices.begin());
+
+	while (iterator != m_devices.end())
+	{
+		if (iterator.value().url() == url)
+		{
+			m_discardedDevices.remove(iterator.key());
+
+			delete iterator.key();
+
+			iterator = m_devices.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const bool hasEntry(m_entries.contains(url));
+
+	removeEntry(url);
+
+	return hasEntry;
+}
+
+}
@@ -0,0 +1,84 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_MEMORYNETWORKCACHE_H
+#define OTTER_MEMORYNETWORKCACHE_H
+
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtNetwork/QAbstractNetworkCache>
+
+namespace Otter
+{
+
+class MemoryNetworkCache final : public QAbstractNetworkCache
+{
+	Q_OBJECT
+
+public:
+	explicit MemoryNetworkCache(QObject *parent = nullptr);
+	~MemoryNetworkCache();
+
+	void insert(QIODevice *device) override;
+	void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+	QIODevice* prepare(const QNetworkCacheMetaData &metaData) override;
+	QIODevice* data(const QUrl &url) override;
+	QNetworkCacheMetaData metaData(const QUrl &url) override;
+	qint64 cacheSize() const override;
+	qint64 maximumCacheSize() const;
+	int getEntriesAmount() const;
+	bool remove(const QUrl &url) override;
+
+public slots:
+	void clear() override;
+
+protected:
+	enum EntryParameter
+	{
+		EntrySizeDivisor = 8
+	};
+
+	struct Entry final
+	{
+		QNetworkCacheMetaData metaData;
+		QByteArray data;
+		qint64 size = 0;
+		quint64 accessCounter = 0;
+	};
+
+	void removeEntry(const QUrl &url);
+	void evictEntries();
+	static qint64 getMetaDataSize(const QNetworkCacheMetaData &metaData);
+
+protected slots:
+	void handleOptionChanged(int identifier, const QVariant &value);
+
+private:
+	QHash<QUrl, Entry> m_entries;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QMap<quint64, QUrl> m_accessOrder;
+	QSet<QIODevice*> m_discardedDevices;
+	qint64 m_size;
+	qint64 m_maximumSize;
+	quint64 m_accessCounter;
+};
+
+}
+
+#endif
@@ -0,0 +1,395 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "MetricsExporter.h"
+#include "Application.h"
+#include "Console.h"
+#include "ContentFiltersManager.h"
+#include "EventLoopWatchdog.h"
+#include "NetworkCache.h"
+#include "NetworkManagerFactory.h"
+#include "PlatformIntegration.h"
+#include "SettingsManager.h"
+#include "Utils.h"
+#include "../ui/MainWindow.h"
+#include "../ui/Window.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+MetricsExporter* MetricsExporter::m_instance(nullptr);
+QMutex MetricsExporter::m_saveStatisticsMutex;
+QHash<QString, MetricsExporter::SaveStatistics> MetricsExporter::m_saveStatistics;
+
+MetricsExporter::MetricsExporter(QObject *parent) : QObject(parent),
+	m_format(JsonLinesFormat),
+	m_exportTimer(0)
+{
+	handleOptionChanged(SettingsManager::Browser_MetricsExportPathOption);
+	handleOptionChanged(SettingsManager::Browser_MetricsExportFormatOption);
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &MetricsExporter::handleOptionChanged);
+}
+
+void MetricsExporter::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new MetricsExporter(QCoreApplication::instance());
+	}
+}
+
+void MetricsExporter::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_exportTimer)
+	{
+		exportMetrics();
+	}
+}
+
+void MetricsExporter::exportMetrics()
+{
+	if (m_path.isEmpty())
+	{
+		return;
+	}
+
+	QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+	const QVector<Sample> samples(collectSamples());
+
+	if (m_format == PrometheusFormat)
+	{
+		QSaveFile file(m_path);
+
+		if (!file.open(QIODevice::WriteOnly) || file.write(createPrometheusText(samples)) < 0 || !file.commit())
+		{
+			Console::addMessage(tr("Failed to write performance metrics"), Console::OtherCategory, Console::ErrorLevel, m_path);
+		}
+
+		return;
+	}
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(createJsonLine(samples)) < 0)
+	{
+		Console::addMessage(tr("Failed to write performance metrics"), Console::OtherCategory, Console::ErrorLevel, m_path);
+	}
+}
+
+void MetricsExporter::updateTimer()
+{
+	if (m_exportTimer != 0)
+	{
+		killTimer(m_exportTimer);
+
+		m_exportTimer = 0;
+	}
+
+	if (!m_path.isEmpty())
+	{
+		m_exportTimer = startTimer(qMax(static_cast<int>(MinimumExportInterval), SettingsManager::getOption(SettingsManager::Browser_MetricsExportIntervalOption).toInt()) * 1000);
+	}
+}
+
+void MetricsExporter::addSaveDuration(const QString &subsystem, qint64 duration)
+{
+	m_saveStatisticsMutex.lock();
+
+	SaveStatistics &statistics(m_saveStatistics[subsystem]);
+	statistics.lastDuration = duration;
+	statistics.longestDuration = qMax(statistics.longestDuration, duration);
+	statistics.totalDuration += duration;
+
+	++statistics.amount;
+
+	m_saveStatisticsMutex.unlock();
+}
+
+void MetricsExporter::handleOptionChanged(int identifier)
+{
+	switch (identifier)
+	{
+		case SettingsManager::Browser_MetricsExportFormatOption:
+			m_format = ((SettingsManager::getOption(identifier).toString() == QLatin1String("prometheus")) ? PrometheusFormat : JsonLinesFormat);
+
+			break;
+		case SettingsManager::Browser_MetricsExportIntervalOption:
+			updateTimer();
+
+			break;
+		case SettingsManager::Browser_MetricsExportPathOption:
+			m_path = Utils::normalizePath(SettingsManager::getOption(identifier).toString());
+
+			updateTimer();
+
+			break;
+		default:
+			break;
+	}
+}
+
+MetricsExporter* MetricsExporter::getInstance()
+{
+	return m_instance;
+}
+
+QVector<MetricsExporter::Sample> MetricsExporter::collectSamples()
+{
+	QVector<Sample> samples;
+	const auto addSample([&](const QString &name, double value, const QString &labelName, const QString &labelValue)
+	{
+		Sample sample;
+		sample.name = name;
+		sample.labelName = labelName;
+		sample.labelValue = labelValue;
+		sample.value = value;
+
+		samples.append(sample);
+	});
+	const QVector<QPair<QString, qint64> > startupPhasesDurations(Application::getStartupPhasesDurations());
+
+	for (int i = 0; i < startupPhasesDurations.count(); ++i)
+	{
+		addSample(QLatin1String("startup_phase_duration_ms"), startupPhasesDurations.at(i).second, QLatin1String("phase"), startupPhasesDurations.at(i).first);
+	}
+
+	QVector<int> eventLoopLags(Application::getEventLoopLags());
+
+	if (!eventLoopLags.isEmpty())
+	{
+		std::sort(eventLoopLags.begin(), eventLoopLags.end());
+
+		const QVector<QPair<QString, int> > percentiles({{QLatin1String("0.5"), 50}, {QLatin1String("0.9"), 90}, {QLatin1String("0.99"), 99}, {QLatin1String("1"), 100}});
+
+		for (int i = 0; i < percentiles.count(); ++i)
+		{
+			addSample(QLatin1String("event_loop_lag_ms"), eventLoopLags.at(((eventLoopLags.count() - 1) * percentiles.at(i).second) / 100), QLatin1String("quantile"), percentiles.at(i).first);
+		}
+	}
+
+	addSample(QLatin1String("slow_operations_total"), Application::getSlowOperationsAmount(), {}, {});
+
+	if (EventLoopWatchdog::isEnabled())
+	{
+		const EventLoopWatchdog::StallsStatistics stallsStatistics(EventLoopWatchdog::getStallsStatistics());
+
+		addSample(QLatin1String("event_loop_stalls_total"), stallsStatistics.amount, {}, {});
+		addSample(QLatin1String("event_loop_longest_stall_ms"), stallsStatistics.longestDuration, {}, {});
+	}
+
+	const PlatformIntegration *platformIntegration(Application::getPlatformIntegration());
+
+	if (platformIntegration && platformIntegration->getResidentMemorySize() > 0)
+	{
+		addSample(QLatin1String("resident_memory_bytes"), platformIntegration->getResidentMemorySize(), {}, {});
+	}
+
+	QVector<ContentFiltersProfile*> contentFiltersProfiles(ContentFiltersManager::getContentBlockingProfiles());
+	contentFiltersProfiles.append(ContentFiltersManager::getFraudCheckingProfiles());
+
+	quint64 contentFiltersUsage(0);
+
+	for (int i = 0; i < contentFiltersProfiles.count(); ++i)
+	{
+		contentFiltersUsage += contentFiltersProfiles.at(i)->getMemoryUsage();
+	}
+
+	const NetworkCache *networkCache(NetworkManagerFactory::getCache());
+	const NetworkCache::LookupStatistics networkCacheLookupStatistics(networkCache->getLookupStatistics());
+	const NetworkCache::MemoryTierStatistics networkCacheStatistics(networkCache->getMemoryTierStatistics());
+
+	addSample(QLatin1String("memory_bytes"), contentFiltersUsage, QLatin1String("subsystem"), QLatin1String("content_filters"));
+	addSample(QLatin1String("memory_bytes"), networkCache->getIndexMemoryUsage(), QLatin1String("subsystem"), QLatin1String("cache_index"));
+	addSample(QLatin1String("memory_bytes"), networkCacheStatistics.size, QLatin1String("subsystem"), QLatin1String("cache_memory_tier"));
+
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QHash<QString, int> tabsAmounts({{QLatin1String("crashed"), 0}, {QLatin1String("deferred"), 0}, {QLatin1String("loaded"), 0}, {QLatin1String("loading"), 0}, {QLatin1String("suspended"), 0}});
+	qint64 bytesReceived(0);
+	quint64 requestsStarted(0);
+	quint64 requestsBlocked(0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		for (int j = 0; j < mainWindows.at(i)->getWindowCount(); ++j)
+		{
+			Window *window(mainWindows.at(i)->getWindowByIndex(j));
+
+			if (!window)
+			{
+				continue;
+			}
+
+			const WebWidget::LoadingState loadingState(window->getLoadingState());
+
+			switch (loadingState)
+			{
+				case WebWidget::DeferredLoadingState:
+					++tabsAmounts[window->isSuspended() ? QLatin1String("suspended") : QLatin1String("deferred")];
+
+					continue;
+				case WebWidget::OngoingLoadingState:
+					++tabsAmounts[QLatin1String("loading")];
+
+					break;
+				case WebWidget::CrashedLoadingState:
+					++tabsAmounts[QLatin1String("crashed")];
+
+					break;
+				default:
+					++tabsAmounts[QLatin1String("loaded")];
+
+					break;
+			}
+
+			const WebWidget *webWidget(window->getContentsWidget()->getWebWidget());
+
+			if (webWidget)
+			{
+				bytesReceived += webWidget->getPageInformation(WebWidget::TotalBytesReceivedInformation).toLongLong();
+				requestsStarted += webWidget->getPageInformation(WebWidget::RequestsStartedInformation).toULongLong();
+				requestsBlocked += webWidget->getPageInformation(WebWidget::RequestsBlockedInformation).toULongLong();
+			}
+		}
+	}
+
+	QHash<QString, int>::const_iterator tabsIterator;
+
+	for (tabsIterator = tabsAmounts.constBegin(); tabsIterator != tabsAmounts.constEnd(); ++tabsIterator)
+	{
+		addSample(QLatin1String("tabs"), tabsIterator.value(), QLatin1String("state"), tabsIterator.key());
+	}
+
+	addSample(QLatin1String("tabs_bytes_received"), bytesReceived, {}, {});
+	addSample(QLatin1String("tabs_requests_started"), requestsStarted, {}, {});
+	addSample(QLatin1String("tabs_requests_blocked"), requestsBlocked, {}, {});
+
+	const ContentFiltersManager::ResultsCacheStatistics contentFiltersStatistics(ContentFiltersManager::getResultsCacheStatistics());
+	const quint64 contentFiltersLookups(contentFiltersStatistics.hits + contentFiltersStatistics.misses);
+	const quint64 networkCacheLookups(networkCacheStatistics.hits + networkCacheStatistics.misses);
+	const quint64 networkCacheKeyLookups(networkCacheLookupStatistics.hits + networkCacheLookupStatistics.misses);
+
+	addSample(QLatin1String("content_filters_cache_hits_total"), contentFiltersStatistics.hits, {}, {});
+	addSample(QLatin1String("content_filters_cache_misses_total"), contentFiltersStatistics.misses, {}, {});
+	addSample(QLatin1String("content_filters_cache_hit_ratio"), ((contentFiltersLookups > 0) ? (static_cast<double>(contentFiltersStatistics.hits) / static_cast<double>(contentFiltersLookups)) : 0), {}, {});
+	addSample(QLatin1String("content_filters_matching_time_ms_total"), (static_cast<double>(contentFiltersStatistics.matchingTime) / 1000), {}, {});
+	addSample(QLatin1String("network_cache_memory_hits_total"), networkCacheStatistics.hits, {}, {});
+	addSample(QLatin1String("network_cache_memory_misses_total"), networkCacheStatistics.misses, {}, {});
+	addSample(QLatin1String("network_cache_memory_hit_ratio"), ((networkCacheLookups > 0) ? (static_cast<double>(networkCacheStatistics.hits) / static_cast<double>(networkCacheLookups)) : 0), {}, {});
+	addSample(QLatin1String("network_cache_hits_total"), networkCacheLookupStatistics.hits, {}, {});
+	addSample(QLatin1String("network_cache_misses_total"), networkCacheLookupStatistics.misses, {}, {});
+	addSample(QLatin1String("network_cache_hit_ratio"), ((networkCacheKeyLookups > 0) ? (static_cast<double>(networkCacheLookupStatistics.hits) / static_cast<double>(networkCacheKeyLookups)) : 0), {}, {});
+	addSample(QLatin1String("network_cache_normalized_keys_total"), networkCacheLookupStatistics.normalizedKeys, {}, {});
+	addSample(QLatin1String("network_cache_normalized_hits_total"), networkCacheLookupStatistics.normalizedHits, {}, {});
+
+	m_saveStatisticsMutex.lock();
+
+	const QHash<QString, SaveStatistics> saveStatistics(m_saveStatistics);
+
+	m_saveStatisticsMutex.unlock();
+
+	QHash<QString, SaveStatistics>::const_iterator savesIterator;
+
+	for (savesIterator = saveStatistics.constBegin(); savesIterator != saveStatistics.constEnd(); ++savesIterator)
+	{
+		addSample(QLatin1String("saves_total"), savesIterator.value().amount, QLatin1String("subsystem"), savesIterator.key());
+		addSample(QLatin1String("save_duration_ms_total"), savesIterator.value().totalDuration, QLatin1String("subsystem"), savesIterator.key());
+		addSample(QLatin1String("save_last_duration_ms"), savesIterator.value().lastDuration, QLatin1String("subsystem"), savesIterator.key());
+		addSample(QLatin1String("save_longest_duration_ms"), savesIterator.value().longestDuration, QLatin1String("subsystem"), savesIterator.key());
+	}
+
+	return samples;
+}
+
+QByteArray MetricsExporter::createJsonLine(const QVector<Sample> &samples)
+{
+	QJsonObject object({{QLatin1String("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate)}});
+
+	for (int i = 0; i < samples.count(); ++i)
+	{
+		const Sample &sample(samples.at(i));
+
+		if (sample.labelName.isEmpty())
+		{
+			object.insert(sample.name, sample.value);
+		}
+		else
+		{
+			QJsonObject labelsObject(object.value(sample.name).toObject());
+			labelsObject.insert(sample.labelValue, sample.value);
+
+			object.insert(sample.name, labelsObject);
+		}
+	}
+
+	return (QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n');
+}
+
+QByteArray MetricsExporter::createPrometheusText(const QVector<Sample> &samples)
+{
+	QByteArray text;
+	QString previousName;
+
+	for (int i = 0; i < samples.count(); ++i)
+	{
+		const Sample &sample(samples.at(i));
+		const QByteArray name(QByteArrayLiteral("otter_") + sample.name.toLatin1());
+
+		if (sample.name != previousName)
+		{
+			text.append(QByteArrayLiteral("# TYPE ") + name + (sample.name.endsWith(QLatin1String("_total")) ? QByteArrayLiteral(" counter\n") : QByteArrayLiteral(" gauge\n")));
+
+			previousName = sample.name;
+		}
+
+		text.append(name);
+
+		if (!sample.labelName.isEmpty())
+		{
+			QString labelValue(sample.labelValue);
+			labelValue.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+			labelValue.replace(QLatin1Char('"'), QLatin1String("\\\""));
+
+			text.append('{' + sample.labelName.toLatin1() + QByteArrayLiteral("=\"") + labelValue.toUtf8() + QByteArrayLiteral("\"}"));
+		}
+
+		text.append(' ' + QByteArray::number(sample.value, 'g', 15) + '\n');
+	}
+
+	return text;
+}
+
+bool MetricsExporter::isEnabled()
+{
+	return (m_instance && !m_instance->m_path.isEmpty());
+}
+
+}
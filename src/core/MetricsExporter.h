@@ -0,0 +1,93 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_METRICSEXPORTER_H
+#define OTTER_METRICSEXPORTER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class MetricsExporter final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static void addSaveDuration(const QString &subsystem, qint64 duration);
+	static MetricsExporter* getInstance();
+	static bool isEnabled();
+
+protected:
+	enum ExportFormat
+	{
+		JsonLinesFormat = 0,
+		PrometheusFormat
+	};
+
+	enum ExportParameter
+	{
+		MinimumExportInterval = 5
+	};
+
+	struct Sample final
+	{
+		QString name;
+		QString labelName;
+		QString labelValue;
+		double value = 0;
+	};
+
+	struct SaveStatistics final
+	{
+		quint64 amount = 0;
+		qint64 lastDuration = 0;
+		qint64 longestDuration = 0;
+		qint64 totalDuration = 0;
+	};
+
+	explicit MetricsExporter(QObject *parent = nullptr);
+
+	void timerEvent(QTimerEvent *event) override;
+	void exportMetrics();
+	void updateTimer();
+	static QVector<Sample> collectSamples();
+	static QByteArray createJsonLine(const QVector<Sample> &samples);
+	static QByteArray createPrometheusText(const QVector<Sample> &samples);
+
+protected slots:
+	void handleOptionChanged(int identifier);
+
+private:
+	QString m_path;
+	ExportFormat m_format;
+	int m_exportTimer;
+
+	static MetricsExporter *m_instance;
+	static QMutex m_saveStatisticsMutex;
+	static QHash<QString, SaveStatistics> m_saveStatistics;
+};
+
+}
+
+#endif
@@ -26,10 +26,14 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 #include "ToolBarsManager.h"
+#include "Tracer.h"
 #include "../ui/ItemViewWidget.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDate>
 #include <QtCore/QDir>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 #include <QtCore/QSettings>
@@ -38,6 +42,7 @@
 #include <QtWidgets/QDialog>
 #include <QtWidgets/QDialogButtonBox>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QProgressDialog>
 #include <QtWidgets/QVBoxLayout>
 
 namespace Otter
@@ -506,9 +511,12 @@ bool Migration::needsMigration() const
 
 bool Migrator::run()
 {
+	const Tracer::Span span("Migrator::run");
+
 	const QVector<Migration*> availableMigrations({new KeyboardAndMouseProfilesIniToJsonMigration(), new OptionsRenameMigration(), new SessionsIniToJsonMigration()});
 	QVector<Migration*> possibleMigrations;
 	QStringList processedMigrations(SettingsManager::getOption(SettingsManager::Browser_MigrationsOption).toStringList());
+	const int amountOfProcessedMigrations(processedMigrations.count());
 
 	for (int i = 0; i < availableMigrations.count(); ++i)
 	{
@@ -527,7 +535,12 @@ bool Migrator::run()
 
 	if (possibleMigrations.isEmpty())
 	{
-		SettingsManager::setOption(SettingsManager::Browser_MigrationsOption, QVariant(processedMigrations));
+		if (processedMigrations.count() != amountOfProcessedMigrations)
+		{
+			SettingsManager::setOption(SettingsManager::Browser_MigrationsOption, QVariant(processedMigrations));
+		}
+
+		qDeleteAll(availableMigrations);
 
 		return true;
 	}
@@ -587,21 +600,51 @@ bool Migrator::run()
 
 	if (canProceed || createBackupCheckBox->isChecked())
 	{
-		processedMigrations.reserve(possibleMigrations.count());
+		const bool shouldCreateBackup(createBackupCheckBox->isChecked());
+
+		processedMigrations.reserve(processedMigrations.count() + possibleMigrations.count());
 
 		for (int i = 0; i < possibleMigrations.count(); ++i)
 		{
 			processedMigrations.append(possibleMigrations.at(i)->getName());
+		}
 
-			if (createBackupCheckBox->isChecked())
-			{
-				possibleMigrations.at(i)->createBackup();
-			}
+		QProgressDialog progressDialog(QCoreApplication::translate("Otter::Migrator", "Migrating configuration…"), {}, 0, possibleMigrations.count());
+		progressDialog.setWindowTitle(dialog.windowTitle());
+		progressDialog.setWindowModality(Qt::ApplicationModal);
+		progressDialog.setMinimumDuration(0);
+		progressDialog.setValue(0);
+
+		QEventLoop eventLoop;
+		QFutureWatcher<void> watcher;
 
-			if (canProceed)
+		QObject::connect(&watcher, &QFutureWatcher<void>::finished, &eventLoop, &QEventLoop::quit);
+
+		watcher.setFuture(QtConcurrent::run([&]()
+		{
+			for (int i = 0; i < possibleMigrations.count(); ++i)
 			{
-				possibleMigrations.at(i)->migrate();
+				if (shouldCreateBackup)
+				{
+					possibleMigrations.at(i)->createBackup();
+				}
+
+				if (canProceed)
+				{
+					possibleMigrations.at(i)->migrate();
+				}
+
+				QMetaObject::invokeMethod(&progressDialog, "setValue", Qt::QueuedConnection, Q_ARG(int, (i + 1)));
 			}
+		}));
+
+		eventLoop.exec();
+
+		progressDialog.setValue(possibleMigrations.count());
+
+		if (canProceed)
+		{
+			SettingsManager::loadOptions();
 		}
 	}
 
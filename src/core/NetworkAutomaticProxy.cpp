@@ -21,11 +21,14 @@
 #include "NetworkAutomaticProxy.h"
 #include "Console.h"
 #include "Job.h"
+#include "NetworkManagerFactory.h"
+#include "SettingsManager.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDate>
+#include <QtCore/QEventLoop>
 #include <QtCore/QFile>
-#include <QtNetwork/QHostInfo>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkInterface>
 
 namespace Otter
@@ -34,7 +37,8 @@ namespace Otter
 QStringList PacUtils::m_months = {QLatin1String("jan"), QLatin1String("feb"), QLatin1String("mar"), QLatin1String("apr"), QLatin1String("may"), QLatin1String("jun"), QLatin1String("jul"), QLatin1String("aug"), QLatin1String("sep"), QLatin1String("oct"), QLatin1String("nov"), QLatin1String("dec")};
 QStringList PacUtils::m_days = {QLatin1String("mon"), QLatin1String("tue"), QLatin1String("wed"), QLatin1String("thu"), QLatin1String("fri"), QLatin1String("sat"), QLatin1String("sun")};
 
-PacUtils::PacUtils(QObject *parent) : QObject(parent)
+PacUtils::PacUtils(QObject *parent) : QObject(parent),
+	m_addressExpirationTime(0)
 {
 }
 
@@ -45,7 +49,7 @@ void PacUtils::alert(const QString &message) const
 
 QString PacUtils::dnsResolve(const QString &host) const
 {
-	const QHostInfo hostInformation(QHostInfo::fromName(host));
+	const QHostInfo hostInformation(lookupHost(host));
 
 	if (hostInformation.error() == QHostInfo::NoError && !hostInformation.addresses().isEmpty())
 	{
@@ -57,17 +61,29 @@ QString PacUtils::dnsResolve(const QString &host) const
 
 QString PacUtils::myIpAddress() const
 {
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+
+	if (m_addressExpirationTime > currentTime)
+	{
+		return m_address;
+	}
+
 	const QList<QHostAddress> addresses(QNetworkInterface::allAddresses());
 
+	m_address.clear();
+	m_addressExpirationTime = (currentTime + AddressCacheTime);
+
 	for (int i = 0; i < addresses.count(); ++i)
 	{
 		if (!addresses.at(i).isNull() && addresses.at(i) != QHostAddress::LocalHost && addresses.at(i) != QHostAddress::LocalHostIPv6 && addresses.at(i) != QHostAddress::Null && addresses.at(i) != QHostAddress::Broadcast && addresses.at(i) != QHostAddress::Any && addresses.at(i) != QHostAddress::AnyIPv6)
 		{
-			return addresses.at(i).toString();
+			m_address = addresses.at(i).toString();
+
+			break;
 		}
 	}
 
-	return {};
+	return m_address;
 }
 
 int PacUtils::dnsDomainLevels(const QString &host) const
@@ -82,7 +98,7 @@ int PacUtils::dnsDomainLevels(const QString &host) const
 
 bool PacUtils::isInNet(const QString &host, const QString &pattern, const QString &mask) const
 {
-	const QHostAddress address(host);
+	const QHostAddress address(QHostAddress(host).isNull() ? dnsResolve(host) : host);
 	const QHostAddress netaddress(pattern);
 	const QHostAddress netmask(mask);
 
@@ -96,7 +112,7 @@ bool PacUtils::isPlainHostName(const QString &host) const
 
 bool PacUtils::isResolvable(const QString &host) const
 {
-	return (QHostInfo::fromName(host).error() == QHostInfo::NoError);
+	return (lookupHost(host).error() == QHostInfo::NoError);
 }
 
 bool PacUtils::localHostOrDomainIs(const QString &host, QString domain) const
@@ -285,6 +301,59 @@ bool PacUtils::timeRange(const QVariant &arg1, const QVariant &arg2, const QVari
 	return false;
 }
 
+QHostInfo PacUtils::lookupHost(const QString &host) const
+{
+	QHostInfo information;
+
+	if (NetworkManagerFactory::getHostInformation(host, information))
+	{
+		return information;
+	}
+
+#if QT_VERSION >= 0x050900
+	QEventLoop eventLoop;
+	bool isFinished(false);
+	const int lookupIdentifier(QHostInfo::lookupHost(host, [&](const QHostInfo &result)
+	{
+		information = result;
+
+		isFinished = true;
+
+		eventLoop.quit();
+	}));
+
+	QTimer timer;
+	timer.setSingleShot(true);
+
+	connect(&timer, &QTimer::timeout, [&]()
+	{
+		QHostInfo::abortHostLookup(lookupIdentifier);
+
+		information.setError(QHostInfo::UnknownError);
+
+		eventLoop.quit();
+	});
+
+	timer.start(HostLookupTimeout);
+
+	if (!isFinished)
+	{
+		eventLoop.exec();
+	}
+
+	if (!isFinished)
+	{
+		return information;
+	}
+#else
+	information = QHostInfo::fromName(host);
+#endif
+
+	NetworkManagerFactory::cacheHostInformation(host, information);
+
+	return information;
+}
+
 bool PacUtils::isDateInRange(const QDate &from, const QDate &to, const QDate &value) const
 {
 	return (value >= from && value <= to);
@@ -300,27 +369,202 @@ bool PacUtils::isNumberInRange(int from, int to, int value) const
 	return (value >= from && value <= to);
 }
 
-NetworkAutomaticProxy::NetworkAutomaticProxy(const QString &path, QObject *parent) : QObject(parent),
-	m_path(path),
-	m_isValid(false)
+PacEvaluator::PacEvaluator(QObject *parent) : QThread(parent),
+	m_isStopping(false)
+{
+}
+
+PacEvaluator::~PacEvaluator()
+{
+	m_mutex.lock();
+
+	m_isStopping = true;
+
+	while (!m_requests.isEmpty())
+	{
+		m_requests.dequeue()->isFinished = true;
+	}
+
+	m_requestsCondition.wakeAll();
+	m_resultsCondition.wakeAll();
+	m_mutex.unlock();
+
+	wait();
+}
+
+void PacEvaluator::run()
 {
-	m_engine.globalObject().setProperty(QLatin1String("PacUtils"), m_engine.newQObject(new PacUtils(this)));
+	QJSEngine engine;
+	engine.globalObject().setProperty(QLatin1String("PacUtils"), engine.newQObject(new PacUtils(&engine)));
 
 	const QStringList functions({QLatin1String("alert"), QLatin1String("dnsResolve"), QLatin1String("myIpAddress"), QLatin1String("dnsDomainLevels"), QLatin1String("isInNet"), QLatin1String("isPlainHostName"), QLatin1String("isResolvable"), QLatin1String("localHostOrDomainIs"), QLatin1String("dnsDomainIs"), QLatin1String("shExpMatch"), QLatin1String("weekdayRange"), QLatin1String("dateRange"), QLatin1String("timeRange")});
 
 	for (int i = 0; i < functions.count(); ++i)
 	{
-		m_engine.evaluate(QStringLiteral("function %1() { return PacUtils.%1.apply(null, arguments); }").arg(functions.at(i))).isError();
+		engine.evaluate(QStringLiteral("function %1() { return PacUtils.%1.apply(null, arguments); }").arg(functions.at(i))).isError();
+	}
+
+	QJSValue findProxy;
+
+	while (true)
+	{
+		m_mutex.lock();
+
+		while (m_requests.isEmpty() && !m_isStopping)
+		{
+			m_requestsCondition.wait(&m_mutex);
+		}
+
+		if (m_isStopping)
+		{
+			m_mutex.unlock();
+
+			return;
+		}
+
+		Request *request(m_requests.dequeue());
+
+		m_mutex.unlock();
+
+		if (request->isSetup)
+		{
+			request->isSuccess = !engine.evaluate(request->script).isError();
+
+			if (request->isSuccess)
+			{
+				findProxy = engine.globalObject().property(QLatin1String("FindProxyForURL"));
+
+				request->isSuccess = findProxy.isCallable();
+			}
+		}
+		else if (findProxy.isCallable())
+		{
+			const QJSValue result(findProxy.call(QJSValueList({engine.toScriptValue(request->url), engine.toScriptValue(request->host)})));
+
+			request->isSuccess = !result.isError();
+			request->result = result.toString();
+		}
+
+		m_mutex.lock();
+
+		request->isFinished = true;
+
+		m_resultsCondition.wakeAll();
+		m_mutex.unlock();
+	}
+}
+
+bool PacEvaluator::setup(const QString &script)
+{
+	Request request;
+	request.script = script;
+	request.isSetup = true;
+
+	return postRequest(&request);
+}
+
+bool PacEvaluator::evaluate(const QString &url, const QString &host, QString &result)
+{
+	Request request;
+	request.url = url;
+	request.host = host;
+
+	if (!postRequest(&request))
+	{
+		return false;
 	}
 
+	result = request.result;
+
+	return true;
+}
+
+bool PacEvaluator::postRequest(Request *request)
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (m_isStopping || (!request->isSetup && m_requests.count() >= QueueLimit))
+	{
+		return false;
+	}
+
+	m_requests.enqueue(request);
+	m_requestsCondition.wakeOne();
+
+	while (!request->isFinished)
+	{
+		m_resultsCondition.wait(&m_mutex);
+	}
+
+	return request->isSuccess;
+}
+
+NetworkAutomaticProxy::NetworkAutomaticProxy(const QString &path, QObject *parent) : QObject(parent),
+	m_cacheMode(HostCache),
+	m_cacheTime(0),
+	m_isValid(false)
+{
 	m_proxies.insert(QLatin1String("ERROR"), QVector<QNetworkProxy>({QNetworkProxy(QNetworkProxy::DefaultProxy)}));
 	m_proxies.insert(QLatin1String("DIRECT"), QVector<QNetworkProxy>({QNetworkProxy(QNetworkProxy::NoProxy)}));
 
+	m_evaluator.start();
+
+	handleOptionChanged(SettingsManager::Network_ProxyAutoConfigCacheModeOption, SettingsManager::getOption(SettingsManager::Network_ProxyAutoConfigCacheModeOption));
+	handleOptionChanged(SettingsManager::Network_ProxyAutoConfigCacheTimeOption, SettingsManager::getOption(SettingsManager::Network_ProxyAutoConfigCacheTimeOption));
 	setPath(path);
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &NetworkAutomaticProxy::handleOptionChanged);
+}
+
+void NetworkAutomaticProxy::handleOptionChanged(int identifier, const QVariant &value)
+{
+	switch (identifier)
+	{
+		case SettingsManager::Network_ProxyAutoConfigCacheModeOption:
+			{
+				const QString mode(value.toString());
+				QMutexLocker locker(&m_mutex);
+
+				if (mode == QLatin1String("disabled"))
+				{
+					m_cacheMode = NoCache;
+				}
+				else if (mode == QLatin1String("url"))
+				{
+					m_cacheMode = UrlCache;
+				}
+				else
+				{
+					m_cacheMode = HostCache;
+				}
+
+				m_cache.clear();
+			}
+
+			break;
+		case SettingsManager::Network_ProxyAutoConfigCacheTimeOption:
+			{
+				QMutexLocker locker(&m_mutex);
+
+				m_cacheTime = (qMax(0, value.toInt()) * 1000);
+
+				m_cache.clear();
+			}
+
+			break;
+		default:
+			break;
+	}
 }
 
 void NetworkAutomaticProxy::setPath(const QString &path)
 {
+	m_path = path;
+
+	m_mutex.lock();
+	m_cache.clear();
+	m_mutex.unlock();
+
 	if (QFile::exists(path))
 	{
 		QFile file(path);
@@ -374,15 +618,75 @@ QString NetworkAutomaticProxy::getPath() const
 
 QVector<QNetworkProxy> NetworkAutomaticProxy::getProxy(const QString &url, const QString &host)
 {
-	const QJSValue result(m_findProxy.call(QJSValueList({m_engine.toScriptValue(url), m_engine.toScriptValue(host)})));
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	QString key;
+
+	m_mutex.lock();
 
-	if (result.isError())
+	if (m_cacheMode != NoCache && m_cacheTime > 0)
 	{
+		key = ((m_cacheMode == HostCache) ? host.toLower() : url);
+
+		if (m_cache.contains(key) && m_cache[key].expirationTime > currentTime)
+		{
+			const QVector<QNetworkProxy> proxies(m_cache[key].proxies);
+
+			m_mutex.unlock();
+
+			return proxies;
+		}
+	}
+
+	m_mutex.unlock();
+
+	QString result;
+
+	if (!m_evaluator.evaluate(url, host, result))
+	{
+		QMutexLocker locker(&m_mutex);
+
 		return m_proxies[QLatin1String("ERROR")];
 	}
 
-	const QString configuration(result.toString().remove(QLatin1Char(' ')));
+	QMutexLocker locker(&m_mutex);
+	const QVector<QNetworkProxy> proxies(parseProxies(result.remove(QLatin1Char(' '))));
 
+	if (!key.isEmpty() && proxies.value(0).type() != QNetworkProxy::DefaultProxy)
+	{
+		if (m_cache.count() >= CacheLimit)
+		{
+			QHash<QString, CacheEntry>::iterator iterator(m_cache.begin());
+
+			while (iterator != m_cache.end())
+			{
+				if (iterator.value().expirationTime <= currentTime)
+				{
+					iterator = m_cache.erase(iterator);
+				}
+				else
+				{
+					++iterator;
+				}
+			}
+
+			if (m_cache.count() >= CacheLimit)
+			{
+				m_cache.clear();
+			}
+		}
+
+		CacheEntry entry;
+		entry.proxies = proxies;
+		entry.expirationTime = (currentTime + m_cacheTime);
+
+		m_cache[key] = entry;
+	}
+
+	return proxies;
+}
+
+QVector<QNetworkProxy> NetworkAutomaticProxy::parseProxies(const QString &configuration)
+{
 	if (!m_proxies.value(configuration).isEmpty())
 	{
 		return m_proxies[configuration];
@@ -436,14 +740,16 @@ bool NetworkAutomaticProxy::isValid() const
 
 bool NetworkAutomaticProxy::setup(const QString &script)
 {
-	if (m_engine.evaluate(script).isError())
+	if (!m_evaluator.setup(script))
 	{
 		return false;
 	}
 
-	m_findProxy = m_engine.globalObject().property(QLatin1String("FindProxyForURL"));
+	QMutexLocker locker(&m_mutex);
+
+	m_cache.clear();
 
-	return m_findProxy.isCallable();
+	return true;
 }
 
 }
@@ -21,6 +21,11 @@
 #ifndef OTTER_NETWORKAUTOMATICPROXY_H
 #define OTTER_NETWORKAUTOMATICPROXY_H
 
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtNetwork/QHostInfo>
 #include <QtNetwork/QNetworkProxy>
 #include <QtQml/QJSEngine>
 
@@ -50,18 +55,74 @@ public slots:
 	bool timeRange(const QVariant &arg1, const QVariant &arg2, const QVariant &arg3, const QVariant &arg4, const QVariant &arg5, const QVariant &arg6, const QString &gmt = QLatin1String("gmt")) const;
 
 protected:
+	enum HostLookupParameter
+	{
+		HostLookupTimeout = 2000,
+		AddressCacheTime = 60000
+	};
+
+	QHostInfo lookupHost(const QString &host) const;
 	bool isDateInRange(const QDate &from, const QDate &to, const QDate &value) const;
 	bool isTimeInRange(const QTime &from, const QTime &to, const QTime &value) const;
 	bool isNumberInRange(int from, int to, int value) const;
 
 private:
+	mutable QString m_address;
+	mutable qint64 m_addressExpirationTime;
+
 	static QStringList m_months;
 	static QStringList m_days;
 };
 
+class PacEvaluator final : public QThread
+{
+public:
+	explicit PacEvaluator(QObject *parent = nullptr);
+	~PacEvaluator();
+
+	bool setup(const QString &script);
+	bool evaluate(const QString &url, const QString &host, QString &result);
+
+protected:
+	enum QueueParameter
+	{
+		QueueLimit = 100
+	};
+
+	struct Request final
+	{
+		QString script;
+		QString url;
+		QString host;
+		QString result;
+		bool isSetup = false;
+		bool isSuccess = false;
+		bool isFinished = false;
+	};
+
+	void run() override;
+	bool postRequest(Request *request);
+
+private:
+	QQueue<Request*> m_requests;
+	QMutex m_mutex;
+	QWaitCondition m_requestsCondition;
+	QWaitCondition m_resultsCondition;
+	bool m_isStopping;
+};
+
 class NetworkAutomaticProxy final : public QObject
 {
+	Q_OBJECT
+
 public:
+	enum CacheMode
+	{
+		NoCache = 0,
+		HostCache,
+		UrlCache
+	};
+
 	explicit NetworkAutomaticProxy(const QString &path, QObject *parent = nullptr);
 
 	void setPath(const QString &path);
@@ -70,13 +131,31 @@ public:
 	bool isValid() const;
 
 protected:
+	enum CacheParameter
+	{
+		CacheLimit = 1000
+	};
+
+	struct CacheEntry final
+	{
+		QVector<QNetworkProxy> proxies;
+		qint64 expirationTime = 0;
+	};
+
+	QVector<QNetworkProxy> parseProxies(const QString &configuration);
 	bool setup(const QString &script);
 
+protected slots:
+	void handleOptionChanged(int identifier, const QVariant &value);
+
 private:
-	QJSEngine m_engine;
-	QJSValue m_findProxy;
+	PacEvaluator m_evaluator;
 	QString m_path;
 	QHash<QString, QVector<QNetworkProxy> > m_proxies;
+	QHash<QString, CacheEntry> m_cache;
+	QMutex m_mutex;
+	CacheMode m_cacheMode;
+	int m_cacheTime;
 	bool m_isValid;
 };
 
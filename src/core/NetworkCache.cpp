@@ -21,14 +21,42 @@
 #include "SessionsManager.h"
 #include "SettingsManager.h"
 
-#include <QtCore/QDateTime>
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <cstring>
 
 namespace Otter
 {
 
-NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
+NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent),
+	m_rebuildIterator(nullptr),
+	m_totalSize(0),
+	m_memoryTierSize(0),
+	m_memoryAccessCounter(0),
+	m_memoryTierHits(0),
+	m_memoryTierMisses(0),
+	m_memoryTierRejections(0),
+	m_lookupHits(0),
+	m_lookupMisses(0),
+	m_normalizedKeys(0),
+	m_normalizedHits(0),
+	m_frequencySketchAdditions(0),
+	m_loadPolicy(NetworkLoadPolicy),
+	m_rebuildTimer(0),
+	m_isClearing(false),
+	m_isDeduplicationEnabled(false)
 {
+	m_frequencySketch.fill(0, (FrequencySketchDepth * FrequencySketchWidth));
+
+	handleOptionChanged(SettingsManager::Cache_IgnoredQueryParametersOption, SettingsManager::getOption(SettingsManager::Cache_IgnoredQueryParametersOption));
+
 	const QString cachePath(SessionsManager::getCachePath());
 
 	if (!cachePath.isEmpty())
@@ -37,164 +65,1411 @@ NetworkCache::NetworkCache(QObject *parent) : QNetworkDiskCache(parent)
 
 		setCacheDirectory(cachePath);
 		setMaximumCacheSize(SettingsManager::getOption(SettingsManager::Cache_DiskCacheLimitOption).toInt() * 1024);
+		handleOptionChanged(SettingsManager::Cache_LoadPolicyOption, SettingsManager::getOption(SettingsManager::Cache_LoadPolicyOption));
+
+		m_isDeduplicationEnabled = SettingsManager::getOption(SettingsManager::Cache_EnableContentDeduplicationOption).toBool();
+
+		loadIndex();
 
 		connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &NetworkCache::handleOptionChanged);
+		connect(&m_evictionWatcher, &QFutureWatcher<void>::finished, this, &NetworkCache::handleEvictionFinished);
+
+		const QFileInfo cacheInformation(QDir(cachePath).absolutePath());
+		const QFileInfoList trashedDirectories(cacheInformation.dir().entryInfoList({cacheInformation.fileName() + QLatin1String(".trash-*")}, (QDir::Dirs | QDir::NoDotAndDotDot)));
+
+		if (!trashedDirectories.isEmpty())
+		{
+			QStringList paths;
+			paths.reserve(trashedDirectories.count());
+
+			for (int i = 0; i < trashedDirectories.count(); ++i)
+			{
+				paths.append(trashedDirectories.at(i).absoluteFilePath());
+			}
+
+			m_evictionWatcher.setFuture(QtConcurrent::run(&NetworkCache::removeDirectories, paths));
+		}
 	}
 }
 
-void NetworkCache::handleOptionChanged(int identifier, const QVariant &value)
+NetworkCache::~NetworkCache()
 {
-	if (identifier == SettingsManager::Cache_DiskCacheLimitOption)
+	m_evictionWatcher.waitForFinished();
+
+	qDeleteAll(m_contentDevices);
+
+	if (m_rebuildIterator)
 	{
-		setMaximumCacheSize(value.toInt() * 1024);
+		delete m_rebuildIterator;
+	}
+	else if (!cacheDirectory().isEmpty())
+	{
+		saveIndex();
 	}
 }
 
-void NetworkCache::clearCache(int period)
+void NetworkCache::timerEvent(QTimerEvent *event)
 {
-	if (period <= 0)
+	if (event->timerId() != m_rebuildTimer)
 	{
-		clear();
-
-		emit cleared();
-
 		return;
 	}
 
-	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
-
-	for (int i = 0; i < directories.count(); ++i)
+	for (int i = 0; i < RebuildBatchSize; ++i)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		if (!m_rebuildIterator->hasNext())
+		{
+			killTimer(m_rebuildTimer);
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+			m_rebuildTimer = 0;
+
+			delete m_rebuildIterator;
+
+			m_rebuildIterator = nullptr;
+
+			emit indexRebuilt();
+
+			removeOrphanedContents();
+
+			if (m_totalSize > maximumCacheSize())
+			{
+				evictEntries();
+			}
+
+			return;
+		}
+
+		const QString path(m_rebuildIterator->next());
+		const QNetworkCacheMetaData metaData(fileMetaData(path));
+
+		if (metaData.url().isValid() && !m_entriesPositions.contains(metaData.url()))
 		{
-			const QFileInfoList files(QDir(cacheSubDirectory.absoluteFilePath(subDirectories.at(j))).entryInfoList(QDir::Files));
+			EntryInformation entry(createEntryInformation(metaData));
+			entry.path = path;
+			entry.size = m_rebuildIterator->fileInfo().size();
+			entry.accessTime = m_rebuildIterator->fileInfo().lastModified().toMSecsSinceEpoch();
 
-			for (int k = 0; k < files.count(); ++k)
+			addIndexEntry(entry);
+		}
+	}
+}
+
+void NetworkCache::handleOptionChanged(int identifier, const QVariant &value)
+{
+	switch (identifier)
+	{
+		case SettingsManager::Cache_DiskCacheLimitOption:
+			setMaximumCacheSize(value.toInt() * 1024);
+
+			break;
+		case SettingsManager::Cache_EnableContentDeduplicationOption:
+			m_isDeduplicationEnabled = value.toBool();
+
+			break;
+		case SettingsManager::Cache_IgnoredQueryParametersOption:
 			{
-				if (files.at(k).lastModified().toUTC().secsTo(currentDateTime) < (period * 3600))
+				const QStringList rules(value.toStringList());
+
+				m_ignoredQueryParameters.clear();
+				m_ignoredHostQueryParameters.clear();
+
+				for (int i = 0; i < rules.count(); ++i)
 				{
-					const QNetworkCacheMetaData metaData(fileMetaData(files.at(k).absoluteFilePath()));
+					const QString rule(rules.at(i).trimmed());
+					const int separatorPosition(rule.indexOf(QLatin1Char(':')));
 
-					if (metaData.isValid())
+					if (rule.isEmpty())
 					{
-						remove(metaData.url());
+						continue;
+					}
+
+					if (separatorPosition > 0)
+					{
+						m_ignoredHostQueryParameters.insert(rule.left(separatorPosition).toLower(), rule.mid(separatorPosition + 1));
+					}
+					else
+					{
+						m_ignoredQueryParameters.append(rule);
 					}
 				}
 			}
-		}
+
+			break;
+		case SettingsManager::Cache_LoadPolicyOption:
+			{
+				const QString policy(value.toString());
+
+				if (policy == QLatin1String("staleWhileRevalidate"))
+				{
+					m_loadPolicy = StaleWhileRevalidateLoadPolicy;
+				}
+				else if (policy == QLatin1String("preferCache"))
+				{
+					m_loadPolicy = PreferCacheLoadPolicy;
+				}
+				else
+				{
+					m_loadPolicy = NetworkLoadPolicy;
+				}
+			}
+
+			break;
+		default:
+			break;
 	}
 }
 
-void NetworkCache::insert(QIODevice *device)
+void NetworkCache::handleEvictionFinished()
+{
+	m_evictedPaths.clear();
+
+	scheduleContentsRemoval();
+
+	if (isIndexReady() && m_totalSize > maximumCacheSize())
+	{
+		evictEntries();
+	}
+}
+
+void NetworkCache::loadIndex()
 {
-	QNetworkDiskCache::insert(device);
+	QFile file(getIndexPath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		rebuildIndex();
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+	quint32 amount(0);
+
+	stream >> magicNumber >> formatVersion >> amount;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != IndexMagicNumber || formatVersion != IndexFormatVersion)
+	{
+		file.close();
 
-	if (m_devices.contains(device))
+		rebuildIndex();
+
+		return;
+	}
+
+	m_entries.reserve(static_cast<int>(amount));
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		EntryInformation entry;
+
+		stream >> entry.url >> entry.path >> entry.mimeType >> entry.lastModified >> entry.expirationDate >> entry.size >> entry.accessTime >> entry.isImmutable >> entry.contentHash >> entry.contentSize;
+
+		if (stream.status() == QDataStream::Ok && entry.isValid() && !m_entriesPositions.contains(entry.url))
+		{
+			addIndexEntry(entry);
+		}
+	}
+
+	const bool isValid(stream.status() == QDataStream::Ok);
+
+	file.close();
+
+///TODO Keep a journal instead, for now a missing index after a crash just means another rebuild
+	QFile::remove(getIndexPath());
+
+	if (!isValid)
 	{
-		emit entryAdded(m_devices[device]);
+		m_entries.clear();
+		m_entriesPositions.clear();
+		m_accessOrder.clear();
+
+		m_totalSize = 0;
 
-		m_devices.remove(device);
+		rebuildIndex();
 	}
 }
 
-QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &metaData)
+void NetworkCache::saveIndex() const
 {
-	QIODevice *device(QNetworkDiskCache::prepare(metaData));
+	QSaveFile file(getIndexPath());
 
-	if (device)
+	if (!file.open(QIODevice::WriteOnly))
 	{
-		m_devices[device] = metaData.url();
+		return;
 	}
 
-	return device;
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(IndexMagicNumber) << static_cast<quint32>(IndexFormatVersion) << static_cast<quint32>(m_entries.count());
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		const EntryInformation &entry(m_entries.at(i));
+
+		stream << entry.url << entry.path << entry.mimeType << entry.lastModified << entry.expirationDate << entry.size << entry.accessTime << entry.isImmutable << entry.contentHash << entry.contentSize;
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+
+		return;
+	}
+
+	file.commit();
 }
 
-QString NetworkCache::getPathForUrl(const QUrl &url)
+void NetworkCache::rebuildIndex()
 {
-	if (!url.isValid() || !metaData(url).isValid())
+	if (m_rebuildIterator)
 	{
-		return {};
+		delete m_rebuildIterator;
 	}
 
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	m_rebuildIterator = new QDirIterator(getDataDirectory(), QDir::Files, QDirIterator::Subdirectories);
 
-	for (int i = 0; i < directories.count(); ++i)
+	if (m_rebuildTimer == 0)
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		m_rebuildTimer = startTimer(10);
+	}
+}
 
-		for (int j = 0; j < subDirectories.count(); ++j)
-		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
+void NetworkCache::evictEntries()
+{
+	if (m_evictionWatcher.isRunning())
+	{
+		return;
+	}
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QString cacheFilePath(cacheFilesDirectory.absoluteFilePath(files.at(k)));
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilePath));
+	const qint64 limit((maximumCacheSize() * 9) / 10);
+	QStringList paths;
 
-				if (metaData.isValid() && url == metaData.url())
-				{
-					return cacheFilePath;
-				}
-			}
+	while (m_totalSize > limit && !m_accessOrder.isEmpty())
+	{
+		const QUrl url(m_accessOrder.first());
+		const EntryInformation entry(getEntryInformation(url));
+
+		removeIndexEntry(url);
+
+		if (!entry.path.isEmpty())
+		{
+			paths.append(entry.path);
+
+			m_evictedPaths.insert(entry.path);
 		}
+
+		emit entryRemoved(url);
 	}
 
-	return {};
+	for (int i = 0; i < m_orphanedContentPaths.count(); ++i)
+	{
+		m_evictedPaths.insert(m_orphanedContentPaths.at(i));
+	}
+
+	paths.append(m_orphanedContentPaths);
+
+	m_orphanedContentPaths.clear();
+
+	if (!paths.isEmpty())
+	{
+		m_evictionWatcher.setFuture(QtConcurrent::run(&NetworkCache::removeFiles, paths));
+	}
 }
 
-QVector<QUrl> NetworkCache::getEntries() const
+void NetworkCache::addIndexEntry(const EntryInformation &entry)
 {
-	QVector<QUrl> entries;
-	const QDir cacheMainDirectory(cacheDirectory());
-	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+	if (!entry.contentHash.isEmpty())
+	{
+		retainContent(entry.contentHash, entry.contentSize);
+	}
 
-	for (int i = 0; i < directories.count(); ++i)
+	if (m_entriesPositions.contains(entry.url))
 	{
-		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
-		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+		EntryInformation &existingEntry(m_entries[m_entriesPositions[entry.url]]);
 
-		for (int j = 0; j < subDirectories.count(); ++j)
+		m_accessOrder.remove(existingEntry.accessTime, existingEntry.url);
+
+		if (existingEntry.size > 0)
 		{
-			const QDir cacheFilesDirectory(cacheSubDirectory.absoluteFilePath(subDirectories.at(j)));
-			const QStringList files(cacheFilesDirectory.entryList(QDir::Files));
+			m_totalSize -= existingEntry.size;
+		}
 
-			entries.reserve(entries.count() + files.count());
+		if (!existingEntry.contentHash.isEmpty())
+		{
+			releaseContent(existingEntry.contentHash);
+		}
 
-			for (int k = 0; k < files.count(); ++k)
-			{
-				const QNetworkCacheMetaData metaData(fileMetaData(cacheFilesDirectory.absoluteFilePath(files.at(k))));
+		existingEntry = entry;
+	}
+	else
+	{
+		m_entriesPositions[entry.url] = m_entries.count();
 
-				if (metaData.url().isValid())
-				{
-					entries.append(metaData.url());
-				}
-			}
-		}
+		m_entries.append(entry);
 	}
 
-	entries.squeeze();
+	m_accessOrder.insert(entry.accessTime, entry.url);
 
-	return entries;
+	if (entry.size > 0)
+	{
+		m_totalSize += entry.size;
+	}
 }
 
-bool NetworkCache::remove(const QUrl &url)
+void NetworkCache::removeIndexEntry(const QUrl &url)
 {
-	const bool result(QNetworkDiskCache::remove(url));
+	removeMemoryEntry(url);
 
-	if (result)
+	if (!m_entriesPositions.contains(url))
 	{
-		emit entryRemoved(url);
+		return;
 	}
 
-	return result;
+	const int position(m_entriesPositions.take(url));
+	const int lastPosition(m_entries.count() - 1);
+	const EntryInformation &entry(m_entries.at(position));
+
+	m_accessOrder.remove(entry.accessTime, entry.url);
+
+	if (entry.size > 0)
+	{
+		m_totalSize -= entry.size;
+	}
+
+	if (!entry.contentHash.isEmpty())
+	{
+		releaseContent(entry.contentHash);
+	}
+
+	if (position != lastPosition)
+	{
+		m_entries[position] = m_entries.at(lastPosition);
+		m_entriesPositions[m_entries.at(position).url] = position;
+	}
+
+	m_entries.removeLast();
+}
+
+void NetworkCache::addMemoryEntry(const QUrl &url, const QByteArray &data)
+{
+	const qint64 size(data.size());
+
+	if (size > MemoryTierEntryLimit || m_memoryEntries.contains(url))
+	{
+		return;
+	}
+
+	if ((m_memoryTierSize + size) > MemoryTierLimit && !m_memoryAccessOrder.isEmpty() && getEstimatedFrequency(url) <= getEstimatedFrequency(m_memoryAccessOrder.first()))
+	{
+		++m_memoryTierRejections;
+
+		return;
+	}
+
+	MemoryEntry entry;
+	entry.metaData = QNetworkDiskCache::metaData(url);
+
+	if (!entry.metaData.isValid())
+	{
+		return;
+	}
+
+	while ((m_memoryTierSize + size) > MemoryTierLimit && !m_memoryAccessOrder.isEmpty())
+	{
+		const QUrl evictedUrl(m_memoryAccessOrder.first());
+
+		removeMemoryEntry(evictedUrl);
+	}
+
+	++m_memoryAccessCounter;
+
+	entry.data = data;
+	entry.accessCounter = m_memoryAccessCounter;
+
+	m_memoryEntries.insert(url, entry);
+	m_memoryAccessOrder.insert(m_memoryAccessCounter, url);
+
+	m_memoryTierSize += size;
+}
+
+void NetworkCache::removeMemoryEntry(const QUrl &url)
+{
+	const QHash<QUrl, MemoryEntry>::iterator iterator(m_memoryEntries.find(url));
+
+	if (iterator == m_memoryEntries.end())
+	{
+		return;
+	}
+
+	m_memoryAccessOrder.remove(iterator.value().accessCounter);
+
+	m_memoryTierSize -= iterator.value().data.size();
+
+	m_memoryEntries.erase(iterator);
+}
+
+void NetworkCache::clearMemoryEntries()
+{
+	m_memoryEntries.clear();
+	m_memoryAccessOrder.clear();
+	m_frequencySketch.fill(0);
+
+	m_memoryTierSize = 0;
+	m_frequencySketchAdditions = 0;
+}
+
+void NetworkCache::retainContent(const QByteArray &hash, qint64 size)
+{
+	ContentInformation &content(m_contents[hash]);
+
+	if (content.references == 0)
+	{
+		content.size = ((size < 0) ? QFileInfo(getContentPath(hash)).size() : size);
+
+		m_totalSize += content.size;
+	}
+
+	++content.references;
+}
+
+void NetworkCache::releaseContent(const QByteArray &hash)
+{
+	const QHash<QByteArray, ContentInformation>::iterator iterator(m_contents.find(hash));
+
+	if (iterator == m_contents.end())
+	{
+		return;
+	}
+
+	--iterator.value().references;
+
+	if (iterator.value().references <= 0)
+	{
+		m_totalSize -= iterator.value().size;
+
+		m_contents.erase(iterator);
+
+		m_orphanedContentPaths.append(getContentPath(hash));
+	}
+}
+
+void NetworkCache::removeOrphanedContents()
+{
+	QDirIterator iterator(getContentsDirectory(), QDir::Files, QDirIterator::Subdirectories);
+
+	while (iterator.hasNext())
+	{
+		const QString path(iterator.next());
+
+		if (!m_contents.contains(iterator.fileName().toLatin1()))
+		{
+			m_orphanedContentPaths.append(path);
+		}
+	}
+
+	scheduleContentsRemoval();
+}
+
+void NetworkCache::scheduleContentsRemoval()
+{
+	if (m_orphanedContentPaths.isEmpty() || m_evictionWatcher.isRunning())
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_orphanedContentPaths.count(); ++i)
+	{
+		m_evictedPaths.insert(m_orphanedContentPaths.at(i));
+	}
+
+	m_evictionWatcher.setFuture(QtConcurrent::run(&NetworkCache::removeFiles, m_orphanedContentPaths));
+
+	m_orphanedContentPaths.clear();
+}
+
+void NetworkCache::recordAccess(const QUrl &url)
+{
+	const uint hash(qHash(url));
+
+	for (int i = 0; i < FrequencySketchDepth; ++i)
+	{
+		const int position((i * FrequencySketchWidth) + static_cast<int>(qHash(hash, static_cast<uint>(i + 1)) % FrequencySketchWidth));
+
+		if (m_frequencySketch.at(position) < 15)
+		{
+			++m_frequencySketch[position];
+		}
+	}
+
+	++m_frequencySketchAdditions;
+
+	if (m_frequencySketchAdditions >= FrequencySketchResetInterval)
+	{
+		for (int i = 0; i < m_frequencySketch.count(); ++i)
+		{
+			m_frequencySketch[i] /= 2;
+		}
+
+		m_frequencySketchAdditions = 0;
+	}
+}
+
+void NetworkCache::clear()
+{
+	m_evictionWatcher.waitForFinished();
+
+	const QString path(cacheDirectory().isEmpty() ? QString() : QDir(cacheDirectory()).absolutePath());
+	const QString trashPath(path + QLatin1String(".trash-") + QString::number(QDateTime::currentMSecsSinceEpoch()));
+	const bool isTrashed(!path.isEmpty() && QDir().rename(path, trashPath));
+
+	if (isTrashed)
+	{
+		QDir().mkpath(path);
+
+		setCacheDirectory(path);
+	}
+
+	m_isClearing = true;
+
+	QNetworkDiskCache::clear();
+
+	m_isClearing = false;
+	m_entries.clear();
+	m_entriesPositions.clear();
+	m_accessOrder.clear();
+	m_devices.clear();
+	m_evictedPaths.clear();
+	m_contents.clear();
+	m_orphanedContentPaths.clear();
+	m_totalSize = 0;
+
+	clearMemoryEntries();
+
+	if (m_rebuildIterator)
+	{
+		killTimer(m_rebuildTimer);
+
+		m_rebuildTimer = 0;
+
+		delete m_rebuildIterator;
+
+		m_rebuildIterator = nullptr;
+	}
+
+	if (isTrashed)
+	{
+		m_evictionWatcher.setFuture(QtConcurrent::run(&NetworkCache::removeDirectories, QStringList({trashPath})));
+	}
+}
+
+void NetworkCache::clearCache(int period)
+{
+	if (period <= 0)
+	{
+		clear();
+
+		emit cleared();
+
+		return;
+	}
+
+	if (isIndexReady())
+	{
+		m_evictionWatcher.waitForFinished();
+
+		QVector<QUrl> urls;
+
+		for (QMultiMap<qint64, QUrl>::const_iterator iterator(m_accessOrder.lowerBound(QDateTime::currentMSecsSinceEpoch() - (static_cast<qint64>(period) * 3600000))); iterator != m_accessOrder.constEnd(); ++iterator)
+		{
+			urls.append(iterator.value());
+		}
+
+		QStringList paths;
+		paths.reserve(urls.count());
+
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			const EntryInformation entry(getEntryInformation(urls.at(i)));
+
+			removeIndexEntry(urls.at(i));
+
+			if (!entry.path.isEmpty())
+			{
+				paths.append(entry.path);
+
+				m_evictedPaths.insert(entry.path);
+			}
+
+			emit entryRemoved(urls.at(i));
+		}
+
+		if (!paths.isEmpty())
+		{
+			m_evictionWatcher.setFuture(QtConcurrent::run(&NetworkCache::removeFiles, paths));
+		}
+
+		return;
+	}
+
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QDir cacheMainDirectory(cacheDirectory());
+	const QStringList directories(cacheMainDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+
+	for (int i = 0; i < directories.count(); ++i)
+	{
+		const QDir cacheSubDirectory(cacheMainDirectory.absoluteFilePath(directories.at(i)));
+		const QStringList subDirectories(cacheSubDirectory.entryList(QDir::AllDirs | QDir::NoDotAndDotDot));
+
+		for (int j = 0; j < subDirectories.count(); ++j)
+		{
+			const QFileInfoList files(QDir(cacheSubDirectory.absoluteFilePath(subDirectories.at(j))).entryInfoList(QDir::Files));
+
+			for (int k = 0; k < files.count(); ++k)
+			{
+				if (files.at(k).lastModified().toUTC().secsTo(currentDateTime) < (period * 3600))
+				{
+					const QNetworkCacheMetaData metaData(fileMetaData(files.at(k).absoluteFilePath()));
+
+					if (metaData.isValid())
+					{
+						remove(metaData.url());
+					}
+				}
+			}
+		}
+	}
+}
+
+void NetworkCache::finishRevalidation(const QUrl &url)
+{
+	m_revalidatedUrls.remove(normalizeUrl(url));
+}
+
+void NetworkCache::insert(QIODevice *device)
+{
+	const QNetworkCacheMetaData metaData(m_devices.take(device));
+	const QString path(metaData.url().isValid() ? getCacheFileName(metaData.url()) : QString());
+
+	removeMemoryEntry(metaData.url());
+
+	if (m_evictedPaths.contains(path))
+	{
+		m_evictionWatcher.waitForFinished();
+	}
+
+	EntryInformation entry(createEntryInformation(metaData));
+	entry.accessTime = QDateTime::currentMSecsSinceEpoch();
+
+	if (m_contentDevices.remove(device))
+	{
+		const QByteArray data(static_cast<QBuffer*>(device)->data());
+
+		delete device;
+
+		if (!metaData.url().isValid())
+		{
+			return;
+		}
+
+		entry.contentHash = storeContent(data, entry.mimeType);
+
+		if (entry.contentHash.isEmpty())
+		{
+			return;
+		}
+
+		entry.contentSize = QFileInfo(getContentPath(entry.contentHash)).size();
+
+		QNetworkCacheMetaData contentMetaData(metaData);
+		QNetworkCacheMetaData::AttributesMap attributes(contentMetaData.attributes());
+		attributes[static_cast<QNetworkRequest::Attribute>(ContentHashAttribute)] = entry.contentHash;
+
+		contentMetaData.setAttributes(attributes);
+
+		QIODevice *metaDataDevice(QNetworkDiskCache::prepare(contentMetaData));
+
+		if (!metaDataDevice)
+		{
+			retainContent(entry.contentHash, entry.contentSize);
+			releaseContent(entry.contentHash);
+			scheduleContentsRemoval();
+
+			return;
+		}
+
+		QNetworkDiskCache::insert(metaDataDevice);
+	}
+	else
+	{
+		QNetworkDiskCache::insert(device);
+
+		if (!metaData.url().isValid())
+		{
+			return;
+		}
+	}
+
+	const QFileInfo fileInfo(path);
+
+	if (fileInfo.exists())
+	{
+		entry.path = path;
+		entry.size = fileInfo.size();
+	}
+
+	addIndexEntry(entry);
+	scheduleContentsRemoval();
+
+	emit entryAdded(metaData.url());
+
+	if (m_totalSize > maximumCacheSize())
+	{
+		evictEntries();
+	}
+}
+
+QIODevice* NetworkCache::prepare(const QNetworkCacheMetaData &originalMetaData)
+{
+	QNetworkCacheMetaData metaData(originalMetaData);
+	metaData.setUrl(normalizeUrl(originalMetaData.url()));
+
+	if (m_isDeduplicationEnabled && metaData.isValid() && metaData.url().isValid() && metaData.saveToDisk())
+	{
+		const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+		qint64 length(-1);
+
+		for (int i = 0; i < headers.count(); ++i)
+		{
+			if (headers.at(i).first.compare(QByteArrayLiteral("Content-Length"), Qt::CaseInsensitive) == 0)
+			{
+				length = headers.at(i).second.toLongLong();
+
+				break;
+			}
+		}
+
+		if (length > 0 && length <= ContentSizeLimit && length < ((maximumCacheSize() * 3) / 4))
+		{
+			QBuffer *buffer(new QBuffer());
+			buffer->open(QIODevice::ReadWrite);
+
+			m_devices[buffer] = metaData;
+
+			m_contentDevices.insert(buffer);
+
+			return buffer;
+		}
+	}
+
+	QIODevice *device(QNetworkDiskCache::prepare(metaData));
+
+	if (device)
+	{
+		m_devices[device] = metaData;
+	}
+
+	return device;
+}
+
+QIODevice* NetworkCache::data(const QUrl &originalUrl)
+{
+	const QUrl url(normalizeUrl(originalUrl));
+
+	recordAccess(url);
+
+	const QHash<QUrl, MemoryEntry>::iterator iterator(m_memoryEntries.find(url));
+	QIODevice *device(nullptr);
+
+	if (iterator == m_memoryEntries.end())
+	{
+		++m_memoryTierMisses;
+
+		device = readData(url);
+
+		if (device && device->size() <= MemoryTierEntryLimit)
+		{
+			const QByteArray data(device->readAll());
+
+			delete device;
+
+			addMemoryEntry(url, data);
+
+			QBuffer *buffer(new QBuffer());
+			buffer->setData(data);
+			buffer->open(QIODevice::ReadOnly);
+
+			device = buffer;
+		}
+	}
+	else
+	{
+		++m_memoryTierHits;
+		++m_memoryAccessCounter;
+
+		m_memoryAccessOrder.remove(iterator.value().accessCounter);
+		m_memoryAccessOrder.insert(m_memoryAccessCounter, url);
+
+		iterator.value().accessCounter = m_memoryAccessCounter;
+
+		QBuffer *buffer(new QBuffer());
+		buffer->setData(iterator.value().data);
+		buffer->open(QIODevice::ReadOnly);
+
+		device = buffer;
+	}
+
+	if (device && m_entriesPositions.contains(url))
+	{
+		EntryInformation entry(m_entries.at(m_entriesPositions[url]));
+		entry.accessTime = QDateTime::currentMSecsSinceEpoch();
+
+		addIndexEntry(entry);
+	}
+
+	return device;
+}
+
+QNetworkCacheMetaData NetworkCache::metaData(const QUrl &originalUrl)
+{
+	const QUrl url(normalizeUrl(originalUrl));
+	const bool isNormalized(url != originalUrl);
+	const QHash<QUrl, MemoryEntry>::const_iterator iterator(m_memoryEntries.constFind(url));
+	const QNetworkCacheMetaData metaData((iterator == m_memoryEntries.constEnd()) ? QNetworkDiskCache::metaData(url) : iterator.value().metaData);
+
+	if (isNormalized)
+	{
+		++m_normalizedKeys;
+	}
+
+	if (metaData.isValid())
+	{
+		++m_lookupHits;
+
+		if (isNormalized)
+		{
+			++m_normalizedHits;
+		}
+	}
+	else
+	{
+		++m_lookupMisses;
+	}
+
+	return metaData;
+}
+
+QIODevice* NetworkCache::readData(const QUrl &url)
+{
+	QByteArray contentHash;
+
+	if (m_entriesPositions.contains(url))
+	{
+		contentHash = m_entries.at(m_entriesPositions.value(url)).contentHash;
+	}
+	else if (!isIndexReady())
+	{
+		contentHash = QNetworkDiskCache::metaData(url).attributes().value(static_cast<QNetworkRequest::Attribute>(ContentHashAttribute)).toByteArray();
+	}
+
+	if (contentHash.isEmpty())
+	{
+		return QNetworkDiskCache::data(url);
+	}
+
+	QFile file(getContentPath(contentHash));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return nullptr;
+	}
+
+	const QByteArray content(file.readAll());
+
+	file.close();
+
+	if (content.isEmpty())
+	{
+		return nullptr;
+	}
+
+	QBuffer *buffer(new QBuffer());
+	buffer->setData((content.at(0) == CompressedContentFormat) ? qUncompress(content.mid(1)) : content.mid(1));
+	buffer->open(QIODevice::ReadOnly);
+
+	return buffer;
+}
+
+QString NetworkCache::getIndexPath() const
+{
+	return QDir(cacheDirectory()).absoluteFilePath(QLatin1String("index.dat"));
+}
+
+QString NetworkCache::getDataDirectory() const
+{
+	return QDir(cacheDirectory()).absoluteFilePath(QLatin1String("data8")) + QLatin1Char('/');
+}
+
+QString NetworkCache::getContentPath(const QByteArray &hash) const
+{
+	return getContentsDirectory() + QLatin1String(hash.left(2)) + QLatin1Char('/') + QLatin1String(hash);
+}
+
+QString NetworkCache::getContentsDirectory() const
+{
+	return QDir(cacheDirectory()).absoluteFilePath(QLatin1String("contents")) + QLatin1Char('/');
+}
+
+QString NetworkCache::getCacheFileName(const QUrl &url) const
+{
+	QUrl cleanUrl(url);
+	cleanUrl.setPassword({});
+	cleanUrl.setFragment({});
+
+	const QByteArray hash(QCryptographicHash::hash(cleanUrl.toEncoded(), QCryptographicHash::Sha1));
+	qlonglong value(0);
+
+	std::memcpy(&value, hash.constData(), sizeof(value));
+
+	const QByteArray identifier(QByteArray::number(value, 36).left(8));
+
+	return getDataDirectory() + QString::number((static_cast<uint>(identifier.at(identifier.length() - 1)) % 16), 16) + QLatin1Char('/') + QLatin1String(identifier) + QLatin1String(".d");
+}
+
+QUrl NetworkCache::normalizeUrl(const QUrl &url) const
+{
+	if (!url.hasQuery() || (m_ignoredQueryParameters.isEmpty() && m_ignoredHostQueryParameters.isEmpty()) || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return url;
+	}
+
+	QStringList parameters(m_ignoredQueryParameters);
+
+	if (!m_ignoredHostQueryParameters.isEmpty())
+	{
+		QString host(url.host().toLower());
+
+		while (!host.isEmpty())
+		{
+			parameters.append(m_ignoredHostQueryParameters.values(host));
+
+			const int separatorPosition(host.indexOf(QLatin1Char('.')));
+
+			host = ((separatorPosition < 0) ? QString() : host.mid(separatorPosition + 1));
+		}
+	}
+
+	if (parameters.isEmpty())
+	{
+		return url;
+	}
+
+	const QStringList items(url.query(QUrl::FullyEncoded).split(QLatin1Char('&')));
+	QStringList keptItems;
+	keptItems.reserve(items.count());
+
+	for (int i = 0; i < items.count(); ++i)
+	{
+		const QString name(QUrl::fromPercentEncoding(items.at(i).section(QLatin1Char('='), 0, 0).toUtf8()));
+		bool isIgnored(false);
+
+		for (int j = 0; j < parameters.count(); ++j)
+		{
+			const QString &parameter(parameters.at(j));
+
+			if (parameter.endsWith(QLatin1Char('*')) ? name.startsWith(parameter.left(parameter.length() - 1)) : (name == parameter))
+			{
+				isIgnored = true;
+
+				break;
+			}
+		}
+
+		if (!isIgnored)
+		{
+			keptItems.append(items.at(i));
+		}
+	}
+
+	if (keptItems.count() == items.count())
+	{
+		return url;
+	}
+
+	QUrl normalizedUrl(url);
+
+	if (keptItems.isEmpty())
+	{
+		normalizedUrl.setQuery(QString());
+	}
+	else
+	{
+		normalizedUrl.setQuery(keptItems.join(QLatin1Char('&')), QUrl::StrictMode);
+	}
+
+	return normalizedUrl;
+}
+
+QString NetworkCache::getPathForUrl(const QUrl &originalUrl)
+{
+	const QUrl url(normalizeUrl(originalUrl));
+
+	if (!url.isValid())
+	{
+		return {};
+	}
+
+	if (m_entriesPositions.contains(url))
+	{
+		const EntryInformation &entry(m_entries.at(m_entriesPositions[url]));
+
+		if (!entry.path.isEmpty() && QFile::exists(entry.path))
+		{
+			return entry.path;
+		}
+	}
+	else if (!m_rebuildIterator)
+	{
+		return {};
+	}
+
+	const QString path(getCacheFileName(url));
+
+	if (fileMetaData(path).url() != url)
+	{
+		return {};
+	}
+
+	EntryInformation entry(getEntryInformation(url));
+
+	if (!entry.isValid())
+	{
+		entry = createEntryInformation(metaData(url));
+	}
+
+	if (entry.accessTime == 0)
+	{
+		entry.accessTime = QDateTime::currentMSecsSinceEpoch();
+	}
+
+	entry.path = path;
+	entry.size = QFileInfo(path).size();
+
+	addIndexEntry(entry);
+
+	return path;
+}
+
+QByteArray NetworkCache::storeContent(const QByteArray &data, const QString &mimeType)
+{
+	const QByteArray hash(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+	const QString path(getContentPath(hash));
+
+	if (m_orphanedContentPaths.removeAll(path) == 0 && m_evictedPaths.contains(path))
+	{
+		m_evictionWatcher.waitForFinished();
+	}
+
+	if (QFile::exists(path))
+	{
+		return hash;
+	}
+
+	QByteArray content;
+
+	if (isCompressible(mimeType))
+	{
+		const QByteArray compressedData(qCompress(data, 1));
+
+		if (compressedData.size() < data.size())
+		{
+			content.reserve(compressedData.size() + 1);
+			content.append(CompressedContentFormat);
+			content.append(compressedData);
+		}
+	}
+
+	if (content.isEmpty())
+	{
+		content.reserve(data.size() + 1);
+		content.append(RawContentFormat);
+		content.append(data);
+	}
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() || !file.commit())
+	{
+		return {};
+	}
+
+	return hash;
+}
+
+NetworkCache::EntryInformation NetworkCache::createEntryInformation(const QNetworkCacheMetaData &metaData)
+{
+	EntryInformation entry;
+	entry.url = metaData.url();
+	entry.lastModified = metaData.lastModified();
+	entry.expirationDate = metaData.expirationDate();
+	entry.contentHash = metaData.attributes().value(static_cast<QNetworkRequest::Attribute>(ContentHashAttribute)).toByteArray();
+
+	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		if (headers.at(i).first.compare(QByteArrayLiteral("Content-Type"), Qt::CaseInsensitive) == 0)
+		{
+			entry.mimeType = QString::fromLatin1(headers.at(i).second).section(QLatin1Char(';'), 0, 0).trimmed();
+		}
+		else if (headers.at(i).first.compare(QByteArrayLiteral("Cache-Control"), Qt::CaseInsensitive) == 0)
+		{
+			entry.isImmutable = headers.at(i).second.toLower().contains(QByteArrayLiteral("immutable"));
+		}
+	}
+
+	return entry;
+}
+
+NetworkCache::EntryInformation NetworkCache::getEntryInformation(const QUrl &url) const
+{
+	if (m_entriesPositions.contains(url))
+	{
+		return m_entries.at(m_entriesPositions[url]);
+	}
+
+	return {};
+}
+
+NetworkCache::LookupStatistics NetworkCache::getLookupStatistics() const
+{
+	LookupStatistics statistics;
+	statistics.hits = m_lookupHits;
+	statistics.misses = m_lookupMisses;
+	statistics.normalizedKeys = m_normalizedKeys;
+	statistics.normalizedHits = m_normalizedHits;
+
+	return statistics;
+}
+
+NetworkCache::MemoryTierStatistics NetworkCache::getMemoryTierStatistics() const
+{
+	MemoryTierStatistics statistics;
+	statistics.hits = m_memoryTierHits;
+	statistics.misses = m_memoryTierMisses;
+	statistics.rejections = m_memoryTierRejections;
+	statistics.size = m_memoryTierSize;
+	statistics.limit = MemoryTierLimit;
+	statistics.amount = m_memoryEntries.count();
+
+	return statistics;
+}
+
+NetworkCache::CacheState NetworkCache::getCacheState(const QUrl &originalUrl) const
+{
+	const QUrl url(normalizeUrl(originalUrl));
+
+	if (!isIndexReady() || !m_entriesPositions.contains(url))
+	{
+		return UnavailableState;
+	}
+
+	const EntryInformation &entry(m_entries.at(m_entriesPositions.value(url)));
+
+	if (entry.isImmutable || isFingerprintedUrl(url))
+	{
+		return ImmutableState;
+	}
+
+	return ((entry.expirationDate.isValid() && entry.expirationDate > QDateTime::currentDateTimeUtc()) ? FreshState : StaleState);
+}
+
+QVector<QUrl> NetworkCache::getEntries(int offset, int amount) const
+{
+	QVector<QUrl> entries;
+
+	if (offset < 0 || offset >= m_entries.count())
+	{
+		return entries;
+	}
+
+	const int limit((amount < 0) ? m_entries.count() : qMin(m_entries.count(), (offset + amount)));
+
+	entries.reserve(limit - offset);
+
+	for (int i = offset; i < limit; ++i)
+	{
+		entries.append(m_entries.at(i).url);
+	}
+
+	return entries;
+}
+
+quint64 NetworkCache::getIndexMemoryUsage() const
+{
+	quint64 usage(static_cast<quint64>(m_entries.capacity()) * sizeof(EntryInformation));
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		const EntryInformation &entry(m_entries.at(i));
+
+		usage += (static_cast<quint64>(entry.url.toEncoded().size() + ((entry.path.capacity() + entry.mimeType.capacity()) * static_cast<int>(sizeof(QChar)))));
+	}
+
+	usage += (static_cast<quint64>(m_entriesPositions.count() + m_accessOrder.count()) * (sizeof(QUrl) + sizeof(qint64) + (2 * sizeof(void*))));
+
+	return usage;
+}
+
+int NetworkCache::getEntriesAmount() const
+{
+	return m_entries.count();
+}
+
+int NetworkCache::getEstimatedFrequency(const QUrl &url) const
+{
+	const uint hash(qHash(url));
+	int frequency(15);
+
+	for (int i = 0; i < FrequencySketchDepth; ++i)
+	{
+		frequency = qMin(frequency, static_cast<int>(m_frequencySketch.at((i * FrequencySketchWidth) + static_cast<int>(qHash(hash, static_cast<uint>(i + 1)) % FrequencySketchWidth))));
+	}
+
+	return frequency;
+}
+
+qint64 NetworkCache::expire()
+{
+	if (m_isClearing)
+	{
+		return QNetworkDiskCache::expire();
+	}
+
+	if (isIndexReady() && m_totalSize > maximumCacheSize())
+	{
+		evictEntries();
+	}
+
+	return m_totalSize;
+}
+
+void NetworkCache::removeFiles(const QStringList &paths)
+{
+	for (int i = 0; i < paths.count(); ++i)
+	{
+		QFile::remove(paths.at(i));
+	}
+}
+
+void NetworkCache::removeDirectories(const QStringList &paths)
+{
+	for (int i = 0; i < paths.count(); ++i)
+	{
+		QDir(paths.at(i)).removeRecursively();
+	}
+}
+
+bool NetworkCache::remove(const QUrl &originalUrl)
+{
+	const QUrl url(normalizeUrl(originalUrl));
+
+	QSet<QIODevice*>::iterator iterator(m_contentDevices.begin());
+
+	while (iterator != m_contentDevices.end())
+	{
+		if (m_devices.value(*iterator).url() == url)
+		{
+			m_devices.remove(*iterator);
+
+			delete *iterator;
+
+			iterator = m_contentDevices.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const bool result(QNetworkDiskCache::remove(url));
+
+	removeIndexEntry(url);
+	scheduleContentsRemoval();
+
+	if (result)
+	{
+		emit entryRemoved(url);
+	}
+
+	return result;
+}
+
+bool NetworkCache::applyLoadPolicy(QNetworkRequest &request, bool isSubresource)
+{
+	const QVariant loadControl(request.attribute(QNetworkRequest::CacheLoadControlAttribute));
+	const QString scheme(request.url().scheme());
+
+	if ((loadControl.isValid() && loadControl.toInt() != QNetworkRequest::PreferNetwork) || (scheme != QLatin1String("http") && scheme != QLatin1String("https")))
+	{
+		return false;
+	}
+
+	const QUrl url(normalizeUrl(request.url().adjusted(QUrl::RemoveFragment)));
+
+	switch (getCacheState(url))
+	{
+		case ImmutableState:
+			request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+
+			break;
+		case StaleState:
+			if (m_loadPolicy == PreferCacheLoadPolicy)
+			{
+				request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+			}
+			else if (m_loadPolicy == StaleWhileRevalidateLoadPolicy && isSubresource && !m_revalidatedUrls.contains(url))
+			{
+				request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+
+				m_revalidatedUrls.insert(url);
+
+				return true;
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+bool NetworkCache::isFingerprintedUrl(const QUrl &url)
+{
+	if (url.hasQuery())
+	{
+		return false;
+	}
+
+	static const QRegularExpression expression(QLatin1String("[._-](?=[0-9]*[a-f])[0-9a-f]{8,}\\.[a-z0-9]+$"), QRegularExpression::CaseInsensitiveOption);
+
+	return expression.match(url.fileName()).hasMatch();
+}
+
+bool NetworkCache::isCompressible(const QString &mimeType)
+{
+	return (mimeType.startsWith(QLatin1String("text/")) || mimeType.endsWith(QLatin1String("javascript")) || mimeType.endsWith(QLatin1String("json")) || mimeType.endsWith(QLatin1String("xml")));
+}
+
+bool NetworkCache::isIndexReady() const
+{
+	return (m_rebuildIterator == nullptr);
 }
 
 }
@@ -20,7 +20,13 @@
 #ifndef OTTER_NETWORKCACHE_H
 #define OTTER_NETWORKCACHE_H
 
+#include <QtCore/QDateTime>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QNetworkRequest>
 
 namespace Otter
 {
@@ -30,23 +36,199 @@ class NetworkCache final : public QNetworkDiskCache
 	Q_OBJECT
 
 public:
+	enum CacheState
+	{
+		UnavailableState = 0,
+		FreshState,
+		StaleState,
+		ImmutableState
+	};
+
+	enum LoadPolicy
+	{
+		NetworkLoadPolicy = 0,
+		StaleWhileRevalidateLoadPolicy,
+		PreferCacheLoadPolicy
+	};
+
+	struct EntryInformation final
+	{
+		QUrl url;
+		QString path;
+		QString mimeType;
+		QDateTime lastModified;
+		QDateTime expirationDate;
+		qint64 size = -1;
+		QByteArray contentHash;
+		qint64 accessTime = 0;
+		qint64 contentSize = -1;
+		bool isImmutable = false;
+
+		bool isValid() const
+		{
+			return url.isValid();
+		}
+	};
+
+	struct LookupStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+		quint64 normalizedKeys = 0;
+		quint64 normalizedHits = 0;
+	};
+
+	struct MemoryTierStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+		quint64 rejections = 0;
+		qint64 size = 0;
+		qint64 limit = 0;
+		int amount = 0;
+	};
+
 	explicit NetworkCache(QObject *parent = nullptr);
+	~NetworkCache();
 
 	void clearCache(int period = 0);
+	void finishRevalidation(const QUrl &url);
 	void insert(QIODevice *device) override;
-	QIODevice* prepare(const QNetworkCacheMetaData &metaData) override;
-	QString getPathForUrl(const QUrl &url);
-	QVector<QUrl> getEntries() const;
-	bool remove(const QUrl &url) override;
+	QIODevice* prepare(const QNetworkCacheMetaData &originalMetaData) override;
+	QIODevice* data(const QUrl &originalUrl) override;
+	QNetworkCacheMetaData metaData(const QUrl &originalUrl) override;
+	QString getPathForUrl(const QUrl &originalUrl);
+	EntryInformation getEntryInformation(const QUrl &url) const;
+	LookupStatistics getLookupStatistics() const;
+	MemoryTierStatistics getMemoryTierStatistics() const;
+	CacheState getCacheState(const QUrl &originalUrl) const;
+	QVector<QUrl> getEntries(int offset = 0, int amount = -1) const;
+	quint64 getIndexMemoryUsage() const;
+	int getEntriesAmount() const;
+	bool applyLoadPolicy(QNetworkRequest &request, bool isSubresource);
+	bool remove(const QUrl &originalUrl) override;
+	bool isIndexReady() const;
+
+public slots:
+	void clear() override;
+
+protected:
+	enum IndexFormat : quint32
+	{
+		IndexMagicNumber = 0x4F4E4349,
+		IndexFormatVersion = 4
+	};
+
+	enum IndexParameter
+	{
+		RebuildBatchSize = 100
+	};
+
+	enum MemoryTierParameter
+	{
+		MemoryTierLimit = 8388608,
+		MemoryTierEntryLimit = 65536,
+		FrequencySketchDepth = 4,
+		FrequencySketchWidth = 4096,
+		FrequencySketchResetInterval = 40960
+	};
+
+	enum ContentParameter
+	{
+		ContentHashAttribute = (QNetworkRequest::User + 1),
+		ContentSizeLimit = 4194304
+	};
+
+	enum ContentFormat : char
+	{
+		RawContentFormat = 'R',
+		CompressedContentFormat = 'C'
+	};
+
+	struct ContentInformation final
+	{
+		qint64 size = 0;
+		int references = 0;
+	};
+
+	struct MemoryEntry final
+	{
+		QNetworkCacheMetaData metaData;
+		QByteArray data;
+		quint64 accessCounter = 0;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void loadIndex();
+	void saveIndex() const;
+	void rebuildIndex();
+	void evictEntries();
+	void addIndexEntry(const EntryInformation &entry);
+	void removeIndexEntry(const QUrl &url);
+	void addMemoryEntry(const QUrl &url, const QByteArray &data);
+	void removeMemoryEntry(const QUrl &url);
+	void clearMemoryEntries();
+	void retainContent(const QByteArray &hash, qint64 size);
+	void releaseContent(const QByteArray &hash);
+	void removeOrphanedContents();
+	void scheduleContentsRemoval();
+	QIODevice* readData(const QUrl &url);
+	QString getContentPath(const QByteArray &hash) const;
+	QString getContentsDirectory() const;
+	QByteArray storeContent(const QByteArray &data, const QString &mimeType);
+	void recordAccess(const QUrl &url);
+	int getEstimatedFrequency(const QUrl &url) const;
+	QString getIndexPath() const;
+	QString getDataDirectory() const;
+	QString getCacheFileName(const QUrl &url) const;
+	QUrl normalizeUrl(const QUrl &url) const;
+	static EntryInformation createEntryInformation(const QNetworkCacheMetaData &metaData);
+	static bool isFingerprintedUrl(const QUrl &url);
+	static bool isCompressible(const QString &mimeType);
+	qint64 expire() override;
+	static void removeFiles(const QStringList &paths);
+	static void removeDirectories(const QStringList &paths);
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleEvictionFinished();
 
 private:
-	QHash<QIODevice*, QUrl> m_devices;
+	QDirIterator *m_rebuildIterator;
+	QVector<EntryInformation> m_entries;
+	QHash<QUrl, int> m_entriesPositions;
+	QMultiMap<qint64, QUrl> m_accessOrder;
+	QHash<QIODevice*, QNetworkCacheMetaData> m_devices;
+	QHash<QUrl, MemoryEntry> m_memoryEntries;
+	QHash<QByteArray, ContentInformation> m_contents;
+	QSet<QIODevice*> m_contentDevices;
+	QStringList m_orphanedContentPaths;
+	QMap<quint64, QUrl> m_memoryAccessOrder;
+	QVector<quint8> m_frequencySketch;
+	QSet<QString> m_evictedPaths;
+	QSet<QUrl> m_revalidatedUrls;
+	QStringList m_ignoredQueryParameters;
+	QMultiHash<QString, QString> m_ignoredHostQueryParameters;
+	QFutureWatcher<void> m_evictionWatcher;
+	qint64 m_totalSize;
+	qint64 m_memoryTierSize;
+	quint64 m_memoryAccessCounter;
+	quint64 m_memoryTierHits;
+	quint64 m_memoryTierMisses;
+	quint64 m_memoryTierRejections;
+	quint64 m_lookupHits;
+	quint64 m_lookupMisses;
+	quint64 m_normalizedKeys;
+	quint64 m_normalizedHits;
+	int m_frequencySketchAdditions;
+	LoadPolicy m_loadPolicy;
+	int m_rebuildTimer;
+	bool m_isClearing;
+	bool m_isDeduplicationEnabled;
 
 signals:
 	void cleared();
+	void indexRebuilt();
 	void entryAdded(const QUrl &url);
 	void entryRemoved(const QUrl &url);
 };
@@ -23,6 +23,7 @@
 #include "Application.h"
 #include "CookieJar.h"
 #include "LocalListingNetworkReply.h"
+#include "MemoryNetworkCache.h"
 #include "NetworkCache.h"
 #include "NetworkManagerFactory.h"
 #include "SettingsManager.h"
@@ -30,7 +31,13 @@
 #include "../ui/AuthenticationDialog.h"
 #include "../ui/MainWindow.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QUrlQuery>
 #include <QtWidgets/QMessageBox>
 #include <QtNetwork/QNetworkProxy>
 
@@ -47,6 +54,12 @@ NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccess
 		m_cookieJar = new CookieJar({}, this);
 
 		setCookieJar(m_cookieJar);
+
+		MemoryNetworkCache *cache(NetworkManagerFactory::getPrivateCache());
+
+		setCache(cache);
+
+		cache->setParent(QCoreApplication::instance());
 	}
 	else
 	{
@@ -61,8 +74,11 @@ NetworkManager::NetworkManager(bool isPrivate, QObject *parent) : QNetworkAccess
 		setCache(cache);
 
 		cache->setParent(QCoreApplication::instance());
+
+		connect(this, &NetworkManager::finished, this, &NetworkManagerFactory::storeSslSession);
 	}
 
+	connect(this, &NetworkManager::finished, this, &NetworkManagerFactory::updateHttp2Support);
 	connect(this, &NetworkManager::authenticationRequired, this, &NetworkManager::handleAuthenticationRequired);
 	connect(this, &NetworkManager::proxyAuthenticationRequired, this, &NetworkManager::handleProxyAuthenticationRequired);
 	connect(this, &NetworkManager::sslErrors, this, &NetworkManager::handleSslErrors);
@@ -103,7 +119,7 @@ void NetworkManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError
 		return;
 	}
 
-	const QStringList exceptions(SettingsManager::getOption(SettingsManager::Security_IgnoreSslErrorsOption, Utils::extractHost(reply->url())).toStringList());
+	const QStringList exceptions(SettingsManager::getOption<QStringList>(SettingsManager::Security_IgnoreSslErrorsOption, Utils::extractHost(reply->url())));
 	QList<QSslError> errorsToIgnore;
 	QStringList messages;
 	messages.reserve(errors.count());
@@ -146,11 +162,12 @@ QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation op
 		return new LocalListingNetworkReply(request, this);
 	}
 
+	const NetworkManagerFactory::RequestHeaders &requestHeaders(NetworkManagerFactory::m_requestHeaders);
 	QNetworkRequest mutableRequest(request);
 
-	if (!NetworkManagerFactory::canSendReferrer())
+	for (int i = 0; i < requestHeaders.headers.count(); ++i)
 	{
-		mutableRequest.setRawHeader(QByteArrayLiteral("Referer"), {});
+		mutableRequest.setRawHeader(requestHeaders.headers.at(i).first, requestHeaders.headers.at(i).second);
 	}
 
 	if (operation == PostOperation && mutableRequest.header(QNetworkRequest::ContentTypeHeader).isNull())
@@ -162,12 +179,19 @@ QNetworkReply* NetworkManager::createRequest(QNetworkAccessManager::Operation op
 	{
 		mutableRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
 	}
-	else if (NetworkManagerFactory::getDoNotTrackPolicy() != NetworkManagerFactory::SkipTrackPolicy)
+	else if (!requestHeaders.doNotTrack.isEmpty())
 	{
-		mutableRequest.setRawHeader(QByteArrayLiteral("DNT"), QByteArray::number((NetworkManagerFactory::getDoNotTrackPolicy() == NetworkManagerFactory::DoNotAllowToTrackPolicy) ? 1 : 0));
+		mutableRequest.setRawHeader(QByteArrayLiteral("DNT"), requestHeaders.doNotTrack);
 	}
 
-	mutableRequest.setRawHeader(QByteArrayLiteral("Accept-Language"), NetworkManagerFactory::getAcceptLanguage().toLatin1());
+	if (cache())
+	{
+		NetworkManagerFactory::restoreSslSession(mutableRequest);
+	}
+
+#if QT_VERSION >= 0x050900
+	mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, NetworkManagerFactory::canUseHttp2(mutableRequest.url()));
+#endif
 
 	return QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
 }
@@ -220,4 +244,190 @@ NetworkManager::ResourceType NetworkManager::getResourceType(const QNetworkReque
 	return OtherType;
 }
 
+bool NetworkManager::exportRequestTimings(const QVector<RequestTiming> &timings, const QString &path, const QString &title)
+{
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	const auto createHeadersArray([&](const QList<QPair<QByteArray, QByteArray> > &headers)
+	{
+		QJsonArray headersArray;
+
+		for (int i = 0; i < headers.count(); ++i)
+		{
+			headersArray.append(QJsonObject({{QLatin1String("name"), QString::fromLatin1(headers.at(i).first)}, {QLatin1String("value"), QString::fromLatin1(headers.at(i).second)}}));
+		}
+
+		return headersArray;
+	});
+	const auto formatTime([&](qint64 time)
+	{
+		return QDateTime::fromMSecsSinceEpoch(time).toUTC().toString(QLatin1String("yyyy-MM-dd'T'HH:mm:ss.zzz'Z'"));
+	});
+	const qint64 pageStartTime(timings.isEmpty() ? QDateTime::currentMSecsSinceEpoch() : timings.first().startTime);
+	QJsonArray entriesArray;
+
+	for (int i = 0; i < timings.count(); ++i)
+	{
+		const RequestTiming &timing(timings.at(i));
+		const qint64 connectTime((timing.encryptedTime >= timing.startTime) ? (timing.encryptedTime - timing.startTime) : -1);
+		const qint64 sendTime((connectTime >= 0) ? timing.encryptedTime : timing.startTime);
+		const qint64 firstByteTime((timing.firstByteTime >= sendTime) ? timing.firstByteTime : qMax(sendTime, timing.finishedTime));
+		const qint64 waitTime(qMax(qint64(0), (firstByteTime - sendTime)));
+		const qint64 receiveTime((timing.finishedTime >= firstByteTime) ? (timing.finishedTime - firstByteTime) : 0);
+		const QList<QPair<QString, QString> > queryItems(QUrlQuery(timing.url).queryItems(QUrl::FullyDecoded));
+		QJsonArray queryArray;
+
+		for (int j = 0; j < queryItems.count(); ++j)
+		{
+			queryArray.append(QJsonObject({{QLatin1String("name"), queryItems.at(j).first}, {QLatin1String("value"), queryItems.at(j).second}}));
+		}
+
+		const QString httpVersion(timing.isHttp2 ? QLatin1String("HTTP/2") : QLatin1String("HTTP/1.1"));
+		QJsonObject requestObject({{QLatin1String("method"), QString::fromLatin1(timing.method.isEmpty() ? QByteArrayLiteral("GET") : timing.method)}, {QLatin1String("url"), timing.url.toString()}, {QLatin1String("httpVersion"), httpVersion}, {QLatin1String("cookies"), QJsonArray()}, {QLatin1String("headers"), createHeadersArray(timing.requestHeaders)}, {QLatin1String("queryString"), queryArray}, {QLatin1String("headersSize"), -1}, {QLatin1String("bodySize"), -1}});
+		QJsonObject responseObject({{QLatin1String("status"), timing.statusCode}, {QLatin1String("statusText"), timing.statusText}, {QLatin1String("httpVersion"), httpVersion}, {QLatin1String("cookies"), QJsonArray()}, {QLatin1String("headers"), createHeadersArray(timing.responseHeaders)}, {QLatin1String("content"), QJsonObject({{QLatin1String("size"), timing.bytesReceived}, {QLatin1String("mimeType"), timing.mimeType}})}, {QLatin1String("redirectURL"), QString()}, {QLatin1String("headersSize"), -1}, {QLatin1String("bodySize"), (timing.isCached ? 0 : timing.bytesReceived)}});
+		QJsonObject timingsObject({{QLatin1String("blocked"), -1}, {QLatin1String("dns"), (timing.hasCachedHost ? 0 : -1)}, {QLatin1String("connect"), connectTime}, {QLatin1String("ssl"), -1}, {QLatin1String("send"), 0}, {QLatin1String("wait"), waitTime}, {QLatin1String("receive"), receiveTime}});
+		QJsonObject entryObject({{QLatin1String("pageref"), QLatin1String("page_1")}, {QLatin1String("startedDateTime"), formatTime(timing.startTime)}, {QLatin1String("time"), (qMax(qint64(0), connectTime) + waitTime + receiveTime)}, {QLatin1String("request"), requestObject}, {QLatin1String("response"), responseObject}, {QLatin1String("cache"), QJsonObject()}, {QLatin1String("timings"), timingsObject}});
+		entryObject.insert(QLatin1String("_fromCache"), timing.isCached);
+		entryObject.insert(QLatin1String("_blockedByContentFilter"), timing.isBlocked);
+
+		if (timing.isHttp2)
+		{
+			entryObject.insert(QLatin1String("connection"), timing.url.host() + QLatin1Char(':') + QString::number(timing.url.port(443)));
+		}
+
+		entriesArray.append(entryObject);
+	}
+
+	const QJsonObject pageObject({{QLatin1String("startedDateTime"), formatTime(pageStartTime)}, {QLatin1String("id"), QLatin1String("page_1")}, {QLatin1String("title"), title}, {QLatin1String("pageTimings"), QJsonObject({{QLatin1String("onContentLoad"), -1}, {QLatin1String("onLoad"), -1}})}});
+	const QJsonObject logObject({{QLatin1String("version"), QLatin1String("1.2")}, {QLatin1String("creator"), QJsonObject({{QLatin1String("name"), QLatin1String("Otter Browser")}, {QLatin1String("version"), Application::getFullVersion()}})}, {QLatin1String("pages"), QJsonArray({pageObject})}, {QLatin1String("entries"), entriesArray}});
+
+	file.write(QJsonDocument(QJsonObject({{QLatin1String("log"), logObject}})).toJson(QJsonDocument::Indented));
+
+	return file.commit();
+}
+
+BlockedRequestsLog::BlockedRequestsLog() :
+	m_requestsPosition(0),
+	m_amount(0)
+{
+}
+
+void BlockedRequestsLog::addRequest(const NetworkManager::ResourceInformation &resource, bool canHideElement)
+{
+	const QString host(resource.url.host());
+	QString rule(resource.metaData.value(NetworkManager::ContentBlockingRuleMetaData).toString());
+	const int profile(resource.metaData.value(NetworkManager::ContentBlockingProfileMetaData, -1).toInt());
+
+	++m_amount;
+	++m_hostsAmounts[host];
+	++m_profilesAmounts[profile];
+
+	if (!rule.isEmpty())
+	{
+		QHash<QString, int>::iterator iterator(m_rulesAmounts.find(rule));
+
+		if (iterator == m_rulesAmounts.end())
+		{
+			iterator = m_rulesAmounts.insert(rule, 0);
+		}
+		else
+		{
+			rule = iterator.key();
+		}
+
+		++iterator.value();
+	}
+
+	NetworkManager::ResourceInformation compactResource(resource);
+
+	if (!rule.isEmpty())
+	{
+		compactResource.metaData[NetworkManager::ContentBlockingRuleMetaData] = rule;
+	}
+
+	if (m_requests.count() < RecentRequestsLimit)
+	{
+		m_requests.append(compactResource);
+	}
+	else
+	{
+		m_requests[m_requestsPosition] = compactResource;
+
+		m_requestsPosition = ((m_requestsPosition + 1) % RecentRequestsLimit);
+	}
+
+	if (!canHideElement)
+	{
+		return;
+	}
+
+	const QString element(resource.url.url());
+
+	if (m_elementsSet.contains(element))
+	{
+		return;
+	}
+
+	if (m_elements.count() >= ElementsLimit)
+	{
+		m_elementsSet.remove(m_elements.takeFirst());
+	}
+
+	m_elements.append(element);
+	m_elementsSet.insert(element);
+}
+
+void BlockedRequestsLog::clear()
+{
+	m_requests.clear();
+	m_elements.clear();
+	m_elementsSet.clear();
+	m_hostsAmounts.clear();
+	m_rulesAmounts.clear();
+	m_profilesAmounts.clear();
+
+	m_requestsPosition = 0;
+	m_amount = 0;
+}
+
+QStringList BlockedRequestsLog::getElements() const
+{
+	return m_elements;
+}
+
+QVector<NetworkManager::ResourceInformation> BlockedRequestsLog::getRequests() const
+{
+	if (m_requestsPosition == 0)
+	{
+		return m_requests;
+	}
+
+	return (m_requests.mid(m_requestsPosition) + m_requests.mid(0, m_requestsPosition));
+}
+
+QHash<QString, int> BlockedRequestsLog::getHostsAmounts() const
+{
+	return m_hostsAmounts;
+}
+
+QHash<QString, int> BlockedRequestsLog::getRulesAmounts() const
+{
+	return m_rulesAmounts;
+}
+
+QHash<int, int> BlockedRequestsLog::getProfilesAmounts() const
+{
+	return m_profilesAmounts;
+}
+
+int BlockedRequestsLog::getAmount() const
+{
+	return m_amount;
+}
+
 }
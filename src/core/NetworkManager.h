@@ -22,7 +22,11 @@
 #ifndef OTTER_NETWORKMANAGER_H
 #define OTTER_NETWORKMANAGER_H
 
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
 #include <QtCore/QUrl>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkAccessManager>
 
 namespace Otter
@@ -65,10 +69,37 @@ public:
 		ResourceType resourceType = OtherType;
 	};
 
+	struct RequestTiming final
+	{
+		QUrl url;
+		QByteArray method;
+		QString mimeType;
+		QString statusText;
+		QList<QPair<QByteArray, QByteArray> > requestHeaders;
+		QList<QPair<QByteArray, QByteArray> > responseHeaders;
+		qint64 startTime = -1;
+		qint64 encryptedTime = -1;
+		qint64 firstByteTime = -1;
+		qint64 finishedTime = -1;
+		qint64 bytesReceived = 0;
+		ResourceType resourceType = OtherType;
+		int statusCode = 0;
+		bool hasCachedHost = false;
+		bool isCached = false;
+		bool isBlocked = false;
+		bool isHttp2 = false;
+
+		qint64 getDuration() const
+		{
+			return ((startTime >= 0 && finishedTime >= startTime) ? (finishedTime - startTime) : -1);
+		}
+	};
+
 	explicit NetworkManager(bool isPrivate = false, QObject *parent = nullptr);
 
 	CookieJar* getCookieJar() const;
 	static ResourceType getResourceType(const QNetworkRequest &request, const QUrl &firstPartyUrl = {});
+	static bool exportRequestTimings(const QVector<RequestTiming> &timings, const QString &path, const QString &title = {});
 
 protected:
 	QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData) override;
@@ -84,6 +115,37 @@ private:
 friend class NetworkManagerFactory;
 };
 
+class BlockedRequestsLog final
+{
+public:
+	enum LogParameter
+	{
+		RecentRequestsLimit = 500,
+		ElementsLimit = 1000
+	};
+
+	BlockedRequestsLog();
+
+	void addRequest(const NetworkManager::ResourceInformation &resource, bool canHideElement);
+	void clear();
+	QStringList getElements() const;
+	QVector<NetworkManager::ResourceInformation> getRequests() const;
+	QHash<QString, int> getHostsAmounts() const;
+	QHash<QString, int> getRulesAmounts() const;
+	QHash<int, int> getProfilesAmounts() const;
+	int getAmount() const;
+
+private:
+	QVector<NetworkManager::ResourceInformation> m_requests;
+	QStringList m_elements;
+	QSet<QString> m_elementsSet;
+	QHash<QString, int> m_hostsAmounts;
+	QHash<QString, int> m_rulesAmounts;
+	QHash<int, int> m_profilesAmounts;
+	int m_requestsPosition;
+	int m_amount;
+};
+
 }
 
 #endif
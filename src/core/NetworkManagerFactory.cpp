@@ -21,20 +21,26 @@
 #include "NetworkManagerFactory.h"
 #include "AddonsManager.h"
 #include "Application.h"
+#include "Console.h"
 #include "ContentFiltersManager.h"
 #include "CookieJar.h"
+#include "MemoryNetworkCache.h"
 #include "NetworkCache.h"
 #include "NetworkManager.h"
 #include "NetworkProxyFactory.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
+#include "Utils.h"
 #include "WebBackend.h"
+#include "../ui/MainWindow.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QTimerEvent>
 #include <QtNetwork/QNetworkConfigurationManager>
 #include <QtNetwork/QSslConfiguration>
 
@@ -46,14 +52,28 @@ NetworkManager* NetworkManagerFactory::m_privateNetworkManager(nullptr);
 NetworkManager* NetworkManagerFactory::m_standardNetworkManager(nullptr);
 NetworkProxyFactory* NetworkManagerFactory::m_proxyFactory(nullptr);
 NetworkCache* NetworkManagerFactory::m_cache(nullptr);
+MemoryNetworkCache* NetworkManagerFactory::m_privateCache(nullptr);
 CookieJar* NetworkManagerFactory::m_cookieJar(nullptr);
 QString NetworkManagerFactory::m_acceptLanguage;
 QMap<QString, ProxyDefinition> NetworkManagerFactory::m_proxies;
 QMap<QString, UserAgentDefinition> NetworkManagerFactory::m_userAgents;
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy);
 QList<QSslCipher> NetworkManagerFactory::m_defaultCiphers;
+QHash<QString, NetworkManagerFactory::HostEntry> NetworkManagerFactory::m_hosts;
+QSet<QString> NetworkManagerFactory::m_pendingHosts;
+QMutex NetworkManagerFactory::m_hostsMutex;
+QHash<QString, qint64> NetworkManagerFactory::m_preconnections;
+QHash<QUrl, qint64> NetworkManagerFactory::m_prefetches;
+QHash<QString, QByteArray> NetworkManagerFactory::m_sslSessions;
+QHash<QString, bool> NetworkManagerFactory::m_http2Hosts;
+QHash<QString, NetworkManagerFactory::NetworkProfile> NetworkManagerFactory::m_networkProfiles;
+NetworkManagerFactory::RequestHeaders NetworkManagerFactory::m_requestHeaders;
+int NetworkManagerFactory::m_hostsTimer(0);
 bool NetworkManagerFactory::m_canSendReferrer(true);
+bool NetworkManagerFactory::m_isDnsPrefetchEnabled(true);
+bool NetworkManagerFactory::m_isHttp2Enabled(true);
 bool NetworkManagerFactory::m_isInitialized(false);
+bool NetworkManagerFactory::m_isSpeculativeLoadingEnabled(true);
 bool NetworkManagerFactory::m_isWorkingOffline(false);
 
 ProxiesModel::ProxiesModel(const QString &selectedProxy, bool isEditor, QObject *parent) : ItemModel(parent),
@@ -222,11 +242,54 @@ NetworkManagerFactory::NetworkManagerFactory(QObject *parent) : QObject(parent)
 		}
 	}
 
+	configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
 	QSslConfiguration::setDefaultConfiguration(configuration);
 
 	connect(new QNetworkConfigurationManager(this), &QNetworkConfigurationManager::onlineStateChanged, this, &NetworkManagerFactory::onlineStateChanged);
 }
 
+void NetworkManagerFactory::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_hostsTimer)
+	{
+		return;
+	}
+
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	QStringList hosts;
+
+	m_hostsMutex.lock();
+
+	QHash<QString, HostEntry>::iterator iterator(m_hosts.begin());
+
+	while (iterator != m_hosts.end())
+	{
+		const HostEntry &entry(iterator.value());
+
+		if ((currentTime - entry.accessTime) > HostPositiveCacheTime)
+		{
+			iterator = m_hosts.erase(iterator);
+
+			continue;
+		}
+
+		if (m_isDnsPrefetchEnabled && entry.information.error() == QHostInfo::NoError && (entry.expirationTime - currentTime) <= HostRefreshInterval && !m_pendingHosts.contains(iterator.key()))
+		{
+			hosts.append(iterator.key());
+		}
+
+		++iterator;
+	}
+
+	m_hostsMutex.unlock();
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		startHostLookup(hosts.at(i));
+	}
+}
+
 void NetworkManagerFactory::createInstance()
 {
 	if (!m_instance)
@@ -263,12 +326,40 @@ void NetworkManagerFactory::initialize()
 
 	m_instance->handleOptionChanged(SettingsManager::Network_AcceptLanguageOption, SettingsManager::getOption(SettingsManager::Network_AcceptLanguageOption));
 	m_instance->handleOptionChanged(SettingsManager::Network_DoNotTrackPolicyOption, SettingsManager::getOption(SettingsManager::Network_DoNotTrackPolicyOption));
+	m_instance->handleOptionChanged(SettingsManager::Network_EnableDnsPrefetchOption, SettingsManager::getOption(SettingsManager::Network_EnableDnsPrefetchOption));
+	m_instance->handleOptionChanged(SettingsManager::Network_EnableHttp2Option, SettingsManager::getOption(SettingsManager::Network_EnableHttp2Option));
 	m_instance->handleOptionChanged(SettingsManager::Network_EnableReferrerOption, SettingsManager::getOption(SettingsManager::Network_EnableReferrerOption));
+	m_instance->handleOptionChanged(SettingsManager::Network_EnableSpeculativeLoadingOption, SettingsManager::getOption(SettingsManager::Network_EnableSpeculativeLoadingOption));
 	m_instance->handleOptionChanged(SettingsManager::Network_ProxyOption, SettingsManager::getOption(SettingsManager::Network_ProxyOption));
 	m_instance->handleOptionChanged(SettingsManager::Network_WorkOfflineOption, SettingsManager::getOption(SettingsManager::Network_WorkOfflineOption));
 	m_instance->handleOptionChanged(SettingsManager::Security_CiphersOption, SettingsManager::getOption(SettingsManager::Security_CiphersOption));
 
+	m_hostsTimer = m_instance->startTimer(HostRefreshInterval);
+
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, m_instance, &NetworkManagerFactory::handleOptionChanged);
+	connect(SettingsManager::getInstance(), &SettingsManager::hostOptionChanged, m_instance, []()
+	{
+		m_networkProfiles.clear();
+	});
+	connect(Application::getInstance(), &Application::windowRemoved, m_instance, [](MainWindow *mainWindow)
+	{
+		if (!m_privateCache || !mainWindow->isPrivate())
+		{
+			return;
+		}
+
+		const QVector<MainWindow*> windows(Application::getWindows());
+
+		for (int i = 0; i < windows.count(); ++i)
+		{
+			if (windows.at(i)->isPrivate())
+			{
+				return;
+			}
+		}
+
+		m_privateCache->clear();
+	});
 }
 
 void NetworkManagerFactory::clearCookies(int period)
@@ -279,6 +370,103 @@ void NetworkManagerFactory::clearCookies(int period)
 	}
 
 	m_cookieJar->clearCookies(period);
+
+	m_sslSessions.clear();
+}
+
+void NetworkManagerFactory::restoreSslSession(QNetworkRequest &request)
+{
+	if (request.url().scheme() != QLatin1String("https"))
+	{
+		return;
+	}
+
+	const QByteArray sessionTicket(m_sslSessions.value(getConnectionKey(request.url())));
+
+	if (!sessionTicket.isEmpty())
+	{
+		QSslConfiguration configuration(request.sslConfiguration());
+		configuration.setSessionTicket(sessionTicket);
+
+		request.setSslConfiguration(configuration);
+	}
+}
+
+void NetworkManagerFactory::storeSslSession(QNetworkReply *reply)
+{
+	if (!reply || reply->url().scheme() != QLatin1String("https") || reply->error() == QNetworkReply::SslHandshakeFailedError)
+	{
+		return;
+	}
+
+	const QByteArray sessionTicket(reply->sslConfiguration().sessionTicket());
+
+	if (sessionTicket.isEmpty())
+	{
+		return;
+	}
+
+	const QString key(getConnectionKey(reply->url()));
+
+	if (m_sslSessions.count() >= SslSessionsLimit && !m_sslSessions.contains(key))
+	{
+		m_sslSessions.erase(m_sslSessions.begin());
+	}
+
+	m_sslSessions[key] = sessionTicket;
+}
+
+void NetworkManagerFactory::updateHttp2Support(QNetworkReply *reply)
+{
+#if QT_VERSION >= 0x050900
+	if (!reply || reply->url().scheme() != QLatin1String("https") || !reply->request().attribute(QNetworkRequest::HTTP2AllowedAttribute).toBool())
+	{
+		return;
+	}
+
+	const QString key(getConnectionKey(reply->url()));
+
+	if (reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool())
+	{
+		if (!m_http2Hosts.value(key, false))
+		{
+			if (m_http2Hosts.count() >= Http2HostsLimit)
+			{
+				m_http2Hosts.clear();
+			}
+
+			m_http2Hosts[key] = true;
+		}
+
+		return;
+	}
+
+	switch (reply->error())
+	{
+		case QNetworkReply::ProtocolFailure:
+		case QNetworkReply::ProtocolInvalidOperationError:
+		case QNetworkReply::ProtocolUnknownError:
+		case QNetworkReply::RemoteHostClosedError:
+		case QNetworkReply::UnknownNetworkError:
+			if (!m_http2Hosts.contains(key))
+			{
+				if (m_http2Hosts.count() >= Http2HostsLimit)
+				{
+					m_http2Hosts.clear();
+				}
+
+				m_http2Hosts[key] = false;
+
+				Console::addMessage(QCoreApplication::translate("main", "Disabling HTTP/2 for %1 after failed request").arg(reply->url().host()), Console::NetworkCategory, Console::WarningLevel, reply->url().toString());
+			}
+
+			break;
+		default:
+			break;
+	}
+#else
+	Q_UNUSED(reply)
+#endif
 }
 
 void NetworkManagerFactory::clearCache(int period)
@@ -287,6 +475,11 @@ void NetworkManagerFactory::clearCache(int period)
 	{
 		m_cache->clearCache(period);
 	}
+
+	if (m_privateCache)
+	{
+		m_privateCache->clear();
+	}
 }
 
 void NetworkManagerFactory::loadProxies()
@@ -322,6 +515,7 @@ void NetworkManagerFactory::loadProxies()
 void NetworkManagerFactory::loadUserAgents()
 {
 	m_userAgents.clear();
+	m_networkProfiles.clear();
 
 	QFile file(SessionsManager::getReadableDataPath(QLatin1String("userAgents.json")));
 
@@ -494,10 +688,13 @@ void NetworkManagerFactory::readUserAgent(const QJsonValue &value, UserAgentDefi
 
 void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &value)
 {
+	m_networkProfiles.clear();
+
 	switch (identifier)
 	{
 		case SettingsManager::Network_AcceptLanguageOption:
 			m_acceptLanguage = ((value.toString().isEmpty()) ? QLatin1String(" ") : value.toString().replace(QLatin1String("system"), QLocale::system().bcp47Name()));
+			m_requestHeaders = createRequestHeaders(m_acceptLanguage, m_doNotTrackPolicy, m_canSendReferrer);
 
 			break;
 		case SettingsManager::Network_DoNotTrackPolicyOption:
@@ -516,11 +713,32 @@ void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &
 				{
 					m_doNotTrackPolicy = SkipTrackPolicy;
 				}
+
+				m_requestHeaders = createRequestHeaders(m_acceptLanguage, m_doNotTrackPolicy, m_canSendReferrer);
 			}
 
+			break;
+		case SettingsManager::Network_EnableDnsPrefetchOption:
+			m_isDnsPrefetchEnabled = value.toBool();
+
+			break;
+		case SettingsManager::Network_EnableHttp2Option:
+			m_isHttp2Enabled = value.toBool();
+
 			break;
 		case SettingsManager::Network_EnableReferrerOption:
 			m_canSendReferrer = value.toBool();
+			m_requestHeaders = createRequestHeaders(m_acceptLanguage, m_doNotTrackPolicy, m_canSendReferrer);
+
+			break;
+		case SettingsManager::Network_EnableSpeculativeLoadingOption:
+			m_isSpeculativeLoadingEnabled = value.toBool();
+
+			if (!m_isSpeculativeLoadingEnabled)
+			{
+				m_preconnections.clear();
+				m_prefetches.clear();
+			}
 
 			break;
 		case SettingsManager::Network_ProxyOption:
@@ -567,11 +785,97 @@ void NetworkManagerFactory::handleOptionChanged(int identifier, const QVariant &
 	}
 }
 
+void NetworkManagerFactory::handleHostLookupFinished(const QHostInfo &information)
+{
+	const QString host(information.hostName().toLower());
+
+	m_hostsMutex.lock();
+	m_pendingHosts.remove(host);
+	m_hostsMutex.unlock();
+
+	cacheHostInformation(host, information);
+}
+
 void NetworkManagerFactory::notifyAuthenticated(QAuthenticator *authenticator, bool wasAccepted)
 {
 	emit m_instance->authenticated(authenticator, wasAccepted);
 }
 
+void NetworkManagerFactory::prefetchHost(const QString &host)
+{
+	if (!m_isDnsPrefetchEnabled || host.isEmpty() || !QHostAddress(host).isNull())
+	{
+		return;
+	}
+
+	const QString key(host.toLower());
+
+	m_hostsMutex.lock();
+
+	if (m_hosts.contains(key) && m_hosts[key].expirationTime > QDateTime::currentMSecsSinceEpoch())
+	{
+		m_hosts[key].accessTime = QDateTime::currentMSecsSinceEpoch();
+
+		m_hostsMutex.unlock();
+
+		return;
+	}
+
+	const bool isPending(m_pendingHosts.contains(key));
+
+	m_hostsMutex.unlock();
+
+	if (!isPending)
+	{
+		startHostLookup(key);
+	}
+}
+
+void NetworkManagerFactory::startHostLookup(const QString &host)
+{
+	m_hostsMutex.lock();
+	m_pendingHosts.insert(host);
+	m_hostsMutex.unlock();
+
+	QHostInfo::lookupHost(host, m_instance, SLOT(handleHostLookupFinished(QHostInfo)));
+}
+
+void NetworkManagerFactory::cacheHostInformation(const QString &host, const QHostInfo &information)
+{
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	const QString key(host.toLower());
+	QMutexLocker locker(&m_hostsMutex);
+
+	if (m_hosts.count() >= HostCacheLimit && !m_hosts.contains(key))
+	{
+		QHash<QString, HostEntry>::iterator iterator(m_hosts.begin());
+
+		while (iterator != m_hosts.end())
+		{
+			if (iterator.value().expirationTime <= currentTime)
+			{
+				iterator = m_hosts.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		if (m_hosts.count() >= HostCacheLimit)
+		{
+			return;
+		}
+	}
+
+	HostEntry entry;
+	entry.information = information;
+	entry.accessTime = (m_hosts.contains(key) ? m_hosts[key].accessTime : currentTime);
+	entry.expirationTime = (currentTime + ((information.error() == QHostInfo::NoError && !information.addresses().isEmpty()) ? HostPositiveCacheTime : HostNegativeCacheTime));
+
+	m_hosts[key] = entry;
+}
+
 void NetworkManagerFactory::updateProxiesOption()
 {
 	SettingsManager::OptionDefinition proxiesOption(SettingsManager::getOptionDefinition(SettingsManager::Network_ProxyOption));
@@ -611,6 +915,11 @@ void NetworkManagerFactory::updateUserAgentsOption()
 	SettingsManager::updateOptionDefinition(SettingsManager::Network_UserAgentOption, userAgentsOption);
 }
 
+QString NetworkManagerFactory::getConnectionKey(const QUrl &url)
+{
+	return (url.host().toLower() + QLatin1Char(':') + QString::number(url.port(443)));
+}
+
 NetworkManagerFactory* NetworkManagerFactory::getInstance()
 {
 	return m_instance;
@@ -640,6 +949,16 @@ NetworkCache* NetworkManagerFactory::getCache()
 	return m_cache;
 }
 
+MemoryNetworkCache* NetworkManagerFactory::getPrivateCache()
+{
+	if (!m_privateCache)
+	{
+		m_privateCache = new MemoryNetworkCache(QCoreApplication::instance());
+	}
+
+	return m_privateCache;
+}
+
 CookieJar* NetworkManagerFactory::getCookieJar()
 {
 	if (!m_cookieJar)
@@ -652,11 +971,16 @@ CookieJar* NetworkManagerFactory::getCookieJar()
 
 QNetworkReply* NetworkManagerFactory::createRequest(const QUrl &url, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData)
 {
-	QNetworkRequest request(url);
-	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
-	request.setHeader(QNetworkRequest::UserAgentHeader, getUserAgent());
+	return createRequest(QNetworkRequest(url), operation, isPrivate, outgoingData);
+}
 
-	return getNetworkManager(isPrivate)->createRequest(operation, request, outgoingData);
+QNetworkReply* NetworkManagerFactory::createRequest(const QNetworkRequest &request, QNetworkAccessManager::Operation operation, bool isPrivate, QIODevice *outgoingData)
+{
+	QNetworkRequest mutableRequest(request);
+	mutableRequest.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+	mutableRequest.setHeader(QNetworkRequest::UserAgentHeader, getUserAgent());
+
+	return getNetworkManager(isPrivate)->createRequest(operation, mutableRequest, outgoingData);
 }
 
 QString NetworkManagerFactory::getAcceptLanguage()
@@ -744,16 +1068,246 @@ UserAgentDefinition NetworkManagerFactory::getUserAgent(const QString &identifie
 	return m_userAgents[identifier];
 }
 
+NetworkManagerFactory::NetworkProfile NetworkManagerFactory::getNetworkProfile(const QUrl &url, const QHash<int, QVariant> &options)
+{
+	const QVector<int> identifiers({SettingsManager::ContentBlocking_EnableContentBlockingOption, SettingsManager::ContentBlocking_IgnoreHostsOption, SettingsManager::ContentBlocking_ProfilesOption, SettingsManager::Network_AcceptLanguageOption, SettingsManager::Network_CookiesKeepModeOption, SettingsManager::Network_CookiesPolicyOption, SettingsManager::Network_DoNotTrackPolicyOption, SettingsManager::Network_EnableReferrerOption, SettingsManager::Network_ProxyOption, SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption, SettingsManager::Network_ThirdPartyCookiesPolicyOption, SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption, SettingsManager::Network_UserAgentOption, SettingsManager::Permissions_EnableImagesOption});
+	const QString host(Utils::extractHost(url));
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		if (options.contains(identifiers.at(i)))
+		{
+			return createNetworkProfile(host, options);
+		}
+	}
+
+	if (m_networkProfiles.contains(host))
+	{
+		return m_networkProfiles[host];
+	}
+
+	if (m_networkProfiles.count() >= NetworkProfilesLimit)
+	{
+		m_networkProfiles.clear();
+	}
+
+	const NetworkProfile profile(createNetworkProfile(host, {}));
+
+	m_networkProfiles[host] = profile;
+
+	return profile;
+}
+
+NetworkManagerFactory::NetworkProfile NetworkManagerFactory::createNetworkProfile(const QString &host, const QHash<int, QVariant> &options)
+{
+	const auto getOption([&](int identifier)
+	{
+		return (options.contains(identifier) ? options[identifier] : SettingsManager::getOption(identifier, host));
+	});
+	NetworkProfile profile;
+
+	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption).toBool())
+	{
+		profile.contentBlockingProfiles = getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList();
+	}
+
+	QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption).toString());
+	acceptLanguage = ((acceptLanguage.isEmpty()) ? QLatin1String(" ") : acceptLanguage.replace(QLatin1String("system"), QLocale::system().bcp47Name()));
+
+	const QString doNotTrackPolicyValue(getOption(SettingsManager::Network_DoNotTrackPolicyOption).toString());
+	DoNotTrackPolicy doNotTrackPolicy(SkipTrackPolicy);
+
+	if (doNotTrackPolicyValue == QLatin1String("allow"))
+	{
+		doNotTrackPolicy = AllowToTrackPolicy;
+	}
+	else if (doNotTrackPolicyValue == QLatin1String("doNotAllow"))
+	{
+		doNotTrackPolicy = DoNotAllowToTrackPolicy;
+	}
+
+	profile.requestHeaders = createRequestHeaders(acceptLanguage, doNotTrackPolicy, getOption(SettingsManager::Network_EnableReferrerOption).toBool());
+	profile.userAgent = getUserAgent(getOption(SettingsManager::Network_UserAgentOption).toString()).value;
+	profile.unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption).toStringList();
+	profile.areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption).toString() != QLatin1String("disabled"));
+
+	const QString generalCookiesPolicyValue(getOption(SettingsManager::Network_CookiesPolicyOption).toString());
+
+	if (generalCookiesPolicyValue == QLatin1String("ignore"))
+	{
+		profile.generalCookiesPolicy = CookieJar::IgnoreCookies;
+	}
+	else if (generalCookiesPolicyValue == QLatin1String("readOnly"))
+	{
+		profile.generalCookiesPolicy = CookieJar::ReadOnlyCookies;
+	}
+	else if (generalCookiesPolicyValue == QLatin1String("acceptExisting"))
+	{
+		profile.generalCookiesPolicy = CookieJar::AcceptExistingCookies;
+	}
+
+	const QString thirdPartyCookiesPolicyValue(getOption(SettingsManager::Network_ThirdPartyCookiesPolicyOption).toString());
+
+	if (thirdPartyCookiesPolicyValue == QLatin1String("ignore"))
+	{
+		profile.thirdPartyCookiesPolicy = CookieJar::IgnoreCookies;
+	}
+	else if (thirdPartyCookiesPolicyValue == QLatin1String("readOnly"))
+	{
+		profile.thirdPartyCookiesPolicy = CookieJar::ReadOnlyCookies;
+	}
+	else if (thirdPartyCookiesPolicyValue == QLatin1String("acceptExisting"))
+	{
+		profile.thirdPartyCookiesPolicy = CookieJar::AcceptExistingCookies;
+	}
+
+	const QString keepCookiesModeValue(getOption(SettingsManager::Network_CookiesKeepModeOption).toString());
+
+	if (keepCookiesModeValue == QLatin1String("keepUntilExit"))
+	{
+		profile.keepCookiesMode = CookieJar::KeepUntilExitMode;
+	}
+	else if (keepCookiesModeValue == QLatin1String("ask"))
+	{
+		profile.keepCookiesMode = CookieJar::AskIfKeepMode;
+	}
+
+	profile.thirdPartyCookiesAcceptedHosts = getOption(SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption).toStringList();
+	profile.thirdPartyCookiesRejectedHosts = getOption(SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption).toStringList();
+	profile.proxy = getOption(SettingsManager::Network_ProxyOption).toString();
+	profile.hasProxyOverride = (options.contains(SettingsManager::Network_ProxyOption) || SettingsManager::hasOverride(host, SettingsManager::Network_ProxyOption));
+
+	return profile;
+}
+
+NetworkManagerFactory::RequestHeaders NetworkManagerFactory::createRequestHeaders(const QString &acceptLanguage, DoNotTrackPolicy doNotTrackPolicy, bool canSendReferrer)
+{
+	RequestHeaders requestHeaders;
+	requestHeaders.headers.append({QByteArrayLiteral("Accept-Language"), acceptLanguage.toLatin1()});
+
+	if (!canSendReferrer)
+	{
+		requestHeaders.headers.append({QByteArrayLiteral("Referer"), {}});
+	}
+
+	if (doNotTrackPolicy != SkipTrackPolicy)
+	{
+		requestHeaders.doNotTrack = ((doNotTrackPolicy == DoNotAllowToTrackPolicy) ? QByteArrayLiteral("1") : QByteArrayLiteral("0"));
+	}
+
+	return requestHeaders;
+}
+
 NetworkManagerFactory::DoNotTrackPolicy NetworkManagerFactory::getDoNotTrackPolicy()
 {
 	return m_doNotTrackPolicy;
 }
 
+bool NetworkManagerFactory::getHostInformation(const QString &host, QHostInfo &information)
+{
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+	const QString key(host.toLower());
+	QMutexLocker locker(&m_hostsMutex);
+
+	if (!m_hosts.contains(key) || m_hosts[key].expirationTime <= currentTime)
+	{
+		return false;
+	}
+
+	HostEntry &entry(m_hosts[key]);
+	entry.accessTime = currentTime;
+
+	information = entry.information;
+
+	return true;
+}
+
+bool NetworkManagerFactory::reserveSpeculativeLoad(const QUrl &url, bool isPrefetch)
+{
+	if (!m_isSpeculativeLoadingEnabled || m_isWorkingOffline || !url.isValid() || url.host().isEmpty() || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return false;
+	}
+
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+
+	if (isPrefetch)
+	{
+		QHash<QUrl, qint64>::iterator iterator(m_prefetches.begin());
+
+		while (iterator != m_prefetches.end())
+		{
+			if ((currentTime - iterator.value()) >= SpeculativeLoadInterval)
+			{
+				iterator = m_prefetches.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		const QUrl key(url.adjusted(QUrl::RemoveFragment));
+
+		if (m_prefetches.contains(key) || m_prefetches.count() >= PrefetchLimit)
+		{
+			return false;
+		}
+
+		m_prefetches[key] = currentTime;
+
+		return true;
+	}
+
+	QHash<QString, qint64>::iterator iterator(m_preconnections.begin());
+
+	while (iterator != m_preconnections.end())
+	{
+		if ((currentTime - iterator.value()) >= SpeculativeLoadInterval)
+		{
+			iterator = m_preconnections.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const QString key(url.scheme() + QLatin1String("://") + url.host().toLower() + QLatin1Char(':') + QString::number(url.port((url.scheme() == QLatin1String("https")) ? 443 : 80)));
+
+	if (m_preconnections.contains(key))
+	{
+		if ((currentTime - m_preconnections[key]) < SpeculativeLoadReuseTime)
+		{
+			return false;
+		}
+	}
+	else if (m_preconnections.count() >= PreconnectLimit)
+	{
+		return false;
+	}
+
+	m_preconnections[key] = currentTime;
+
+	return true;
+}
+
 bool NetworkManagerFactory::canSendReferrer()
 {
 	return m_canSendReferrer;
 }
 
+bool NetworkManagerFactory::canUseHttp2(const QUrl &url)
+{
+#if QT_VERSION >= 0x050900
+	return (m_isHttp2Enabled && !m_isWorkingOffline && url.scheme() == QLatin1String("https") && m_http2Hosts.value(getConnectionKey(url), true));
+#else
+	Q_UNUSED(url)
+
+	return false;
+#endif
+}
+
 bool NetworkManagerFactory::isWorkingOffline()
 {
 	return m_isWorkingOffline;
@@ -21,10 +21,14 @@
 #ifndef OTTER_NETWORKMANAGERFACTORY_H
 #define OTTER_NETWORKMANAGERFACTORY_H
 
+#include "CookieJar.h"
 #include "ItemModel.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
 #include <QtNetwork/QAuthenticator>
+#include <QtNetwork/QHostInfo>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QSslCipher>
 
@@ -130,6 +134,7 @@ struct UserAgentDefinition final
 };
 
 class CookieJar;
+class MemoryNetworkCache;
 class NetworkCache;
 class NetworkManager;
 class NetworkManagerFactory;
@@ -186,6 +191,28 @@ public:
 
 	Q_ENUM(DoNotTrackPolicy)
 
+	struct RequestHeaders final
+	{
+		QVector<QPair<QByteArray, QByteArray> > headers;
+		QByteArray doNotTrack;
+	};
+
+	struct NetworkProfile final
+	{
+		RequestHeaders requestHeaders;
+		QString userAgent;
+		QString proxy;
+		QStringList contentBlockingProfiles;
+		QStringList unblockedHosts;
+		QStringList thirdPartyCookiesAcceptedHosts;
+		QStringList thirdPartyCookiesRejectedHosts;
+		CookieJar::CookiesPolicy generalCookiesPolicy = CookieJar::AcceptAllCookies;
+		CookieJar::CookiesPolicy thirdPartyCookiesPolicy = CookieJar::AcceptAllCookies;
+		CookieJar::KeepMode keepCookiesMode = CookieJar::KeepUntilExpiresMode;
+		bool areImagesEnabled = true;
+		bool hasProxyOverride = false;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void clearCookies(int period = 0);
@@ -193,11 +220,18 @@ public:
 	static void loadProxies();
 	static void loadUserAgents();
 	static void notifyAuthenticated(QAuthenticator *authenticator, bool wasAccepted);
+	static void prefetchHost(const QString &host);
+	static void cacheHostInformation(const QString &host, const QHostInfo &information);
+	static void restoreSslSession(QNetworkRequest &request);
+	static void storeSslSession(QNetworkReply *reply);
+	static void updateHttp2Support(QNetworkReply *reply);
 	static NetworkManagerFactory* getInstance();
 	static NetworkManager* getNetworkManager(bool isPrivate = false);
 	static NetworkCache* getCache();
+	static MemoryNetworkCache* getPrivateCache();
 	static CookieJar* getCookieJar();
 	static QNetworkReply* createRequest(const QUrl &url, QNetworkAccessManager::Operation operation = QNetworkAccessManager::GetOperation, bool isPrivate = false, QIODevice *outgoingData = nullptr);
+	static QNetworkReply* createRequest(const QNetworkRequest &request, QNetworkAccessManager::Operation operation = QNetworkAccessManager::GetOperation, bool isPrivate = false, QIODevice *outgoingData = nullptr);
 	static QString getAcceptLanguage();
 	static QString getUserAgent();
 	static QStringList getProxies();
@@ -205,22 +239,66 @@ public:
 	static QList<QSslCipher> getDefaultCiphers();
 	static ProxyDefinition getProxy(const QString &identifier);
 	static UserAgentDefinition getUserAgent(const QString &identifier);
+	static NetworkProfile getNetworkProfile(const QUrl &url, const QHash<int, QVariant> &options = {});
 	static DoNotTrackPolicy getDoNotTrackPolicy();
+	static bool getHostInformation(const QString &host, QHostInfo &information);
+	static bool reserveSpeculativeLoad(const QUrl &url, bool isPrefetch);
 	static bool canSendReferrer();
+	static bool canUseHttp2(const QUrl &url);
 	static bool isWorkingOffline();
 	static bool usesSystemProxyAuthentication();
 	bool event(QEvent *event) override;
 
 protected:
+	enum HostCacheParameter
+	{
+		HostCacheLimit = 1000,
+		HostPositiveCacheTime = 300000,
+		HostNegativeCacheTime = 30000,
+		HostRefreshInterval = 30000
+	};
+
+	enum NetworkProfileParameter
+	{
+		NetworkProfilesLimit = 100
+	};
+
+	enum ConnectionCacheParameter
+	{
+		Http2HostsLimit = 1000,
+		SslSessionsLimit = 500
+	};
+
+	enum SpeculativeLoadParameter
+	{
+		PreconnectLimit = 6,
+		PrefetchLimit = 2,
+		SpeculativeLoadInterval = 60000,
+		SpeculativeLoadReuseTime = 10000
+	};
+
+	struct HostEntry final
+	{
+		QHostInfo information;
+		qint64 accessTime = 0;
+		qint64 expirationTime = 0;
+	};
+
 	explicit NetworkManagerFactory(QObject *parent = nullptr);
 
+	void timerEvent(QTimerEvent *event) override;
+	static void startHostLookup(const QString &host);
+	static QString getConnectionKey(const QUrl &url);
 	static void readProxy(const QJsonValue &value, ProxyDefinition *parent);
 	static void readUserAgent(const QJsonValue &value, UserAgentDefinition *parent);
 	static void updateProxiesOption();
 	static void updateUserAgentsOption();
+	static NetworkProfile createNetworkProfile(const QString &host, const QHash<int, QVariant> &options);
+	static RequestHeaders createRequestHeaders(const QString &acceptLanguage, DoNotTrackPolicy doNotTrackPolicy, bool canSendReferrer);
 
 protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleHostLookupFinished(const QHostInfo &information);
 
 private:
 	static NetworkManagerFactory *m_instance;
@@ -228,14 +306,28 @@ private:
 	static NetworkManager *m_standardNetworkManager;
 	static NetworkProxyFactory *m_proxyFactory;
 	static NetworkCache *m_cache;
+	static MemoryNetworkCache *m_privateCache;
 	static CookieJar *m_cookieJar;
 	static QString m_acceptLanguage;
 	static QMap<QString, ProxyDefinition> m_proxies;
 	static QMap<QString, UserAgentDefinition> m_userAgents;
 	static QList<QSslCipher> m_defaultCiphers;
+	static QHash<QString, HostEntry> m_hosts;
+	static QSet<QString> m_pendingHosts;
+	static QMutex m_hostsMutex;
+	static QHash<QString, qint64> m_preconnections;
+	static QHash<QUrl, qint64> m_prefetches;
+	static QHash<QString, QByteArray> m_sslSessions;
+	static QHash<QString, bool> m_http2Hosts;
+	static QHash<QString, NetworkProfile> m_networkProfiles;
+	static RequestHeaders m_requestHeaders;
 	static DoNotTrackPolicy m_doNotTrackPolicy;
+	static int m_hostsTimer;
 	static bool m_canSendReferrer;
+	static bool m_isDnsPrefetchEnabled;
+	static bool m_isHttp2Enabled;
 	static bool m_isInitialized;
+	static bool m_isSpeculativeLoadingEnabled;
 	static bool m_isWorkingOffline;
 
 signals:
@@ -21,6 +21,8 @@
 #include "NetworkProxyFactory.h"
 #include "NetworkAutomaticProxy.h"
 
+#include <QtCore/QDateTime>
+
 namespace Otter
 {
 
@@ -41,6 +43,9 @@ void NetworkProxyFactory::setProxy(const QString &identifier)
 
 	m_proxies.clear();
 	m_proxies[-1] = {QNetworkProxy(QNetworkProxy::NoProxy)};
+	m_decisionsCache.clear();
+
+	compileExceptions();
 
 	switch (m_definition.type)
 	{
@@ -83,33 +88,83 @@ void NetworkProxyFactory::setProxy(const QString &identifier)
 	}
 }
 
+void NetworkProxyFactory::compileExceptions()
+{
+	m_exceptionSubnets.clear();
+	m_exceptionHosts.clear();
+	m_exceptionPatterns.clear();
+
+	for (int i = 0; i < m_definition.exceptions.count(); ++i)
+	{
+		const QString exception(m_definition.exceptions.at(i).trimmed().toLower());
+
+		if (exception.isEmpty())
+		{
+			continue;
+		}
+
+		if (exception.contains(QLatin1Char('/')))
+		{
+			const QPair<QHostAddress, int> subnet(QHostAddress::parseSubnet(exception));
+
+			if (subnet.second != -1)
+			{
+				m_exceptionSubnets.append(subnet);
+			}
+
+			continue;
+		}
+
+		if (!QHostAddress(exception).isNull())
+		{
+			m_exceptionHosts.insert(exception);
+
+			continue;
+		}
+
+		QString domain(exception);
+
+		if (domain.startsWith(QLatin1String("*.")))
+		{
+			domain.remove(0, 2);
+		}
+		else if (domain.startsWith(QLatin1Char('.')))
+		{
+			domain.remove(0, 1);
+		}
+
+		bool isDomain(!domain.isEmpty() && !domain.endsWith(QLatin1Char('.')) && domain.at(0).isLetter());
+
+		for (int j = 0; isDomain && j < domain.length(); ++j)
+		{
+			const QChar character(domain.at(j));
+
+			isDomain = (character.isLetterOrNumber() || character == QLatin1Char('.') || character == QLatin1Char('-'));
+		}
+
+		if (isDomain)
+		{
+			m_exceptionHosts.insert(domain);
+		}
+		else
+		{
+			m_exceptionPatterns.append(exception);
+		}
+	}
+}
+
 QList<QNetworkProxy> NetworkProxyFactory::queryProxy(const QNetworkProxyQuery &query)
 {
 	switch (m_definition.type)
 	{
 		case ProxyDefinition::SystemProxy:
-			return QNetworkProxyFactory::systemProxyForQuery(query);
+			return getSystemProxy(query);
 
 		case ProxyDefinition::ManualProxy:
 			{
-				const QString host(query.peerHostName());
-
-				for (int i = 0; i < m_definition.exceptions.count(); ++i)
+				if (isException(query.peerHostName()))
 				{
-					if (m_definition.exceptions.at(i).contains(QLatin1Char('/')))
-					{
-						const QHostAddress address(host);
-						const QPair<QHostAddress, int> subnet(QHostAddress::parseSubnet(m_definition.exceptions.at(i)));
-
-						if (!address.isNull() && subnet.second != -1 && address.isInSubnet(subnet))
-						{
-							return m_proxies[-1];
-						}
-					}
-					else if (host.contains(m_definition.exceptions.at(i), Qt::CaseInsensitive))
-					{
-						return m_proxies[-1];
-					}
+					return m_proxies[-1];
 				}
 
 				if (m_proxies.contains(ProxyDefinition::SocksProtocol))
@@ -142,7 +197,7 @@ QList<QNetworkProxy> NetworkProxyFactory::queryProxy(const QNetworkProxyQuery &q
 				return m_automaticProxy->getProxy(query.url().toString(), query.peerHostName()).toList();
 			}
 
-			return QNetworkProxyFactory::systemProxyForQuery(query);
+			return getSystemProxy(query);
 		default:
 			break;
 	}
@@ -150,6 +205,52 @@ QList<QNetworkProxy> NetworkProxyFactory::queryProxy(const QNetworkProxyQuery &q
 	return m_proxies[-1];
 }
 
+QList<QNetworkProxy> NetworkProxyFactory::getSystemProxy(const QNetworkProxyQuery &query)
+{
+	const QString key(QString::number(query.queryType()) + QLatin1Char(' ') + query.protocolTag().toLower() + QLatin1String("://") + query.peerHostName().toLower() + QLatin1Char(':') + QString::number(query.peerPort()));
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+
+	if (m_decisionsCache.contains(key))
+	{
+		const ProxyDecision &decision(m_decisionsCache[key]);
+
+		if (decision.expirationTime > currentTime)
+		{
+			return decision.proxies;
+		}
+	}
+
+	if (m_decisionsCache.count() >= DecisionsCacheLimit)
+	{
+		QHash<QString, ProxyDecision>::iterator iterator(m_decisionsCache.begin());
+
+		while (iterator != m_decisionsCache.end())
+		{
+			if (iterator.value().expirationTime <= currentTime)
+			{
+				iterator = m_decisionsCache.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		if (m_decisionsCache.count() >= DecisionsCacheLimit)
+		{
+			m_decisionsCache.clear();
+		}
+	}
+
+	ProxyDecision decision;
+	decision.proxies = QNetworkProxyFactory::systemProxyForQuery(query);
+	decision.expirationTime = (currentTime + DecisionsCacheTime);
+
+	m_decisionsCache[key] = decision;
+
+	return decision.proxies;
+}
+
 QNetworkProxy::ProxyType NetworkProxyFactory::getProxyType(ProxyDefinition::ProtocolType protocol)
 {
 	switch (protocol)
@@ -168,6 +269,62 @@ QNetworkProxy::ProxyType NetworkProxyFactory::getProxyType(ProxyDefinition::Prot
 	return QNetworkProxy::DefaultProxy;
 }
 
+bool NetworkProxyFactory::isException(const QString &host) const
+{
+	if (host.isEmpty())
+	{
+		return false;
+	}
+
+	const QString normalizedHost(host.toLower());
+
+	if (!m_exceptionSubnets.isEmpty())
+	{
+		const QHostAddress address(normalizedHost);
+
+		if (!address.isNull())
+		{
+			for (int i = 0; i < m_exceptionSubnets.count(); ++i)
+			{
+				if (address.isInSubnet(m_exceptionSubnets.at(i)))
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	if (!m_exceptionHosts.isEmpty())
+	{
+		int position(0);
+
+		while (position >= 0)
+		{
+			if (m_exceptionHosts.contains(normalizedHost.mid(position)))
+			{
+				return true;
+			}
+
+			position = normalizedHost.indexOf(QLatin1Char('.'), position);
+
+			if (position >= 0)
+			{
+				++position;
+			}
+		}
+	}
+
+	for (int i = 0; i < m_exceptionPatterns.count(); ++i)
+	{
+		if (normalizedHost.contains(m_exceptionPatterns.at(i)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool NetworkProxyFactory::usesSystemAuthentication()
 {
 	return m_definition.usesSystemAuthentication;
@@ -23,6 +23,8 @@
 
 #include "NetworkManagerFactory.h"
 
+#include <QtCore/QSet>
+#include <QtNetwork/QHostAddress>
 #include <QtNetwork/QNetworkProxy>
 
 namespace Otter
@@ -43,12 +45,31 @@ public:
 	bool usesSystemAuthentication();
 
 protected:
+	enum DecisionsCacheParameter
+	{
+		DecisionsCacheLimit = 200,
+		DecisionsCacheTime = 30000
+	};
+
+	struct ProxyDecision final
+	{
+		QList<QNetworkProxy> proxies;
+		qint64 expirationTime = 0;
+	};
+
+	void compileExceptions();
 	QNetworkProxy::ProxyType getProxyType(ProxyDefinition::ProtocolType protocol);
+	QList<QNetworkProxy> getSystemProxy(const QNetworkProxyQuery &query);
+	bool isException(const QString &host) const;
 
 private:
 	NetworkAutomaticProxy *m_automaticProxy;
 	ProxyDefinition m_definition;
 	QMap<int, QList<QNetworkProxy> > m_proxies;
+	QVector<QPair<QHostAddress, int> > m_exceptionSubnets;
+	QSet<QString> m_exceptionHosts;
+	QStringList m_exceptionPatterns;
+	QHash<QString, ProxyDecision> m_decisionsCache;
 };
 
 }
@@ -19,6 +19,7 @@
 
 #include "NotesManager.h"
 #include "Application.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
 
 namespace Otter
@@ -27,8 +28,7 @@ namespace Otter
 NotesManager* NotesManager::m_instance(nullptr);
 BookmarksModel* NotesManager::m_model(nullptr);
 
-NotesManager::NotesManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+NotesManager::NotesManager(QObject *parent) : QObject(parent)
 {
 }
 
@@ -37,58 +37,37 @@ void NotesManager::createInstance()
 	if (!m_instance)
 	{
 		m_instance = new NotesManager(QCoreApplication::instance());
-	}
-}
-
-void NotesManager::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_saveTimer)
-	{
-		killTimer(m_saveTimer);
 
-		m_saveTimer = 0;
-
-		if (m_model)
+		PersistenceManager::registerTarget(m_instance, [](bool isBlocking)
 		{
-			m_model->save(SessionsManager::getWritableDataPath(QLatin1String("notes.xbel")));
-		}
+			return (!m_model || m_model->flushJournal(isBlocking));
+		});
 	}
 }
 
 void NotesManager::scheduleSave()
 {
-	if (Application::isAboutToQuit())
-	{
-		if (m_saveTimer != 0)
-		{
-			killTimer(m_saveTimer);
-
-			m_saveTimer = 0;
-		}
-
-		if (m_model)
-		{
-			m_model->save(SessionsManager::getWritableDataPath(QLatin1String("notes.xbel")));
-		}
-	}
-	else if (m_saveTimer == 0)
-	{
-		m_saveTimer = startTimer(1000);
-	}
+	PersistenceManager::markAsDirty(this);
 }
 
 NotesManager* NotesManager::getInstance()
 {
+	createInstance();
+
 	return m_instance;
 }
 
 BookmarksModel* NotesManager::getModel()
 {
-	if (!m_model && m_instance)
+	createInstance();
+
+	if (!m_model)
 	{
 		m_model = new BookmarksModel(SessionsManager::getWritableDataPath(QLatin1String("notes.xbel")), BookmarksModel::NotesMode, m_instance);
 
 		connect(m_model, &BookmarksModel::modelModified, m_instance, &NotesManager::scheduleSave);
+
+		m_model->ensureLoaded();
 	}
 
 	return m_model;
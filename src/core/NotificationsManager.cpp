@@ -24,6 +24,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QSettings>
+#include <QtCore/QTimerEvent>
 #include <QtMultimedia/QSoundEffect>
 
 namespace Otter
@@ -31,6 +32,10 @@ namespace Otter
 
 NotificationsManager* NotificationsManager::m_instance(nullptr);
 QMap<int, QString> NotificationsManager::m_identifiers;
+QHash<int, NotificationsManager::EventDefinition> NotificationsManager::m_cachedDefinitions;
+QHash<int, QVector<QPointer<Notification> > > NotificationsManager::m_pendingNotifications;
+QHash<int, qint64> NotificationsManager::m_lastNotificationTimes;
+QHash<int, int> NotificationsManager::m_coalescingTimers;
 QVector<NotificationsManager::EventDefinition> NotificationsManager::m_definitions;
 int NotificationsManager::m_eventIdentifierEnumerator(0);
 
@@ -112,6 +117,85 @@ void NotificationsManager::createInstance()
 	}
 }
 
+void NotificationsManager::timerEvent(QTimerEvent *event)
+{
+	const int identifier(m_coalescingTimers.key(event->timerId(), -1));
+
+	if (identifier < 0)
+	{
+		return;
+	}
+
+	killTimer(event->timerId());
+
+	m_coalescingTimers.remove(identifier);
+
+	const QVector<QPointer<Notification> > pendingNotifications(m_pendingNotifications.take(identifier));
+	QVector<Notification*> notifications;
+	notifications.reserve(pendingNotifications.count());
+
+	for (int i = 0; i < pendingNotifications.count(); ++i)
+	{
+		if (pendingNotifications.at(i))
+		{
+			notifications.append(pendingNotifications.at(i).data());
+		}
+	}
+
+	if (notifications.isEmpty())
+	{
+		return;
+	}
+
+	Notification *notification(notifications.takeLast());
+
+	if (!notifications.isEmpty())
+	{
+		Notification::Message message(notification->getMessage());
+
+		if (!message.message.isEmpty())
+		{
+			message.message.append(QLatin1Char('\n'));
+		}
+
+		message.message.append(tr("%n more similar notification(s)", "", notifications.count()));
+
+		notification->setMessage(message);
+
+		for (int i = 0; i < notifications.count(); ++i)
+		{
+			notifications.at(i)->markAsIgnored();
+		}
+	}
+
+	m_lastNotificationTimes[identifier] = QDateTime::currentMSecsSinceEpoch();
+
+	Application::showNotification(notification);
+}
+
+void NotificationsManager::scheduleNotification(Notification *notification)
+{
+	const int identifier(notification->getMessage().event);
+	const int interval(getCoalescingInterval(identifier));
+	const qint64 currentTime(QDateTime::currentMSecsSinceEpoch());
+
+	if (interval <= 0 || (!m_coalescingTimers.contains(identifier) && (currentTime - m_lastNotificationTimes.value(identifier, 0)) >= interval))
+	{
+		m_lastNotificationTimes[identifier] = currentTime;
+
+		Application::showNotification(notification);
+
+		return;
+	}
+
+	m_pendingNotifications[identifier].append(notification);
+
+	if (!m_coalescingTimers.contains(identifier))
+	{
+		m_coalescingTimers[identifier] = m_instance->startTimer(interval);
+	}
+}
+
 Notification* NotificationsManager::createNotification(const Notification::Message &message, QObject *parent)
 {
 	Notification *notification(new Notification(message, Application::getInstance()));
@@ -154,7 +238,7 @@ Notification* NotificationsManager::createNotification(const Notification::Messa
 
 	if (definition.showNotification)
 	{
-		Application::showNotification(notification);
+		scheduleNotification(notification);
 	}
 
 	return notification;
@@ -177,6 +261,11 @@ NotificationsManager::EventDefinition NotificationsManager::getEventDefinition(i
 		return {};
 	}
 
+	if (m_cachedDefinitions.contains(identifier))
+	{
+		return m_cachedDefinitions[identifier];
+	}
+
 	const QSettings bundledSettings(SessionsManager::getReadableDataPath(QLatin1String("notifications.ini"), true), QSettings::IniFormat);
 	const QSettings localSettings(SessionsManager::getReadableDataPath(QLatin1String("notifications.ini")), QSettings::IniFormat);
 	const QSettings *settings(&localSettings);
@@ -192,6 +281,8 @@ NotificationsManager::EventDefinition NotificationsManager::getEventDefinition(i
 	definition.showAlert = settings->value(eventName + QLatin1String("/showAlert"), false).toBool();
 	definition.showNotification = settings->value(eventName + QLatin1String("/showNotification"), false).toBool();
 
+	m_cachedDefinitions[identifier] = definition;
+
 	return definition;
 }
 
@@ -208,6 +299,20 @@ QVector<NotificationsManager::EventDefinition> NotificationsManager::getEventDef
 	return definitions;
 }
 
+int NotificationsManager::getCoalescingInterval(int event)
+{
+	switch (event)
+	{
+		case FeedUpdatedEvent:
+		case TransferCompletedEvent:
+			return CoalescingInterval;
+		default:
+			break;
+	}
+
+	return 0;
+}
+
 int NotificationsManager::registerEvent(const QString &title, const QString &description)
 {
 	const int identifier(m_definitions.count());
@@ -222,4 +327,9 @@ int NotificationsManager::registerEvent(const QString &title, const QString &des
 	return identifier;
 }
 
+void NotificationsManager::reloadEventDefinitions()
+{
+	m_cachedDefinitions.clear();
+}
+
 }
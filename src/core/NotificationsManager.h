@@ -24,6 +24,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QPointer>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
 
@@ -175,13 +176,27 @@ public:
 	static EventDefinition getEventDefinition(int identifier);
 	static QVector<EventDefinition> getEventDefinitions();
 	static int registerEvent(const QString &title, const QString &description = {});
+	static void reloadEventDefinitions();
 
 protected:
+	enum CoalescingParameter
+	{
+		CoalescingInterval = 2000
+	};
+
 	explicit NotificationsManager(QObject *parent);
 
+	void timerEvent(QTimerEvent *event) override;
+	static void scheduleNotification(Notification *notification);
+	static int getCoalescingInterval(int event);
+
 private:
 	static NotificationsManager *m_instance;
 	static QMap<int, QString> m_identifiers;
+	static QHash<int, EventDefinition> m_cachedDefinitions;
+	static QHash<int, QVector<QPointer<Notification> > > m_pendingNotifications;
+	static QHash<int, qint64> m_lastNotificationTimes;
+	static QHash<int, int> m_coalescingTimers;
 	static QVector<EventDefinition> m_definitions;
 	static int m_eventIdentifierEnumerator;
 };
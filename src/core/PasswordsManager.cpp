@@ -44,6 +44,8 @@ void PasswordsManager::createInstance()
 
 void PasswordsManager::clearPasswords(const QString &host)
 {
+	createInstance();
+
 	if (m_backend)
 	{
 		m_backend->clearPasswords(host);
@@ -52,6 +54,8 @@ void PasswordsManager::clearPasswords(const QString &host)
 
 void PasswordsManager::clearPasswords(int period)
 {
+	createInstance();
+
 	if (m_backend)
 	{
 		m_backend->clearPasswords(period);
@@ -60,6 +64,8 @@ void PasswordsManager::clearPasswords(int period)
 
 void PasswordsManager::addPassword(const PasswordInformation &password)
 {
+	createInstance();
+
 	if (m_backend)
 	{
 		m_backend->addPassword(password);
@@ -68,6 +74,8 @@ void PasswordsManager::addPassword(const PasswordInformation &password)
 
 void PasswordsManager::removePassword(const PasswordsManager::PasswordInformation &password)
 {
+	createInstance();
+
 	if (m_backend)
 	{
 		m_backend->removePassword(password);
@@ -76,26 +84,36 @@ void PasswordsManager::removePassword(const PasswordsManager::PasswordInformatio
 
 PasswordsManager* PasswordsManager::getInstance()
 {
+	createInstance();
+
 	return m_instance;
 }
 
 QStringList PasswordsManager::getHosts()
 {
+	createInstance();
+
 	return (m_backend ? m_backend->getHosts() : QStringList());
 }
 
 QVector<PasswordsManager::PasswordInformation> PasswordsManager::getPasswords(const QUrl &url, PasswordTypes types)
 {
+	createInstance();
+
 	return (m_backend ? m_backend->getPasswords(url, types) : QVector<PasswordsManager::PasswordInformation>());
 }
 
 PasswordsManager::PasswordMatch PasswordsManager::hasPassword(const PasswordsManager::PasswordInformation &password)
 {
+	createInstance();
+
 	return (m_backend ? m_backend->hasPassword(password) : NoMatch);
 }
 
 bool PasswordsManager::hasPasswords(const QUrl &url, PasswordTypes types)
 {
+	createInstance();
+
 	return (m_backend ? m_backend->hasPasswords(url, types) : false);
 }
 
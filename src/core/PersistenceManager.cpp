@@ -0,0 +1,192 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PersistenceManager.h"
+#include "Application.h"
+#include "Tracer.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+PersistenceManager* PersistenceManager::m_instance(nullptr);
+QVector<PersistenceManager::Target> PersistenceManager::m_targets;
+
+PersistenceManager::PersistenceManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
+{
+}
+
+void PersistenceManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new PersistenceManager(QCoreApplication::instance());
+	}
+}
+
+void PersistenceManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		saveTargets(false);
+	}
+}
+
+void PersistenceManager::saveTargets(bool isBlocking)
+{
+	const Tracer::Span span("PersistenceManager::saveTargets", "persistence");
+	QVector<QObject*> objects;
+
+	for (int i = 0; i < m_targets.count(); ++i)
+	{
+		if (m_targets.at(i).isDirty)
+		{
+			m_targets[i].isDirty = false;
+
+			objects.append(m_targets.at(i).object);
+		}
+	}
+
+	for (int i = 0; i < objects.count(); ++i)
+	{
+		const int index(findTarget(objects.at(i)));
+
+		if (index < 0)
+		{
+			continue;
+		}
+
+		const std::function<bool(bool)> function(m_targets.at(index).function);
+
+		if (!function(isBlocking))
+		{
+			markAsDirty(objects.at(i));
+		}
+	}
+}
+
+void PersistenceManager::scheduleSave()
+{
+	createInstance();
+
+	if (m_instance->m_saveTimer == 0)
+	{
+		m_instance->m_saveTimer = m_instance->startTimer(SaveDelay);
+	}
+}
+
+void PersistenceManager::registerTarget(QObject *object, const std::function<bool(bool)> &function)
+{
+	if (!object || findTarget(object) >= 0)
+	{
+		return;
+	}
+
+	createInstance();
+
+	Target target;
+	target.object = object;
+	target.function = function;
+
+	m_targets.append(target);
+
+	connect(object, &QObject::destroyed, m_instance, [=]()
+	{
+		removeTarget(object);
+	});
+}
+
+void PersistenceManager::removeTarget(QObject *object)
+{
+	const int index(findTarget(object));
+
+	if (index >= 0)
+	{
+		m_targets.remove(index);
+	}
+}
+
+void PersistenceManager::markAsDirty(QObject *object)
+{
+	const int index(findTarget(object));
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	if (Application::isAboutToQuit())
+	{
+		const std::function<bool(bool)> function(m_targets.at(index).function);
+
+		function(true);
+
+		return;
+	}
+
+	m_targets[index].isDirty = true;
+
+	scheduleSave();
+}
+
+void PersistenceManager::flush()
+{
+	if (m_instance && m_instance->m_saveTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_saveTimer);
+
+		m_instance->m_saveTimer = 0;
+	}
+
+	saveTargets(true);
+}
+
+PersistenceManager* PersistenceManager::getInstance()
+{
+	return m_instance;
+}
+
+int PersistenceManager::findTarget(QObject *object)
+{
+	for (int i = 0; i < m_targets.count(); ++i)
+	{
+		if (m_targets.at(i).object == object)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool PersistenceManager::isDirty(QObject *object)
+{
+	const int index(findTarget(object));
+
+	return (index >= 0 && m_targets.at(index).isDirty);
+}
+
+}
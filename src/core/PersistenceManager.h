@@ -0,0 +1,73 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PERSISTENCEMANAGER_H
+#define OTTER_PERSISTENCEMANAGER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include <functional>
+
+namespace Otter
+{
+
+class PersistenceManager final : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance();
+	static void registerTarget(QObject *object, const std::function<bool(bool)> &function);
+	static void markAsDirty(QObject *object);
+	static void flush();
+	static PersistenceManager* getInstance();
+	static bool isDirty(QObject *object);
+
+protected:
+	enum SaveParameter
+	{
+		SaveDelay = 1000
+	};
+
+	struct Target final
+	{
+		QObject *object = nullptr;
+		std::function<bool(bool)> function = nullptr;
+		bool isDirty = false;
+	};
+
+	explicit PersistenceManager(QObject *parent = nullptr);
+
+	void timerEvent(QTimerEvent *event) override;
+	static void saveTargets(bool isBlocking);
+	static void scheduleSave();
+	static void removeTarget(QObject *object);
+	static int findTarget(QObject *object);
+
+private:
+	int m_saveTimer;
+
+	static PersistenceManager *m_instance;
+	static QVector<Target> m_targets;
+};
+
+}
+
+#endif
@@ -71,6 +71,11 @@ QString PlatformIntegration::getPlatformName() const
 	return {};
 }
 
+quint64 PlatformIntegration::getResidentMemorySize() const
+{
+	return 0;
+}
+
 bool PlatformIntegration::canShowNotifications() const
 {
 	return false;
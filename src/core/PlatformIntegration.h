@@ -45,6 +45,7 @@ public:
 	virtual QVector<ApplicationInformation> getApplicationsForMimeType(const QMimeType &mimeType) = 0;
 	virtual QString getPreferredPasswordsBackend() const;
 	virtual QString getPlatformName() const;
+	virtual quint64 getResidentMemorySize() const;
 	virtual bool canShowNotifications() const;
 	virtual bool canSetAsDefaultBrowser() const;
 	virtual bool isDefaultBrowser() const;
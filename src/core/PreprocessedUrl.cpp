@@ -0,0 +1,218 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PreprocessedUrl.h"
+
+#include <QtCore/QtAlgorithms>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+#define OTTER_PREPROCESSEDURL_SSE2
+#endif
+
+namespace Otter
+{
+
+PreprocessedUrl::PreprocessedUrl(const QString &url) : m_url(url),
+	m_lowerCaseUrl(url)
+{
+	const int length(url.length());
+
+	if (length == 0)
+	{
+		return;
+	}
+
+	const int wordsAmount((length + 63) / 64);
+
+	m_separators.fill(0, wordsAmount);
+	m_domainSeparators.fill(0, wordsAmount);
+	m_tokenCharacters.fill(0, wordsAmount);
+
+	ushort *lowerCaseData(reinterpret_cast<ushort*>(m_lowerCaseUrl.data()));
+	bool hasNonAsciiCharacters(false);
+	int position(0);
+
+#ifdef OTTER_PREPROCESSEDURL_SSE2
+	const __m128i zero(_mm_setzero_si128());
+	const __m128i nonAsciiMask(_mm_set1_epi16(static_cast<short>(0xFF80)));
+	const auto isEqual([](__m128i characters, char character)
+	{
+		return _mm_cmpeq_epi16(characters, _mm_set1_epi16(character));
+	});
+	const auto isInRange([](__m128i characters, char first, char last)
+	{
+		return _mm_and_si128(_mm_cmpgt_epi16(characters, _mm_set1_epi16(static_cast<short>(first - 1))), _mm_cmplt_epi16(characters, _mm_set1_epi16(static_cast<short>(last + 1))));
+	});
+	const auto createMask([&](__m128i matches)
+	{
+		return static_cast<quint64>(_mm_movemask_epi8(_mm_packs_epi16(matches, zero)) & 0xFF);
+	});
+
+	for (; (position + 8) <= length; position += 8)
+	{
+		const __m128i characters(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lowerCaseData + position)));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(characters, nonAsciiMask), zero)) != 0xFFFF)
+		{
+			hasNonAsciiCharacters = true;
+
+			for (int i = position; i < (position + 8); ++i)
+			{
+				classifyCharacter(i, url.at(i));
+			}
+
+			continue;
+		}
+
+		const __m128i lowerCaseCharacters(_mm_add_epi16(characters, _mm_and_si128(isInRange(characters, 'A', 'Z'), _mm_set1_epi16(0x20))));
+		const __m128i tokenCharacters(_mm_or_si128(_mm_or_si128(isInRange(lowerCaseCharacters, 'a', 'z'), isInRange(lowerCaseCharacters, '0', '9')), isEqual(lowerCaseCharacters, '%')));
+		const __m128i wordCharacters(_mm_or_si128(_mm_or_si128(tokenCharacters, isEqual(lowerCaseCharacters, '_')), _mm_or_si128(isEqual(lowerCaseCharacters, '-'), isEqual(lowerCaseCharacters, '.'))));
+		const __m128i domainSeparators(_mm_or_si128(_mm_or_si128(_mm_or_si128(isEqual(lowerCaseCharacters, ':'), isEqual(lowerCaseCharacters, '?')), _mm_or_si128(isEqual(lowerCaseCharacters, '&'), isEqual(lowerCaseCharacters, '/'))), isEqual(lowerCaseCharacters, '=')));
+		const int word(position >> 6);
+		const int shift(position & 63);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lowerCaseData + position), lowerCaseCharacters);
+
+		m_separators[word] |= ((~createMask(wordCharacters) & 0xFF) << shift);
+		m_domainSeparators[word] |= (createMask(domainSeparators) << shift);
+		m_tokenCharacters[word] |= (createMask(tokenCharacters) << shift);
+	}
+#endif
+
+	for (; position < length; ++position)
+	{
+		const QChar character(url.at(position));
+
+		if (character.unicode() > 0x7F)
+		{
+			hasNonAsciiCharacters = true;
+		}
+		else if (character.unicode() >= 'A' && character.unicode() <= 'Z')
+		{
+			lowerCaseData[position] = static_cast<ushort>(character.unicode() + 0x20);
+		}
+
+		classifyCharacter(position, character);
+	}
+
+	if (hasNonAsciiCharacters)
+	{
+		const QString lowerCaseUrl(url.toLower());
+
+		m_lowerCaseUrl = ((lowerCaseUrl.length() == length) ? lowerCaseUrl : url);
+	}
+}
+
+void PreprocessedUrl::classifyCharacter(int position, QChar character)
+{
+	const quint64 bit(static_cast<quint64>(1) << (position & 63));
+	const int word(position >> 6);
+
+	if (isSeparator(character))
+	{
+		m_separators[word] |= bit;
+	}
+
+	if (isDomainSeparator(character))
+	{
+		m_domainSeparators[word] |= bit;
+	}
+
+	if (isTokenCharacter(character))
+	{
+		m_tokenCharacters[word] |= bit;
+	}
+}
+
+const QString& PreprocessedUrl::getUrl() const
+{
+	return m_url;
+}
+
+const QString& PreprocessedUrl::getLowerCaseUrl() const
+{
+	return m_lowerCaseUrl;
+}
+
+int PreprocessedUrl::findBit(const QVector<quint64> &bitmap, int position, int limit, bool value)
+{
+	while (position < limit)
+	{
+		const int word(position >> 6);
+		const quint64 bits((value ? bitmap.at(word) : ~bitmap.at(word)) & (~static_cast<quint64>(0) << (position & 63)));
+
+		if (bits != 0)
+		{
+			return qMin(limit, ((word << 6) + static_cast<int>(qCountTrailingZeroBits(bits))));
+		}
+
+		position = ((word + 1) << 6);
+	}
+
+	return limit;
+}
+
+int PreprocessedUrl::findDomainSeparator(int position, int limit) const
+{
+	return findBit(m_domainSeparators, position, qMin(limit, m_url.length()), true);
+}
+
+int PreprocessedUrl::findTokenStart(int position) const
+{
+	return findBit(m_tokenCharacters, position, m_url.length(), true);
+}
+
+int PreprocessedUrl::findTokenEnd(int position) const
+{
+	return findBit(m_tokenCharacters, position, m_url.length(), false);
+}
+
+int PreprocessedUrl::getLength() const
+{
+	return m_url.length();
+}
+
+bool PreprocessedUrl::isSeparator(int position) const
+{
+	return ((m_separators.at(position >> 6) >> (position & 63)) & 1);
+}
+
+bool PreprocessedUrl::isTokenCharacter(int position) const
+{
+	return ((m_tokenCharacters.at(position >> 6) >> (position & 63)) & 1);
+}
+
+bool PreprocessedUrl::isSeparator(QChar character)
+{
+	return (!character.isDigit() && !character.isLetter() && character != QLatin1Char('_') && character != QLatin1Char('-') && character != QLatin1Char('.') && character != QLatin1Char('%'));
+}
+
+bool PreprocessedUrl::isDomainSeparator(QChar character)
+{
+	return (character == QLatin1Char(':') || character == QLatin1Char('?') || character == QLatin1Char('&') || character == QLatin1Char('/') || character == QLatin1Char('='));
+}
+
+bool PreprocessedUrl::isTokenCharacter(QChar character)
+{
+	return (character.isLetterOrNumber() || character == QLatin1Char('%'));
+}
+
+}
@@ -0,0 +1,60 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PREPROCESSEDURL_H
+#define OTTER_PREPROCESSEDURL_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class PreprocessedUrl final
+{
+public:
+	explicit PreprocessedUrl(const QString &url = {});
+
+	const QString& getUrl() const;
+	const QString& getLowerCaseUrl() const;
+	int findDomainSeparator(int position, int limit) const;
+	int findTokenStart(int position) const;
+	int findTokenEnd(int position) const;
+	int getLength() const;
+	bool isSeparator(int position) const;
+	bool isTokenCharacter(int position) const;
+	static bool isSeparator(QChar character);
+	static bool isDomainSeparator(QChar character);
+	static bool isTokenCharacter(QChar character);
+
+protected:
+	void classifyCharacter(int position, QChar character);
+	static int findBit(const QVector<quint64> &bitmap, int position, int limit, bool value);
+
+private:
+	QString m_url;
+	QString m_lowerCaseUrl;
+	QVector<quint64> m_separators;
+	QVector<quint64> m_domainSeparators;
+	QVector<quint64> m_tokenCharacters;
+};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PublicSuffixList.h"
+
+#include <QtCore/QUrl>
+#include <QtNetwork/QHostAddress>
+
+namespace Otter
+{
+
+QHash<QString, PublicSuffixList::DomainPositions> PublicSuffixList::m_cache;
+QReadWriteLock PublicSuffixList::m_cacheLock;
+
+PublicSuffixList::DomainPositions PublicSuffixList::getPositions(const QString &host)
+{
+	{
+		const QReadLocker locker(&m_cacheLock);
+		const QHash<QString, DomainPositions>::const_iterator iterator(m_cache.constFind(host));
+
+		if (iterator != m_cache.constEnd())
+		{
+			return iterator.value();
+		}
+	}
+
+	const DomainPositions positions(calculatePositions(host));
+	const QWriteLocker locker(&m_cacheLock);
+
+	if (m_cache.count() >= CacheLimit)
+	{
+		m_cache.clear();
+	}
+
+	m_cache.insert(host, positions);
+
+	return positions;
+}
+
+PublicSuffixList::DomainPositions PublicSuffixList::calculatePositions(const QString &host)
+{
+	DomainPositions positions;
+
+	if (host.isEmpty() || host.endsWith(QLatin1Char('.')) || !QHostAddress(host).isNull())
+	{
+		positions.publicSuffix = host.length();
+
+		return positions;
+	}
+
+	QUrl url;
+	url.setHost(host);
+
+	const QString topLevelDomain(url.topLevelDomain());
+	const int suffixLength(topLevelDomain.isEmpty() ? (host.length() - host.lastIndexOf(QLatin1Char('.')) - 1) : (topLevelDomain.length() - 1));
+
+	if (suffixLength >= host.length())
+	{
+		return positions;
+	}
+
+	positions.publicSuffix = (host.length() - suffixLength);
+	positions.registrableDomain = (host.lastIndexOf(QLatin1Char('.'), (positions.publicSuffix - 2)) + 1);
+
+	return positions;
+}
+
+QStringRef PublicSuffixList::getPublicSuffix(const QString &host)
+{
+	return host.midRef(getPositions(host).publicSuffix);
+}
+
+QStringRef PublicSuffixList::getRegistrableDomain(const QString &host)
+{
+	return host.midRef(getPositions(host).registrableDomain);
+}
+
+bool PublicSuffixList::isSameSite(const QString &firstHost, const QString &secondHost)
+{
+	if (firstHost.isEmpty() || secondHost.isEmpty())
+	{
+		return (firstHost.isEmpty() && secondHost.isEmpty());
+	}
+
+	return (getRegistrableDomain(firstHost).compare(getRegistrableDomain(secondHost), Qt::CaseInsensitive) == 0);
+}
+
+}
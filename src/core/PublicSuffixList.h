@@ -0,0 +1,59 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PUBLICSUFFIXLIST_H
+#define OTTER_PUBLICSUFFIXLIST_H
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QString>
+
+namespace Otter
+{
+
+class PublicSuffixList final
+{
+public:
+	static QStringRef getPublicSuffix(const QString &host);
+	static QStringRef getRegistrableDomain(const QString &host);
+	static bool isSameSite(const QString &firstHost, const QString &secondHost);
+
+protected:
+	enum CacheParameter
+	{
+		CacheLimit = 2048
+	};
+
+	struct DomainPositions final
+	{
+		int registrableDomain = 0;
+		int publicSuffix = 0;
+	};
+
+	static DomainPositions getPositions(const QString &host);
+	static DomainPositions calculatePositions(const QString &host);
+
+private:
+	static QHash<QString, DomainPositions> m_cache;
+	static QReadWriteLock m_cacheLock;
+};
+
+}
+
+#endif
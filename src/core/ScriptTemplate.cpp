@@ -0,0 +1,155 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ScriptTemplate.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+
+namespace Otter
+{
+
+QHash<QString, ScriptTemplate> ScriptTemplate::m_templates;
+
+ScriptTemplate::ScriptTemplate(const QString &source) : m_length(0),
+	m_isValid(!source.isEmpty())
+{
+	QMap<int, int> numbers;
+	QVector<int> placeholderNumbers;
+	int chunkStart(0);
+
+	for (int i = 0; i < source.length(); ++i)
+	{
+		if (source.at(i) != QLatin1Char('%') || (i + 1) >= source.length() || !source.at(i + 1).isDigit())
+		{
+			continue;
+		}
+
+		int end(i + 2);
+
+		if (end < source.length() && source.at(end).isDigit())
+		{
+			++end;
+		}
+
+		const int number(source.midRef(i + 1, (end - i - 1)).toInt());
+
+		if (number == 0)
+		{
+			continue;
+		}
+
+		Placeholder placeholder;
+		placeholder.text = source.mid(i, (end - i));
+
+		numbers[number] = 0;
+
+		m_chunks.append(source.mid(chunkStart, (i - chunkStart)));
+		m_placeholders.append(placeholder);
+
+		placeholderNumbers.append(number);
+
+		chunkStart = end;
+		i = (end - 1);
+	}
+
+	m_chunks.append(source.mid(chunkStart));
+
+	QMap<int, int>::iterator iterator;
+	int parameter(0);
+
+	for (iterator = numbers.begin(); iterator != numbers.end(); ++iterator)
+	{
+		iterator.value() = parameter;
+
+		++parameter;
+	}
+
+	for (int i = 0; i < m_placeholders.count(); ++i)
+	{
+		m_placeholders[i].parameter = numbers.value(placeholderNumbers.at(i));
+	}
+
+	for (int i = 0; i < m_chunks.count(); ++i)
+	{
+		m_length += m_chunks.at(i).length();
+	}
+}
+
+QString ScriptTemplate::createSource(const QStringList &parameters) const
+{
+	if (m_placeholders.isEmpty())
+	{
+		return m_chunks.value(0);
+	}
+
+	int length(m_length);
+
+	for (int i = 0; i < m_placeholders.count(); ++i)
+	{
+		const Placeholder &placeholder(m_placeholders.at(i));
+
+		length += ((placeholder.parameter < parameters.count()) ? parameters.at(placeholder.parameter).length() : placeholder.text.length());
+	}
+
+	QString source;
+	source.reserve(length);
+
+	for (int i = 0; i < m_placeholders.count(); ++i)
+	{
+		const Placeholder &placeholder(m_placeholders.at(i));
+
+		source.append(m_chunks.at(i));
+		source.append((placeholder.parameter < parameters.count()) ? parameters.at(placeholder.parameter) : placeholder.text);
+	}
+
+	source.append(m_chunks.last());
+
+	return source;
+}
+
+ScriptTemplate ScriptTemplate::getTemplate(const QString &path)
+{
+	if (m_templates.contains(path))
+	{
+		return m_templates[path];
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return ScriptTemplate();
+	}
+
+	const ScriptTemplate scriptTemplate(QString::fromLatin1(file.readAll()));
+
+	file.close();
+
+	m_templates[path] = scriptTemplate;
+
+	return scriptTemplate;
+}
+
+bool ScriptTemplate::isValid() const
+{
+	return m_isValid;
+}
+
+}
@@ -0,0 +1,57 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SCRIPTTEMPLATE_H
+#define OTTER_SCRIPTTEMPLATE_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class ScriptTemplate final
+{
+public:
+	explicit ScriptTemplate(const QString &source = {});
+
+	QString createSource(const QStringList &parameters = {}) const;
+	static ScriptTemplate getTemplate(const QString &path);
+	bool isValid() const;
+
+protected:
+	struct Placeholder final
+	{
+		QString text;
+		int parameter = 0;
+	};
+
+private:
+	QStringList m_chunks;
+	QVector<Placeholder> m_placeholders;
+	int m_length;
+	bool m_isValid;
+
+	static QHash<QString, ScriptTemplate> m_templates;
+};
+
+}
+
+#endif
@@ -23,8 +23,11 @@
 #include "SettingsManager.h"
 #include "ThemesManager.h"
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
 #include <QtNetwork/QNetworkRequest>
@@ -37,6 +40,8 @@ QStandardItemModel* SearchEnginesManager::m_searchEnginesModel(nullptr);
 QStringList SearchEnginesManager::m_searchEnginesOrder;
 QStringList SearchEnginesManager::m_searchKeywords;
 QHash<QString, SearchEnginesManager::SearchEngineDefinition> SearchEnginesManager::m_searchEngines;
+QHash<QString, SearchEnginesManager::SearchEngineFile> SearchEnginesManager::m_searchEngineFiles;
+QHash<QString, QString> SearchEnginesManager::m_keywords;
 bool SearchEnginesManager::m_isInitialized(false);
 
 SearchEnginesManager::SearchEnginesManager(QObject *parent) : QObject(parent)
@@ -71,6 +76,11 @@ void SearchEnginesManager::ensureInitialized()
 
 void SearchEnginesManager::loadSearchEngines()
 {
+	if (m_searchEngineFiles.isEmpty())
+	{
+		loadIndex();
+	}
+
 	m_searchEnginesOrder = SettingsManager::getOption(SettingsManager::Search_SearchEnginesOrderOption).toStringList();
 
 	m_searchEngines.clear();
@@ -79,41 +89,187 @@ void SearchEnginesManager::loadSearchEngines()
 	m_searchKeywords.clear();
 	m_searchKeywords.reserve(m_searchEnginesOrder.count());
 
+	m_keywords.clear();
+	m_keywords.reserve(m_searchEnginesOrder.count());
+
 	const QStringList searchEnginesOrder(m_searchEnginesOrder);
+	QHash<QString, SearchEngineFile> searchEngineFiles;
+	searchEngineFiles.reserve(searchEnginesOrder.count());
+
+	bool needsIndexUpdate(false);
 
 	for (int i = 0; i < searchEnginesOrder.count(); ++i)
 	{
-		QFile file(SessionsManager::getReadableDataPath(QLatin1String("searchEngines/") + searchEnginesOrder.at(i) + QLatin1String(".xml")));
+		const QString identifier(searchEnginesOrder.at(i));
+		const QString path(SessionsManager::getReadableDataPath(QLatin1String("searchEngines/") + identifier + QLatin1String(".xml")));
+		const QFileInfo fileInformation(path);
+		SearchEngineFile searchEngineFile(m_searchEngineFiles.value(identifier));
 
-		if (!file.open(QIODevice::ReadOnly))
+		if (searchEngineFile.path != path || searchEngineFile.lastModified != fileInformation.lastModified() || searchEngineFile.size != fileInformation.size())
 		{
-			m_searchEnginesOrder.removeAll(searchEnginesOrder.at(i));
+			QFile file(path);
 
-			continue;
+			if (!file.open(QIODevice::ReadOnly))
+			{
+				m_searchEnginesOrder.removeAll(identifier);
+
+				continue;
+			}
+
+			searchEngineFile.definition = loadSearchEngine(&file, identifier, false);
+			searchEngineFile.path = path;
+			searchEngineFile.lastModified = fileInformation.lastModified();
+			searchEngineFile.size = fileInformation.size();
+
+			file.close();
+
+			needsIndexUpdate = true;
 		}
 
-		const SearchEngineDefinition searchEngine(loadSearchEngine(&file, searchEnginesOrder.at(i), true));
+		searchEngineFiles[identifier] = searchEngineFile;
 
-		file.close();
+		SearchEngineDefinition searchEngine(searchEngineFile.definition);
 
-		if (searchEngine.isValid())
+		if (!searchEngine.isValid())
 		{
-			m_searchEngines[searchEnginesOrder.at(i)] = searchEngine;
+			m_searchEnginesOrder.removeAll(identifier);
+
+			continue;
 		}
-		else
+
+		if (!searchEngine.keyword.isEmpty())
 		{
-			m_searchEnginesOrder.removeAll(searchEnginesOrder.at(i));
+			if (m_keywords.contains(searchEngine.keyword))
+			{
+				searchEngine.keyword.clear();
+			}
+			else
+			{
+				m_keywords[searchEngine.keyword] = identifier;
+				m_searchKeywords.append(searchEngine.keyword);
+			}
 		}
+
+		m_searchEngines[identifier] = searchEngine;
 	}
 
 	m_searchEngines.squeeze();
 
+	if (needsIndexUpdate || searchEngineFiles.count() != m_searchEngineFiles.count())
+	{
+		m_searchEngineFiles = searchEngineFiles;
+
+		saveIndex();
+	}
+
 	emit m_instance->searchEnginesModified();
 
 	updateSearchEnginesModel();
 	updateSearchEnginesOptions();
 }
 
+void SearchEnginesManager::loadIndex()
+{
+	const QString path(getIndexPath());
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+	quint32 amount(0);
+
+	stream >> magicNumber >> formatVersion >> amount;
+
+	if (stream.status() != QDataStream::Ok || magicNumber != IndexMagicNumber || formatVersion != IndexFormatVersion)
+	{
+		return;
+	}
+
+	QHash<QString, SearchEngineFile> searchEngineFiles;
+	searchEngineFiles.reserve(static_cast<int>(qMin(amount, 1000u)));
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		SearchEngineFile searchEngineFile;
+		SearchEngineDefinition &searchEngine(searchEngineFile.definition);
+		QList<QPair<QString, QString> > resultsParameters;
+		QList<QPair<QString, QString> > suggestionsParameters;
+
+		stream >> searchEngineFile.path >> searchEngineFile.lastModified >> searchEngineFile.size;
+		stream >> searchEngine.identifier >> searchEngine.title >> searchEngine.description >> searchEngine.keyword >> searchEngine.encoding >> searchEngine.formUrl >> searchEngine.iconUrl >> searchEngine.selfUrl >> searchEngine.icon;
+		stream >> searchEngine.resultsUrl.url >> searchEngine.resultsUrl.enctype >> searchEngine.resultsUrl.method >> resultsParameters;
+		stream >> searchEngine.suggestionsUrl.url >> searchEngine.suggestionsUrl.enctype >> searchEngine.suggestionsUrl.method >> suggestionsParameters;
+
+		searchEngine.resultsUrl.parameters.setQueryItems(resultsParameters);
+		searchEngine.suggestionsUrl.parameters.setQueryItems(suggestionsParameters);
+
+		searchEngineFiles[searchEngine.identifier] = searchEngineFile;
+	}
+
+	if (stream.status() == QDataStream::Ok)
+	{
+		m_searchEngineFiles = searchEngineFiles;
+	}
+}
+
+void SearchEnginesManager::saveIndex()
+{
+	const QString path(getIndexPath());
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(IndexMagicNumber) << static_cast<quint32>(IndexFormatVersion) << static_cast<quint32>(m_searchEngineFiles.count());
+
+	QHash<QString, SearchEngineFile>::const_iterator iterator;
+
+	for (iterator = m_searchEngineFiles.constBegin(); iterator != m_searchEngineFiles.constEnd(); ++iterator)
+	{
+		const SearchEngineFile &searchEngineFile(iterator.value());
+		const SearchEngineDefinition &searchEngine(searchEngineFile.definition);
+
+		stream << searchEngineFile.path << searchEngineFile.lastModified << searchEngineFile.size;
+		stream << iterator.key() << searchEngine.title << searchEngine.description << searchEngine.keyword << searchEngine.encoding << searchEngine.formUrl << searchEngine.iconUrl << searchEngine.selfUrl << searchEngine.icon;
+		stream << searchEngine.resultsUrl.url << searchEngine.resultsUrl.enctype << searchEngine.resultsUrl.method << searchEngine.resultsUrl.parameters.queryItems();
+		stream << searchEngine.suggestionsUrl.url << searchEngine.suggestionsUrl.enctype << searchEngine.suggestionsUrl.method << searchEngine.suggestionsUrl.parameters.queryItems();
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+
+		return;
+	}
+
+	file.commit();
+}
+
 void SearchEnginesManager::updateSearchEnginesModel()
 {
 	if (!m_searchEnginesModel)
@@ -342,18 +498,9 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::loadSearchEng
 			{
 				const QString keyword(reader.readElementText());
 
-				if (!keyword.isEmpty())
+				if (!keyword.isEmpty() && (!checkKeyword || !m_keywords.contains(keyword)))
 				{
-					if (!m_searchKeywords.contains(keyword))
-					{
-						searchEngine.keyword = keyword;
-
-						m_searchKeywords.append(keyword);
-					}
-					else if (!checkKeyword)
-					{
-						searchEngine.keyword = keyword;
-					}
+					searchEngine.keyword = keyword;
 				}
 			}
 			else if (reader.name() == QLatin1String("ShortName"))
@@ -391,6 +538,13 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::loadSearchEng
 	return searchEngine;
 }
 
+QString SearchEnginesManager::getIndexPath()
+{
+	const QString cachePath(SessionsManager::getCachePath());
+
+	return (cachePath.isEmpty() ? QString() : QDir::toNativeSeparators(cachePath + QLatin1String("/searchEngines.dat")));
+}
+
 SearchEnginesManager* SearchEnginesManager::getInstance()
 {
 	return m_instance;
@@ -416,20 +570,9 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::getSearchEngi
 
 	if (byKeyword)
 	{
-		if (!identifier.isEmpty())
-		{
-			QHash<QString, SearchEngineDefinition>::iterator iterator;
-
-			for (iterator = m_searchEngines.begin(); iterator != m_searchEngines.end(); ++iterator)
-			{
-				if (iterator.value().keyword == identifier)
-				{
-					return iterator.value();
-				}
-			}
-		}
+		const QHash<QString, QString>::const_iterator iterator(m_keywords.constFind(identifier));
 
-		return {};
+		return ((identifier.isEmpty() || iterator == m_keywords.constEnd()) ? SearchEngineDefinition() : m_searchEngines.value(iterator.value()));
 	}
 
 	if (identifier.isEmpty())
@@ -448,6 +591,12 @@ SearchEnginesManager::SearchEngineDefinition SearchEnginesManager::getSearchEngi
 			if (searchEngine.isValid())
 			{
 				m_searchEngines[identifier] = searchEngine;
+
+				if (!searchEngine.keyword.isEmpty())
+				{
+					m_keywords[searchEngine.keyword] = identifier;
+					m_searchKeywords.append(searchEngine.keyword);
+				}
 			}
 
 			file.close();
@@ -23,6 +23,7 @@
 #include "Job.h"
 #include "Utils.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QUrlQuery>
 #include <QtGui/QIcon>
 #include <QtGui/QStandardItemModel>
@@ -103,11 +104,28 @@ public:
 	static bool saveSearchEngine(const SearchEngineDefinition &searchEngine);
 
 protected:
+	enum IndexFormat : quint32
+	{
+		IndexMagicNumber = 0x4F534549,
+		IndexFormatVersion = 1
+	};
+
+	struct SearchEngineFile final
+	{
+		SearchEngineDefinition definition;
+		QString path;
+		QDateTime lastModified;
+		qint64 size = 0;
+	};
+
 	explicit SearchEnginesManager(QObject *parent);
 
 	static void ensureInitialized();
+	static void loadIndex();
+	static void saveIndex();
 	static void updateSearchEnginesModel();
 	static void updateSearchEnginesOptions();
+	static QString getIndexPath();
 
 private:
 	static SearchEnginesManager *m_instance;
@@ -115,6 +133,8 @@ private:
 	static QStringList m_searchEnginesOrder;
 	static QStringList m_searchKeywords;
 	static QHash<QString, SearchEngineDefinition> m_searchEngines;
+	static QHash<QString, SearchEngineFile> m_searchEngineFiles;
+	static QHash<QString, QString> m_keywords;
 	static bool m_isInitialized;
 
 signals:
@@ -25,17 +25,34 @@
 
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
+QCache<QPair<QString, QString>, QVector<SearchSuggester::SearchSuggestion> > SearchSuggester::m_cache(CacheLimit);
+SearchSuggester::RequestsStatistics SearchSuggester::m_statistics;
+
 SearchSuggester::SearchSuggester(const QString &searchEngine, QObject *parent) : QObject(parent),
 	m_networkReply(nullptr),
 	m_model(nullptr),
-	m_searchEngine(searchEngine)
+	m_searchEngine(searchEngine),
+	m_requestTimer(0)
 {
 }
 
+void SearchSuggester::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_requestTimer)
+	{
+		killTimer(m_requestTimer);
+
+		m_requestTimer = 0;
+
+		sendRequest();
+	}
+}
+
 void SearchSuggester::setSearchEngine(const QString &searchEngine)
 {
 	const QString query(m_query);
@@ -56,13 +73,78 @@ void SearchSuggester::setQuery(const QString &query)
 	m_query = query;
 	m_suggestions.clear();
 
-	if (m_networkReply)
+	abortRequest();
+
+	if (m_requestTimer != 0)
 	{
-		m_networkReply->abort();
-		m_networkReply->deleteLater();
-		m_networkReply = nullptr;
+		killTimer(m_requestTimer);
+
+		m_requestTimer = 0;
+	}
+
+	if (query.isEmpty())
+	{
+		return;
+	}
+
+	const QVector<SearchSuggestion> *cachedSuggestions(m_cache.object({m_searchEngine, query}));
+
+	if (cachedSuggestions)
+	{
+		++m_statistics.cached;
+
+		setSuggestions(*cachedSuggestions);
+
+		return;
+	}
+
+	for (int i = (query.length() - 1); i > 0; --i)
+	{
+		const QVector<SearchSuggestion> *prefixSuggestions(m_cache.object({m_searchEngine, query.left(i)}));
+
+		if (prefixSuggestions)
+		{
+			QVector<SearchSuggestion> suggestions;
+
+			for (int j = 0; j < prefixSuggestions->count(); ++j)
+			{
+				if (prefixSuggestions->at(j).completion.startsWith(query, Qt::CaseInsensitive))
+				{
+					suggestions.append(prefixSuggestions->at(j));
+				}
+			}
+
+			if (!suggestions.isEmpty())
+			{
+				setSuggestions(suggestions);
+			}
+
+			break;
+		}
 	}
 
+	m_requestTimer = startTimer(RequestDelay);
+}
+
+void SearchSuggester::setSuggestions(const QVector<SearchSuggestion> &suggestions)
+{
+	m_suggestions = suggestions;
+
+	if (m_model)
+	{
+		m_model->clear();
+
+		for (int i = 0; i < m_suggestions.count(); ++i)
+		{
+			m_model->appendRow(new QStandardItem(m_suggestions.at(i).completion));
+		}
+	}
+
+	emit suggestionsChanged(m_suggestions);
+}
+
+void SearchSuggester::sendRequest()
+{
 	const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(m_searchEngine));
 
 	if (!searchEngine.isValid() || searchEngine.suggestionsUrl.url.isEmpty())
@@ -70,7 +152,7 @@ void SearchSuggester::setQuery(const QString &query)
 		return;
 	}
 
-	SearchEnginesManager::SearchQuery searchQuery(SearchEnginesManager::setupQuery(query, searchEngine.suggestionsUrl));
+	SearchEnginesManager::SearchQuery searchQuery(SearchEnginesManager::setupQuery(m_query, searchEngine.suggestionsUrl));
 	searchQuery.request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
 
 	if (searchQuery.method == QNetworkAccessManager::PostOperation)
@@ -82,6 +164,8 @@ void SearchSuggester::setQuery(const QString &query)
 		m_networkReply = NetworkManagerFactory::getNetworkManager()->get(searchQuery.request);
 	}
 
+	++m_statistics.issued;
+
 	connect(m_networkReply, &QNetworkReply::finished, this, [&]()
 	{
 		if (!m_networkReply)
@@ -89,11 +173,6 @@ void SearchSuggester::setQuery(const QString &query)
 			return;
 		}
 
-		if (m_model)
-		{
-			m_model->clear();
-		}
-
 		m_networkReply->deleteLater();
 
 		if (m_networkReply->size() <= 0)
@@ -105,13 +184,15 @@ void SearchSuggester::setQuery(const QString &query)
 
 		const QJsonDocument document(QJsonDocument::fromJson(m_networkReply->readAll()));
 
+		m_networkReply = nullptr;
+
 		if (!document.isEmpty() && document.isArray() && document.array().count() > 1 && document.array().at(0).toString() == m_query)
 		{
 			const QJsonArray completionsArray(document.array().at(1).toArray());
 			const QJsonArray descriptionsArray(document.array().at(2).toArray());
 			const QJsonArray urlsArray(document.array().at(3).toArray());
-
-			m_suggestions.reserve(completionsArray.count());
+			QVector<SearchSuggestion> suggestions;
+			suggestions.reserve(completionsArray.count());
 
 			for (int i = 0; i < completionsArray.count(); ++i)
 			{
@@ -120,19 +201,27 @@ void SearchSuggester::setQuery(const QString &query)
 				suggestion.description = descriptionsArray.at(i).toString();
 				suggestion.url = urlsArray.at(i).toString();
 
-				m_suggestions.append(suggestion);
-
-				if (m_model)
-				{
-					m_model->appendRow(new QStandardItem(suggestion.completion));
-				}
+				suggestions.append(suggestion);
 			}
 
-			emit suggestionsChanged(m_suggestions);
+			m_cache.insert({m_searchEngine, m_query}, new QVector<SearchSuggestion>(suggestions));
+
+			setSuggestions(suggestions);
 		}
+	});
+}
 
+void SearchSuggester::abortRequest()
+{
+	if (m_networkReply)
+	{
+		++m_statistics.aborted;
+
+		m_networkReply->disconnect(this);
+		m_networkReply->abort();
+		m_networkReply->deleteLater();
 		m_networkReply = nullptr;
-	});
+	}
 }
 
 QStandardItemModel* SearchSuggester::getModel()
@@ -155,4 +244,9 @@ QVector<SearchSuggester::SearchSuggestion> SearchSuggester::getSuggestions() con
 	return m_suggestions;
 }
 
+SearchSuggester::RequestsStatistics SearchSuggester::getRequestsStatistics()
+{
+	return m_statistics;
+}
+
 }
@@ -21,6 +21,7 @@
 #ifndef OTTER_SEARCHSUGGESTER_H
 #define OTTER_SEARCHSUGGESTER_H
 
+#include <QtCore/QCache>
 #include <QtCore/QObject>
 #include <QtGui/QStandardItemModel>
 #include <QtNetwork/QNetworkReply>
@@ -40,21 +41,45 @@ public:
 		QString url;
 	};
 
+	struct RequestsStatistics final
+	{
+		quint64 issued = 0;
+		quint64 aborted = 0;
+		quint64 cached = 0;
+	};
+
 	explicit SearchSuggester(const QString &searchEngine, QObject *parent = nullptr);
 
 	QStandardItemModel* getModel();
 	QVector<SearchSuggestion> getSuggestions() const;
+	static RequestsStatistics getRequestsStatistics();
 
 public slots:
 	void setSearchEngine(const QString &searchEngine);
 	void setQuery(const QString &query);
 
+protected:
+	enum SuggestionsParameter
+	{
+		RequestDelay = 150,
+		CacheLimit = 200
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void sendRequest();
+	void abortRequest();
+	void setSuggestions(const QVector<SearchSuggestion> &suggestions);
+
 private:
 	QNetworkReply *m_networkReply;
 	QStandardItemModel *m_model;
 	QString m_searchEngine;
 	QString m_query;
 	QVector<SearchSuggestion> m_suggestions;
+	int m_requestTimer;
+
+	static QCache<QPair<QString, QString>, QVector<SearchSuggestion> > m_cache;
+	static RequestsStatistics m_statistics;
 
 signals:
 	void suggestionsChanged(const QVector<SearchSuggester::SearchSuggestion> &suggestions);
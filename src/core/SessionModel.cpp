@@ -24,6 +24,8 @@
 #include "../ui/MainWindow.h"
 #include "../ui/Window.h"
 
+#include <QtCore/QTimerEvent>
+
 namespace Otter
 {
 
@@ -87,7 +89,9 @@ QVariant SessionItem::data(int role) const
 }
 
 MainWindowSessionItem::MainWindowSessionItem(MainWindow *mainWindow) : SessionItem(),
-	m_mainWindow(mainWindow)
+	m_mainWindow(mainWindow),
+	m_activeWindowIdentifier(0),
+	m_updateTimer(0)
 {
 	for (int i = 0; i < mainWindow->getWindowCount(); ++i)
 	{
@@ -99,12 +103,82 @@ MainWindowSessionItem::MainWindowSessionItem(MainWindow *mainWindow) : SessionIt
 		}
 	}
 
+	const Window *activeWindow(mainWindow->getActiveWindow());
+
+	if (activeWindow)
+	{
+		m_activeWindowIdentifier = activeWindow->getIdentifier();
+	}
+
 	connect(mainWindow, &MainWindow::titleChanged, this, &MainWindowSessionItem::notifyMainWindowModified);
-	connect(mainWindow, &MainWindow::activeWindowChanged, this, &MainWindowSessionItem::notifyMainWindowModified);
+	connect(mainWindow, &MainWindow::activeWindowChanged, this, &MainWindowSessionItem::handleActiveWindowChanged);
 	connect(mainWindow, &MainWindow::windowAdded, this, &MainWindowSessionItem::handleWindowAdded);
 	connect(mainWindow, &MainWindow::windowRemoved, this, &MainWindowSessionItem::handleWindowRemoved);
 }
 
+void MainWindowSessionItem::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_updateTimer)
+	{
+		QObject::timerEvent(event);
+
+		return;
+	}
+
+	killTimer(m_updateTimer);
+
+	m_updateTimer = 0;
+
+	const QHash<quint64, QVector<int> > pendingRoles(m_pendingRoles);
+
+	m_pendingRoles.clear();
+
+	QStandardItemModel *itemModel(model());
+
+	if (!itemModel || pendingRoles.isEmpty())
+	{
+		return;
+	}
+
+	if (pendingRoles.contains(0))
+	{
+		const QModelIndex itemIndex(index());
+
+		emit itemModel->dataChanged(itemIndex, itemIndex, pendingRoles.value(0));
+	}
+
+	for (int i = 0; i < rowCount(); ++i)
+	{
+		QStandardItem *item(child(i, 0));
+		const quint64 identifier(ItemModel::getItemData(item, SessionModel::IdentifierRole).toULongLong());
+
+		if (identifier > 0 && pendingRoles.contains(identifier))
+		{
+			const QModelIndex itemIndex(item->index());
+
+			emit itemModel->dataChanged(itemIndex, itemIndex, pendingRoles.value(identifier));
+		}
+	}
+}
+
+void MainWindowSessionItem::scheduleUpdate(quint64 identifier, const QVector<int> &roles)
+{
+	QVector<int> &pendingRoles(m_pendingRoles[identifier]);
+
+	for (int i = 0; i < roles.count(); ++i)
+	{
+		if (!pendingRoles.contains(roles.at(i)))
+		{
+			pendingRoles.append(roles.at(i));
+		}
+	}
+
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(UpdateInterval);
+	}
+}
+
 void MainWindowSessionItem::handleWindowAdded(quint64 identifier)
 {
 	for (int i = 0; i < rowCount(); ++i)
@@ -115,25 +189,81 @@ void MainWindowSessionItem::handleWindowAdded(quint64 identifier)
 		}
 	}
 
-	insertRow(m_mainWindow->getWindowIndex(identifier), new WindowSessionItem(m_mainWindow->getWindowByIdentifier(identifier)));
+	Window *window(m_mainWindow->getWindowByIdentifier(identifier));
+
+	insertRow(m_mainWindow->getWindowIndex(identifier), new WindowSessionItem(window));
+
+	if (!window)
+	{
+		return;
+	}
+
+	connect(window, &Window::titleChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::TitleRole, Qt::ToolTipRole});
+	});
+	connect(window, &Window::urlChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::UrlRole});
+	});
+	connect(window, &Window::iconChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::IconRole});
+	});
+	connect(window, &Window::loadingStateChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::IsAudibleRole, SessionModel::IsAudioMutedRole, SessionModel::IsDeferredRole});
+	});
+	connect(window, &Window::zoomChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::ZoomRole});
+	});
+	connect(window, &Window::isPinnedChanged, this, [=]()
+	{
+		scheduleUpdate(identifier, {SessionModel::IsPinnedRole});
+	});
 }
 
 void MainWindowSessionItem::handleWindowRemoved(quint64 identifier)
 {
 	for (int i = 0; i < rowCount(); ++i)
 	{
-		if (ItemModel::getItemData(child(i, 0), SessionModel::IdentifierRole).toULongLong() == identifier)
+		SessionItem *item(static_cast<SessionItem*>(child(i, 0)));
+
+		if (ItemModel::getItemData(item, SessionModel::IdentifierRole).toULongLong() == identifier)
 		{
+			Window *window(item->getActiveWindow());
+
+			if (window)
+			{
+				window->disconnect(this);
+			}
+
 			removeRow(i);
 
 			break;
 		}
 	}
+
+	m_pendingRoles.remove(identifier);
+}
+
+void MainWindowSessionItem::handleActiveWindowChanged(quint64 identifier)
+{
+	if (m_activeWindowIdentifier > 0)
+	{
+		scheduleUpdate(m_activeWindowIdentifier, {SessionModel::IsActiveRole, SessionModel::LastActivityRole});
+	}
+
+	m_activeWindowIdentifier = identifier;
+
+	scheduleUpdate(identifier, {SessionModel::IsActiveRole, SessionModel::LastActivityRole});
+	scheduleUpdate(0, {SessionModel::TitleRole, SessionModel::UrlRole, SessionModel::IndexRole, Qt::ToolTipRole});
 }
 
 void MainWindowSessionItem::notifyMainWindowModified()
 {
-	emitDataChanged();
+	scheduleUpdate(0, {SessionModel::TitleRole, SessionModel::UrlRole, Qt::ToolTipRole});
 }
 
 Window* MainWindowSessionItem::getActiveWindow() const
@@ -290,8 +420,6 @@ void SessionModel::handleMainWindowAdded(MainWindow *mainWindow)
 	m_rootItem->appendRow(item);
 
 	m_mainWindowItems[mainWindow] = item;
-
-	connect(mainWindow, &MainWindow::activeWindowChanged, this, &SessionModel::modelModified);
 }
 
 void SessionModel::handleMainWindowRemoved(MainWindow *mainWindow)
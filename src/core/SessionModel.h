@@ -21,6 +21,7 @@
 #define OTTER_SESSIONMODEL_H
 
 #include <QtCore/QPointer>
+#include <QtCore/QVector>
 #include <QtGui/QStandardItemModel>
 
 namespace Otter
@@ -51,15 +52,27 @@ public:
 	QVariant data(int role) const override;
 
 protected:
+	enum UpdateParameter
+	{
+		UpdateInterval = 16
+	};
+
 	explicit MainWindowSessionItem(MainWindow *mainWindow);
 
+	void timerEvent(QTimerEvent *event) override;
+	void scheduleUpdate(quint64 identifier, const QVector<int> &roles);
+
 protected slots:
 	void handleWindowAdded(quint64 identifier);
 	void handleWindowRemoved(quint64 identifier);
+	void handleActiveWindowChanged(quint64 identifier);
 	void notifyMainWindowModified();
 
 private:
 	QPointer<MainWindow> m_mainWindow;
+	QHash<quint64, QVector<int> > m_pendingRoles;
+	quint64 m_activeWindowIdentifier;
+	int m_updateTimer;
 
 friend class SessionModel;
 };
@@ -20,14 +20,20 @@
 
 #include "SessionsManager.h"
 #include "Application.h"
+#include "ClosedWindowsStorage.h"
 #include "JsonSettings.h"
+#include "JsonWriter.h"
+#include "MetricsExporter.h"
 #include "SessionModel.h"
+#include "Tracer.h"
 #include "../ui/MainWindow.h"
 #include "../ui/Window.h"
 
 #include <QtCore/QDir>
-#include <QtCore/QJsonArray>
-#include <QtCore/QJsonObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace Otter
 {
@@ -38,13 +44,20 @@ Session::Session(QObject *parent) : QObject(parent)
 
 SessionsManager* SessionsManager::m_instance(nullptr);
 SessionModel* SessionsManager::m_model(nullptr);
+QFutureWatcher<bool>* SessionsManager::m_savingWatcher(nullptr);
 QString SessionsManager::m_sessionPath;
 QString SessionsManager::m_sessionTitle;
 QString SessionsManager::m_cachePath;
 QString SessionsManager::m_profilePath;
 QHash<QString, Session::Identity> SessionsManager::m_identities;
+QHash<Window*, QUrl> SessionsManager::m_windowUrls;
+QMultiHash<QUrl, Window*> SessionsManager::m_openUrls;
 QVector<Session::MainWindow> SessionsManager::m_closedWindows;
+QVector<quint64> SessionsManager::m_loggedWindows;
+QSet<quint64> SessionsManager::m_modifiedWindows;
+int SessionsManager::m_sessionLogRecordsAmount(0);
 bool SessionsManager::m_isDirty(false);
+bool SessionsManager::m_needsCompaction(true);
 bool SessionsManager::m_isPrivate(false);
 bool SessionsManager::m_isReadOnly(false);
 
@@ -65,7 +78,7 @@ void SessionsManager::timerEvent(QTimerEvent *event)
 
 		if (!m_isPrivate)
 		{
-			saveSession({}, {}, nullptr, false);
+			writeSessionLog();
 		}
 	}
 }
@@ -104,13 +117,15 @@ void SessionsManager::storeClosedWindow(MainWindow *mainWindow)
 		return;
 	}
 
-	const Session::MainWindow session(mainWindow->getSession());
+	Session::MainWindow session(mainWindow->getSession());
 
 	if (session.windows.isEmpty())
 	{
 		return;
 	}
 
+	ClosedWindowsStorage::storeHistories(session);
+
 	const int limit(SettingsManager::getOption(SettingsManager::History_ClosedTabsLimitAmountOption).toInt());
 
 	m_closedWindows.prepend(session);
@@ -124,9 +139,31 @@ void SessionsManager::storeClosedWindow(MainWindow *mainWindow)
 	emit m_instance->closedWindowsChanged();
 }
 
-void SessionsManager::markSessionAsModified()
+void SessionsManager::markSessionAsModified(QObject *source)
 {
-	if (!m_isPrivate && !m_isDirty && m_sessionPath == QLatin1String("default"))
+	if (m_isPrivate || m_sessionPath != QLatin1String("default"))
+	{
+		return;
+	}
+
+	MainWindow *mainWindow(nullptr);
+
+	while (source && !mainWindow)
+	{
+		mainWindow = qobject_cast<MainWindow*>(source);
+		source = source->parent();
+	}
+
+	if (mainWindow)
+	{
+		m_modifiedWindows.insert(mainWindow->getIdentifier());
+	}
+	else
+	{
+		m_needsCompaction = true;
+	}
+
+	if (!m_isDirty)
 	{
 		m_isDirty = true;
 
@@ -134,11 +171,167 @@ void SessionsManager::markSessionAsModified()
 	}
 }
 
+void SessionsManager::writeSessionLog()
+{
+	if (m_savingWatcher)
+	{
+		m_isDirty = true;
+
+		m_instance->scheduleSave();
+
+		return;
+	}
+
+	const QVector<MainWindow*> windows(Application::getWindows());
+	QVector<quint64> identifiers;
+	identifiers.reserve(windows.count());
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		if (!windows.at(i)->isPrivate())
+		{
+			identifiers.append(windows.at(i)->getIdentifier());
+		}
+	}
+
+	if (m_needsCompaction || m_sessionLogRecordsAmount >= 100)
+	{
+		m_modifiedWindows.clear();
+
+		if (saveSession({}, {}, nullptr, false, false))
+		{
+			m_loggedWindows = identifiers;
+			m_sessionLogRecordsAmount = 0;
+			m_needsCompaction = false;
+		}
+
+		return;
+	}
+
+	const QString path(getSessionLogPath(getSessionPath(m_sessionPath)));
+	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
+	SessionNames names;
+	QByteArray data;
+	int recordsAmount(0);
+
+	if (!QFile::exists(path))
+	{
+		QJsonArray identifiersArray;
+
+		for (int i = 0; i < m_loggedWindows.count(); ++i)
+		{
+			identifiersArray.append(QString::number(m_loggedWindows.at(i)));
+		}
+
+		data.append(QJsonDocument(QJsonObject({{QLatin1String("identifiers"), identifiersArray}})).toJson(QJsonDocument::Compact));
+		data.append('\n');
+	}
+
+	for (int i = (m_loggedWindows.count() - 1); i >= 0; --i)
+	{
+		if (!identifiers.contains(m_loggedWindows.at(i)))
+		{
+			data.append(QJsonDocument(QJsonObject({{QLatin1String("identifier"), QString::number(m_loggedWindows.at(i))}, {QLatin1String("isRemoved"), true}})).toJson(QJsonDocument::Compact));
+			data.append('\n');
+
+			m_loggedWindows.remove(i);
+
+			++recordsAmount;
+		}
+	}
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		const quint64 identifier(windows.at(i)->getIdentifier());
+
+		if (windows.at(i)->isPrivate() || (m_loggedWindows.contains(identifier) && !m_modifiedWindows.contains(identifier)))
+		{
+			continue;
+		}
+
+		const Session::MainWindow session(windows.at(i)->getSession());
+
+		if (session.windows.isEmpty())
+		{
+			continue;
+		}
+
+		collectSessionNames(session, excludedOptions, names);
+
+		data.append(QJsonDocument(QJsonObject({{QLatin1String("identifier"), QString::number(identifier)}, {QLatin1String("window"), createMainWindowObject(session, names)}})).toJson(QJsonDocument::Compact));
+		data.append('\n');
+
+		if (!m_loggedWindows.contains(identifier))
+		{
+			m_loggedWindows.append(identifier);
+		}
+
+		++recordsAmount;
+	}
+
+	m_modifiedWindows.clear();
+
+	if (recordsAmount == 0)
+	{
+		return;
+	}
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(data) != data.size() || !file.flush())
+	{
+		m_needsCompaction = true;
+
+		return;
+	}
+
+	m_sessionLogRecordsAmount += recordsAmount;
+}
+
 void SessionsManager::removeStoredUrl(const QString &url)
 {
 	emit m_instance->requestedRemoveStoredUrl(url);
 }
 
+void SessionsManager::updateOpenUrl(Window *window)
+{
+	const QUrl url(window->getUrl());
+
+	if (m_windowUrls.contains(window))
+	{
+		const QUrl previousUrl(m_windowUrls.value(window));
+
+		if (previousUrl == url)
+		{
+			return;
+		}
+
+		m_openUrls.remove(previousUrl, window);
+	}
+	else
+	{
+		connect(window, &Window::destroyed, m_instance, [=]()
+		{
+			removeOpenUrl(window);
+		});
+	}
+
+	m_windowUrls[window] = url;
+	m_openUrls.insert(url, window);
+}
+
+void SessionsManager::removeOpenUrl(Window *window)
+{
+	if (!m_windowUrls.contains(window))
+	{
+		return;
+	}
+
+	m_openUrls.remove(m_windowUrls.take(window), window);
+
+	disconnect(window, &Window::destroyed, m_instance, nullptr);
+}
+
 SessionsManager* SessionsManager::getInstance()
 {
 	return m_instance;
@@ -181,6 +374,11 @@ QString SessionsManager::getWritableDataPath(const QString &path)
 	return QDir::toNativeSeparators(m_profilePath + QDir::separator() + path);
 }
 
+QString SessionsManager::getSessionLogPath(const QString &path)
+{
+	return QFileInfo(path).absoluteDir().filePath(QFileInfo(path).completeBaseName() + QLatin1String(".log"));
+}
+
 QString SessionsManager::getSessionPath(const QString &path, bool isBound)
 {
 	QString normalizedPath(path);
@@ -228,12 +426,14 @@ SessionInformation SessionsManager::getSession(const QString &path)
 	}
 
 	const int defaultZoom(SettingsManager::getOption(SettingsManager::Content_DefaultZoomOption).toInt());
-	const QJsonArray mainWindowsArray(settings.object().value(QLatin1String("windows")).toArray());
+	const QString logPath(getSessionLogPath(getSessionPath(path)));
+	const bool hasLog(QFile::exists(logPath));
+	const QJsonArray mainWindowsArray(hasLog ? readSessionLog(logPath, settings.object().value(QLatin1String("windows")).toArray()) : settings.object().value(QLatin1String("windows")).toArray());
 
 	session.path = path;
 	session.title = settings.object().value(QLatin1String("title")).toString((path == QLatin1String("default")) ? tr("Default") : tr("(Untitled)"));
 	session.index = (settings.object().value(QLatin1String("currentIndex")).toInt(1) - 1);
-	session.isClean = settings.object().value(QLatin1String("isClean")).toBool(true);
+	session.isClean = (!hasLog && settings.object().value(QLatin1String("isClean")).toBool(true));
 
 	for (int i = 0; i < mainWindowsArray.count(); ++i)
 	{
@@ -542,7 +742,11 @@ bool SessionsManager::restoreClosedWindow(int index)
 		return false;
 	}
 
-	Application::createWindow({}, m_closedWindows.takeAt(index));
+	Session::MainWindow session(m_closedWindows.takeAt(index));
+
+	ClosedWindowsStorage::restoreHistories(session);
+
+	Application::createWindow({}, session);
 
 	emit m_instance->closedWindowsChanged();
 
@@ -551,6 +755,8 @@ bool SessionsManager::restoreClosedWindow(int index)
 
 bool SessionsManager::restoreSession(const SessionInformation &session, MainWindow *mainWindow, bool isPrivate)
 {
+	const Tracer::Span span("SessionsManager::restoreSession");
+
 	if (session.windows.isEmpty())
 	{
 		if (m_sessionPath.isEmpty() && session.path == QLatin1String("default"))
@@ -584,7 +790,7 @@ bool SessionsManager::restoreSession(const SessionInformation &session, MainWind
 	return true;
 }
 
-bool SessionsManager::saveSession(const QString &path, const QString &title, MainWindow *mainWindow, bool isClean)
+bool SessionsManager::saveSession(const QString &path, const QString &title, MainWindow *mainWindow, bool isClean, bool isBlocking)
 {
 	if (m_isPrivate && path.isEmpty())
 	{
@@ -619,10 +825,10 @@ bool SessionsManager::saveSession(const QString &path, const QString &title, Mai
 
 	session.windows.squeeze();
 
-	return saveSession(session);
+	return saveSession(session, isBlocking);
 }
 
-bool SessionsManager::saveSession(const SessionInformation &session)
+bool SessionsManager::saveSession(const SessionInformation &session, bool isBlocking)
 {
 	const QString sessionsPath(m_profilePath + QLatin1String("/sessions/"));
 
@@ -654,205 +860,400 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 	}
 
 	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
-	QJsonArray mainWindowsArray;
-	QJsonObject sessionObject({{QLatin1String("title"), session.title}, {QLatin1String("currentIndex"), 1}});
+	SessionNames names;
+
+	for (int i = 0; i < session.windows.count(); ++i)
+	{
+		collectSessionNames(session.windows.at(i), excludedOptions, names);
+	}
+
+	if (m_savingWatcher)
+	{
+		if (!isBlocking)
+		{
+			return false;
+		}
+
+		m_savingWatcher->waitForFinished();
+
+		m_instance->handleSessionSaved();
+	}
+
+	if (isBlocking)
+	{
+		m_needsCompaction = true;
+
+		return writeSession(path, session, names);
+	}
+
+	m_savingWatcher = new QFutureWatcher<bool>(m_instance);
+
+	connect(m_savingWatcher, &QFutureWatcher<bool>::finished, m_instance, &SessionsManager::handleSessionSaved);
+
+	m_savingWatcher->setFuture(QtConcurrent::run(&SessionsManager::writeSession, path, session, names));
+
+	return true;
+}
+
+bool SessionsManager::writeSession(const QString &path, const SessionInformation &session, const SessionNames &names)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	JsonWriter writer(&file);
+	writer.writeStartObject();
+	writer.writeName(QLatin1String("currentIndex"));
+	writer.writeValue(1);
 
 	if (!session.isClean)
 	{
-		sessionObject.insert(QLatin1String("isClean"), false);
+		writer.writeName(QLatin1String("isClean"));
+		writer.writeValue(false);
 	}
 
+	writer.writeName(QLatin1String("title"));
+	writer.writeValue(session.title);
+	writer.writeName(QLatin1String("windows"));
+	writer.writeStartArray();
+
 	for (int i = 0; i < session.windows.count(); ++i)
 	{
-		const Session::MainWindow sessionEntry(session.windows.at(i));
-		QJsonObject mainWindowObject({{QLatin1String("currentIndex"), (sessionEntry.index + 1)}, {QLatin1String("geometry"), QString::fromLatin1(sessionEntry.geometry.toBase64())}});
-		QJsonArray windowsArray;
+		writer.writeValue(createMainWindowObject(session.windows.at(i), names));
+	}
 
-		for (int j = 0; j < sessionEntry.windows.count(); ++j)
-		{
-			QJsonObject windowObject({{QLatin1String("currentIndex"), (sessionEntry.windows.at(j).history.index + 1)}});
+	writer.writeEndArray();
+	writer.writeEndObject();
+
+	if (writer.hasError() || !file.commit())
+	{
+		return false;
+	}
+
+	MetricsExporter::addSaveDuration(QLatin1String("session"), timer.elapsed());
+
+	const QString logPath(getSessionLogPath(path));
+
+	return (!QFile::exists(logPath) || QFile::remove(logPath));
+}
 
-			if (!sessionEntry.windows.at(j).identity.isEmpty())
+void SessionsManager::collectSessionNames(const Session::MainWindow &mainWindow, const QStringList &excludedOptions, SessionNames &names)
+{
+	for (int i = 0; i < mainWindow.windows.count(); ++i)
+	{
+		const QHash<int, QVariant> windowOptions(mainWindow.windows.at(i).options);
+		QHash<int, QVariant>::const_iterator iterator;
+
+		for (iterator = windowOptions.constBegin(); iterator != windowOptions.constEnd(); ++iterator)
+		{
+			if (!names.options.contains(iterator.key()))
 			{
-				windowObject.insert(QLatin1String("identity"), sessionEntry.windows.at(j).identity);
+				const QString optionName(SettingsManager::getOptionName(iterator.key()));
+
+				names.options[iterator.key()] = (excludedOptions.contains(optionName) ? QString() : optionName);
 			}
+		}
+	}
+
+	for (int i = 0; i < mainWindow.toolBars.count(); ++i)
+	{
+		const int identifier(mainWindow.toolBars.at(i).identifier);
+
+		if (!names.toolBars.contains(identifier))
+		{
+			names.toolBars[identifier] = ToolBarsManager::getToolBarName(identifier);
+		}
+	}
+}
 
-			if (!sessionEntry.windows.at(j).options.isEmpty())
+QJsonObject SessionsManager::createMainWindowObject(const Session::MainWindow &mainWindow, const SessionNames &names)
+{
+	QJsonObject mainWindowObject({{QLatin1String("currentIndex"), (mainWindow.index + 1)}, {QLatin1String("geometry"), QString::fromLatin1(mainWindow.geometry.toBase64())}});
+	QJsonArray windowsArray;
+
+	for (int i = 0; i < mainWindow.windows.count(); ++i)
+	{
+		QJsonObject windowObject({{QLatin1String("currentIndex"), (mainWindow.windows.at(i).history.index + 1)}});
+
+		if (!mainWindow.windows.at(i).identity.isEmpty())
+		{
+			windowObject.insert(QLatin1String("identity"), mainWindow.windows.at(i).identity);
+		}
+
+		if (!mainWindow.windows.at(i).options.isEmpty())
+		{
+			const QHash<int, QVariant> windowOptions(mainWindow.windows.at(i).options);
+			QHash<int, QVariant>::const_iterator optionsIterator;
+			QJsonObject optionsObject;
+
+			for (optionsIterator = windowOptions.constBegin(); optionsIterator != windowOptions.constEnd(); ++optionsIterator)
 			{
-				const QHash<int, QVariant> windowOptions(sessionEntry.windows.at(j).options);
-				QHash<int, QVariant>::const_iterator optionsIterator;
-				QJsonObject optionsObject;
+				const QString optionName(names.options.value(optionsIterator.key()));
 
-				for (optionsIterator = windowOptions.constBegin(); optionsIterator != windowOptions.constEnd(); ++optionsIterator)
+				if (!optionName.isEmpty())
 				{
-					const QString optionName(SettingsManager::getOptionName(optionsIterator.key()));
+					optionsObject.insert(optionName, QJsonValue::fromVariant(optionsIterator.value()));
+				}
+			}
 
-					if (!optionName.isEmpty() && !excludedOptions.contains(optionName))
+			windowObject.insert(QLatin1String("options"), optionsObject);
+		}
+
+		switch (mainWindow.windows.at(i).state.state)
+		{
+			case Qt::WindowMaximized:
+				windowObject.insert(QLatin1String("state"), QLatin1String("maximized"));
+
+				break;
+			case Qt::WindowMinimized:
+				windowObject.insert(QLatin1String("state"), QLatin1String("minimized"));
+
+				break;
+			default:
+				{
+					const QRect geometry(mainWindow.windows.at(i).state.geometry);
+
+					windowObject.insert(QLatin1String("state"), QLatin1String("normal"));
+
+					if (geometry.isValid())
 					{
-						optionsObject.insert(optionName, QJsonValue::fromVariant(optionsIterator.value()));
+						windowObject.insert(QLatin1String("geometry"), QStringLiteral("%1, %2, %3, %4").arg(geometry.x()).arg(geometry.y()).arg(geometry.width()).arg(geometry.height()));
 					}
 				}
 
-				windowObject.insert(QLatin1String("options"), optionsObject);
+				break;
+		}
+
+		if (mainWindow.windows.at(i).isAlwaysOnTop)
+		{
+			windowObject.insert(QLatin1String("isAlwaysOnTop"), true);
+		}
+
+		if (mainWindow.windows.at(i).isPinned)
+		{
+			windowObject.insert(QLatin1String("isPinned"), true);
+		}
+
+		const Session::Window::History windowHistory(mainWindow.windows.at(i).history);
+		QJsonArray windowHistoryArray;
+
+		for (int j = 0; j < windowHistory.entries.count(); ++j)
+		{
+			const QPoint position(windowHistory.entries.at(j).position);
+			QJsonObject historyEntryObject({{QLatin1String("url"), windowHistory.entries.at(j).url}, {QLatin1String("title"), windowHistory.entries.at(j).title}, {QLatin1String("zoom"), windowHistory.entries.at(j).zoom}});
+
+			if (!position.isNull())
+			{
+				historyEntryObject.insert(QLatin1String("position"), QStringLiteral("%1, %2").arg(position.x()).arg(position.y()));
+			}
+
+			windowHistoryArray.append(historyEntryObject);
+		}
+
+		windowObject.insert(QLatin1String("history"), windowHistoryArray);
+
+		windowsArray.append(windowObject);
+	}
+
+	mainWindowObject.insert(QLatin1String("windows"), windowsArray);
+
+	if (mainWindow.hasToolBarsState)
+	{
+		QJsonArray toolBarsArray;
+
+		for (int i = 0; i < mainWindow.toolBars.count(); ++i)
+		{
+			const QString identifier(names.toolBars.value(mainWindow.toolBars.at(i).identifier));
+
+			if (identifier.isEmpty())
+			{
+				continue;
 			}
 
-			switch (sessionEntry.windows.at(j).state.state)
+			QJsonObject toolBarObject({{QLatin1String("identifier"), identifier}});
+			QString location;
+
+			switch (mainWindow.toolBars.at(i).location)
 			{
-				case Qt::WindowMaximized:
-					windowObject.insert(QLatin1String("state"), QLatin1String("maximized"));
+				case Qt::LeftToolBarArea:
+					location = QLatin1String("left");
 
 					break;
-				case Qt::WindowMinimized:
-					windowObject.insert(QLatin1String("state"), QLatin1String("minimized"));
+				case Qt::RightToolBarArea:
+					location = QLatin1String("right");
 
 					break;
-				default:
-					{
-						const QRect geometry(sessionEntry.windows.at(j).state.geometry);
+				case Qt::TopToolBarArea:
+					location = QLatin1String("top");
 
-						windowObject.insert(QLatin1String("state"), QLatin1String("normal"));
-
-						if (geometry.isValid())
-						{
-							windowObject.insert(QLatin1String("geometry"), QStringLiteral("%1, %2, %3, %4").arg(geometry.x()).arg(geometry.y()).arg(geometry.width()).arg(geometry.height()));
-						}
-					}
+					break;
+				case Qt::BottomToolBarArea:
+					location = QLatin1String("bottom");
 
+					break;
+				default:
 					break;
 			}
 
-			if (sessionEntry.windows.at(j).isAlwaysOnTop)
+			if (!location.isEmpty())
 			{
-				windowObject.insert(QLatin1String("isAlwaysOnTop"), true);
+				toolBarObject.insert(QLatin1String("location"), location);
 			}
 
-			if (sessionEntry.windows.at(j).isPinned)
+			if (mainWindow.toolBars.at(i).normalVisibility != Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar)
 			{
-				windowObject.insert(QLatin1String("isPinned"), true);
+				toolBarObject.insert(QLatin1String("normalVisibility"), ((mainWindow.toolBars.at(i).normalVisibility == Session::MainWindow::ToolBarState::AlwaysHiddenToolBar) ? QLatin1String("hidden") : QLatin1String("visible")));
 			}
 
-			const Session::Window::History windowHistory(sessionEntry.windows.at(j).history);
-			QJsonArray windowHistoryArray;
-
-			for (int k = 0; k < windowHistory.entries.count(); ++k)
+			if (mainWindow.toolBars.at(i).fullScreenVisibility != Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar)
 			{
-				const QPoint position(windowHistory.entries.at(k).position);
-				QJsonObject historyEntryObject({{QLatin1String("url"), windowHistory.entries.at(k).url}, {QLatin1String("title"), windowHistory.entries.at(k).title}, {QLatin1String("zoom"), windowHistory.entries.at(k).zoom}});
-
-				if (!position.isNull())
-				{
-					historyEntryObject.insert(QLatin1String("position"), QStringLiteral("%1, %2").arg(position.x()).arg(position.y()));
-				}
-
-				windowHistoryArray.append(historyEntryObject);
+				toolBarObject.insert(QLatin1String("fullScreenVisibility"), ((mainWindow.toolBars.at(i).fullScreenVisibility == Session::MainWindow::ToolBarState::AlwaysHiddenToolBar) ? QLatin1String("hidden") : QLatin1String("visible")));
 			}
 
-			windowObject.insert(QLatin1String("history"), windowHistoryArray);
+			if (mainWindow.toolBars.at(i).row >= 0)
+			{
+				toolBarObject.insert(QLatin1String("row"), mainWindow.toolBars.at(i).row);
+			}
 
-			windowsArray.append(windowObject);
+			toolBarsArray.append(toolBarObject);
 		}
 
-		mainWindowObject.insert(QLatin1String("windows"), windowsArray);
+		mainWindowObject.insert(QLatin1String("toolBars"), toolBarsArray);
+	}
 
-		if (sessionEntry.hasToolBarsState)
+	if (!mainWindow.splitters.isEmpty())
+	{
+		QJsonArray splittersArray;
+		QMap<QString, QVector<int> >::const_iterator iterator;
+
+		for (iterator = mainWindow.splitters.begin(); iterator != mainWindow.splitters.end(); ++iterator)
 		{
-			QJsonArray toolBarsArray;
+			QJsonArray sizesArray;
+			const QVector<int> &sizes(iterator.value());
 
-			for (int j = 0; j < sessionEntry.toolBars.count(); ++j)
+			for (int i = 0; i < sizes.count(); ++i)
 			{
-				const QString identifier(ToolBarsManager::getToolBarName(sessionEntry.toolBars.at(j).identifier));
+				sizesArray.append(sizes.at(i));
+			}
 
-				if (identifier.isEmpty())
-				{
-					continue;
-				}
+			splittersArray.append(QJsonObject({{QLatin1String("identifier"), iterator.key()}, {QLatin1String("sizes"), sizesArray}}));
+		}
 
-				QJsonObject toolBarObject({{QLatin1String("identifier"), identifier}});
-				QString location;
+		mainWindowObject.insert(QLatin1String("splitters"), splittersArray);
+	}
 
-				switch (sessionEntry.toolBars.at(j).location)
-				{
-					case Qt::LeftToolBarArea:
-						location = QLatin1String("left");
+	return mainWindowObject;
+}
 
-						break;
-					case Qt::RightToolBarArea:
-						location = QLatin1String("right");
+QJsonArray SessionsManager::readSessionLog(const QString &path, const QJsonArray &mainWindows)
+{
+	QFile file(path);
 
-						break;
-					case Qt::TopToolBarArea:
-						location = QLatin1String("top");
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return mainWindows;
+	}
 
-						break;
-					case Qt::BottomToolBarArea:
-						location = QLatin1String("bottom");
+	QStringList identifiers;
+	QVector<QJsonValue> mainWindowObjects;
+	mainWindowObjects.reserve(mainWindows.count());
 
-						break;
-					default:
-						break;
-				}
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		identifiers.append(QString());
+		mainWindowObjects.append(mainWindows.at(i));
+	}
 
-				if (!location.isEmpty())
-				{
-					toolBarObject.insert(QLatin1String("location"), location);
-				}
+	while (!file.atEnd())
+	{
+		const QJsonDocument document(QJsonDocument::fromJson(file.readLine()));
 
-				if (sessionEntry.toolBars.at(j).normalVisibility != Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar)
-				{
-					toolBarObject.insert(QLatin1String("normalVisibility"), ((sessionEntry.toolBars.at(j).normalVisibility == Session::MainWindow::ToolBarState::AlwaysHiddenToolBar) ? QLatin1String("hidden") : QLatin1String("visible")));
-				}
+		if (!document.isObject())
+		{
+			break;
+		}
 
-				if (sessionEntry.toolBars.at(j).fullScreenVisibility != Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar)
-				{
-					toolBarObject.insert(QLatin1String("fullScreenVisibility"), ((sessionEntry.toolBars.at(j).fullScreenVisibility == Session::MainWindow::ToolBarState::AlwaysHiddenToolBar) ? QLatin1String("hidden") : QLatin1String("visible")));
-				}
+		const QJsonObject recordObject(document.object());
 
-				if (sessionEntry.toolBars.at(j).row >= 0)
-				{
-					toolBarObject.insert(QLatin1String("row"), sessionEntry.toolBars.at(j).row);
-				}
+		if (recordObject.contains(QLatin1String("identifiers")))
+		{
+			const QJsonArray identifiersArray(recordObject.value(QLatin1String("identifiers")).toArray());
 
-				toolBarsArray.append(toolBarObject);
+			for (int i = 0; i < qMin(identifiersArray.count(), identifiers.count()); ++i)
+			{
+				identifiers[i] = identifiersArray.at(i).toString();
 			}
 
-			mainWindowObject.insert(QLatin1String("toolBars"), toolBarsArray);
+			continue;
 		}
 
-		if (!sessionEntry.splitters.isEmpty())
-		{
-			QJsonArray splittersArray;
-			QMap<QString, QVector<int> >::const_iterator iterator;
+		const QString identifier(recordObject.value(QLatin1String("identifier")).toString());
+		const int index(identifier.isEmpty() ? -1 : identifiers.indexOf(identifier));
 
-			for (iterator = sessionEntry.splitters.begin(); iterator != sessionEntry.splitters.end(); ++iterator)
+		if (recordObject.value(QLatin1String("isRemoved")).toBool(false))
+		{
+			if (index >= 0)
 			{
-				QJsonArray sizesArray;
-				const QVector<int> &sizes(iterator.value());
-
-				for (int j = 0; j < sizes.count(); ++j)
-				{
-					sizesArray.append(sizes.at(j));
-				}
-
-				splittersArray.append(QJsonObject({{QLatin1String("identifier"), iterator.key()}, {QLatin1String("sizes"), sizesArray}}));
+				identifiers.removeAt(index);
+				mainWindowObjects.remove(index);
 			}
-
-			mainWindowObject.insert(QLatin1String("splitters"), splittersArray);
 		}
+		else if (recordObject.contains(QLatin1String("window")))
+		{
+			if (index >= 0)
+			{
+				mainWindowObjects[index] = recordObject.value(QLatin1String("window"));
+			}
+			else
+			{
+				identifiers.append(identifier);
+				mainWindowObjects.append(recordObject.value(QLatin1String("window")));
+			}
+		}
+	}
 
-		mainWindowsArray.append(mainWindowObject);
+	QJsonArray mainWindowsArray;
+
+	for (int i = 0; i < mainWindowObjects.count(); ++i)
+	{
+		mainWindowsArray.append(mainWindowObjects.at(i));
 	}
 
-	sessionObject.insert(QLatin1String("windows"), mainWindowsArray);
+	return mainWindowsArray;
+}
 
-	JsonSettings settings;
-	settings.setObject(sessionObject);
+void SessionsManager::handleSessionSaved()
+{
+	if (!m_savingWatcher)
+	{
+		return;
+	}
 
-	return settings.save(path);
+	if (!m_savingWatcher->result())
+	{
+		m_needsCompaction = true;
+	}
+
+	m_savingWatcher->disconnect(this);
+	m_savingWatcher->deleteLater();
+	m_savingWatcher = nullptr;
 }
 
 bool SessionsManager::deleteSession(const QString &path)
 {
 	const QString normalizedPath(getSessionPath(path, true));
+	const QString logPath(getSessionLogPath(normalizedPath));
+
+	if (QFile::exists(logPath))
+	{
+		QFile::remove(logPath);
+	}
 
 	if (QFile::exists(normalizedPath))
 	{
@@ -874,39 +1275,51 @@ bool SessionsManager::isReadOnly()
 
 bool SessionsManager::hasUrl(const QUrl &url, bool activate)
 {
-	MainWindow *activeWindow(Application::getActiveWindow());
+	const QList<Window*> windows(m_openUrls.values(url));
 
-	if (activeWindow ->hasUrl(url, activate))
+	if (windows.isEmpty())
 	{
-		Application::triggerAction(ActionsManager::ActivateWindowAction, {{QLatin1String("window"), activeWindow->getIdentifier()}}, m_instance);
-
-		return true;
+		return false;
 	}
 
-	const QVector<MainWindow*> windows(Application::getWindows());
-	QMultiMap<qint64, MainWindow*> map;
+	const MainWindow *activeMainWindow(Application::getActiveWindow());
+	Window *window(nullptr);
 
 	for (int i = 0; i < windows.count(); ++i)
 	{
-		if (windows.at(i) != activeWindow && windows.at(i)->getActiveWindow())
+		Window *candidateWindow(windows.at(i));
+
+		if (!window)
 		{
-			map.insert(windows.at(i)->getActiveWindow()->getLastActivity().toMSecsSinceEpoch(), windows.at(i));
+			window = candidateWindow;
+
+			continue;
+		}
+
+		const bool isInActiveMainWindow(candidateWindow->getMainWindow() == activeMainWindow);
+		const bool wasInActiveMainWindow(window->getMainWindow() == activeMainWindow);
+
+		if ((isInActiveMainWindow && !wasInActiveMainWindow) || (isInActiveMainWindow == wasInActiveMainWindow && candidateWindow->getLastActivity() > window->getLastActivity()))
+		{
+			window = candidateWindow;
 		}
 	}
 
-	const QVector<MainWindow*> sortedWindows(map.values().toVector());
+	MainWindow *mainWindow(window->getMainWindow());
 
-	for (int i = (sortedWindows.count() - 1); i >= 0; --i)
+	if (!mainWindow)
 	{
-		if (sortedWindows.at(i)->hasUrl(url, activate))
-		{
-			Application::triggerAction(ActionsManager::ActivateWindowAction, {{QLatin1String("window"), sortedWindows.at(i)->getIdentifier()}}, m_instance);
+		return false;
+	}
 
-			return true;
-		}
+	if (activate)
+	{
+		mainWindow->setActiveWindowByIdentifier(window->getIdentifier());
 	}
 
-	return false;
+	Application::triggerAction(ActionsManager::ActivateWindowAction, {{QLatin1String("window"), mainWindow->getIdentifier()}}, m_instance);
+
+	return true;
 }
 
 }
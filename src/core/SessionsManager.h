@@ -27,13 +27,18 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtCore/QRect>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
 class MainWindow;
 class SessionModel;
+class Window;
 
 class Session final : public QObject
 {
@@ -83,6 +88,7 @@ public:
 			};
 
 			QVector<Entry> entries;
+			quint64 storageIdentifier = 0;
 			int index = -1;
 
 			bool isEmpty() const
@@ -242,8 +248,10 @@ public:
 	static void createInstance(const QString &profilePath, const QString &cachePath, bool isPrivate = false, bool isReadOnly = false);
 	static void clearClosedWindows();
 	static void storeClosedWindow(MainWindow *mainWindow);
-	static void markSessionAsModified();
+	static void markSessionAsModified(QObject *source = nullptr);
 	static void removeStoredUrl(const QString &url);
+	static void updateOpenUrl(Window *window);
+	static void removeOpenUrl(Window *window);
 	static SessionsManager* getInstance();
 	static SessionModel* getModel();
 	static QString getCurrentSession();
@@ -262,31 +270,53 @@ public:
 	static OpenHints calculateOpenHints(const QVariantMap &parameters, bool ignoreModifiers = false);
 	static bool restoreClosedWindow(int index = 0);
 	static bool restoreSession(const SessionInformation &session, MainWindow *mainWindow = nullptr, bool isPrivate = false);
-	static bool saveSession(const QString &path = {}, const QString &title = {}, MainWindow *mainWindow = nullptr, bool isClean = true);
-	static bool saveSession(const SessionInformation &session);
+	static bool saveSession(const QString &path = {}, const QString &title = {}, MainWindow *mainWindow = nullptr, bool isClean = true, bool isBlocking = true);
+	static bool saveSession(const SessionInformation &session, bool isBlocking = true);
 	static bool deleteSession(const QString &path = {});
 	static bool isPrivate();
 	static bool isReadOnly();
 	static bool hasUrl(const QUrl &url, bool activate = false);
 
 protected:
+	struct SessionNames final
+	{
+		QHash<int, QString> options;
+		QHash<int, QString> toolBars;
+	};
+
 	explicit SessionsManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	static void writeSessionLog();
+	static QString getSessionLogPath(const QString &path);
+	static void collectSessionNames(const Session::MainWindow &mainWindow, const QStringList &excludedOptions, SessionNames &names);
+	static QJsonObject createMainWindowObject(const Session::MainWindow &mainWindow, const SessionNames &names);
+	static QJsonArray readSessionLog(const QString &path, const QJsonArray &mainWindows);
+	static bool writeSession(const QString &path, const SessionInformation &session, const SessionNames &names);
+
+protected slots:
+	void handleSessionSaved();
 
 private:
 	int m_saveTimer;
 
 	static SessionsManager *m_instance;
 	static SessionModel *m_model;
+	static QFutureWatcher<bool> *m_savingWatcher;
 	static QString m_sessionPath;
 	static QString m_sessionTitle;
 	static QString m_cachePath;
 	static QString m_profilePath;
 	static QHash<QString, Session::Identity> m_identities;
+	static QHash<Window*, QUrl> m_windowUrls;
+	static QMultiHash<QUrl, Window*> m_openUrls;
 	static QVector<Session::MainWindow> m_closedWindows;
+	static QVector<quint64> m_loggedWindows;
+	static QSet<quint64> m_modifiedWindows;
+	static int m_sessionLogRecordsAmount;
 	static bool m_isDirty;
+	static bool m_needsCompaction;
 	static bool m_isPrivate;
 	static bool m_isReadOnly;
 
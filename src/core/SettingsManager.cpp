@@ -20,13 +20,16 @@
 **************************************************************************/
 
 #include "SettingsManager.h"
+#include "Tracer.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QVector>
 
 namespace Otter
@@ -36,15 +39,26 @@ SettingsManager* SettingsManager::m_instance(nullptr);
 QString SettingsManager::m_globalPath;
 QString SettingsManager::m_overridePath;
 QVector<SettingsManager::OptionDefinition> SettingsManager::m_definitions;
+QVector<QVariant> SettingsManager::m_values;
+QHash<QString, QHash<int, QVariant> > SettingsManager::m_overrides;
+QHash<QString, QHash<QString, QVariant> > SettingsManager::m_pendingChanges;
+QFuture<void> SettingsManager::m_saveFuture;
+QVariant SettingsManager::m_invalidValue;
 QHash<QString, int> SettingsManager::m_customOptions;
 int SettingsManager::m_identifierCounter(-1);
 int SettingsManager::m_optionIdentifierEnumerator(0);
 bool SettingsManager::m_hasWildcardedOverrides(false);
 
-SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
+SettingsManager::SettingsManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
 {
 }
 
+SettingsManager::~SettingsManager()
+{
+	saveOptions();
+}
+
 void SettingsManager::createInstance(const QString &path)
 {
 	if (m_instance)
@@ -52,6 +66,8 @@ void SettingsManager::createInstance(const QString &path)
 		return;
 	}
 
+	const Tracer::Span span("SettingsManager::createInstance");
+
 	m_instance = new SettingsManager(QCoreApplication::instance());
 	m_globalPath = QDir::toNativeSeparators(path + QLatin1String("/otter.conf"));
 	m_overridePath = QDir::toNativeSeparators(path + QLatin1String("/override.ini"));
@@ -77,20 +93,26 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Backends_PasswordsOption, EnumerationType, QLatin1String("file"), {QLatin1String("file")});
 	registerOption(Backends_WebOption, EnumerationType, QLatin1String("qtwebkit"), {QLatin1String("qtwebkit")}, (OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag | OptionDefinition::RequiresRestartFlag));
 	registerOption(Browser_AlwaysAskWhereToSaveDownloadOption, BooleanType, true);
+	registerOption(Browser_EnableEventLoopWatchdogOption, BooleanType, false);
 	registerOption(Browser_EnableMouseGesturesOption, BooleanType, true);
 	registerOption(Browser_EnableSingleKeyShortcutsOption, BooleanType, true);
 	registerOption(Browser_EnableSpellCheckOption, BooleanType, true);
 	registerOption(Browser_EnableTrayIconOption, BooleanType, true);
 	registerOption(Browser_HomePageOption, StringType, QString());
 	registerOption(Browser_InactiveTabTimeUntilSuspendOption, IntegerType, -1);
+	registerOption(Browser_InactiveTabsMemoryLimitOption, IntegerType, -1);
 	registerOption(Browser_KeyboardShortcutsProfilesOrderOption, ListType, QStringList(QLatin1String("default")));
 	registerOption(Browser_LocaleOption, StringType, QLatin1String("system"));
 	registerOption(Browser_MessagesOption, ListType, QStringList());
+	registerOption(Browser_MetricsExportFormatOption, EnumerationType, QLatin1String("jsonLines"), {QLatin1String("jsonLines"), QLatin1String("prometheus")});
+	registerOption(Browser_MetricsExportIntervalOption, IntegerType, 60);
+	registerOption(Browser_MetricsExportPathOption, PathType, QString());
 	registerOption(Browser_MigrationsOption, ListType, QStringList());
 	registerOption(Browser_MouseProfilesOrderOption, ListType, QStringList(QLatin1String("default")));
 	registerOption(Browser_OfflineStorageLimitOption, IntegerType, 10240);
 	registerOption(Browser_OfflineWebApplicationCacheLimitOption, IntegerType, 10240);
 	registerOption(Browser_OpenLinksInNewTabOption, BooleanType, true);
+	registerOption(Browser_PreloadedPagesAmountOption, IntegerType, 1);
 	registerOption(Browser_PrintElementBackgroundsOption, BooleanType, true);
 	registerOption(Browser_PrivateModeOption, BooleanType, false);
 	registerOption(Browser_RememberPasswordsOption, BooleanType, false);
@@ -98,10 +120,20 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Browser_ShowSelectionContextMenuOnDoubleClickOption, BooleanType, false);
 	registerOption(Browser_SpellCheckDictionaryOption, StringType, QString());
 	registerOption(Browser_StartupBehaviorOption, EnumerationType, QLatin1String("continuePrevious"), {QLatin1String("continuePrevious"), QLatin1String("showDialog"), QLatin1String("startHomePage"), QLatin1String("startStartPage"), QLatin1String("startEmpty")});
+	registerOption(Browser_TransferBandwidthLimitOption, IntegerType, 0);
+	registerOption(Browser_TransferConcurrencyLimitOption, IntegerType, 0);
+	registerOption(Browser_TransferConnectionsLimitOption, IntegerType, 8);
+	registerOption(Browser_TransferHostBandwidthLimitOption, IntegerType, 0);
+	registerOption(Browser_TransferSegmentsAmountOption, IntegerType, 1);
 	registerOption(Browser_TransferStartingActionOption, EnumerationType, QLatin1String("doNothing"), {QLatin1String("openTab"), QLatin1String("openBackgroundTab"), QLatin1String("openPanel"), QLatin1String("doNothing")});
+	registerOption(Browser_TransferYieldToBrowsingOption, BooleanType, false);
 	registerOption(Browser_ValidatorsOrderOption, ListType, QStringList({QLatin1String("w3c-markup"), QLatin1String("w3c-css")}));
 	registerOption(Cache_DiskCacheLimitOption, IntegerType, 51200);
+	registerOption(Cache_EnableContentDeduplicationOption, BooleanType, false);
+	registerOption(Cache_IgnoredQueryParametersOption, ListType, QStringList({QLatin1String("utm_*"), QLatin1String("fbclid"), QLatin1String("gclid"), QLatin1String("dclid"), QLatin1String("msclkid"), QLatin1String("yclid"), QLatin1String("mc_cid"), QLatin1String("mc_eid"), QLatin1String("_ga")}));
+	registerOption(Cache_LoadPolicyOption, EnumerationType, QLatin1String("network"), {QLatin1String("network"), QLatin1String("staleWhileRevalidate"), QLatin1String("preferCache")});
 	registerOption(Cache_PagesInMemoryLimitOption, IntegerType, 5);
+	registerOption(Cache_PrivateMemoryCacheLimitOption, IntegerType, 20480);
 	registerOption(Choices_WarnFormResendOption, BooleanType, true);
 	registerOption(Choices_WarnLowDiskSpaceOption, EnumerationType, QLatin1String("warn"), {QLatin1String("warn"), QLatin1String("continueReadOnly"), QLatin1String("continueReadWrite")});
 	registerOption(Choices_WarnOpenBookmarkFolderOption, BooleanType, true);
@@ -116,6 +148,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Content_DefaultZoomOption, IntegerType, 100);
 	registerOption(Content_FantasyFontOption, FontType, QLatin1String("Impact"));
 	registerOption(Content_FixedFontOption, FontType, QLatin1String("DejaVu Sans Mono"));
+	registerOption(Content_LazyLoadImagesOption, BooleanType, false);
 	registerOption(Content_LinkColorOption, ColorType, QColor(0, 0, 0xEE));
 	registerOption(Content_MinimumFontSizeOption, IntegerType, -1);
 	registerOption(Content_PageReloadTimeOption, IntegerType, -1);
@@ -127,8 +160,16 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Content_VisitedLinkColorOption, ColorType, QColor(0x55, 0x1A, 0x8B));
 	registerOption(Content_ZoomTextOnlyOption, BooleanType, false);
 	registerOption(ContentBlocking_EnableContentBlockingOption, BooleanType, true);
+	registerOption(ContentBlocking_EnableRuleStatisticsOption, BooleanType, false);
 	registerOption(ContentBlocking_IgnoreHostsOption, ListType, QStringList());
+	registerOption(ContentBlocking_MatchingEngineOption, EnumerationType, QLatin1String("trie"), {QLatin1String("trie"), QLatin1String("tokenIndex")});
+	registerOption(ContentBlocking_MergeProfilesOption, BooleanType, false);
+	registerOption(ContentBlocking_PendingRequestsPolicyOption, EnumerationType, QLatin1String("hold"), {QLatin1String("allow"), QLatin1String("hold"), QLatin1String("block")});
 	registerOption(ContentBlocking_ProfilesOption, ListType, QStringList());
+	registerOption(ContentBlocking_ResultsCacheLimitOption, IntegerType, 5000);
+	registerOption(ContentBlocking_RuleStatisticsKeptRulesOption, ListType, QStringList());
+	registerOption(ContentBlocking_RuleStatisticsPeriodOption, IntegerType, 30);
+	registerOption(ContentBlocking_SharedCachePathOption, PathType, QString());
 	registerOption(History_BrowsingLimitAmountGlobalOption, IntegerType, 1000);
 	registerOption(History_BrowsingLimitAmountWindowOption, IntegerType, 50);
 	registerOption(History_BrowsingLimitPeriodOption, IntegerType, 30);
@@ -136,6 +177,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(History_ClosedTabsLimitAmountOption, IntegerType, 50);
 	registerOption(History_ClosedWindowsLimitAmountOption, IntegerType, 10);
 	registerOption(History_DownloadsLimitPeriodOption, IntegerType, 7);
+	registerOption(History_EnableContentsIndexingOption, BooleanType, false);
 	registerOption(History_ExpandBranchesOption, EnumerationType, QLatin1String("first"), {QLatin1String("first"), QLatin1String("all"), QLatin1String("none")});
 	registerOption(History_ManualClearOptionsOption, ListType, QStringList({QLatin1String("browsing"), QLatin1String("cookies"), QLatin1String("forms"), QLatin1String("downloads"), QLatin1String("caches")}));
 	registerOption(History_ManualClearPeriodOption, IntegerType, 1);
@@ -147,6 +189,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Interface_DateTimeFormatOption, StringType, QString());
 	registerOption(Interface_EnableSmoothScrollingOption, BooleanType, false);
 	registerOption(Interface_EnableToolTipsOption, BooleanType, true);
+	registerOption(Interface_HiddenPanelTimeUntilReleaseOption, IntegerType, 300);
 	registerOption(Interface_IconThemePathOption, PathType, QString());
 	registerOption(Interface_LastTabClosingActionOption, EnumerationType, QLatin1String("openTab"), {QLatin1String("openTab"), QLatin1String("closeWindow"), QLatin1String("closeWindowIfNotLast"), QLatin1String("doNothing")});
 	registerOption(Interface_LockToolBarsOption, BooleanType, false);
@@ -165,7 +208,11 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Network_CookiesPolicyOption, EnumerationType, QLatin1String("acceptAll"), {QLatin1String("acceptAll"), QLatin1String("acceptExisting"), QLatin1String("readOnly"), QLatin1String("ignore")});
 	registerOption(Network_DoNotTrackPolicyOption, EnumerationType, QLatin1String("skip"), {QLatin1String("skip"), QLatin1String("allow"), QLatin1String("doNotAllow")});
 	registerOption(Network_EnableDnsPrefetchOption, BooleanType, true);
+	registerOption(Network_EnableHttp2Option, BooleanType, true);
 	registerOption(Network_EnableReferrerOption, BooleanType, true);
+	registerOption(Network_EnableSpeculativeLoadingOption, BooleanType, true);
+	registerOption(Network_ProxyAutoConfigCacheModeOption, EnumerationType, QLatin1String("host"), {QLatin1String("disabled"), QLatin1String("host"), QLatin1String("url")});
+	registerOption(Network_ProxyAutoConfigCacheTimeOption, IntegerType, 300);
 	registerOption(Network_ProxyOption, EnumerationType, QLatin1String("system"), {QLatin1String("system")});
 	registerOption(Network_ThirdPartyCookiesAcceptedHostsOption, ListType, QStringList());
 	registerOption(Network_ThirdPartyCookiesPolicyOption, EnumerationType, QLatin1String("ignore"), QStringList({QLatin1String("acceptAll"), QLatin1String("acceptExisting"), QLatin1String("ignore")}));
@@ -246,16 +293,137 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Updates_LastCheckOption, StringType, QString());
 	registerOption(Updates_ServerUrlOption, StringType, QLatin1String("https://www.otter-browser.org/updates/update.json"));
 
-	const QStringList hosts(getOverrideHosts());
+	loadOptions();
+}
+
+void SettingsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_saveTimer || m_saveFuture.isRunning())
+	{
+		return;
+	}
+
+	killTimer(m_saveTimer);
+
+	m_saveTimer = 0;
+
+	const QHash<QString, QHash<QString, QVariant> > changes(m_pendingChanges);
+
+	m_pendingChanges.clear();
+
+	m_saveFuture = QtConcurrent::run(&SettingsManager::writeOptions, changes);
+}
+
+void SettingsManager::scheduleSave()
+{
+	if (m_instance && m_instance->m_saveTimer == 0)
+	{
+		m_instance->m_saveTimer = m_instance->startTimer(1000);
+	}
+}
+
+void SettingsManager::loadOptions()
+{
+	saveOptions();
+
+	m_values.fill(QVariant(), m_definitions.count());
+	m_overrides.clear();
+
+	m_hasWildcardedOverrides = false;
+
+	const QSettings settings(m_globalPath, QSettings::IniFormat);
+	const QStringList keys(settings.allKeys());
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		const int identifier(getOptionIdentifier(keys.at(i)));
+
+		if (identifier >= 0 && identifier < m_values.count())
+		{
+			m_values[identifier] = settings.value(keys.at(i));
+		}
+	}
+
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrides.childGroups());
 
 	for (int i = 0; i < hosts.count(); ++i)
 	{
+		overrides.beginGroup(hosts.at(i));
+
+		const QStringList overridesKeys(overrides.allKeys());
+		QHash<int, QVariant> values;
+
+		for (int j = 0; j < overridesKeys.count(); ++j)
+		{
+			const int identifier(getOptionIdentifier(overridesKeys.at(j)));
+
+			if (identifier >= 0 && identifier < m_values.count())
+			{
+				values[identifier] = overrides.value(overridesKeys.at(j));
+			}
+		}
+
+		overrides.endGroup();
+
+		if (!values.isEmpty())
+		{
+			m_overrides[hosts.at(i)] = values;
+		}
+
 		if (hosts.at(i).startsWith(QLatin1Char('*')))
 		{
 			m_hasWildcardedOverrides = true;
+		}
+	}
+}
 
-			break;
+void SettingsManager::saveOptions()
+{
+	if (m_instance && m_instance->m_saveTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_saveTimer);
+		m_instance->m_saveTimer = 0;
+	}
+
+	m_saveFuture.waitForFinished();
+
+	if (!m_pendingChanges.isEmpty())
+	{
+		const QHash<QString, QHash<QString, QVariant> > changes(m_pendingChanges);
+
+		m_pendingChanges.clear();
+
+		writeOptions(changes);
+	}
+}
+
+void SettingsManager::writeOptions(const QHash<QString, QHash<QString, QVariant> > &changes)
+{
+	QHash<QString, QHash<QString, QVariant> >::const_iterator pathsIterator;
+
+	for (pathsIterator = changes.constBegin(); pathsIterator != changes.constEnd(); ++pathsIterator)
+	{
+		QSettings settings(pathsIterator.key(), QSettings::IniFormat);
+		QHash<QString, QVariant>::const_iterator iterator;
+
+		for (iterator = pathsIterator->constBegin(); iterator != pathsIterator->constEnd(); ++iterator)
+		{
+			if (!iterator.value().isValid())
+			{
+				settings.remove(iterator.key());
+			}
+		}
+
+		for (iterator = pathsIterator->constBegin(); iterator != pathsIterator->constEnd(); ++iterator)
+		{
+			if (iterator.value().isValid())
+			{
+				settings.setValue(iterator.key(), iterator.value());
+			}
 		}
+
+		settings.sync();
 	}
 }
 
@@ -263,11 +431,40 @@ void SettingsManager::removeOverride(const QString &host, int identifier)
 {
 	if (identifier < 0)
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host);
+		QHash<QString, QVariant> &changes(m_pendingChanges[m_overridePath]);
+		QHash<QString, QVariant>::iterator iterator(changes.begin());
+
+		while (iterator != changes.end())
+		{
+			if (iterator.key().startsWith(host + QLatin1Char('/')))
+			{
+				iterator = changes.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		changes[host] = QVariant();
+
+		m_overrides.remove(host);
+
+		scheduleSave();
 	}
 	else
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host + QLatin1Char('/') + getOptionName(identifier));
+		saveOption(m_overridePath, host + QLatin1Char('/') + getOptionName(identifier), {}, getOptionDefinition(identifier).type);
+
+		if (m_overrides.contains(host))
+		{
+			m_overrides[host].remove(identifier);
+
+			if (m_overrides[host].isEmpty())
+			{
+				m_overrides.remove(host);
+			}
+		}
 	}
 }
 
@@ -285,20 +482,9 @@ void SettingsManager::registerOption(int identifier, OptionType type, const QVar
 
 void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type)
 {
-	if (value.isNull())
-	{
-		QSettings(path, QSettings::IniFormat).remove(key);
-	}
-	else if (type == ColorType)
-	{
-		const QColor color(value.value<QColor>());
+	m_pendingChanges[path][key] = (value.isNull() ? QVariant() : encodeValue(value, type));
 
-		QSettings(path, QSettings::IniFormat).setValue(key, (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString()));
-	}
-	else
-	{
-		QSettings(path, QSettings::IniFormat).setValue(key, value);
-	}
+	scheduleSave();
 }
 
 void SettingsManager::updateOptionDefinition(int identifier, const SettingsManager::OptionDefinition &definition)
@@ -319,13 +505,23 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 	{
 		const QString overrideName(host + QLatin1Char('/') + name);
 
+		saveOption(m_overridePath, overrideName, value, type);
+
 		if (value.isNull())
 		{
-			QSettings(m_overridePath, QSettings::IniFormat).remove(overrideName);
+			if (m_overrides.contains(host))
+			{
+				m_overrides[host].remove(identifier);
+
+				if (m_overrides[host].isEmpty())
+				{
+					m_overrides.remove(host);
+				}
+			}
 		}
 		else
 		{
-			saveOption(m_overridePath, overrideName, value, type);
+			m_overrides[host][identifier] = encodeValue(value, type);
 		}
 
 		if (!m_hasWildcardedOverrides && overrideName.startsWith(QLatin1Char('*')))
@@ -342,6 +538,11 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 	{
 		saveOption(m_globalPath, name, value, type);
 
+		if (identifier >= 0 && identifier < m_values.count())
+		{
+			m_values[identifier] = (value.isNull() ? QVariant() : encodeValue(value, type));
+		}
+
 		emit m_instance->optionChanged(identifier, value);
 	}
 }
@@ -404,6 +605,8 @@ QString SettingsManager::createReport()
 	stream.setFieldAlignment(QTextStream::AlignLeft);
 	stream << QLatin1String("Settings:\n");
 
+	saveOptions();
+
 	QHash<QString, int> overridenValues;
 	QSettings overrides(m_overridePath, QSettings::IniFormat);
 	const QStringList overridesGroups(overrides.childGroups());
@@ -484,39 +687,66 @@ QString SettingsManager::getOptionName(int identifier)
 	return m_customOptions.key(identifier);
 }
 
-QVariant SettingsManager::getOption(int identifier, const QString &host)
+QVariant SettingsManager::encodeValue(const QVariant &value, OptionType type)
 {
-	if (identifier < 0 || identifier >= m_definitions.count())
+	if (type == ColorType)
 	{
-		return {};
+		const QColor color(value.value<QColor>());
+
+		return (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString());
 	}
 
-	const QString name(getOptionName(identifier));
+	return value;
+}
+
+QVariant SettingsManager::getOption(int identifier, const QString &host)
+{
+	return getOptionValue(identifier, host);
+}
 
-	if (host.isEmpty())
+const QVariant& SettingsManager::getOptionValue(int identifier, const QString &host)
+{
+	if (identifier < 0 || identifier >= m_values.count())
 	{
-		return QSettings(m_globalPath, QSettings::IniFormat).value(name, m_definitions.at(identifier).defaultValue);
+		return m_invalidValue;
 	}
 
-	const QString overrideName(host + QLatin1Char('/') + name);
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-
-	if (m_hasWildcardedOverrides && !overrides.contains(overrideName))
+	if (!host.isEmpty() && !m_overrides.isEmpty())
 	{
-		const QStringList hostParts(host.split(QLatin1Char('.')));
+		QHash<QString, QHash<int, QVariant> >::const_iterator iterator(m_overrides.constFind(host));
 
-		for (int i = 1; i < hostParts.count(); ++i)
+		if (iterator != m_overrides.constEnd())
 		{
-			const QString wildcardedName(QLatin1String("*.") + QStringList(hostParts.mid(i)).join(QLatin1Char('.')) + QLatin1Char('/') + name);
+			const QHash<int, QVariant>::const_iterator valueIterator(iterator->constFind(identifier));
 
-			if (overrides.contains(wildcardedName))
+			if (valueIterator != iterator->constEnd())
 			{
-				return QSettings(m_overridePath, QSettings::IniFormat).value(wildcardedName, getOption(identifier));
+				return valueIterator.value();
+			}
+		}
+
+		if (m_hasWildcardedOverrides)
+		{
+			for (int position = host.indexOf(QLatin1Char('.')); position >= 0; position = host.indexOf(QLatin1Char('.'), (position + 1)))
+			{
+				iterator = m_overrides.constFind(QLatin1Char('*') + host.mid(position));
+
+				if (iterator != m_overrides.constEnd())
+				{
+					const QHash<int, QVariant>::const_iterator valueIterator(iterator->constFind(identifier));
+
+					if (valueIterator != iterator->constEnd())
+					{
+						return valueIterator.value();
+					}
+				}
 			}
 		}
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).value(overrideName, getOption(identifier));
+	const QVariant &value(m_values.at(identifier));
+
+	return (value.isValid() ? value : m_definitions.at(identifier).defaultValue);
 }
 
 QStringList SettingsManager::getOptions()
@@ -538,22 +768,24 @@ QStringList SettingsManager::getOverrideHosts(int identifier)
 {
 	if (identifier < 0)
 	{
+		saveOptions();
+
 		return QSettings(m_overridePath, QSettings::IniFormat).childGroups();
 	}
 
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
 	QStringList hosts;
-	const QString optionName(getOptionName(identifier));
+	QHash<QString, QHash<int, QVariant> >::const_iterator iterator;
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
+	for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 	{
-		if (overrides.contains(overridesGroups.at(i) + QLatin1Char('/') + optionName))
+		if (iterator->contains(identifier))
 		{
-			hosts.append(overridesGroups.at(i));
+			hosts.append(iterator.key());
 		}
 	}
 
+	hosts.sort();
+
 	return hosts;
 }
 
@@ -589,6 +821,21 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 
 	m_definitions.append(definition);
 
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrides.childGroups());
+
+	for (int i = 0; i < hosts.count(); ++i)
+	{
+		const QString overrideName(hosts.at(i) + QLatin1Char('/') + name);
+
+		if (overrides.contains(overrideName))
+		{
+			m_overrides[hosts.at(i)][identifier] = overrides.value(overrideName);
+		}
+	}
+
+	m_values.append(QSettings(m_globalPath, QSettings::IniFormat).value(name));
+
 	return identifier;
 }
 
@@ -614,10 +861,12 @@ bool SettingsManager::hasOverride(const QString &host, int identifier)
 {
 	if (identifier < 0)
 	{
+		saveOptions();
+
 		return QSettings(m_overridePath, QSettings::IniFormat).childGroups().contains(host);
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).contains(host + QLatin1Char('/') + getOptionName(identifier));
+	return m_overrides.value(host).contains(identifier);
 }
 
 }
@@ -22,6 +22,7 @@
 #ifndef OTTER_SETTINGSMANAGER_H
 #define OTTER_SETTINGSMANAGER_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QObject>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
@@ -53,20 +54,26 @@ public:
 		Backends_PasswordsOption,
 		Backends_WebOption,
 		Browser_AlwaysAskWhereToSaveDownloadOption,
+		Browser_EnableEventLoopWatchdogOption,
 		Browser_EnableMouseGesturesOption,
 		Browser_EnableSingleKeyShortcutsOption,
 		Browser_EnableSpellCheckOption,
 		Browser_EnableTrayIconOption,
 		Browser_HomePageOption,
 		Browser_InactiveTabTimeUntilSuspendOption,
+		Browser_InactiveTabsMemoryLimitOption,
 		Browser_KeyboardShortcutsProfilesOrderOption,
 		Browser_LocaleOption,
 		Browser_MessagesOption,
+		Browser_MetricsExportFormatOption,
+		Browser_MetricsExportIntervalOption,
+		Browser_MetricsExportPathOption,
 		Browser_MigrationsOption,
 		Browser_MouseProfilesOrderOption,
 		Browser_OfflineStorageLimitOption,
 		Browser_OfflineWebApplicationCacheLimitOption,
 		Browser_OpenLinksInNewTabOption,
+		Browser_PreloadedPagesAmountOption,
 		Browser_PrintElementBackgroundsOption,
 		Browser_PrivateModeOption,
 		Browser_RememberPasswordsOption,
@@ -74,10 +81,20 @@ public:
 		Browser_ShowSelectionContextMenuOnDoubleClickOption,
 		Browser_SpellCheckDictionaryOption,
 		Browser_StartupBehaviorOption,
+		Browser_TransferBandwidthLimitOption,
+		Browser_TransferConcurrencyLimitOption,
+		Browser_TransferConnectionsLimitOption,
+		Browser_TransferHostBandwidthLimitOption,
+		Browser_TransferSegmentsAmountOption,
 		Browser_TransferStartingActionOption,
+		Browser_TransferYieldToBrowsingOption,
 		Browser_ValidatorsOrderOption,
 		Cache_DiskCacheLimitOption,
+		Cache_EnableContentDeduplicationOption,
+		Cache_IgnoredQueryParametersOption,
+		Cache_LoadPolicyOption,
 		Cache_PagesInMemoryLimitOption,
+		Cache_PrivateMemoryCacheLimitOption,
 		Choices_WarnFormResendOption,
 		Choices_WarnLowDiskSpaceOption,
 		Choices_WarnOpenBookmarkFolderOption,
@@ -92,6 +109,7 @@ public:
 		Content_DefaultZoomOption,
 		Content_FantasyFontOption,
 		Content_FixedFontOption,
+		Content_LazyLoadImagesOption,
 		Content_LinkColorOption,
 		Content_MinimumFontSizeOption,
 		Content_PageReloadTimeOption,
@@ -103,8 +121,16 @@ public:
 		Content_VisitedLinkColorOption,
 		Content_ZoomTextOnlyOption,
 		ContentBlocking_EnableContentBlockingOption,
+		ContentBlocking_EnableRuleStatisticsOption,
 		ContentBlocking_IgnoreHostsOption,
+		ContentBlocking_MatchingEngineOption,
+		ContentBlocking_MergeProfilesOption,
+		ContentBlocking_PendingRequestsPolicyOption,
 		ContentBlocking_ProfilesOption,
+		ContentBlocking_ResultsCacheLimitOption,
+		ContentBlocking_RuleStatisticsKeptRulesOption,
+		ContentBlocking_RuleStatisticsPeriodOption,
+		ContentBlocking_SharedCachePathOption,
 		History_BrowsingLimitAmountGlobalOption,
 		History_BrowsingLimitAmountWindowOption,
 		History_BrowsingLimitPeriodOption,
@@ -112,6 +138,7 @@ public:
 		History_ClosedTabsLimitAmountOption,
 		History_ClosedWindowsLimitAmountOption,
 		History_DownloadsLimitPeriodOption,
+		History_EnableContentsIndexingOption,
 		History_ExpandBranchesOption,
 		History_ManualClearOptionsOption,
 		History_ManualClearPeriodOption,
@@ -123,6 +150,7 @@ public:
 		Interface_DateTimeFormatOption,
 		Interface_EnableSmoothScrollingOption,
 		Interface_EnableToolTipsOption,
+		Interface_HiddenPanelTimeUntilReleaseOption,
 		Interface_IconThemePathOption,
 		Interface_LastTabClosingActionOption,
 		Interface_LockToolBarsOption,
@@ -141,7 +169,11 @@ public:
 		Network_CookiesPolicyOption,
 		Network_DoNotTrackPolicyOption,
 		Network_EnableDnsPrefetchOption,
+		Network_EnableHttp2Option,
 		Network_EnableReferrerOption,
+		Network_EnableSpeculativeLoadingOption,
+		Network_ProxyAutoConfigCacheModeOption,
+		Network_ProxyAutoConfigCacheTimeOption,
 		Network_ProxyOption,
 		Network_ThirdPartyCookiesAcceptedHostsOption,
 		Network_ThirdPartyCookiesPolicyOption,
@@ -302,7 +334,11 @@ public:
 		}
 	};
 
+	~SettingsManager();
+
 	static void createInstance(const QString &path);
+	static void loadOptions();
+	static void saveOptions();
 	static void removeOverride(const QString &host, int identifier = -1);
 	static void updateOptionDefinition(int identifier, const OptionDefinition &definition);
 	static void setOption(int identifier, const QVariant &value, const QString &host = {});
@@ -320,17 +356,35 @@ public:
 	static int getOptionIdentifier(const QString &name);
 	static bool hasOverride(const QString &host, int identifier = -1);
 
+	template<typename T>
+	static T getOption(int identifier, const QString &host = {})
+	{
+		return getOptionValue(identifier, host).value<T>();
+	}
+
 protected:
 	explicit SettingsManager(QObject *parent);
 
+	void timerEvent(QTimerEvent *event) override;
+	static void scheduleSave();
+	static void writeOptions(const QHash<QString, QHash<QString, QVariant> > &changes);
 	static void registerOption(int identifier, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag | OptionDefinition::IsBuiltInFlag));
 	static void saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type);
+	static QVariant encodeValue(const QVariant &value, OptionType type);
+	static const QVariant& getOptionValue(int identifier, const QString &host);
 
 private:
+	int m_saveTimer;
+
 	static SettingsManager *m_instance;
 	static QString m_globalPath;
 	static QString m_overridePath;
 	static QVector<OptionDefinition> m_definitions;
+	static QVector<QVariant> m_values;
+	static QHash<QString, QHash<int, QVariant> > m_overrides;
+	static QHash<QString, QHash<QString, QVariant> > m_pendingChanges;
+	static QFuture<void> m_saveFuture;
+	static QVariant m_invalidValue;
 	static QHash<QString, int> m_customOptions;
 	static int m_identifierCounter;
 	static int m_optionIdentifierEnumerator;
@@ -341,6 +395,40 @@ signals:
 	void hostOptionChanged(int identifier, const QVariant &value, const QString &host);
 };
 
+template<typename T>
+class CachedOption final
+{
+public:
+	explicit CachedOption(int identifier) : m_value(SettingsManager::getOption<T>(identifier)),
+		m_identifier(identifier)
+	{
+		m_connection = QObject::connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, [&](int changedIdentifier)
+		{
+			if (changedIdentifier == m_identifier)
+			{
+				m_value = SettingsManager::getOption<T>(m_identifier);
+			}
+		});
+	}
+
+	~CachedOption()
+	{
+		QObject::disconnect(m_connection);
+	}
+
+	const T& getValue() const
+	{
+		return m_value;
+	}
+
+private:
+	QMetaObject::Connection m_connection;
+	T m_value;
+	int m_identifier;
+
+	Q_DISABLE_COPY(CachedOption)
+};
+
 }
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Otter::SettingsManager::OptionDefinition::OptionFlags)
@@ -99,11 +99,15 @@ void SpellCheckManager::updateDefaultDictionary()
 
 SpellCheckManager* SpellCheckManager::getInstance()
 {
+	createInstance();
+
 	return m_instance;
 }
 
 QString SpellCheckManager::getDefaultDictionary()
 {
+	createInstance();
+
 	if (m_defaultDictionary.isEmpty())
 	{
 		updateDefaultDictionary();
@@ -114,6 +118,8 @@ QString SpellCheckManager::getDefaultDictionary()
 
 QVector<SpellCheckManager::DictionaryInformation> SpellCheckManager::getDictionaries()
 {
+	createInstance();
+
 	QVector<DictionaryInformation> dictionaries;
 	dictionaries.reserve(m_dictionaries.count());
 
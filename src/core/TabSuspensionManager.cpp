@@ -0,0 +1,184 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+
+#include "TabSuspensionManager.h"
+#include "Application.h"
+#include "Console.h"
+#include "PlatformIntegration.h"
+#include "SettingsManager.h"
+#include "../ui/MainWindow.h"
+#include "../ui/Window.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMultiMap>
+#include <QtCore/QPointer>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+TabSuspensionManager* TabSuspensionManager::m_instance(nullptr);
+
+TabSuspensionManager::TabSuspensionManager(QObject *parent) : QObject(parent),
+	m_checkTimer(0)
+{
+	handleOptionChanged(SettingsManager::Browser_InactiveTabsMemoryLimitOption, SettingsManager::getOption(SettingsManager::Browser_InactiveTabsMemoryLimitOption));
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &TabSuspensionManager::handleOptionChanged);
+}
+
+void TabSuspensionManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new TabSuspensionManager(QCoreApplication::instance());
+	}
+}
+
+void TabSuspensionManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_checkTimer)
+	{
+		suspendTabs();
+	}
+}
+
+void TabSuspensionManager::suspendTabs()
+{
+	const int limit(SettingsManager::getOption(SettingsManager::Browser_InactiveTabsMemoryLimitOption).toInt());
+	const PlatformIntegration *platformIntegration(Application::getPlatformIntegration());
+
+	if (limit < 0 || !platformIntegration)
+	{
+		return;
+	}
+
+	const quint64 usage(platformIntegration->getResidentMemorySize());
+	const quint64 budget(static_cast<quint64>(limit) * 1048576);
+
+	if (usage == 0 || usage <= budget)
+	{
+		return;
+	}
+
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	QMultiMap<QDateTime, QPointer<Window> > windows;
+	int loadedAmount(0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		const Window *activeWindow(mainWindows.at(i)->getActiveWindow());
+
+		for (int j = 0; j < mainWindows.at(i)->getWindowCount(); ++j)
+		{
+			Window *window(mainWindows.at(i)->getWindowByIndex(j));
+
+			if (!window || window->getLoadingState() == WebWidget::DeferredLoadingState)
+			{
+				continue;
+			}
+
+			++loadedAmount;
+
+			if (window != activeWindow && canSuspend(window))
+			{
+				windows.insert(window->getLastActivity(), window);
+			}
+		}
+	}
+
+	if (windows.isEmpty())
+	{
+		return;
+	}
+
+	const quint64 windowUsage(usage / static_cast<quint64>(qMax(1, loadedAmount)));
+	quint64 releasedUsage(0);
+	QMultiMap<QDateTime, QPointer<Window> >::const_iterator iterator;
+
+	for (iterator = windows.constBegin(); iterator != windows.constEnd() && (usage - releasedUsage) > budget; ++iterator)
+	{
+		Window *window(iterator.value());
+
+		if (!window)
+		{
+			continue;
+		}
+
+		const QString title(window->getTitle());
+		const QString url(window->getUrl().toDisplayString());
+
+		window->triggerAction(ActionsManager::SuspendTabAction);
+
+		if (window->getLoadingState() != WebWidget::DeferredLoadingState)
+		{
+			continue;
+		}
+
+		releasedUsage += windowUsage;
+
+		Console::addMessage(tr("Suspended tab \"%1\" to reduce memory usage").arg(title), Console::OtherCategory, Console::LogLevel, url, -1, window->getIdentifier());
+
+		emit tabSuspended(window->getIdentifier());
+	}
+}
+
+void TabSuspensionManager::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier != SettingsManager::Browser_InactiveTabsMemoryLimitOption)
+	{
+		return;
+	}
+
+	if (value.toInt() >= 0)
+	{
+		if (m_checkTimer == 0)
+		{
+			m_checkTimer = startTimer(10000);
+		}
+	}
+	else if (m_checkTimer != 0)
+	{
+		killTimer(m_checkTimer);
+
+		m_checkTimer = 0;
+	}
+}
+
+TabSuspensionManager* TabSuspensionManager::getInstance()
+{
+	createInstance();
+
+	return m_instance;
+}
+
+bool TabSuspensionManager::canSuspend(Window *window)
+{
+	if (!window || window->isPinned() || window->isAboutToClose() || window->getLoadingState() == WebWidget::DeferredLoadingState)
+	{
+		return false;
+	}
+
+	const WebWidget *webWidget(window->getContentsWidget() ? window->getContentsWidget()->getWebWidget() : nullptr);
+
+	return !(webWidget && (webWidget->isAudible() || webWidget->isModified()));
+}
+
+}
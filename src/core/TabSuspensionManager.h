@@ -1,7 +1,6 @@
 /**************************************************************************
 * Otter Browser: Web browser controlled by the user, not vice-versa.
-* Copyright (C) 2015 Jan Bajer aka bajasoft <jbajer@gmail.com>
-* Copyright (C) 2017 - 2019 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
 *
 * This program is free software: you can redistribute it and/or modify
 * it under the terms of the GNU General Public License as published by
@@ -18,35 +17,41 @@
 *
 **************************************************************************/
 
-#ifndef OTTER_LONGTERMTIMER_H
-#define OTTER_LONGTERMTIMER_H
+#ifndef OTTER_TABSUSPENSIONMANAGER_H
+#define OTTER_TABSUSPENSIONMANAGER_H
 
 #include <QtCore/QObject>
 
 namespace Otter
 {
 
-class LongTermTimer final : public QObject
+class Window;
+
+class TabSuspensionManager final : public QObject
 {
 	Q_OBJECT
 
 public:
-	explicit LongTermTimer(QObject *parent = nullptr);
-
-	void start(quint64 interval);
-	void stop();
+	static void createInstance();
+	static TabSuspensionManager* getInstance();
+	static bool canSuspend(Window *window);
 
 protected:
+	explicit TabSuspensionManager(QObject *parent = nullptr);
+
 	void timerEvent(QTimerEvent *event) override;
-	void updateTimer(quint64 remainingTime, bool updateCounter = false);
+	void suspendTabs();
+
+protected slots:
+	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
-	quint64 m_interval;
-	quint64 m_remainingTime;
-	int m_timer;
+	int m_checkTimer;
+
+	static TabSuspensionManager *m_instance;
 
 signals:
-	void timeout();
+	void tabSuspended(quint64 identifier);
 };
 
 }
@@ -20,16 +20,19 @@
 #include "TasksManager.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QTimerEvent>
+
+#include <algorithm>
 
 namespace Otter
 {
 
 TasksManager* TasksManager::m_instance = nullptr;
 QMap<quint64, TasksManager::Task> TasksManager::m_tasks;
-QQueue<quint64> TasksManager::m_queue;
+QVector<TasksManager::QueueEntry> TasksManager::m_queue;
 
 TasksManager::TasksManager(QObject *parent) : QObject(parent),
-	m_tasksTimer(startTimer(60000))
+	m_tasksTimer(0)
 {
 }
 
@@ -38,6 +41,8 @@ void TasksManager::createInstance()
 	if (!m_instance)
 	{
 		m_instance = new TasksManager(QCoreApplication::instance());
+
+		updateQueue();
 	}
 }
 
@@ -45,47 +50,112 @@ void TasksManager::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_tasksTimer)
 	{
-		const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+		killTimer(m_tasksTimer);
+
+		m_tasksTimer = 0;
+
+		runTasks();
+	}
+}
+
+void TasksManager::runTasks()
+{
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const qint64 deadline(currentDateTime.toMSecsSinceEpoch() + CoalescingWindow);
+	QVector<quint64> identifiers;
+
+	while (!m_queue.isEmpty() && m_queue.first().nextRun <= deadline)
+	{
+		std::pop_heap(m_queue.begin(), m_queue.end());
+
+		identifiers.append(m_queue.last().identifier);
+
+		m_queue.removeLast();
+	}
 
-		if (m_queue.isEmpty() || !m_tasks.contains(m_queue[0]) || m_tasks[m_queue[0]].nextRun > currentDateTime)
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		const quint64 identifier(identifiers.at(i));
+
+		if (!m_tasks.contains(identifier))
 		{
-			return;
+			continue;
 		}
 
-		while (!m_queue.isEmpty())
+		const Task definition(m_tasks[identifier]);
+
+		if (definition.isBoundToObject && !definition.object)
 		{
-			if (!m_tasks.contains(m_queue[0]))
-			{
-				m_queue.dequeue();
-
-				continue;
-			}
-
-			if (m_tasks[m_queue[0]].nextRun > currentDateTime)
-			{
-				break;
-			}
-
-			const quint64 identifier(m_queue.dequeue());
-			const Task definition(m_tasks[identifier]);
-
-			if (definition.function && definition.object)
-			{
-				definition.function();
-			}
-			else
-			{
-				emit timeout(identifier);
-			}
+			m_tasks.remove(identifier);
+
+			continue;
 		}
 
-		updateQueue();
+		if (definition.isRepeating)
+		{
+			m_tasks[identifier].nextRun = currentDateTime.addSecs(definition.interval);
+		}
+		else
+		{
+			m_tasks.remove(identifier);
+		}
+
+		if (definition.function)
+		{
+			definition.function();
+		}
+		else
+		{
+			emit timeout(identifier);
+		}
 	}
+
+	updateQueue();
 }
 
 void TasksManager::updateQueue()
 {
-///TODO
+	m_queue.clear();
+	m_queue.reserve(m_tasks.count());
+
+	QMap<quint64, Task>::const_iterator iterator;
+
+	for (iterator = m_tasks.constBegin(); iterator != m_tasks.constEnd(); ++iterator)
+	{
+		QueueEntry entry;
+		entry.nextRun = iterator.value().nextRun.toMSecsSinceEpoch();
+		entry.identifier = iterator.key();
+
+		m_queue.append(entry);
+	}
+
+	std::make_heap(m_queue.begin(), m_queue.end());
+
+	scheduleTimer();
+}
+
+void TasksManager::scheduleTimer()
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	if (m_instance->m_tasksTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_tasksTimer);
+
+		m_instance->m_tasksTimer = 0;
+	}
+
+	if (m_queue.isEmpty())
+	{
+		return;
+	}
+
+	const qint64 delay(m_queue.first().nextRun - QDateTime::currentMSecsSinceEpoch());
+
+	m_instance->m_tasksTimer = m_instance->startTimer(static_cast<int>(qBound(static_cast<qint64>(0), delay, static_cast<qint64>(MaximumTimerInterval))), Qt::CoarseTimer);
 }
 
 void TasksManager::updateTask(quint64 identifier, int interval, bool isRepeating)
@@ -95,8 +165,9 @@ void TasksManager::updateTask(quint64 identifier, int interval, bool isRepeating
 		return;
 	}
 
-	m_tasks[identifier].interval = interval;
+	m_tasks[identifier].interval = static_cast<uint>(qMax(0, interval));
 	m_tasks[identifier].isRepeating = isRepeating;
+	m_tasks[identifier].nextRun = QDateTime::currentDateTimeUtc().addSecs(qMax(0, interval));
 
 	updateQueue();
 }
@@ -124,8 +195,10 @@ quint64 TasksManager::registerTask(uint interval, bool isRepeating, const std::f
 	Task definition;
 	definition.object = object;
 	definition.function = function;
+	definition.nextRun = QDateTime::currentDateTimeUtc().addSecs(interval);
 	definition.identifier = identifier;
 	definition.interval = interval;
+	definition.isBoundToObject = (object != nullptr);
 	definition.isRepeating = isRepeating;
 
 	m_tasks[identifier] = definition;
@@ -24,7 +24,7 @@
 #include <QtCore/QMap>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
-#include <QtCore/QQueue>
+#include <QtCore/QVector>
 
 #include <functional>
 
@@ -43,6 +43,7 @@ public:
 		QDateTime nextRun;
 		quint64 identifier = 0;
 		uint interval = 0;
+		bool isBoundToObject = false;
 		bool isRepeating = true;
 	};
 
@@ -53,17 +54,36 @@ public:
 	static quint64 registerTask(uint interval, bool isRepeating, const std::function<void()> &function, QObject *object = nullptr);
 
 protected:
+	enum SchedulerParameter
+	{
+		CoalescingWindow = 1000,
+		MaximumTimerInterval = 3600000
+	};
+
+	struct QueueEntry final
+	{
+		qint64 nextRun = 0;
+		quint64 identifier = 0;
+
+		bool operator<(const QueueEntry &other) const
+		{
+			return ((nextRun == other.nextRun) ? (identifier > other.identifier) : (nextRun > other.nextRun));
+		}
+	};
+
 	explicit TasksManager(QObject *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
+	void runTasks();
 	static void updateQueue();
+	static void scheduleTimer();
 
 private:
 	int m_tasksTimer;
 
 	static TasksManager *m_instance;
 	static QMap<quint64, Task> m_tasks;
-	static QQueue<quint64> m_queue;
+	static QVector<QueueEntry> m_queue;
 
 signals:
 	void timeout(quint64 identifier);
@@ -26,12 +26,12 @@
 #ifdef Q_OS_WIN32
 #include <QtCore/QAbstractEventDispatcher>
 #endif
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
-#include <QtGui/QIcon>
 #include <QtWidgets/QWidget>
 
 #ifdef Q_OS_WIN32
@@ -118,6 +118,8 @@ ThemesManager* ThemesManager::m_instance(nullptr);
 ColorScheme* ThemesManager::m_colorScheme(nullptr);
 QWidget* ThemesManager::m_probeWidget(nullptr);
 QString ThemesManager::m_iconThemePath(QLatin1String(":/icons/theme/"));
+QHash<QPair<QString, bool>, QIcon> ThemesManager::m_icons;
+QCache<QByteArray, QIcon> ThemesManager::m_dataUriIcons(DataUriIconsLimit);
 bool ThemesManager::m_useSystemIconTheme(false);
 
 ThemesManager::ThemesManager(QObject *parent) : QObject(parent)
@@ -167,6 +169,8 @@ void ThemesManager::handleOptionChanged(int identifier, const QVariant &value)
 				{
 					m_iconThemePath = path;
 
+					clearIconsCache();
+
 					emit iconThemeChanged();
 				}
 			}
@@ -177,6 +181,8 @@ void ThemesManager::handleOptionChanged(int identifier, const QVariant &value)
 			{
 				m_useSystemIconTheme = value.toBool();
 
+				clearIconsCache();
+
 				emit iconThemeChanged();
 			}
 
@@ -186,6 +192,11 @@ void ThemesManager::handleOptionChanged(int identifier, const QVariant &value)
 	}
 }
 
+void ThemesManager::clearIconsCache()
+{
+	m_icons.clear();
+}
+
 ThemesManager* ThemesManager::getInstance()
 {
 	return m_instance;
@@ -243,29 +254,63 @@ QIcon ThemesManager::createIcon(const QString &name, bool fromTheme)
 
 	if (name.startsWith(QLatin1String("data:image/")))
 	{
-		return QIcon(Utils::loadPixmapFromDataUri(name));
+		const QByteArray key(QCryptographicHash::hash(name.toLatin1(), QCryptographicHash::Md5));
+		const QIcon *cachedIcon(m_dataUriIcons.object(key));
+
+		if (cachedIcon)
+		{
+			return *cachedIcon;
+		}
+
+		const QIcon icon(Utils::loadPixmapFromDataUri(name));
+
+		m_dataUriIcons.insert(key, new QIcon(icon));
+
+		return icon;
 	}
 
-	if (m_useSystemIconTheme && fromTheme && QIcon::hasThemeIcon(name))
+	const QPair<QString, bool> key(name, fromTheme);
+
+	if (m_icons.contains(key))
 	{
-		return QIcon::fromTheme(name);
+		return m_icons.value(key);
 	}
 
-	const QString iconPath((!fromTheme && name == QLatin1String("otter-browser")) ? QLatin1String(":/icons/otter-browser") : m_iconThemePath + name);
-	const QString svgPath(iconPath + QLatin1String(".svg"));
-	const QString rasterPath(iconPath + QLatin1String(".png"));
+	QIcon icon;
 
-	if (QFile::exists(svgPath))
+	if (m_useSystemIconTheme && fromTheme && QIcon::hasThemeIcon(name))
 	{
-		return QIcon(svgPath);
+		icon = QIcon::fromTheme(name);
 	}
-
-	if (QFile::exists(rasterPath))
+	else
 	{
-		return QIcon(rasterPath);
+		const QString iconPath((!fromTheme && name == QLatin1String("otter-browser")) ? QLatin1String(":/icons/otter-browser") : m_iconThemePath + name);
+		const QString svgPath(iconPath + QLatin1String(".svg"));
+		const QString rasterPath(iconPath + QLatin1String(".png"));
+
+		if (QFile::exists(svgPath))
+		{
+			icon = QIcon(svgPath);
+		}
+		else if (QFile::exists(rasterPath))
+		{
+			icon = QIcon(rasterPath);
+		}
 	}
 
-	return {};
+	m_icons.insert(key, icon);
+
+	return icon;
+}
+
+ThemesManager::IconsCacheStatistics ThemesManager::getIconsCacheStatistics()
+{
+	IconsCacheStatistics statistics;
+	statistics.iconsAmount = m_icons.count();
+	statistics.dataUriIconsAmount = m_dataUriIcons.count();
+	statistics.dataUriIconsLimit = m_dataUriIcons.maxCost();
+
+	return statistics;
 }
 
 bool ThemesManager::eventFilter(QObject *object, QEvent *event)
@@ -25,7 +25,9 @@
 #ifdef Q_OS_WIN32
 #include <QtCore/QAbstractNativeEventFilter>
 #endif
+#include <QtCore/QCache>
 #include <QtCore/QMap>
+#include <QtGui/QIcon>
 #include <QtWidgets/QStyle>
 
 namespace Otter
@@ -103,16 +105,30 @@ class ThemesManager final : public QObject
 	Q_OBJECT
 
 public:
+	struct IconsCacheStatistics final
+	{
+		int iconsAmount = 0;
+		int dataUriIconsAmount = 0;
+		int dataUriIconsLimit = 0;
+	};
+
 	static void createInstance();
 	static ThemesManager* getInstance();
 	static ColorScheme* getColorScheme();
 	static Style* createStyle(const QString &name);
 	static QString getAnimationPath(const QString &name);
 	static QIcon createIcon(const QString &name, bool fromTheme = true);
+	static IconsCacheStatistics getIconsCacheStatistics();
 
 protected:
+	enum IconsCacheParameter
+	{
+		DataUriIconsLimit = 250
+	};
+
 	explicit ThemesManager(QObject *parent);
 
+	static void clearIconsCache();
 	bool eventFilter(QObject *object, QEvent *event) override;
 #ifdef Q_OS_WIN32
 	bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
@@ -126,6 +142,8 @@ private:
 	static ColorScheme *m_colorScheme;
 	static QWidget *m_probeWidget;
 	static QString m_iconThemePath;
+	static QHash<QPair<QString, bool>, QIcon> m_icons;
+	static QCache<QByteArray, QIcon> m_dataUriIcons;
 	static bool m_useSystemIconTheme;
 
 signals:
@@ -19,7 +19,9 @@
 
 #include "ToolBarsManager.h"
 #include "JsonSettings.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
+#include "Tracer.h"
 #include "Utils.h"
 #include "../ui/ToolBarDialog.h"
 
@@ -38,8 +40,7 @@ int ToolBarsManager::m_toolBarIdentifierEnumerator(0);
 bool ToolBarsManager::m_areToolBarsLocked(false);
 bool ToolBarsManager::m_isLoading(false);
 
-ToolBarsManager::ToolBarsManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+ToolBarsManager::ToolBarsManager(QObject *parent) : QObject(parent)
 {
 	Q_UNUSED(QT_TRANSLATE_NOOP("actions", "Menu Bar"))
 	Q_UNUSED(QT_TRANSLATE_NOOP("actions", "Bookmarks Bar"))
@@ -61,152 +62,152 @@ void ToolBarsManager::createInstance()
 		m_instance = new ToolBarsManager(QCoreApplication::instance());
 		m_toolBarIdentifierEnumerator = staticMetaObject.indexOfEnumerator(QLatin1String("ToolBarIdentifier").data());
 		m_areToolBarsLocked = SettingsManager::getOption(SettingsManager::Interface_LockToolBarsOption).toBool();
+
+		PersistenceManager::registerTarget(m_instance, [](bool)
+		{
+			save();
+
+			return true;
+		});
 	}
 }
 
-void ToolBarsManager::timerEvent(QTimerEvent *event)
+void ToolBarsManager::save()
 {
-	if (event->timerId() == m_saveTimer)
+	if (m_definitions.isEmpty())
 	{
-		killTimer(m_saveTimer);
+		return;
+	}
 
-		m_saveTimer = 0;
+	QJsonArray definitionsArray;
+	const QMap<ToolBarVisibility, QString> visibilityModes({{AlwaysVisibleToolBar, QLatin1String("visible")}, {OnHoverVisibleToolBar, QLatin1String("hover")}, {AutoVisibilityToolBar, QLatin1String("auto")}, {AlwaysHiddenToolBar, QLatin1String("hidden")}});
 
-		if (m_definitions.isEmpty())
+	for (int i = 0; i < m_definitions.count(); ++i)
+	{
+		if (m_definitions.at(i).isDefault || m_definitions.at(i).wasRemoved)
 		{
-			return;
+			continue;
 		}
 
-		QJsonArray definitionsArray;
-		const QMap<ToolBarVisibility, QString> visibilityModes({{AlwaysVisibleToolBar, QLatin1String("visible")}, {OnHoverVisibleToolBar, QLatin1String("hover")}, {AutoVisibilityToolBar, QLatin1String("auto")}, {AlwaysHiddenToolBar, QLatin1String("hidden")}});
+		const QString identifier(getToolBarName(m_definitions.at(i).identifier));
 
-		for (int i = 0; i < m_definitions.count(); ++i)
+		if (identifier.isEmpty())
 		{
-			if (m_definitions.at(i).isDefault || m_definitions.at(i).wasRemoved)
-			{
-				continue;
-			}
-
-			const QString identifier(getToolBarName(m_definitions.at(i).identifier));
+			continue;
+		}
 
-			if (identifier.isEmpty())
-			{
-				continue;
-			}
+		QJsonObject definitionObject({{QLatin1String("identifier"), QJsonValue(identifier)}, {QLatin1String("title"), QJsonValue(m_definitions.at(i).title)}, {QLatin1String("normalVisibility"), QJsonValue(visibilityModes.value(m_definitions.at(i).normalVisibility))}, {QLatin1String("fullScreenVisibility"), QJsonValue(visibilityModes.value(m_definitions.at(i).fullScreenVisibility))}});
+		QString location;
+		QString buttonStyle;
 
-			QJsonObject definitionObject({{QLatin1String("identifier"), QJsonValue(identifier)}, {QLatin1String("title"), QJsonValue(m_definitions.at(i).title)}, {QLatin1String("normalVisibility"), QJsonValue(visibilityModes.value(m_definitions.at(i).normalVisibility))}, {QLatin1String("fullScreenVisibility"), QJsonValue(visibilityModes.value(m_definitions.at(i).fullScreenVisibility))}});
-			QString location;
-			QString buttonStyle;
+		switch (m_definitions.at(i).type)
+		{
+			case BookmarksBarType:
+				definitionObject.insert(QLatin1String("bookmarksPath"), QJsonValue(m_definitions.at(i).bookmarksPath));
 
-			switch (m_definitions.at(i).type)
-			{
-				case BookmarksBarType:
-					definitionObject.insert(QLatin1String("bookmarksPath"), QJsonValue(m_definitions.at(i).bookmarksPath));
+				break;
+			case SideBarType:
+				definitionObject.insert(QLatin1String("currentPanel"), QJsonValue(m_definitions.at(i).currentPanel));
+				definitionObject.insert(QLatin1String("panels"), QJsonArray::fromStringList(m_definitions.at(i).panels));
 
-					break;
-				case SideBarType:
-					definitionObject.insert(QLatin1String("currentPanel"), QJsonValue(m_definitions.at(i).currentPanel));
-					definitionObject.insert(QLatin1String("panels"), QJsonArray::fromStringList(m_definitions.at(i).panels));
+				break;
+			default:
+				break;
+		}
 
-					break;
-				default:
-					break;
-			}
+		switch (m_definitions.at(i).location)
+		{
+			case Qt::LeftToolBarArea:
+				location = QLatin1String("left");
 
-			switch (m_definitions.at(i).location)
-			{
-				case Qt::LeftToolBarArea:
-					location = QLatin1String("left");
+				break;
+			case Qt::RightToolBarArea:
+				location = QLatin1String("right");
 
-					break;
-				case Qt::RightToolBarArea:
-					location = QLatin1String("right");
+				break;
+			case Qt::TopToolBarArea:
+				location = QLatin1String("top");
 
-					break;
-				case Qt::TopToolBarArea:
-					location = QLatin1String("top");
+				break;
+			case Qt::BottomToolBarArea:
+				location = QLatin1String("bottom");
 
-					break;
-				case Qt::BottomToolBarArea:
-					location = QLatin1String("bottom");
+				break;
+			default:
+				break;
+		}
 
-					break;
-				default:
-					break;
-			}
+		if (!location.isEmpty())
+		{
+			definitionObject.insert(QLatin1String("location"), location);
+		}
 
-			if (!location.isEmpty())
-			{
-				definitionObject.insert(QLatin1String("location"), location);
-			}
+		switch (m_definitions.at(i).buttonStyle)
+		{
+			case Qt::ToolButtonTextOnly:
+				buttonStyle = QLatin1String("textOnly");
 
-			switch (m_definitions.at(i).buttonStyle)
-			{
-				case Qt::ToolButtonTextOnly:
-					buttonStyle = QLatin1String("textOnly");
+				break;
+			case Qt::ToolButtonTextBesideIcon:
+				buttonStyle = QLatin1String("textBesideIcon");
 
-					break;
-				case Qt::ToolButtonTextBesideIcon:
-					buttonStyle = QLatin1String("textBesideIcon");
+				break;
+			case Qt::ToolButtonTextUnderIcon:
+				buttonStyle = QLatin1String("textUnderIcon");
 
-					break;
-				case Qt::ToolButtonTextUnderIcon:
-					buttonStyle = QLatin1String("textUnderIcon");
+				break;
+			case Qt::ToolButtonFollowStyle:
+				buttonStyle = QLatin1String("auto");
 
-					break;
-				case Qt::ToolButtonFollowStyle:
-					buttonStyle = QLatin1String("auto");
+				break;
+			default:
+				buttonStyle = QLatin1String("iconOnly");
 
-					break;
-				default:
-					buttonStyle = QLatin1String("iconOnly");
+				break;
+		}
 
-					break;
-			}
+		definitionObject.insert(QLatin1String("buttonStyle"), buttonStyle);
 
-			definitionObject.insert(QLatin1String("buttonStyle"), buttonStyle);
+		if (m_definitions.at(i).iconSize > 0)
+		{
+			definitionObject.insert(QLatin1String("iconSize"), QJsonValue(m_definitions.at(i).iconSize));
+		}
 
-			if (m_definitions.at(i).iconSize > 0)
-			{
-				definitionObject.insert(QLatin1String("iconSize"), QJsonValue(m_definitions.at(i).iconSize));
-			}
+		if (m_definitions.at(i).maximumButtonSize > 0)
+		{
+			definitionObject.insert(QLatin1String("maximumButtonSize"), QJsonValue(m_definitions.at(i).maximumButtonSize));
+		}
 
-			if (m_definitions.at(i).maximumButtonSize > 0)
-			{
-				definitionObject.insert(QLatin1String("maximumButtonSize"), QJsonValue(m_definitions.at(i).maximumButtonSize));
-			}
+		if (m_definitions.at(i).panelSize > 0)
+		{
+			definitionObject.insert(QLatin1String("panelSize"), QJsonValue(m_definitions.at(i).panelSize));
+		}
 
-			if (m_definitions.at(i).panelSize > 0)
-			{
-				definitionObject.insert(QLatin1String("panelSize"), QJsonValue(m_definitions.at(i).panelSize));
-			}
+		definitionObject.insert(QLatin1String("row"), QJsonValue(m_definitions.at(i).row));
 
-			definitionObject.insert(QLatin1String("row"), QJsonValue(m_definitions.at(i).row));
+		if (m_definitions.at(i).hasToggle)
+		{
+			definitionObject.insert(QLatin1String("hasToggle"), QJsonValue(true));
+		}
 
-			if (m_definitions.at(i).hasToggle)
-			{
-				definitionObject.insert(QLatin1String("hasToggle"), QJsonValue(true));
-			}
+		if (!m_definitions.at(i).entries.isEmpty())
+		{
+			QJsonArray actionsArray;
 
-			if (!m_definitions.at(i).entries.isEmpty())
+			for (int j = 0; j < m_definitions.at(i).entries.count(); ++j)
 			{
-				QJsonArray actionsArray;
-
-				for (int j = 0; j < m_definitions.at(i).entries.count(); ++j)
-				{
-					actionsArray.append(encodeEntry(m_definitions.at(i).entries.at(j)));
-				}
-
-				definitionObject.insert(QLatin1String("actions"), actionsArray);
+				actionsArray.append(encodeEntry(m_definitions.at(i).entries.at(j)));
 			}
 
-			definitionsArray.append(definitionObject);
+			definitionObject.insert(QLatin1String("actions"), actionsArray);
 		}
 
-		JsonSettings settings;
-		settings.setArray(definitionsArray);
-		settings.save(SessionsManager::getWritableDataPath(QLatin1String("toolBars.json")));
+		definitionsArray.append(definitionObject);
 	}
+
+	JsonSettings settings;
+	settings.setArray(definitionsArray);
+	settings.save(SessionsManager::getWritableDataPath(QLatin1String("toolBars.json")));
 }
 
 void ToolBarsManager::ensureInitialized()
@@ -216,6 +217,8 @@ void ToolBarsManager::ensureInitialized()
 		return;
 	}
 
+	const Tracer::Span span("ToolBarsManager::loadToolBars");
+
 	m_isLoading = true;
 
 	const QString bundledToolBarsPath(SessionsManager::getReadableDataPath(QLatin1String("toolBars.json"), true));
@@ -490,9 +493,9 @@ void ToolBarsManager::setToolBar(ToolBarsManager::ToolBarDefinition definition)
 
 void ToolBarsManager::scheduleSave()
 {
-	if (!SessionsManager::isReadOnly() && m_saveTimer == 0)
+	if (!SessionsManager::isReadOnly())
 	{
-		m_saveTimer = startTimer(1000);
+		PersistenceManager::markAsDirty(this);
 	}
 }
 
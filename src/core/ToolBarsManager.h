@@ -162,8 +162,8 @@ public:
 protected:
 	explicit ToolBarsManager(QObject *parent);
 
-	void timerEvent(QTimerEvent *event) override;
 	static void ensureInitialized();
+	static void save();
 	static QJsonValue encodeEntry(const ToolBarDefinition::Entry &definition);
 	static ToolBarDefinition::Entry decodeEntry(const QJsonValue &value);
 	static QHash<QString, ToolBarDefinition> loadToolBars(const QString &path, bool isDefault);
@@ -173,8 +173,6 @@ protected slots:
 	void handleOptionChanged(int identifier, const QVariant &value);
 
 private:
-	int m_saveTimer;
-
 	static ToolBarsManager *m_instance;
 	static QMap<int, QString> m_identifiers;
 	static QVector<ToolBarDefinition> m_definitions;
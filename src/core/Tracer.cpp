@@ -0,0 +1,193 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "Tracer.h"
+#include "Console.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+namespace Otter
+{
+
+QElapsedTimer Tracer::m_timer;
+QMutex Tracer::m_mutex;
+QString Tracer::m_path;
+QVector<Tracer::Event> Tracer::m_events;
+std::atomic<const char*> Tracer::m_activeName(nullptr);
+std::atomic<const char*> Tracer::m_activeCategory(nullptr);
+std::atomic<quintptr> Tracer::m_trackedThread(0);
+std::atomic<bool> Tracer::m_isEnabled(false);
+std::atomic<bool> Tracer::m_isTrackingScopes(false);
+
+Tracer::Span::Span(const char *name, const char *category) :
+	m_name(name),
+	m_category(category),
+	m_previousName(nullptr),
+	m_previousCategory(nullptr),
+	m_startTime(isEnabled() ? getTimestamp() : -1),
+	m_isTracked(m_isTrackingScopes && reinterpret_cast<quintptr>(QThread::currentThreadId()) == m_trackedThread)
+{
+	if (m_isTracked)
+	{
+		m_previousName = m_activeName.exchange(name);
+		m_previousCategory = m_activeCategory.exchange(category);
+	}
+}
+
+Tracer::Span::~Span()
+{
+	if (m_isTracked)
+	{
+		m_activeName = m_previousName;
+		m_activeCategory = m_previousCategory;
+	}
+
+	if (m_startTime >= 0)
+	{
+		addEvent(m_name, m_category, m_startTime, (getTimestamp() - m_startTime));
+	}
+}
+
+void Tracer::start(const QString &path)
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_path = path;
+	m_events.clear();
+	m_events.reserve(1000);
+	m_timer.start();
+	m_isEnabled = true;
+}
+
+void Tracer::stop()
+{
+	if (!m_isEnabled)
+	{
+		return;
+	}
+
+	QMutexLocker locker(&m_mutex);
+
+	m_isEnabled = false;
+
+	const qint64 processIdentifier(QCoreApplication::applicationPid());
+	QJsonArray eventsArray;
+
+	for (int i = 0; i < m_events.count(); ++i)
+	{
+		const Event &event(m_events.at(i));
+		QJsonObject eventObject({{QLatin1String("name"), QString::fromLatin1(event.name)}, {QLatin1String("cat"), QString::fromLatin1(event.category)}, {QLatin1String("ts"), event.timestamp}, {QLatin1String("pid"), processIdentifier}, {QLatin1String("tid"), static_cast<qint64>(event.thread)}});
+
+		if (event.duration < 0)
+		{
+			eventObject.insert(QLatin1String("ph"), QLatin1String("i"));
+			eventObject.insert(QLatin1String("s"), QLatin1String("p"));
+		}
+		else
+		{
+			eventObject.insert(QLatin1String("ph"), QLatin1String("X"));
+			eventObject.insert(QLatin1String("dur"), event.duration);
+		}
+
+		eventsArray.append(eventObject);
+	}
+
+	m_events.clear();
+
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save trace file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return;
+	}
+
+	file.write(QJsonDocument(QJsonObject({{QLatin1String("traceEvents"), eventsArray}, {QLatin1String("displayTimeUnit"), QLatin1String("ms")}})).toJson(QJsonDocument::Compact));
+
+	if (!file.commit())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save trace file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+	}
+}
+
+void Tracer::addInstantEvent(const char *name, const char *category)
+{
+	if (isEnabled())
+	{
+		addEvent(name, category, getTimestamp(), -1);
+	}
+}
+
+void Tracer::setScopesTrackingEnabled(bool isEnabled)
+{
+	if (isEnabled)
+	{
+		m_trackedThread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+	}
+	else
+	{
+		m_activeName = nullptr;
+		m_activeCategory = nullptr;
+	}
+
+	m_isTrackingScopes = isEnabled;
+}
+
+void Tracer::getActiveScope(const char **name, const char **category)
+{
+	*name = m_activeName;
+	*category = m_activeCategory;
+}
+
+void Tracer::addEvent(const char *name, const char *category, qint64 timestamp, qint64 duration)
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (!m_isEnabled)
+	{
+		return;
+	}
+
+	Event event;
+	event.name = name;
+	event.category = category;
+	event.timestamp = timestamp;
+	event.duration = duration;
+	event.thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+	m_events.append(event);
+}
+
+qint64 Tracer::getTimestamp()
+{
+	return (m_timer.nsecsElapsed() / 1000);
+}
+
+bool Tracer::isEnabled()
+{
+	return m_isEnabled;
+}
+
+}
@@ -0,0 +1,84 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_TRACER_H
+#define OTTER_TRACER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include <atomic>
+
+namespace Otter
+{
+
+class Tracer final
+{
+public:
+	class Span final
+	{
+	public:
+		explicit Span(const char *name, const char *category = "startup");
+		~Span();
+
+	private:
+		const char *m_name;
+		const char *m_category;
+		const char *m_previousName;
+		const char *m_previousCategory;
+		qint64 m_startTime;
+		bool m_isTracked;
+	};
+
+	static void start(const QString &path);
+	static void stop();
+	static void addInstantEvent(const char *name, const char *category = "startup");
+	static void setScopesTrackingEnabled(bool isEnabled);
+	static void getActiveScope(const char **name, const char **category);
+	static bool isEnabled();
+
+protected:
+	struct Event final
+	{
+		const char *name = nullptr;
+		const char *category = nullptr;
+		qint64 timestamp = 0;
+		qint64 duration = -1;
+		quintptr thread = 0;
+	};
+
+	static void addEvent(const char *name, const char *category, qint64 timestamp, qint64 duration);
+	static qint64 getTimestamp();
+
+private:
+	static QElapsedTimer m_timer;
+	static QMutex m_mutex;
+	static QString m_path;
+	static QVector<Event> m_events;
+	static std::atomic<const char*> m_activeName;
+	static std::atomic<const char*> m_activeCategory;
+	static std::atomic<quintptr> m_trackedThread;
+	static std::atomic<bool> m_isEnabled;
+	static std::atomic<bool> m_isTrackingScopes;
+};
+
+}
+
+#endif
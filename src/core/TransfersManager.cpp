@@ -19,17 +19,22 @@
 
 #include "TransfersManager.h"
 #include "Application.h"
+#include "Console.h"
 #include "HistoryManager.h"
 #include "NetworkManager.h"
 #include "NetworkManagerFactory.h"
 #include "NotificationsManager.h"
+#include "PersistenceManager.h"
 #include "SessionsManager.h"
 #include "Utils.h"
 #include "../ui/MainWindow.h"
+#include "../ui/Window.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QTimer>
@@ -41,11 +46,203 @@ namespace Otter
 {
 
 TransfersManager* TransfersManager::m_instance(nullptr);
+QPointer<TransferWriter> Transfer::m_writer(nullptr);
 QVector<Transfer*> TransfersManager::m_transfers;
 QVector<Transfer*> TransfersManager::m_privateTransfers;
+QSet<Transfer*> TransfersManager::m_modifiedTransfers;
+QSet<Transfer*> TransfersManager::m_changedTransfers;
+QSet<Transfer*> TransfersManager::m_pausedTransfers;
+QHash<QString, TransfersManager::TokenBucket> TransfersManager::m_hostBandwidthBuckets;
+TransfersManager::TokenBucket TransfersManager::m_bandwidthBucket;
+QByteArray TransfersManager::m_journalBuffer;
+quint64 TransfersManager::m_identifiersCounter(0);
+int TransfersManager::m_connectionsAmount(0);
+int TransfersManager::m_journalRecordsAmount(0);
+bool TransfersManager::m_needsCompaction(false);
 bool TransfersManager::m_isInitilized(false);
 bool TransfersManager::m_hasRunningTransfers(false);
 
+TransferWriter::TransferWriter(QObject *parent) : QThread(parent),
+	m_activeChunk(-1),
+	m_isStopping(false)
+{
+	m_chunks.resize(ChunksAmount);
+	m_freeChunks.reserve(ChunksAmount);
+
+	for (int i = 0; i < ChunksAmount; ++i)
+	{
+		m_chunks[i].data.resize(ChunkSize);
+
+		m_freeChunks.append(i);
+	}
+
+	start(QThread::LowPriority);
+}
+
+TransferWriter::~TransferWriter()
+{
+	m_mutex.lock();
+	m_isStopping = true;
+	m_pendingCondition.wakeAll();
+	m_mutex.unlock();
+
+	wait();
+}
+
+void TransferWriter::run()
+{
+	while (true)
+	{
+		m_mutex.lock();
+
+		while (m_pendingChunks.isEmpty() && !m_isStopping)
+		{
+			m_pendingCondition.wait(&m_mutex);
+		}
+
+		if (m_pendingChunks.isEmpty())
+		{
+			m_mutex.unlock();
+
+			break;
+		}
+
+		m_activeChunk = m_pendingChunks.dequeue();
+
+		Chunk &chunk(m_chunks[m_activeChunk]);
+
+		m_mutex.unlock();
+
+		if ((chunk.offset < 0 || chunk.device->seek(chunk.offset)) && chunk.device->write(chunk.data.constData(), chunk.size) == chunk.size)
+		{
+			for (int i = 0; i < chunk.hashes.count(); ++i)
+			{
+				chunk.hashes.at(i)->addData(chunk.data.constData(), static_cast<int>(chunk.size));
+			}
+		}
+
+		m_mutex.lock();
+
+		chunk.hashes.clear();
+		chunk.device = nullptr;
+		chunk.offset = -1;
+		chunk.size = 0;
+
+		m_freeChunks.append(m_activeChunk);
+		m_activeChunk = -1;
+		m_writtenCondition.wakeAll();
+		m_mutex.unlock();
+
+		emit chunkWritten();
+	}
+}
+
+void TransferWriter::flush(QIODevice *device)
+{
+	QMutexLocker locker(&m_mutex);
+
+	while (hasPendingChunks(device))
+	{
+		m_writtenCondition.wait(&m_mutex);
+	}
+}
+
+void TransferWriter::discard(QIODevice *device)
+{
+	QMutexLocker locker(&m_mutex);
+
+	for (int i = (m_pendingChunks.count() - 1); i >= 0; --i)
+	{
+		const int index(m_pendingChunks.at(i));
+
+		if (m_chunks.at(index).device == device)
+		{
+			m_chunks[index].hashes.clear();
+			m_chunks[index].device = nullptr;
+			m_chunks[index].offset = -1;
+			m_chunks[index].size = 0;
+
+			m_pendingChunks.removeAt(i);
+			m_freeChunks.append(index);
+		}
+	}
+
+	while (hasPendingChunks(device))
+	{
+		m_writtenCondition.wait(&m_mutex);
+	}
+}
+
+qint64 TransferWriter::write(QIODevice *source, QIODevice *device, qint64 offset, qint64 limit, const QVector<QCryptographicHash*> &hashes)
+{
+	qint64 amount(0);
+
+	while (source->bytesAvailable() > 0 && (limit < 0 || amount < limit))
+	{
+		m_mutex.lock();
+
+		if (m_freeChunks.isEmpty())
+		{
+			m_mutex.unlock();
+
+			break;
+		}
+
+		const int index(m_freeChunks.takeLast());
+
+		m_mutex.unlock();
+
+		Chunk &chunk(m_chunks[index]);
+		const qint64 size(source->read(chunk.data.data(), ((limit < 0) ? ChunkSize : qMin(qint64(ChunkSize), (limit - amount)))));
+
+		m_mutex.lock();
+
+		if (size > 0)
+		{
+			chunk.hashes = hashes;
+			chunk.device = device;
+			chunk.offset = ((offset < 0) ? -1 : (offset + amount));
+			chunk.size = size;
+
+			m_pendingChunks.enqueue(index);
+			m_pendingCondition.wakeOne();
+		}
+		else
+		{
+			m_freeChunks.append(index);
+		}
+
+		m_mutex.unlock();
+
+		if (size <= 0)
+		{
+			break;
+		}
+
+		amount += size;
+	}
+
+	return amount;
+}
+
+bool TransferWriter::hasPendingChunks(QIODevice *device) const
+{
+	if (m_activeChunk >= 0 && m_chunks.at(m_activeChunk).device == device)
+	{
+		return true;
+	}
+
+	for (int i = 0; i < m_pendingChunks.count(); ++i)
+	{
+		if (m_chunks.at(m_pendingChunks.at(i)).device == device)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 Transfer::Transfer(TransferOptions options, QObject *parent) : QObject(parent ? parent : TransfersManager::getInstance()),
 	m_reply(nullptr),
 	m_device(nullptr),
@@ -54,43 +251,70 @@ Transfer::Transfer(TransferOptions options, QObject *parent) : QObject(parent ?
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
+	m_identifier(0),
 	m_options(options),
+	m_priority(NormalPriority),
 	m_state(UnknownState),
 	m_updateTimer(0),
 	m_updateInterval(0),
 	m_remainingTime(-1),
+	m_hasPendingProgress(false),
 	m_isSelectingPath(false),
 	m_isArchived(false)
 {
 }
 
-Transfer::Transfer(const QSettings &settings, QObject *parent) : QObject(parent ? parent : TransfersManager::getInstance()),
+Transfer::Transfer(const QVariantMap &information, QObject *parent) : QObject(parent ? parent : TransfersManager::getInstance()),
 	m_reply(nullptr),
 	m_device(nullptr),
-	m_source(settings.value(QLatin1String("source")).toUrl()),
-	m_target(settings.value(QLatin1String("target")).toString()),
-	m_timeStarted(settings.value(QLatin1String("timeStarted")).toDateTime()),
-	m_timeFinished(settings.value(QLatin1String("timeFinished")).toDateTime()),
+	m_source(information.value(QLatin1String("source")).toUrl()),
+	m_target(information.value(QLatin1String("target")).toString()),
+	m_entityTag(information.value(QLatin1String("entityTag")).toByteArray()),
+	m_lastModified(information.value(QLatin1String("lastModified")).toByteArray()),
+	m_timeStarted(information.value(QLatin1String("timeStarted")).toDateTime()),
+	m_timeFinished(information.value(QLatin1String("timeFinished")).toDateTime()),
 	m_mimeType(QMimeDatabase().mimeTypeForFile(m_target)),
 	m_speed(0),
 	m_bytesStart(0),
 	m_bytesReceivedDifference(0),
-	m_bytesReceived(settings.value(QLatin1String("bytesReceived")).toLongLong()),
-	m_bytesTotal(settings.value(QLatin1String("bytesTotal")).toLongLong()),
+	m_bytesReceived(information.value(QLatin1String("bytesReceived")).toLongLong()),
+	m_bytesTotal(information.value(QLatin1String("bytesTotal")).toLongLong()),
+	m_identifier(0),
 	m_options(NoOption),
-	m_state((m_bytesReceived > 0 && m_bytesTotal == m_bytesReceived && QFile::exists(settings.value(QLatin1String("target")).toString())) ? FinishedState : ErrorState),
+	m_priority(NormalPriority),
+	m_state((m_bytesReceived > 0 && m_bytesTotal == m_bytesReceived && QFile::exists(information.value(QLatin1String("target")).toString())) ? FinishedState : ErrorState),
 	m_updateTimer(0),
 	m_updateInterval(0),
 	m_remainingTime(-1),
+	m_hasPendingProgress(false),
 	m_isSelectingPath(false),
 	m_isArchived(true)
 {
 	m_timeStarted.setTimeSpec(Qt::UTC);
 	m_timeFinished.setTimeSpec(Qt::UTC);
+
+	const QStringList segments(information.value(QLatin1String("segments")).toStringList());
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		const QStringList range(segments.at(i).split(QLatin1Char('-')));
+
+		if (range.count() == 2)
+		{
+			Segment segment;
+			segment.position = range.at(0).toLongLong();
+			segment.end = range.at(1).toLongLong();
+
+			m_segments.append(segment);
+		}
+	}
 }
 
 Transfer::~Transfer()
 {
+	discardDevice();
+	clearHashStates();
+
 	if (m_options.testFlag(HasToOpenAfterFinishOption) && QFile::exists(m_target))
 	{
 		QFile::remove(m_target);
@@ -101,6 +325,18 @@ void Transfer::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_updateTimer)
 	{
+		if (!m_segments.isEmpty())
+		{
+			startSegments();
+		}
+
+		if (m_hasPendingProgress)
+		{
+			m_hasPendingProgress = false;
+
+			emit progressChanged((m_bytesReceived - m_bytesStart), (m_bytesTotal - m_bytesStart));
+		}
+
 		const qint64 oldSpeed(m_speed);
 
 		m_speed = (m_bytesReceivedDifference * 2);
@@ -205,6 +441,15 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 	m_target = m_device->fileName();
 	m_state = (m_reply->isFinished() ? FinishedState : RunningState);
 
+	resetHashStates();
+
+	if (m_state == RunningState)
+	{
+		m_reply->setReadBufferSize(ReadBufferSize);
+
+		connect(getWriter(), &TransferWriter::chunkWritten, this, &Transfer::handleChunkWritten, Qt::UniqueConnection);
+	}
+
 	handleDataAvailable();
 
 	const bool isRunning(m_state == RunningState);
@@ -225,6 +470,8 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 		}
 	}
 
+	flushDevice();
+
 	m_device->reset();
 
 	m_mimeType = mimeDatabase.mimeTypeForData(m_device);
@@ -276,6 +523,8 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 					m_reply->abort();
 				}
 
+				discardDevice();
+
 				m_device = nullptr;
 
 				cancel();
@@ -299,6 +548,11 @@ void Transfer::start(QNetworkReply *reply, const QString &target)
 		setTarget(finalTarget, canOverwriteExisting);
 	}
 
+	if (canSegment())
+	{
+		startSegmentation();
+	}
+
 	if (m_state == FinishedState)
 	{
 		if (m_bytesTotal <= 0 && m_bytesReceived > 0)
@@ -331,6 +585,10 @@ void Transfer::cancel()
 {
 	m_state = CancelledState;
 
+	abortSegments();
+
+	m_segments.clear();
+
 	if (m_reply)
 	{
 		m_reply->abort();
@@ -340,6 +598,8 @@ void Transfer::cancel()
 
 	if (m_device)
 	{
+		discardDevice();
+
 		m_device->remove();
 	}
 
@@ -367,8 +627,12 @@ void Transfer::stop()
 		QTimer::singleShot(250, m_reply, &QNetworkReply::deleteLater);
 	}
 
+	abortSegments();
+
 	if (m_device && !m_device->inherits("QTemporaryFile"))
 	{
+		flushDevice();
+
 		m_device->close();
 		m_device->deleteLater();
 		m_device = nullptr;
@@ -406,7 +670,14 @@ void Transfer::handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 	m_bytesReceived = (m_bytesStart + bytesReceived);
 	m_bytesTotal = (m_bytesStart + bytesTotal);
 
-	emit progressChanged(bytesReceived, bytesTotal);
+	if (m_updateTimer == 0)
+	{
+		emit progressChanged(bytesReceived, bytesTotal);
+	}
+	else
+	{
+		m_hasPendingProgress = true;
+	}
 }
 
 void Transfer::handleDataAvailable()
@@ -416,22 +687,61 @@ void Transfer::handleDataAvailable()
 		return;
 	}
 
+	updateValidators();
+
 	if (m_state == ErrorState)
 	{
 		m_state = RunningState;
 
 		if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() && m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
 		{
+			flushDevice();
+
+			m_device->resize(0);
 			m_device->reset();
+
+			resetHashStates();
 		}
 	}
 
-	m_device->write(m_reply->readAll());
-	m_device->seek(m_device->size());
+	if (m_state != RunningState)
+	{
+		writeData(m_reply->readAll());
+
+		return;
+	}
+
+	writeReplyData();
 
-	if (m_state == RunningState && m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && m_bytesTotal >= 0 && m_device->size() == m_bytesTotal)
+	if (m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() && m_bytesTotal >= 0)
 	{
-		handleDownloadFinished();
+		flushDevice();
+
+		if (m_device->size() == m_bytesTotal)
+		{
+			handleDownloadFinished();
+		}
+	}
+}
+
+void Transfer::handleChunkWritten()
+{
+	if (!m_segments.isEmpty())
+	{
+		for (int i = 0; i < m_segments.count(); ++i)
+		{
+			if (m_segments.at(i).reply && m_segments.at(i).reply->bytesAvailable() > 0)
+			{
+				writeSegmentData(i);
+			}
+		}
+
+		return;
+	}
+
+	if (m_reply && m_device && m_state == RunningState && m_reply->bytesAvailable() > 0)
+	{
+		writeReplyData();
 	}
 }
 
@@ -441,6 +751,8 @@ void Transfer::handleDownloadFinished()
 	{
 		if (m_device && !m_device->inherits("QTemporaryFile"))
 		{
+			flushDevice();
+
 			m_device->close();
 			m_device->deleteLater();
 			m_device = nullptr;
@@ -479,9 +791,13 @@ void Transfer::handleDownloadFinished()
 		m_updateTimer = 0;
 	}
 
-	if (m_reply->size() > 0)
+	if (m_device && m_reply->bytesAvailable() > 0)
+	{
+		writeData(m_reply->readAll());
+	}
+	else
 	{
-		m_device->write(m_reply->readAll());
+		flushDevice();
 	}
 
 	disconnect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
@@ -505,6 +821,13 @@ void Transfer::handleDownloadFinished()
 
 		m_state = FinishedState;
 		m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
+
+		if (!m_hashes.isEmpty() && !verifyHashes())
+		{
+			m_state = ErrorState;
+
+			Console::addMessage(tr("Downloaded file does not match its checksum: %1").arg(m_target), Console::NetworkCategory, Console::ErrorLevel, m_source.toString());
+		}
 	}
 
 	emit finished();
@@ -547,567 +870,1554 @@ void Transfer::handleDownloadError(QNetworkReply::NetworkError error)
 	}
 }
 
-void Transfer::setOpenCommand(const QString &command)
+void Transfer::synchronizeDevice()
 {
-	m_openCommand = command;
-
-	m_options |= HasToOpenAfterFinishOption;
+	if (m_device && !m_device->inherits("QTemporaryFile"))
+	{
+		flushDevice();
 
-	QTemporaryFile *file(qobject_cast<QTemporaryFile*>(m_device));
+		m_device->flush();
+	}
+}
 
-	if (file)
+void Transfer::updateValidators()
+{
+	if (!m_reply)
 	{
-		file->setAutoRemove(false);
+		return;
 	}
 
-	if (m_state == FinishedState)
+	const int statusCode(m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+
+	if (statusCode != 200 && (statusCode != 206 || hasValidators()))
 	{
-		if (file)
-		{
-			file->close();
-			file->deleteLater();
+		return;
+	}
 
-			m_device = nullptr;
-		}
+	m_entityTag = m_reply->rawHeader(QByteArrayLiteral("ETag"));
+	m_lastModified = m_reply->rawHeader(QByteArrayLiteral("Last-Modified"));
 
-		openTarget();
+	if (m_entityTag.startsWith(QByteArrayLiteral("W/")))
+	{
+		m_entityTag.clear();
 	}
 }
 
-void Transfer::setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm)
+void Transfer::applyValidators(QNetworkRequest &request) const
 {
-	if (!hash.isEmpty())
+	if (!m_entityTag.isEmpty())
 	{
-		m_hashes[algorithm] = hash;
+		request.setRawHeader(QByteArrayLiteral("If-Range"), m_entityTag);
 	}
-	else if (m_hashes.contains(algorithm))
+	else if (!m_lastModified.isEmpty())
 	{
-		m_hashes.remove(algorithm);
+		request.setRawHeader(QByteArrayLiteral("If-Range"), m_lastModified);
 	}
 }
 
-void Transfer::setUpdateInterval(int interval)
+void Transfer::flushDevice()
 {
-	m_updateInterval = interval;
-
-	if (m_updateTimer != 0)
-	{
-		killTimer(m_updateTimer);
-
-		m_updateTimer = 0;
-	}
-
-	if (interval > 0 && m_updateInterval > 0 && m_state == Transfer::RunningState)
+	if (m_device && m_writer)
 	{
-		m_updateTimer = startTimer(m_updateInterval);
+		m_writer->flush(m_device);
 	}
 }
 
-QUrl Transfer::getSource() const
-{
-	return m_source;
-}
-
-QString Transfer::getSuggestedFileName()
+void Transfer::discardDevice()
 {
-	if (!m_reply)
+	if (m_device && m_writer)
 	{
-		return (m_suggestedFileName.isEmpty() ? tr("file") : m_suggestedFileName);
+		m_writer->discard(m_device);
 	}
+}
 
-	QString fileName;
+void Transfer::writeData(const QByteArray &data)
+{
+	flushDevice();
 
-	if (m_reply->hasRawHeader(QByteArrayLiteral("Content-Disposition")))
+	if (m_device->write(data) == data.size())
 	{
-		const QString contenDispositionHeader(QString::fromLatin1(m_reply->rawHeader(QByteArrayLiteral("Content-Disposition"))));
+		QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::const_iterator iterator;
 
-		if (contenDispositionHeader.contains(QLatin1String("filename*=")))
-		{
-			fileName = QRegularExpression(QLatin1String(R"([\s;]filename\*=["]?[a-zA-Z0-9\-_]+\'[a-zA-Z0-9\-]?\'([^"]+)["]?[\s;]?)")).match(contenDispositionHeader).captured(1);
-		}
-		else
+		for (iterator = m_hashStates.constBegin(); iterator != m_hashStates.constEnd(); ++iterator)
 		{
-			fileName = QRegularExpression(QLatin1String(R"([\s;]filename=["]?([^"]+)["]?[\s;]?)")).match(contenDispositionHeader).captured(1);
+			iterator.value()->addData(data);
 		}
+	}
+}
 
-		if (fileName.contains(QLatin1String("; ")))
-		{
-			fileName = fileName.section(QLatin1String("; "), 0, 0);
-		}
+void Transfer::writeReplyData()
+{
+	const qint64 limit(TransfersManager::getBandwidthAllowance(this));
 
-		fileName = QUrl(fileName).fileName();
+	if (limit != 0)
+	{
+		TransfersManager::consumeBandwidth(this, getWriter()->write(m_reply, m_device, -1, limit, m_hashStates.values().toVector()));
 	}
+}
 
-	if (fileName.isEmpty())
+void Transfer::resetHashStates(qint64 prefixSize)
+{
+	clearHashStates();
+
+	if (m_hashes.isEmpty())
 	{
-		fileName = m_source.fileName();
+		return;
 	}
 
-	if (fileName.isEmpty())
+	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
 	{
-		fileName = tr("file");
+		m_hashStates[iterator.key()] = new QCryptographicHash(iterator.key());
 	}
 
-	if (QFileInfo(fileName).suffix().isEmpty())
+	if (prefixSize <= 0)
 	{
-		QString suffix;
-
-		if (m_reply->header(QNetworkRequest::ContentTypeHeader).isValid())
+		return;
+	}
+
+	QFile file(m_target);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		clearHashStates();
+
+		return;
+	}
+
+	QByteArray buffer(ReadBufferSize, Qt::Uninitialized);
+	qint64 amount(0);
+
+	while (amount < prefixSize)
+	{
+		const qint64 size(file.read(buffer.data(), qMin(qint64(buffer.size()), (prefixSize - amount))));
+
+		if (size <= 0)
 		{
-			suffix = m_mimeType.preferredSuffix();
+			break;
 		}
 
-		if (!suffix.isEmpty())
+		QHash<QCryptographicHash::Algorithm, QCryptographicHash*>::const_iterator hashesIterator;
+
+		for (hashesIterator = m_hashStates.constBegin(); hashesIterator != m_hashStates.constEnd(); ++hashesIterator)
 		{
-			fileName.append(QLatin1Char('.'));
-			fileName.append(suffix);
+			hashesIterator.value()->addData(buffer.constData(), static_cast<int>(size));
 		}
+
+		amount += size;
 	}
 
-	m_suggestedFileName = fileName;
+	file.close();
 
-	return fileName;
+	if (amount < prefixSize)
+	{
+		clearHashStates();
+	}
 }
 
-QString Transfer::getTarget() const
+void Transfer::clearHashStates()
 {
-	return m_target;
-}
+	flushDevice();
 
-QIcon Transfer::getIcon() const
-{
-	const QString iconName(getMimeType().iconName());
+	qDeleteAll(m_hashStates);
 
-	return QIcon::fromTheme(iconName, QFileIconProvider().icon(iconName));
+	m_hashStates.clear();
 }
 
-QDateTime Transfer::getTimeStarted() const
+void Transfer::startSegmentation()
 {
-	return m_timeStarted;
-}
+	flushDevice();
 
-QDateTime Transfer::getTimeFinished() const
-{
-	return m_timeFinished;
-}
+	const qint64 position(m_device->size());
+	const qint64 remaining(m_bytesTotal - position);
+	const int amount(static_cast<int>(qMin(qint64(SettingsManager::getOption(SettingsManager::Browser_TransferSegmentsAmountOption).toInt()), (remaining / SegmentMinimumSize))));
 
-QMimeType Transfer::getMimeType() const
-{
-	return m_mimeType;
-}
+	if (amount < 2 || !m_device->resize(m_bytesTotal))
+	{
+		return;
+	}
 
-qint64 Transfer::getSpeed() const
-{
-	return m_speed;
-}
+	const qint64 size(remaining / amount);
 
-qint64 Transfer::getBytesReceived() const
-{
-	return m_bytesReceived;
-}
+	disconnect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
+	disconnect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+	disconnect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
+	disconnect(m_reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &Transfer::handleDownloadError);
 
-qint64 Transfer::getBytesTotal() const
-{
-	return m_bytesTotal;
-}
+	clearHashStates();
 
-Transfer::TransferOptions Transfer::getOptions() const
-{
-	return m_options;
+	m_segments.resize(amount);
+	m_bytesStart = 0;
+	m_bytesReceived = position;
+
+	for (int i = 0; i < amount; ++i)
+	{
+		m_segments[i].position = (position + (i * size));
+		m_segments[i].end = ((i == (amount - 1)) ? (m_bytesTotal - 1) : (m_segments[i].position + size - 1));
+	}
+
+	QNetworkReply *reply(m_reply);
+
+	m_reply = nullptr;
+	m_segments[0].reply = reply;
+
+	connect(reply, &QNetworkReply::readyRead, this, [=]()
+	{
+		writeSegmentData(getSegmentIndex(reply));
+	});
+	connect(reply, &QNetworkReply::finished, this, [=]()
+	{
+		finishSegment(getSegmentIndex(reply));
+	});
+
+	startSegments();
+	writeSegmentData(0);
 }
 
-Transfer::TransferState Transfer::getState() const
+void Transfer::startSegments()
 {
-	return m_state;
+	if (m_state != RunningState)
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		Segment &segment(m_segments[i]);
+
+		if (segment.reply || segment.position > segment.end)
+		{
+			continue;
+		}
+
+		if (!TransfersManager::reserveConnection())
+		{
+			break;
+		}
+
+		QNetworkRequest request;
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+		request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+		request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-%2").arg(segment.position).arg(segment.end).toLatin1());
+		request.setUrl(m_source);
+
+		applyValidators(request);
+
+		QNetworkReply *reply(NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request));
+		reply->setReadBufferSize(ReadBufferSize);
+
+		segment.reply = reply;
+		segment.isReserved = true;
+
+		connect(reply, &QNetworkReply::readyRead, this, [=]()
+		{
+			writeSegmentData(getSegmentIndex(reply));
+		});
+		connect(reply, &QNetworkReply::finished, this, [=]()
+		{
+			finishSegment(getSegmentIndex(reply));
+		});
+	}
 }
 
-int Transfer::getRemainingTime() const
+void Transfer::abortSegments()
 {
-	return m_remainingTime;
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		Segment &segment(m_segments[i]);
+
+		if (segment.reply)
+		{
+			disconnect(segment.reply, nullptr, this, nullptr);
+
+			segment.reply->abort();
+			segment.reply->deleteLater();
+			segment.reply = nullptr;
+		}
+
+		if (segment.isReserved)
+		{
+			segment.isReserved = false;
+
+			TransfersManager::releaseConnection();
+		}
+	}
 }
 
-bool Transfer::verifyHashes() const
+void Transfer::writeSegmentData(int index, bool canThrottle)
 {
-	if (getState() != FinishedState)
+	if (index < 0 || !m_device)
 	{
-		return false;
+		return;
 	}
 
-	QFile file(getTarget());
+	Segment &segment(m_segments[index]);
 
-	if (!file.open(QIODevice::ReadOnly))
+	if (!segment.reply || segment.position > segment.end)
 	{
-		return false;
+		return;
 	}
 
-	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
-	bool isValid(true);
-
-	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	if (segment.isReserved && segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid() && segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
 	{
-		QCryptographicHash hash(iterator.key());
-		hash.addData(&file);
-
-		if (hash.result() != iterator.value())
+		if (segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200 && hasValidators())
 		{
-			isValid = false;
+			disconnect(segment.reply, nullptr, this, nullptr);
 
-			break;
+			segment.reply->abort();
+
+			QMetaObject::invokeMethod(this, "restart", Qt::QueuedConnection);
+
+			return;
 		}
 
-		file.seek(0);
+		segment.retries = SegmentRetriesLimit;
+		segment.reply->abort();
+
+		return;
 	}
 
-	file.close();
+	const qint64 allowance(canThrottle ? TransfersManager::getBandwidthAllowance(this) : -1);
 
-	return isValid;
-}
+	if (allowance == 0)
+	{
+		return;
+	}
 
-bool Transfer::isArchived() const
-{
-	return m_isArchived;
+	const qint64 remaining(segment.end - segment.position + 1);
+	const qint64 amount(getWriter()->write(segment.reply, m_device, segment.position, ((allowance < 0) ? remaining : qMin(remaining, allowance))));
+
+	TransfersManager::consumeBandwidth(this, amount);
+
+	segment.position += amount;
+
+	m_bytesReceived += amount;
+	m_bytesReceivedDifference += amount;
+
+	if (m_updateTimer == 0)
+	{
+		emit progressChanged(m_bytesReceived, m_bytesTotal);
+	}
+	else
+	{
+		m_hasPendingProgress = true;
+	}
+
+	if (segment.position > segment.end && !segment.reply->isFinished())
+	{
+		segment.reply->abort();
+	}
 }
 
-bool Transfer::resume()
+void Transfer::finishSegment(int index)
 {
-	if (m_state != ErrorState || !QFile::exists(m_target))
+	if (index < 0)
 	{
-		return false;
+		return;
 	}
 
-	m_isArchived = false;
+	QNetworkReply *reply(m_segments.at(index).reply);
 
-	if (m_bytesTotal == 0)
+	while (m_segments.at(index).position <= m_segments.at(index).end && reply->bytesAvailable() > 0 && m_segments.at(index).retries < SegmentRetriesLimit)
 	{
-		return restart();
+		flushDevice();
+		writeSegmentData(index, false);
 	}
 
-	QFile *file(new QFile(m_target));
+	Segment &segment(m_segments[index]);
+	segment.reply = nullptr;
 
-	if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+	reply->deleteLater();
+
+	if (segment.isReserved)
 	{
-		file->deleteLater();
+		segment.isReserved = false;
 
-		return false;
+		TransfersManager::releaseConnection();
 	}
 
-	m_state = RunningState;
-	m_device = file;
-	m_timeStarted = QDateTime::currentDateTimeUtc();
-	m_timeFinished = {};
-	m_bytesStart = file->size();
-
-	QNetworkRequest request;
-	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
-	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
-	request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-").arg(file->size()).toLatin1());
-	request.setUrl(m_source);
+	if (m_state != RunningState)
+	{
+		return;
+	}
 
-	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	if (segment.position <= segment.end)
+	{
+		++segment.retries;
 
-	handleDataAvailable();
+		if (segment.retries > SegmentRetriesLimit)
+		{
+			handleDownloadError(QNetworkReply::UnknownNetworkError);
 
-	connect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
-	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
-	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
-	connect(m_reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &Transfer::handleDownloadError);
+			return;
+		}
+	}
 
-	if (m_updateTimer == 0 && m_updateInterval > 0)
+	for (int i = 0; i < m_segments.count(); ++i)
 	{
-		m_updateTimer = startTimer(m_updateInterval);
+		if (m_segments.at(i).position <= m_segments.at(i).end)
+		{
+			startSegments();
+
+			return;
+		}
 	}
 
-	return true;
+	finishSegments();
 }
 
-bool Transfer::restart()
+void Transfer::finishSegments()
 {
-	stop();
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
 
-	m_isArchived = false;
+		m_updateTimer = 0;
+	}
 
-	QFile *file(new QFile(m_target));
+	flushDevice();
 
-	if (!file->open(QIODevice::WriteOnly))
-	{
-		file->deleteLater();
+	m_segments.clear();
 
-		return false;
+	if (m_device)
+	{
+		m_device->close();
+		m_device->deleteLater();
+		m_device = nullptr;
 	}
 
-	m_state = RunningState;
-	m_device = file;
-	m_timeStarted = QDateTime::currentDateTimeUtc();
-	m_timeFinished = {};
-	m_bytesStart = 0;
+	markAsFinished();
 
-	QNetworkRequest request;
-	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
-	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
-	request.setUrl(m_source);
+	m_bytesReceived = m_bytesTotal;
+	m_state = FinishedState;
+	m_mimeType = QMimeDatabase().mimeTypeForFile(m_target);
 
-	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	if (!m_hashes.isEmpty() && !verifyHashes())
+	{
+		m_state = ErrorState;
 
-	handleDataAvailable();
+		Console::addMessage(tr("Downloaded file does not match its checksum: %1").arg(m_target), Console::NetworkCategory, Console::ErrorLevel, m_source.toString());
+	}
 
-	connect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
-	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
-	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
-	connect(m_reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &Transfer::handleDownloadError);
+	emit finished();
+	emit changed();
 
-	if (m_updateTimer == 0 && m_updateInterval > 0)
+	if (m_state == FinishedState && m_options.testFlag(HasToOpenAfterFinishOption))
 	{
-		m_updateTimer = startTimer(m_updateInterval);
+		openTarget();
 	}
 
-	return true;
+	if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
+	{
+		deleteLater();
+	}
 }
 
-bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
+void Transfer::setOpenCommand(const QString &command)
 {
-	if (m_target == target)
+	m_openCommand = command;
+
+	m_options |= HasToOpenAfterFinishOption;
+
+	QTemporaryFile *file(qobject_cast<QTemporaryFile*>(m_device));
+
+	if (file)
 	{
-		return false;
+		file->setAutoRemove(false);
 	}
 
-	QString mutableTarget(target);
+	if (m_state == FinishedState)
+	{
+		if (file)
+		{
+			flushDevice();
+
+			file->close();
+			file->deleteLater();
+
+			m_device = nullptr;
+		}
+
+		openTarget();
+	}
+}
+
+void Transfer::setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm)
+{
+	if (!hash.isEmpty())
+	{
+		m_hashes[algorithm] = hash;
+	}
+	else if (m_hashes.contains(algorithm))
+	{
+		m_hashes.remove(algorithm);
+	}
+
+	if (m_device && m_state == RunningState && m_segments.isEmpty())
+	{
+		flushDevice();
+
+		resetHashStates(m_device->size());
+	}
+	else if (m_state != FinishedState)
+	{
+		clearHashStates();
+	}
+}
+
+void Transfer::setPriority(TransferPriority priority)
+{
+	if (priority != m_priority)
+	{
+		m_priority = priority;
+
+		TransfersManager::updateSchedule();
+
+		emit changed();
+	}
+}
+
+void Transfer::setUpdateInterval(int interval)
+{
+	m_updateInterval = interval;
+
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+
+	if (interval > 0 && m_updateInterval > 0 && m_state == Transfer::RunningState)
+	{
+		m_updateTimer = startTimer(m_updateInterval);
+	}
+}
+
+QUrl Transfer::getSource() const
+{
+	return m_source;
+}
+
+QString Transfer::getSuggestedFileName()
+{
+	if (!m_reply)
+	{
+		return (m_suggestedFileName.isEmpty() ? tr("file") : m_suggestedFileName);
+	}
+
+	QString fileName;
+
+	if (m_reply->hasRawHeader(QByteArrayLiteral("Content-Disposition")))
+	{
+		const QString contenDispositionHeader(QString::fromLatin1(m_reply->rawHeader(QByteArrayLiteral("Content-Disposition"))));
+
+		if (contenDispositionHeader.contains(QLatin1String("filename*=")))
+		{
+			fileName = QRegularExpression(QLatin1String(R"([\s;]filename\*=["]?[a-zA-Z0-9\-_]+\'[a-zA-Z0-9\-]?\'([^"]+)["]?[\s;]?)")).match(contenDispositionHeader).captured(1);
+		}
+		else
+		{
+			fileName = QRegularExpression(QLatin1String(R"([\s;]filename=["]?([^"]+)["]?[\s;]?)")).match(contenDispositionHeader).captured(1);
+		}
+
+		if (fileName.contains(QLatin1String("; ")))
+		{
+			fileName = fileName.section(QLatin1String("; "), 0, 0);
+		}
+
+		fileName = QUrl(fileName).fileName();
+	}
+
+	if (fileName.isEmpty())
+	{
+		fileName = m_source.fileName();
+	}
+
+	if (fileName.isEmpty())
+	{
+		fileName = tr("file");
+	}
+
+	if (QFileInfo(fileName).suffix().isEmpty())
+	{
+		QString suffix;
+
+		if (m_reply->header(QNetworkRequest::ContentTypeHeader).isValid())
+		{
+			suffix = m_mimeType.preferredSuffix();
+		}
+
+		if (!suffix.isEmpty())
+		{
+			fileName.append(QLatin1Char('.'));
+			fileName.append(suffix);
+		}
+	}
+
+	m_suggestedFileName = fileName;
+
+	return fileName;
+}
+
+QString Transfer::getTarget() const
+{
+	return m_target;
+}
+
+QIcon Transfer::getIcon() const
+{
+	const QString iconName(getMimeType().iconName());
+
+	return QIcon::fromTheme(iconName, QFileIconProvider().icon(iconName));
+}
+
+QDateTime Transfer::getTimeStarted() const
+{
+	return m_timeStarted;
+}
+
+QDateTime Transfer::getTimeFinished() const
+{
+	return m_timeFinished;
+}
+
+QMimeType Transfer::getMimeType() const
+{
+	return m_mimeType;
+}
+
+qint64 Transfer::getSpeed() const
+{
+	return m_speed;
+}
+
+qint64 Transfer::getBytesReceived() const
+{
+	return m_bytesReceived;
+}
+
+qint64 Transfer::getBytesTotal() const
+{
+	return m_bytesTotal;
+}
+
+QStringList Transfer::getSegments() const
+{
+	QStringList segments;
+	segments.reserve(m_segments.count());
+
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		segments.append(QStringLiteral("%1-%2").arg(m_segments.at(i).position).arg(m_segments.at(i).end));
+	}
+
+	return segments;
+}
+
+Transfer::TransferOptions Transfer::getOptions() const
+{
+	return m_options;
+}
+
+Transfer::TransferPriority Transfer::getPriority() const
+{
+	return m_priority;
+}
+
+Transfer::TransferState Transfer::getState() const
+{
+	return m_state;
+}
+
+quint64 Transfer::getIdentifier() const
+{
+	return m_identifier;
+}
+
+int Transfer::getRemainingTime() const
+{
+	return m_remainingTime;
+}
+
+bool Transfer::verifyHashes() const
+{
+	if (getState() != FinishedState)
+	{
+		return false;
+	}
+
+	QHash<QCryptographicHash::Algorithm, QByteArray>::const_iterator iterator;
+
+	if (!m_hashStates.isEmpty() && m_hashStates.count() == m_hashes.count())
+	{
+		for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+		{
+			if (!m_hashStates.contains(iterator.key()) || m_hashStates.value(iterator.key())->result() != iterator.value())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	QFile file(getTarget());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	bool isValid(true);
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		QCryptographicHash hash(iterator.key());
+		hash.addData(&file);
+
+		if (hash.result() != iterator.value())
+		{
+			isValid = false;
+
+			break;
+		}
+
+		file.seek(0);
+	}
+
+	file.close();
+
+	return isValid;
+}
+
+TransferWriter* Transfer::getWriter()
+{
+	if (!m_writer)
+	{
+		m_writer = new TransferWriter(QCoreApplication::instance());
+	}
+
+	return m_writer;
+}
+
+int Transfer::getSegmentIndex(const QNetworkReply *reply) const
+{
+	for (int i = 0; i < m_segments.count(); ++i)
+	{
+		if (m_segments.at(i).reply == reply)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool Transfer::canSegment() const
+{
+	if (!m_reply || m_reply->isFinished() || !m_device || m_device->inherits("QTemporaryFile") || m_state != RunningState || m_bytesTotal < (SegmentMinimumSize * 2) || SettingsManager::getOption(SettingsManager::Browser_TransferSegmentsAmountOption).toInt() < 2)
+	{
+		return false;
+	}
+
+	if (m_source.scheme() != QLatin1String("http") && m_source.scheme() != QLatin1String("https"))
+	{
+		return false;
+	}
+
+	if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200 || m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool() || m_reply->hasRawHeader(QByteArrayLiteral("Content-Encoding")))
+	{
+		return false;
+	}
+
+	return m_reply->rawHeader(QByteArrayLiteral("Accept-Ranges")).toLower().contains(QByteArrayLiteral("bytes"));
+}
+
+bool Transfer::hasValidators() const
+{
+	return (!m_entityTag.isEmpty() || !m_lastModified.isEmpty());
+}
+
+bool Transfer::isArchived() const
+{
+	return m_isArchived;
+}
+
+bool Transfer::resume()
+{
+	if (m_state != ErrorState || !QFile::exists(m_target))
+	{
+		return false;
+	}
+
+	m_isArchived = false;
+
+	if (m_bytesTotal == 0)
+	{
+		return restart();
+	}
+
+	const qint64 targetSize(QFileInfo(m_target).size());
+
+	if (m_bytesTotal > 0 && ((!m_segments.isEmpty() && targetSize != m_bytesTotal) || targetSize > m_bytesTotal))
+	{
+		return restart();
+	}
+
+	if (!m_segments.isEmpty())
+	{
+		QFile *file(new QFile(m_target));
+
+		if (!file->open(QIODevice::ReadWrite))
+		{
+			file->deleteLater();
+
+			return false;
+		}
+
+		m_state = RunningState;
+		m_device = file;
+		m_timeStarted = QDateTime::currentDateTimeUtc();
+		m_timeFinished = {};
+		m_bytesStart = 0;
+
+		connect(getWriter(), &TransferWriter::chunkWritten, this, &Transfer::handleChunkWritten, Qt::UniqueConnection);
+
+		startSegments();
+
+		if (m_updateTimer == 0 && m_updateInterval > 0)
+		{
+			m_updateTimer = startTimer(m_updateInterval);
+		}
+
+		return true;
+	}
+
+	QFile *file(new QFile(m_target));
+
+	if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		file->deleteLater();
+
+		return false;
+	}
+
+	m_state = RunningState;
+	m_device = file;
+	m_timeStarted = QDateTime::currentDateTimeUtc();
+	m_timeFinished = {};
+	m_bytesStart = file->size();
+
+	resetHashStates(m_bytesStart);
+
+	QNetworkRequest request;
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setRawHeader(QByteArrayLiteral("Range"), QStringLiteral("bytes=%1-").arg(file->size()).toLatin1());
+	request.setUrl(m_source);
+
+	applyValidators(request);
+
+	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(ReadBufferSize);
+
+	connect(getWriter(), &TransferWriter::chunkWritten, this, &Transfer::handleChunkWritten, Qt::UniqueConnection);
+
+	handleDataAvailable();
+
+	connect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
+	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
+	connect(m_reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &Transfer::handleDownloadError);
+
+	if (m_updateTimer == 0 && m_updateInterval > 0)
+	{
+		m_updateTimer = startTimer(m_updateInterval);
+	}
+
+	return true;
+}
+
+bool Transfer::restart()
+{
+	stop();
+	discardDevice();
+
+	m_segments.clear();
+	m_entityTag.clear();
+	m_lastModified.clear();
+
+	m_isArchived = false;
+
+	QFile *file(new QFile(m_target));
+
+	if (!file->open(QIODevice::WriteOnly))
+	{
+		file->deleteLater();
+
+		return false;
+	}
+
+	m_state = RunningState;
+	m_device = file;
+	m_timeStarted = QDateTime::currentDateTimeUtc();
+	m_timeFinished = {};
+	m_bytesStart = 0;
+
+	resetHashStates();
+
+	QNetworkRequest request;
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setHeader(QNetworkRequest::UserAgentHeader, NetworkManagerFactory::getUserAgent());
+	request.setUrl(m_source);
+
+	m_reply = NetworkManagerFactory::getNetworkManager(m_options.testFlag(IsPrivateOption))->get(request);
+	m_reply->setReadBufferSize(ReadBufferSize);
+
+	connect(getWriter(), &TransferWriter::chunkWritten, this, &Transfer::handleChunkWritten, Qt::UniqueConnection);
+
+	handleDataAvailable();
+
+	connect(m_reply, &QNetworkReply::downloadProgress, this, &Transfer::handleDownloadProgress);
+	connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+	connect(m_reply, &QNetworkReply::finished, this, &Transfer::handleDownloadFinished);
+	connect(m_reply, static_cast<void(QNetworkReply::*)(QNetworkReply::NetworkError)>(&QNetworkReply::error), this, &Transfer::handleDownloadError);
+
+	if (m_updateTimer == 0 && m_updateInterval > 0)
+	{
+		m_updateTimer = startTimer(m_updateInterval);
+	}
+
+	return true;
+}
+
+bool Transfer::setTarget(const QString &target, bool canOverwriteExisting)
+{
+	if (m_target == target)
+	{
+		return false;
+	}
+
+	QString mutableTarget(target);
+
+	if (!canOverwriteExisting && !m_options.testFlag(CanOverwriteOption) && QFile::exists(target))
+	{
+		const int result(QMessageBox::question(Application::getActiveWindow(), tr("Question"), tr("File with the same name already exists.\nDo you want to overwrite it?\n\n%1").arg(target), QMessageBox::Yes, QMessageBox::No, QMessageBox::Cancel));
+
+		if (result == QMessageBox::No)
+		{
+			const QFileInfo information(target);
+			const QString path(Utils::getSavePath(information.fileName(), information.path(), {}, true).path);
+
+			if (path.isEmpty())
+			{
+				cancel();
+
+				return false;
+			}
+
+			mutableTarget = path;
+		}
+		else if (result == QMessageBox::Cancel)
+		{
+			cancel();
+
+			return false;
+		}
+	}
+
+	if (!m_device)
+	{
+		if (m_state != FinishedState)
+		{
+			return false;
+		}
+
+		const bool isSuccess(QFile::rename(m_target, mutableTarget));
+
+		if (isSuccess)
+		{
+			m_target = mutableTarget;
+		}
+
+		return isSuccess;
+	}
+
+	QFile *file(new QFile(mutableTarget, this));
+
+	if (!file->open(QIODevice::WriteOnly))
+	{
+		m_state = ErrorState;
+
+		file->deleteLater();
+
+		if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
+		{
+			deleteLater();
+		}
+
+		return false;
+	}
+
+	m_target = mutableTarget;
+
+	if (m_device)
+	{
+		if (m_reply && m_state == RunningState)
+		{
+			disconnect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+		}
+
+		flushDevice();
+
+		m_device->reset();
+
+		file->write(m_device->readAll());
+
+		m_device->close();
+		m_device->deleteLater();
+	}
+
+	m_device = file;
+
+	handleDataAvailable();
+
+	if (!m_reply || m_reply->isFinished())
+	{
+		handleDownloadFinished();
+	}
+	else
+	{
+		connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+	}
+
+	return false;
+}
+
+TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
+	m_schedulerTimer(0),
+	m_notificationTimer(0)
+{
+}
+
+void TransfersManager::createInstance()
+{
+	if (!m_instance)
+	{
+		m_instance = new TransfersManager(QCoreApplication::instance());
+
+		PersistenceManager::registerTarget(m_instance, [](bool)
+		{
+			m_instance->save();
+
+			return true;
+		});
+	}
+}
+
+void TransfersManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_notificationTimer)
+	{
+		killTimer(m_notificationTimer);
+
+		m_notificationTimer = 0;
+
+		if (m_changedTransfers.isEmpty())
+		{
+			return;
+		}
+
+		QVector<Transfer*> transfers;
+		transfers.reserve(m_changedTransfers.count());
+
+		for (int i = 0; i < m_transfers.count(); ++i)
+		{
+			if (m_changedTransfers.contains(m_transfers.at(i)))
+			{
+				transfers.append(m_transfers.at(i));
+			}
+		}
+
+		m_changedTransfers.clear();
+
+		updateRunningTransfersState();
+
+		if (!transfers.isEmpty())
+		{
+			emit transfersModified(transfers);
+			emit transfersChanged();
+		}
+	}
+	else if (event->timerId() == m_schedulerTimer)
+	{
+		const qint64 elapsed(m_schedulerClock.restart());
+		const qint64 hostBandwidthLimit(getBandwidthLimit(SettingsManager::Browser_TransferHostBandwidthLimitOption));
+		QSet<QString> hosts;
+
+		m_bandwidthBucket.refill(elapsed, getBandwidthLimit(SettingsManager::Browser_TransferBandwidthLimitOption));
+
+		updateSchedule();
+
+		for (int i = 0; i < m_transfers.count(); ++i)
+		{
+			if (m_transfers.at(i)->getState() == Transfer::RunningState)
+			{
+				hosts.insert(m_transfers.at(i)->getSource().host());
+			}
+		}
+
+		QHash<QString, TokenBucket>::iterator iterator(m_hostBandwidthBuckets.begin());
+
+		while (iterator != m_hostBandwidthBuckets.end())
+		{
+			if (hostBandwidthLimit > 0 && hosts.contains(iterator.key()))
+			{
+				iterator.value().refill(elapsed, hostBandwidthLimit);
+
+				++iterator;
+			}
+			else
+			{
+				iterator = m_hostBandwidthBuckets.erase(iterator);
+			}
+		}
+
+		for (int i = 0; i < m_transfers.count(); ++i)
+		{
+			if (m_transfers.at(i)->getState() == Transfer::RunningState && !m_pausedTransfers.contains(m_transfers.at(i)))
+			{
+				m_transfers.at(i)->handleChunkWritten();
+			}
+		}
+
+		const bool isThrottling(!m_pausedTransfers.isEmpty() || m_bandwidthBucket.rate > 0 || hostBandwidthLimit > 0 || SettingsManager::getOption(SettingsManager::Browser_TransferYieldToBrowsingOption).toBool());
+
+		if (hosts.isEmpty() || !isThrottling)
+		{
+			killTimer(m_schedulerTimer);
+
+			m_schedulerTimer = 0;
+		}
+	}
+}
+
+void TransfersManager::scheduleSave()
+{
+	PersistenceManager::markAsDirty(this);
+}
+
+void TransfersManager::startScheduler()
+{
+	if (m_schedulerTimer == 0)
+	{
+		m_schedulerClock.start();
+
+		m_schedulerTimer = startTimer(SchedulerInterval);
+	}
+}
+
+void TransfersManager::updateRunningTransfersState()
+{
+	bool hasRunningTransfers(false);
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		if (m_transfers.at(i)->getState() == Transfer::RunningState)
+		{
+			hasRunningTransfers = true;
+
+			break;
+		}
+	}
+
+	m_hasRunningTransfers = hasRunningTransfers;
+
+	updateSchedule();
+}
+
+void TransfersManager::addTransfer(Transfer *transfer)
+{
+	if (!transfer)
+	{
+		return;
+	}
+
+	m_transfers.append(transfer);
+
+	if (transfer->m_identifier == 0)
+	{
+		transfer->m_identifier = ++m_identifiersCounter;
+	}
+	else
+	{
+		m_identifiersCounter = qMax(m_identifiersCounter, transfer->m_identifier);
+	}
+
+	if (m_isInitilized)
+	{
+		m_modifiedTransfers.insert(transfer);
+	}
+
+	transfer->setUpdateInterval(500);
+
+	connect(transfer, &Transfer::started, m_instance, &TransfersManager::handleTransferStarted);
+	connect(transfer, &Transfer::finished, m_instance, &TransfersManager::handleTransferFinished);
+	connect(transfer, &Transfer::changed, m_instance, &TransfersManager::handleTransferChanged);
+	connect(transfer, &Transfer::stopped, m_instance, &TransfersManager::handleTransferStopped);
+
+	if (transfer->getOptions().testFlag(Transfer::CanNotifyOption) && transfer->getState() != Transfer::CancelledState)
+	{
+		emit m_instance->transferStarted(transfer);
+		emit m_instance->transfersChanged();
+
+		if (transfer->getState() == Transfer::RunningState)
+		{
+			emit m_instance->transferFinished(transfer);
+		}
+	}
+
+	if (transfer->getOptions().testFlag(Transfer::IsPrivateOption))
+	{
+		m_privateTransfers.append(transfer);
+	}
+	else
+	{
+		const QString scheme(transfer->getSource().scheme());
+
+		if (scheme == QLatin1String("http") || scheme == QLatin1String("https"))
+		{
+			HistoryManager::addEntry(transfer->getSource());
+		}
+	}
+}
+
+void TransfersManager::save()
+{
+	if (SessionsManager::isReadOnly() || SettingsManager::getOption(SettingsManager::Browser_PrivateModeOption).toBool() || !SettingsManager::getOption(SettingsManager::History_RememberDownloadsOption).toBool())
+	{
+		m_modifiedTransfers.clear();
+		m_journalBuffer.clear();
+
+		return;
+	}
+
+	if (!m_isInitilized)
+	{
+		getTransfers();
+	}
+
+	for (int i = 0; i < m_transfers.count(); ++i)
+	{
+		if (m_transfers.at(i)->getState() == Transfer::RunningState && !m_privateTransfers.contains(m_transfers.at(i)))
+		{
+			m_transfers.at(i)->synchronizeDevice();
+		}
+	}
+
+	const QString path(SessionsManager::getWritableDataPath(QLatin1String("transfers.dat")));
+
+	if (m_needsCompaction || m_journalRecordsAmount > ((m_transfers.count() * 2) + 1000) || !QFile::exists(path))
+	{
+		QByteArray data;
+		QDataStream stream(&data, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_6);
+		stream << static_cast<quint32>(JournalMagicNumber) << static_cast<quint32>(JournalFormatVersion);
+
+		m_journalRecordsAmount = 0;
+
+		for (int i = 0; i < m_transfers.count(); ++i)
+		{
+			if (!m_privateTransfers.contains(m_transfers.at(i)))
+			{
+				writeJournalRecord(stream, EntryRecord, m_transfers.at(i));
+
+				++m_journalRecordsAmount;
+			}
+		}
+
+		m_modifiedTransfers.clear();
+		m_journalBuffer.clear();
+
+		m_needsCompaction = !writeJournal(path, data, false);
+
+		if (m_needsCompaction)
+		{
+			Console::addMessage(tr("Failed to save transfers history file"), Console::OtherCategory, Console::ErrorLevel, path);
+		}
+		else if (QFile::exists(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini"))))
+		{
+			QFile::remove(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")));
+		}
+
+		return;
+	}
+
+	if (!m_modifiedTransfers.isEmpty())
+	{
+		QDataStream stream(&m_journalBuffer, (QIODevice::WriteOnly | QIODevice::Append));
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		for (int i = 0; i < m_transfers.count(); ++i)
+		{
+			if (m_modifiedTransfers.contains(m_transfers.at(i)) && !m_privateTransfers.contains(m_transfers.at(i)))
+			{
+				writeJournalRecord(stream, EntryRecord, m_transfers.at(i));
+
+				++m_journalRecordsAmount;
+			}
+		}
+
+		m_modifiedTransfers.clear();
+	}
+
+	if (!m_journalBuffer.isEmpty())
+	{
+		if (!writeJournal(path, m_journalBuffer, true))
+		{
+			Console::addMessage(tr("Failed to save transfers history file"), Console::OtherCategory, Console::ErrorLevel, path);
+
+			m_needsCompaction = true;
+		}
+
+		m_journalBuffer.clear();
+	}
+}
+
+void TransfersManager::loadJournal()
+{
+	const int limit(SettingsManager::getOption(SettingsManager::History_DownloadsLimitPeriodOption).toInt());
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QString path(SessionsManager::getWritableDataPath(QLatin1String("transfers.dat")));
+	QMap<quint64, QVariantMap> records;
+	QFile file(path);
+
+	if (file.open(QIODevice::ReadOnly))
+	{
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		quint32 magicNumber(0);
+		quint32 formatVersion(0);
+
+		stream >> magicNumber >> formatVersion;
+
+		if (stream.status() != QDataStream::Ok || magicNumber != JournalMagicNumber || formatVersion != JournalFormatVersion)
+		{
+			Console::addMessage(tr("Failed to load transfers history file: unsupported format"), Console::OtherCategory, Console::ErrorLevel, path);
+
+			m_needsCompaction = true;
+		}
+		else
+		{
+			while (!stream.atEnd())
+			{
+				quint8 type(UnknownRecord);
+				quint64 identifier(0);
+
+				stream >> type >> identifier;
+
+				if (type == EntryRecord)
+				{
+					QVariantMap record;
+
+					stream >> record;
+
+					if (stream.status() != QDataStream::Ok)
+					{
+						break;
+					}
+
+					records[identifier] = record;
+				}
+				else if (type == RemoveRecord && stream.status() == QDataStream::Ok)
+				{
+					records.remove(identifier);
+				}
+				else
+				{
+					stream.setStatus(QDataStream::ReadCorruptData);
 
-	if (!canOverwriteExisting && !m_options.testFlag(CanOverwriteOption) && QFile::exists(target))
-	{
-		const int result(QMessageBox::question(Application::getActiveWindow(), tr("Question"), tr("File with the same name already exists.\nDo you want to overwrite it?\n\n%1").arg(target), QMessageBox::Yes, QMessageBox::No, QMessageBox::Cancel));
+					break;
+				}
 
-		if (result == QMessageBox::No)
-		{
-			const QFileInfo information(target);
-			const QString path(Utils::getSavePath(information.fileName(), information.path(), {}, true).path);
+				++m_journalRecordsAmount;
+			}
 
-			if (path.isEmpty())
+			if (stream.status() != QDataStream::Ok)
 			{
-				cancel();
+				Console::addMessage(tr("Transfers history file is damaged, trailing records were discarded"), Console::OtherCategory, Console::WarningLevel, path);
 
-				return false;
+				m_needsCompaction = true;
 			}
-
-			mutableTarget = path;
 		}
-		else if (result == QMessageBox::Cancel)
-		{
-			cancel();
 
-			return false;
-		}
+		file.close();
 	}
-
-	if (!m_device)
+	else
 	{
-		if (m_state != FinishedState)
-		{
-			return false;
-		}
-
-		const bool isSuccess(QFile::rename(m_target, mutableTarget));
+		QSettings history(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")), QSettings::IniFormat);
+		const QStringList entries(history.childGroups());
 
-		if (isSuccess)
+		for (int i = 0; i < entries.count(); ++i)
 		{
-			m_target = mutableTarget;
-		}
+			QVariantMap record;
 
-		return isSuccess;
-	}
+			history.beginGroup(entries.at(i));
 
-	QFile *file(new QFile(mutableTarget, this));
+			const QStringList keys(history.childKeys());
 
-	if (!file->open(QIODevice::WriteOnly))
-	{
-		m_state = ErrorState;
+			for (int j = 0; j < keys.count(); ++j)
+			{
+				record[keys.at(j)] = history.value(keys.at(j));
+			}
 
-		file->deleteLater();
+			history.endGroup();
 
-		if (m_options.testFlag(CanAutoDeleteOption) && !m_isSelectingPath)
-		{
-			deleteLater();
+			records[static_cast<quint64>(i + 1)] = record;
 		}
 
-		return false;
+		m_needsCompaction = !records.isEmpty();
 	}
 
-	m_target = mutableTarget;
+	m_transfers.reserve(records.count());
 
-	if (m_device)
+	QMap<quint64, QVariantMap>::const_iterator iterator;
+
+	for (iterator = records.constBegin(); iterator != records.constEnd(); ++iterator)
 	{
-		if (m_reply && m_state == RunningState)
+		if (iterator.value().value(QLatin1String("source")).toString().isEmpty() || iterator.value().value(QLatin1String("target")).toString().isEmpty())
 		{
-			disconnect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+			continue;
 		}
 
-		m_device->reset();
+		Transfer *transfer(new Transfer(iterator.value(), m_instance));
 
-		file->write(m_device->readAll());
+		if (transfer->getState() == Transfer::FinishedState && transfer->getTimeFinished().isValid() && transfer->getTimeFinished().daysTo(currentDateTime) > limit)
+		{
+			transfer->deleteLater();
 
-		m_device->close();
-		m_device->deleteLater();
-	}
+			m_needsCompaction = true;
 
-	m_device = file;
+			continue;
+		}
 
-	handleDataAvailable();
+		transfer->m_identifier = iterator.key();
 
-	if (!m_reply || m_reply->isFinished())
-	{
-		handleDownloadFinished();
-	}
-	else
-	{
-		connect(m_reply, &QNetworkReply::readyRead, this, &Transfer::handleDataAvailable);
+		addTransfer(transfer);
 	}
-
-	return false;
 }
 
-TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
-	m_saveTimer(0)
+void TransfersManager::writeJournalRecord(QDataStream &stream, JournalRecordType type, const Transfer *transfer)
 {
-}
+	stream << static_cast<quint8>(type) << transfer->getIdentifier();
 
-void TransfersManager::createInstance()
-{
-	if (!m_instance)
+	if (type != EntryRecord)
 	{
-		m_instance = new TransfersManager(QCoreApplication::instance());
+		return;
 	}
-}
-
-void TransfersManager::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_saveTimer)
-	{
-		killTimer(m_saveTimer);
 
-		m_saveTimer = 0;
-
-		save();
-	}
-}
+	QVariantMap record({{QLatin1String("source"), transfer->getSource().toString()}, {QLatin1String("target"), transfer->getTarget()}, {QLatin1String("timeStarted"), transfer->getTimeStarted()}, {QLatin1String("timeFinished"), ((transfer->getTimeFinished().isValid() && transfer->getState() != Transfer::RunningState) ? transfer->getTimeFinished() : QDateTime::currentDateTimeUtc())}, {QLatin1String("bytesTotal"), transfer->getBytesTotal()}, {QLatin1String("bytesReceived"), transfer->getBytesReceived()}});
 
-void TransfersManager::scheduleSave()
-{
-	if (Application::isAboutToQuit())
+	if (transfer->getState() != Transfer::FinishedState)
 	{
-		if (m_saveTimer != 0)
+		const QStringList segments(transfer->getSegments());
+
+		if (!segments.isEmpty())
 		{
-			killTimer(m_saveTimer);
+			record[QLatin1String("segments")] = segments;
+		}
 
-			m_saveTimer = 0;
+		if (!transfer->m_entityTag.isEmpty())
+		{
+			record[QLatin1String("entityTag")] = transfer->m_entityTag;
 		}
 
-		save();
-	}
-	else if (m_saveTimer == 0)
-	{
-		m_saveTimer = startTimer(1000);
+		if (!transfer->m_lastModified.isEmpty())
+		{
+			record[QLatin1String("lastModified")] = transfer->m_lastModified;
+		}
 	}
+
+	stream << record;
 }
 
-void TransfersManager::updateRunningTransfersState()
+void TransfersManager::clearTransfers(int period)
 {
-	bool hasRunningTransfers(false);
-
-	for (int i = 0; i < m_transfers.count(); ++i)
+	for (int i = (m_transfers.count() - 1); i >= 0; --i)
 	{
-		if (m_transfers.at(i)->getState() == Transfer::RunningState)
+		if (m_transfers.at(i)->getState() == Transfer::FinishedState && (period == 0 || (m_transfers.at(i)->getTimeFinished().isValid() && m_transfers.at(i)->getTimeFinished().secsTo(QDateTime::currentDateTimeUtc()) > (period * 3600))))
 		{
-			hasRunningTransfers = true;
-
-			break;
+			TransfersManager::removeTransfer(m_transfers.at(i));
 		}
 	}
-
-	m_hasRunningTransfers = hasRunningTransfers;
 }
 
-void TransfersManager::addTransfer(Transfer *transfer)
+void TransfersManager::consumeBandwidth(const Transfer *transfer, qint64 amount)
 {
-	if (!transfer)
+	if (amount <= 0)
 	{
 		return;
 	}
 
-	m_transfers.append(transfer);
-
-	transfer->setUpdateInterval(500);
-
-	connect(transfer, &Transfer::started, m_instance, &TransfersManager::handleTransferStarted);
-	connect(transfer, &Transfer::finished, m_instance, &TransfersManager::handleTransferFinished);
-	connect(transfer, &Transfer::changed, m_instance, &TransfersManager::handleTransferChanged);
-	connect(transfer, &Transfer::stopped, m_instance, &TransfersManager::handleTransferStopped);
-
-	if (transfer->getOptions().testFlag(Transfer::CanNotifyOption) && transfer->getState() != Transfer::CancelledState)
+	if (m_bandwidthBucket.rate > 0)
 	{
-		emit m_instance->transferStarted(transfer);
-		emit m_instance->transfersChanged();
-
-		if (transfer->getState() == Transfer::RunningState)
-		{
-			emit m_instance->transferFinished(transfer);
-		}
+		m_bandwidthBucket.tokens = qMax(qint64(0), (m_bandwidthBucket.tokens - amount));
 	}
 
-	if (transfer->getOptions().testFlag(Transfer::IsPrivateOption))
-	{
-		m_privateTransfers.append(transfer);
-	}
-	else
-	{
-		const QString scheme(transfer->getSource().scheme());
+	const QString host(transfer->getSource().host());
 
-		if (scheme == QLatin1String("http") || scheme == QLatin1String("https"))
-		{
-			HistoryManager::addEntry(transfer->getSource());
-		}
+	if (m_hostBandwidthBuckets.contains(host))
+	{
+		TokenBucket &bucket(m_hostBandwidthBuckets[host]);
+		bucket.tokens = qMax(qint64(0), (bucket.tokens - amount));
 	}
 }
 
-void TransfersManager::save()
+void TransfersManager::updateSchedule()
 {
-	if (SessionsManager::isReadOnly() || SettingsManager::getOption(SettingsManager::Browser_PrivateModeOption).toBool() || !SettingsManager::getOption(SettingsManager::History_RememberDownloadsOption).toBool())
+	QVector<Transfer*> transfers;
+
+	for (int i = 0; i < m_transfers.count(); ++i)
 	{
-		return;
+		if (m_transfers.at(i)->getState() == Transfer::RunningState)
+		{
+			transfers.append(m_transfers.at(i));
+		}
 	}
 
-	QSettings history(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")), QSettings::IniFormat);
-	history.clear();
+	std::stable_sort(transfers.begin(), transfers.end(), [&](Transfer *first, Transfer *second)
+	{
+		return (first->getPriority() > second->getPriority());
+	});
 
-	const int limit(SettingsManager::getOption(SettingsManager::History_DownloadsLimitPeriodOption).toInt());
-	int entry(1);
+	const int limit(SettingsManager::getOption(SettingsManager::Browser_TransferConcurrencyLimitOption).toInt());
+	const bool hasToYield(SettingsManager::getOption(SettingsManager::Browser_TransferYieldToBrowsingOption).toBool() && isForegroundLoading());
+	QSet<Transfer*> pausedTransfers;
 
-	for (int i = 0; i < m_transfers.count(); ++i)
+	for (int i = 0; i < transfers.count(); ++i)
 	{
-		if (m_privateTransfers.contains(m_transfers.at(i)) || (m_transfers.at(i)->getState() == Transfer::FinishedState && m_transfers.at(i)->getTimeFinished().isValid() && m_transfers.at(i)->getTimeFinished().daysTo(QDateTime::currentDateTimeUtc()) > limit))
+		if ((limit > 0 && i >= limit) || (hasToYield && transfers.at(i)->getPriority() != Transfer::HighPriority))
 		{
-			continue;
+			pausedTransfers.insert(transfers.at(i));
 		}
+	}
 
-		history.setValue(QStringLiteral("%1/source").arg(entry), m_transfers.at(i)->getSource().toString());
-		history.setValue(QStringLiteral("%1/target").arg(entry), m_transfers.at(i)->getTarget());
-		history.setValue(QStringLiteral("%1/timeStarted").arg(entry), m_transfers.at(i)->getTimeStarted().toString(Qt::ISODate));
-		history.setValue(QStringLiteral("%1/timeFinished").arg(entry), ((m_transfers.at(i)->getTimeFinished().isValid() && m_transfers.at(i)->getState() != Transfer::RunningState) ? m_transfers.at(i)->getTimeFinished() : QDateTime::currentDateTimeUtc()).toString(Qt::ISODate));
-		history.setValue(QStringLiteral("%1/bytesTotal").arg(entry), m_transfers.at(i)->getBytesTotal());
-		history.setValue(QStringLiteral("%1/bytesReceived").arg(entry), m_transfers.at(i)->getBytesReceived());
+	m_pausedTransfers = pausedTransfers;
 
-		++entry;
+	if (m_instance && (!m_pausedTransfers.isEmpty() || (hasToYield && !transfers.isEmpty())))
+	{
+		m_instance->startScheduler();
 	}
-
-	history.sync();
 }
 
-void TransfersManager::clearTransfers(int period)
+void TransfersManager::releaseConnection()
 {
-	for (int i = (m_transfers.count() - 1); i >= 0; --i)
+	if (m_connectionsAmount > 0)
 	{
-		if (m_transfers.at(i)->getState() == Transfer::FinishedState && (period == 0 || (m_transfers.at(i)->getTimeFinished().isValid() && m_transfers.at(i)->getTimeFinished().secsTo(QDateTime::currentDateTimeUtc()) > (period * 3600))))
-		{
-			TransfersManager::removeTransfer(m_transfers.at(i));
-		}
+		--m_connectionsAmount;
 	}
 }
 
@@ -1122,6 +2432,8 @@ void TransfersManager::handleTransferStarted()
 			m_hasRunningTransfers = true;
 		}
 
+		m_modifiedTransfers.insert(transfer);
+
 		emit transferStarted(transfer);
 		emit transfersChanged();
 
@@ -1157,6 +2469,8 @@ void TransfersManager::handleTransferFinished()
 
 		if (!m_privateTransfers.contains(transfer))
 		{
+			m_modifiedTransfers.insert(transfer);
+
 			scheduleSave();
 		}
 	}
@@ -1168,11 +2482,15 @@ void TransfersManager::handleTransferChanged()
 
 	if (transfer)
 	{
+		m_modifiedTransfers.insert(transfer);
+		m_changedTransfers.insert(transfer);
+
 		scheduleSave();
-		updateRunningTransfersState();
 
-		emit transferChanged(transfer);
-		emit transfersChanged();
+		if (m_notificationTimer == 0)
+		{
+			m_notificationTimer = startTimer(NotificationInterval);
+		}
 	}
 }
 
@@ -1184,6 +2502,8 @@ void TransfersManager::handleTransferStopped()
 
 	if (transfer)
 	{
+		m_modifiedTransfers.insert(transfer);
+
 		emit transferStopped(transfer);
 		emit transfersChanged();
 
@@ -1257,22 +2577,7 @@ QVector<Transfer*> TransfersManager::getTransfers()
 {
 	if (!m_isInitilized)
 	{
-		QSettings history(SessionsManager::getWritableDataPath(QLatin1String("transfers.ini")), QSettings::IniFormat);
-		const QStringList entries(history.childGroups());
-
-		m_transfers.reserve(entries.count());
-
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			history.beginGroup(entries.at(i));
-
-			if (!history.value(QLatin1String("source")).toString().isEmpty() && !history.value(QLatin1String("target")).toString().isEmpty())
-			{
-				addTransfer(new Transfer(history, m_instance));
-			}
-
-			history.endGroup();
-		}
+		loadJournal();
 
 		m_isInitilized = true;
 
@@ -1314,6 +2619,58 @@ TransfersManager::ActiveTransfersInformation TransfersManager::getActiveTransfer
 	return information;
 }
 
+qint64 TransfersManager::getBandwidthLimit(SettingsManager::OptionIdentifier identifier)
+{
+	return (qMax(0, SettingsManager::getOption(identifier).toInt()) * qint64(1024));
+}
+
+qint64 TransfersManager::getBandwidthAllowance(const Transfer *transfer)
+{
+	if (m_pausedTransfers.contains(const_cast<Transfer*>(transfer)))
+	{
+		return 0;
+	}
+
+	const qint64 bandwidthLimit(getBandwidthLimit(SettingsManager::Browser_TransferBandwidthLimitOption));
+	const qint64 hostBandwidthLimit(getBandwidthLimit(SettingsManager::Browser_TransferHostBandwidthLimitOption));
+
+	if (bandwidthLimit == 0 && hostBandwidthLimit == 0)
+	{
+		return -1;
+	}
+
+	if (m_instance)
+	{
+		m_instance->startScheduler();
+	}
+
+	qint64 allowance(-1);
+
+	if (bandwidthLimit > 0)
+	{
+		if (m_bandwidthBucket.rate != bandwidthLimit)
+		{
+			m_bandwidthBucket.refill(0, bandwidthLimit);
+		}
+
+		allowance = m_bandwidthBucket.tokens;
+	}
+
+	if (hostBandwidthLimit > 0)
+	{
+		TokenBucket &bucket(m_hostBandwidthBuckets[transfer->getSource().host()]);
+
+		if (bucket.rate != hostBandwidthLimit)
+		{
+			bucket.refill(0, hostBandwidthLimit);
+		}
+
+		allowance = ((allowance < 0) ? bucket.tokens : qMin(allowance, bucket.tokens));
+	}
+
+	return allowance;
+}
+
 bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 {
 	if (!transfer || !m_transfers.contains(transfer))
@@ -1323,7 +2680,21 @@ bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 
 	m_transfers.removeAll(transfer);
 
-	m_privateTransfers.removeAll(transfer);
+	m_pausedTransfers.remove(transfer);
+	m_modifiedTransfers.remove(transfer);
+	m_changedTransfers.remove(transfer);
+
+	if (!m_privateTransfers.removeAll(transfer))
+	{
+		QDataStream stream(&m_journalBuffer, (QIODevice::WriteOnly | QIODevice::Append));
+		stream.setVersion(QDataStream::Qt_5_6);
+
+		writeJournalRecord(stream, RemoveRecord, transfer);
+
+		++m_journalRecordsAmount;
+
+		m_instance->scheduleSave();
+	}
 
 	if (transfer->getState() == Transfer::RunningState)
 	{
@@ -1343,6 +2714,18 @@ bool TransfersManager::removeTransfer(Transfer *transfer, bool keepFile)
 	return true;
 }
 
+bool TransfersManager::reserveConnection()
+{
+	if (m_connectionsAmount >= SettingsManager::getOption(SettingsManager::Browser_TransferConnectionsLimitOption).toInt())
+	{
+		return false;
+	}
+
+	++m_connectionsAmount;
+
+	return true;
+}
+
 bool TransfersManager::isDownloading(const QString &source, const QString &target)
 {
 	if (source.isEmpty() && target.isEmpty())
@@ -1376,6 +2759,45 @@ bool TransfersManager::isDownloading(const QString &source, const QString &targe
 	return false;
 }
 
+bool TransfersManager::writeJournal(const QString &path, const QByteArray &data, bool isAppending)
+{
+	if (isAppending)
+	{
+		QFile file(path);
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+		{
+			return false;
+		}
+
+		return (file.write(data) == data.size() && file.flush());
+	}
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	if (file.write(data) != data.size())
+	{
+		file.cancelWriting();
+
+		return false;
+	}
+
+	return file.commit();
+}
+
+bool TransfersManager::isForegroundLoading()
+{
+	const MainWindow *mainWindow(Application::getActiveWindow());
+	const Window *window(mainWindow ? mainWindow->getActiveWindow() : nullptr);
+
+	return (window && window->getLoadingState() == WebWidget::OngoingLoadingState);
+}
+
 bool TransfersManager::hasRunningTransfers()
 {
 	return m_hasRunningTransfers;
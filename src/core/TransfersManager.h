@@ -20,11 +20,18 @@
 #ifndef OTTER_TRANSFERSMANAGER_H
 #define OTTER_TRANSFERSMANAGER_H
 
+#include "SettingsManager.h"
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtCore/QMimeType>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QQueue>
-#include <QtCore/QSettings>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QVariantMap>
+#include <QtCore/QWaitCondition>
 #include <QtNetwork/QNetworkReply>
 
 namespace Otter
@@ -32,6 +39,51 @@ namespace Otter
 
 class NetworkManager;
 
+class TransferWriter final : public QThread
+{
+	Q_OBJECT
+
+public:
+	explicit TransferWriter(QObject *parent = nullptr);
+	~TransferWriter();
+
+	void flush(QIODevice *device);
+	void discard(QIODevice *device);
+	qint64 write(QIODevice *source, QIODevice *device, qint64 offset = -1, qint64 limit = -1, const QVector<QCryptographicHash*> &hashes = {});
+
+protected:
+	enum ChunkParameter
+	{
+		ChunkSize = 262144,
+		ChunksAmount = 16
+	};
+
+	struct Chunk final
+	{
+		QByteArray data;
+		QVector<QCryptographicHash*> hashes;
+		QIODevice *device = nullptr;
+		qint64 offset = -1;
+		qint64 size = 0;
+	};
+
+	void run() override;
+	bool hasPendingChunks(QIODevice *device) const;
+
+private:
+	QVector<Chunk> m_chunks;
+	QQueue<int> m_pendingChunks;
+	QVector<int> m_freeChunks;
+	QMutex m_mutex;
+	QWaitCondition m_pendingCondition;
+	QWaitCondition m_writtenCondition;
+	int m_activeChunk;
+	bool m_isStopping;
+
+signals:
+	void chunkWritten();
+};
+
 class Transfer : public QObject
 {
 	Q_OBJECT
@@ -60,9 +112,17 @@ public:
 		FinishedState
 	};
 
+	enum TransferPriority
+	{
+		LowPriority = 0,
+		NormalPriority,
+		HighPriority
+	};
+
 	~Transfer();
 
 	void setHash(const QByteArray &hash, QCryptographicHash::Algorithm algorithm);
+	void setPriority(TransferPriority priority);
 	virtual void setUpdateInterval(int interval);
 	virtual QUrl getSource() const;
 	virtual QString getSuggestedFileName();
@@ -71,11 +131,14 @@ public:
 	virtual QDateTime getTimeStarted() const;
 	virtual QDateTime getTimeFinished() const;
 	virtual QMimeType getMimeType() const;
+	QStringList getSegments() const;
 	virtual qint64 getSpeed() const;
 	virtual qint64 getBytesReceived() const;
 	virtual qint64 getBytesTotal() const;
 	TransferOptions getOptions() const;
+	TransferPriority getPriority() const;
 	virtual TransferState getState() const;
+	quint64 getIdentifier() const;
 	virtual int getRemainingTime() const;
 	bool verifyHashes() const;
 	bool isArchived() const;
@@ -90,17 +153,57 @@ public slots:
 	virtual bool setTarget(const QString &target, bool canOverwriteExisting = false);
 
 protected:
+	enum BufferParameter
+	{
+		ReadBufferSize = 1048576
+	};
+
+	enum SegmentParameter
+	{
+		SegmentMinimumSize = 1048576,
+		SegmentRetriesLimit = 3
+	};
+
+	struct Segment final
+	{
+		QPointer<QNetworkReply> reply;
+		qint64 position = 0;
+		qint64 end = -1;
+		int retries = 0;
+		bool isReserved = false;
+	};
+
 	explicit Transfer(TransferOptions options = CanAskForPathOption, QObject *parent = nullptr);
-	explicit Transfer(const QSettings &settings, QObject *parent = nullptr);
+	explicit Transfer(const QVariantMap &information, QObject *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
 	void start(QNetworkReply *reply, const QString &target);
+	void flushDevice();
+	void discardDevice();
+	void synchronizeDevice();
+	void updateValidators();
+	void applyValidators(QNetworkRequest &request) const;
+	void writeData(const QByteArray &data);
+	void writeReplyData();
+	void resetHashStates(qint64 prefixSize = 0);
+	void clearHashStates();
+	void startSegmentation();
+	void startSegments();
+	void abortSegments();
+	void writeSegmentData(int index, bool canThrottle = true);
+	void finishSegment(int index);
+	void finishSegments();
+	static TransferWriter* getWriter();
+	int getSegmentIndex(const QNetworkReply *reply) const;
+	bool canSegment() const;
+	bool hasValidators() const;
 
 protected slots:
 	void markAsStarted();
 	void markAsFinished();
 	void handleDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
 	void handleDataAvailable();
+	void handleChunkWritten();
 	void handleDownloadFinished();
 	void handleDownloadError(QNetworkReply::NetworkError error);
 
@@ -111,24 +214,33 @@ private:
 	QString m_target;
 	QString m_openCommand;
 	QString m_suggestedFileName;
+	QByteArray m_entityTag;
+	QByteArray m_lastModified;
 	QDateTime m_timeStarted;
 	QDateTime m_timeFinished;
 	QMimeType m_mimeType;
 	QHash<QCryptographicHash::Algorithm, QByteArray> m_hashes;
+	QHash<QCryptographicHash::Algorithm, QCryptographicHash*> m_hashStates;
+	QVector<Segment> m_segments;
 	QQueue<qint64> m_speeds;
 	qint64 m_speed;
 	qint64 m_bytesStart;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
+	quint64 m_identifier;
 	TransferOptions m_options;
+	TransferPriority m_priority;
 	TransferState m_state;
 	int m_updateTimer;
 	int m_updateInterval;
 	int m_remainingTime;
+	bool m_hasPendingProgress;
 	bool m_isSelectingPath;
 	bool m_isArchived;
 
+	static QPointer<TransferWriter> m_writer;
+
 signals:
 	void progressChanged(qint64 bytesReceived, qint64 bytesTotal);
 	void started();
@@ -155,22 +267,77 @@ public:
 	static void createInstance();
 	static void addTransfer(Transfer *transfer);
 	static void clearTransfers(int period = 0);
+	static void releaseConnection();
 	static TransfersManager* getInstance();
 	static Transfer* startTransfer(const QUrl &source, const QString &target = {}, Transfer::TransferOptions options = Transfer::CanAskForPathOption);
 	static Transfer* startTransfer(const QNetworkRequest &request, const QString &target = {}, Transfer::TransferOptions options = Transfer::CanAskForPathOption);
 	static Transfer* startTransfer(QNetworkReply *reply, const QString &target = {}, Transfer::TransferOptions options = Transfer::CanAskForPathOption);
 	static QVector<Transfer*> getTransfers();
 	static ActiveTransfersInformation getActiveTransfersInformation();
+	static void consumeBandwidth(const Transfer *transfer, qint64 amount);
+	static void updateSchedule();
+	static qint64 getBandwidthAllowance(const Transfer *transfer);
 	static bool removeTransfer(Transfer *transfer, bool keepFile = true);
+	static bool reserveConnection();
 	static bool isDownloading(const QString &source, const QString &target = {});
 	static bool hasRunningTransfers();
 
 protected:
+	enum JournalFormat : quint32
+	{
+		JournalMagicNumber = 0x4F54524A,
+		JournalFormatVersion = 1
+	};
+
+	enum JournalRecordType : quint8
+	{
+		UnknownRecord = 0,
+		EntryRecord,
+		RemoveRecord
+	};
+
+	enum SchedulerParameter
+	{
+		SchedulerInterval = 100,
+		NotificationInterval = 250,
+		MinimumBucketCapacity = 16384
+	};
+
+	struct TokenBucket final
+	{
+		qint64 tokens = 0;
+		qint64 rate = 0;
+
+		void refill(qint64 elapsed, qint64 limit)
+		{
+			if (rate != limit)
+			{
+				rate = limit;
+				tokens = getCapacity();
+
+				return;
+			}
+
+			tokens = qMin((tokens + ((rate * elapsed) / 1000)), getCapacity());
+		}
+
+		qint64 getCapacity() const
+		{
+			return qMax((rate / 4), qint64(MinimumBucketCapacity));
+		}
+	};
+
 	explicit TransfersManager(QObject *parent);
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	void startScheduler();
 	void updateRunningTransfersState();
+	static void loadJournal();
+	static void writeJournalRecord(QDataStream &stream, JournalRecordType type, const Transfer *transfer);
+	static qint64 getBandwidthLimit(SettingsManager::OptionIdentifier identifier);
+	static bool writeJournal(const QString &path, const QByteArray &data, bool isAppending);
+	static bool isForegroundLoading();
 
 protected slots:
 	void save();
@@ -180,18 +347,30 @@ protected slots:
 	void handleTransferStopped();
 
 private:
-	int m_saveTimer;
+	QElapsedTimer m_schedulerClock;
+	int m_schedulerTimer;
+	int m_notificationTimer;
 
 	static TransfersManager *m_instance;
 	static QVector<Transfer*> m_transfers;
 	static QVector<Transfer*> m_privateTransfers;
+	static QSet<Transfer*> m_modifiedTransfers;
+	static QSet<Transfer*> m_changedTransfers;
+	static QSet<Transfer*> m_pausedTransfers;
+	static QHash<QString, TokenBucket> m_hostBandwidthBuckets;
+	static TokenBucket m_bandwidthBucket;
+	static QByteArray m_journalBuffer;
+	static quint64 m_identifiersCounter;
+	static int m_connectionsAmount;
+	static int m_journalRecordsAmount;
+	static bool m_needsCompaction;
 	static bool m_isInitilized;
 	static bool m_hasRunningTransfers;
 
 signals:
 	void transferStarted(Transfer *transfer);
 	void transferFinished(Transfer *transfer);
-	void transferChanged(Transfer *transfer);
+	void transfersModified(const QVector<Transfer*> &transfers);
 	void transferStopped(Transfer *transfer);
 	void transferRemoved(Transfer *transfer);
 	void transfersChanged();
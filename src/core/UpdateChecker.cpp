@@ -102,6 +102,17 @@ UpdateChecker::UpdateChecker(QObject *parent, bool isInBackground) : QObject(par
 						information.detailsUrl = QUrl(channelObject.value(QLatin1String("detailsUrl")).toString());
 						information.scriptUrl = QUrl(channelObject.value(QLatin1String("scriptUrl")).toString().replace(QLatin1String("%VERSION%"), channelVersion).replace(QLatin1String("%PLATFORM%"), platform));
 						information.fileUrl = QUrl(channelObject.value(QLatin1String("fileUrl")).toString().replace(QLatin1String("%VERSION%"), channelVersion).replace(QLatin1String("%PLATFORM%"), platform).replace(QLatin1String("%TIMESTAMP%"), QString::number(QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() / 1000)));
+						information.fileHash = QByteArray::fromHex(readPlatformValue(channelObject.value(QLatin1String("fileHash")), platform).toLatin1());
+
+						if (channelObject.contains(QLatin1String("deltaFileUrl")) && channelObject.contains(QLatin1String("deltaScriptUrl")))
+						{
+							const QString installedVersion(QCoreApplication::applicationVersion());
+							const QString installedSubVersion(QString::number(subVersion));
+
+							information.deltaScriptUrl = QUrl(channelObject.value(QLatin1String("deltaScriptUrl")).toString().replace(QLatin1String("%VERSION%"), channelVersion).replace(QLatin1String("%PLATFORM%"), platform).replace(QLatin1String("%INSTALLED_VERSION%"), installedVersion).replace(QLatin1String("%INSTALLED_SUBVERSION%"), installedSubVersion));
+							information.deltaFileUrl = QUrl(channelObject.value(QLatin1String("deltaFileUrl")).toString().replace(QLatin1String("%VERSION%"), channelVersion).replace(QLatin1String("%PLATFORM%"), platform).replace(QLatin1String("%INSTALLED_VERSION%"), installedVersion).replace(QLatin1String("%INSTALLED_SUBVERSION%"), installedSubVersion).replace(QLatin1String("%TIMESTAMP%"), QString::number(QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() / 1000)));
+							information.deltaFileHash = QByteArray::fromHex(readPlatformValue(channelObject.value(QLatin1String("deltaFileHash")), platform).toLatin1());
+						}
 
 						if (!channelObject.value(QLatin1String("subVersion")).toString().isEmpty())
 						{
@@ -130,4 +141,14 @@ UpdateChecker::UpdateChecker(QObject *parent, bool isInBackground) : QObject(par
 	job->start();
 }
 
+QString UpdateChecker::readPlatformValue(const QJsonValue &value, const QString &platform)
+{
+	if (value.isObject())
+	{
+		return value.toObject().value(platform).toString();
+	}
+
+	return value.toString();
+}
+
 }
@@ -23,6 +23,8 @@
 
 #include "SessionsManager.h"
 
+#include <QtCore/QJsonValue>
+
 namespace Otter
 {
 
@@ -38,11 +40,23 @@ public:
 		QUrl detailsUrl;
 		QUrl scriptUrl;
 		QUrl fileUrl;
+		QUrl deltaScriptUrl;
+		QUrl deltaFileUrl;
+		QByteArray fileHash;
+		QByteArray deltaFileHash;
 		bool isAvailable = false;
+
+		bool hasDelta() const
+		{
+			return (deltaScriptUrl.isValid() && deltaFileUrl.isValid());
+		}
 	};
 
 	explicit UpdateChecker(QObject *parent = nullptr, bool isInBackground = true);
 
+protected:
+	static QString readPlatformValue(const QJsonValue &value, const QString &platform);
+
 signals:
 	void finished(const QVector<UpdateChecker::UpdateInformation> &availableUpdates, int latestVersionIndex);
 };
@@ -27,21 +27,25 @@
 #include <QtCore/QDir>
 #include <QtCore/QtMath>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
 
 namespace Otter
 {
 
-Updater::Updater(const UpdateChecker::UpdateInformation &information, QObject *parent) : QObject(parent),
+Updater::Updater(const UpdateChecker::UpdateInformation &information, QObject *parent, bool isInBackground) : QObject(parent),
 	m_transfer(nullptr),
+	m_information(information),
+	m_path(QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QLatin1String("/OtterBrowser/")),
 	m_transfersCount(0),
+	m_isDelta(false),
+	m_isInBackground(isInBackground),
 	m_transfersSuccessful(true)
 {
-	const QString path(QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QLatin1String("/OtterBrowser/"));
-	QDir directory(path);
+	QDir directory(m_path);
 
 	if (!directory.exists())
 	{
-		QDir().mkdir(path);
+		QDir().mkdir(m_path);
 	}
 	else if (directory.entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries).count() > 0)
 	{
@@ -55,10 +59,19 @@ Updater::Updater(const UpdateChecker::UpdateInformation &information, QObject *p
 	}
 
 	clearUpdate();
+	startDownload(m_information.hasDelta());
+}
+
+void Updater::startDownload(bool isDelta)
+{
+	m_isDelta = isDelta;
+	m_transfersCount = 0;
+	m_transfersSuccessful = true;
+	m_scriptPath.clear();
 
-	downloadFile(information.scriptUrl, path);
+	const Transfer *scriptTransfer(downloadFile((isDelta ? m_information.deltaScriptUrl : m_information.scriptUrl)));
 
-	m_transfer = downloadFile(information.fileUrl, path);
+	m_transfer = downloadFile((isDelta ? m_information.deltaFileUrl : m_information.fileUrl), (isDelta ? m_information.deltaFileHash : m_information.fileHash));
 
 	if (m_transfer)
 	{
@@ -66,6 +79,17 @@ Updater::Updater(const UpdateChecker::UpdateInformation &information, QObject *p
 
 		connect(m_transfer, &Transfer::progressChanged, this, &Updater::updateProgress);
 	}
+
+	if (!scriptTransfer || !m_transfer)
+	{
+		m_transfersCount += ((scriptTransfer ? 0 : 1) + (m_transfer ? 0 : 1));
+		m_transfersSuccessful = false;
+
+		if (m_transfersCount == 2)
+		{
+			QTimer::singleShot(0, this, &Updater::finishUpdate);
+		}
+	}
 }
 
 void Updater::handleTransferFinished()
@@ -80,15 +104,7 @@ void Updater::handleTransferFinished()
 		{
 			if (QFileInfo(path).suffix() == QLatin1String("xml"))
 			{
-				QFile file(SessionsManager::getWritableDataPath(QLatin1String("update.txt")));
-
-				if (file.open(QIODevice::ReadWrite | QIODevice::Text))
-				{
-					QTextStream stream(&file);
-					stream << path;
-
-					file.close();
-				}
+				m_scriptPath = path;
 			}
 		}
 		else
@@ -98,6 +114,11 @@ void Updater::handleTransferFinished()
 			m_transfersSuccessful = false;
 		}
 
+		if (transfer == m_transfer)
+		{
+			m_transfer = nullptr;
+		}
+
 		transfer->deleteLater();
 	}
 	else
@@ -109,15 +130,45 @@ void Updater::handleTransferFinished()
 
 	if (m_transfersCount == 2)
 	{
-		if (!m_transfersSuccessful)
+		finishUpdate();
+	}
+}
+
+void Updater::finishUpdate()
+{
+	if (m_transfersSuccessful && !m_scriptPath.isEmpty())
+	{
+		QFile file(SessionsManager::getWritableDataPath(QLatin1String("update.txt")));
+
+		if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
 		{
-			clearUpdate();
+			QTextStream stream(&file);
+			stream << m_scriptPath;
+
+			file.close();
+
+			emit finished(true);
+
+			deleteLater();
+
+			return;
 		}
+	}
 
-		emit finished(m_transfersSuccessful);
+	if (m_isDelta)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Unable to download incremental update, falling back to full package: %1").arg(m_information.fileUrl.url()), Console::OtherCategory, Console::WarningLevel);
 
-		deleteLater();
+		startDownload(false);
+
+		return;
 	}
+
+	clearUpdate();
+
+	emit finished(false);
+
+	deleteLater();
 }
 
 void Updater::updateProgress(qint64 bytesReceived, qint64 bytesTotal)
@@ -130,14 +181,25 @@ void Updater::clearUpdate()
 	QFile::remove(SessionsManager::getWritableDataPath(QLatin1String("update.txt")));
 }
 
-Transfer* Updater::downloadFile(const QUrl &url, const QString &path)
+Transfer* Updater::downloadFile(const QUrl &url, const QByteArray &hash)
 {
+	if (!url.isValid())
+	{
+		return nullptr;
+	}
+
 	const QString urlString(url.path());
-	Transfer *transfer(TransfersManager::startTransfer(url, path + urlString.mid(urlString.lastIndexOf(QLatin1Char('/')) + 1), (Transfer::CanOverwriteOption)));
+	Transfer *transfer(TransfersManager::startTransfer(url, m_path + urlString.mid(urlString.lastIndexOf(QLatin1Char('/')) + 1), (Transfer::CanOverwriteOption)));
 
 	if (transfer)
 	{
 		transfer->setParent(this);
+		transfer->setHash(hash, QCryptographicHash::Sha256);
+
+		if (m_isInBackground)
+		{
+			transfer->setPriority(Transfer::LowPriority);
+		}
 
 		connect(transfer, &Transfer::finished, this, &Updater::handleTransferFinished);
 	}
@@ -35,7 +35,7 @@ class Updater final : public QObject
 	Q_OBJECT
 
 public:
-	explicit Updater(const UpdateChecker::UpdateInformation &information, QObject *parent = nullptr);
+	explicit Updater(const UpdateChecker::UpdateInformation &information, QObject *parent = nullptr, bool isInBackground = false);
 
 	static void clearUpdate();
 	static QString getScriptPath();
@@ -43,15 +43,22 @@ public:
 	static bool isReadyToInstall(QString path = {});
 
 protected:
-	Transfer* downloadFile(const QUrl &url, const QString &path);
+	void startDownload(bool isDelta);
+	Transfer* downloadFile(const QUrl &url, const QByteArray &hash = {});
 
 protected slots:
 	void handleTransferFinished();
+	void finishUpdate();
 	void updateProgress(qint64 bytesReceived, qint64 bytesTotal);
 
 private:
 	Transfer *m_transfer;
+	UpdateChecker::UpdateInformation m_information;
+	QString m_path;
+	QString m_scriptPath;
 	int m_transfersCount;
+	bool m_isDelta;
+	bool m_isInBackground;
 	bool m_transfersSuccessful;
 
 signals:
@@ -0,0 +1,127 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "UrlCompletionIndex.h"
+
+#include <QtCore/QHash>
+
+namespace Otter
+{
+
+void UrlCompletionIndex::addUrl(const QUrl &url)
+{
+	const QStringList forms(createUrlForms(url));
+
+	for (int i = 0; i < forms.count(); ++i)
+	{
+		UrlForm form;
+		form.url = url;
+		form.match = forms.at(i);
+		form.priority = i;
+
+		m_urlForms.insert(forms.at(i).toCaseFolded(), form);
+	}
+}
+
+void UrlCompletionIndex::removeUrl(const QUrl &url)
+{
+	const QStringList forms(createUrlForms(url));
+
+	for (int i = 0; i < forms.count(); ++i)
+	{
+		const QString key(forms.at(i).toCaseFolded());
+		QMultiMap<QString, UrlForm>::iterator iterator(m_urlForms.find(key));
+
+		while (iterator != m_urlForms.end() && iterator.key() == key)
+		{
+			if (iterator.value().url == url)
+			{
+				iterator = m_urlForms.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+	}
+}
+
+void UrlCompletionIndex::clear()
+{
+	m_urlForms.clear();
+}
+
+QStringList UrlCompletionIndex::createUrlForms(const QUrl &url)
+{
+	QStringList forms({url.toString()});
+	const QString schemelessForm(url.toString(QUrl::RemoveScheme).mid(2));
+
+	forms.append(schemelessForm);
+
+	if (schemelessForm.startsWith(QLatin1String("www.")) && url.host().count(QLatin1Char('.')) > 1)
+	{
+		forms.append(schemelessForm.mid(4));
+	}
+
+	return forms;
+}
+
+QVector<UrlCompletionIndex::UrlMatch> UrlCompletionIndex::findUrls(const QString &prefix, const QElapsedTimer &timer, int timeBudget) const
+{
+	const QString key(prefix.toCaseFolded());
+	QHash<QUrl, int> matchedUrls;
+	QVector<UrlMatch> matches;
+	QVector<int> priorities;
+	QMultiMap<QString, UrlForm>::const_iterator iterator;
+	int amount(0);
+
+	for (iterator = m_urlForms.lowerBound(key); (iterator != m_urlForms.constEnd() && iterator.key().startsWith(key)); ++iterator)
+	{
+		++amount;
+
+		if (timeBudget >= 0 && (amount % 256) == 0 && timer.isValid() && timer.elapsed() > timeBudget)
+		{
+			break;
+		}
+
+		const UrlForm &form(iterator.value());
+		const int index(matchedUrls.value(form.url, -1));
+
+		if (index < 0)
+		{
+			UrlMatch match;
+			match.url = form.url;
+			match.match = form.match;
+
+			matchedUrls[form.url] = matches.count();
+
+			matches.append(match);
+			priorities.append(form.priority);
+		}
+		else if (form.priority < priorities.at(index))
+		{
+			matches[index].match = form.match;
+			priorities[index] = form.priority;
+		}
+	}
+
+	return matches;
+}
+
+}
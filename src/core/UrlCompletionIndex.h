@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_URLCOMPLETIONINDEX_H
+#define OTTER_URLCOMPLETIONINDEX_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMultiMap>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class UrlCompletionIndex final
+{
+public:
+	struct UrlMatch final
+	{
+		QUrl url;
+		QString match;
+	};
+
+	void addUrl(const QUrl &url);
+	void removeUrl(const QUrl &url);
+	void clear();
+	QVector<UrlMatch> findUrls(const QString &prefix, const QElapsedTimer &timer = {}, int timeBudget = -1) const;
+
+protected:
+	struct UrlForm final
+	{
+		QUrl url;
+		QString match;
+		int priority = 0;
+	};
+
+	static QStringList createUrlForms(const QUrl &url);
+
+private:
+	QMultiMap<QString, UrlForm> m_urlForms;
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "UrlsTable.h"
+#include "Utils.h"
+
+namespace Otter
+{
+
+QHash<quint64, UrlsTable::UrlEntry> UrlsTable::m_entries;
+QHash<QUrl, quint64> UrlsTable::m_identifiers;
+quint64 UrlsTable::m_identifierCounter(0);
+
+void UrlsTable::releaseUrl(quint64 identifier)
+{
+	QHash<quint64, UrlEntry>::iterator iterator(m_entries.find(identifier));
+
+	if (iterator == m_entries.end())
+	{
+		return;
+	}
+
+	--iterator.value().references;
+
+	if (iterator.value().references <= 0)
+	{
+		m_identifiers.remove(iterator.value().url);
+		m_entries.erase(iterator);
+	}
+}
+
+QUrl UrlsTable::getUrl(quint64 identifier)
+{
+	return m_entries.value(identifier).url;
+}
+
+quint64 UrlsTable::getIdentifier(const QUrl &url)
+{
+	return m_identifiers.value(Utils::normalizeUrl(url), 0);
+}
+
+quint64 UrlsTable::retainUrl(const QUrl &url)
+{
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+
+	if (normalizedUrl.isEmpty())
+	{
+		return 0;
+	}
+
+	const QHash<QUrl, quint64>::const_iterator iterator(m_identifiers.constFind(normalizedUrl));
+
+	if (iterator != m_identifiers.constEnd())
+	{
+		++m_entries[iterator.value()].references;
+
+		return iterator.value();
+	}
+
+	++m_identifierCounter;
+
+	UrlEntry entry;
+	entry.url = normalizedUrl;
+	entry.hash = qHash(normalizedUrl);
+	entry.references = 1;
+
+	m_entries.insert(m_identifierCounter, entry);
+	m_identifiers.insert(normalizedUrl, m_identifierCounter);
+
+	return m_identifierCounter;
+}
+
+uint UrlsTable::getHash(quint64 identifier)
+{
+	return m_entries.value(identifier).hash;
+}
+
+int UrlsTable::getAmount()
+{
+	return m_entries.count();
+}
+
+}
@@ -0,0 +1,55 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_URLSTABLE_H
+#define OTTER_URLSTABLE_H
+
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+
+namespace Otter
+{
+
+class UrlsTable final
+{
+public:
+	static void releaseUrl(quint64 identifier);
+	static QUrl getUrl(quint64 identifier);
+	static quint64 getIdentifier(const QUrl &url);
+	static quint64 retainUrl(const QUrl &url);
+	static uint getHash(quint64 identifier);
+	static int getAmount();
+
+protected:
+	struct UrlEntry final
+	{
+		QUrl url;
+		uint hash = 0;
+		int references = 0;
+	};
+
+private:
+	static QHash<quint64, UrlEntry> m_entries;
+	static QHash<QUrl, quint64> m_identifiers;
+	static quint64 m_identifierCounter;
+};
+
+}
+
+#endif
@@ -21,29 +21,54 @@
 #include "UserScript.h"
 #include "Console.h"
 #include "Job.h"
+#include "PublicSuffixList.h"
 #include "SessionsManager.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
 #include <QtCore/QTextStream>
 
 namespace Otter
 {
 
+UserScript::UrlIndex UserScript::m_urlIndex;
+QCache<QString, QVector<UserScript*> > UserScript::m_urlsCache(UserScript::UrlsCacheLimit);
+QCache<QString, QString> UserScript::m_bundlesCache(UserScript::BundlesCacheLimit);
+quint64 UserScript::m_resolvingTime(0);
+
 UserScript::UserScript(const QString &path, const QUrl &url, QObject *parent) : QObject(parent),
 	m_iconFetchJob(nullptr),
+	m_fileSystemWatcher(new QFileSystemWatcher(this)),
 	m_path(path),
 	m_downloadUrl(url),
 	m_injectionTime(DocumentReadyTime),
 	m_shouldRunOnSubFrames(true)
 {
 	reload();
+
+	if (!m_path.isEmpty())
+	{
+		m_fileSystemWatcher->addPath(m_path);
+	}
+
+	connect(m_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &UserScript::handleFileChanged);
+}
+
+UserScript::~UserScript()
+{
+	clearCaches();
 }
 
 void UserScript::reload()
 {
+	clearCaches();
+
 	m_source.clear();
 	m_title.clear();
 	m_description.clear();
@@ -55,6 +80,8 @@ void UserScript::reload()
 	m_excludeRules.clear();
 	m_includeRules.clear();
 	m_matchRules.clear();
+	m_compiledExcludeRules.clear();
+	m_compiledIncludeRules.clear();
 	m_injectionTime = DocumentReadyTime;
 	m_shouldRunOnSubFrames = true;
 
@@ -193,6 +220,22 @@ void UserScript::reload()
 
 	file.close();
 
+	const QStringList includeRules(m_matchRules + m_includeRules);
+
+	m_compiledIncludeRules.reserve(includeRules.count());
+
+	for (int i = 0; i < includeRules.count(); ++i)
+	{
+		m_compiledIncludeRules.append(compileRule(includeRules.at(i)));
+	}
+
+	m_compiledExcludeRules.reserve(m_excludeRules.count());
+
+	for (int i = 0; i < m_excludeRules.count(); ++i)
+	{
+		m_compiledExcludeRules.append(compileRule(m_excludeRules.at(i)));
+	}
+
 	if (m_title.isEmpty())
 	{
 		m_title = QFileInfo(file).completeBaseName();
@@ -276,47 +319,238 @@ QString UserScript::getSource()
 	return m_source;
 }
 
-QString UserScript::checkUrlSubString(const QString &rule, const QString &urlSubString, QString generatedUrl, int position) const
+void UserScript::handleFileChanged()
 {
-	if (rule.isEmpty())
+	if (!m_fileSystemWatcher->files().contains(m_path) && QFile::exists(m_path))
 	{
-		return urlSubString;
+		m_fileSystemWatcher->addPath(m_path);
 	}
 
-	for (int i = 0; i < urlSubString.length(); ++i)
+	reload();
+}
+
+void UserScript::buildUrlIndex()
+{
+	const QStringList scriptNames(AddonsManager::getAddons(Addon::UserScriptType));
+
+	m_urlIndex = {};
+
+	for (int i = 0; i < scriptNames.count(); ++i)
 	{
-		const QChar character(urlSubString.at(i));
+		UserScript *script(AddonsManager::getUserScript(scriptNames.at(i)));
+
+		if (!script)
+		{
+			continue;
+		}
+
+		const QStringList rules(script->m_matchRules + script->m_includeRules);
+
+		if (rules.isEmpty())
+		{
+			m_urlIndex.genericScripts.append(script);
+
+			continue;
+		}
 
-		if (rule.at(position) == QLatin1Char('*'))
+		for (int j = 0; j < rules.count(); ++j)
 		{
-			const QString wildcardString(urlSubString.mid(i));
+			const QString host(getRuleHost(rules.at(j)));
 
-			for (int j = 1; j < wildcardString.length(); ++j)
+			if (host.isEmpty())
 			{
-				const QString result(checkUrlSubString(rule, urlSubString.right(wildcardString.length() - j), generatedUrl + wildcardString.left(j), (position + 1)));
+				m_urlIndex.genericScripts.append(script);
 
-				if (!result.isEmpty())
-				{
-					return result;
-				}
+				break;
+			}
+
+			if (host.startsWith(QLatin1String("*.")))
+			{
+				m_urlIndex.hostSuffixes[host.mid(2)].append(script);
+			}
+			else
+			{
+				m_urlIndex.hosts[host].append(script);
 			}
 		}
-		else if (rule.at(position) != character)
+	}
+
+	m_urlIndex.isValid = true;
+}
+
+void UserScript::clearCaches()
+{
+	m_urlIndex = {};
+
+	m_urlsCache.clear();
+	m_bundlesCache.clear();
+}
+
+QString UserScript::getRuleHost(const QString &rule)
+{
+	if (rule.contains(QLatin1String(".tld"), Qt::CaseInsensitive) || (rule.length() > 1 && rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/'))))
+	{
+		return {};
+	}
+
+	const int schemeEnd(rule.indexOf(QLatin1String("://")));
+
+	if (schemeEnd < 0)
+	{
+		return {};
+	}
+
+	QString host(rule.mid(schemeEnd + 3).section(QLatin1Char('/'), 0, 0).section(QLatin1Char(':'), 0, 0).toLower());
+
+	if (host.lastIndexOf(QLatin1Char('*')) > 0 || (host.startsWith(QLatin1Char('*')) && !host.startsWith(QLatin1String("*."))) || host == QLatin1String("*."))
+	{
+		return {};
+	}
+
+	return host;
+}
+
+QVector<UserScript*> UserScript::getMatchingUserScripts(const QUrl &url)
+{
+	const QStringList scriptNames(AddonsManager::getAddons(Addon::UserScriptType));
+	const QString key(url.url());
+
+	if (m_urlsCache.contains(key))
+	{
+		return *m_urlsCache.object(key);
+	}
+
+	if (!m_urlIndex.isValid)
+	{
+		buildUrlIndex();
+	}
+
+	QSet<UserScript*> candidates;
+
+	for (int i = 0; i < m_urlIndex.genericScripts.count(); ++i)
+	{
+		candidates.insert(m_urlIndex.genericScripts.at(i));
+	}
+
+	QString host(url.host().toLower());
+	const QVector<UserScript*> hostScripts(m_urlIndex.hosts.value(host));
+
+	for (int i = 0; i < hostScripts.count(); ++i)
+	{
+		candidates.insert(hostScripts.at(i));
+	}
+
+	while (!host.isEmpty())
+	{
+		const QVector<UserScript*> suffixScripts(m_urlIndex.hostSuffixes.value(host));
+
+		for (int i = 0; i < suffixScripts.count(); ++i)
 		{
-			return {};
+			candidates.insert(suffixScripts.at(i));
 		}
 
-		++position;
+		const int separatorPosition(host.indexOf(QLatin1Char('.')));
+
+		host = ((separatorPosition < 0) ? QString() : host.mid(separatorPosition + 1));
+	}
 
-		generatedUrl += character;
+	QVector<UserScript*> scripts;
 
-		if (position == rule.length())
+	for (int i = 0; i < scriptNames.count(); ++i)
+	{
+		UserScript *script(AddonsManager::getUserScript(scriptNames.at(i)));
+
+		if (candidates.contains(script) && script->isEnabledForUrl(url))
 		{
-			return generatedUrl;
+			scripts.append(script);
 		}
 	}
 
-	return {};
+	m_urlsCache.insert(key, new QVector<UserScript*>(scripts));
+
+	return scripts;
+}
+
+UserScript::UrlRule UserScript::compileRule(const QString &rule)
+{
+	UrlRule compiledRule;
+	compiledRule.rule = rule;
+
+	if (rule.length() > 1 && rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/')))
+	{
+		compiledRule.expression = QRegularExpression(rule.mid(1, (rule.length() - 2)));
+	}
+	else if (rule.contains(QLatin1String(".tld"), Qt::CaseInsensitive))
+	{
+		compiledRule.needsTopLevelDomain = true;
+
+		return compiledRule;
+	}
+	else if (rule.endsWith(QLatin1Char('*')))
+	{
+		compiledRule.expression = compileGlob(rule.left(rule.length() - 1), true);
+	}
+	else
+	{
+		compiledRule.expression = compileGlob(rule, false);
+	}
+
+	compiledRule.expression.optimize();
+
+	return compiledRule;
+}
+
+QRegularExpression UserScript::compileGlob(const QString &glob, bool isPrefixMatch)
+{
+	const int schemeEnd(glob.indexOf(QLatin1String("://")));
+	int hostEnd(-1);
+
+	if (schemeEnd >= 0)
+	{
+		hostEnd = glob.indexOf(QLatin1Char('/'), (schemeEnd + 3));
+
+		if (hostEnd < 0)
+		{
+			hostEnd = glob.length();
+		}
+	}
+
+	QString pattern(QLatin1String("^"));
+	int literalStart(0);
+
+	for (int i = 0; i < glob.length(); ++i)
+	{
+		if (glob.at(i) != QLatin1Char('*'))
+		{
+			continue;
+		}
+
+		pattern.append(QRegularExpression::escape(glob.mid(literalStart, (i - literalStart))));
+
+		if (i < schemeEnd)
+		{
+			pattern.append(QLatin1String("[^:/]+"));
+		}
+		else if (i < hostEnd)
+		{
+			pattern.append(QLatin1String("[^/]+"));
+		}
+		else
+		{
+			pattern.append(QLatin1String(".+"));
+		}
+
+		literalStart = (i + 1);
+	}
+
+	pattern.append(QRegularExpression::escape(glob.mid(literalStart)));
+
+	if (!isPrefixMatch)
+	{
+		pattern.append(QLatin1Char('$'));
+	}
+
+	return QRegularExpression(pattern);
 }
 
 QUrl UserScript::getHomePage() const
@@ -349,24 +583,85 @@ QStringList UserScript::getMatchRules() const
 	return m_matchRules;
 }
 
+QString UserScript::getSourceBundle(const QVector<UserScript*> &scripts)
+{
+	if (scripts.count() == 1)
+	{
+		return scripts.first()->getSource();
+	}
+
+	QStringList names;
+	names.reserve(scripts.count());
+
+	for (int i = 0; i < scripts.count(); ++i)
+	{
+		names.append(scripts.at(i)->getName());
+	}
+
+	const QString key(names.join(QLatin1Char('\n')));
+
+	if (m_bundlesCache.contains(key))
+	{
+		return *m_bundlesCache.object(key);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QString bundle;
+
+	for (int i = 0; i < scripts.count(); ++i)
+	{
+		QString source(QString::fromUtf8(QJsonDocument(QJsonArray({scripts.at(i)->getSource()})).toJson(QJsonDocument::Compact)));
+		source.replace(QChar(0x2028), QLatin1String("\\u2028"));
+		source.replace(QChar(0x2029), QLatin1String("\\u2029"));
+
+		bundle.append(QLatin1String("try { (0, eval)(") + source + QLatin1String("[0]); } catch (error) { console.error(error); }\n"));
+	}
+
+	m_bundlesCache.insert(key, new QString(bundle));
+
+	m_resolvingTime += static_cast<quint64>(timer.nsecsElapsed());
+
+	return bundle;
+}
+
 QVector<UserScript*> UserScript::getUserScriptsForUrl(const QUrl &url, UserScript::InjectionTime injectionTime, bool isSubFrame)
 {
-	const QStringList scriptNames(AddonsManager::getAddons(Addon::UserScriptType));
+	QElapsedTimer timer;
+	timer.start();
+
+	const QVector<UserScript*> matchingScripts(getMatchingUserScripts(url));
 	QVector<UserScript*> scripts;
+	scripts.reserve(matchingScripts.count());
 
-	for (int i = 0; i < scriptNames.count(); ++i)
+	for (int i = 0; i < matchingScripts.count(); ++i)
 	{
-		UserScript *script(AddonsManager::getUserScript(scriptNames.at(i)));
+		UserScript *script(matchingScripts.at(i));
 
-		if (script->isEnabled() && (injectionTime == AnyTime || script->getInjectionTime() == injectionTime) && (!isSubFrame || script->shouldRunOnSubFrames()) && script->isEnabledForUrl(url))
+		if (script->isEnabled() && (injectionTime == AnyTime || script->getInjectionTime() == injectionTime) && (!isSubFrame || script->shouldRunOnSubFrames()))
 		{
 			scripts.append(script);
 		}
 	}
 
+	m_resolvingTime += static_cast<quint64>(timer.nsecsElapsed());
+
 	return scripts;
 }
 
+UserScript::CachesStatistics UserScript::getCachesStatistics()
+{
+	CachesStatistics statistics;
+	statistics.resolvingTime = (m_resolvingTime / 1000);
+	statistics.urlsAmount = m_urlsCache.count();
+	statistics.urlsLimit = m_urlsCache.maxCost();
+	statistics.bundlesAmount = m_bundlesCache.count();
+	statistics.bundlesLimit = m_bundlesCache.maxCost();
+
+	return statistics;
+}
+
 UserScript::InjectionTime UserScript::getInjectionTime() const
 {
 	return m_injectionTime;
@@ -384,24 +679,12 @@ bool UserScript::isEnabledForUrl(const QUrl &url)
 		return false;
 	}
 
-	bool isEnabled(!(m_includeRules.length() > 0 || m_matchRules.length() > 0));
-
-	if (checkUrl(url, m_matchRules))
-	{
-		isEnabled = true;
-	}
-
-	if (!isEnabled && checkUrl(url, m_includeRules))
-	{
-		isEnabled = true;
-	}
-
-	if (isEnabled && checkUrl(url, m_excludeRules))
+	if (!m_compiledIncludeRules.isEmpty() && !checkUrl(url, m_compiledIncludeRules))
 	{
-		isEnabled = false;
+		return false;
 	}
 
-	return isEnabled;
+	return !checkUrl(url, m_compiledExcludeRules);
 }
 
 bool UserScript::canRemove() const
@@ -409,33 +692,28 @@ bool UserScript::canRemove() const
 	return true;
 }
 
-bool UserScript::checkUrl(const QUrl &url, const QStringList &rules) const
+bool UserScript::checkUrl(const QUrl &url, const QVector<UrlRule> &rules) const
 {
+	const QString urlString(url.url());
+	const QString host(url.host());
+
 	for (int i = 0; i < rules.count(); ++i)
 	{
-		QString rule(rules.at(i));
-
-		if (rule.startsWith(QLatin1Char('/')) && rule.endsWith(QLatin1Char('/')))
-		{
-			return QRegularExpression(rule.mid(1, rule.length() - 2)).match(url.url()).hasMatch();
-		}
+		const UrlRule &rule(rules.at(i));
 
-		if (rule.contains(QLatin1String(".tld"), Qt::CaseInsensitive))
+		if (rule.needsTopLevelDomain)
 		{
-			rule.replace(QLatin1String(".tld"), url.topLevelDomain(), Qt::CaseInsensitive);
-		}
+			QString glob(rule.rule);
+			glob.replace(QLatin1String(".tld"), (QLatin1Char('.') + PublicSuffixList::getPublicSuffix(host).toString()), Qt::CaseInsensitive);
 
-		bool useExactMatch(true);
+			const bool isPrefixMatch(glob.endsWith(QLatin1Char('*')));
 
-		if (rule.endsWith(QLatin1Char('*')))
-		{
-			useExactMatch = false;
-			rule = rule.left(rule.length() - 1);
+			if (compileGlob((isPrefixMatch ? glob.left(glob.length() - 1) : glob), isPrefixMatch).match(urlString).hasMatch())
+			{
+				return true;
+			}
 		}
-
-		const QString result(checkUrlSubString(rule, url.url(), {}));
-
-		if (!result.isEmpty() && ((useExactMatch && url.url() == result) || (!useExactMatch && url.url().startsWith(result))))
+		else if (rule.expression.match(urlString).hasMatch())
 		{
 			return true;
 		}
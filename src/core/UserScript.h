@@ -23,6 +23,11 @@
 
 #include "AddonsManager.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QRegularExpression>
+
+class QFileSystemWatcher;
+
 namespace Otter
 {
 
@@ -41,7 +46,17 @@ public:
 		DeferredTime
 	};
 
+	struct CachesStatistics final
+	{
+		quint64 resolvingTime = 0;
+		int urlsAmount = 0;
+		int urlsLimit = 0;
+		int bundlesAmount = 0;
+		int bundlesLimit = 0;
+	};
+
 	explicit UserScript(const QString &path, const QUrl &url = {}, QObject *parent = nullptr);
+	~UserScript();
 
 	QString getName() const override;
 	QString getTitle() const override;
@@ -55,7 +70,9 @@ public:
 	QStringList getExcludeRules() const;
 	QStringList getIncludeRules() const;
 	QStringList getMatchRules() const;
+	static QString getSourceBundle(const QVector<UserScript*> &scripts);
 	static QVector<UserScript*> getUserScriptsForUrl(const QUrl &url, InjectionTime injectionTime = AnyTime, bool isSubFrame = false);
+	static CachesStatistics getCachesStatistics();
 	InjectionTime getInjectionTime() const;
 	AddonType getType() const override;
 	bool isEnabledForUrl(const QUrl &url);
@@ -67,11 +84,41 @@ public slots:
 	void reload();
 
 protected:
-	QString checkUrlSubString(const QString &rule, const QString &urlSubString, QString generatedUrl, int position = 0) const;
-	bool checkUrl(const QUrl &url, const QStringList &rules) const;
+	enum UrlIndexParameter
+	{
+		UrlsCacheLimit = 100,
+		BundlesCacheLimit = 20
+	};
+
+	struct UrlRule final
+	{
+		QRegularExpression expression;
+		QString rule;
+		bool needsTopLevelDomain = false;
+	};
+
+	struct UrlIndex final
+	{
+		QHash<QString, QVector<UserScript*> > hosts;
+		QHash<QString, QVector<UserScript*> > hostSuffixes;
+		QVector<UserScript*> genericScripts;
+		bool isValid = false;
+	};
+
+	static void buildUrlIndex();
+	static void clearCaches();
+	static QString getRuleHost(const QString &rule);
+	static QVector<UserScript*> getMatchingUserScripts(const QUrl &url);
+	static UrlRule compileRule(const QString &rule);
+	static QRegularExpression compileGlob(const QString &glob, bool isPrefixMatch);
+	bool checkUrl(const QUrl &url, const QVector<UrlRule> &rules) const;
+
+protected slots:
+	void handleFileChanged();
 
 private:
 	IconFetchJob *m_iconFetchJob;
+	QFileSystemWatcher *m_fileSystemWatcher;
 	QString m_path;
 	QString m_source;
 	QString m_title;
@@ -85,9 +132,16 @@ private:
 	QStringList m_excludeRules;
 	QStringList m_includeRules;
 	QStringList m_matchRules;
+	QVector<UrlRule> m_compiledExcludeRules;
+	QVector<UrlRule> m_compiledIncludeRules;
 	InjectionTime m_injectionTime;
 	bool m_shouldRunOnSubFrames;
 
+	static UrlIndex m_urlIndex;
+	static QCache<QString, QVector<UserScript*> > m_urlsCache;
+	static QCache<QString, QString> m_bundlesCache;
+	static quint64 m_resolvingTime;
+
 signals:
 	void metaDataChanged();
 };
@@ -0,0 +1,211 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "VisitedLinksSet.h"
+#include "Utils.h"
+
+namespace Otter
+{
+
+VisitedLinksSet::VisitedLinksSet() :
+	m_bits(MinimumBitsAmount / 64, 0),
+	m_staleAmount(0)
+{
+}
+
+void VisitedLinksSet::addUrl(const QUrl &url)
+{
+	const QString encodedUrl(url.toString(QUrl::FullyEncoded));
+	const QString normalizedUrl(Utils::normalizeUrl(url).toString(QUrl::FullyEncoded));
+
+	addHash(hashUrl(encodedUrl, encodedUrl.length()));
+
+	if (normalizedUrl != encodedUrl)
+	{
+		addHash(hashUrl(normalizedUrl, normalizedUrl.length()));
+	}
+}
+
+void VisitedLinksSet::removeUrl(const QUrl &url)
+{
+	const QString encodedUrl(url.toString(QUrl::FullyEncoded));
+	const QString normalizedUrl(Utils::normalizeUrl(url).toString(QUrl::FullyEncoded));
+
+	removeHash(hashUrl(encodedUrl, encodedUrl.length()));
+
+	if (normalizedUrl != encodedUrl)
+	{
+		removeHash(hashUrl(normalizedUrl, normalizedUrl.length()));
+	}
+}
+
+void VisitedLinksSet::addHash(quint64 hash)
+{
+	int &amount(m_hashes[hash]);
+
+	++amount;
+
+	if (amount > 1)
+	{
+		return;
+	}
+
+	if ((m_hashes.count() * BitsPerUrl) > (m_bits.count() * 64))
+	{
+		rebuild();
+	}
+	else
+	{
+		setBits(hash);
+	}
+}
+
+void VisitedLinksSet::removeHash(quint64 hash)
+{
+	QHash<quint64, int>::iterator iterator(m_hashes.find(hash));
+
+	if (iterator == m_hashes.end())
+	{
+		return;
+	}
+
+	--iterator.value();
+
+	if (iterator.value() > 0)
+	{
+		return;
+	}
+
+	m_hashes.erase(iterator);
+
+	++m_staleAmount;
+
+	if (m_staleAmount > qMax(1024, m_hashes.count()))
+	{
+		rebuild();
+	}
+}
+
+void VisitedLinksSet::clear()
+{
+	m_hashes.clear();
+	m_bits = QVector<quint64>(MinimumBitsAmount / 64, 0);
+	m_staleAmount = 0;
+}
+
+void VisitedLinksSet::rebuild()
+{
+	int bitsAmount(MinimumBitsAmount);
+
+	while (bitsAmount < (m_hashes.count() * BitsPerUrl * 2))
+	{
+		bitsAmount *= 2;
+	}
+
+	m_bits = QVector<quint64>(bitsAmount / 64, 0);
+	m_staleAmount = 0;
+
+	QHash<quint64, int>::const_iterator iterator;
+
+	for (iterator = m_hashes.constBegin(); iterator != m_hashes.constEnd(); ++iterator)
+	{
+		setBits(iterator.key());
+	}
+}
+
+void VisitedLinksSet::setBits(quint64 hash)
+{
+	const quint64 bitsAmount(static_cast<quint64>(m_bits.count()) * 64);
+	const quint64 step((hash >> 32) | 1);
+
+	for (int i = 0; i < HashesAmount; ++i)
+	{
+		const quint64 bit((hash + (i * step)) & (bitsAmount - 1));
+
+		m_bits[static_cast<int>(bit / 64)] |= (static_cast<quint64>(1) << (bit % 64));
+	}
+}
+
+quint64 VisitedLinksSet::hashUrl(const QString &url, int length)
+{
+	const ushort *data(url.utf16());
+	quint64 hash(Q_UINT64_C(14695981039346656037));
+
+	for (int i = 0; i < length; ++i)
+	{
+		hash ^= data[i];
+		hash *= Q_UINT64_C(1099511628211);
+	}
+
+	return hash;
+}
+
+bool VisitedLinksSet::containsHash(quint64 hash) const
+{
+	const quint64 bitsAmount(static_cast<quint64>(m_bits.count()) * 64);
+	const quint64 step((hash >> 32) | 1);
+
+	for (int i = 0; i < HashesAmount; ++i)
+	{
+		const quint64 bit((hash + (i * step)) & (bitsAmount - 1));
+
+		if ((m_bits.at(static_cast<int>(bit / 64)) & (static_cast<quint64>(1) << (bit % 64))) == 0)
+		{
+			return false;
+		}
+	}
+
+	return m_hashes.contains(hash);
+}
+
+bool VisitedLinksSet::contains(const QString &url) const
+{
+	if (url.isEmpty() || m_hashes.isEmpty())
+	{
+		return false;
+	}
+
+	int length(url.length());
+
+	if (containsHash(hashUrl(url, length)))
+	{
+		return true;
+	}
+
+	const int fragmentPosition(url.indexOf(QLatin1Char('#')));
+
+	if (fragmentPosition >= 0)
+	{
+		length = fragmentPosition;
+
+		if (containsHash(hashUrl(url, length)))
+		{
+			return true;
+		}
+	}
+
+	if (length > 0 && url.at(length - 1) == QLatin1Char('/'))
+	{
+		return containsHash(hashUrl(url, (length - 1)));
+	}
+
+	return false;
+}
+
+}
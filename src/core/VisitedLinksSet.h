@@ -0,0 +1,63 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_VISITEDLINKSSET_H
+#define OTTER_VISITEDLINKSSET_H
+
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class VisitedLinksSet final
+{
+public:
+	VisitedLinksSet();
+
+	void addUrl(const QUrl &url);
+	void removeUrl(const QUrl &url);
+	void clear();
+	bool contains(const QString &url) const;
+
+protected:
+	enum BloomFilterParameter
+	{
+		BitsPerUrl = 10,
+		HashesAmount = 4,
+		MinimumBitsAmount = 4096
+	};
+
+	void addHash(quint64 hash);
+	void removeHash(quint64 hash);
+	void rebuild();
+	void setBits(quint64 hash);
+	static quint64 hashUrl(const QString &url, int length);
+	bool containsHash(quint64 hash) const;
+
+private:
+	QVector<quint64> m_bits;
+	QHash<quint64, int> m_hashes;
+	int m_staleAmount;
+};
+
+}
+
+#endif
@@ -126,6 +126,13 @@ int main(int argc, char *argv[])
 	// Use static version for this attribute too, for consistency with the above.
 	Application::setAttribute(Qt::AA_UseHighDpiPixmaps, true);
 
+	// Hand arguments over to already running instance before any GUI, plugins
+	// or web backends get initialized, using only minimal core application.
+	if (Application::forwardArguments(argc, argv))
+	{
+		return 0;
+	}
+
 	Application application(argc, argv);
 
 	if (Application::isAboutToQuit() || Application::isRunning() || Application::isUpdating() || Application::getCommandLineParser()->isSet(QLatin1String("report")))
@@ -22,140 +22,240 @@
 #include "../../../../core/Console.h"
 #include "../../../../core/SessionsManager.h"
 
+#include <QtCore/QDataStream>
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimer>
 
 namespace Otter
 {
 
 FilePasswordsStorageBackend::FilePasswordsStorageBackend(QObject *parent) : PasswordsStorageBackend(parent),
+	m_passwords(DecodedHostsLimit),
+	m_storedRecordsAmount(0),
 	m_isInitialized(false)
 {
+	QTimer::singleShot(0, this, [&]()
+	{
+		if (!m_isInitialized)
+		{
+			initialize();
+		}
+	});
 }
 
 void FilePasswordsStorageBackend::initialize()
 {
 	m_isInitialized = true;
 
-	const QString path(SessionsManager::getWritableDataPath(QLatin1String("passwords.json")));
+	const QString path(getStorePath());
 
 	if (!QFile::exists(path))
 	{
+		const QString legacyPath(SessionsManager::getWritableDataPath(QLatin1String("passwords.json")));
+
+		if (QFile::exists(legacyPath))
+		{
+			importLegacyPasswords(legacyPath);
+		}
+
 		return;
 	}
 
 	QFile file(path);
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	if (!file.open(QIODevice::ReadOnly))
 	{
 		Console::addMessage(tr("Failed to open passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 
 		return;
 	}
 
-	QHash<QString, QVector<PasswordsManager::PasswordInformation> > passwords;
-	QJsonObject hostsObject(QJsonDocument::fromJson(file.readAll()).object());
-	QJsonObject::const_iterator hostsIterator;
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
 
-	for (hostsIterator = hostsObject.constBegin(); hostsIterator != hostsObject.constEnd(); ++hostsIterator)
+	quint32 magicNumber(0);
+	quint32 formatVersion(0);
+
+	stream >> magicNumber >> formatVersion;
+
+	if (magicNumber != StoreMagicNumber || formatVersion != StoreFormatVersion)
 	{
-		const QJsonArray passwordsArray(hostsIterator.value().toArray());
-		QVector<PasswordsManager::PasswordInformation> hostPasswords;
-		hostPasswords.reserve(passwordsArray.count());
+		Console::addMessage(tr("Failed to load passwords file: unsupported format"), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 
-		for (int i = 0; i < passwordsArray.count(); ++i)
-		{
-			const QJsonObject passwordObject(passwordsArray.at(i).toObject());
-			PasswordsManager::PasswordInformation password;
-			password.url = QUrl(passwordObject.value(QLatin1String("url")).toString());
-			password.timeAdded = QDateTime::fromString(passwordObject.value(QLatin1String("timeAdded")).toString(), Qt::ISODate);
-			password.timeAdded.setTimeSpec(Qt::UTC);
-			password.timeUsed = QDateTime::fromString(passwordObject.value(QLatin1String("timeUsed")).toString(), Qt::ISODate);
-			password.timeUsed.setTimeSpec(Qt::UTC);
-			password.type = ((passwordObject.value(QLatin1String("type")).toString() == QLatin1String("auth")) ? PasswordsManager::AuthPassword : PasswordsManager::FormPassword);
+		return;
+	}
 
-			const QJsonArray fieldsArray(passwordObject.value(QLatin1String("fields")).toArray());
+	while (!stream.atEnd())
+	{
+		const qint64 offset(file.pos());
+		QString host;
+		quint8 types(0);
+		quint32 length(0);
 
-			password.fields.reserve(fieldsArray.count());
+		stream >> host >> types >> length;
 
-			for (int j = 0; j < fieldsArray.count(); ++j)
-			{
-				const QJsonObject fieldObject(fieldsArray.at(j).toObject());
-				PasswordsManager::PasswordInformation::Field field;
-				field.name = fieldObject.value(fieldObject.contains(QLatin1String("name")) ? QLatin1String("name") : QLatin1String("key")).toString();
-				field.value = fieldObject.value(QLatin1String("value")).toString();
-				field.type = ((fieldObject.value(QLatin1String("type")).toString() == QLatin1String("password")) ? PasswordsManager::PasswordField : PasswordsManager::TextField);
+		if (stream.status() != QDataStream::Ok || (length != 0xFFFFFFFF && stream.skipRawData(static_cast<int>(length)) != static_cast<int>(length)))
+		{
+			break;
+		}
 
-				password.fields.append(field);
-			}
+		++m_storedRecordsAmount;
 
-			hostPasswords.append(password);
+		if (types == PasswordsManager::UnknownPassword)
+		{
+			m_hosts.remove(host);
 		}
+		else
+		{
+			HostRecord record;
+			record.offset = offset;
+			record.types = static_cast<PasswordsManager::PasswordType>(types);
 
-		passwords[hostsIterator.key()] = hostPasswords;
+			m_hosts[host] = record;
+		}
 	}
-
-	m_passwords = passwords;
 }
 
-void FilePasswordsStorageBackend::save()
+void FilePasswordsStorageBackend::importLegacyPasswords(const QString &path)
 {
-	QFile file(SessionsManager::getWritableDataPath(QLatin1String("passwords.json")));
+	QFile file(path);
 
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
 	{
-		Console::addMessage(tr("Failed to save passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+		Console::addMessage(tr("Failed to open passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 
 		return;
 	}
 
-	QJsonObject hostsObject;
-	QHash<QString, QVector<PasswordsManager::PasswordInformation> >::iterator hostsIterator;
+	QHash<QString, QByteArray> payloads;
+	const QJsonObject hostsObject(QJsonDocument::fromJson(file.readAll()).object());
+	QJsonObject::const_iterator iterator;
+
+	file.close();
 
-	for (hostsIterator = m_passwords.begin(); hostsIterator != m_passwords.end(); ++hostsIterator)
+	for (iterator = hostsObject.constBegin(); iterator != hostsObject.constEnd(); ++iterator)
 	{
-		if (hostsIterator.value().isEmpty())
+		const QVector<PasswordsManager::PasswordInformation> passwords(deserializePasswords(iterator.value().toArray()));
+
+		if (passwords.isEmpty())
 		{
 			continue;
 		}
 
-		QJsonArray passwordsArray;
-		const QVector<PasswordsManager::PasswordInformation> passwords(hostsIterator.value());
+		HostRecord record;
 
 		for (int i = 0; i < passwords.count(); ++i)
 		{
-			QJsonArray fieldsArray;
+			record.types |= passwords.at(i).type;
+		}
 
-			for (int j = 0; j < passwords.at(i).fields.count(); ++j)
-			{
-				fieldsArray.append(QJsonObject({{QLatin1String("name"), passwords.at(i).fields.at(j).name}, {QLatin1String("value"), passwords.at(i).fields.at(j).value}, {QLatin1String("type"), ((passwords.at(i).fields.at(j).type == PasswordsManager::PasswordField) ? QLatin1String("password") : QLatin1String("text"))}}));
-			}
+		m_hosts[iterator.key()] = record;
 
-			QJsonObject passwordObject({{QLatin1String("url"), passwords.at(i).url.toString()}});
+		payloads[iterator.key()] = serializePasswords(passwords);
+	}
 
-			if (passwords.at(i).timeAdded.isValid())
-			{
-				passwordObject.insert(QLatin1String("timeAdded"), passwords.at(i).timeAdded.toString(Qt::ISODate));
-			}
+	if (writeStore(payloads))
+	{
+		QFile::remove(path);
+	}
+	else
+	{
+		m_hosts.clear();
+	}
+}
 
-			if (passwords.at(i).timeUsed.isValid())
+void FilePasswordsStorageBackend::setPasswords(const QString &host, const QVector<PasswordsManager::PasswordInformation> &passwords)
+{
+	PasswordsManager::PasswordTypes types(PasswordsManager::UnknownPassword);
+
+	for (int i = 0; i < passwords.count(); ++i)
+	{
+		types |= passwords.at(i).type;
+	}
+
+	const QByteArray payload(passwords.isEmpty() ? QByteArray() : serializePasswords(passwords));
+
+	m_passwords.insert(host, new QVector<PasswordsManager::PasswordInformation>(passwords));
+
+	if (m_storedRecordsAmount >= ((m_hosts.count() * 2) + 100))
+	{
+		QHash<QString, QByteArray> payloads;
+		payloads.reserve(m_hosts.count());
+
+		QHash<QString, HostRecord>::const_iterator iterator;
+
+		for (iterator = m_hosts.constBegin(); iterator != m_hosts.constEnd(); ++iterator)
+		{
+			if (iterator.key() != host)
 			{
-				passwordObject.insert(QLatin1String("timeUsed"), passwords.at(i).timeUsed.toString(Qt::ISODate));
+				payloads[iterator.key()] = readPayload(iterator.key());
 			}
+		}
 
-			passwordObject.insert(QLatin1String("type"), ((passwords.at(i).type == PasswordsManager::AuthPassword) ? QLatin1String("auth") : QLatin1String("form")));
-			passwordObject.insert(QLatin1String("fields"), fieldsArray);
+		if (passwords.isEmpty())
+		{
+			m_hosts.remove(host);
+		}
+		else
+		{
+			m_hosts[host].types = types;
 
-			passwordsArray.append(passwordObject);
+			payloads[host] = payload;
 		}
 
-		hostsObject.insert(hostsIterator.key(), passwordsArray);
+		writeStore(payloads);
+
+		return;
 	}
 
-	file.write(QJsonDocument(hostsObject).toJson(QJsonDocument::Compact));
+	QFile file(getStorePath());
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(tr("Failed to save passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	if (file.size() == 0)
+	{
+		stream << static_cast<quint32>(StoreMagicNumber) << static_cast<quint32>(StoreFormatVersion);
+	}
+
+	const qint64 offset(file.pos());
+
+	stream << host << static_cast<quint8>(types) << payload;
+
 	file.close();
+
+	if (stream.status() != QDataStream::Ok || file.error() != QFileDevice::NoError)
+	{
+		Console::addMessage(tr("Failed to save passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+		return;
+	}
+
+	++m_storedRecordsAmount;
+
+	if (passwords.isEmpty())
+	{
+		m_hosts.remove(host);
+	}
+	else
+	{
+		HostRecord record;
+		record.offset = offset;
+		record.types = types;
+
+		m_hosts[host] = record;
+	}
 }
 
 void FilePasswordsStorageBackend::clearPasswords(const QString &host)
@@ -170,18 +270,11 @@ void FilePasswordsStorageBackend::clearPasswords(const QString &host)
 		initialize();
 	}
 
-	if (m_passwords.isEmpty())
-	{
-		return;
-	}
-
-	if (m_passwords.contains(host))
+	if (m_hosts.contains(host))
 	{
-		m_passwords.remove(host);
+		setPasswords(host, {});
 
 		emit passwordsModified();
-
-		save();
 	}
 }
 
@@ -189,18 +282,29 @@ void FilePasswordsStorageBackend::clearPasswords(int period)
 {
 	if (period <= 0)
 	{
-		const QString path(SessionsManager::getWritableDataPath(QLatin1String("passwords.json")));
+		const QString path(getStorePath());
+		const QString legacyPath(SessionsManager::getWritableDataPath(QLatin1String("passwords.json")));
 
-		if (!QFile::remove(path))
+		if ((QFile::exists(path) && !QFile::remove(path)) || (QFile::exists(legacyPath) && !QFile::remove(legacyPath)))
 		{
 			Console::addMessage(tr("Failed to remove passwords file"), Console::OtherCategory, Console::ErrorLevel, path);
+
+			return;
 		}
-		else if (!m_passwords.isEmpty())
-		{
-			m_passwords.clear();
 
+		const bool hadPasswords(!m_hosts.isEmpty());
+
+		m_hosts.clear();
+		m_passwords.clear();
+		m_storedRecordsAmount = 0;
+		m_isInitialized = true;
+
+		if (hadPasswords)
+		{
 			emit passwordsModified();
 		}
+
+		return;
 	}
 
 	if (!m_isInitialized)
@@ -208,44 +312,34 @@ void FilePasswordsStorageBackend::clearPasswords(int period)
 		initialize();
 	}
 
-	if (m_passwords.isEmpty())
-	{
-		return;
-	}
-
-	QHash<QString, QVector<PasswordsManager::PasswordInformation> >::iterator iterator(m_passwords.begin());
+	const QStringList hosts(m_hosts.keys());
 	bool wasModified(false);
 
-	while (iterator != m_passwords.end())
+	for (int i = 0; i < hosts.count(); ++i)
 	{
-		QVector<PasswordsManager::PasswordInformation> passwords(iterator.value());
+		QVector<PasswordsManager::PasswordInformation> passwords(getHostPasswords(hosts.at(i)));
+		bool wasHostModified(false);
 
-		for (int i = (passwords.count() - 1); i >= 0; --i)
+		for (int j = (passwords.count() - 1); j >= 0; --j)
 		{
-			if (passwords.at(i).timeAdded.secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
+			if (passwords.at(j).timeAdded.secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
 			{
-				passwords.removeAt(i);
+				passwords.removeAt(j);
 
-				wasModified = true;
+				wasHostModified = true;
 			}
 		}
 
-		if (passwords.isEmpty())
+		if (wasHostModified)
 		{
-			iterator = m_passwords.erase(iterator);
-		}
-		else
-		{
-			m_passwords[iterator.key()] = passwords;
+			setPasswords(hosts.at(i), passwords);
 
-			++iterator;
+			wasModified = true;
 		}
 	}
 
 	if (wasModified)
 	{
-		save();
-
 		emit passwordsModified();
 	}
 }
@@ -258,40 +352,34 @@ void FilePasswordsStorageBackend::addPassword(const PasswordsManager::PasswordIn
 	}
 
 	const QString host(Utils::extractHost(password.url));
+	QVector<PasswordsManager::PasswordInformation> passwords(getHostPasswords(host));
 
-	if (m_passwords.contains(host))
+	for (int i = 0; i < passwords.count(); ++i)
 	{
-		const QVector<PasswordsManager::PasswordInformation> passwords(m_passwords[host]);
+		const PasswordsManager::PasswordMatch match(comparePasswords(password, passwords.at(i)));
 
-		for (int i = 0; i < passwords.count(); ++i)
+		if (match == PasswordsManager::FullMatch)
 		{
-			if (comparePasswords(password, passwords.at(i)) == PasswordsManager::FullMatch)
-			{
-				return;
-			}
+			return;
+		}
 
-			if (comparePasswords(password, passwords.at(i)) == PasswordsManager::PartialMatch)
-			{
-				m_passwords[host].replace(i, password);
+		if (match == PasswordsManager::PartialMatch)
+		{
+			passwords.replace(i, password);
 
-				emit passwordsModified();
+			emit passwordsModified();
 
-				save();
+			setPasswords(host, passwords);
 
-				return;
-			}
+			return;
 		}
 	}
-	else
-	{
-		m_passwords[host] = {};
-	}
 
-	m_passwords[host].append(password);
+	passwords.append(password);
 
 	emit passwordsModified();
 
-	save();
+	setPasswords(host, passwords);
 }
 
 void FilePasswordsStorageBackend::removePassword(const PasswordsManager::PasswordInformation &password)
@@ -303,22 +391,22 @@ void FilePasswordsStorageBackend::removePassword(const PasswordsManager::Passwor
 
 	const QString host(Utils::extractHost(password.url));
 
-	if (!m_passwords.contains(host))
+	if (!m_hosts.contains(host))
 	{
 		return;
 	}
 
-	const QVector<PasswordsManager::PasswordInformation> passwords(m_passwords[host]);
+	QVector<PasswordsManager::PasswordInformation> passwords(getHostPasswords(host));
 
 	for (int i = 0; i < passwords.count(); ++i)
 	{
 		if (comparePasswords(password, passwords.at(i)) != PasswordsManager::NoMatch)
 		{
-			m_passwords[host].removeAt(i);
+			passwords.removeAt(i);
 
 			emit passwordsModified();
 
-			save();
+			setPasswords(host, passwords);
 
 			return;
 		}
@@ -345,6 +433,11 @@ QString FilePasswordsStorageBackend::getVersion() const
 	return QLatin1String("1.0");
 }
 
+QString FilePasswordsStorageBackend::getStorePath()
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("passwords.dat"));
+}
+
 QUrl FilePasswordsStorageBackend::getHomePage() const
 {
 	return QUrl(QLatin1String("https://otter-browser.org/"));
@@ -357,7 +450,125 @@ QStringList FilePasswordsStorageBackend::getHosts()
 		initialize();
 	}
 
-	return m_passwords.keys();
+	return m_hosts.keys();
+}
+
+QByteArray FilePasswordsStorageBackend::readPayload(const QString &host) const
+{
+	const HostRecord record(m_hosts.value(host));
+
+	if (record.offset < 0)
+	{
+		return {};
+	}
+
+	QFile file(getStorePath());
+
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(record.offset))
+	{
+		return {};
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	QString storedHost;
+	quint8 types(0);
+	QByteArray payload;
+
+	stream >> storedHost >> types >> payload;
+
+	return ((stream.status() == QDataStream::Ok && storedHost == host) ? payload : QByteArray());
+}
+
+QByteArray FilePasswordsStorageBackend::serializePasswords(const QVector<PasswordsManager::PasswordInformation> &passwords)
+{
+	QJsonArray passwordsArray;
+
+	for (int i = 0; i < passwords.count(); ++i)
+	{
+		QJsonArray fieldsArray;
+
+		for (int j = 0; j < passwords.at(i).fields.count(); ++j)
+		{
+			fieldsArray.append(QJsonObject({{QLatin1String("name"), passwords.at(i).fields.at(j).name}, {QLatin1String("value"), passwords.at(i).fields.at(j).value}, {QLatin1String("type"), ((passwords.at(i).fields.at(j).type == PasswordsManager::PasswordField) ? QLatin1String("password") : QLatin1String("text"))}}));
+		}
+
+		QJsonObject passwordObject({{QLatin1String("url"), passwords.at(i).url.toString()}});
+
+		if (passwords.at(i).timeAdded.isValid())
+		{
+			passwordObject.insert(QLatin1String("timeAdded"), passwords.at(i).timeAdded.toString(Qt::ISODate));
+		}
+
+		if (passwords.at(i).timeUsed.isValid())
+		{
+			passwordObject.insert(QLatin1String("timeUsed"), passwords.at(i).timeUsed.toString(Qt::ISODate));
+		}
+
+		passwordObject.insert(QLatin1String("type"), ((passwords.at(i).type == PasswordsManager::AuthPassword) ? QLatin1String("auth") : QLatin1String("form")));
+		passwordObject.insert(QLatin1String("fields"), fieldsArray);
+
+		passwordsArray.append(passwordObject);
+	}
+
+	return QJsonDocument(passwordsArray).toJson(QJsonDocument::Compact);
+}
+
+QVector<PasswordsManager::PasswordInformation> FilePasswordsStorageBackend::getHostPasswords(const QString &host)
+{
+	if (m_passwords.contains(host))
+	{
+		return *m_passwords.object(host);
+	}
+
+	if (!m_hosts.contains(host))
+	{
+		return {};
+	}
+
+	const QVector<PasswordsManager::PasswordInformation> passwords(deserializePasswords(QJsonDocument::fromJson(readPayload(host)).array()));
+
+	m_passwords.insert(host, new QVector<PasswordsManager::PasswordInformation>(passwords));
+
+	return passwords;
+}
+
+QVector<PasswordsManager::PasswordInformation> FilePasswordsStorageBackend::deserializePasswords(const QJsonArray &passwordsArray)
+{
+	QVector<PasswordsManager::PasswordInformation> passwords;
+	passwords.reserve(passwordsArray.count());
+
+	for (int i = 0; i < passwordsArray.count(); ++i)
+	{
+		const QJsonObject passwordObject(passwordsArray.at(i).toObject());
+		PasswordsManager::PasswordInformation password;
+		password.url = QUrl(passwordObject.value(QLatin1String("url")).toString());
+		password.timeAdded = QDateTime::fromString(passwordObject.value(QLatin1String("timeAdded")).toString(), Qt::ISODate);
+		password.timeAdded.setTimeSpec(Qt::UTC);
+		password.timeUsed = QDateTime::fromString(passwordObject.value(QLatin1String("timeUsed")).toString(), Qt::ISODate);
+		password.timeUsed.setTimeSpec(Qt::UTC);
+		password.type = ((passwordObject.value(QLatin1String("type")).toString() == QLatin1String("auth")) ? PasswordsManager::AuthPassword : PasswordsManager::FormPassword);
+
+		const QJsonArray fieldsArray(passwordObject.value(QLatin1String("fields")).toArray());
+
+		password.fields.reserve(fieldsArray.count());
+
+		for (int j = 0; j < fieldsArray.count(); ++j)
+		{
+			const QJsonObject fieldObject(fieldsArray.at(j).toObject());
+			PasswordsManager::PasswordInformation::Field field;
+			field.name = fieldObject.value(fieldObject.contains(QLatin1String("name")) ? QLatin1String("name") : QLatin1String("key")).toString();
+			field.value = fieldObject.value(QLatin1String("value")).toString();
+			field.type = ((fieldObject.value(QLatin1String("type")).toString() == QLatin1String("password")) ? PasswordsManager::PasswordField : PasswordsManager::TextField);
+
+			password.fields.append(field);
+		}
+
+		passwords.append(password);
+	}
+
+	return passwords;
 }
 
 QVector<PasswordsManager::PasswordInformation> FilePasswordsStorageBackend::getPasswords(const QUrl &url, PasswordsManager::PasswordTypes types)
@@ -369,28 +580,29 @@ QVector<PasswordsManager::PasswordInformation> FilePasswordsStorageBackend::getP
 
 	const QString host(Utils::extractHost(url));
 
-	if (m_passwords.contains(host))
+	if (!m_hosts.contains(host) || !(m_hosts[host].types & types))
 	{
-		if (types == PasswordsManager::AnyPassword)
-		{
-			return m_passwords[host];
-		}
+		return {};
+	}
 
-		const QVector<PasswordsManager::PasswordInformation> passwords(m_passwords[host]);
-		QVector<PasswordsManager::PasswordInformation> matchingPasswords;
+	const QVector<PasswordsManager::PasswordInformation> passwords(getHostPasswords(host));
 
-		for (int i = 0; i < passwords.count(); ++i)
+	if (types == PasswordsManager::AnyPassword)
+	{
+		return passwords;
+	}
+
+	QVector<PasswordsManager::PasswordInformation> matchingPasswords;
+
+	for (int i = 0; i < passwords.count(); ++i)
+	{
+		if (types.testFlag(passwords.at(i).type))
 		{
-			if (types.testFlag(passwords.at(i).type))
-			{
-				matchingPasswords.append(passwords.at(i));
-			}
+			matchingPasswords.append(passwords.at(i));
 		}
-
-		return matchingPasswords;
 	}
 
-	return {};
+	return matchingPasswords;
 }
 
 PasswordsManager::PasswordMatch FilePasswordsStorageBackend::hasPassword(const PasswordsManager::PasswordInformation &password)
@@ -402,12 +614,12 @@ PasswordsManager::PasswordMatch FilePasswordsStorageBackend::hasPassword(const P
 
 	const QString host(Utils::extractHost(password.url));
 
-	if (!m_passwords.contains(host))
+	if (!m_hosts.contains(host) || !(m_hosts[host].types & password.type))
 	{
 		return PasswordsManager::NoMatch;
 	}
 
-	const QVector<PasswordsManager::PasswordInformation> passwords(m_passwords[host]);
+	const QVector<PasswordsManager::PasswordInformation> passwords(getHostPasswords(host));
 
 	for (int i = 0; i < passwords.count(); ++i)
 	{
@@ -431,25 +643,45 @@ bool FilePasswordsStorageBackend::hasPasswords(const QUrl &url, PasswordsManager
 
 	const QString host(Utils::extractHost(url));
 
-	if (types == PasswordsManager::AnyPassword)
+	return (m_hosts.contains(host) && (m_hosts[host].types & types));
+}
+
+bool FilePasswordsStorageBackend::writeStore(const QHash<QString, QByteArray> &payloads)
+{
+	QSaveFile file(getStorePath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		Console::addMessage(tr("Failed to save passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
+
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(StoreMagicNumber) << static_cast<quint32>(StoreFormatVersion);
+
+	QHash<QString, HostRecord> hosts(m_hosts);
+	QHash<QString, HostRecord>::iterator iterator;
+
+	for (iterator = hosts.begin(); iterator != hosts.end(); ++iterator)
 	{
-		return m_passwords.contains(host);
+		iterator.value().offset = file.pos();
+
+		stream << iterator.key() << static_cast<quint8>(iterator.value().types) << payloads.value(iterator.key());
 	}
 
-	if (m_passwords.contains(host))
+	if (stream.status() != QDataStream::Ok || !file.commit())
 	{
-		const QVector<PasswordsManager::PasswordInformation> passwords(m_passwords[host]);
+		Console::addMessage(tr("Failed to save passwords file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 
-		for (int i = 0; i < passwords.count(); ++i)
-		{
-			if (types.testFlag(passwords.at(i).type))
-			{
-				return true;
-			}
-		}
+		return false;
 	}
 
-	return false;
+	m_hosts = hosts;
+	m_storedRecordsAmount = hosts.count();
+
+	return true;
 }
 
 }
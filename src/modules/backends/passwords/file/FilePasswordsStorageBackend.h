@@ -23,6 +23,10 @@
 
 #include "../../../../core/PasswordsStorageBackend.h"
 
+#include <QtCore/QCache>
+
+class QJsonArray;
+
 namespace Otter
 {
 
@@ -48,11 +52,37 @@ public:
 	bool hasPasswords(const QUrl &url, PasswordsManager::PasswordTypes types = PasswordsManager::AnyPassword) override;
 
 protected:
+	enum StoreFormat : quint32
+	{
+		StoreMagicNumber = 0x4F505357,
+		StoreFormatVersion = 1
+	};
+
+	enum StoreParameter
+	{
+		DecodedHostsLimit = 100
+	};
+
+	struct HostRecord final
+	{
+		qint64 offset = -1;
+		PasswordsManager::PasswordTypes types = PasswordsManager::UnknownPassword;
+	};
+
 	void initialize();
-	void save();
+	void importLegacyPasswords(const QString &path);
+	void setPasswords(const QString &host, const QVector<PasswordsManager::PasswordInformation> &passwords);
+	static QString getStorePath();
+	static QByteArray serializePasswords(const QVector<PasswordsManager::PasswordInformation> &passwords);
+	QVector<PasswordsManager::PasswordInformation> getHostPasswords(const QString &host);
+	static QVector<PasswordsManager::PasswordInformation> deserializePasswords(const QJsonArray &passwordsArray);
+	QByteArray readPayload(const QString &host) const;
+	bool writeStore(const QHash<QString, QByteArray> &payloads);
 
 private:
-	QHash<QString, QVector<PasswordsManager::PasswordInformation> > m_passwords;
+	QCache<QString, QVector<PasswordsManager::PasswordInformation> > m_passwords;
+	QHash<QString, HostRecord> m_hosts;
+	int m_storedRecordsAmount;
 	bool m_isInitialized;
 };
 
@@ -25,7 +25,9 @@
 #include "../../../../core/ContentFiltersManager.h"
 #include "../../../../core/HandlersManager.h"
 #include "../../../../core/HistoryManager.h"
+#include "../../../../core/ScriptTemplate.h"
 #include "../../../../core/ThemesManager.h"
+#include "../../../../core/Tracer.h"
 #include "../../../../core/UserScript.h"
 #include "../../../../core/Utils.h"
 #include "../../../../ui/ContentsDialog.h"
@@ -43,19 +45,34 @@
 namespace Otter
 {
 
+QCache<QString, QString> QtWebEnginePage::m_cosmeticFiltersScripts(10);
+bool QtWebEnginePage::m_isCosmeticFiltersScriptsCacheConnected(false);
+
 QtWebEnginePage::QtWebEnginePage(bool isPrivate, QtWebEngineWebWidget *parent) : QWebEnginePage((isPrivate ? new QWebEngineProfile(parent) : QWebEngineProfile::defaultProfile()), parent),
 	m_widget(parent),
 	m_previousNavigationType(QtWebEnginePage::NavigationTypeOther),
+	m_isHistorySnapshotValid(false),
 	m_isIgnoringJavaScriptPopups(false),
 	m_isViewingMedia(false),
 	m_isPopup(false)
 {
-	if (isPrivate && m_widget)
+	if (isPrivate)
 	{
-		connect(profile(), &QWebEngineProfile::downloadRequested, qobject_cast<QtWebEngineWebBackend*>(m_widget->getBackend()), &QtWebEngineWebBackend::handleDownloadRequested);
+		if (m_widget)
+		{
+			connect(profile(), &QWebEngineProfile::downloadRequested, qobject_cast<QtWebEngineWebBackend*>(m_widget->getBackend()), &QtWebEngineWebBackend::handleDownloadRequested);
+		}
+		else
+		{
+			profile()->setParent(this);
+		}
 	}
 
+	connect(this, &QtWebEnginePage::loadStarted, this, &QtWebEnginePage::invalidateHistorySnapshot);
 	connect(this, &QtWebEnginePage::loadFinished, this, &QtWebEnginePage::handleLoadFinished);
+	connect(this, &QtWebEnginePage::urlChanged, this, &QtWebEnginePage::invalidateHistorySnapshot);
+	connect(this, &QtWebEnginePage::titleChanged, this, &QtWebEnginePage::invalidateHistorySnapshot);
+	connect(this, &QtWebEnginePage::iconChanged, this, &QtWebEnginePage::invalidateHistorySnapshot);
 }
 
 void QtWebEnginePage::validatePopup(const QUrl &url)
@@ -150,6 +167,8 @@ void QtWebEnginePage::handleLoadFinished()
 {
 	m_isIgnoringJavaScriptPopups = false;
 
+	invalidateHistorySnapshot();
+
 	const int historyIndex(history()->currentItemIndex());
 	HistoryEntryInformation entry(m_history.value(historyIndex));
 
@@ -169,33 +188,11 @@ void QtWebEnginePage::handleLoadFinished()
 	{
 		if (m_widget)
 		{
-			const QUrl url(m_widget->getUrl());
-			const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
-
-			if (!cosmeticFilters.rules.isEmpty() || !cosmeticFilters.exceptions.isEmpty())
-			{
-				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideElements.js"));
-
-				if (file.open(QIODevice::ReadOnly))
-				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(cosmeticFilters.exceptions), createJavaScriptList(cosmeticFilters.rules)));
-
-					file.close();
-				}
-			}
-
 			const QStringList blockedRequests(m_widget->getBlockedElements());
 
 			if (!blockedRequests.isEmpty())
 			{
-				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideBlockedRequests.js"));
-
-				if (file.open(QIODevice::ReadOnly))
-				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(blockedRequests)));
-
-					file.close();
-				}
+				runJavaScript(createScriptSource(QLatin1String("hideBlockedRequests"), {createJavaScriptList(blockedRequests)}));
 			}
 		}
 
@@ -229,19 +226,38 @@ void QtWebEnginePage::handleLoadFinished()
 	});
 }
 
+void QtWebEnginePage::setWidget(QtWebEngineWebWidget *widget)
+{
+	if (widget == m_widget)
+	{
+		return;
+	}
+
+	m_widget = widget;
+
+	setParent(widget);
+
+	if (widget && profile() != QWebEngineProfile::defaultProfile())
+	{
+		connect(profile(), &QWebEngineProfile::downloadRequested, qobject_cast<QtWebEngineWebBackend*>(widget->getBackend()), &QtWebEngineWebBackend::handleDownloadRequested);
+	}
+}
+
 void QtWebEnginePage::setHistory(const Session::Window::History &history)
 {
 	m_history.clear();
 
+	invalidateHistorySnapshot();
+
 	if (history.entries.isEmpty())
 	{
 		this->history()->clear();
 
 		const QVector<UserScript*> scripts(UserScript::getUserScriptsForUrl(QUrl(QLatin1String("about:blank"))));
 
-		for (int i = 0; i < scripts.count(); ++i)
+		if (!scripts.isEmpty())
 		{
-			runJavaScript(scripts.at(i)->getSource(), QWebEngineScript::UserWorld);
+			runJavaScript(UserScript::getSourceBundle(scripts), QWebEngineScript::UserWorld);
 		}
 
 		return;
@@ -281,6 +297,12 @@ void QtWebEnginePage::setHistory(const Session::Window::History &history)
 	}
 }
 
+void QtWebEnginePage::invalidateHistorySnapshot()
+{
+	m_isHistorySnapshotValid = false;
+	m_historySnapshot = {};
+}
+
 QtWebEngineWebWidget* QtWebEnginePage::getWebWidget() const
 {
 	return m_widget;
@@ -357,29 +379,67 @@ QString QtWebEnginePage::createJavaScriptList(const QStringList &rules) const
 	return QLatin1Char('\'') + parsedRules.join(QLatin1String("','")) + QLatin1Char('\'');
 }
 
-QString QtWebEnginePage::createScriptSource(const QString &path, const QStringList &parameters) const
+QString QtWebEnginePage::createCosmeticFiltersScript(const QUrl &url) const
 {
-	QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/") + path + QLatin1String(".js"));
+	if (!m_widget || url.host().isEmpty())
+	{
+		return {};
+	}
+
+	const QStringList profileNames(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList());
 
-	if (!file.open(QIODevice::ReadOnly))
+	if (profileNames.isEmpty())
 	{
 		return {};
 	}
 
-	QString script(QString::fromLatin1(file.readAll()));
+	if (!m_isCosmeticFiltersScriptsCacheConnected)
+	{
+		const auto clearCache([]()
+		{
+			m_cosmeticFiltersScripts.clear();
+		});
+
+		connect(ContentFiltersManager::getInstance(), &ContentFiltersManager::profileAdded, ContentFiltersManager::getInstance(), clearCache);
+		connect(ContentFiltersManager::getInstance(), &ContentFiltersManager::profileLoaded, ContentFiltersManager::getInstance(), clearCache);
+		connect(ContentFiltersManager::getInstance(), &ContentFiltersManager::profileModified, ContentFiltersManager::getInstance(), clearCache);
+		connect(ContentFiltersManager::getInstance(), &ContentFiltersManager::profileRemoved, ContentFiltersManager::getInstance(), clearCache);
+
+		m_isCosmeticFiltersScriptsCacheConnected = true;
+	}
+
+	const QString cacheKey(profileNames.join(QLatin1Char(',')) + QLatin1Char('|') + url.host());
+	const QString *cachedScript(m_cosmeticFiltersScripts.object(cacheKey));
+
+	if (cachedScript)
+	{
+		return *cachedScript;
+	}
 
-	file.close();
+	QString styleSheet(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(profileNames), url).styleSheet);
 
-	for (int i = 0; i < parameters.count(); ++i)
+	if (styleSheet.isEmpty())
 	{
-		script = script.arg(parameters.at(i));
+		return {};
 	}
 
+	styleSheet.replace(QLatin1Char('\\'), QLatin1String("\\\\")).replace(QLatin1Char('\''), QLatin1String("\\'")).replace(QLatin1Char('\n'), QLatin1String("\\n"));
+
+	const QString script(createScriptSource(QLatin1String("injectStyleSheet"), {styleSheet}));
+
+	m_cosmeticFiltersScripts.insert(cacheKey, new QString(script), qMax(1, (script.length() / 1048576)));
+
 	return script;
 }
 
+QString QtWebEnginePage::createScriptSource(const QString &path, const QStringList &parameters) const
+{
+	return ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebengine/resources/") + path + QLatin1String(".js")).createSource(parameters);
+}
+
 QVariant QtWebEnginePage::runScriptSource(const QString &script)
 {
+	const Tracer::Span span("QtWebEnginePage::runScriptSource", "scripts");
 	QVariant result;
 	QEventLoop eventLoop;
 
@@ -414,6 +474,13 @@ WebWidget::SslInformation QtWebEnginePage::getSslInformation() const
 
 Session::Window::History QtWebEnginePage::getHistory() const
 {
+	const bool isLoading(m_widget && m_widget->getLoadingState() == WebWidget::OngoingLoadingState);
+
+	if (m_isHistorySnapshotValid && !isLoading)
+	{
+		return m_historySnapshot;
+	}
+
 	QWebEngineHistory *pageHistory(history());
 	const int historyCount(pageHistory->count());
 	Session::Window::History history;
@@ -441,7 +508,7 @@ Session::Window::History QtWebEnginePage::getHistory() const
 		history.entries.append(entry);
 	}
 
-	if (m_widget && m_widget->getLoadingState() == WebWidget::OngoingLoadingState && url != pageHistory->itemAt(pageHistory->currentItemIndex()).url().toString())
+	if (isLoading && url != pageHistory->itemAt(pageHistory->currentItemIndex()).url().toString())
 	{
 		Session::Window::History::Entry entry;
 		entry.url = url;
@@ -454,6 +521,11 @@ Session::Window::History QtWebEnginePage::getHistory() const
 		history.entries.append(entry);
 		history.index = historyCount;
 	}
+	else if (!isLoading)
+	{
+		m_historySnapshot = history;
+		m_isHistorySnapshotValid = true;
+	}
 
 	return history;
 }
@@ -559,36 +631,71 @@ bool QtWebEnginePage::acceptNavigationRequest(const QUrl &url, NavigationType ty
 			}
 
 			m_history.append(entry);
+
+			invalidateHistorySnapshot();
 		}
 	}
 
 	scripts().clear();
 
-	const QVector<UserScript*> userScripts(UserScript::getUserScriptsForUrl(url));
+	const QString cosmeticFiltersScript(createCosmeticFiltersScript(isMainFrame ? url : this->url()));
 
-	for (int i = 0; i < userScripts.count(); ++i)
+	if (!cosmeticFiltersScript.isEmpty())
 	{
 		QWebEngineScript script;
-		script.setSourceCode(userScripts.at(i)->getSource());
-		script.setRunsOnSubFrames(userScripts.at(i)->shouldRunOnSubFrames());
+		script.setSourceCode(cosmeticFiltersScript);
+		script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+		script.setRunsOnSubFrames(false);
+		script.setWorldId(QWebEngineScript::ApplicationWorld);
 
-		switch (userScripts.at(i)->getInjectionTime())
+		scripts().insert(script);
+	}
+
+	const QVector<UserScript*> userScripts(UserScript::getUserScriptsForUrl(url));
+	const QVector<UserScript::InjectionTime> injectionTimes({UserScript::DocumentCreationTime, UserScript::DocumentReadyTime, UserScript::DeferredTime});
+
+	for (int i = 0; i < injectionTimes.count(); ++i)
+	{
+		for (int j = 0; j < 2; ++j)
 		{
-			case UserScript::DeferredTime:
-				script.setInjectionPoint(QWebEngineScript::Deferred);
+			const bool runsOnSubFrames(j == 0);
+			QVector<UserScript*> bundleScripts;
 
-				break;
-			case UserScript::DocumentCreationTime:
-				script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+			for (int k = 0; k < userScripts.count(); ++k)
+			{
+				if (userScripts.at(k)->getInjectionTime() == injectionTimes.at(i) && userScripts.at(k)->shouldRunOnSubFrames() == runsOnSubFrames)
+				{
+					bundleScripts.append(userScripts.at(k));
+				}
+			}
 
-				break;
-			default:
-				script.setInjectionPoint(QWebEngineScript::DocumentReady);
+			if (bundleScripts.isEmpty())
+			{
+				continue;
+			}
 
-				break;
-		}
+			QWebEngineScript script;
+			script.setSourceCode(UserScript::getSourceBundle(bundleScripts));
+			script.setRunsOnSubFrames(runsOnSubFrames);
 
-		scripts().insert(script);
+			switch (injectionTimes.at(i))
+			{
+				case UserScript::DeferredTime:
+					script.setInjectionPoint(QWebEngineScript::Deferred);
+
+					break;
+				case UserScript::DocumentCreationTime:
+					script.setInjectionPoint(QWebEngineScript::DocumentCreation);
+
+					break;
+				default:
+					script.setInjectionPoint(QWebEngineScript::DocumentReady);
+
+					break;
+			}
+
+			scripts().insert(script);
+		}
 	}
 
 	emit aboutToNavigate(url, type);
@@ -24,6 +24,7 @@
 #include "../../../../core/SessionsManager.h"
 #include "../../../../ui/WebWidget.h"
 
+#include <QtCore/QCache>
 #include <QtWebEngineWidgets/QWebEngineCertificateError>
 #include <QtWebEngineWidgets/QWebEnginePage>
 
@@ -50,7 +51,9 @@ public:
 
 	explicit QtWebEnginePage(bool isPrivate, QtWebEngineWebWidget *parent);
 
+	void setWidget(QtWebEngineWebWidget *widget);
 	void setHistory(const Session::Window::History &history);
+	void invalidateHistorySnapshot();
 	QtWebEngineWebWidget* getWebWidget() const;
 	QString createScriptSource(const QString &path, const QStringList &parameters = {}) const;
 	QVariant runScriptSource(const QString &script);
@@ -66,6 +69,7 @@ protected:
 	void javaScriptConsoleMessage(JavaScriptConsoleMessageLevel level, const QString &note, int line, const QString &source) override;
 	QWebEnginePage* createWindow(WebWindowType type) override;
 	QtWebEngineWebWidget* createWidget(SessionsManager::OpenHints hints);
+	QString createCosmeticFiltersScript(const QUrl &url) const;
 	QString createJavaScriptList(const QStringList &rules) const;
 	QStringList chooseFiles(FileSelectionMode mode, const QStringList &oldFiles, const QStringList &acceptedMimeTypes) override;
 	bool acceptNavigationRequest(const QUrl &url, NavigationType type, bool isMainFrame) override;
@@ -82,11 +86,16 @@ private:
 	WebWidget::SslInformation m_sslInformation;
 	QVector<QtWebEnginePage*> m_popups;
 	QVector<HistoryEntryInformation> m_history;
+	mutable Session::Window::History m_historySnapshot;
 	NavigationType m_previousNavigationType;
+	mutable bool m_isHistorySnapshotValid;
 	bool m_isIgnoringJavaScriptPopups;
 	bool m_isViewingMedia;
 	bool m_isPopup;
 
+	static QCache<QString, QString> m_cosmeticFiltersScripts;
+	static bool m_isCosmeticFiltersScriptsCacheConnected;
+
 signals:
 	void requestedNewWindow(WebWidget *widget, SessionsManager::OpenHints hints, const QVariantMap &parameters);
 	void requestedPopupWindow(const QUrl &parentUrl, const QUrl &popupUrl);
@@ -26,6 +26,7 @@
 #include "../../../../core/WebBackend.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 
 namespace Otter
 {
@@ -34,9 +35,7 @@ WebBackend* QtWebEngineUrlRequestInterceptor::m_backend(nullptr);
 
 QtWebEngineUrlRequestInterceptor::QtWebEngineUrlRequestInterceptor(QtWebEngineWebWidget *parent) : QWebEngineUrlRequestInterceptor(parent),
 	m_widget(parent),
-	m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy),
-	m_areImagesEnabled(true),
-	m_canSendReferrer(true)
+	m_areImagesEnabled(true)
 {
 }
 
@@ -49,53 +48,53 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 		return;
 	}
 
-	if (!m_contentBlockingProfiles.isEmpty() && (m_unblockedHosts.isEmpty() || !m_unblockedHosts.contains(Utils::extractHost(request.firstPartyUrl()))))
+	NetworkManager::ResourceType resourceType(NetworkManager::OtherType);
+	bool storeBlockedUrl(true);
+
+	switch (request.resourceType())
 	{
-		NetworkManager::ResourceType resourceType(NetworkManager::OtherType);
-		bool storeBlockedUrl(true);
+		case QWebEngineUrlRequestInfo::ResourceTypeMainFrame:
+			resourceType = NetworkManager::MainFrameType;
 
-		switch (request.resourceType())
-		{
-			case QWebEngineUrlRequestInfo::ResourceTypeMainFrame:
-				resourceType = NetworkManager::MainFrameType;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:
-				resourceType = NetworkManager::SubFrameType;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:
-				resourceType = NetworkManager::StyleSheetType;
-				storeBlockedUrl = false;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeScript:
-				resourceType = NetworkManager::ScriptType;
-				storeBlockedUrl = false;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeImage:
-				resourceType = NetworkManager::ImageType;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeObject:
-			case QWebEngineUrlRequestInfo::ResourceTypeMedia:
-				resourceType = NetworkManager::ObjectType;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypePluginResource:
-				resourceType = NetworkManager::ObjectSubrequestType;
-				storeBlockedUrl = false;
-
-				break;
-			case QWebEngineUrlRequestInfo::ResourceTypeXhr:
-				resourceType = NetworkManager::XmlHttpRequestType;
-
-				break;
-			default:
-				break;
-		}
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:
+			resourceType = NetworkManager::SubFrameType;
+
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:
+			resourceType = NetworkManager::StyleSheetType;
+			storeBlockedUrl = false;
+
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeScript:
+			resourceType = NetworkManager::ScriptType;
+			storeBlockedUrl = false;
+
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeImage:
+			resourceType = NetworkManager::ImageType;
+
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeObject:
+		case QWebEngineUrlRequestInfo::ResourceTypeMedia:
+			resourceType = NetworkManager::ObjectType;
+
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypePluginResource:
+			resourceType = NetworkManager::ObjectSubrequestType;
+			storeBlockedUrl = false;
 
+			break;
+		case QWebEngineUrlRequestInfo::ResourceTypeXhr:
+			resourceType = NetworkManager::XmlHttpRequestType;
+
+			break;
+		default:
+			break;
+	}
+
+	if (!m_contentBlockingProfiles.isEmpty() && (m_unblockedHosts.isEmpty() || !m_unblockedHosts.contains(Utils::extractHost(request.firstPartyUrl()))))
+	{
 		const ContentFiltersManager::CheckResult result(ContentFiltersManager::checkUrl(m_contentBlockingProfiles, request.firstPartyUrl(), request.requestUrl(), resourceType));
 
 		if (result.isBlocked)
@@ -104,22 +103,19 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg(profile ? profile->getTitle() : QCoreApplication::translate("main", "(Unknown)"), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
 
-			if (storeBlockedUrl && !m_blockedElements.contains(request.requestUrl().url()))
-			{
-				m_blockedElements.append(request.requestUrl().url());
-			}
-
 			NetworkManager::ResourceInformation resource;
 			resource.url = request.requestUrl();
 			resource.resourceType = resourceType;
 			resource.metaData[NetworkManager::ContentBlockingProfileMetaData] = result.profile;
 			resource.metaData[NetworkManager::ContentBlockingRuleMetaData] = result.rule;
 
-			m_blockedRequests.append(resource);
+			m_blockedRequests.addRequest(resource, storeBlockedUrl);
 
-			emit pageInformationChanged(WebWidget::RequestsBlockedInformation, m_blockedRequests.count());
+			emit pageInformationChanged(WebWidget::RequestsBlockedInformation, m_blockedRequests.getAmount());
 			emit requestBlocked(resource);
 
+			addRequestTiming(request, resourceType, true);
+
 			request.block(true);
 
 			return;
@@ -128,26 +124,47 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 	++m_startedRequestsAmount;
 
-	request.setHttpHeader(QByteArrayLiteral("Accept-Language"), (m_acceptLanguage.isEmpty() ? NetworkManagerFactory::getAcceptLanguage().toLatin1() : m_acceptLanguage.toLatin1()));
-	request.setHttpHeader(QByteArrayLiteral("User-Agent"), m_userAgent.toUtf8());
+	addRequestTiming(request, resourceType, false);
 
-	if (m_doNotTrackPolicy != NetworkManagerFactory::SkipTrackPolicy)
+	for (int i = 0; i < m_requestHeaders.headers.count(); ++i)
 	{
-		request.setHttpHeader(QByteArrayLiteral("DNT"), ((m_doNotTrackPolicy == NetworkManagerFactory::DoNotAllowToTrackPolicy) ? QByteArrayLiteral("1") : QByteArrayLiteral("0")));
+		request.setHttpHeader(m_requestHeaders.headers.at(i).first, m_requestHeaders.headers.at(i).second);
 	}
 
-	if (!m_canSendReferrer)
+	if (!m_requestHeaders.doNotTrack.isEmpty())
 	{
-		request.setHttpHeader(QByteArrayLiteral("Referer"), {});
+		request.setHttpHeader(QByteArrayLiteral("DNT"), m_requestHeaders.doNotTrack);
 	}
 
 	emit pageInformationChanged(WebWidget::RequestsStartedInformation, m_startedRequestsAmount);
 }
 
+void QtWebEngineUrlRequestInterceptor::addRequestTiming(const QWebEngineUrlRequestInfo &request, NetworkManager::ResourceType resourceType, bool isBlocked)
+{
+	if (m_requestTimings.count() >= RequestTimingsLimit)
+	{
+		return;
+	}
+
+	NetworkManager::RequestTiming timing;
+	timing.url = request.requestUrl();
+	timing.method = request.requestMethod();
+	timing.startTime = QDateTime::currentMSecsSinceEpoch();
+	timing.resourceType = resourceType;
+	timing.isBlocked = isBlocked;
+
+	if (isBlocked)
+	{
+		timing.finishedTime = timing.startTime;
+	}
+
+	m_requestTimings.append(timing);
+}
+
 void QtWebEngineUrlRequestInterceptor::resetStatistics()
 {
 	m_blockedRequests.clear();
-	m_blockedElements.clear();
+	m_requestTimings.clear();
 	m_startedRequestsAmount = 0;
 }
 
@@ -158,44 +175,14 @@ void QtWebEngineUrlRequestInterceptor::updateOptions(const QUrl &url)
 		m_backend = AddonsManager::getWebBackend(QLatin1String("qtwebengine"));
 	}
 
-	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption, url).toBool())
-	{
-		m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList());
-	}
-	else
-	{
-		m_contentBlockingProfiles.clear();
-	}
-
-	QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption, url).toString());
-	acceptLanguage = ((acceptLanguage.isEmpty()) ? QLatin1String(" ") : acceptLanguage.replace(QLatin1String("system"), QLocale::system().bcp47Name()));
-
-	m_acceptLanguage = ((acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : acceptLanguage);
-	m_userAgent = m_backend->getUserAgent(NetworkManagerFactory::getUserAgent(getOption(SettingsManager::Network_UserAgentOption, url).toString()).value);
-	m_unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption, url).toStringList();
-
-	const QString doNotTrackPolicyValue(getOption(SettingsManager::Network_DoNotTrackPolicyOption, url).toString());
-
-	if (doNotTrackPolicyValue == QLatin1String("allow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::AllowToTrackPolicy;
-	}
-	else if (doNotTrackPolicyValue == QLatin1String("doNotAllow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::DoNotAllowToTrackPolicy;
-	}
-	else
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
-	}
-
-	m_areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption, url).toString() != QLatin1String("disabled"));
-	m_canSendReferrer = getOption(SettingsManager::Network_EnableReferrerOption, url).toBool();
-}
+	const NetworkManagerFactory::NetworkProfile profile(NetworkManagerFactory::getNetworkProfile(url, (m_widget ? m_widget->getOptions() : QHash<int, QVariant>())));
 
-QVariant QtWebEngineUrlRequestInterceptor::getOption(int identifier, const QUrl &url) const
-{
-	return (m_widget ? m_widget->getOption(identifier, url) : SettingsManager::getOption(identifier, Utils::extractHost(url)));
+	m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(profile.contentBlockingProfiles);
+	m_userAgent = m_backend->getUserAgent(profile.userAgent);
+	m_unblockedHosts = profile.unblockedHosts;
+	m_requestHeaders = profile.requestHeaders;
+	m_requestHeaders.headers.append({QByteArrayLiteral("User-Agent"), m_userAgent.toUtf8()});
+	m_areImagesEnabled = profile.areImagesEnabled;
 }
 
 QVariant QtWebEngineUrlRequestInterceptor::getPageInformation(WebWidget::PageInformation key) const
@@ -203,7 +190,7 @@ QVariant QtWebEngineUrlRequestInterceptor::getPageInformation(WebWidget::PageInf
 	switch (key)
 	{
 		case WebWidget::RequestsBlockedInformation:
-			return m_blockedRequests.count();
+			return m_blockedRequests.getAmount();
 
 		case WebWidget::RequestsStartedInformation:
 			return m_startedRequestsAmount;
@@ -216,12 +203,22 @@ QVariant QtWebEngineUrlRequestInterceptor::getPageInformation(WebWidget::PageInf
 
 QStringList QtWebEngineUrlRequestInterceptor::getBlockedElements() const
 {
-	return m_blockedElements;
+	return m_blockedRequests.getElements();
 }
 
 QVector<NetworkManager::ResourceInformation> QtWebEngineUrlRequestInterceptor::getBlockedRequests() const
 {
-	return m_blockedRequests;
+	return m_blockedRequests.getRequests();
+}
+
+QHash<int, int> QtWebEngineUrlRequestInterceptor::getBlockedProfilesAmounts() const
+{
+	return m_blockedRequests.getProfilesAmounts();
+}
+
+QVector<NetworkManager::RequestTiming> QtWebEngineUrlRequestInterceptor::getRequestTimings() const
+{
+	return m_requestTimings;
 }
 
 }
@@ -40,10 +40,17 @@ public:
 	void interceptRequest(QWebEngineUrlRequestInfo &request) override;
 	QStringList getBlockedElements() const;
 	QVector<NetworkManager::ResourceInformation> getBlockedRequests() const;
+	QVector<NetworkManager::RequestTiming> getRequestTimings() const;
+	QHash<int, int> getBlockedProfilesAmounts() const;
 
 protected:
+	enum RequestTimingParameter
+	{
+		RequestTimingsLimit = 5000
+	};
+
+	void addRequestTiming(const QWebEngineUrlRequestInfo &request, NetworkManager::ResourceType resourceType, bool isBlocked);
 	void updateOptions(const QUrl &url);
-	QVariant getOption(int identifier, const QUrl &url) const;
 	QVariant getPageInformation(WebWidget::PageInformation key) const;
 
 protected slots:
@@ -51,16 +58,14 @@ protected slots:
 
 private:
 	QtWebEngineWebWidget *m_widget;
-	QString m_acceptLanguage;
 	QString m_userAgent;
-	QStringList m_blockedElements;
 	QStringList m_unblockedHosts;
-	QVector<NetworkManager::ResourceInformation> m_blockedRequests;
+	BlockedRequestsLog m_blockedRequests;
+	QVector<NetworkManager::RequestTiming> m_requestTimings;
 	QVector<int> m_contentBlockingProfiles;
-	NetworkManagerFactory::DoNotTrackPolicy m_doNotTrackPolicy;
+	NetworkManagerFactory::RequestHeaders m_requestHeaders;
 	quint64 m_startedRequestsAmount;
 	bool m_areImagesEnabled;
-	bool m_canSendReferrer;
 
 	static WebBackend *m_backend;
 
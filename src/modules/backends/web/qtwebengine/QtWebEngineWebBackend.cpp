@@ -34,6 +34,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QTimerEvent>
 #include <QtWebEngineWidgets/QWebEngineProfile>
 #include <QtWebEngineWidgets/QWebEngineSettings>
 
@@ -45,7 +46,9 @@ QHash<QString, QString> QtWebEngineWebBackend::m_userAgentComponents;
 QMap<QString, QString> QtWebEngineWebBackend::m_userAgents;
 
 QtWebEngineWebBackend::QtWebEngineWebBackend(QObject *parent) : WebBackend(parent),
-	m_isInitialized(false)
+	m_preloadPagesTimer(0),
+	m_isInitialized(false),
+	m_isPreloadingPrivatePages(false)
 {
 	const QString userAgent(QWebEngineProfile::defaultProfile()->httpUserAgent());
 
@@ -139,6 +142,10 @@ void QtWebEngineWebBackend::handleOptionChanged(int identifier)
 {
 	switch (identifier)
 	{
+		case SettingsManager::Browser_PreloadedPagesAmountOption:
+			schedulePagesPreloading();
+
+			return;
 		case SettingsManager::Browser_PrintElementBackgroundsOption:
 			QWebEngineSettings::globalSettings()->setAttribute(QWebEngineSettings::PrintElementBackgrounds, SettingsManager::getOption(SettingsManager::Browser_PrintElementBackgroundsOption).toBool());
 
@@ -260,6 +267,82 @@ WebWidget* QtWebEngineWebBackend::createWidget(const QVariantMap &parameters, Co
 	return new QtWebEngineWebWidget(parameters, this, parent);
 }
 
+void QtWebEngineWebBackend::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_preloadPagesTimer)
+	{
+		return;
+	}
+
+	const int amount(qBound(0, SettingsManager::getOption(SettingsManager::Browser_PreloadedPagesAmountOption).toInt(), 2));
+
+	while (m_preloadedPages.count() > amount)
+	{
+		m_preloadedPages.takeLast()->deleteLater();
+	}
+
+	while (m_preloadedPrivatePages.count() > amount)
+	{
+		m_preloadedPrivatePages.takeLast()->deleteLater();
+	}
+
+	QtWebEnginePage *page(nullptr);
+
+	if (m_preloadedPages.count() < amount)
+	{
+		page = new QtWebEnginePage(false, nullptr);
+
+		m_preloadedPages.append(page);
+	}
+	else if (m_isPreloadingPrivatePages && m_preloadedPrivatePages.count() < amount)
+	{
+		page = new QtWebEnginePage(true, nullptr);
+
+		m_preloadedPrivatePages.append(page);
+	}
+
+	if (page)
+	{
+		page->setParent(this);
+	}
+	else
+	{
+		killTimer(m_preloadPagesTimer);
+
+		m_preloadPagesTimer = 0;
+	}
+}
+
+void QtWebEngineWebBackend::schedulePagesPreloading()
+{
+	if (m_preloadPagesTimer == 0)
+	{
+		m_preloadPagesTimer = startTimer(1000);
+	}
+}
+
+QtWebEnginePage* QtWebEngineWebBackend::createPage(bool isPrivate, QtWebEngineWebWidget *widget)
+{
+	QVector<QtWebEnginePage*> &pages(isPrivate ? m_preloadedPrivatePages : m_preloadedPages);
+
+	if (isPrivate)
+	{
+		m_isPreloadingPrivatePages = true;
+	}
+
+	schedulePagesPreloading();
+
+	if (pages.isEmpty())
+	{
+		return new QtWebEnginePage(isPrivate, widget);
+	}
+
+	QtWebEnginePage *page(pages.takeFirst());
+	page->setWidget(widget);
+
+	return page;
+}
+
 QString QtWebEngineWebBackend::getName() const
 {
 	return QLatin1String("qtwebengine");
@@ -33,6 +33,7 @@ namespace Otter
 
 class QtWebEnginePage;
 class QtWebEngineUrlRequestInterceptor;
+class QtWebEngineWebWidget;
 
 class QtWebEngineWebBackend final : public WebBackend
 {
@@ -54,6 +55,9 @@ public:
 	bool hasSslSupport() const override;
 
 protected:
+	void timerEvent(QTimerEvent *event) override;
+	void schedulePagesPreloading();
+	QtWebEnginePage* createPage(bool isPrivate, QtWebEngineWebWidget *widget);
 	static void showNotification(std::unique_ptr<QWebEngineNotification> nativeNotification);
 
 protected slots:
@@ -61,13 +65,18 @@ protected slots:
 	void handleOptionChanged(int identifier);
 
 private:
+	QVector<QtWebEnginePage*> m_preloadedPages;
+	QVector<QtWebEnginePage*> m_preloadedPrivatePages;
+	int m_preloadPagesTimer;
 	bool m_isInitialized;
+	bool m_isPreloadingPrivatePages;
 
 	static QString m_engineVersion;
 	static QHash<QString, QString> m_userAgentComponents;
 	static QMap<QString, QString> m_userAgents;
 
 friend class QtWebEnginePage;
+friend class QtWebEngineWebWidget;
 };
 
 }
@@ -20,6 +20,7 @@
 #include "QtWebEngineWebWidget.h"
 #include "QtWebEnginePage.h"
 #include "QtWebEngineUrlRequestInterceptor.h"
+#include "QtWebEngineWebBackend.h"
 #include "../../../../core/Application.h"
 #include "../../../../core/BookmarksManager.h"
 #include "../../../../core/Console.h"
@@ -84,15 +85,63 @@ void QtWebEngineInspectorWidget::showEvent(QShowEvent *event)
 	QWebEngineView::showEvent(event);
 }
 
+QtWebEnginePrintJob::QtWebEnginePrintJob(QPrinter *printer, QWebEnginePage *page, QObject *parent) : PrintJob(printer, parent),
+	m_page(page),
+	m_isRunning(false)
+{
+}
+
+void QtWebEnginePrintJob::start()
+{
+	if (!m_page)
+	{
+		emit jobFinished(false);
+
+		return;
+	}
+
+	m_isRunning = true;
+
+	setProgress(0);
+
+	const QPointer<QtWebEnginePrintJob> job(this);
+
+	m_page->print(getPrinter(), [=](bool isSuccess)
+	{
+		if (job)
+		{
+			job->m_isRunning = false;
+			job->setProgress(100);
+
+			emit job->jobFinished(isSuccess);
+		}
+	});
+}
+
+void QtWebEnginePrintJob::cancel()
+{
+	if (!m_isRunning)
+	{
+		emit jobFinished(false);
+	}
+}
+
+bool QtWebEnginePrintJob::isRunning() const
+{
+	return m_isRunning;
+}
+
 QtWebEngineWebWidget::QtWebEngineWebWidget(const QVariantMap &parameters, WebBackend *backend, ContentsWidget *parent) : WebWidget(parameters, backend, parent),
 	m_webView(nullptr),
 	m_inspectorWidget(nullptr),
-	m_page(new QtWebEnginePage(SessionsManager::calculateOpenHints(parameters).testFlag(SessionsManager::PrivateOpen), this)),
+	m_page(qobject_cast<QtWebEngineWebBackend*>(backend)->createPage(SessionsManager::calculateOpenHints(parameters).testFlag(SessionsManager::PrivateOpen), this)),
 	m_requestInterceptor(new QtWebEngineUrlRequestInterceptor(this)),
 	m_loadingState(FinishedLoadingState),
 	m_canGoForwardValue(UnknownValue),
+	m_loadIdentifier(0),
 	m_documentLoadingProgress(0),
 	m_focusProxyTimer(0),
+	m_hitTestPrefetchTimer(0),
 	m_updateNavigationActionsTimer(0),
 	m_isClosing(false),
 	m_isEditing(false),
@@ -107,7 +156,7 @@ QtWebEngineWebWidget::QtWebEngineWebWidget(const QVariantMap &parameters, WebBac
 	{
 		m_documentLoadingProgress = progress;
 
-		emit pageInformationChanged(DocumentLoadingProgressInformation, progress);
+		notifyPageInformationChanged(DocumentLoadingProgressInformation, progress);
 	});
 	connect(m_page, &QtWebEnginePage::loadStarted, this, &QtWebEngineWebWidget::handleLoadStarted);
 	connect(m_page, &QtWebEnginePage::loadFinished, this, &QtWebEngineWebWidget::handleLoadFinished);
@@ -138,10 +187,14 @@ QtWebEngineWebWidget::QtWebEngineWebWidget(const QVariantMap &parameters, WebBac
 	connect(m_page, &QtWebEnginePage::titleChanged, this, &QtWebEngineWebWidget::notifyTitleChanged);
 	connect(m_page, &QtWebEnginePage::urlChanged, this, &QtWebEngineWebWidget::notifyUrlChanged);
 	connect(m_page, &QtWebEnginePage::renderProcessTerminated, this, &QtWebEngineWebWidget::notifyRenderProcessTerminated);
+	connect(m_page, &QtWebEnginePage::loadStarted, this, &QtWebEngineWebWidget::clearHitTestCache);
+	connect(m_page, &QtWebEnginePage::scrollPositionChanged, this, &QtWebEngineWebWidget::clearHitTestCache);
+	connect(m_page, &QtWebEnginePage::contentsSizeChanged, this, &QtWebEngineWebWidget::clearHitTestCache);
+	connect(m_page, &QtWebEnginePage::selectionChanged, this, &QtWebEngineWebWidget::clearHitTestCache);
 	connect(m_page->action(QWebEnginePage::Redo), &QAction::changed, this, &QtWebEngineWebWidget::notifyRedoActionStateChanged);
 	connect(m_page->action(QWebEnginePage::Undo), &QAction::changed, this, &QtWebEngineWebWidget::notifyUndoActionStateChanged);
 	connect(m_page, &QtWebEnginePage::aboutToNavigate, m_requestInterceptor, &QtWebEngineUrlRequestInterceptor::resetStatistics);
-	connect(m_requestInterceptor, &QtWebEngineUrlRequestInterceptor::pageInformationChanged, this, &QtWebEngineWebWidget::pageInformationChanged);
+	connect(m_requestInterceptor, &QtWebEngineUrlRequestInterceptor::pageInformationChanged, this, &QtWebEngineWebWidget::notifyPageInformationChanged);
 	connect(m_requestInterceptor, &QtWebEngineUrlRequestInterceptor::requestBlocked, this, &QtWebEngineWebWidget::requestBlocked);
 }
 
@@ -160,6 +213,17 @@ void QtWebEngineWebWidget::timerEvent(QTimerEvent *event)
 			focusWidget()->installEventFilter(this);
 		}
 	}
+	else if (event->timerId() == m_hitTestPrefetchTimer)
+	{
+		killTimer(m_hitTestPrefetchTimer);
+
+		m_hitTestPrefetchTimer = 0;
+
+		requestHitTestResult(m_hitTestPrefetchPosition, [](const HitTestResult &hitResult)
+		{
+			Q_UNUSED(hitResult)
+		});
+	}
 	else if (event->timerId() == m_updateNavigationActionsTimer)
 	{
 		killTimer(m_updateNavigationActionsTimer);
@@ -204,6 +268,120 @@ void QtWebEngineWebWidget::focusInEvent(QFocusEvent *event)
 	m_webView->setFocus();
 }
 
+void QtWebEngineWebWidget::collectPageMetadata(const QVector<ChangeWatcher> &watchers)
+{
+	QVector<ChangeWatcher> requestedWatchers;
+	QStringList sections;
+
+	for (int i = 0; i < watchers.count(); ++i)
+	{
+		const ChangeWatcher watcher(watchers.at(i));
+
+		if (m_pendingMetaDataWatchers.contains(watcher) || hasWatchedChanges(watcher))
+		{
+			continue;
+		}
+
+		switch (watcher)
+		{
+			case FeedsWatcher:
+				sections.append(QLatin1String("feeds: true"));
+
+				break;
+			case LinksWatcher:
+				sections.append(QLatin1String("links: true"));
+
+				break;
+			case MetaDataWatcher:
+				sections.append(QLatin1String("metaData: true"));
+
+				break;
+			case SearchEnginesWatcher:
+				sections.append(QLatin1String("searchEngines: true"));
+
+				break;
+			case StylesheetsWatcher:
+				sections.append(QLatin1String("styleSheets: true"));
+
+				break;
+			default:
+				continue;
+		}
+
+		requestedWatchers.append(watcher);
+	}
+
+	if (requestedWatchers.isEmpty())
+	{
+		return;
+	}
+
+	const quint64 loadIdentifier(m_loadIdentifier);
+
+	m_pendingMetaDataWatchers.append(requestedWatchers);
+
+	m_page->runJavaScript(m_page->createScriptSource(QLatin1String("collectPageMetadata"), {QLatin1Char('{') + sections.join(QLatin1String(", ")) + QLatin1Char('}')}), [=](const QVariant &result)
+	{
+		if (m_isClosing || loadIdentifier != m_loadIdentifier)
+		{
+			return;
+		}
+
+		const QVariantMap metaData(result.toMap());
+
+		for (int i = 0; i < requestedWatchers.count(); ++i)
+		{
+			const ChangeWatcher watcher(requestedWatchers.at(i));
+
+			m_pendingMetaDataWatchers.removeAll(watcher);
+
+			switch (watcher)
+			{
+				case FeedsWatcher:
+					m_feeds = processLinks(metaData.value(QLatin1String("feeds")).toList());
+
+					break;
+				case LinksWatcher:
+					m_links = processLinks(metaData.value(QLatin1String("links")).toList());
+
+					break;
+				case MetaDataWatcher:
+					{
+						const QVariantList rawMetaData(metaData.value(QLatin1String("metaData")).toList());
+
+						m_metaData.clear();
+
+						for (int j = 0; j < rawMetaData.count(); ++j)
+						{
+							const QVariantHash entry(rawMetaData.at(j).toHash());
+
+							m_metaData.insert(entry.value(QLatin1String("key")).toString(), entry.value(QLatin1String("value")).toString());
+						}
+					}
+
+					break;
+				case SearchEnginesWatcher:
+					m_searchEngines = processLinks(metaData.value(QLatin1String("searchEngines")).toList());
+
+					break;
+				case StylesheetsWatcher:
+					m_styleSheets = metaData.value(QLatin1String("styleSheets")).toStringList();
+
+					break;
+				default:
+					break;
+			}
+
+			notifyWatchedDataChanged(watcher);
+		}
+	});
+}
+
+void QtWebEngineWebWidget::clearHitTestCache()
+{
+	m_hitResultsCache.clear();
+}
+
 void QtWebEngineWebWidget::ensureInitialized()
 {
 	if (!m_webView)
@@ -270,6 +448,7 @@ void QtWebEngineWebWidget::triggerAction(int identifier, const QVariantMap &para
 			setUrl(QUrl(QLatin1String("about:blank")));
 
 			m_page->history()->clear();
+			m_page->invalidateHistorySnapshot();
 
 			notifyNavigationActionsChanged();
 
@@ -699,14 +878,14 @@ void QtWebEngineWebWidget::triggerAction(int identifier, const QVariantMap &para
 			break;
 		case ActionsManager::CreateSearchAction:
 			{
-				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/createSearch.js"));
+				const QString script(m_page->createScriptSource(QLatin1String("createSearch")));
 
-				if (!file.open(QIODevice::ReadOnly))
+				if (script.isEmpty())
 				{
 					break;
 				}
 
-				m_page->runJavaScript(parsePosition(QString::fromLatin1(file.readAll()), getClickPosition()), [&](const QVariant &result)
+				m_page->runJavaScript(parsePosition(script, getClickPosition()), [&](const QVariant &result)
 				{
 					if (result.isNull())
 					{
@@ -731,8 +910,6 @@ void QtWebEngineWebWidget::triggerAction(int identifier, const QVariantMap &para
 						SearchEnginesManager::addSearchEngine(dialog.getSearchEngine());
 					}
 				});
-
-				file.close();
 			}
 
 			break;
@@ -927,8 +1104,45 @@ void QtWebEngineWebWidget::print(QPrinter *printer)
 	eventLoop.exec();
 }
 
+void QtWebEngineWebWidget::requestHitTestResult(const QPoint &position, const std::function<void(const HitTestResult &hitResult)> &callback)
+{
+	HitTestResult hitResult;
+
+	if (getCachedHitTestResult(position, &hitResult))
+	{
+		callback(hitResult);
+
+		return;
+	}
+
+	const QPointer<QtWebEngineWebWidget> widget(this);
+
+	m_page->runJavaScript(m_page->createScriptSource(QLatin1String("hitTest"), {QString::number(position.x() / m_page->zoomFactor()), QString::number(position.y() / m_page->zoomFactor())}), [=](const QVariant &result)
+	{
+		if (widget && !widget->m_isClosing)
+		{
+			callback(widget->handleHitTestResult(position, result));
+		}
+	});
+}
+
+void QtWebEngineWebWidget::requestDocumentText(const std::function<void(const QString &text)> &callback)
+{
+	const QPointer<QtWebEngineWebWidget> widget(this);
+
+	m_page->toPlainText([=](const QString &text)
+	{
+		if (widget && !widget->m_isClosing)
+		{
+			callback(text);
+		}
+	});
+}
+
 void QtWebEngineWebWidget::handleLoadStarted()
 {
+	++m_loadIdentifier;
+
 	m_lastUrlClickTime = {};
 	m_metaData.clear();
 	m_styleSheets.clear();
@@ -936,6 +1150,7 @@ void QtWebEngineWebWidget::handleLoadStarted()
 	m_links.clear();
 	m_searchEngines.clear();
 	m_watchedChanges.clear();
+	m_pendingMetaDataWatchers.clear();
 	m_loadingState = OngoingLoadingState;
 	m_documentLoadingProgress = 0;
 
@@ -944,7 +1159,8 @@ void QtWebEngineWebWidget::handleLoadStarted()
 
 	emit geometryChanged();
 	emit loadingStateChanged(OngoingLoadingState);
-	emit pageInformationChanged(DocumentLoadingProgressInformation, 0);
+
+	notifyPageInformationChanged(DocumentLoadingProgressInformation, 0);
 }
 
 void QtWebEngineWebWidget::handleLoadFinished()
@@ -963,15 +1179,18 @@ void QtWebEngineWebWidget::handleLoadFinished()
 	});
 
 	const QVector<ChangeWatcher> watchers({FeedsWatcher, LinksWatcher, MetaDataWatcher, SearchEnginesWatcher, StylesheetsWatcher});
+	QVector<ChangeWatcher> activeWatchers;
 
 	for (int i = 0; i < watchers.count(); ++i)
 	{
 		if (isWatchingChanges(watchers.at(i)))
 		{
-			updateWatchedData(watchers.at(i));
+			activeWatchers.append(watchers.at(i));
 		}
 	}
 
+	collectPageMetadata(activeWatchers);
+
 	emit contentStateChanged(getContentState());
 	emit loadingStateChanged(FinishedLoadingState);
 }
@@ -1102,7 +1321,7 @@ void QtWebEngineWebWidget::notifyUrlChanged()
 	emit urlChanged((url.toString() == QLatin1String("about:blank")) ? m_page->requestedUrl() : url);
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void QtWebEngineWebWidget::notifyIconChanged()
@@ -1230,66 +1449,14 @@ void QtWebEngineWebWidget::updateOptions(const QUrl &url)
 
 void QtWebEngineWebWidget::updateWatchedData(ChangeWatcher watcher)
 {
-	switch (watcher)
+	if (hasWatchedChanges(watcher))
 	{
-		case FeedsWatcher:
-			m_page->runJavaScript(m_page->createScriptSource(QLatin1String("getLinks"), {QLatin1String(R"(a[type=\'application/atom+xml\'], a[type=\'application/rss+xml\'], link[type=\'application/atom+xml\'], link[type=\'application/rss+xml\'])")}), [&](const QVariant &result)
-			{
-				m_feeds = processLinks(result.toList());
-
-				notifyWatchedDataChanged(FeedsWatcher);
-			});
-
-			break;
-		case LinksWatcher:
-			m_page->runJavaScript(m_page->createScriptSource(QLatin1String("getLinks"), {QLatin1String("a[href]")}), [&](const QVariant &result)
-			{
-				m_links = processLinks(result.toList());
-
-				notifyWatchedDataChanged(LinksWatcher);
-			});
+		emit watchedDataChanged(watcher);
 
-			break;
-		case MetaDataWatcher:
-			m_page->runJavaScript(QLatin1String("var elements = document.querySelectorAll('meta'); var metaData = []; for (var i = 0; i < elements.length; ++i) { if (elements[i].name !== '') { metaData.push({key: elements[i].name, value: elements[i].content}); } } metaData;"), [&](const QVariant &result)
-			{
-				QMultiMap<QString, QString> metaData;
-				const QVariantList rawMetaData(result.toList());
-
-				for (int i = 0; i < rawMetaData.count(); ++i)
-				{
-					const QVariantHash entry(rawMetaData.at(i).toHash());
-
-					metaData.insert(entry.value(QLatin1String("key")).toString(), entry.value(QLatin1String("value")).toString());
-				}
-
-				m_metaData = metaData;
-
-				notifyWatchedDataChanged(MetaDataWatcher);
-			});
-
-			break;
-		case SearchEnginesWatcher:
-			m_page->runJavaScript(m_page->createScriptSource(QLatin1String("getLinks"), {QLatin1String("link[type=\\'application/opensearchdescription+xml\\']")}), [&](const QVariant &result)
-			{
-				m_searchEngines = processLinks(result.toList());
-
-				notifyWatchedDataChanged(SearchEnginesWatcher);
-			});
-
-			break;
-		case StylesheetsWatcher:
-			m_page->runJavaScript(m_page->createScriptSource(QLatin1String("getStyleSheets")), [&](const QVariant &result)
-			{
-				m_styleSheets = result.toStringList();
-
-				notifyWatchedDataChanged(StylesheetsWatcher);
-			});
-
-			break;
-		default:
-			break;
+		return;
 	}
+
+	collectPageMetadata({watcher});
 }
 
 void QtWebEngineWebWidget::setScrollPosition(const QPoint &position)
@@ -1325,6 +1492,8 @@ void QtWebEngineWebWidget::setHistory(QDataStream &stream)
 	stream.device()->reset();
 	stream >> *(m_page->history());
 
+	m_page->invalidateHistorySnapshot();
+
 	const QUrl url(m_page->history()->currentItem().url());
 
 	setRequestedUrl(url, false, true);
@@ -1337,7 +1506,7 @@ void QtWebEngineWebWidget::setZoom(int zoom)
 	{
 		m_page->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
@@ -1453,6 +1622,18 @@ void QtWebEngineWebWidget::setOptions(const QHash<int, QVariant> &options, const
 	updateOptions(getUrl());
 }
 
+void QtWebEngineWebWidget::setThrottled(bool isThrottled)
+{
+	if (!isThrottled)
+	{
+		m_page->setLifecycleState(QWebEnginePage::LifecycleState::Active);
+	}
+	else if (m_page->recommendedState() != QWebEnginePage::LifecycleState::Active)
+	{
+		m_page->setLifecycleState(QWebEnginePage::LifecycleState::Frozen);
+	}
+}
+
 WebWidget* QtWebEngineWebWidget::clone(bool cloneHistory, bool isPrivate, const QStringList &excludedOptions) const
 {
 	QtWebEngineWebWidget *widget((this->isPrivate() || isPrivate) ? new QtWebEngineWebWidget({{QLatin1String("hints"), SessionsManager::PrivateOpen}}, getBackend()) : new QtWebEngineWebWidget({}, getBackend()));
@@ -1622,6 +1803,11 @@ QPixmap QtWebEngineWebWidget::createThumbnail(const QSize &size)
 	return pixmap;
 }
 
+PrintJob* QtWebEngineWebWidget::createPrintJob(QPrinter *printer)
+{
+	return new QtWebEnginePrintJob(printer, m_page, this);
+}
+
 QDateTime QtWebEngineWebWidget::getLastUrlClickTime() const
 {
 	return m_lastUrlClickTime;
@@ -1702,7 +1888,21 @@ Session::Window::History QtWebEngineWebWidget::getHistory() const
 
 WebWidget::HitTestResult QtWebEngineWebWidget::getHitTestResult(const QPoint &position)
 {
-	m_hitResult = QtWebEngineHitTestResult(m_page->runScriptFile(QLatin1String("hitTest"), {QString::number(position.x() / m_page->zoomFactor()), QString::number(position.y() / m_page->zoomFactor())}));
+	HitTestResult hitResult;
+
+	if (getCachedHitTestResult(position, &hitResult))
+	{
+		m_hitResult = hitResult;
+
+		return m_hitResult;
+	}
+
+	return handleHitTestResult(position, m_page->runScriptFile(QLatin1String("hitTest"), {QString::number(position.x() / m_page->zoomFactor()), QString::number(position.y() / m_page->zoomFactor())}));
+}
+
+WebWidget::HitTestResult QtWebEngineWebWidget::handleHitTestResult(const QPoint &position, const QVariant &rawResult)
+{
+	m_hitResult = QtWebEngineHitTestResult(rawResult);
 
 	if (m_hitResult.flags.testFlag(HitTestResult::IsSelectedTest) && !m_hitResult.linkUrl.isValid() && Utils::isUrl(m_page->selectedText()))
 	{
@@ -1710,6 +1910,25 @@ WebWidget::HitTestResult QtWebEngineWebWidget::getHitTestResult(const QPoint &po
 		m_hitResult.linkUrl = QUrl::fromUserInput(m_page->selectedText());
 	}
 
+	for (int i = (m_hitResultsCache.count() - 1); i >= 0; --i)
+	{
+		if (m_hitResultsCache.at(i).position == position)
+		{
+			m_hitResultsCache.remove(i);
+		}
+	}
+
+	if (m_hitResultsCache.count() >= HitTestCacheSize)
+	{
+		m_hitResultsCache.removeLast();
+	}
+
+	HitTestCacheEntry entry;
+	entry.result = m_hitResult;
+	entry.position = position;
+
+	m_hitResultsCache.prepend(entry);
+
 	return m_hitResult;
 }
 
@@ -1757,6 +1976,16 @@ QVector<NetworkManager::ResourceInformation> QtWebEngineWebWidget::getBlockedReq
 	return m_requestInterceptor->getBlockedRequests();
 }
 
+QVector<NetworkManager::RequestTiming> QtWebEngineWebWidget::getRequestTimings() const
+{
+	return m_requestInterceptor->getRequestTimings();
+}
+
+QHash<int, int> QtWebEngineWebWidget::getBlockedProfilesAmounts() const
+{
+	return m_requestInterceptor->getBlockedProfilesAmounts();
+}
+
 QMultiMap<QString, QString> QtWebEngineWebWidget::getMetaData() const
 {
 	return m_metaData;
@@ -1772,6 +2001,21 @@ int QtWebEngineWebWidget::getZoom() const
 	return static_cast<int>(m_page->zoomFactor() * 100);
 }
 
+bool QtWebEngineWebWidget::getCachedHitTestResult(const QPoint &position, HitTestResult *hitResult) const
+{
+	for (int i = 0; i < m_hitResultsCache.count(); ++i)
+	{
+		if (m_hitResultsCache.at(i).position == position)
+		{
+			*hitResult = m_hitResultsCache.at(i).result;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool QtWebEngineWebWidget::canGoBack() const
 {
 	return m_page->history()->canGoBack();
@@ -1951,6 +2195,32 @@ bool QtWebEngineWebWidget::eventFilter(QObject *object, QEvent *event)
 				}
 			}
 
+			break;
+		case QEvent::KeyPress:
+		case QEvent::MouseButtonRelease:
+			clearHitTestCache();
+
+			break;
+		case QEvent::MouseMove:
+			{
+				const QMouseEvent *mouseEvent(static_cast<QMouseEvent*>(event));
+
+				clearHitTestCache();
+
+				if (m_hitTestPrefetchTimer != 0)
+				{
+					killTimer(m_hitTestPrefetchTimer);
+
+					m_hitTestPrefetchTimer = 0;
+				}
+
+				if (mouseEvent && mouseEvent->buttons() == Qt::NoButton)
+				{
+					m_hitTestPrefetchPosition = mouseEvent->pos();
+					m_hitTestPrefetchTimer = startTimer(HitTestPrefetchDelay);
+				}
+			}
+
 			break;
 		case QEvent::Move:
 		case QEvent::Resize:
@@ -20,6 +20,7 @@
 #ifndef OTTER_QTWEBENGINEWEBWIDGET_H
 #define OTTER_QTWEBENGINEWEBWIDGET_H
 
+#include "../../../../core/Job.h"
 #include "../../../../ui/WebWidget.h"
 
 #include <QtNetwork/QNetworkReply>
@@ -45,6 +46,24 @@ private:
 	QWebEnginePage *m_inspectedPage;
 };
 
+class QtWebEnginePrintJob final : public PrintJob
+{
+	Q_OBJECT
+
+public:
+	explicit QtWebEnginePrintJob(QPrinter *printer, QWebEnginePage *page, QObject *parent = nullptr);
+
+	bool isRunning() const override;
+
+public slots:
+	void start() override;
+	void cancel() override;
+
+private:
+	QPointer<QWebEnginePage> m_page;
+	bool m_isRunning;
+};
+
 class QtWebEngineWebWidget final : public WebWidget
 {
 	Q_OBJECT
@@ -77,6 +96,8 @@ public:
 
 	void search(const QString &query, const QString &searchEngine) override;
 	void print(QPrinter *printer) override;
+	void requestHitTestResult(const QPoint &position, const std::function<void(const HitTestResult &hitResult)> &callback) override;
+	void requestDocumentText(const std::function<void(const QString &text)> &callback) override;
 	WebWidget* clone(bool cloneHistory = true, bool isPrivate = false, const QStringList &excludedOptions = {}) const override;
 	QWidget* getInspector() override;
 	QWidget* getViewport() override;
@@ -88,6 +109,7 @@ public:
 	QUrl getUrl() const override;
 	QIcon getIcon() const override;
 	QPixmap createThumbnail(const QSize &size = {}) override;
+	PrintJob* createPrintJob(QPrinter *printer) override;
 	QPoint getScrollPosition() const override;
 	LinkUrl getActiveFrame() const override;
 	LinkUrl getActiveImage() const override;
@@ -101,6 +123,8 @@ public:
 	QVector<LinkUrl> getLinks() const override;
 	QVector<LinkUrl> getSearchEngines() const override;
 	QVector<NetworkManager::ResourceInformation> getBlockedRequests() const override;
+	QVector<NetworkManager::RequestTiming> getRequestTimings() const override;
+	QHash<int, int> getBlockedProfilesAmounts() const override;
 	QMultiMap<QString, QString> getMetaData() const override;
 	LoadingState getLoadingState() const override;
 	int getZoom() const override;
@@ -125,6 +149,18 @@ public slots:
 	void setUrl(const QUrl &url, bool isTypedIn = true) override;
 
 protected:
+	enum HitTestParameter
+	{
+		HitTestCacheSize = 4,
+		HitTestPrefetchDelay = 50
+	};
+
+	struct HitTestCacheEntry final
+	{
+		HitTestResult result;
+		QPoint position;
+	};
+
 	explicit QtWebEngineWebWidget(const QVariantMap &parameters, WebBackend *backend, ContentsWidget *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
@@ -132,16 +168,21 @@ protected:
 	void hideEvent(QHideEvent *event) override;
 	void focusInEvent(QFocusEvent *event) override;
 	void ensureInitialized();
+	void collectPageMetadata(const QVector<ChangeWatcher> &watchers);
+	void clearHitTestCache();
 	void notifyWatchedDataChanged(ChangeWatcher watcher);
 	void updateOptions(const QUrl &url);
 	void updateWatchedData(ChangeWatcher watcher) override;
 	void setHistory(QDataStream &stream);
 	void setOptions(const QHash<int, QVariant> &options, const QStringList &excludedOptions = {}) override;
+	void setThrottled(bool isThrottled) override;
 	QWebEnginePage* getPage() const;
 	QString parsePosition(const QString &script, const QPoint &position) const;
 	QDateTime getLastUrlClickTime() const;
 	QStringList getBlockedElements() const;
+	HitTestResult handleHitTestResult(const QPoint &position, const QVariant &rawResult);
 	QVector<LinkUrl> processLinks(const QVariantList &rawLinks) const;
+	bool getCachedHitTestResult(const QPoint &position, HitTestResult *hitResult) const;
 	bool canGoBack() const override;
 	bool canGoForward() const override;
 	bool canFastForward() const override;
@@ -179,17 +220,22 @@ private:
 	QDateTime m_lastUrlClickTime;
 	QPixmap m_thumbnail;
 	HitTestResult m_hitResult;
+	QPoint m_hitTestPrefetchPosition;
 	QHash<QNetworkReply*, QPointer<SourceViewerWebWidget> > m_viewSourceReplies;
 	QMultiMap<QString, QString> m_metaData;
 	QStringList m_styleSheets;
+	QVector<HitTestCacheEntry> m_hitResultsCache;
 	QVector<LinkUrl> m_feeds;
 	QVector<LinkUrl> m_links;
 	QVector<LinkUrl> m_searchEngines;
+	QVector<ChangeWatcher> m_pendingMetaDataWatchers;
 	QVector<bool> m_watchedChanges;
 	LoadingState m_loadingState;
 	TrileanValue m_canGoForwardValue;
+	quint64 m_loadIdentifier;
 	int m_documentLoadingProgress;
 	int m_focusProxyTimer;
+	int m_hitTestPrefetchTimer;
 	int m_updateNavigationActionsTimer;
 	bool m_isClosing;
 	bool m_isEditing;
@@ -0,0 +1,94 @@
+(function(sections)
+{
+	function collectLinks(selector)
+	{
+		let elements = document.querySelectorAll(selector);
+		let urls = new Set();
+		let links = [];
+
+		for (let i = 0; i < elements.length; ++i)
+		{
+			if (urls.has(elements[i].href))
+			{
+				continue;
+			}
+
+			urls.add(elements[i].href);
+
+			let link = {
+				title: elements[i].title.trim(),
+				mimeType: elements[i].type,
+				url: elements[i].href
+			};
+
+			if (link.title == '')
+			{
+				link.title = elements[i].textContent.trim();
+			}
+
+			if (link.title == '')
+			{
+				let imageElement = elements[i].querySelector('img[alt]:not([alt=\'\'])');
+
+				if (imageElement)
+				{
+					link.title = imageElement.alt;
+				}
+			}
+
+			links.push(link);
+		}
+
+		return links;
+	}
+
+	let result = {};
+
+	if (sections.feeds)
+	{
+		result.feeds = collectLinks('a[type=\'application/atom+xml\'], a[type=\'application/rss+xml\'], link[type=\'application/atom+xml\'], link[type=\'application/rss+xml\']');
+	}
+
+	if (sections.links)
+	{
+		result.links = collectLinks('a[href]');
+	}
+
+	if (sections.metaData)
+	{
+		let elements = document.querySelectorAll('meta');
+
+		result.metaData = [];
+
+		for (let i = 0; i < elements.length; ++i)
+		{
+			if (elements[i].name !== '')
+			{
+				result.metaData.push({key: elements[i].name, value: elements[i].content});
+			}
+		}
+	}
+
+	if (sections.searchEngines)
+	{
+		result.searchEngines = collectLinks('link[type=\'application/opensearchdescription+xml\']');
+	}
+
+	if (sections.styleSheets)
+	{
+		let elements = document.querySelectorAll('link[rel=\'alternate stylesheet\']');
+		let titles = new Set();
+
+		for (let i = 0; i < elements.length; ++i)
+		{
+			if (elements[i].title !== '')
+			{
+				titles.add(elements[i].title);
+			}
+		}
+
+		result.styleSheets = Array.from(titles);
+	}
+
+	return result;
+})(%1);
@@ -0,0 +1,29 @@
+let styleSheet = document.createElement('style');
+styleSheet.textContent = '%1';
+
+function injectStyleSheet()
+{
+	let parent = (document.head || document.documentElement);
+
+	if (!parent)
+	{
+		return false;
+	}
+
+	parent.appendChild(styleSheet);
+
+	return true;
+}
+
+if (!injectStyleSheet())
+{
+	let observer = new MutationObserver(function()
+	{
+		if (injectStyleSheet())
+		{
+			observer.disconnect();
+		}
+	});
+
+	observer.observe(document, {childList: true, subtree: true});
+}
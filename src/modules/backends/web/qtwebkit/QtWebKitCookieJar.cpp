@@ -31,14 +31,30 @@ QtWebKitCookieJar::QtWebKitCookieJar(CookieJar *cookieJar, WebWidget *widget) :
 	m_cookieJar(cookieJar),
 	m_generalCookiesPolicy(CookieJar::AcceptAllCookies),
 	m_thirdPartyCookiesPolicy(CookieJar::AcceptAllCookies),
-	m_keepMode(CookieJar::KeepUntilExpiresMode)
+	m_keepMode(CookieJar::KeepUntilExpiresMode),
+	m_hasThirdPartyRejectedHosts(false)
 {
 }
 
 void QtWebKitCookieJar::setup(const QStringList &thirdPartyAcceptedHosts, const QStringList &thirdPartyRejectedHosts, CookieJar::CookiesPolicy generalCookiesPolicy, CookieJar::CookiesPolicy thirdPartyCookiesPolicy, CookieJar::KeepMode keepMode)
 {
-	m_thirdPartyAcceptedHosts = thirdPartyAcceptedHosts;
-	m_thirdPartyRejectedHosts = thirdPartyRejectedHosts;
+	m_thirdPartyHostsPolicies.clear();
+	m_thirdPartyHostsPolicies.reserve(thirdPartyAcceptedHosts.count() + thirdPartyRejectedHosts.count());
+	m_domainPoliciesCache.clear();
+
+	for (int i = 0; i < thirdPartyAcceptedHosts.count(); ++i)
+	{
+		m_thirdPartyHostsPolicies[normalizeDomain(thirdPartyAcceptedHosts.at(i))] = AcceptedDomainPolicy;
+	}
+
+	for (int i = 0; i < thirdPartyRejectedHosts.count(); ++i)
+	{
+		m_thirdPartyHostsPolicies[normalizeDomain(thirdPartyRejectedHosts.at(i))] = RejectedDomainPolicy;
+	}
+
+	m_thirdPartyHostsPolicies.remove({});
+
+	m_hasThirdPartyRejectedHosts = !thirdPartyRejectedHosts.isEmpty();
 	m_generalCookiesPolicy = generalCookiesPolicy;
 	m_thirdPartyCookiesPolicy = thirdPartyCookiesPolicy;
 	m_keepMode = keepMode;
@@ -71,6 +87,54 @@ CookieJar* QtWebKitCookieJar::getCookieJar()
 	return m_cookieJar;
 }
 
+QString QtWebKitCookieJar::normalizeDomain(const QString &domain)
+{
+	const QString normalizedDomain(domain.trimmed().toLower());
+
+	return (normalizedDomain.startsWith(QLatin1Char('.')) ? normalizedDomain.mid(1) : normalizedDomain);
+}
+
+QtWebKitCookieJar::DomainPolicy QtWebKitCookieJar::getDomainPolicy(const QString &domain) const
+{
+	const QUrl firstPartyUrl(m_widget->getUrl());
+	const QPair<QString, QString> key(firstPartyUrl.host().toLower(), domain);
+
+	if (m_domainPoliciesCache.contains(key))
+	{
+		return m_domainPoliciesCache[key];
+	}
+
+	QString suffix(normalizeDomain(domain));
+	QUrl url;
+	url.setScheme(QLatin1String("http"));
+	url.setHost(suffix);
+
+	DomainPolicy policy(CookieJar::isDomainTheSame(firstPartyUrl, url) ? FirstPartyDomainPolicy : UnlistedDomainPolicy);
+
+	while (policy == UnlistedDomainPolicy && !suffix.isEmpty())
+	{
+		policy = m_thirdPartyHostsPolicies.value(suffix, UnlistedDomainPolicy);
+
+		const int separator(suffix.indexOf(QLatin1Char('.')));
+
+		if (separator < 0)
+		{
+			break;
+		}
+
+		suffix = suffix.mid(separator + 1);
+	}
+
+	if (m_domainPoliciesCache.count() >= DomainPoliciesCacheLimit)
+	{
+		m_domainPoliciesCache.clear();
+	}
+
+	m_domainPoliciesCache[key] = policy;
+
+	return policy;
+}
+
 QList<QNetworkCookie> QtWebKitCookieJar::cookiesForUrl(const QUrl &url) const
 {
 	if (m_generalCookiesPolicy == CookieJar::IgnoreCookies)
@@ -135,33 +199,27 @@ bool QtWebKitCookieJar::canModifyCookie(const QNetworkCookie &cookie) const
 		return false;
 	}
 
-	if (m_thirdPartyCookiesPolicy != CookieJar::AcceptAllCookies || !m_thirdPartyRejectedHosts.isEmpty())
+	if (m_thirdPartyCookiesPolicy != CookieJar::AcceptAllCookies || m_hasThirdPartyRejectedHosts)
 	{
-		QUrl url;
-		url.setScheme(QLatin1String("http"));
-		url.setHost(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-
-		if (!CookieJar::isDomainTheSame(m_widget->getUrl(), url))
+		switch (getDomainPolicy(cookie.domain()))
 		{
-			if (m_thirdPartyRejectedHosts.contains(cookie.domain()))
-			{
-				return false;
-			}
-
-			if (m_thirdPartyAcceptedHosts.contains(cookie.domain()))
-			{
+			case FirstPartyDomainPolicy:
+			case AcceptedDomainPolicy:
 				return true;
-			}
-
-			if (m_thirdPartyCookiesPolicy == CookieJar::IgnoreCookies)
-			{
+			case RejectedDomainPolicy:
 				return false;
-			}
+			default:
+				break;
+		}
 
-			if (m_thirdPartyCookiesPolicy == CookieJar::AcceptExistingCookies && !m_cookieJar->hasCookie(cookie))
-			{
-				return false;
-			}
+		if (m_thirdPartyCookiesPolicy == CookieJar::IgnoreCookies)
+		{
+			return false;
+		}
+
+		if (m_thirdPartyCookiesPolicy == CookieJar::AcceptExistingCookies && !m_cookieJar->hasCookie(cookie))
+		{
+			return false;
 		}
 	}
 
@@ -22,6 +22,7 @@
 
 #include "../../../../core/CookieJar.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QStringList>
 
 namespace Otter
@@ -47,17 +48,33 @@ public:
 	bool setCookiesFromUrl(const QList<QNetworkCookie> &cookies, const QUrl &url) override;
 
 protected:
+	enum DomainPolicy
+	{
+		FirstPartyDomainPolicy = 0,
+		UnlistedDomainPolicy,
+		AcceptedDomainPolicy,
+		RejectedDomainPolicy
+	};
+
+	enum CacheParameter
+	{
+		DomainPoliciesCacheLimit = 1000
+	};
+
 	void showDialog(const QNetworkCookie &cookie, CookieJar::CookieOperation operation);
+	static QString normalizeDomain(const QString &domain);
+	DomainPolicy getDomainPolicy(const QString &domain) const;
 	bool canModifyCookie(const QNetworkCookie &cookie) const;
 
 private:
 	WebWidget *m_widget;
 	CookieJar *m_cookieJar;
-	QStringList m_thirdPartyAcceptedHosts;
-	QStringList m_thirdPartyRejectedHosts;
+	QHash<QString, DomainPolicy> m_thirdPartyHostsPolicies;
+	mutable QHash<QPair<QString, QString>, DomainPolicy> m_domainPoliciesCache;
 	CookieJar::CookiesPolicy m_generalCookiesPolicy;
 	CookieJar::CookiesPolicy m_thirdPartyCookiesPolicy;
 	CookieJar::KeepMode m_keepMode;
+	bool m_hasThirdPartyRejectedHosts;
 };
 
 }
@@ -17,20 +17,56 @@
 * along with this program. If not, see <http://www.gnu.org/licenses/>.
 *
 **************************************************************************/
-
 #include "QtWebKitFtpListingNetworkReply.h"
 #include "../../../../core/Utils.h"
 
 #include <QtCore/QCoreApplication>
-#include <QtCore/QMimeDatabase>
+#include <QtCore/QDateTime>
+#include <QtCore/QTimer>
 
 namespace Otter
 {
 
+QCache<QUrl, QtWebKitFtpListingNetworkReply::CachedListing> QtWebKitFtpListingNetworkReply::m_cache(ListingCacheLimit);
+
 QtWebKitFtpListingNetworkReply::QtWebKitFtpListingNetworkReply(const QNetworkRequest &request, QObject *parent) : ListingNetworkReply(request, parent),
 	m_ftp(new QFtp(this)),
-	m_offset(0)
+	m_offset(0),
+	m_entriesAmount(0),
+	m_isCacheable(true),
+	m_isFinished(false),
+	m_isListing(false)
 {
+	const QNetworkRequest::CacheLoadControl cacheLoadControl(static_cast<QNetworkRequest::CacheLoadControl>(request.attribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork).toInt()));
+	const QUrl url(Utils::normalizeUrl(request.url()));
+
+	if (cacheLoadControl != QNetworkRequest::PreferCache && cacheLoadControl != QNetworkRequest::AlwaysCache)
+	{
+		m_cache.remove(url);
+	}
+	else if (m_cache.contains(url))
+	{
+		if ((QDateTime::currentMSecsSinceEpoch() - m_cache[url]->time) < ListingCacheLifetime)
+		{
+			m_content = m_cache[url]->content;
+			m_isFinished = true;
+
+			open(ReadOnly | Unbuffered);
+			setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
+			setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+
+			QTimer::singleShot(0, this, [&]()
+			{
+				emit readyRead();
+				emit finished();
+			});
+
+			return;
+		}
+
+		m_cache.remove(url);
+	}
+
 	connect(m_ftp, &QFtp::listInfo, this, &QtWebKitFtpListingNetworkReply::addEntry);
 	connect(m_ftp, &QFtp::readyRead, this, &QtWebKitFtpListingNetworkReply::processData);
 	connect(m_ftp, &QFtp::commandFinished, this, &QtWebKitFtpListingNetworkReply::processCommand);
@@ -43,39 +79,55 @@ void QtWebKitFtpListingNetworkReply::processCommand(int command, bool isError)
 {
 	Q_UNUSED(command)
 
-	if (isError)
+	if (m_isFinished)
 	{
-		open(ReadOnly | Unbuffered);
-
-		ErrorPageInformation::PageAction reloadAction;
-		reloadAction.name = QLatin1String("reloadPage");
-		reloadAction.title = QCoreApplication::translate("utils", "Try Again");
-		reloadAction.type = ErrorPageInformation::MainAction;
+		return;
+	}
 
-		ErrorPageInformation information;
-		information.url = request().url();
-		information.description = QStringList(m_ftp->errorString());
-		information.actions.append(reloadAction);
+	if (isError)
+	{
+		m_isFinished = true;
 
-		if (m_ftp->error() == QFtp::HostNotFound)
-		{
-			information.type = ErrorPageInformation::ServerNotFoundError;
-		}
-		else if (m_ftp->error() == QFtp::ConnectionRefused)
+		if (m_isListing)
 		{
-			information.type = ErrorPageInformation::ConnectionRefusedError;
+			m_entries.clear();
+			m_content.append(createListingFooter());
 		}
-		else if (m_ftp->replyCode() > 0)
+		else
 		{
-			information.title = tr("Network error %1").arg(m_ftp->replyCode());
-		}
+			open(ReadOnly | Unbuffered);
 
-		m_content = Utils::createErrorPage(information).toUtf8();
+			ErrorPageInformation::PageAction reloadAction;
+			reloadAction.name = QLatin1String("reloadPage");
+			reloadAction.title = QCoreApplication::translate("utils", "Try Again");
+			reloadAction.type = ErrorPageInformation::MainAction;
+
+			ErrorPageInformation information;
+			information.url = request().url();
+			information.description = QStringList(m_ftp->errorString());
+			information.actions.append(reloadAction);
+
+			if (m_ftp->error() == QFtp::HostNotFound)
+			{
+				information.type = ErrorPageInformation::ServerNotFoundError;
+			}
+			else if (m_ftp->error() == QFtp::ConnectionRefused)
+			{
+				information.type = ErrorPageInformation::ConnectionRefusedError;
+			}
+			else if (m_ftp->replyCode() > 0)
+			{
+				information.title = tr("Network error %1").arg(m_ftp->replyCode());
+			}
 
-		setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
-		setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+			m_content = Utils::createErrorPage(information).toUtf8();
+
+			setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
+			setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+
+			emit listingError();
+		}
 
-		emit listingError();
 		emit readyRead();
 		emit finished();
 
@@ -102,76 +154,33 @@ void QtWebKitFtpListingNetworkReply::processCommand(int command, bool isError)
 
 			break;
 		case QFtp::List:
-			if (m_directories.isEmpty() && ((m_files.count() == 1 && m_symlinks.isEmpty() && request().url().path().endsWith(m_files.value(0).name())) || (m_symlinks.count() == 1 && m_files.isEmpty() && request().url().path().endsWith(m_symlinks.value(0).name()))))
+			if (!m_isListing && canBeFile())
 			{
+				m_entries.clear();
+
 				m_ftp->get(Utils::normalizeUrl(request().url()).path());
 			}
 			else
 			{
-				open(ReadOnly | Unbuffered);
-
-				QUrl url(request().url());
-				QMimeDatabase mimeDatabase;
-				QVector<NavigationEntry> navigation;
-				const QVector<QUrlInfo> rawEntries(m_symlinks + m_directories + m_files);
-				QVector<ListingEntry> entries;
-				entries.reserve(rawEntries.count());
-
-				if (url.path().isEmpty())
+				if (!m_isListing)
 				{
-					url.setPath(QLatin1String("/"));
+					startListing();
 				}
 
-				while (true)
-				{
-					const bool isRoot(url.path() == QLatin1String("/"));
-
-					url = url.adjusted(QUrl::StripTrailingSlash);
+				appendEntries();
 
-					NavigationEntry entry;
-					entry.name = (isRoot ? url.toString() : url.fileName() + QLatin1Char('/'));
-					entry.url = url.url();
+				m_content.append(createListingFooter());
 
-					navigation.prepend(entry);
-
-					if (isRoot)
-					{
-						break;
-					}
-
-					url = url.adjusted(QUrl::RemoveFilename);
-				}
-
-				for (int i = 0; i < rawEntries.count(); ++i)
+				if (m_isCacheable)
 				{
-					ListingEntry entry;
-					entry.name = rawEntries.at(i).name();
-					entry.url = Utils::normalizeUrl(request().url()).url() + QLatin1Char('/') + rawEntries.at(i).name();
-					entry.timeModified = rawEntries.at(i).lastModified();
-					entry.type = (rawEntries.at(i).isSymLink() ? ListingEntry::UnknownType : (rawEntries.at(i).isDir() ? ListingEntry::DirectoryType : ListingEntry::FileType));
-					entry.size = rawEntries.at(i).size();
-					entry.isSymlink = rawEntries.at(i).isSymLink();
-
-					if (rawEntries.at(i).isSymLink())
-					{
-						entry.mimeType = mimeDatabase.mimeTypeForName(QLatin1String("text/uri-list"));
-					}
-					else if (rawEntries.at(i).isDir())
-					{
-						entry.mimeType = mimeDatabase.mimeTypeForName(QLatin1String("inode/directory"));
-					}
-					else
-					{
-						entry.mimeType = mimeDatabase.mimeTypeForUrl(request().url().url() + rawEntries.at(i).name());
-					}
-
-					entries.append(entry);
+					m_listing.append(createListingFooter());
+
+					cacheListing();
 				}
 
-				m_content = createListing(request().url().toString() + (request().url().path().endsWith(QLatin1Char('/')) ? QChar() : QLatin1Char('/')), navigation, entries);
+				m_listing.clear();
 
-				setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
-				setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+				m_isFinished = true;
 
 				emit readyRead();
 				emit finished();
@@ -184,6 +193,8 @@ void QtWebKitFtpListingNetworkReply::processCommand(int command, bool isError)
 			open(QIODevice::ReadOnly | QIODevice::Unbuffered);
 			setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
 
+			m_isFinished = true;
+
 			emit readyRead();
 			emit finished();
 
@@ -195,19 +206,113 @@ void QtWebKitFtpListingNetworkReply::processCommand(int command, bool isError)
 	}
 }
 
-void QtWebKitFtpListingNetworkReply::addEntry(const QUrlInfo &entry)
+void QtWebKitFtpListingNetworkReply::startListing()
 {
-	if (entry.isSymLink())
+	open(ReadOnly | Unbuffered);
+
+	QUrl url(request().url());
+	QVector<NavigationEntry> navigation;
+
+	if (url.path().isEmpty())
 	{
-		m_symlinks.append(entry);
+		url.setPath(QLatin1String("/"));
 	}
-	else if (entry.isDir())
+
+	while (true)
 	{
-		m_directories.append(entry);
+		const bool isRoot(url.path() == QLatin1String("/"));
+
+		url = url.adjusted(QUrl::StripTrailingSlash);
+
+		NavigationEntry entry;
+		entry.name = (isRoot ? url.toString() : url.fileName() + QLatin1Char('/'));
+		entry.url = url.url();
+
+		navigation.prepend(entry);
+
+		if (isRoot)
+		{
+			break;
+		}
+
+		url = url.adjusted(QUrl::RemoveFilename);
 	}
-	else
+
+	m_content = createListingHeader(request().url().toString() + (request().url().path().endsWith(QLatin1Char('/')) ? QChar() : QLatin1Char('/')), navigation);
+	m_listing = m_content;
+	m_isListing = true;
+
+	setHeader(QNetworkRequest::ContentTypeHeader, QVariant(QLatin1String("text/html; charset=UTF-8")));
+}
+
+void QtWebKitFtpListingNetworkReply::appendEntries()
+{
+	if (m_entries.isEmpty())
 	{
-		m_files.append(entry);
+		return;
+	}
+
+	QVector<ListingEntry> entries;
+	entries.reserve(m_entries.count());
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		entries.append(createEntry(m_entries.at(i)));
+	}
+
+	m_entries.clear();
+
+	const QByteArray content(createListingEntries(entries, 0, entries.count()));
+
+	m_content.append(content);
+
+	if (m_isCacheable)
+	{
+		if ((m_listing.size() + content.size()) > (ListingCacheLimit * 1024))
+		{
+			m_listing.clear();
+
+			m_isCacheable = false;
+		}
+		else
+		{
+			m_listing.append(content);
+		}
+	}
+}
+
+void QtWebKitFtpListingNetworkReply::cacheListing()
+{
+	CachedListing *listing(new CachedListing());
+	listing->content = m_listing;
+	listing->time = QDateTime::currentMSecsSinceEpoch();
+
+	m_cache.insert(Utils::normalizeUrl(request().url()), listing, qMax(1, (m_listing.size() / 1024)));
+}
+
+void QtWebKitFtpListingNetworkReply::addEntry(const QUrlInfo &entry)
+{
+	m_entries.append(entry);
+
+	++m_entriesAmount;
+
+	if (!m_isListing)
+	{
+		if (canBeFile())
+		{
+			return;
+		}
+
+		startListing();
+
+		emit readyRead();
+	}
+
+	if (m_entries.count() >= ListingBatchSize)
+	{
+		appendEntries();
+
+		emit readyRead();
 	}
 }
 
@@ -220,11 +325,56 @@ void QtWebKitFtpListingNetworkReply::processData()
 
 void QtWebKitFtpListingNetworkReply::abort()
 {
+	if (m_isFinished)
+	{
+		return;
+	}
+
+	m_entries.clear();
+	m_listing.clear();
+
+	m_isFinished = true;
+
 	m_ftp->close();
 
+	setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+
 	emit finished();
 }
 
+ListingNetworkReply::ListingEntry QtWebKitFtpListingNetworkReply::createEntry(const QUrlInfo &information)
+{
+	ListingEntry entry;
+	entry.name = information.name();
+	entry.url = Utils::normalizeUrl(request().url()).url() + QLatin1Char('/') + information.name();
+	entry.timeModified = information.lastModified();
+	entry.type = (information.isSymLink() ? ListingEntry::UnknownType : (information.isDir() ? ListingEntry::DirectoryType : ListingEntry::FileType));
+	entry.size = information.size();
+	entry.isSymlink = information.isSymLink();
+
+	if (information.isSymLink())
+	{
+		entry.mimeType = m_mimeDatabase.mimeTypeForName(QLatin1String("text/uri-list"));
+	}
+	else if (information.isDir())
+	{
+		entry.mimeType = m_mimeDatabase.mimeTypeForName(QLatin1String("inode/directory"));
+	}
+	else
+	{
+		const QString suffix(information.name().section(QLatin1Char('.'), 1));
+
+		if (!m_mimeTypes.contains(suffix))
+		{
+			m_mimeTypes[suffix] = m_mimeDatabase.mimeTypeForUrl(request().url().url() + information.name());
+		}
+
+		entry.mimeType = m_mimeTypes[suffix];
+	}
+
+	return entry;
+}
+
 qint64 QtWebKitFtpListingNetworkReply::bytesAvailable() const
 {
 	return (m_content.size() - m_offset);
@@ -240,10 +390,26 @@ qint64 QtWebKitFtpListingNetworkReply::readData(char *data, qint64 maxSize)
 
 		m_offset += number;
 
+		if (m_offset >= m_content.size())
+		{
+			m_content.clear();
+			m_offset = 0;
+		}
+
 		return number;
 	}
 
-	return -1;
+	return (m_isFinished ? -1 : 0);
+}
+
+bool QtWebKitFtpListingNetworkReply::canBeFile() const
+{
+	if (m_entriesAmount != 1 || m_entries.count() != 1 || (m_entries.at(0).isDir() && !m_entries.at(0).isSymLink()))
+	{
+		return false;
+	}
+
+	return request().url().path().endsWith(m_entries.at(0).name());
 }
 
 bool QtWebKitFtpListingNetworkReply::isSequential() const
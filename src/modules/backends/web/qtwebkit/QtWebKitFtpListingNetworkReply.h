@@ -25,6 +25,9 @@
 #include "3rdparty/qtftp/qftp.h"
 #include "3rdparty/qtftp/qurlinfo.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QMimeDatabase>
+
 namespace Otter
 {
 
@@ -42,6 +45,26 @@ public:
 public slots:
 	void abort() override;
 
+protected:
+	enum ListingParameter
+	{
+		ListingBatchSize = 500,
+		ListingCacheLifetime = 300000,
+		ListingCacheLimit = 4096
+	};
+
+	struct CachedListing final
+	{
+		QByteArray content;
+		qint64 time = 0;
+	};
+
+	void startListing();
+	void appendEntries();
+	void cacheListing();
+	ListingEntry createEntry(const QUrlInfo &information);
+	bool canBeFile() const;
+
 protected slots:
 	void processCommand(int command, bool isError);
 	void addEntry(const QUrlInfo &entry);
@@ -49,11 +72,18 @@ protected slots:
 
 private:
 	QFtp *m_ftp;
+	QMimeDatabase m_mimeDatabase;
+	QHash<QString, QMimeType> m_mimeTypes;
 	QByteArray m_content;
-	QVector<QUrlInfo> m_directories;
-	QVector<QUrlInfo> m_files;
-	QVector<QUrlInfo> m_symlinks;
+	QByteArray m_listing;
+	QVector<QUrlInfo> m_entries;
 	qint64 m_offset;
+	int m_entriesAmount;
+	bool m_isCacheable;
+	bool m_isFinished;
+	bool m_isListing;
+
+	static QCache<QUrl, CachedListing> m_cache;
 };
 
 }
@@ -31,6 +31,7 @@ QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistor
 void QtWebKitHistoryInterface::clear()
 {
 	m_urls.clear();
+	m_recentUrls.clear();
 }
 
 void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
@@ -40,17 +41,18 @@ void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
 		return;
 	}
 
-	m_urls.append(url);
+	m_urls.insert(url);
+	m_recentUrls.append(url);
 
-	if (m_urls.length() > 100)
+	if (m_recentUrls.count() > 100)
 	{
-		m_urls.removeAt(0);
+		m_urls.remove(m_recentUrls.takeFirst());
 	}
 }
 
 bool QtWebKitHistoryInterface::historyContains(const QString &url) const
 {
-	return (m_urls.contains(url) || HistoryManager::hasEntry(url));
+	return (m_urls.contains(url) || HistoryManager::hasVisitedLink(url));
 }
 
 }
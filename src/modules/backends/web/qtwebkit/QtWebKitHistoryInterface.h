@@ -20,7 +20,8 @@
 #ifndef OTTER_QTWEBKITHISTORYINTERFACE_H
 #define OTTER_QTWEBKITHISTORYINTERFACE_H
 
-#include <QtCore/QStringList>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtWebKit/QWebHistoryInterface>
 
 namespace Otter
@@ -40,7 +41,8 @@ protected slots:
 	void clear();
 
 private:
-	QStringList m_urls;
+	QSet<QString> m_urls;
+	QQueue<QString> m_recentUrls;
 };
 
 }
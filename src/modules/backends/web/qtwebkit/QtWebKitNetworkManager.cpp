@@ -23,11 +23,14 @@
 #include "QtWebKitCookieJar.h"
 #include "QtWebKitFtpListingNetworkReply.h"
 #include "QtWebKitPage.h"
+#include "QtWebKitRequestScheduler.h"
+#include "QtWebKitWebBackend.h"
 #include "../../../../core/AddonsManager.h"
 #include "../../../../core/Console.h"
 #include "../../../../core/CookieJar.h"
 #include "../../../../core/ContentFiltersManager.h"
 #include "../../../../core/LocalListingNetworkReply.h"
+#include "../../../../core/MemoryNetworkCache.h"
 #include "../../../../core/NetworkCache.h"
 #include "../../../../core/NetworkManagerFactory.h"
 #include "../../../../core/NetworkProxyFactory.h"
@@ -39,6 +42,7 @@
 #include "../../../../ui/ContentsDialog.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
@@ -51,20 +55,24 @@ namespace Otter
 {
 
 WebBackend* QtWebKitNetworkManager::m_backend(nullptr);
+QHash<QString, QtWebKitNetworkTransport*> QtWebKitNetworkTransport::m_transports;
 
 QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar *cookieJarProxy, QtWebKitWebWidget *parent) : QNetworkAccessManager(parent),
 	m_widget(parent),
 	m_cookieJar(nullptr),
 	m_cookieJarProxy(cookieJarProxy),
 	m_proxyFactory(nullptr),
+	m_transport(nullptr),
 	m_baseReply(nullptr),
 	m_contentState(WebWidget::UnknownContentState),
-	m_doNotTrackPolicy(NetworkManagerFactory::SkipTrackPolicy),
 	m_isSecureValue(UnknownValue),
 	m_bytesReceivedDifference(0),
+	m_contentFilteringTime(0),
+	m_heldImagesTimer(0),
 	m_loadingSpeedTimer(0),
 	m_areImagesEnabled(true),
-	m_canSendReferrer(true)
+	m_canHoldImages(false),
+	m_isHoldingImages(false)
 {
 	NetworkManagerFactory::initialize();
 
@@ -78,10 +86,18 @@ QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar
 		setCache(cache);
 
 		cache->setParent(QCoreApplication::instance());
+
+		connect(this, &QtWebKitNetworkManager::finished, this, &NetworkManagerFactory::storeSslSession);
 	}
 	else
 	{
 		m_cookieJar = new CookieJar({}, this);
+
+		MemoryNetworkCache *cache(NetworkManagerFactory::getPrivateCache());
+
+		setCache(cache);
+
+		cache->setParent(QCoreApplication::instance());
 	}
 
 	if (m_cookieJarProxy)
@@ -96,6 +112,7 @@ QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar
 	setCookieJar(m_cookieJarProxy);
 
 	connect(this, &QtWebKitNetworkManager::finished, this, &QtWebKitNetworkManager::handleRequestFinished);
+	connect(this, &QtWebKitNetworkManager::finished, this, &NetworkManagerFactory::updateHttp2Support);
 	connect(this, &QtWebKitNetworkManager::authenticationRequired, this, &QtWebKitNetworkManager::handleAuthenticationRequired);
 	connect(this, &QtWebKitNetworkManager::proxyAuthenticationRequired, this, &QtWebKitNetworkManager::handleProxyAuthenticationRequired);
 	connect(this, &QtWebKitNetworkManager::sslErrors, this, &QtWebKitNetworkManager::handleSslErrors);
@@ -108,12 +125,79 @@ QtWebKitNetworkManager::QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar
 	});
 }
 
+void QtWebKitNetworkManager::preconnect(const QUrl &url, bool canPrefetch)
+{
+	if (!cache() || !NetworkManagerFactory::reserveSpeculativeLoad(url, false))
+	{
+		return;
+	}
+
+	NetworkManagerFactory::prefetchHost(url.host());
+
+	QNetworkAccessManager *manager(m_transport ? static_cast<QNetworkAccessManager*>(m_transport) : this);
+
+	if (url.scheme() == QLatin1String("https"))
+	{
+		manager->connectToHostEncrypted(url.host(), static_cast<quint16>(url.port(443)));
+	}
+	else
+	{
+		manager->connectToHost(url.host(), static_cast<quint16>(url.port(80)));
+	}
+
+	if (!canPrefetch || !NetworkManagerFactory::reserveSpeculativeLoad(url, true))
+	{
+		return;
+	}
+
+	QNetworkRequest request(url.adjusted(QUrl::RemoveFragment));
+	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+	request.setRawHeader(QByteArrayLiteral("Purpose"), QByteArrayLiteral("prefetch"));
+#if QT_VERSION >= 0x050900
+	request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, false);
+#endif
+
+	for (int i = 0; i < m_requestHeaders.headers.count(); ++i)
+	{
+		request.setRawHeader(m_requestHeaders.headers.at(i).first, m_requestHeaders.headers.at(i).second);
+	}
+
+	if (!m_requestHeaders.doNotTrack.isEmpty())
+	{
+		request.setRawHeader(QByteArrayLiteral("DNT"), m_requestHeaders.doNotTrack);
+	}
+
+	QNetworkReply *reply(m_transport ? m_transport->createReply(this, GetOperation, request, nullptr) : QNetworkAccessManager::createRequest(GetOperation, request, nullptr));
+
+	m_prefetchReplies.insert(reply);
+
+	connect(reply, &QNetworkReply::downloadProgress, reply, [=](qint64 bytesReceived, qint64 bytesTotal)
+	{
+		if (bytesReceived > PrefetchSizeLimit || bytesTotal > PrefetchSizeLimit || !reply->header(QNetworkRequest::ContentTypeHeader).toString().contains(QLatin1String("html"), Qt::CaseInsensitive))
+		{
+			reply->abort();
+		}
+	});
+	connect(reply, &QNetworkReply::finished, this, [=]()
+	{
+		m_prefetchReplies.remove(reply);
+
+		reply->deleteLater();
+	});
+}
+
 void QtWebKitNetworkManager::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_loadingSpeedTimer)
 	{
 		updateLoadingSpeed();
 	}
+	else if (event->timerId() == m_heldImagesTimer)
+	{
+		m_isHoldingImages = false;
+
+		releaseHeldImages({});
+	}
 }
 
 void QtWebKitNetworkManager::addContentBlockingException(const QUrl &url, NetworkManager::ResourceType resourceType)
@@ -134,10 +218,11 @@ void QtWebKitNetworkManager::resetStatistics()
 
 	m_sslInformation = {};
 	m_loadingSpeedTimer = 0;
-	m_blockedElements.clear();
 	m_contentBlockingProfiles.clear();
 	m_contentBlockingExceptions.clear();
 	m_blockedRequests.clear();
+	m_requestTimings.clear();
+	m_requestTimingsPositions.clear();
 	m_replies.clear();
 	m_headers.clear();
 	m_pageInformation = {{WebWidget::DocumentBytesReceivedInformation, quint64(0)}, {WebWidget::DocumentBytesTotalInformation, quint64(0)}, {WebWidget::TotalBytesReceivedInformation, quint64(0)}, {WebWidget::TotalBytesTotalInformation, quint64(0)}, {WebWidget::RequestsFinishedInformation, 0}, {WebWidget::RequestsStartedInformation, 0}};
@@ -145,7 +230,10 @@ void QtWebKitNetworkManager::resetStatistics()
 	m_contentState = WebWidget::UnknownContentState;
 	m_isSecureValue = UnknownValue;
 	m_bytesReceivedDifference = 0;
+	m_contentFilteringTime = 0;
+	m_isHoldingImages = m_canHoldImages;
 
+	releaseHeldImages({});
 	updateLoadingSpeed();
 
 	for (int i = 0; i < keys.count(); ++i)
@@ -228,6 +316,21 @@ void QtWebKitNetworkManager::handleRequestFinished(QNetworkReply *reply)
 
 	const QUrl url(reply->url());
 
+	if (m_requestTimingsPositions.contains(reply))
+	{
+		NetworkManager::RequestTiming &timing(m_requestTimings[m_requestTimingsPositions.take(reply)]);
+		timing.mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+		timing.statusText = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
+		timing.responseHeaders = reply->rawHeaderPairs();
+		timing.finishedTime = QDateTime::currentMSecsSinceEpoch();
+		timing.bytesReceived = m_replies[reply].first;
+		timing.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		timing.isCached = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+#if QT_VERSION >= 0x050900
+		timing.isHttp2 = reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool();
+#endif
+	}
+
 	m_replies.remove(reply);
 
 	setPageInformation(WebWidget::RequestsFinishedInformation, (m_pageInformation[WebWidget::RequestsFinishedInformation].toInt() + 1));
@@ -299,6 +402,13 @@ void QtWebKitNetworkManager::handleTransferFinished()
 
 void QtWebKitNetworkManager::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
 {
+	if (m_prefetchReplies.contains(reply))
+	{
+		reply->abort();
+
+		return;
+	}
+
 	if (!m_widget)
 	{
 		return;
@@ -350,7 +460,7 @@ void QtWebKitNetworkManager::handleProxyAuthenticationRequired(const QNetworkPro
 
 void QtWebKitNetworkManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
 {
-	if (!m_widget)
+	if (!m_widget || m_prefetchReplies.contains(reply))
 	{
 		return;
 	}
@@ -421,101 +531,75 @@ void QtWebKitNetworkManager::handleLoadFinished(bool result)
 	emit contentStateChanged(m_contentState);
 }
 
-void QtWebKitNetworkManager::updateLoadingSpeed()
-{
-	setPageInformation(WebWidget::LoadingSpeedInformation, (m_bytesReceivedDifference * 2));
-
-	m_bytesReceivedDifference = 0;
-}
-
-void QtWebKitNetworkManager::updateOptions(const QUrl &url)
+void QtWebKitNetworkManager::releaseHeldImages(const QSet<QUrl> &deferredUrls)
 {
-	if (!m_backend)
+	if (m_heldImagesTimer != 0)
 	{
-		m_backend = AddonsManager::getWebBackend(QLatin1String("qtwebkit"));
-	}
+		killTimer(m_heldImagesTimer);
 
-	if (getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption, url).toBool())
-	{
-		m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(getOption(SettingsManager::ContentBlocking_ProfilesOption, url).toStringList());
-	}
-	else
-	{
-		m_contentBlockingProfiles.clear();
+		m_heldImagesTimer = 0;
 	}
 
-	QString acceptLanguage(getOption(SettingsManager::Network_AcceptLanguageOption, url).toString());
-	acceptLanguage = ((acceptLanguage.isEmpty()) ? QLatin1String(" ") : acceptLanguage.replace(QLatin1String("system"), QLocale::system().bcp47Name()));
-
-	m_acceptLanguage = ((acceptLanguage == NetworkManagerFactory::getAcceptLanguage()) ? QString() : acceptLanguage);
-	m_userAgent = m_backend->getUserAgent(NetworkManagerFactory::getUserAgent(getOption(SettingsManager::Network_UserAgentOption, url).toString()).value);
-	m_unblockedHosts = getOption(SettingsManager::ContentBlocking_IgnoreHostsOption, url).toStringList();
+	const QVector<QPointer<QtWebKitDeferredNetworkReply> > replies(m_heldImages);
 
-	const QString doNotTrackPolicyValue(getOption(SettingsManager::Network_DoNotTrackPolicyOption, url).toString());
+	m_heldImages.clear();
 
-	if (doNotTrackPolicyValue == QLatin1String("allow"))
+	for (int i = 0; i < replies.count(); ++i)
 	{
-		m_doNotTrackPolicy = NetworkManagerFactory::AllowToTrackPolicy;
-	}
-	else if (doNotTrackPolicyValue == QLatin1String("doNotAllow"))
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::DoNotAllowToTrackPolicy;
-	}
-	else
-	{
-		m_doNotTrackPolicy = NetworkManagerFactory::SkipTrackPolicy;
+		QtWebKitDeferredNetworkReply *reply(replies.at(i));
+
+		if (!reply)
+		{
+			continue;
+		}
+
+		if (deferredUrls.contains(reply->request().url().adjusted(QUrl::RemoveFragment)))
+		{
+			reply->abort();
+		}
+		else
+		{
+			reply->start();
+		}
 	}
+}
 
-	m_areImagesEnabled = (getOption(SettingsManager::Permissions_EnableImagesOption, url).toString() != QLatin1String("disabled"));
-	m_canSendReferrer = getOption(SettingsManager::Network_EnableReferrerOption, url).toBool();
+void QtWebKitNetworkManager::updateLoadingSpeed()
+{
+	setPageInformation(WebWidget::LoadingSpeedInformation, (m_bytesReceivedDifference * 2));
 
-	const QString generalCookiesPolicyValue(getOption(SettingsManager::Network_CookiesPolicyOption, url).toString());
-	CookieJar::CookiesPolicy generalCookiesPolicy(CookieJar::AcceptAllCookies);
+	m_bytesReceivedDifference = 0;
+}
 
-	if (generalCookiesPolicyValue == QLatin1String("ignore"))
-	{
-		generalCookiesPolicy = CookieJar::IgnoreCookies;
-	}
-	else if (generalCookiesPolicyValue == QLatin1String("readOnly"))
-	{
-		generalCookiesPolicy = CookieJar::ReadOnlyCookies;
-	}
-	else if (generalCookiesPolicyValue == QLatin1String("acceptExisting"))
+void QtWebKitNetworkManager::updateOptions(const QUrl &url)
+{
+	if (!m_backend)
 	{
-		generalCookiesPolicy = CookieJar::AcceptExistingCookies;
+		m_backend = AddonsManager::getWebBackend(QLatin1String("qtwebkit"));
 	}
 
-	const QString thirdPartyCookiesPolicyValue(getOption(SettingsManager::Network_ThirdPartyCookiesPolicyOption, url).toString());
-	CookieJar::CookiesPolicy thirdPartyCookiesPolicy(CookieJar::AcceptAllCookies);
+	const NetworkManagerFactory::NetworkProfile profile(NetworkManagerFactory::getNetworkProfile(url, (m_widget ? m_widget->getOptions() : QHash<int, QVariant>())));
 
-	if (thirdPartyCookiesPolicyValue == QLatin1String("ignore"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::IgnoreCookies;
-	}
-	else if (thirdPartyCookiesPolicyValue == QLatin1String("readOnly"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::ReadOnlyCookies;
-	}
-	else if (thirdPartyCookiesPolicyValue == QLatin1String("acceptExisting"))
-	{
-		thirdPartyCookiesPolicy = CookieJar::AcceptExistingCookies;
-	}
+	m_contentBlockingProfiles = ContentFiltersManager::getProfileIdentifiers(profile.contentBlockingProfiles);
+	m_userAgent = m_backend->getUserAgent(profile.userAgent);
+	m_unblockedHosts = profile.unblockedHosts;
+	m_requestHeaders = profile.requestHeaders;
+	m_requestHeaders.headers.append({QByteArrayLiteral("User-Agent"), m_userAgent.toLatin1()});
+	m_areImagesEnabled = profile.areImagesEnabled;
+	m_canHoldImages = (m_widget && (url.scheme() == QLatin1String("http") || url.scheme() == QLatin1String("https")) && getOption(SettingsManager::Content_LazyLoadImagesOption, url).toBool() && getOption(SettingsManager::Permissions_EnableJavaScriptOption, url).toBool());
 
-	const QString keepCookiesModeValue(getOption(SettingsManager::Network_CookiesKeepModeOption, url).toString());
-	CookieJar::KeepMode keepCookiesMode(CookieJar::KeepUntilExpiresMode);
+	m_cookieJarProxy->setup(profile.thirdPartyCookiesAcceptedHosts, profile.thirdPartyCookiesRejectedHosts, profile.generalCookiesPolicy, profile.thirdPartyCookiesPolicy, profile.keepCookiesMode);
 
-	if (keepCookiesModeValue == QLatin1String("keepUntilExit"))
+	if (SettingsManager::getOption(QtWebKitWebBackend::getOptionIdentifier(QtWebKitWebBackend::QtWebKitBackend_EnableSharedNetworkTransportOption)).toBool())
 	{
-		keepCookiesMode = CookieJar::KeepUntilExitMode;
-	}
-	else if (keepCookiesModeValue == QLatin1String("ask"))
-	{
-		keepCookiesMode = CookieJar::AskIfKeepMode;
+		m_transport = QtWebKitNetworkTransport::getTransport((cache() == nullptr), (profile.hasProxyOverride ? profile.proxy : QString()));
+
+		return;
 	}
 
-	m_cookieJarProxy->setup(getOption(SettingsManager::Network_ThirdPartyCookiesAcceptedHostsOption, url).toStringList(), getOption(SettingsManager::Network_ThirdPartyCookiesRejectedHostsOption, url).toStringList(), generalCookiesPolicy, thirdPartyCookiesPolicy, keepCookiesMode);
+	m_transport = nullptr;
 
-	if (!m_proxyFactory && ((m_widget && m_widget->hasOption(SettingsManager::Network_ProxyOption)) || SettingsManager::hasOverride(Utils::extractHost(url), SettingsManager::Network_ProxyOption)))
+	if (!m_proxyFactory && profile.hasProxyOverride)
 	{
 		m_proxyFactory = new NetworkProxyFactory(this);
 
@@ -524,7 +608,7 @@ void QtWebKitNetworkManager::updateOptions(const QUrl &url)
 
 	if (m_proxyFactory)
 	{
-		m_proxyFactory->setProxy(getOption(SettingsManager::Network_ProxyOption, url).toString());
+		m_proxyFactory->setProxy(profile.proxy);
 	}
 }
 
@@ -560,6 +644,11 @@ void QtWebKitNetworkManager::setWidget(QtWebKitWebWidget *widget)
 	m_cookieJarProxy->setWidget(widget);
 }
 
+QNetworkReply* QtWebKitNetworkManager::createScheduledReply(const QNetworkRequest &request)
+{
+	return (m_transport ? m_transport->createReply(this, GetOperation, request, nullptr) : QNetworkAccessManager::createRequest(GetOperation, request, nullptr));
+}
+
 QtWebKitNetworkManager* QtWebKitNetworkManager::clone() const
 {
 	return new QtWebKitNetworkManager((cache() == nullptr), m_cookieJarProxy->clone(nullptr), nullptr);
@@ -641,6 +730,24 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 					m_widget->notifySavePasswordRequested(password, (match == PasswordsManager::PartialMatch));
 				}
 			}
+			else if (type == QLatin1String("defer-images"))
+			{
+				const QJsonArray urlsArray(payloadObject.value(QLatin1String("urls")).toArray());
+				QSet<QUrl> deferredUrls;
+				deferredUrls.reserve(urlsArray.count());
+
+				for (int i = 0; i < urlsArray.count(); ++i)
+				{
+					deferredUrls.insert(QUrl(urlsArray.at(i).toString()).adjusted(QUrl::RemoveFragment));
+				}
+
+				if (payloadObject.value(QLatin1String("isFinal")).toBool())
+				{
+					m_isHoldingImages = false;
+				}
+
+				releaseHeldImages(deferredUrls);
+			}
 		}
 
 		return QNetworkAccessManager::createRequest(GetOperation, QNetworkRequest(QUrl()));
@@ -659,26 +766,39 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 
 		if (needsContentBlockingCheck)
 		{
+			QElapsedTimer timer;
+			timer.start();
+
 			const ContentFiltersManager::CheckResult result(ContentFiltersManager::checkUrl(m_contentBlockingProfiles, baseUrl, request.url(), resourceType));
 
+			m_contentFilteringTime += timer.nsecsElapsed();
+
 			if (result.isBlocked)
 			{
 				const ContentFiltersProfile *profile(ContentFiltersManager::getProfile(result.profile));
 
 				Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg((profile ? profile->getTitle() : QCoreApplication::translate("main", "(Unknown)")), result.rule), Console::NetworkCategory, Console::LogLevel, request.url().toString(), -1, (m_widget ? m_widget->getWindowIdentifier() : 0));
 
-				if (resourceType != NetworkManager::ScriptType && resourceType != NetworkManager::StyleSheetType)
-				{
-					m_blockedElements.append(request.url().url());
-				}
-
 				NetworkManager::ResourceInformation resource;
 				resource.url = request.url();
 				resource.resourceType = resourceType;
 				resource.metaData[NetworkManager::ContentBlockingProfileMetaData] = result.profile;
 				resource.metaData[NetworkManager::ContentBlockingRuleMetaData] = result.rule;
 
-				m_blockedRequests.append(resource);
+				m_blockedRequests.addRequest(resource, (resourceType != NetworkManager::ScriptType && resourceType != NetworkManager::StyleSheetType));
+
+				if (m_requestTimings.count() < RequestTimingsLimit)
+				{
+					NetworkManager::RequestTiming timing;
+					timing.url = request.url();
+					timing.method = getOperationName(operation, request);
+					timing.startTime = QDateTime::currentMSecsSinceEpoch();
+					timing.finishedTime = timing.startTime;
+					timing.resourceType = resourceType;
+					timing.isBlocked = true;
+
+					m_requestTimings.append(timing);
+				}
 
 				emit requestBlocked(resource);
 
@@ -691,9 +811,9 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 
 	QNetworkRequest mutableRequest(request);
 
-	if (!m_canSendReferrer)
+	for (int i = 0; i < m_requestHeaders.headers.count(); ++i)
 	{
-		mutableRequest.setRawHeader(QByteArrayLiteral("Referer"), {});
+		mutableRequest.setRawHeader(m_requestHeaders.headers.at(i).first, m_requestHeaders.headers.at(i).second);
 	}
 
 	if (operation == PostOperation && mutableRequest.header(QNetworkRequest::ContentTypeHeader).isNull())
@@ -705,20 +825,65 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 	{
 		mutableRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
 	}
-	else if (m_doNotTrackPolicy != NetworkManagerFactory::SkipTrackPolicy)
+	else if (!m_requestHeaders.doNotTrack.isEmpty())
+	{
+		mutableRequest.setRawHeader(QByteArrayLiteral("DNT"), m_requestHeaders.doNotTrack);
+	}
+
+	const NetworkManager::ResourceType resourceType((m_widget && request.url() == m_mainRequestUrl) ? NetworkManager::MainFrameType : NetworkManager::getResourceType(request, m_mainRequestUrl));
+	const bool isBackground(m_widget && !m_widget->isVisible());
+	const bool isNetworkRequest(request.url().scheme() == QLatin1String("http") || request.url().scheme() == QLatin1String("https"));
+
+	switch (resourceType)
 	{
-		mutableRequest.setRawHeader(QByteArrayLiteral("DNT"), ((m_doNotTrackPolicy == NetworkManagerFactory::DoNotAllowToTrackPolicy) ? QByteArrayLiteral("1") : QByteArrayLiteral("0")));
+		case NetworkManager::MainFrameType:
+		case NetworkManager::SubFrameType:
+			mutableRequest.setPriority(isBackground ? QNetworkRequest::NormalPriority : QNetworkRequest::HighPriority);
+
+			break;
+		case NetworkManager::StyleSheetType:
+		case NetworkManager::ScriptType:
+			mutableRequest.setPriority(isBackground ? QNetworkRequest::LowPriority : QNetworkRequest::HighPriority);
+
+			break;
+		case NetworkManager::ImageType:
+		case NetworkManager::ObjectType:
+		case NetworkManager::ObjectSubrequestType:
+			mutableRequest.setPriority(QNetworkRequest::LowPriority);
+
+			break;
+		default:
+			mutableRequest.setPriority(isBackground ? QNetworkRequest::LowPriority : QNetworkRequest::NormalPriority);
+
+			break;
 	}
 
-	mutableRequest.setRawHeader(QByteArrayLiteral("Accept-Language"), (m_acceptLanguage.isEmpty() ? NetworkManagerFactory::getAcceptLanguage().toLatin1() : m_acceptLanguage.toLatin1()));
-	mutableRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
 #if QT_VERSION >= 0x050900
-	mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, false);
+	mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, NetworkManagerFactory::canUseHttp2(mutableRequest.url()));
 #endif
 
+	NetworkCache *networkCache(qobject_cast<NetworkCache*>(cache()));
+	bool needsRevalidation(false);
+
+	if (networkCache)
+	{
+		NetworkManagerFactory::restoreSslSession(mutableRequest);
+
+		if (operation == GetOperation && !m_transport && !NetworkManagerFactory::isWorkingOffline())
+		{
+			needsRevalidation = networkCache->applyLoadPolicy(mutableRequest, (resourceType != NetworkManager::MainFrameType && resourceType != NetworkManager::SubFrameType));
+		}
+	}
+
+	QHostInfo hostInformation;
+	const bool hasCachedHost(NetworkManagerFactory::getHostInformation(request.url().host(), hostInformation));
+
+	NetworkManagerFactory::prefetchHost(request.url().host());
+
 	setPageInformation(WebWidget::LoadingMessageInformation, tr("Sending request to %1…").arg(request.url().host()));
 
 	QNetworkReply *reply(nullptr);
+	bool isDeferred(false);
 
 	if (operation == GetOperation && request.url().isLocalFile() && QFileInfo(request.url().toLocalFile()).isDir())
 	{
@@ -756,11 +921,69 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 			}
 		}
 	}
+	else if (m_isHoldingImages && isNetworkRequest && operation == GetOperation && resourceType == NetworkManager::ImageType)
+	{
+		QtWebKitDeferredNetworkReply *deferredReply(new QtWebKitDeferredNetworkReply(mutableRequest, this));
+
+		reply = deferredReply;
+		isDeferred = true;
+
+		m_heldImages.append(deferredReply);
+
+		if (m_heldImagesTimer == 0)
+		{
+			m_heldImagesTimer = startTimer(HeldImagesTimeout);
+		}
+
+		connect(deferredReply, &QtWebKitDeferredNetworkReply::finished, this, [=]()
+		{
+			emit finished(deferredReply);
+		});
+	}
+	else if (isBackground && isNetworkRequest && operation == GetOperation && resourceType != NetworkManager::MainFrameType && resourceType != NetworkManager::SubFrameType && !QtWebKitRequestScheduler::canStartBackgroundRequest())
+	{
+		QtWebKitDeferredNetworkReply *deferredReply(new QtWebKitDeferredNetworkReply(mutableRequest, this));
+
+		reply = deferredReply;
+		isDeferred = true;
+
+		QtWebKitRequestScheduler::deferRequest(deferredReply);
+
+		connect(deferredReply, &QtWebKitDeferredNetworkReply::finished, this, [=]()
+		{
+			emit finished(deferredReply);
+		});
+	}
+	else if (m_transport)
+	{
+		reply = m_transport->createReply(this, operation, mutableRequest, outgoingData);
+	}
 	else
 	{
 		reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
 	}
 
+	if (isNetworkRequest && !isDeferred)
+	{
+		QtWebKitRequestScheduler::registerRequest(reply, isBackground);
+	}
+
+	if (needsRevalidation)
+	{
+		const QUrl url(mutableRequest.url().adjusted(QUrl::RemoveFragment));
+		QNetworkRequest revalidationRequest(mutableRequest);
+		revalidationRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+		revalidationRequest.setPriority(QNetworkRequest::LowPriority);
+
+		QNetworkReply *revalidationReply(QNetworkAccessManager::createRequest(GetOperation, revalidationRequest, nullptr));
+
+		connect(revalidationReply, &QNetworkReply::finished, revalidationReply, &QNetworkReply::deleteLater);
+		connect(revalidationReply, &QNetworkReply::destroyed, networkCache, [=]()
+		{
+			networkCache->finishRevalidation(url);
+		});
+	}
+
 	if (!m_baseReply && request.url() == m_mainRequestUrl)
 	{
 		m_baseReply = reply;
@@ -789,6 +1012,46 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 
 	m_replies[reply] = {0, false};
 
+	if (m_requestTimings.count() < RequestTimingsLimit)
+	{
+		const QList<QByteArray> headers(mutableRequest.rawHeaderList());
+		NetworkManager::RequestTiming timing;
+		timing.url = request.url();
+		timing.method = getOperationName(operation, request);
+		timing.startTime = QDateTime::currentMSecsSinceEpoch();
+		timing.resourceType = resourceType;
+		timing.hasCachedHost = hasCachedHost;
+		timing.requestHeaders.reserve(headers.count());
+
+		for (int i = 0; i < headers.count(); ++i)
+		{
+			timing.requestHeaders.append({headers.at(i), mutableRequest.rawHeader(headers.at(i))});
+		}
+
+		m_requestTimingsPositions[reply] = m_requestTimings.count();
+		m_requestTimings.append(timing);
+
+		connect(reply, &QNetworkReply::encrypted, this, [=]()
+		{
+			if (m_requestTimingsPositions.contains(reply))
+			{
+				m_requestTimings[m_requestTimingsPositions.value(reply)].encryptedTime = QDateTime::currentMSecsSinceEpoch();
+			}
+		});
+		connect(reply, &QNetworkReply::metaDataChanged, this, [=]()
+		{
+			if (m_requestTimingsPositions.contains(reply))
+			{
+				NetworkManager::RequestTiming &timing(m_requestTimings[m_requestTimingsPositions.value(reply)]);
+
+				if (timing.firstByteTime < 0)
+				{
+					timing.firstByteTime = QDateTime::currentMSecsSinceEpoch();
+				}
+			}
+		});
+	}
+
 	connect(reply, &QNetworkReply::downloadProgress, this, &QtWebKitNetworkManager::handleDownloadProgress);
 
 	if (m_loadingSpeedTimer == 0)
@@ -809,6 +1072,27 @@ QString QtWebKitNetworkManager::getUserAgent() const
 	return m_userAgent;
 }
 
+QByteArray QtWebKitNetworkManager::getOperationName(Operation operation, const QNetworkRequest &request)
+{
+	switch (operation)
+	{
+		case HeadOperation:
+			return QByteArrayLiteral("HEAD");
+		case PutOperation:
+			return QByteArrayLiteral("PUT");
+		case PostOperation:
+			return QByteArrayLiteral("POST");
+		case DeleteOperation:
+			return QByteArrayLiteral("DELETE");
+		case CustomOperation:
+			return request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+		default:
+			break;
+	}
+
+	return QByteArrayLiteral("GET");
+}
+
 QVariant QtWebKitNetworkManager::getOption(int identifier, const QUrl &url) const
 {
 	return (m_widget ? m_widget->getOption(identifier, url) : SettingsManager::getOption(identifier, Utils::extractHost(url)));
@@ -818,7 +1102,12 @@ QVariant QtWebKitNetworkManager::getPageInformation(WebWidget::PageInformation k
 {
 	if (key == WebWidget::RequestsBlockedInformation)
 	{
-		return m_blockedRequests.count();
+		return m_blockedRequests.getAmount();
+	}
+
+	if (key == WebWidget::ContentFilteringTimeInformation)
+	{
+		return static_cast<quint64>(m_contentFilteringTime / 1000);
 	}
 
 	return m_pageInformation.value(key);
@@ -831,12 +1120,22 @@ WebWidget::SslInformation QtWebKitNetworkManager::getSslInformation() const
 
 QStringList QtWebKitNetworkManager::getBlockedElements() const
 {
-	return m_blockedElements;
+	return m_blockedRequests.getElements();
 }
 
 QVector<NetworkManager::ResourceInformation> QtWebKitNetworkManager::getBlockedRequests() const
 {
-	return m_blockedRequests;
+	return m_blockedRequests.getRequests();
+}
+
+QHash<int, int> QtWebKitNetworkManager::getBlockedProfilesAmounts() const
+{
+	return m_blockedRequests.getProfilesAmounts();
+}
+
+QVector<NetworkManager::RequestTiming> QtWebKitNetworkManager::getRequestTimings() const
+{
+	return m_requestTimings;
 }
 
 QMap<QByteArray, QByteArray> QtWebKitNetworkManager::getHeaders() const
@@ -849,4 +1148,142 @@ WebWidget::ContentStates QtWebKitNetworkManager::getContentState() const
 	return m_contentState;
 }
 
+QtWebKitNetworkTransport::QtWebKitNetworkTransport(bool isPrivate, const QString &proxy, QObject *parent) : QNetworkAccessManager(parent)
+{
+	if (!isPrivate)
+	{
+		QNetworkDiskCache *cache(NetworkManagerFactory::getCache());
+
+		setCache(cache);
+
+		cache->setParent(QCoreApplication::instance());
+
+		connect(this, &QtWebKitNetworkTransport::finished, this, &NetworkManagerFactory::storeSslSession);
+	}
+	else
+	{
+		MemoryNetworkCache *cache(NetworkManagerFactory::getPrivateCache());
+
+		setCache(cache);
+
+		cache->setParent(QCoreApplication::instance());
+	}
+
+	if (!proxy.isEmpty())
+	{
+		NetworkProxyFactory *proxyFactory(new NetworkProxyFactory(this));
+		proxyFactory->setProxy(proxy);
+
+		setProxyFactory(proxyFactory);
+	}
+
+	connect(this, &QtWebKitNetworkTransport::finished, this, &QtWebKitNetworkTransport::handleRequestFinished);
+	connect(this, &QtWebKitNetworkTransport::finished, this, &NetworkManagerFactory::updateHttp2Support);
+	connect(this, &QtWebKitNetworkTransport::authenticationRequired, this, &QtWebKitNetworkTransport::handleAuthenticationRequired);
+	connect(this, &QtWebKitNetworkTransport::proxyAuthenticationRequired, this, &QtWebKitNetworkTransport::handleProxyAuthenticationRequired);
+	connect(this, &QtWebKitNetworkTransport::sslErrors, this, &QtWebKitNetworkTransport::handleSslErrors);
+	connect(NetworkManagerFactory::getInstance(), &NetworkManagerFactory::onlineStateChanged, this, [&](bool isOnline)
+	{
+		if (isOnline)
+		{
+			setNetworkAccessible(Accessible);
+		}
+	});
+}
+
+void QtWebKitNetworkTransport::handleRequestFinished(QNetworkReply *reply)
+{
+	const QPointer<QtWebKitNetworkManager> manager(m_managers.take(reply));
+
+	if (manager)
+	{
+		manager->handleRequestFinished(reply);
+	}
+}
+
+void QtWebKitNetworkTransport::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
+{
+	const QPointer<QtWebKitNetworkManager> manager(m_managers.value(reply));
+
+	if (manager)
+	{
+		manager->handleAuthenticationRequired(reply, authenticator);
+	}
+}
+
+void QtWebKitNetworkTransport::handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator)
+{
+	if (m_lastManager)
+	{
+		m_lastManager->handleProxyAuthenticationRequired(proxy, authenticator);
+	}
+}
+
+void QtWebKitNetworkTransport::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
+{
+	const QPointer<QtWebKitNetworkManager> manager(m_managers.value(reply));
+
+	if (manager)
+	{
+		manager->handleSslErrors(reply, errors);
+	}
+}
+
+QtWebKitNetworkTransport* QtWebKitNetworkTransport::getTransport(bool isPrivate, const QString &proxy)
+{
+	const QString key((isPrivate ? QLatin1String("private:") : QLatin1String("default:")) + proxy);
+
+	if (!m_transports.contains(key))
+	{
+		m_transports[key] = new QtWebKitNetworkTransport(isPrivate, proxy, QCoreApplication::instance());
+	}
+
+	return m_transports[key];
+}
+
+QNetworkReply* QtWebKitNetworkTransport::createReply(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+	const QPointer<QtWebKitNetworkManager> managerPointer(manager);
+	const bool canLoadCookies(request.attribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Automatic).toInt() == QNetworkRequest::Automatic);
+	const bool canSaveCookies(request.attribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Automatic).toInt() == QNetworkRequest::Automatic);
+	QNetworkRequest mutableRequest(request);
+	mutableRequest.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+	mutableRequest.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+
+	if (canLoadCookies && manager->cookieJar())
+	{
+		const QList<QNetworkCookie> cookies(manager->cookieJar()->cookiesForUrl(request.url()));
+
+		if (!cookies.isEmpty())
+		{
+			mutableRequest.setHeader(QNetworkRequest::CookieHeader, QVariant::fromValue(cookies));
+		}
+	}
+
+	QNetworkReply *reply(QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData));
+
+	m_lastManager = manager;
+	m_managers[reply] = manager;
+
+	if (canSaveCookies)
+	{
+		connect(reply, &QNetworkReply::metaDataChanged, manager, [=]()
+		{
+			const QList<QNetworkCookie> cookies(reply->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie> >());
+
+			if (managerPointer && managerPointer->cookieJar() && !cookies.isEmpty())
+			{
+				managerPointer->cookieJar()->setCookiesFromUrl(cookies, reply->url());
+			}
+		});
+	}
+
+	connect(reply, &QNetworkReply::destroyed, this, [=]()
+	{
+		m_managers.remove(reply);
+	});
+
+	return reply;
+}
+
 }
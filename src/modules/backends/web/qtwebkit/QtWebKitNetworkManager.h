@@ -33,6 +33,8 @@ namespace Otter
 
 class NetworkProxyFactory;
 class QtWebKitCookieJar;
+class QtWebKitDeferredNetworkReply;
+class QtWebKitNetworkTransport;
 class WebBackend;
 
 class QtWebKitNetworkManager final : public QNetworkAccessManager
@@ -42,19 +44,38 @@ class QtWebKitNetworkManager final : public QNetworkAccessManager
 public:
 	explicit QtWebKitNetworkManager(bool isPrivate, QtWebKitCookieJar *cookieJarProxy, QtWebKitWebWidget *parent);
 
+	void preconnect(const QUrl &url, bool canPrefetch);
 	CookieJar* getCookieJar() const;
 	QVariant getPageInformation(WebWidget::PageInformation key) const;
 	WebWidget::SslInformation getSslInformation() const;
 	QStringList getBlockedElements() const;
 	QVector<NetworkManager::ResourceInformation> getBlockedRequests() const;
+	QVector<NetworkManager::RequestTiming> getRequestTimings() const;
+	QHash<int, int> getBlockedProfilesAmounts() const;
 	QMap<QByteArray, QByteArray> getHeaders() const;
 	WebWidget::ContentStates getContentState() const;
 
 protected:
+	enum HeldImagesParameter
+	{
+		HeldImagesTimeout = 3000
+	};
+
+	enum PrefetchParameter
+	{
+		PrefetchSizeLimit = 2097152
+	};
+
+	enum RequestTimingParameter
+	{
+		RequestTimingsLimit = 5000
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void addContentBlockingException(const QUrl &url, NetworkManager::ResourceType resourceType);
 	void resetStatistics();
 	void registerTransfer(QNetworkReply *reply);
+	void releaseHeldImages(const QSet<QUrl> &deferredUrls);
 	void updateLoadingSpeed();
 	void updateOptions(const QUrl &url);
 	void setPageInformation(WebWidget::PageInformation key, const QVariant &value);
@@ -63,7 +84,9 @@ protected:
 	void setWidget(QtWebKitWebWidget *widget);
 	QtWebKitNetworkManager* clone() const;
 	QNetworkReply* createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData) override;
+	QNetworkReply* createScheduledReply(const QNetworkRequest &request);
 	QString getUserAgent() const;
+	static QByteArray getOperationName(Operation operation, const QNetworkRequest &request);
 	QVariant getOption(int identifier, const QUrl &url) const;
 
 protected slots:
@@ -80,28 +103,34 @@ private:
 	CookieJar *m_cookieJar;
 	QtWebKitCookieJar *m_cookieJarProxy;
 	NetworkProxyFactory *m_proxyFactory;
+	QtWebKitNetworkTransport *m_transport;
 	QNetworkReply *m_baseReply;
-	QString m_acceptLanguage;
 	QString m_userAgent;
 	QUrl m_formRequestUrl;
 	QUrl m_mainRequestUrl;
 	WebWidget::SslInformation m_sslInformation;
-	QStringList m_blockedElements;
 	QStringList m_unblockedHosts;
 	QVector<QNetworkReply*> m_transfers;
-	QVector<NetworkManager::ResourceInformation> m_blockedRequests;
+	QVector<QPointer<QtWebKitDeferredNetworkReply> > m_heldImages;
+	BlockedRequestsLog m_blockedRequests;
+	QVector<NetworkManager::RequestTiming> m_requestTimings;
 	QVector<int> m_contentBlockingProfiles;
 	QSet<QUrl> m_contentBlockingExceptions;
+	QSet<QNetworkReply*> m_prefetchReplies;
 	QHash<QNetworkReply*, QPair<qint64, bool> > m_replies;
+	QHash<QNetworkReply*, int> m_requestTimingsPositions;
 	QMap<QByteArray, QByteArray> m_headers;
 	QMap<WebWidget::PageInformation, QVariant> m_pageInformation;
+	NetworkManagerFactory::RequestHeaders m_requestHeaders;
 	WebWidget::ContentStates m_contentState;
-	NetworkManagerFactory::DoNotTrackPolicy m_doNotTrackPolicy;
 	TrileanValue m_isSecureValue;
 	qint64 m_bytesReceivedDifference;
+	qint64 m_contentFilteringTime;
+	int m_heldImagesTimer;
 	int m_loadingSpeedTimer;
 	bool m_areImagesEnabled;
-	bool m_canSendReferrer;
+	bool m_canHoldImages;
+	bool m_isHoldingImages;
 
 	static WebBackend *m_backend;
 
@@ -110,10 +139,36 @@ signals:
 	void requestBlocked(const NetworkManager::ResourceInformation &request);
 	void contentStateChanged(WebWidget::ContentStates state);
 
+friend class QtWebKitDeferredNetworkReply;
+friend class QtWebKitNetworkTransport;
 friend class QtWebKitPage;
 friend class QtWebKitWebWidget;
 };
 
+class QtWebKitNetworkTransport final : public QNetworkAccessManager
+{
+	Q_OBJECT
+
+public:
+	QNetworkReply* createReply(QtWebKitNetworkManager *manager, Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	static QtWebKitNetworkTransport* getTransport(bool isPrivate, const QString &proxy);
+
+protected:
+	explicit QtWebKitNetworkTransport(bool isPrivate, const QString &proxy, QObject *parent = nullptr);
+
+protected slots:
+	void handleRequestFinished(QNetworkReply *reply);
+	void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
+	void handleProxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
+	void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+
+private:
+	QPointer<QtWebKitNetworkManager> m_lastManager;
+	QHash<QNetworkReply*, QPointer<QtWebKitNetworkManager> > m_managers;
+
+	static QHash<QString, QtWebKitNetworkTransport*> m_transports;
+};
+
 }
 
 #endif
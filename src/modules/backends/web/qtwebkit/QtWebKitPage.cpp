@@ -26,6 +26,7 @@
 #include "../../../../core/Console.h"
 #include "../../../../core/ContentFiltersManager.h"
 #include "../../../../core/HandlersManager.h"
+#include "../../../../core/ScriptTemplate.h"
 #include "../../../../core/SettingsManager.h"
 #include "../../../../core/ThemesManager.h"
 #include "../../../../core/UserScript.h"
@@ -35,6 +36,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSet>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QWheelEvent>
 #include <QtWebKit/QWebHistory>
@@ -51,39 +53,50 @@ QtWebKitFrame::QtWebKitFrame(QWebFrame *frame, QtWebKitWebWidget *parent) : QObj
 {
 	connect(frame, &QWebFrame::destroyed, this, &QtWebKitFrame::deleteLater);
 	connect(frame, &QWebFrame::loadFinished, this, &QtWebKitFrame::handleLoadFinished);
+
+	if (!frame->parentFrame())
+	{
+		connect(frame, &QWebFrame::initialLayoutCompleted, this, &QtWebKitFrame::handleInitialLayoutCompleted);
+	}
 }
 
 void QtWebKitFrame::runUserScripts(const QUrl &url) const
 {
 	const QVector<UserScript*> scripts(UserScript::getUserScriptsForUrl(url, UserScript::AnyTime, (m_frame->parentFrame() != nullptr)));
 
-	for (int i = 0; i < scripts.count(); ++i)
+	if (!scripts.isEmpty())
 	{
-		m_frame->documentElement().evaluateJavaScript(scripts.at(i)->getSource());
+		m_frame->documentElement().evaluateJavaScript(UserScript::getSourceBundle(scripts));
 	}
 }
 
-void QtWebKitFrame::applyContentBlockingRules(const QStringList &rules, bool isHiding)
+void QtWebKitFrame::handleIsDisplayingErrorPageChanged(QWebFrame *frame, bool isDisplayingErrorPage)
 {
-	const QString value(isHiding ? QLatin1String("none !important") : QString());
-	const QWebElementCollection elements(m_frame->documentElement().findAll(rules.join(QLatin1Char(','))));
-
-	for (int i = 0; i < elements.count(); ++i)
+	if (frame == m_frame)
 	{
-		QWebElement element(elements.at(i));
-
-		if (!element.isNull())
-		{
-			element.setStyleProperty(QLatin1String("display"), value);
-		}
+		m_isDisplayingErrorPage = isDisplayingErrorPage;
 	}
 }
 
-void QtWebKitFrame::handleIsDisplayingErrorPageChanged(QWebFrame *frame, bool isDisplayingErrorPage)
+void QtWebKitFrame::handleInitialLayoutCompleted()
 {
-	if (frame == m_frame)
+	if (!m_widget || m_isDisplayingErrorPage)
 	{
-		m_isDisplayingErrorPage = isDisplayingErrorPage;
+		return;
+	}
+
+	const QUrl url(m_frame->url());
+
+	if ((url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")) || !m_widget->getOption(SettingsManager::Content_LazyLoadImagesOption, url).toBool() || !m_widget->getOption(SettingsManager::Permissions_EnableJavaScriptOption, url).toBool())
+	{
+		return;
+	}
+
+	const ScriptTemplate scriptTemplate(ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebkit/resources/imageDeferrer.js")));
+
+	if (scriptTemplate.isValid())
+	{
+		m_frame->documentElement().evaluateJavaScript(scriptTemplate.createSource({m_widget->getMessageToken()}));
 	}
 }
 
@@ -97,27 +110,23 @@ void QtWebKitFrame::handleLoadFinished()
 	if (m_isDisplayingErrorPage)
 	{
 		const QVector<WebWidget::SslInformation::SslError> sslErrors(m_widget->getSslInformation().errors);
-		QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/errorPage.js"));
+		const ScriptTemplate scriptTemplate(ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebkit/resources/errorPage.js")));
 
-		if (file.open(QIODevice::ReadOnly))
+		if (scriptTemplate.isValid())
 		{
-			m_frame->documentElement().evaluateJavaScript(QString::fromLatin1(file.readAll()).arg(m_widget->getMessageToken(), QString::fromLatin1((sslErrors.isEmpty() ? QByteArray() : sslErrors.value(0).error.certificate().digest().toBase64())), ((m_frame->page()->history()->currentItemIndex() > 0) ? QLatin1String("true") : QLatin1String("false"))));
-
-			file.close();
+			m_frame->documentElement().evaluateJavaScript(scriptTemplate.createSource({m_widget->getMessageToken(), QString::fromLatin1((sslErrors.isEmpty() ? QByteArray() : sslErrors.value(0).error.certificate().digest().toBase64())), ((m_frame->page()->history()->currentItemIndex() > 0) ? QLatin1String("true") : QLatin1String("false"))}));
 		}
 	}
 
 	runUserScripts(m_widget->getUrl());
 
-	if (!m_widget->isPrivate() && m_widget->getOption(SettingsManager::Browser_RememberPasswordsOption).toBool())
+	if (!m_isDisplayingErrorPage && !m_widget->isPrivate() && !Utils::extractHost(m_frame->url()).isEmpty() && m_widget->getOption(SettingsManager::Browser_RememberPasswordsOption).toBool())
 	{
-		QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/formExtractor.js"));
+		const ScriptTemplate scriptTemplate(ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebkit/resources/formExtractor.js")));
 
-		if (file.open(QIODevice::ReadOnly))
+		if (scriptTemplate.isValid())
 		{
-			m_frame->documentElement().evaluateJavaScript(QString::fromLatin1(file.readAll()).arg(m_widget->getMessageToken()));
-
-			file.close();
+			m_frame->documentElement().evaluateJavaScript(scriptTemplate.createSource({m_widget->getMessageToken()}));
 		}
 	}
 
@@ -126,33 +135,69 @@ void QtWebKitFrame::handleLoadFinished()
 		return;
 	}
 
-	const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), m_widget->getUrl()));
+	const QStringList blockedRequests(m_widget->getBlockedElements());
+
+	if (blockedRequests.isEmpty())
+	{
+		return;
+	}
+
+	QSet<QString> blockedUrls;
+	blockedUrls.reserve(blockedRequests.count());
 
-	applyContentBlockingRules(cosmeticFilters.rules, true);
-	applyContentBlockingRules(cosmeticFilters.exceptions, false);
+	for (int i = 0; i < blockedRequests.count(); ++i)
+	{
+		blockedUrls.insert(blockedRequests.at(i));
+	}
 
-	const QStringList blockedRequests(m_widget->getBlockedElements());
+	const QUrl baseUrl(m_frame->baseUrl());
+	const QWebElementCollection elements(m_frame->documentElement().findAll(QLatin1String("[src]")));
+	QSet<QString> checkedSources;
+	QStringList selectors;
 
-	if (blockedRequests.count() > 0)
+	for (int i = 0; i < elements.count(); ++i)
 	{
-		const QWebElementCollection elements(m_frame->documentElement().findAll(QLatin1String("[src]")));
+		const QString source(elements.at(i).attribute(QLatin1String("src")));
 
-		for (int i = 0; i < elements.count(); ++i)
+		if (source.isEmpty() || checkedSources.contains(source))
 		{
-			QWebElement element(elements.at(i));
-			const QUrl url(element.attribute(QLatin1String("src")));
+			continue;
+		}
 
-			for (int j = 0; j < blockedRequests.count(); ++j)
-			{
-				if (url.matches(QUrl(blockedRequests.at(j)), QUrl::None) || blockedRequests.at(j).endsWith(url.url()))
-				{
-					element.setStyleProperty(QLatin1String("display"), QLatin1String("none !important"));
+		checkedSources.insert(source);
 
-					break;
-				}
-			}
+		if (blockedUrls.contains(source) || blockedUrls.contains(baseUrl.resolved(QUrl(source)).url()))
+		{
+			QString escapedSource(source);
+			escapedSource.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+			escapedSource.replace(QLatin1Char('"'), QLatin1String("\\\""));
+			escapedSource.replace(QLatin1Char('<'), QLatin1String("\\3c "));
+			escapedSource.replace(QLatin1Char('\n'), QLatin1String("\\a "));
+
+			selectors.append(QLatin1String("[src=\"") + escapedSource + QLatin1String("\"]"));
 		}
 	}
+
+	QWebElement styleElement(m_frame->documentElement().findFirst(QLatin1String("style[data-otter-blocked-elements]")));
+
+	if (!styleElement.isNull())
+	{
+		styleElement.removeFromDocument();
+	}
+
+	if (selectors.isEmpty())
+	{
+		return;
+	}
+
+	QWebElement headElement(m_frame->documentElement().findFirst(QLatin1String("head")));
+
+	if (headElement.isNull())
+	{
+		headElement = m_frame->documentElement();
+	}
+
+	headElement.appendInside(QLatin1String("<style data-otter-blocked-elements>") + selectors.join(QLatin1Char(',')) + QLatin1String(" {display: none !important;}</style>"));
 }
 
 bool QtWebKitFrame::isDisplayingErrorPage() const
@@ -166,6 +211,7 @@ QtWebKitPage::QtWebKitPage(QtWebKitNetworkManager *networkManager, QtWebKitWebWi
 	m_mainFrame(nullptr),
 	m_isIgnoringJavaScriptPopups(false),
 	m_isPopup(false),
+	m_isThrottled(false),
 	m_isViewingMedia(false)
 {
 	setNetworkAccessManager(m_networkManager);
@@ -194,6 +240,7 @@ QtWebKitPage::QtWebKitPage() :
 	m_mainFrame(nullptr),
 	m_isIgnoringJavaScriptPopups(false),
 	m_isPopup(false),
+	m_isThrottled(false),
 	m_isViewingMedia(false)
 {
 }
@@ -204,6 +251,7 @@ QtWebKitPage::QtWebKitPage(const QUrl &url) :
 	m_mainFrame(nullptr),
 	m_isIgnoringJavaScriptPopups(true),
 	m_isPopup(false),
+	m_isThrottled(false),
 	m_isViewingMedia(false)
 {
 	setNetworkAccessManager(m_networkManager);
@@ -274,6 +322,18 @@ void QtWebKitPage::markAsPopup()
 	m_isPopup = true;
 }
 
+void QtWebKitPage::applyStyleSheet()
+{
+	QString styleSheet(m_styleSheet);
+
+	if (m_isThrottled)
+	{
+		styleSheet.append(QLatin1String("* {-webkit-animation-play-state: paused !important; animation-play-state: paused !important;}"));
+	}
+
+	settings()->setUserStyleSheetUrl(QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + styleSheet.toUtf8().toBase64()));
+}
+
 void QtWebKitPage::handleOptionChanged(int identifier)
 {
 	if (SettingsManager::getOptionName(identifier).startsWith(QLatin1String("Content/")) || identifier == SettingsManager::Interface_ShowScrollBarsOption)
@@ -389,6 +449,18 @@ void QtWebKitPage::updateStyleSheets(const QUrl &url)
 		styleSheet.append(QLatin1String("body::-webkit-scrollbar {display:none;}"));
 	}
 
+	const QUrl pageUrl(url.isEmpty() ? (mainFrame()->url().isEmpty() ? mainFrame()->requestedUrl() : mainFrame()->url()) : url);
+
+	if (!pageUrl.host().isEmpty() && getOption(SettingsManager::ContentBlocking_EnableContentBlockingOption).toBool())
+	{
+		const QStringList profiles(getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList());
+
+		if (!profiles.isEmpty())
+		{
+			styleSheet.append(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(profiles), pageUrl).styleSheet);
+		}
+	}
+
 	const QString userSyleSheetPath(getOption(SettingsManager::Content_UserStyleSheetOption).toString());
 
 	if (!userSyleSheetPath.isEmpty())
@@ -403,7 +475,12 @@ void QtWebKitPage::updateStyleSheets(const QUrl &url)
 		}
 	}
 
-	settings()->setUserStyleSheetUrl(QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + styleSheet.toUtf8().toBase64()));
+	if (styleSheet != m_styleSheet)
+	{
+		m_styleSheet = styleSheet;
+
+		applyStyleSheet();
+	}
 }
 
 void QtWebKitPage::javaScriptAlert(QWebFrame *frame, const QString &message)
@@ -477,6 +554,16 @@ QWebPage* QtWebKitPage::createWindow(WebWindowType type)
 	return QWebPage::createWindow(type);
 }
 
+void QtWebKitPage::setThrottled(bool isThrottled)
+{
+	if (isThrottled != m_isThrottled)
+	{
+		m_isThrottled = isThrottled;
+
+		applyStyleSheet();
+	}
+}
+
 QtWebKitFrame* QtWebKitPage::getMainFrame() const
 {
 	return m_mainFrame;
@@ -530,15 +617,11 @@ QVariant QtWebKitPage::runScript(const QString &path, QWebElement element)
 		element = mainFrame()->documentElement();
 	}
 
-	QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/") + path + QLatin1String(".js"));
+	const ScriptTemplate scriptTemplate(ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebkit/resources/") + path + QLatin1String(".js")));
 
-	if (file.open(QIODevice::ReadOnly))
+	if (scriptTemplate.isValid())
 	{
-		const QVariant result(element.evaluateJavaScript(QString::fromLatin1(file.readAll())));
-
-		file.close();
-
-		return result;
+		return element.evaluateJavaScript(scriptTemplate.createSource());
 	}
 
 	return {};
@@ -47,10 +47,8 @@ public:
 public slots:
 	void handleIsDisplayingErrorPageChanged(QWebFrame *frame, bool isDisplayingErrorPage);
 
-protected:
-	void applyContentBlockingRules(const QStringList &rules, bool isHiding);
-
 protected slots:
+	void handleInitialLayoutCompleted();
 	void handleLoadFinished();
 
 private:
@@ -68,6 +66,7 @@ public:
 	~QtWebKitPage();
 
 	void triggerAction(WebAction action, bool isChecked = false) override;
+	void setThrottled(bool isThrottled);
 	QtWebKitFrame* getMainFrame() const;
 	QVariant runScript(const QString &path, QWebElement element = {});
 	bool event(QEvent *event) override;
@@ -87,6 +86,7 @@ protected:
 	explicit QtWebKitPage(const QUrl &url);
 
 	void markAsPopup();
+	void applyStyleSheet();
 	void javaScriptAlert(QWebFrame *frame, const QString &message) override;
 	QWebPage* createWindow(WebWindowType type) override;
 	QtWebKitWebWidget* createWidget(SessionsManager::OpenHints hints);
@@ -108,8 +108,10 @@ private:
 	QtWebKitNetworkManager *m_networkManager;
 	QtWebKitFrame *m_mainFrame;
 	QVector<QtWebKitPage*> m_popups;
+	QString m_styleSheet;
 	bool m_isIgnoringJavaScriptPopups;
 	bool m_isPopup;
+	bool m_isThrottled;
 	bool m_isViewingMedia;
 
 signals:
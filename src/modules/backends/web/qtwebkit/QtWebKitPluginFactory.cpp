@@ -25,21 +25,54 @@
 namespace Otter
 {
 
+int QtWebKitPluginFactory::m_totalAmountOfPlugins(0);
+
 QtWebKitPluginFactory::QtWebKitPluginFactory(QtWebKitWebWidget *parent) : QWebPluginFactory(parent),
-	m_widget(parent)
+	m_widget(parent),
+	m_amountOfPlugins(0),
+	m_isBudgetEnabled(true)
+{
+}
+
+QtWebKitPluginFactory::~QtWebKitPluginFactory()
+{
+	m_totalAmountOfPlugins -= m_amountOfPlugins;
+}
+
+void QtWebKitPluginFactory::resetBudget()
+{
+	m_totalAmountOfPlugins -= m_amountOfPlugins;
+	m_amountOfPlugins = 0;
+	m_isBudgetEnabled = true;
+}
+
+void QtWebKitPluginFactory::setBudgetEnabled(bool isEnabled)
 {
+	m_isBudgetEnabled = isEnabled;
+}
+
+void QtWebKitPluginFactory::registerPlugin() const
+{
+	++m_amountOfPlugins;
+	++m_totalAmountOfPlugins;
 }
 
 QObject* QtWebKitPluginFactory::create(const QString &mimeType, const QUrl &url, const QStringList &argumentNames, const QStringList &argumentValues) const
 {
 	const bool isActivatingPlugin(argumentNames.contains(QLatin1String("data-otter-browser")) && argumentValues.value(argumentNames.indexOf(QLatin1String("data-otter-browser"))) == m_widget->getPluginToken());
 
-	if (m_widget->canLoadPlugins() || isActivatingPlugin)
+	if (isActivatingPlugin)
 	{
-		if (isActivatingPlugin)
-		{
-			m_widget->clearPluginToken();
-		}
+		m_widget->clearPluginToken();
+
+		registerPlugin();
+
+		return nullptr;
+	}
+
+	if (m_widget->canLoadPlugins() && (!m_isBudgetEnabled || canCreatePlugin(argumentNames, argumentValues)))
+	{
+		registerPlugin();
 
 		return nullptr;
 	}
@@ -52,4 +85,36 @@ QList<QWebPluginFactory::Plugin> QtWebKitPluginFactory::plugins() const
 	return {};
 }
 
+bool QtWebKitPluginFactory::canCreatePlugin(const QStringList &argumentNames, const QStringList &argumentValues) const
+{
+	if (m_amountOfPlugins >= PagePluginsLimit || m_totalAmountOfPlugins >= GlobalPluginsLimit)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < argumentNames.count(); ++i)
+	{
+		const QString name(argumentNames.at(i).toLower());
+		const QString value(argumentValues.value(i).trimmed());
+
+		if (name == QLatin1String("hidden") && value.compare(QLatin1String("false"), Qt::CaseInsensitive) != 0)
+		{
+			return false;
+		}
+
+		if (name == QLatin1String("width") || name == QLatin1String("height"))
+		{
+			bool isValid(false);
+			const int size(value.toInt(&isValid));
+
+			if (isValid && size < PluginMinimumSize)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 }
@@ -34,12 +34,30 @@ class QtWebKitPluginFactory final : public QWebPluginFactory
 
 public:
 	explicit QtWebKitPluginFactory(QtWebKitWebWidget *parent);
+	~QtWebKitPluginFactory();
 
+	void resetBudget();
+	void setBudgetEnabled(bool isEnabled);
 	QObject* create(const QString &mimeType, const QUrl &url, const QStringList &argumentNames, const QStringList &argumentValues) const override;
 	QList<QWebPluginFactory::Plugin> plugins() const override;
 
+protected:
+	enum PluginBudgetParameter
+	{
+		GlobalPluginsLimit = 50,
+		PagePluginsLimit = 10,
+		PluginMinimumSize = 5
+	};
+
+	void registerPlugin() const;
+	bool canCreatePlugin(const QStringList &argumentNames, const QStringList &argumentValues) const;
+
 private:
 	QtWebKitWebWidget *m_widget;
+	mutable int m_amountOfPlugins;
+	bool m_isBudgetEnabled;
+
+	static int m_totalAmountOfPlugins;
 };
 
 }
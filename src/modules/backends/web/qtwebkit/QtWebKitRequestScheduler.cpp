@@ -0,0 +1,261 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "QtWebKitRequestScheduler.h"
+#include "QtWebKitNetworkManager.h"
+
+#include <QtNetwork/QSslConfiguration>
+
+namespace Otter
+{
+
+QQueue<QPointer<QtWebKitDeferredNetworkReply> > QtWebKitRequestScheduler::m_pendingRequests;
+QSet<QNetworkReply*> QtWebKitRequestScheduler::m_backgroundRequests;
+QSet<QNetworkReply*> QtWebKitRequestScheduler::m_foregroundRequests;
+
+QtWebKitDeferredNetworkReply::QtWebKitDeferredNetworkReply(const QNetworkRequest &request, QtWebKitNetworkManager *parent) : QNetworkReply(parent),
+	m_manager(parent),
+	m_reply(nullptr)
+{
+	setRequest(request);
+	setUrl(request.url());
+	setOperation(QNetworkAccessManager::GetOperation);
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void QtWebKitDeferredNetworkReply::start()
+{
+	if (m_reply || isFinished() || !m_manager)
+	{
+		return;
+	}
+
+	m_reply = m_manager->createScheduledReply(request());
+	m_reply->setParent(this);
+
+	connect(m_reply, &QNetworkReply::metaDataChanged, this, &QtWebKitDeferredNetworkReply::updateMetaData);
+	connect(m_reply, &QNetworkReply::readyRead, this, &QtWebKitDeferredNetworkReply::readyRead);
+	connect(m_reply, &QNetworkReply::downloadProgress, this, &QtWebKitDeferredNetworkReply::downloadProgress);
+	connect(m_reply, &QNetworkReply::encrypted, this, &QtWebKitDeferredNetworkReply::encrypted);
+	connect(m_reply, &QNetworkReply::finished, this, &QtWebKitDeferredNetworkReply::handleFinished);
+
+	if (m_reply->isFinished())
+	{
+		handleFinished();
+	}
+}
+
+void QtWebKitDeferredNetworkReply::abort()
+{
+	if (m_reply)
+	{
+		m_reply->abort();
+
+		return;
+	}
+
+	if (isFinished())
+	{
+		return;
+	}
+
+	setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+	setFinished(true);
+
+	emit finished();
+}
+
+void QtWebKitDeferredNetworkReply::ignoreSslErrors()
+{
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors();
+	}
+}
+
+void QtWebKitDeferredNetworkReply::sslConfigurationImplementation(QSslConfiguration &configuration) const
+{
+	if (m_reply)
+	{
+		configuration = m_reply->sslConfiguration();
+	}
+}
+
+void QtWebKitDeferredNetworkReply::updateMetaData()
+{
+	const QList<QNetworkReply::RawHeaderPair> rawHeaders(m_reply->rawHeaderPairs());
+	const QVector<QNetworkRequest::Attribute> attributes({QNetworkRequest::HttpStatusCodeAttribute, QNetworkRequest::HttpReasonPhraseAttribute, QNetworkRequest::RedirectionTargetAttribute, QNetworkRequest::ConnectionEncryptedAttribute, QNetworkRequest::SourceIsFromCacheAttribute, QNetworkRequest::HttpPipeliningWasUsedAttribute
+#if QT_VERSION >= 0x050900
+		, QNetworkRequest::HTTP2WasUsedAttribute
+#endif
+	});
+
+	for (int i = 0; i < rawHeaders.count(); ++i)
+	{
+		setRawHeader(rawHeaders.at(i).first, rawHeaders.at(i).second);
+	}
+
+	for (int i = 0; i < attributes.count(); ++i)
+	{
+		setAttribute(attributes.at(i), m_reply->attribute(attributes.at(i)));
+	}
+
+	setUrl(m_reply->url());
+
+	emit metaDataChanged();
+}
+
+void QtWebKitDeferredNetworkReply::handleFinished()
+{
+	if (isFinished())
+	{
+		return;
+	}
+
+	updateMetaData();
+	setError(m_reply->error(), m_reply->errorString());
+	setFinished(true);
+
+	if (m_reply->error() != QNetworkReply::NoError)
+	{
+		emit error(m_reply->error());
+	}
+
+	emit finished();
+}
+
+QtWebKitNetworkManager* QtWebKitDeferredNetworkReply::getManager() const
+{
+	return m_manager.data();
+}
+
+qint64 QtWebKitDeferredNetworkReply::bytesAvailable() const
+{
+	return (QNetworkReply::bytesAvailable() + (m_reply ? m_reply->bytesAvailable() : 0));
+}
+
+qint64 QtWebKitDeferredNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (!m_reply)
+	{
+		return (isFinished() ? -1 : 0);
+	}
+
+	const qint64 size(m_reply->read(data, maxSize));
+
+	return ((size <= 0 && isFinished()) ? -1 : size);
+}
+
+bool QtWebKitDeferredNetworkReply::isStarted() const
+{
+	return (m_reply != nullptr);
+}
+
+bool QtWebKitDeferredNetworkReply::isSequential() const
+{
+	return true;
+}
+
+void QtWebKitRequestScheduler::registerRequest(QNetworkReply *reply, bool isBackground)
+{
+	if (!reply || reply->isFinished())
+	{
+		return;
+	}
+
+	if (isBackground)
+	{
+		m_backgroundRequests.insert(reply);
+	}
+	else
+	{
+		m_foregroundRequests.insert(reply);
+	}
+
+	const auto removeRequest([=]()
+	{
+		if (m_backgroundRequests.remove(reply) || m_foregroundRequests.remove(reply))
+		{
+			startPendingRequests();
+		}
+	});
+
+	QObject::connect(reply, &QNetworkReply::finished, removeRequest);
+	QObject::connect(reply, &QNetworkReply::destroyed, removeRequest);
+}
+
+void QtWebKitRequestScheduler::deferRequest(QtWebKitDeferredNetworkReply *reply)
+{
+	m_pendingRequests.enqueue(reply);
+}
+
+void QtWebKitRequestScheduler::releaseRequests(QtWebKitNetworkManager *manager)
+{
+	QVector<QPointer<QtWebKitDeferredNetworkReply> > requests;
+	QQueue<QPointer<QtWebKitDeferredNetworkReply> >::iterator iterator(m_pendingRequests.begin());
+
+	while (iterator != m_pendingRequests.end())
+	{
+		if (!*iterator || (*iterator)->getManager() == manager)
+		{
+			if (*iterator)
+			{
+				requests.append(*iterator);
+			}
+
+			iterator = m_pendingRequests.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	for (int i = 0; i < requests.count(); ++i)
+	{
+		if (requests.at(i))
+		{
+			requests.at(i)->start();
+
+			registerRequest(requests.at(i), false);
+		}
+	}
+}
+
+void QtWebKitRequestScheduler::startPendingRequests()
+{
+	while (!m_pendingRequests.isEmpty() && canStartBackgroundRequest())
+	{
+		const QPointer<QtWebKitDeferredNetworkReply> reply(m_pendingRequests.dequeue());
+
+		if (reply && !reply->isFinished())
+		{
+			reply->start();
+
+			registerRequest(reply, true);
+		}
+	}
+}
+
+bool QtWebKitRequestScheduler::canStartBackgroundRequest()
+{
+	return (m_backgroundRequests.count() < (m_foregroundRequests.isEmpty() ? BackgroundRequestsLimit : BusyBackgroundRequestsLimit));
+}
+
+}
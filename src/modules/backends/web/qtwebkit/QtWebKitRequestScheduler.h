@@ -0,0 +1,88 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_QTWEBKITREQUESTSCHEDULER_H
+#define OTTER_QTWEBKITREQUESTSCHEDULER_H
+
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class QtWebKitNetworkManager;
+
+class QtWebKitDeferredNetworkReply final : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	explicit QtWebKitDeferredNetworkReply(const QNetworkRequest &request, QtWebKitNetworkManager *parent);
+
+	void start();
+	QtWebKitNetworkManager* getManager() const;
+	qint64 bytesAvailable() const override;
+	qint64 readData(char *data, qint64 maxSize) override;
+	bool isStarted() const;
+	bool isSequential() const override;
+
+public slots:
+	void abort() override;
+	void ignoreSslErrors() override;
+
+protected:
+	void sslConfigurationImplementation(QSslConfiguration &configuration) const override;
+	void updateMetaData();
+
+protected slots:
+	void handleFinished();
+
+private:
+	QPointer<QtWebKitNetworkManager> m_manager;
+	QNetworkReply *m_reply;
+};
+
+class QtWebKitRequestScheduler final
+{
+public:
+	static void registerRequest(QNetworkReply *reply, bool isBackground);
+	static void deferRequest(QtWebKitDeferredNetworkReply *reply);
+	static void releaseRequests(QtWebKitNetworkManager *manager);
+	static bool canStartBackgroundRequest();
+
+protected:
+	enum SchedulerParameter
+	{
+		BackgroundRequestsLimit = 6,
+		BusyBackgroundRequestsLimit = 2
+	};
+
+	static void startPendingRequests();
+
+private:
+	static QQueue<QPointer<QtWebKitDeferredNetworkReply> > m_pendingRequests;
+	static QSet<QNetworkReply*> m_backgroundRequests;
+	static QSet<QNetworkReply*> m_foregroundRequests;
+};
+
+}
+
+#endif
@@ -21,13 +21,20 @@
 
 #include "QtWebKitSpellChecker.h"
 #include "QtWebKitWebBackend.h"
+#include "../../../../../3rdparty/sonnet/src/core/loader_p.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QTextBoundaryFinder>
 
 namespace Otter
 {
 
-Sonnet::Speller* QtWebKitSpellChecker::m_speller(nullptr);
+Sonnet::SpellerPlugin* QtWebKitSpellChecker::m_speller(nullptr);
+QFutureWatcher<Sonnet::SpellerPlugin*>* QtWebKitSpellChecker::m_loadingWatcher(nullptr);
+QCache<QString, bool> QtWebKitSpellChecker::m_verdictsCache(VerdictsCacheLimit);
+QCache<QString, QStringList> QtWebKitSpellChecker::m_suggestionsCache(SuggestionsCacheLimit);
+QString QtWebKitSpellChecker::m_loadingDictionary;
+QString QtWebKitSpellChecker::m_pendingDictionary;
 
 QtWebKitSpellChecker::QtWebKitSpellChecker()
 {
@@ -72,7 +79,7 @@ void QtWebKitSpellChecker::checkSpellingOfString(const QString &word, int *missp
 
 			if (isValidWord(string))
 			{
-				if (m_speller->isMisspelled(string))
+				if (isMisspelled(string))
 				{
 					*misspellingLocation = start;
 					*misspellingLength = (end - start);
@@ -105,6 +112,9 @@ void QtWebKitSpellChecker::learnWord(const QString &word)
 	if (m_speller)
 	{
 		m_speller->addToPersonal(word);
+
+		m_verdictsCache.remove(word);
+		m_suggestionsCache.remove(word);
 	}
 }
 
@@ -113,6 +123,9 @@ void QtWebKitSpellChecker::ignoreWordInSpellDocument(const QString &word)
 	if (m_speller)
 	{
 		m_speller->addToSession(word);
+
+		m_verdictsCache.remove(word);
+		m_suggestionsCache.remove(word);
 	}
 }
 
@@ -120,31 +133,74 @@ void QtWebKitSpellChecker::guessesForWord(const QString &word, const QString &co
 {
 	Q_UNUSED(context)
 
-	if (m_speller)
-	{
-		guesses = m_speller->suggest(word);
-	}
+	guesses = getSuggestions(word);
 }
 
 void QtWebKitSpellChecker::setDictionary(const QString &dictionary)
 {
-	if (dictionary.isEmpty() && m_speller)
-	{
-		delete m_speller;
+	loadDictionary(dictionary);
+}
 
-		m_speller = nullptr;
-	}
-	else if (!dictionary.isEmpty())
+void QtWebKitSpellChecker::loadDictionary(const QString &dictionary)
+{
+	m_pendingDictionary = dictionary;
+
+	if (dictionary.isEmpty())
 	{
 		if (m_speller)
 		{
-			m_speller->setLanguage(dictionary);
+			delete m_speller;
+
+			m_speller = nullptr;
 		}
-		else
+
+		clearCaches();
+
+		return;
+	}
+
+	if ((m_loadingWatcher && m_loadingWatcher->isRunning()) || (m_speller && m_speller->language() == dictionary))
+	{
+		return;
+	}
+
+	if (!m_loadingWatcher)
+	{
+		m_loadingWatcher = new QFutureWatcher<Sonnet::SpellerPlugin*>(QtWebKitWebBackend::getInstance());
+
+		connect(m_loadingWatcher, &QFutureWatcher<Sonnet::SpellerPlugin*>::finished, m_loadingWatcher, []()
 		{
-			m_speller = new Sonnet::Speller(dictionary);
-		}
+			Sonnet::SpellerPlugin *speller(m_loadingWatcher->result());
+
+			if (m_speller)
+			{
+				delete m_speller;
+			}
+
+			m_speller = speller;
+
+			clearCaches();
+
+			if (m_pendingDictionary != m_loadingDictionary)
+			{
+				loadDictionary(m_pendingDictionary);
+			}
+		});
 	}
+
+	const Sonnet::Loader *loader(Sonnet::Loader::openLoader());
+
+	m_loadingDictionary = dictionary;
+	m_loadingWatcher->setFuture(QtConcurrent::run([=]()
+	{
+		return loader->createSpeller(dictionary);
+	}));
+}
+
+void QtWebKitSpellChecker::clearCaches()
+{
+	m_verdictsCache.clear();
+	m_suggestionsCache.clear();
 }
 
 QString QtWebKitSpellChecker::autoCorrectSuggestionForMisspelledWord(const QString &word)
@@ -158,15 +214,26 @@ QStringList QtWebKitSpellChecker::getSuggestions(const QString &word)
 {
 	if (!m_speller)
 	{
-		m_speller = new Sonnet::Speller(QtWebKitWebBackend::getActiveDictionary());
+		loadDictionary(QtWebKitWebBackend::getActiveDictionary());
+
+		return {};
 	}
 
-	if (m_speller->isCorrect(word))
+	if (!isMisspelled(word))
 	{
 		return {};
 	}
 
-	return m_speller->suggest(word);
+	if (m_suggestionsCache.contains(word))
+	{
+		return *m_suggestionsCache.object(word);
+	}
+
+	const QStringList suggestions(m_speller->suggest(word));
+
+	m_suggestionsCache.insert(word, new QStringList(suggestions));
+
+	return suggestions;
 }
 
 bool QtWebKitSpellChecker::isContinousSpellCheckingEnabled() const
@@ -179,6 +246,25 @@ bool QtWebKitSpellChecker::isGrammarCheckingEnabled()
 	return false;
 }
 
+bool QtWebKitSpellChecker::isMisspelled(const QString &word)
+{
+	if (!m_speller)
+	{
+		return false;
+	}
+
+	if (m_verdictsCache.contains(word))
+	{
+		return *m_verdictsCache.object(word);
+	}
+
+	const bool isMisspelled(m_speller->isMisspelled(word));
+
+	m_verdictsCache.insert(word, new bool(isMisspelled));
+
+	return isMisspelled;
+}
+
 bool QtWebKitSpellChecker::isValidWord(const QString &string)
 {
 	if (string.isEmpty() || (string.length() == 1 && !string.at(0).isLetter()))
@@ -23,7 +23,10 @@
 #define QTWEBKITSPELLCHECKER_H
 
 #include "qwebkitplatformplugin.h"
-#include "../../../../../3rdparty/sonnet/src/core/speller.h"
+#include "../../../../../3rdparty/sonnet/src/core/spellerplugin_p.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QFutureWatcher>
 
 namespace Otter
 {
@@ -48,13 +51,27 @@ public:
 	bool isGrammarCheckingEnabled() override;
 
 protected:
+	enum CacheLimit
+	{
+		VerdictsCacheLimit = 10000,
+		SuggestionsCacheLimit = 100
+	};
+
+	static void loadDictionary(const QString &dictionary);
+	static void clearCaches();
+	static bool isMisspelled(const QString &word);
 	static bool isValidWord(const QString &string);
 
 protected slots:
 	void setDictionary(const QString &dictionary);
 
 private:
-	static Sonnet::Speller *m_speller;
+	static Sonnet::SpellerPlugin *m_speller;
+	static QFutureWatcher<Sonnet::SpellerPlugin*> *m_loadingWatcher;
+	static QCache<QString, bool> m_verdictsCache;
+	static QCache<QString, QStringList> m_suggestionsCache;
+	static QString m_loadingDictionary;
+	static QString m_pendingDictionary;
 };
 
 }
@@ -31,10 +31,19 @@
 #include <QtCore/QPointer>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtWebKit/QWebHistoryInterface>
 #include <QtWebKit/QWebSettings>
 #include <QtWebKitWidgets/QWebFrame>
 
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_DARWIN)
+#include <sys/sysctl.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
 namespace Otter
 {
 
@@ -44,15 +53,21 @@ QHash<QString, QString> QtWebKitWebBackend::m_userAgentComponents;
 QMap<QString, QString> QtWebKitWebBackend::m_userAgents;
 int QtWebKitWebBackend::m_enableMediaOption(-1);
 int QtWebKitWebBackend::m_enableMediaSourceOption(-1);
+int QtWebKitWebBackend::m_enableMemoryBudgetOption(-1);
+int QtWebKitWebBackend::m_enableSharedNetworkTransportOption(-1);
 int QtWebKitWebBackend::m_enableSiteSpecificQuirksOption(-1);
 int QtWebKitWebBackend::m_enableWebSecurityOption(-1);
 
 QtWebKitWebBackend::QtWebKitWebBackend(QObject *parent) : WebBackend(parent),
+	m_backgroundTimer(0),
+	m_isInBackground(false),
 	m_isInitialized(false)
 {
 	m_instance = this;
 	m_enableMediaOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableMedia"), SettingsManager::BooleanType, true);
 	m_enableMediaSourceOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableMediaSource"), SettingsManager::BooleanType, false);
+	m_enableMemoryBudgetOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableMemoryBudget"), SettingsManager::BooleanType, true);
+	m_enableSharedNetworkTransportOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableSharedNetworkTransport"), SettingsManager::BooleanType, true);
 	m_enableSiteSpecificQuirksOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableSiteSpecificQuirks"), SettingsManager::BooleanType, true);
 	m_enableWebSecurityOption = SettingsManager::registerOption(QLatin1String("QtWebKitBackend/EnableWebSecurity"), SettingsManager::BooleanType, true);
 
@@ -75,8 +90,52 @@ QtWebKitWebBackend::QtWebKitWebBackend(QObject *parent) : WebBackend(parent),
 	page->deleteLater();
 }
 
+void QtWebKitWebBackend::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_backgroundTimer)
+	{
+		killTimer(m_backgroundTimer);
+
+		m_backgroundTimer = 0;
+		m_isInBackground = true;
+
+		updateCacheCapacities();
+	}
+}
+
+void QtWebKitWebBackend::handleApplicationStateChanged(Qt::ApplicationState state)
+{
+	if (state == Qt::ApplicationActive)
+	{
+		if (m_backgroundTimer != 0)
+		{
+			killTimer(m_backgroundTimer);
+
+			m_backgroundTimer = 0;
+		}
+
+		if (m_isInBackground)
+		{
+			m_isInBackground = false;
+
+			updateCacheCapacities();
+		}
+	}
+	else if (!m_isInBackground && m_backgroundTimer == 0)
+	{
+		m_backgroundTimer = startTimer(BackgroundCacheDelay);
+	}
+}
+
 void QtWebKitWebBackend::handleOptionChanged(int identifier)
 {
+	if (identifier == m_enableMemoryBudgetOption)
+	{
+		updateCacheCapacities();
+
+		return;
+	}
+
 	switch (identifier)
 	{
 		case SettingsManager::Browser_OfflineStorageLimitOption:
@@ -92,7 +151,7 @@ void QtWebKitWebBackend::handleOptionChanged(int identifier)
 
 			return;
 		case SettingsManager::Cache_PagesInMemoryLimitOption:
-			QWebSettings::setMaximumPagesInCache(SettingsManager::getOption(SettingsManager::Cache_PagesInMemoryLimitOption).toInt());
+			updateCacheCapacities();
 
 			return;
 		case SettingsManager::Interface_EnableSmoothScrollingOption:
@@ -159,7 +218,6 @@ WebWidget* QtWebKitWebBackend::createWidget(const QVariantMap &parameters, Conte
 		pluginSearchPaths.append(QDir::toNativeSeparators(Application::getApplicationDirectoryPath()));
 
 		QWebSettings::setPluginSearchPaths(pluginSearchPaths);
-		QWebSettings::setMaximumPagesInCache(SettingsManager::getOption(SettingsManager::Cache_PagesInMemoryLimitOption).toInt());
 		QWebSettings::globalSettings()->setAttribute(QWebSettings::DnsPrefetchEnabled, SettingsManager::getOption(SettingsManager::Network_EnableDnsPrefetchOption).toBool());
 		QWebSettings::globalSettings()->setAttribute(QWebSettings::FullScreenSupportEnabled, true);
 		QWebSettings::globalSettings()->setAttribute(QWebSettings::XSSAuditingEnabled, true);
@@ -168,10 +226,12 @@ WebWidget* QtWebKitWebBackend::createWidget(const QVariantMap &parameters, Conte
 		QWebSettings::setOfflineStorageDefaultQuota(SettingsManager::getOption(SettingsManager::Browser_OfflineStorageLimitOption).toInt() * 1024);
 		QWebSettings::setOfflineWebApplicationCacheQuota(SettingsManager::getOption(SettingsManager::Browser_OfflineWebApplicationCacheLimitOption).toInt() * 1024);
 
+		updateCacheCapacities();
 		handleOptionChanged(SettingsManager::Content_DefaultFontSizeOption);
 		handleOptionChanged(SettingsManager::Permissions_EnableFullScreenOption);
 
 		connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &QtWebKitWebBackend::handleOptionChanged);
+		connect(Application::getInstance(), &Application::applicationStateChanged, this, &QtWebKitWebBackend::handleApplicationStateChanged);
 	}
 
 	QtWebKitWebWidget *widget(new QtWebKitWebWidget(parameters, this, nullptr, parent));
@@ -191,6 +251,61 @@ WebPageThumbnailJob* QtWebKitWebBackend::createPageThumbnailJob(const QUrl &url,
 	return new QtWebKitWebPageThumbnailJob(url, size, this);
 }
 
+void QtWebKitWebBackend::updateCacheCapacities()
+{
+	const int pagesLimit(SettingsManager::getOption(SettingsManager::Cache_PagesInMemoryLimitOption).toInt());
+
+	if (!SettingsManager::getOption(m_enableMemoryBudgetOption).toBool())
+	{
+		QWebSettings::setObjectCacheCapacities(0, DefaultObjectCacheCapacity, DefaultObjectCacheCapacity);
+		QWebSettings::setMaximumPagesInCache(pagesLimit);
+
+		return;
+	}
+
+	const quint64 memory(getPhysicalMemory() / 1048576);
+	int totalCapacity(32);
+	int pagesBudget(pagesLimit);
+
+	if (memory >= 4096)
+	{
+		totalCapacity = 128;
+	}
+	else if (memory >= 2048)
+	{
+		totalCapacity = 96;
+		pagesBudget = 3;
+	}
+	else if (memory >= 1024)
+	{
+		totalCapacity = 64;
+		pagesBudget = 2;
+	}
+	else if (memory >= 512)
+	{
+		totalCapacity = 32;
+		pagesBudget = 1;
+	}
+	else if (memory > 0)
+	{
+		totalCapacity = 16;
+		pagesBudget = 0;
+	}
+
+	totalCapacity *= 1048576;
+
+	if (m_isInBackground)
+	{
+		QWebSettings::setObjectCacheCapacities(0, 0, (totalCapacity / 2));
+		QWebSettings::setMaximumPagesInCache(0);
+	}
+	else
+	{
+		QWebSettings::setObjectCacheCapacities((totalCapacity / 8), (totalCapacity / 4), totalCapacity);
+		QWebSettings::setMaximumPagesInCache(qMin(pagesLimit, pagesBudget));
+	}
+}
+
 QtWebKitWebBackend* QtWebKitWebBackend::getInstance()
 {
 	return m_instance;
@@ -290,6 +405,38 @@ WebBackend::CapabilityScopes QtWebKitWebBackend::getCapabilityScopes(WebBackend:
 	return NoScope;
 }
 
+quint64 QtWebKitWebBackend::getPhysicalMemory()
+{
+#ifdef Q_OS_WIN
+	MEMORYSTATUSEX status;
+	status.dwLength = sizeof(status);
+
+	if (GlobalMemoryStatusEx(&status))
+	{
+		return status.ullTotalPhys;
+	}
+#elif defined(Q_OS_DARWIN)
+	int names[2] = {CTL_HW, HW_MEMSIZE};
+	quint64 memory(0);
+	size_t length(sizeof(memory));
+
+	if (sysctl(names, 2, &memory, &length, nullptr, 0) == 0)
+	{
+		return memory;
+	}
+#elif defined(Q_OS_UNIX)
+	const long pagesAmount(sysconf(_SC_PHYS_PAGES));
+	const long pageSize(sysconf(_SC_PAGESIZE));
+
+	if (pagesAmount > 0 && pageSize > 0)
+	{
+		return (static_cast<quint64>(pagesAmount) * static_cast<quint64>(pageSize));
+	}
+#endif
+
+	return 0;
+}
+
 int QtWebKitWebBackend::getOptionIdentifier(QtWebKitWebBackend::OptionIdentifier identifier)
 {
 	switch (identifier)
@@ -298,6 +445,10 @@ int QtWebKitWebBackend::getOptionIdentifier(QtWebKitWebBackend::OptionIdentifier
 			return m_enableMediaOption;
 		case QtWebKitBackend_EnableMediaSourceOption:
 			return m_enableMediaSourceOption;
+		case QtWebKitBackend_EnableMemoryBudgetOption:
+			return m_enableMemoryBudgetOption;
+		case QtWebKitBackend_EnableSharedNetworkTransportOption:
+			return m_enableSharedNetworkTransportOption;
 		case QtWebKitBackend_EnableSiteSpecificQuirksOption:
 			return m_enableSiteSpecificQuirksOption;
 		case QtWebKitBackend_EnableWebSecurityOption:
@@ -320,7 +471,7 @@ QtWebKitBookmarksImportJob::QtWebKitBookmarksImportJob(BookmarksModel::Bookmark
 {
 }
 
-void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
+void QtWebKitBookmarksImportJob::processElement(const QWebElement &element, int parent)
 {
 	QWebElement entryElement(element.findFirst(QLatin1String("dt, hr")));
 
@@ -328,7 +479,11 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 	{
 		if (entryElement.tagName().toLower() == QLatin1String("hr"))
 		{
-			BookmarksManager::addBookmark(BookmarksModel::SeparatorBookmark, {}, getCurrentFolder());
+			BookmarksModel::BookmarkNode node;
+			node.type = BookmarksModel::SeparatorBookmark;
+			node.parent = parent;
+
+			m_tree.nodes.append(node);
 
 			++m_currentAmount;
 
@@ -355,31 +510,21 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 			if (type != BookmarksModel::UnknownBookmark && !matchedElement.isNull())
 			{
-				QMap<int, QVariant> metaData({{BookmarksModel::TitleRole, matchedElement.toPlainText()}});
+				BookmarksModel::BookmarkNode node;
+				node.title = matchedElement.toPlainText();
+				node.type = type;
+				node.parent = parent;
+
 				const bool isUrlBookmark(type == BookmarksModel::UrlBookmark || type == BookmarksModel::FeedBookmark);
 
 				if (isUrlBookmark)
 				{
-					const QUrl url(matchedElement.attribute(QLatin1String("HREF")));
-
-					if (!areDuplicatesAllowed() && BookmarksManager::hasBookmark(url))
-					{
-						entryElement = entryElement.nextSibling();
-
-						continue;
-					}
-
-					metaData[BookmarksModel::UrlRole] = url;
+					node.url = QUrl(matchedElement.attribute(QLatin1String("HREF"))).toString();
 				}
 
 				if (matchedElement.hasAttribute(QLatin1String("SHORTCUTURL")))
 				{
-					const QString keyword(matchedElement.attribute(QLatin1String("SHORTCUTURL")));
-
-					if (!keyword.isEmpty() && !BookmarksManager::hasKeyword(keyword))
-					{
-						metaData[BookmarksModel::KeywordRole] = keyword;
-					}
+					node.keyword = matchedElement.attribute(QLatin1String("SHORTCUTURL"));
 				}
 
 				if (matchedElement.hasAttribute(QLatin1String("ADD_DATE")))
@@ -388,8 +533,8 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 					if (dateTime.isValid())
 					{
-						metaData[BookmarksModel::TimeAddedRole] = dateTime;
-						metaData[BookmarksModel::TimeModifiedRole] = dateTime;
+						node.timeAdded = dateTime;
+						node.timeModified = dateTime;
 					}
 				}
 
@@ -399,7 +544,7 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 					if (dateTime.isValid())
 					{
-						metaData[BookmarksModel::TimeModifiedRole] = dateTime;
+						node.timeModified = dateTime;
 					}
 				}
 
@@ -409,11 +554,18 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 					if (dateTime.isValid())
 					{
-						metaData[BookmarksModel::TimeVisitedRole] = dateTime;
+						node.timeVisited = dateTime;
 					}
 				}
 
-				BookmarksModel::Bookmark *bookmark(BookmarksManager::addBookmark(type, metaData, getCurrentFolder()));
+				if (entryElement.nextSibling().tagName().toLower() == QLatin1String("dd"))
+				{
+					node.description = entryElement.nextSibling().toPlainText();
+				}
+
+				const int index(m_tree.nodes.count());
+
+				m_tree.nodes.append(node);
 
 				++m_currentAmount;
 
@@ -421,14 +573,11 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 				if (type == BookmarksModel::FolderBookmark)
 				{
-					setCurrentFolder(bookmark);
-					processElement(entryElement);
+					processElement(entryElement, index);
 				}
 
 				if (entryElement.nextSibling().tagName().toLower() == QLatin1String("dd"))
 				{
-					bookmark->setItemData(entryElement.nextSibling().toPlainText(), BookmarksModel::DescriptionRole);
-
 					entryElement = entryElement.nextSibling();
 				}
 			}
@@ -436,8 +585,6 @@ void QtWebKitBookmarksImportJob::processElement(const QWebElement &element)
 
 		entryElement = entryElement.nextSibling();
 	}
-
-	goToParent();
 }
 
 void QtWebKitBookmarksImportJob::start()
@@ -464,13 +611,15 @@ void QtWebKitBookmarksImportJob::start()
 
 	emit importStarted(DataExchanger::BookmarksExchange, m_totalAmount);
 
-	BookmarksManager::getModel()->beginImport(getImportFolder(), page.mainFrame()->findAllElements(QLatin1String("a[href]")).count(), page.mainFrame()->findAllElements(QLatin1String("a[shortcuturl]")).count());
+	m_tree.nodes.reserve(m_totalAmount);
+
+	processElement(page.mainFrame()->documentElement().findFirst(QLatin1String("dl")), -1);
 
-	processElement(page.mainFrame()->documentElement().findFirst(QLatin1String("dl")));
+	const int amount(BookmarksManager::getModel()->importBookmarks(m_tree, getImportFolder(), areDuplicatesAllowed()));
 
-	BookmarksManager::getModel()->endImport();
+	m_tree = {};
 
-	emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::SuccessfullOperation, m_totalAmount);
+	emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::SuccessfullOperation, amount);
 	emit jobFinished(true);
 
 	file.close();
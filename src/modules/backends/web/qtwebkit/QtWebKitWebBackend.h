@@ -39,6 +39,8 @@ public:
 	{
 		QtWebKitBackend_EnableMediaOption = 0,
 		QtWebKitBackend_EnableMediaSourceOption,
+		QtWebKitBackend_EnableMemoryBudgetOption,
+		QtWebKitBackend_EnableSharedNetworkTransportOption,
 		QtWebKitBackend_EnableSiteSpecificQuirksOption,
 		QtWebKitBackend_EnableWebSecurityOption
 	};
@@ -61,14 +63,26 @@ public:
 	bool hasSslSupport() const override;
 
 protected:
+	enum CacheBudgetParameter
+	{
+		BackgroundCacheDelay = 60000,
+		DefaultObjectCacheCapacity = 8388608
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void updateCacheCapacities();
 	static QtWebKitWebBackend* getInstance();
 	static QString getActiveDictionary();
+	static quint64 getPhysicalMemory();
 
 protected slots:
+	void handleApplicationStateChanged(Qt::ApplicationState state);
 	void handleOptionChanged(int identifier);
 	void setActiveWidget(WebWidget *widget);
 
 private:
+	int m_backgroundTimer;
+	bool m_isInBackground;
 	bool m_isInitialized;
 
 	static QtWebKitWebBackend* m_instance;
@@ -77,6 +91,8 @@ private:
 	static QMap<QString, QString> m_userAgents;
 	static int m_enableMediaOption;
 	static int m_enableMediaSourceOption;
+	static int m_enableMemoryBudgetOption;
+	static int m_enableSharedNetworkTransportOption;
 	static int m_enableSiteSpecificQuirksOption;
 	static int m_enableWebSecurityOption;
 
@@ -99,9 +115,10 @@ public slots:
 	void cancel() override;
 
 protected:
-	void processElement(const QWebElement &element);
+	void processElement(const QWebElement &element, int parent);
 
 private:
+	BookmarksModel::BookmarksTree m_tree;
 	QString m_path;
 	int m_currentAmount;
 	int m_totalAmount;
@@ -21,7 +21,9 @@
 #include "QtWebKitWebWidget.h"
 #include "QtWebKitNetworkManager.h"
 #include "QtWebKitPage.h"
+#include "QtWebKitPluginFactory.h"
 #include "QtWebKitPluginWidget.h"
+#include "QtWebKitRequestScheduler.h"
 #include "QtWebKitWebBackend.h"
 #include "../../../../core/Application.h"
 #include "../../../../core/BookmarksManager.h"
@@ -35,6 +37,7 @@
 #include "../../../../core/NetworkManager.h"
 #include "../../../../core/NetworkManagerFactory.h"
 #include "../../../../core/NotesManager.h"
+#include "../../../../core/ScriptTemplate.h"
 #include "../../../../core/SearchEnginesManager.h"
 #include "../../../../core/SessionsManager.h"
 #include "../../../../core/SettingsManager.h"
@@ -103,11 +106,19 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	m_networkManager(networkManager),
 	m_formRequestOperation(QNetworkAccessManager::GetOperation),
 	m_loadingState(FinishedLoadingState),
+	m_findInPageCaseSensitivity(Qt::CaseInsensitive),
 	m_amountOfDeferredPlugins(0),
+	m_findInPagePosition(0),
+	m_findInPageTimer(0),
+	m_linkHoverTimer(0),
 	m_transfersTimer(0),
 	m_canLoadPlugins(false),
+	m_hasFindInPageMatches(false),
+	m_isFindInPageCounted(true),
+	m_isRefiningFindInPage(false),
 	m_isAudioMuted(false),
 	m_isFullScreen(false),
+	m_isHistorySnapshotValid(false),
 	m_isTypedIn(false),
 	m_isNavigating(false)
 {
@@ -156,6 +167,7 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	connect(m_page, &QtWebKitPage::downloadRequested, this, &QtWebKitWebWidget::handleDownloadRequested);
 	connect(m_page, &QtWebKitPage::unsupportedContent, this, &QtWebKitWebWidget::handleUnsupportedContent);
 	connect(m_page, &QtWebKitPage::linkHovered, this, &QtWebKitWebWidget::setStatusMessageOverride);
+	connect(m_page, &QtWebKitPage::linkHovered, this, &QtWebKitWebWidget::handleLinkHovered);
 	connect(m_page, &QtWebKitPage::microFocusChanged, [&]()
 	{
 		emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::EditingCategory});
@@ -178,12 +190,9 @@ QtWebKitWebWidget::QtWebKitWebWidget(const QVariantMap &parameters, WebBackend *
 	connect(m_page->undoStack(), &QUndoStack::redoTextChanged, this, &QtWebKitWebWidget::notifyRedoActionStateChanged);
 	connect(m_page->undoStack(), &QUndoStack::canUndoChanged, this, &QtWebKitWebWidget::notifyUndoActionStateChanged);
 	connect(m_page->undoStack(), &QUndoStack::undoTextChanged, this, &QtWebKitWebWidget::notifyUndoActionStateChanged);
-	connect(m_networkManager, &QtWebKitNetworkManager::pageInformationChanged, this, &QtWebKitWebWidget::pageInformationChanged);
+	connect(m_networkManager, &QtWebKitNetworkManager::pageInformationChanged, this, &QtWebKitWebWidget::notifyPageInformationChanged);
 	connect(m_networkManager, &QtWebKitNetworkManager::requestBlocked, this, &QtWebKitWebWidget::requestBlocked);
-	connect(m_networkManager, &QtWebKitNetworkManager::contentStateChanged, this, [&]()
-	{
-		emit contentStateChanged(getContentState());
-	});
+	connect(m_networkManager, &QtWebKitNetworkManager::contentStateChanged, this, &QtWebKitWebWidget::notifyContentStateChanged);
 	connect(new QShortcut(QKeySequence(QKeySequence::SelectAll), this, nullptr, nullptr, Qt::WidgetWithChildrenShortcut), &QShortcut::activated, [&]()
 	{
 		triggerAction(ActionsManager::SelectAllAction);
@@ -222,6 +231,21 @@ void QtWebKitWebWidget::timerEvent(QTimerEvent *event)
 			m_transfersTimer = startTimer(250);
 		}
 	}
+	else if (event->timerId() == m_findInPageTimer)
+	{
+		countFindInPageMatches();
+	}
+	else if (event->timerId() == m_linkHoverTimer)
+	{
+		killTimer(m_linkHoverTimer);
+
+		m_linkHoverTimer = 0;
+
+		if (m_hoveredLink.isValid())
+		{
+			preconnect(m_hoveredLink);
+		}
+	}
 	else
 	{
 		WebWidget::timerEvent(event);
@@ -233,6 +257,8 @@ void QtWebKitWebWidget::showEvent(QShowEvent *event)
 	WebWidget::showEvent(event);
 
 	m_page->setVisibilityState(QWebPage::VisibilityStateVisible);
+
+	QtWebKitRequestScheduler::releaseRequests(m_networkManager);
 }
 
 void QtWebKitWebWidget::hideEvent(QHideEvent *event)
@@ -323,6 +349,8 @@ void QtWebKitWebWidget::triggerAction(int identifier, const QVariantMap &paramet
 
 			m_page->history()->clear();
 
+			m_isHistorySnapshotValid = false;
+
 			emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::NavigationCategory});
 
 			break;
@@ -1011,6 +1039,13 @@ void QtWebKitWebWidget::triggerAction(int identifier, const QVariantMap &paramet
 			{
 				m_canLoadPlugins = true;
 
+				QtWebKitPluginFactory *pluginFactory(qobject_cast<QtWebKitPluginFactory*>(m_page->pluginFactory()));
+
+				if (pluginFactory)
+				{
+					pluginFactory->setBudgetEnabled(false);
+				}
+
 				QList<QWebFrame*> frames({m_page->mainFrame()});
 
 				while (!frames.isEmpty())
@@ -1120,6 +1155,25 @@ void QtWebKitWebWidget::triggerAction(int identifier, const QVariantMap &paramet
 
 void QtWebKitWebWidget::findInPage(const QString &text, FindFlags flags)
 {
+	const Qt::CaseSensitivity caseSensitivity(flags.testFlag(CaseSensitiveFind) ? Qt::CaseSensitive : Qt::CaseInsensitive);
+	const bool isRefinement(!m_findInPageText.isEmpty() && caseSensitivity == m_findInPageCaseSensitivity && text.startsWith(m_findInPageText, caseSensitivity));
+
+	if (m_findInPageTimer != 0)
+	{
+		killTimer(m_findInPageTimer);
+
+		m_findInPageTimer = 0;
+	}
+
+	if (isRefinement && !m_hasFindInPageMatches)
+	{
+		m_findInPageText = text;
+
+		emit findInPageResultsChanged(text, 0, 0);
+
+		return;
+	}
+
 	QWebPage::FindFlags nativeFlags(QWebPage::FindWrapsAroundDocument | QWebPage::FindBeginsInSelection);
 
 	if (flags.testFlag(BackwardFind))
@@ -1138,9 +1192,39 @@ void QtWebKitWebWidget::findInPage(const QString &text, FindFlags flags)
 		m_page->findText(text, (nativeFlags | QWebPage::HighlightAllOccurrences));
 	}
 
-	const bool hasMatches(m_page->findText(text, nativeFlags));
+	m_hasFindInPageMatches = m_page->findText(text, nativeFlags);
+	m_isRefiningFindInPage = (isRefinement && m_isFindInPageCounted);
+	m_findInPageText = text;
+	m_findInPageCaseSensitivity = caseSensitivity;
+	m_findInPagePosition = 0;
+
+	if (!m_hasFindInPageMatches)
+	{
+		m_findInPageCandidates.clear();
+		m_findInPageMatches.clear();
+		m_isFindInPageCounted = true;
+
+		emit findInPageResultsChanged(text, 0, 0);
+
+		return;
+	}
+
+	if (m_isRefiningFindInPage)
+	{
+		m_findInPageCandidates = m_findInPageMatches;
+	}
+	else
+	{
+		m_findInPageCandidates.clear();
+		m_findInPageDocument = m_page->mainFrame()->toPlainText();
+	}
+
+	m_findInPageMatches.clear();
+	m_isFindInPageCounted = false;
 
-	emit findInPageResultsChanged(text, (hasMatches ? -1 : 0), (hasMatches ? -1 : 0));
+	emit findInPageResultsChanged(text, -1, -1);
+
+	m_findInPageTimer = startTimer(0);
 }
 
 void QtWebKitWebWidget::search(const QString &query, const QString &searchEngine)
@@ -1156,11 +1240,24 @@ void QtWebKitWebWidget::search(const QString &query, const QString &searchEngine
 	}
 }
 
+void QtWebKitWebWidget::preconnect(const QUrl &url, bool canPrefetch)
+{
+	if (m_networkManager && !isPrivate())
+	{
+		m_networkManager->preconnect(url, canPrefetch);
+	}
+}
+
 void QtWebKitWebWidget::print(QPrinter *printer)
 {
 	m_page->mainFrame()->print(printer);
 }
 
+void QtWebKitWebWidget::requestDocumentText(const std::function<void(const QString &text)> &callback)
+{
+	callback(m_page->mainFrame()->toPlainText());
+}
+
 void QtWebKitWebWidget::saveState(QWebFrame *frame, QWebHistoryItem *item)
 {
 	if (frame == m_page->mainFrame())
@@ -1220,6 +1317,62 @@ void QtWebKitWebWidget::clearPluginToken()
 	m_pluginToken.clear();
 }
 
+void QtWebKitWebWidget::countFindInPageMatches()
+{
+	const int limit(m_findInPagePosition + FindInPageBatchSize);
+	bool isFinished(false);
+
+	if (m_isRefiningFindInPage)
+	{
+		while (m_findInPagePosition < m_findInPageCandidates.count() && m_findInPagePosition < limit)
+		{
+			const int position(m_findInPageCandidates.at(m_findInPagePosition));
+
+			if (m_findInPageDocument.midRef(position, m_findInPageText.length()).compare(m_findInPageText, m_findInPageCaseSensitivity) == 0)
+			{
+				m_findInPageMatches.append(position);
+			}
+
+			++m_findInPagePosition;
+		}
+
+		isFinished = (m_findInPagePosition >= m_findInPageCandidates.count());
+	}
+	else
+	{
+		int position(m_findInPageDocument.indexOf(m_findInPageText, m_findInPagePosition, m_findInPageCaseSensitivity));
+
+		while (position >= 0 && position < limit)
+		{
+			m_findInPageMatches.append(position);
+
+			position = m_findInPageDocument.indexOf(m_findInPageText, (position + 1), m_findInPageCaseSensitivity);
+		}
+
+		isFinished = (position < 0);
+
+		if (!isFinished)
+		{
+			m_findInPagePosition = position;
+		}
+	}
+
+	if (isFinished)
+	{
+		killTimer(m_findInPageTimer);
+
+		m_findInPageTimer = 0;
+		m_findInPageCandidates.clear();
+		m_isFindInPageCounted = true;
+
+		emit findInPageResultsChanged(m_findInPageText, (m_findInPageMatches.isEmpty() ? -1 : m_findInPageMatches.count()), 0);
+	}
+	else if (!m_findInPageMatches.isEmpty())
+	{
+		emit findInPageResultsChanged(m_findInPageText, m_findInPageMatches.count(), -1);
+	}
+}
+
 void QtWebKitWebWidget::resetSpellCheck(QWebElement element)
 {
 	if (element.isNull())
@@ -1415,8 +1568,40 @@ void QtWebKitWebWidget::handleOptionChanged(int identifier, const QVariant &valu
 	}
 }
 
+void QtWebKitWebWidget::handleLinkHovered(const QString &link)
+{
+	if (m_linkHoverTimer != 0)
+	{
+		killTimer(m_linkHoverTimer);
+
+		m_linkHoverTimer = 0;
+	}
+
+	m_hoveredLink = (link.isEmpty() ? QUrl() : QUrl(link));
+
+	if (m_hoveredLink.isValid() && !isPrivate() && (m_hoveredLink.scheme() == QLatin1String("http") || m_hoveredLink.scheme() == QLatin1String("https")) && m_hoveredLink.adjusted(QUrl::RemoveFragment) != getUrl().adjusted(QUrl::RemoveFragment))
+	{
+		m_linkHoverTimer = startTimer(LinkHoverDelay);
+	}
+}
+
 void QtWebKitWebWidget::handleLoadStarted()
 {
+	m_isHistorySnapshotValid = false;
+
+	if (m_findInPageTimer != 0)
+	{
+		killTimer(m_findInPageTimer);
+
+		m_findInPageTimer = 0;
+	}
+
+	m_findInPageText.clear();
+	m_findInPageDocument.clear();
+	m_findInPageCandidates.clear();
+	m_findInPageMatches.clear();
+	m_isFindInPageCounted = true;
+
 	if (m_loadingState == OngoingLoadingState)
 	{
 		return;
@@ -1427,6 +1612,13 @@ void QtWebKitWebWidget::handleLoadStarted()
 	m_canLoadPlugins = (getOption(SettingsManager::Permissions_EnablePluginsOption, getUrl()).toString() == QLatin1String("enabled"));
 	m_loadingState = OngoingLoadingState;
 
+	QtWebKitPluginFactory *pluginFactory(qobject_cast<QtWebKitPluginFactory*>(m_page->pluginFactory()));
+
+	if (pluginFactory)
+	{
+		pluginFactory->resetBudget();
+	}
+
 	setStatusMessage({});
 	setStatusMessageOverride({});
 
@@ -1442,6 +1634,8 @@ void QtWebKitWebWidget::handleLoadProgress(int progress)
 
 void QtWebKitWebWidget::handleLoadFinished(bool result)
 {
+	m_isHistorySnapshotValid = false;
+
 	if (m_isAudioMuted)
 	{
 		muteAudio(m_page->mainFrame(), true);
@@ -1506,6 +1700,8 @@ void QtWebKitWebWidget::handlePrintRequest(QWebFrame *frame)
 
 void QtWebKitWebWidget::handleHistory()
 {
+	m_isHistorySnapshotValid = false;
+
 	if (isPrivate() || m_page->history()->count() == 0)
 	{
 		return;
@@ -1532,7 +1728,7 @@ void QtWebKitWebWidget::handleHistory()
 			m_isTypedIn = false;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 		BookmarksManager::updateVisits(url.toString());
 	}
 }
@@ -1612,6 +1808,7 @@ void QtWebKitWebWidget::notifyTitleChanged()
 
 void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 {
+	m_isHistorySnapshotValid = false;
 	m_isNavigating = false;
 
 	updateOptions(url);
@@ -1620,11 +1817,13 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 	emit arbitraryActionsStateChanged({ActionsManager::InspectPageAction, ActionsManager::InspectElementAction});
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::NavigationCategory, ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void QtWebKitWebWidget::notifyIconChanged()
 {
+	m_isHistorySnapshotValid = false;
+
 	emit iconChanged(getIcon());
 }
 
@@ -1682,7 +1881,7 @@ void QtWebKitWebWidget::notifySavePasswordRequested(const PasswordsManager::Pass
 
 void QtWebKitWebWidget::updateAmountOfDeferredPlugins()
 {
-	const int amountOfDeferredPlugins(m_canLoadPlugins ? 0 : findChildren<QtWebKitPluginWidget*>().count());
+	const int amountOfDeferredPlugins(findChildren<QtWebKitPluginWidget*>().count());
 
 	if (amountOfDeferredPlugins != m_amountOfDeferredPlugins)
 	{
@@ -1753,9 +1952,9 @@ void QtWebKitWebWidget::clearOptions()
 
 void QtWebKitWebWidget::fillPassword(const PasswordsManager::PasswordInformation &password)
 {
-	QFile file(QLatin1String(":/modules/backends/web/qtwebkit/resources/formFiller.js"));
+	const ScriptTemplate scriptTemplate(ScriptTemplate::getTemplate(QLatin1String(":/modules/backends/web/qtwebkit/resources/formFiller.js")));
 
-	if (!file.open(QIODevice::ReadOnly))
+	if (!scriptTemplate.isValid())
 	{
 		return;
 	}
@@ -1767,9 +1966,7 @@ void QtWebKitWebWidget::fillPassword(const PasswordsManager::PasswordInformation
 		fieldsArray.append(QJsonObject({{QLatin1String("name"), password.fields.at(i).name}, {QLatin1String("value"), password.fields.at(i).value}, {QLatin1String("type"), ((password.fields.at(i).type == PasswordsManager::PasswordField) ? QLatin1String("password") : QLatin1String("text"))}}));
 	}
 
-	const QString script(QString::fromLatin1(file.readAll()).arg(QString::fromLatin1(QJsonDocument(fieldsArray).toJson(QJsonDocument::Indented))));
-
-	file.close();
+	const QString script(scriptTemplate.createSource({QString::fromLatin1(QJsonDocument(fieldsArray).toJson(QJsonDocument::Indented))}));
 
 	QList<QWebFrame*> frames({m_page->mainFrame()});
 
@@ -1794,6 +1991,8 @@ void QtWebKitWebWidget::setActiveStyleSheet(const QString &styleSheet)
 
 void QtWebKitWebWidget::setHistory(const Session::Window::History &history)
 {
+	m_isHistorySnapshotValid = false;
+
 	if (history.entries.isEmpty())
 	{
 		m_page->history()->clear();
@@ -1846,6 +2045,8 @@ void QtWebKitWebWidget::setHistory(const Session::Window::History &history)
 
 void QtWebKitWebWidget::setHistory(const QVariantMap &history)
 {
+	m_isHistorySnapshotValid = false;
+
 	m_page->history()->loadFromMap(history);
 
 	const QUrl url(m_page->history()->currentItem().url());
@@ -1864,7 +2065,7 @@ void QtWebKitWebWidget::setZoom(int zoom)
 	{
 		m_page->mainFrame()->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
@@ -1976,6 +2177,11 @@ void QtWebKitWebWidget::setOptions(const QHash<int, QVariant> &options, const QS
 	updateOptions(getUrl());
 }
 
+void QtWebKitWebWidget::setThrottled(bool isThrottled)
+{
+	m_page->setThrottled(isThrottled);
+}
+
 void QtWebKitWebWidget::setScrollPosition(const QPoint &position)
 {
 	m_page->mainFrame()->setScrollPosition(position);
@@ -2285,6 +2491,21 @@ Session::Window::History QtWebKitWebWidget::getHistory() const
 
 	m_page->history()->currentItem().setUserData(state);
 
+	if (m_isHistorySnapshotValid && m_loadingState != OngoingLoadingState)
+	{
+		const QPoint position(state.value(PositionEntryData, QPoint(0, 0)).toPoint());
+		const int zoom(state.value(ZoomEntryData).toInt());
+		const int index(m_historySnapshot.index);
+
+		if (index >= 0 && index < m_historySnapshot.entries.count() && (m_historySnapshot.entries.at(index).position != position || m_historySnapshot.entries.at(index).zoom != zoom))
+		{
+			m_historySnapshot.entries[index].position = position;
+			m_historySnapshot.entries[index].zoom = zoom;
+		}
+
+		return m_historySnapshot;
+	}
+
 	const QWebHistory *pageHistory(m_page->history());
 	const QUrl requestedUrl(m_page->mainFrame()->requestedUrl());
 	const int historyCount(pageHistory->count());
@@ -2307,11 +2528,11 @@ Session::Window::History QtWebKitWebWidget::getHistory() const
 
 		if (identifier > 0)
 		{
-			const HistoryModel::Entry *globalEntry(HistoryManager::getEntry(identifier));
+			const HistoryModel::Entry globalEntry(HistoryManager::getEntry(identifier));
 
-			if (globalEntry)
+			if (globalEntry.isValid())
 			{
-				entry.icon = globalEntry->icon();
+				entry.icon = globalEntry.getIcon();
 			}
 		}
 
@@ -2329,6 +2550,11 @@ Session::Window::History QtWebKitWebWidget::getHistory() const
 		history.entries.append(entry);
 		history.index = historyCount;
 	}
+	else if (m_loadingState != OngoingLoadingState)
+	{
+		m_historySnapshot = history;
+		m_isHistorySnapshotValid = true;
+	}
 
 	return history;
 }
@@ -2536,6 +2762,16 @@ QVector<NetworkManager::ResourceInformation> QtWebKitWebWidget::getBlockedReques
 	return m_networkManager->getBlockedRequests();
 }
 
+QVector<NetworkManager::RequestTiming> QtWebKitWebWidget::getRequestTimings() const
+{
+	return m_networkManager->getRequestTimings();
+}
+
+QHash<int, int> QtWebKitWebWidget::getBlockedProfilesAmounts() const
+{
+	return m_networkManager->getBlockedProfilesAmounts();
+}
+
 QMap<QByteArray, QByteArray> QtWebKitWebWidget::getHeaders() const
 {
 	return m_networkManager->getHeaders();
@@ -2689,6 +2925,11 @@ bool QtWebKitWebWidget::isNavigating() const
 	return m_isNavigating;
 }
 
+bool QtWebKitWebWidget::isModified() const
+{
+	return m_page->isModified();
+}
+
 bool QtWebKitWebWidget::isPopup() const
 {
 	return m_page->isPopup();
@@ -2710,7 +2951,7 @@ bool QtWebKitWebWidget::eventFilter(QObject *object, QEvent *event)
 	{
 		const QMouseEvent *mouseEvent(static_cast<QMouseEvent*>(event));
 
-		if (event->type() == QEvent::MouseButtonPress && mouseEvent && mouseEvent->button() == Qt::LeftButton && SettingsManager::getOption(SettingsManager::Permissions_EnablePluginsOption, Utils::extractHost(getUrl())).toString() == QLatin1String("onDemand"))
+		if (event->type() == QEvent::MouseButtonPress && mouseEvent && mouseEvent->button() == Qt::LeftButton && SettingsManager::getOption(SettingsManager::Permissions_EnablePluginsOption, Utils::extractHost(getUrl())).toString() != QLatin1String("disabled"))
 		{
 			const QWidget *widget(childAt(mouseEvent->pos()));
 
@@ -2737,7 +2978,7 @@ bool QtWebKitWebWidget::eventFilter(QObject *object, QEvent *event)
 		{
 			case QEvent::ChildAdded:
 			case QEvent::ChildRemoved:
-				if (!m_canLoadPlugins && m_loadingState == FinishedLoadingState)
+				if (m_loadingState == FinishedLoadingState)
 				{
 					updateAmountOfDeferredPlugins();
 				}
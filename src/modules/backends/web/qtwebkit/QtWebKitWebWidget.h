@@ -56,7 +56,9 @@ public:
 	~QtWebKitWebWidget();
 
 	void search(const QString &query, const QString &searchEngine) override;
+	void preconnect(const QUrl &url, bool canPrefetch = false) override;
 	void print(QPrinter *printer) override;
+	void requestDocumentText(const std::function<void(const QString &text)> &callback) override;
 	WebWidget* clone(bool cloneHistory = true, bool isPrivate = false, const QStringList &excludedOptions = {}) const override;
 	QWidget* getInspector() override;
 	QWidget* getViewport() override;
@@ -83,6 +85,8 @@ public:
 	QVector<LinkUrl> getLinks() const override;
 	QVector<LinkUrl> getSearchEngines() const override;
 	QVector<NetworkManager::ResourceInformation> getBlockedRequests() const override;
+	QVector<NetworkManager::RequestTiming> getRequestTimings() const override;
+	QHash<int, int> getBlockedProfilesAmounts() const override;
 	QMap<QByteArray, QByteArray> getHeaders() const override;
 	QMultiMap<QString, QString> getMetaData() const override;
 	ContentStates getContentState() const override;
@@ -93,6 +97,7 @@ public:
 	bool isAudible() const override;
 	bool isAudioMuted() const override;
 	bool isFullScreen() const override;
+	bool isModified() const override;
 	bool isPrivate() const override;
 	bool eventFilter(QObject *object, QEvent *event) override;
 
@@ -110,6 +115,16 @@ public slots:
 	void setUrl(const QUrl &url, bool isTypedIn = true) override;
 
 protected:
+	enum FindInPageParameter
+	{
+		FindInPageBatchSize = 50000
+	};
+
+	enum HoverIntentParameter
+	{
+		LinkHoverDelay = 150
+	};
+
 	enum HistoryEntryData
 	{
 		IdentifierEntryData = 0,
@@ -125,6 +140,7 @@ protected:
 	void hideEvent(QHideEvent *event) override;
 	void focusInEvent(QFocusEvent *event) override;
 	void clearPluginToken();
+	void countFindInPageMatches();
 	void resetSpellCheck(QWebElement element);
 	void muteAudio(QWebFrame *frame, bool isMuted);
 	void openRequest(const QNetworkRequest &request, QNetworkAccessManager::Operation operation, QIODevice *outgoingData);
@@ -134,6 +150,7 @@ protected:
 	void handleNavigationRequest(const QUrl &url, QWebPage::NavigationType type);
 	void setHistory(const QVariantMap &history);
 	void setOptions(const QHash<int, QVariant> &options, const QStringList &excludedOptions = {}) override;
+	void setThrottled(bool isThrottled) override;
 	QtWebKitPage* getPage() const;
 	QString getMessageToken() const;
 	QString getPluginToken() const;
@@ -161,6 +178,7 @@ protected slots:
 	void handleDownloadRequested(const QNetworkRequest &request);
 	void handleUnsupportedContent(QNetworkReply *reply);
 	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleLinkHovered(const QString &link);
 	void handleLoadStarted();
 	void handleLoadProgress(int progress);
 	void handleLoadFinished(bool result);
@@ -182,20 +200,34 @@ private:
 	QtWebKitPage *m_page;
 	QtWebKitInspectorWidget *m_inspectorWidget;
 	QtWebKitNetworkManager *m_networkManager;
+	QUrl m_hoveredLink;
+	QString m_findInPageText;
+	QString m_findInPageDocument;
 	QString m_messageToken;
 	QString m_pluginToken;
 	QPixmap m_thumbnail;
 	QNetworkRequest m_formRequest;
 	QByteArray m_formRequestBody;
 	QQueue<Transfer*> m_transfers;
+	QVector<int> m_findInPageCandidates;
+	QVector<int> m_findInPageMatches;
 	QHash<QNetworkReply*, QPointer<SourceViewerWebWidget> > m_viewSourceReplies;
+	mutable Session::Window::History m_historySnapshot;
 	QNetworkAccessManager::Operation m_formRequestOperation;
 	LoadingState m_loadingState;
+	Qt::CaseSensitivity m_findInPageCaseSensitivity;
 	int m_amountOfDeferredPlugins;
+	int m_findInPagePosition;
+	int m_findInPageTimer;
+	int m_linkHoverTimer;
 	int m_transfersTimer;
 	bool m_canLoadPlugins;
+	bool m_hasFindInPageMatches;
+	bool m_isFindInPageCounted;
+	bool m_isRefiningFindInPage;
 	bool m_isAudioMuted;
 	bool m_isFullScreen;
+	mutable bool m_isHistorySnapshotValid;
 	bool m_isTypedIn;
 	bool m_isNavigating;
 
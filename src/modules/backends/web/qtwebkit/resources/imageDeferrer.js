@@ -0,0 +1,106 @@
+(function(window)
+{
+	const placeholder = 'data:image/gif;base64,R0lGODlhAQABAIAAAAAAAP///yH5BAEAAAAALAAAAAABAAEAAAIBRAA7';
+	let deferredImages = [];
+	let releaseTimeout = null;
+
+	function isFarFromViewport(image)
+	{
+		const rectangle = image.getBoundingClientRect();
+		const margin = window.innerHeight;
+
+		return (rectangle.bottom < -margin || rectangle.top > (window.innerHeight + margin) || rectangle.right < -window.innerWidth || rectangle.left > (window.innerWidth * 2));
+	}
+
+	function deferImages(isFinal)
+	{
+		const images = document.querySelectorAll('img[src]:not([data-otter-deferred-src])');
+		let urls = [];
+
+		for (let i = 0; i < images.length; ++i)
+		{
+			const image = images[i];
+
+			if (image.complete || image.src.indexOf('http') !== 0 || !isFarFromViewport(image))
+			{
+				continue;
+			}
+
+			urls.push(image.src);
+
+			image.setAttribute('data-otter-deferred-src', image.getAttribute('src'));
+
+			if (image.hasAttribute('srcset'))
+			{
+				image.setAttribute('data-otter-deferred-srcset', image.getAttribute('srcset'));
+				image.removeAttribute('srcset');
+			}
+
+			image.src = placeholder;
+
+			deferredImages.push(image);
+		}
+
+		let request = new XMLHttpRequest();
+		request.open('GET', '/otter-message', true);
+		request.setRequestHeader('X-Otter-Token', '%1');
+		request.setRequestHeader('X-Otter-Type', 'defer-images');
+		request.setRequestHeader('X-Otter-Data', btoa(JSON.stringify({ urls: urls, isFinal: isFinal })));
+		request.send(null);
+	}
+
+	function releaseImages()
+	{
+		releaseTimeout = null;
+
+		deferredImages = deferredImages.filter(function(image)
+		{
+			if (image.parentNode && isFarFromViewport(image))
+			{
+				return true;
+			}
+
+			if (image.hasAttribute('data-otter-deferred-srcset'))
+			{
+				image.setAttribute('srcset', image.getAttribute('data-otter-deferred-srcset'));
+				image.removeAttribute('data-otter-deferred-srcset');
+			}
+
+			image.setAttribute('src', image.getAttribute('data-otter-deferred-src'));
+			image.removeAttribute('data-otter-deferred-src');
+
+			return false;
+		});
+
+		if (deferredImages.length === 0)
+		{
+			window.removeEventListener('scroll', scheduleRelease, true);
+			window.removeEventListener('resize', scheduleRelease);
+		}
+	}
+
+	function scheduleRelease()
+	{
+		if (releaseTimeout === null)
+		{
+			releaseTimeout = window.setTimeout(releaseImages, 100);
+		}
+	}
+
+	window.addEventListener('scroll', scheduleRelease, true);
+	window.addEventListener('resize', scheduleRelease);
+
+	if (document.readyState === 'loading')
+	{
+		deferImages(false);
+
+		document.addEventListener('DOMContentLoaded', function()
+		{
+			deferImages(true);
+		});
+	}
+	else
+	{
+		deferImages(true);
+	}
+})(window);
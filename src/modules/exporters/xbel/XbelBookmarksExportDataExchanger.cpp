@@ -18,18 +18,75 @@
 **************************************************************************/
 
 #include "XbelBookmarksExportDataExchanger.h"
-#include "../../../core/SessionsManager.h"
+#include "../../../core/BookmarksManager.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
-#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
 
 namespace Otter
 {
 
-XbelBookmarksExportDataExchanger::XbelBookmarksExportDataExchanger(QObject *parent) : ExportDataExchanger(parent)
+XbelBookmarksExportDataExchanger::XbelBookmarksExportDataExchanger(QObject *parent) : ExportDataExchanger(parent),
+	m_exportWatcher(nullptr),
+	m_totalAmount(0),
+	m_progressTimer(0)
 {
 }
 
+XbelBookmarksExportDataExchanger::~XbelBookmarksExportDataExchanger()
+{
+	if (m_exportWatcher)
+	{
+		m_isCancelled->store(true);
+
+		m_exportWatcher->waitForFinished();
+	}
+}
+
+void XbelBookmarksExportDataExchanger::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_progressTimer)
+	{
+		if (m_writtenAmount)
+		{
+			emit exportProgress(BookmarksExchange, m_totalAmount, m_writtenAmount->load());
+		}
+	}
+	else
+	{
+		ExportDataExchanger::timerEvent(event);
+	}
+}
+
+void XbelBookmarksExportDataExchanger::cancel()
+{
+	if (m_isCancelled)
+	{
+		m_isCancelled->store(true);
+	}
+}
+
+void XbelBookmarksExportDataExchanger::finishExport()
+{
+	const OperationResult result(m_exportWatcher->result());
+
+	if (m_progressTimer != 0)
+	{
+		killTimer(m_progressTimer);
+
+		m_progressTimer = 0;
+	}
+
+	m_exportWatcher->deleteLater();
+	m_exportWatcher = nullptr;
+	m_isCancelled.reset();
+	m_writtenAmount.reset();
+
+	emit exportFinished(BookmarksExchange, result, m_totalAmount);
+}
+
 QString XbelBookmarksExportDataExchanger::getName() const
 {
 	return QLatin1String("xbel");
@@ -80,9 +137,68 @@ DataExchanger::ExchangeType XbelBookmarksExportDataExchanger::getExchangeType()
 	return BookmarksExchange;
 }
 
+bool XbelBookmarksExportDataExchanger::canCancel() const
+{
+	return true;
+}
+
+DataExchanger::OperationResult XbelBookmarksExportDataExchanger::writeData(const QString &path, const QByteArray &data, std::shared_ptr<std::atomic<bool> > isCancelled, std::shared_ptr<std::atomic<int> > writtenAmount)
+{
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return FailedOperation;
+	}
+
+	int position(0);
+
+	while (position < data.size())
+	{
+		if (isCancelled->load())
+		{
+			file.cancelWriting();
+
+			return CancelledOperation;
+		}
+
+		const int size(qMin(static_cast<int>(ExportChunkSize), (data.size() - position)));
+
+		if (file.write(data.constData() + position, size) != size)
+		{
+			return FailedOperation;
+		}
+
+		position += size;
+
+		writtenAmount->store(position);
+	}
+
+	return (file.commit() ? SuccessfullOperation : FailedOperation);
+}
+
 bool XbelBookmarksExportDataExchanger::exportData(const QString &path)
 {
-	return QFile::copy(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")), path);
+	if (m_exportWatcher)
+	{
+		return false;
+	}
+
+	const QByteArray data(BookmarksManager::getModel()->getXbel());
+
+	m_isCancelled = std::make_shared<std::atomic<bool> >(false);
+	m_writtenAmount = std::make_shared<std::atomic<int> >(0);
+	m_totalAmount = data.size();
+	m_exportWatcher = new QFutureWatcher<OperationResult>(this);
+	m_progressTimer = startTimer(ProgressInterval);
+
+	emit exportStarted(BookmarksExchange, m_totalAmount);
+
+	connect(m_exportWatcher, &QFutureWatcher<OperationResult>::finished, this, &XbelBookmarksExportDataExchanger::finishExport);
+
+	m_exportWatcher->setFuture(QtConcurrent::run(&XbelBookmarksExportDataExchanger::writeData, getSuggestedPath(path), data, m_isCancelled, m_writtenAmount));
+
+	return true;
 }
 
 }
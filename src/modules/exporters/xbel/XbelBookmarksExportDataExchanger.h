@@ -22,6 +22,11 @@
 
 #include "../../../core/DataExchanger.h"
 
+#include <QtCore/QFutureWatcher>
+
+#include <atomic>
+#include <memory>
+
 namespace Otter
 {
 
@@ -30,7 +35,14 @@ class XbelBookmarksExportDataExchanger final : public ExportDataExchanger
 	Q_OBJECT
 
 public:
+	enum ExportParameter
+	{
+		ExportChunkSize = 65536,
+		ProgressInterval = 100
+	};
+
 	explicit XbelBookmarksExportDataExchanger(QObject *parent = nullptr);
+	~XbelBookmarksExportDataExchanger();
 
 	QString getName() const override;
 	QString getTitle() const override;
@@ -41,9 +53,23 @@ public:
 	QUrl getHomePage() const override;
 	QStringList getFileFilters() const override;
 	ExchangeType getExchangeType() const override;
+	bool canCancel() const override;
 
 public slots:
+	void cancel() override;
 	bool exportData(const QString &path) override;
+
+protected:
+	void timerEvent(QTimerEvent *event) override;
+	void finishExport();
+	static OperationResult writeData(const QString &path, const QByteArray &data, std::shared_ptr<std::atomic<bool> > isCancelled, std::shared_ptr<std::atomic<int> > writtenAmount);
+
+private:
+	QFutureWatcher<OperationResult> *m_exportWatcher;
+	std::shared_ptr<std::atomic<bool> > m_isCancelled;
+	std::shared_ptr<std::atomic<int> > m_writtenAmount;
+	int m_totalAmount;
+	int m_progressTimer;
 };
 
 }
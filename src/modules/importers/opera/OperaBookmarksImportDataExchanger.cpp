@@ -22,9 +22,11 @@
 #include "../../../core/BookmarksManager.h"
 #include "../../../ui/BookmarksImportOptionsWidget.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
 
@@ -156,19 +158,52 @@ OperaBookmarksImportJob::OperaBookmarksImportJob(BookmarksModel::Bookmark *folde
 
 void OperaBookmarksImportJob::start()
 {
-	QFile file(m_path);
+	m_isRunning = true;
 
-	if (!file.open(QIODevice::ReadOnly))
+	emit importStarted(DataExchanger::BookmarksExchange, -1);
+
+	QFutureWatcher<BookmarksModel::BookmarksTree> *watcher(new QFutureWatcher<BookmarksModel::BookmarksTree>(this));
+
+	connect(watcher, &QFutureWatcher<BookmarksModel::BookmarksTree>::finished, this, [=]()
 	{
-		emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::FailedOperation, 0);
-		emit jobFinished(false);
+		const BookmarksModel::BookmarksTree tree(watcher->result());
+
+		m_isRunning = false;
+
+		if (!tree.openErrorString.isEmpty() || !tree.readErrorString.isEmpty())
+		{
+			emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::FailedOperation, 0);
+			emit jobFinished(false);
+
+			deleteLater();
+
+			return;
+		}
+
+		const int amount(BookmarksManager::getModel()->importBookmarks(tree, getImportFolder(), areDuplicatesAllowed()));
+
+		emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::SuccessfullOperation, amount);
+		emit jobFinished(true);
 
 		deleteLater();
+	});
 
-		return;
-	}
+	watcher->setFuture(QtConcurrent::run(&OperaBookmarksImportJob::readBookmarks, m_path));
+}
 
-	m_isRunning = true;
+BookmarksModel::BookmarksTree OperaBookmarksImportJob::readBookmarks(const QString &path)
+{
+	BookmarksModel::BookmarksTree tree;
+	tree.path = path;
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		tree.openErrorString = file.errorString();
+
+		return tree;
+	}
 
 	QTextStream stream(&file);
 	stream.setCodec("UTF-8");
@@ -177,23 +212,19 @@ void OperaBookmarksImportJob::start()
 
 	if (line != QLatin1String("Opera Hotlist version 2.0"))
 	{
-		emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::FailedOperation, 0);
-		emit jobFinished(false);
+		tree.readErrorString = QLatin1String("Invalid header");
 
-		deleteLater();
-
-		return;
+		return tree;
 	}
 
-	emit importStarted(DataExchanger::BookmarksExchange, -1);
-
-	const int estimatedAmount((file.size() > 0) ? static_cast<int>(file.size() / 250) : 0);
-	int totalAmount(0);
-
-	BookmarksManager::getModel()->beginImport(getImportFolder(), estimatedAmount, qMin(estimatedAmount, 100));
+	if (file.size() > 0)
+	{
+		tree.nodes.reserve(static_cast<int>(file.size() / 250));
+	}
 
-	BookmarksModel::Bookmark *bookmark(nullptr);
+	QVector<int> folders;
 	OperaBookmarkEntry type(NoEntry);
+	int bookmark(-1);
 	bool isHeader(true);
 
 	while (!stream.atEnd())
@@ -209,101 +240,85 @@ void OperaBookmarksImportJob::start()
 
 		if (line.isEmpty())
 		{
-			if (bookmark)
+			if (bookmark >= 0)
 			{
 				if (type == FolderStartEntry)
 				{
-					setCurrentFolder(bookmark);
+					folders.append(bookmark);
 				}
 
-				bookmark = nullptr;
+				bookmark = -1;
 			}
-			else if (type == FolderEndEntry)
+			else if (type == FolderEndEntry && !folders.isEmpty())
 			{
-				goToParent();
+				folders.removeLast();
 			}
 
 			type = NoEntry;
 		}
-		else if (line.startsWith(QLatin1String("#URL")))
+		else if (line.startsWith(QLatin1String("#URL")) || line.startsWith(QLatin1String("#FOLDER")) || line.startsWith(QLatin1String("#SEPERATOR")))
 		{
-			bookmark = BookmarksManager::addBookmark(BookmarksModel::UrlBookmark, {}, getCurrentFolder());
-			type = UrlEntry;
+			BookmarksModel::BookmarkNode node;
+			node.parent = (folders.isEmpty() ? -1 : folders.last());
 
-			++totalAmount;
-		}
-		else if (line.startsWith(QLatin1String("#FOLDER")))
-		{
-			bookmark = BookmarksManager::addBookmark(BookmarksModel::FolderBookmark, {}, getCurrentFolder());
-			type = FolderStartEntry;
+			if (line.startsWith(QLatin1String("#URL")))
+			{
+				node.type = BookmarksModel::UrlBookmark;
+				type = UrlEntry;
+			}
+			else if (line.startsWith(QLatin1String("#FOLDER")))
+			{
+				node.type = BookmarksModel::FolderBookmark;
+				type = FolderStartEntry;
+			}
+			else
+			{
+				node.type = BookmarksModel::SeparatorBookmark;
+				type = SeparatorEntry;
+			}
 
-			++totalAmount;
-		}
-		else if (line.startsWith(QLatin1String("#SEPERATOR")))
-		{
-			bookmark = BookmarksManager::addBookmark(BookmarksModel::SeparatorBookmark, {}, getCurrentFolder());
-			type = SeparatorEntry;
+			bookmark = tree.nodes.count();
 
-			++totalAmount;
+			tree.nodes.append(node);
 		}
 		else if (line == QLatin1String("-"))
 		{
 			type = FolderEndEntry;
 		}
-		else if (bookmark)
+		else if (bookmark >= 0)
 		{
+			BookmarksModel::BookmarkNode &node(tree.nodes[bookmark]);
+
 			if (line.startsWith(QLatin1String("\tURL=")))
 			{
-				const QUrl url(line.section(QLatin1Char('='), 1, -1));
-
-				if (!areDuplicatesAllowed() && BookmarksManager::hasBookmark(url))
-				{
-					bookmark->remove();
-					bookmark = nullptr;
-				}
-				else
-				{
-					bookmark->setData(url, BookmarksModel::UrlRole);
-				}
+				node.url = QUrl(line.section(QLatin1Char('='), 1, -1)).toString();
 			}
 			else if (line.startsWith(QLatin1String("\tNAME=")))
 			{
-				bookmark->setData(line.section(QLatin1Char('='), 1, -1), BookmarksModel::TitleRole);
+				node.title = line.section(QLatin1Char('='), 1, -1);
 			}
 			else if (line.startsWith(QLatin1String("\tDESCRIPTION=")))
 			{
-				bookmark->setData(line.section(QLatin1Char('='), 1, -1).replace(QLatin1String("\x02\x02"), QLatin1String("\n")), BookmarksModel::DescriptionRole);
+				node.description = line.section(QLatin1Char('='), 1, -1).replace(QLatin1String("\x02\x02"), QLatin1String("\n"));
 			}
 			else if (line.startsWith(QLatin1String("\tSHORT NAME=")))
 			{
-				const QString keyword(line.section(QLatin1Char('='), 1, -1));
-
-				if (!BookmarksManager::hasKeyword(keyword))
-				{
-					bookmark->setData(keyword, BookmarksModel::KeywordRole);
-				}
+				node.keyword = line.section(QLatin1Char('='), 1, -1);
 			}
 			else if (line.startsWith(QLatin1String("\tCREATED=")))
 			{
-				bookmark->setData(QDateTime::fromTime_t(line.section(QLatin1Char('='), 1, -1).toUInt()), BookmarksModel::TimeAddedRole);
+				node.timeAdded = QDateTime::fromTime_t(line.section(QLatin1Char('='), 1, -1).toUInt());
 			}
 			else if (line.startsWith(QLatin1String("\tVISITED=")))
 			{
-				bookmark->setData(QDateTime::fromTime_t(line.section(QLatin1Char('='), 1, -1).toUInt()), BookmarksModel::TimeVisitedRole);
+				node.timeVisited = QDateTime::fromTime_t(line.section(QLatin1Char('='), 1, -1).toUInt());
 			}
 		}
 	}
 
-	BookmarksManager::getModel()->endImport();
-
-	emit importFinished(DataExchanger::BookmarksExchange, DataExchanger::SuccessfullOperation, totalAmount);
-	emit jobFinished(true);
-
 	file.close();
 
-	m_isRunning = false;
-
-	deleteLater();
+	return tree;
 }
 
 void OperaBookmarksImportJob::cancel()
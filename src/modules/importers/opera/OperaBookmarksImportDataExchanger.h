@@ -76,6 +76,8 @@ protected:
 		SeparatorEntry
 	};
 
+	static BookmarksModel::BookmarksTree readBookmarks(const QString &path);
+
 private:
 	QString m_path;
 	bool m_isRunning;
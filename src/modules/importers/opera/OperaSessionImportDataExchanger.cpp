@@ -108,15 +108,17 @@ bool OperaSessionImportDataExchanger::importData(const QString &path)
 		return false;
 	}
 
-	emit importStarted(SessionsExchange, 1);
-
 	SessionInformation session;
 	session.title = QFileInfo(path).completeBaseName();
 
 	const int windowCount(originalSession.getValue(QLatin1String("window count")).toInt());
 
+	emit importStarted(SessionsExchange, windowCount);
+
 	for (int i = 1; i <= windowCount; ++i)
 	{
+		emit importProgress(SessionsExchange, windowCount, (i - 1));
+
 		originalSession.beginGroup(QString::number(i));
 
 		if (originalSession.getValue(QLatin1String("type")).toInt() == 0)
@@ -248,6 +250,8 @@ bool OperaSessionImportDataExchanger::importData(const QString &path)
 		session.windows.append(**iterator);
 	}
 
+	emit importProgress(SessionsExchange, windowCount, windowCount);
+
 	const bool result(SessionsManager::saveSession(session));
 
 	qDeleteAll(mainWindows);
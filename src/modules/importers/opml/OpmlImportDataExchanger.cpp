@@ -23,50 +23,136 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QTimer>
 
 namespace Otter
 {
 
 OpmlImportDataExchanger::OpmlImportDataExchanger(QObject *parent) : ImportDataExchanger(parent),
-	m_optionsWidget(nullptr)
+	m_optionsWidget(nullptr),
+	m_sourceModel(nullptr),
+	m_importFolder(nullptr),
+	m_totalAmount(0),
+	m_processedAmount(0),
+	m_importedAmount(0),
+	m_areDuplicatesAllowed(true),
+	m_isCancelled(false)
 {
 }
 
-void OpmlImportDataExchanger::importFolder(FeedsModel::Entry *source, FeedsModel::Entry *target, bool areDuplicatesAllowed)
+void OpmlImportDataExchanger::cancel()
 {
-	for (int i = 0; i < source->rowCount(); ++i)
+	m_isCancelled = true;
+}
+
+void OpmlImportDataExchanger::importEntries()
+{
+	if (m_isCancelled)
 	{
-		FeedsModel::Entry *sourceEntry(source->getChild(i));
+		finishImport(CancelledOperation);
 
-		if (!sourceEntry)
+		return;
+	}
+
+	FeedsModel *model(FeedsManager::getModel());
+	int amount(0);
+
+	model->beginImport(m_importFolder, ImportBatchSize);
+
+	while (!m_folders.isEmpty() && amount < ImportBatchSize)
+	{
+		const ImportFolder folder(m_folders.first());
+
+		if (!folder.source || folder.index >= folder.source->rowCount())
 		{
+			m_folders.removeFirst();
+
 			continue;
 		}
 
-		const FeedsModel::EntryType type(static_cast<FeedsModel::EntryType>(sourceEntry->data(FeedsModel::TypeRole).toInt()));
+		++m_folders[0].index;
+		++amount;
+		++m_processedAmount;
 
-		if (type != FeedsModel::FeedEntry && type != FeedsModel::FolderEntry)
+		FeedsModel::Entry *sourceEntry(folder.source->getChild(folder.index));
+
+		if (!sourceEntry)
 		{
 			continue;
 		}
 
-		switch (type)
+		switch (static_cast<FeedsModel::EntryType>(sourceEntry->data(FeedsModel::TypeRole).toInt()))
 		{
 			case FeedsModel::FeedEntry:
-				if (sourceEntry->getFeed() && (areDuplicatesAllowed || !FeedsManager::getModel()->hasFeed(sourceEntry->getFeed()->getUrl())))
+				if (sourceEntry->getFeed() && (m_areDuplicatesAllowed || !model->hasFeed(sourceEntry->getFeed()->getUrl())))
 				{
-					FeedsManager::getModel()->addEntry(sourceEntry->getFeed(), target);
+					model->addEntry(sourceEntry->getFeed(), folder.target);
+
+					++m_importedAmount;
 				}
 
 				break;
 			case FeedsModel::FolderEntry:
-				importFolder(sourceEntry, FeedsManager::getModel()->addEntry(FeedsModel::FolderEntry, {{FeedsModel::TitleRole, sourceEntry->data(FeedsModel::TitleRole)}}, target), areDuplicatesAllowed);
+				{
+					ImportFolder childFolder;
+					childFolder.source = sourceEntry;
+					childFolder.target = model->addEntry(FeedsModel::FolderEntry, {{FeedsModel::TitleRole, sourceEntry->data(FeedsModel::TitleRole)}}, folder.target);
+
+					m_folders.append(childFolder);
+
+					++m_importedAmount;
+				}
 
 				break;
 			default:
 				break;
 		}
 	}
+
+	model->endImport();
+
+	emit importProgress(FeedsExchange, m_totalAmount, m_processedAmount);
+
+	if (m_folders.isEmpty())
+	{
+		finishImport(SuccessfullOperation);
+	}
+	else
+	{
+		QTimer::singleShot(0, this, &OpmlImportDataExchanger::importEntries);
+	}
+}
+
+void OpmlImportDataExchanger::finishImport(OperationResult result)
+{
+	m_folders.clear();
+
+	if (m_sourceModel)
+	{
+		m_sourceModel->deleteLater();
+		m_sourceModel = nullptr;
+	}
+
+	emit importFinished(FeedsExchange, result, m_importedAmount);
+}
+
+int OpmlImportDataExchanger::countEntries(FeedsModel::Entry *folder)
+{
+	int amount(0);
+
+	for (int i = 0; i < folder->rowCount(); ++i)
+	{
+		FeedsModel::Entry *entry(folder->getChild(i));
+
+		++amount;
+
+		if (entry && static_cast<FeedsModel::EntryType>(entry->data(FeedsModel::TypeRole).toInt()) == FeedsModel::FolderEntry)
+		{
+			amount += countEntries(entry);
+		}
+	}
+
+	return amount;
 }
 
 QWidget* OpmlImportDataExchanger::createOptionsWidget(QWidget *parent)
@@ -129,6 +215,11 @@ DataExchanger::ExchangeType OpmlImportDataExchanger::getExchangeType() const
 	return FeedsExchange;
 }
 
+bool OpmlImportDataExchanger::canCancel() const
+{
+	return true;
+}
+
 bool OpmlImportDataExchanger::hasOptions() const
 {
 	return true;
@@ -136,37 +227,30 @@ bool OpmlImportDataExchanger::hasOptions() const
 
 bool OpmlImportDataExchanger::importData(const QString &path)
 {
-	QFile file(getSuggestedPath(path));
-
-	if (!file.open(QIODevice::ReadOnly))
+	if (!QFile::exists(getSuggestedPath(path)))
 	{
 		emit importFinished(FeedsExchange, FailedOperation, 0);
 
 		return false;
 	}
 
-	emit importStarted(FeedsExchange, -1);
+	m_sourceModel = new FeedsModel(getSuggestedPath(path), this);
+	m_importFolder = (m_optionsWidget ? m_optionsWidget->getTargetFolder() : nullptr);
+	m_areDuplicatesAllowed = (m_optionsWidget ? m_optionsWidget->areDuplicatesAllowed() : true);
+	m_totalAmount = countEntries(m_sourceModel->getRootEntry());
+	m_processedAmount = 0;
+	m_importedAmount = 0;
+	m_isCancelled = false;
 
-	FeedsModel *model(new FeedsModel(path, this));
-	const int estimatedAmount((file.size() > 0) ? static_cast<int>(file.size() / 250) : 0);
-	int totalAmount(0);
-
-	if (model->getRootEntry()->rowCount() > 0)
-	{
-		FeedsModel::Entry *importFolderEntry(m_optionsWidget->getTargetFolder());
-
-		FeedsManager::getModel()->beginImport(importFolderEntry, estimatedAmount);
-
-		importFolder(model->getRootEntry(), importFolderEntry, (m_optionsWidget ? m_optionsWidget->areDuplicatesAllowed() : true));
-
-		FeedsManager::getModel()->endImport();
-	}
+	ImportFolder folder;
+	folder.source = m_sourceModel->getRootEntry();
+	folder.target = m_importFolder;
 
-	model->deleteLater();
+	m_folders = {folder};
 
-	emit importFinished(FeedsExchange, SuccessfullOperation, totalAmount);
+	emit importStarted(FeedsExchange, m_totalAmount);
 
-	file.close();
+	QTimer::singleShot(0, this, &OpmlImportDataExchanger::importEntries);
 
 	return true;
 }
@@ -45,16 +45,42 @@ public:
 	QUrl getHomePage() const override;
 	QStringList getFileFilters() const override;
 	ExchangeType getExchangeType() const override;
+	bool canCancel() const override;
 	bool hasOptions() const override;
 
 public slots:
+	void cancel() override;
 	bool importData(const QString &path) override;
 
 protected:
-	void importFolder(FeedsModel::Entry *source, FeedsModel::Entry *target, bool areDuplicatesAllowed);
+	enum ImportParameter
+	{
+		ImportBatchSize = 250
+	};
+
+	struct ImportFolder final
+	{
+		FeedsModel::Entry *source = nullptr;
+		FeedsModel::Entry *target = nullptr;
+		int index = 0;
+	};
+
+	void finishImport(OperationResult result);
+	static int countEntries(FeedsModel::Entry *folder);
+
+protected slots:
+	void importEntries();
 
 private:
 	OpmlImportOptionsWidget *m_optionsWidget;
+	FeedsModel *m_sourceModel;
+	FeedsModel::Entry *m_importFolder;
+	QVector<ImportFolder> m_folders;
+	int m_totalAmount;
+	int m_processedAmount;
+	int m_importedAmount;
+	bool m_areDuplicatesAllowed;
+	bool m_isCancelled;
 };
 
 }
@@ -29,6 +29,10 @@
 #include "../../../../3rdparty/libmimeapps/Index.h"
 
 #include <QtConcurrent/QtConcurrent>
+#include <QtCore/QFile>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimerEvent>
 #ifdef OTTER_ENABLE_DBUS
 #include <QtDBus/QtDBus>
 #include <QtDBus/QDBusReply>
@@ -40,6 +44,8 @@
 #endif
 #include <QtWidgets/QApplication>
 
+#include <unistd.h>
+
 #define DESKTOP_ENTRY_NAME "otter-browser"
 
 #ifdef OTTER_ENABLE_DBUS
@@ -110,10 +116,13 @@ const QDBusArgument& operator>>(const QDBusArgument &argument, QImage &image)
 namespace Otter
 {
 
-FreeDesktopOrgPlatformIntegration::FreeDesktopOrgPlatformIntegration(QObject *parent) : PlatformIntegration(parent)
+FreeDesktopOrgPlatformIntegration::FreeDesktopOrgPlatformIntegration(QObject *parent) : PlatformIntegration(parent),
 #ifdef OTTER_ENABLE_DBUS
-	, m_notificationsInterface(new QDBusInterface(QLatin1String("org.freedesktop.Notifications"), QLatin1String("/org/freedesktop/Notifications"), QLatin1String("org.freedesktop.Notifications"), QDBusConnection::sessionBus(), this))
+	m_notificationsInterface(new QDBusInterface(QLatin1String("org.freedesktop.Notifications"), QLatin1String("/org/freedesktop/Notifications"), QLatin1String("org.freedesktop.Notifications"), QDBusConnection::sessionBus(), this)),
 #endif
+	m_applicationsWatcher(new QFileSystemWatcher(this)),
+	m_applicationsIndexWatcher(new QFutureWatcher<std::shared_ptr<LibMimeApps::Index> >(this)),
+	m_applicationsIndexTimer(0)
 {
 #if QT_VERSION >= 0x050700
 	QGuiApplication::setDesktopFileName(QLatin1String(DESKTOP_ENTRY_NAME) + QLatin1String(".desktop"));
@@ -126,13 +135,13 @@ FreeDesktopOrgPlatformIntegration::FreeDesktopOrgPlatformIntegration(QObject *pa
 	m_notificationsInterface->connection().connect(m_notificationsInterface->service(), m_notificationsInterface->path(), m_notificationsInterface->interface(), QLatin1String("ActionInvoked"), this, SLOT(handleNotificationClicked(quint32,QString)));
 #endif
 
-	QTimer::singleShot(250, this, [&]()
-	{
-		QtConcurrent::run([&]()
-		{
-			getApplicationsForMimeType(QMimeDatabase().mimeTypeForName(QLatin1String("text/html")));
-		});
-	});
+	m_applicationsIndexTimer = startTimer(250);
+
+	updateWatchedPaths();
+
+	connect(m_applicationsWatcher, &QFileSystemWatcher::directoryChanged, this, &FreeDesktopOrgPlatformIntegration::scheduleApplicationsIndexUpdate);
+	connect(m_applicationsWatcher, &QFileSystemWatcher::fileChanged, this, &FreeDesktopOrgPlatformIntegration::scheduleApplicationsIndexUpdate);
+	connect(m_applicationsIndexWatcher, &QFutureWatcher<std::shared_ptr<LibMimeApps::Index> >::finished, this, &FreeDesktopOrgPlatformIntegration::handleApplicationsIndexCreated);
 
 #ifdef OTTER_ENABLE_DBUS
 	connect(TransfersManager::getInstance(), &TransfersManager::transfersChanged, this, [&]()
@@ -151,6 +160,72 @@ FreeDesktopOrgPlatformIntegration::~FreeDesktopOrgPlatformIntegration()
 }
 #endif
 
+void FreeDesktopOrgPlatformIntegration::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_applicationsIndexTimer)
+	{
+		killTimer(m_applicationsIndexTimer);
+
+		m_applicationsIndexTimer = 0;
+
+		if (m_applicationsIndexWatcher->isRunning())
+		{
+			scheduleApplicationsIndexUpdate();
+
+			return;
+		}
+
+		m_applicationsIndexWatcher->setFuture(QtConcurrent::run(&FreeDesktopOrgPlatformIntegration::createApplicationsIndex));
+
+		updateWatchedPaths();
+	}
+}
+
+void FreeDesktopOrgPlatformIntegration::scheduleApplicationsIndexUpdate()
+{
+	if (m_applicationsIndexTimer != 0)
+	{
+		killTimer(m_applicationsIndexTimer);
+	}
+
+	m_applicationsIndexTimer = startTimer(1000);
+}
+
+void FreeDesktopOrgPlatformIntegration::updateWatchedPaths()
+{
+	const QStringList watchedPaths(m_applicationsWatcher->directories() + m_applicationsWatcher->files());
+	const QStringList directories(QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation));
+	const QStringList configurationDirectories(QStandardPaths::standardLocations(QStandardPaths::GenericConfigLocation));
+	QStringList paths;
+
+	for (int i = 0; i < directories.count(); ++i)
+	{
+		paths.append(directories.at(i));
+		paths.append(QDir(directories.at(i)).filePath(QLatin1String("mimeapps.list")));
+	}
+
+	for (int i = 0; i < configurationDirectories.count(); ++i)
+	{
+		paths.append(QDir(configurationDirectories.at(i)).filePath(QLatin1String("mimeapps.list")));
+	}
+
+	for (int i = 0; i < paths.count(); ++i)
+	{
+		if (!watchedPaths.contains(paths.at(i)) && QFile::exists(paths.at(i)))
+		{
+			m_applicationsWatcher->addPath(paths.at(i));
+		}
+	}
+}
+
+void FreeDesktopOrgPlatformIntegration::handleApplicationsIndexCreated()
+{
+	m_applicationsIndex = m_applicationsIndexWatcher->result();
+
+	m_applicationsCache.clear();
+	m_applicationIcons.clear();
+}
+
 void FreeDesktopOrgPlatformIntegration::runApplication(const QString &command, const QUrl &url) const
 {
 	if (command.isEmpty())
@@ -291,24 +366,75 @@ Style* FreeDesktopOrgPlatformIntegration::createStyle(const QString &name) const
 
 QVector<ApplicationInformation> FreeDesktopOrgPlatformIntegration::getApplicationsForMimeType(const QMimeType &mimeType)
 {
-	if (m_applicationsCache.contains(mimeType.name()))
+	const QString name(mimeType.name());
+
+	if (!m_applicationsCache.contains(name))
+	{
+		if (!m_applicationsIndex)
+		{
+			if (m_applicationsIndexWatcher->isRunning())
+			{
+				m_applicationsIndexWatcher->waitForFinished();
+			}
+
+			m_applicationsIndex = ((m_applicationsIndexWatcher->isFinished() && m_applicationsIndexWatcher->future().resultCount() > 0) ? m_applicationsIndexWatcher->result() : createApplicationsIndex());
+		}
+
+		const std::vector<LibMimeApps::DesktopEntry> entries(m_applicationsIndex->appsForMime(name.toStdString()));
+		QVector<DesktopApplication> applications;
+		applications.reserve(static_cast<int>(entries.size()));
+
+		for (std::vector<LibMimeApps::DesktopEntry>::size_type i = 0; i < entries.size(); ++i)
+		{
+			applications.append({QString::fromStdString(entries.at(i).executable()), QString::fromStdString(entries.at(i).name()), QString::fromStdString(entries.at(i).icon())});
+		}
+
+		m_applicationsCache[name] = applications;
+	}
+
+	const QVector<DesktopApplication> applications(m_applicationsCache.value(name));
+	QVector<ApplicationInformation> information;
+	information.reserve(applications.count());
+
+	for (int i = 0; i < applications.count(); ++i)
+	{
+		const DesktopApplication &application(applications.at(i));
+
+		if (!m_applicationIcons.contains(application.icon))
+		{
+			m_applicationIcons[application.icon] = QIcon::fromTheme(application.icon);
+		}
+
+		information.append({application.command, application.name, m_applicationIcons.value(application.icon)});
+	}
+
+	return information;
+}
+
+std::shared_ptr<LibMimeApps::Index> FreeDesktopOrgPlatformIntegration::createApplicationsIndex()
+{
+	return std::make_shared<LibMimeApps::Index>(QLocale().bcp47Name().toStdString());
+}
+
+quint64 FreeDesktopOrgPlatformIntegration::getResidentMemorySize() const
+{
+	QFile file(QLatin1String("/proc/self/statm"));
+
+	if (!file.open(QIODevice::ReadOnly))
 	{
-		return m_applicationsCache[mimeType.name()];
+		return 0;
 	}
 
-	const LibMimeApps::Index index(QLocale().bcp47Name().toStdString());
-	const std::vector<LibMimeApps::DesktopEntry> entries(index.appsForMime(mimeType.name().toStdString()));
-	QVector<ApplicationInformation> applications;
-	applications.reserve(static_cast<int>(entries.size()));
+	const QList<QByteArray> values(file.readAll().split(' '));
 
-	for (std::vector<LibMimeApps::DesktopEntry>::size_type i = 0; i < entries.size(); ++i)
+	if (values.count() < 2)
 	{
-		applications.append({QString::fromStdString(entries.at(i).executable()), QString::fromStdString(entries.at(i).name()), QIcon::fromTheme(QString::fromStdString(entries.at(i).icon()))});
+		return 0;
 	}
 
-	m_applicationsCache[mimeType.name()] = applications;
+	const long pageSize(sysconf(_SC_PAGESIZE));
 
-	return applications;
+	return ((pageSize > 0) ? (values.at(1).toULongLong() * static_cast<quint64>(pageSize)) : 0);
 }
 
 #ifdef OTTER_ENABLE_DBUS
@@ -24,6 +24,10 @@
 
 #include "../../../core/PlatformIntegration.h"
 
+#include <QtCore/QFutureWatcher>
+
+#include <memory>
+
 #ifdef OTTER_ENABLE_DBUS
 #include <QtDBus/QDBusArgument>
 #include <QtDBus/QDBusInterface>
@@ -33,6 +37,13 @@ QDBusArgument& operator<<(QDBusArgument &argument, const QImage &image);
 const QDBusArgument& operator>>(const QDBusArgument &argument, QImage &image);
 #endif
 
+class QFileSystemWatcher;
+
+namespace LibMimeApps
+{
+	class Index;
+}
+
 namespace Otter
 {
 
@@ -49,16 +60,33 @@ public:
 	void runApplication(const QString &command, const QUrl &url = {}) const override;
 	Style* createStyle(const QString &name) const override;
 	QVector<ApplicationInformation> getApplicationsForMimeType(const QMimeType &mimeType) override;
+	quint64 getResidentMemorySize() const override;
 #ifdef OTTER_ENABLE_DBUS
 	bool canShowNotifications() const override;
 
 public slots:
 	void showNotification(Notification *notification) override;
+#endif
 
 protected:
+	struct DesktopApplication final
+	{
+		QString command;
+		QString name;
+		QString icon;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void scheduleApplicationsIndexUpdate();
+	void updateWatchedPaths();
+	static std::shared_ptr<LibMimeApps::Index> createApplicationsIndex();
+#ifdef OTTER_ENABLE_DBUS
 	void setTransfersProgress(qint64 bytesTotal, qint64 bytesReceived, qint64 transfersAmount);
+#endif
 
 protected slots:
+	void handleApplicationsIndexCreated();
+#ifdef OTTER_ENABLE_DBUS
 	void handleNotificationCallFinished(QDBusPendingCallWatcher *watcher);
 	void handleNotificationIgnored(quint32 identifier, quint32 reason);
 	void handleNotificationClicked(quint32 identifier, const QString &action);
@@ -70,7 +98,12 @@ private:
 	QHash<QDBusPendingCallWatcher*, Notification*> m_notificationWatchers;
 	QHash<quint32, Notification*> m_notifications;
 #endif
-	QHash<QString, QVector<ApplicationInformation> > m_applicationsCache;
+	QFileSystemWatcher *m_applicationsWatcher;
+	QFutureWatcher<std::shared_ptr<LibMimeApps::Index> > *m_applicationsIndexWatcher;
+	std::shared_ptr<LibMimeApps::Index> m_applicationsIndex;
+	QHash<QString, QVector<DesktopApplication> > m_applicationsCache;
+	QHash<QString, QIcon> m_applicationIcons;
+	int m_applicationsIndexTimer;
 };
 
 }
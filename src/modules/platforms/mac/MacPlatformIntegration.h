@@ -52,6 +52,7 @@ public:
 	void startLinkDrag(const QUrl &url, const QString &title, const QPixmap &pixmap, QObject *parent = nullptr) const override;
 	Style* createStyle(const QString &name) const override;
 	QVector<ApplicationInformation> getApplicationsForMimeType(const QMimeType &mimeType) override;
+	quint64 getResidentMemorySize() const override;
 	bool canShowNotifications() const override;
 
 public slots:
@@ -36,6 +36,8 @@
 #include <QtGui/QDesktopServices>
 #include <QtMacExtras/QtMac>
 
+#include <mach/mach.h>
+
 #import <AppKit/AppKit.h>
 #import <Cocoa/Cocoa.h>
 
@@ -404,6 +406,19 @@ QVector<ApplicationInformation> MacPlatformIntegration::getApplicationsForMimeTy
 	return applications;
 }
 
+quint64 MacPlatformIntegration::getResidentMemorySize() const
+{
+	mach_task_basic_info information;
+	mach_msg_type_number_t count(MACH_TASK_BASIC_INFO_COUNT);
+
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&information), &count) == KERN_SUCCESS)
+	{
+		return static_cast<quint64>(information.resident_size);
+	}
+
+	return 0;
+}
+
 bool MacPlatformIntegration::canShowNotifications() const
 {
 	return true;
@@ -31,6 +31,7 @@
 #include "../../../ui/TrayIcon.h"
 
 #include <windows.h>
+#include <psapi.h>
 
 #include <QtCore/QDir>
 #include <QtCore/QMimeData>
@@ -60,7 +61,8 @@ WindowsPlatformIntegration::WindowsPlatformIntegration(QObject *parent) : Platfo
 	m_applicationRegistration(QLatin1String("HKEY_CURRENT_USER\\Software\\RegisteredApplications"), QSettings::NativeFormat),
 	m_propertiesRegistration(QLatin1String("HKEY_CURRENT_USER\\Software\\Classes\\") + QLatin1String(REGISTRATION_IDENTIFIER), QSettings::NativeFormat),
 	m_registrationPairs({{QLatin1String("http"), ProtocolType}, {QLatin1String("https"), ProtocolType}, {QLatin1String("ftp"), ProtocolType}, {QLatin1String(".htm"), ExtensionType}, {QLatin1String(".html"), ExtensionType}, {QLatin1String(".xhtml"), ExtensionType}}),
-	m_cleanupTimer(0)
+	m_cleanupTimer(0),
+	m_taskbarTimer(0)
 {
 #if QT_VERSION >= 0x050900
 	const QOperatingSystemVersion systemVersion(QOperatingSystemVersion::current());
@@ -84,32 +86,9 @@ WindowsPlatformIntegration::WindowsPlatformIntegration(QObject *parent) : Platfo
 		});
 		connect(TransfersManager::getInstance(), &TransfersManager::transfersChanged, this, [&]()
 		{
-			const QVector<MainWindow*> mainWindows(Application::getWindows());
-			const TransfersManager::ActiveTransfersInformation information(TransfersManager::getActiveTransfersInformation());
-			const int progress((information.bytesReceived > 0) ? qFloor(Utils::calculatePercent(information.bytesReceived, information.bytesTotal)) : 0);
-
-			for (int i = 0; i < mainWindows.count(); ++i)
+			if (m_taskbarTimer == 0)
 			{
-				MainWindow *mainWindow(mainWindows.at(i));
-
-				if (information.activeTransfersAmount > 0)
-				{
-					if (!m_taskbarButtons.contains(mainWindow))
-					{
-						m_taskbarButtons[mainWindow] = new QWinTaskbarButton(mainWindow);
-						m_taskbarButtons[mainWindow]->setWindow(mainWindow->windowHandle());
-						m_taskbarButtons[mainWindow]->progress()->show();
-					}
-
-					m_taskbarButtons[mainWindow]->progress()->setValue(progress);
-				}
-				else if (m_taskbarButtons.contains(mainWindow))
-				{
-					m_taskbarButtons[mainWindow]->progress()->reset();
-					m_taskbarButtons[mainWindow]->progress()->hide();
-					m_taskbarButtons[mainWindow]->deleteLater();
-					m_taskbarButtons.remove(mainWindow);
-				}
+				m_taskbarTimer = startTimer(TaskbarUpdateInterval);
 			}
 		});
 	}
@@ -136,6 +115,50 @@ void WindowsPlatformIntegration::timerEvent(QTimerEvent *event)
 		m_cleanupTimer = 0;
 		m_environment.clear();
 	}
+	else if (event->timerId() == m_taskbarTimer)
+	{
+		killTimer(m_taskbarTimer);
+
+		m_taskbarTimer = 0;
+
+		updateTaskbarButtons();
+	}
+}
+
+void WindowsPlatformIntegration::updateTaskbarButtons()
+{
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	const TransfersManager::ActiveTransfersInformation information(TransfersManager::getActiveTransfersInformation());
+	const int progress((information.bytesReceived > 0) ? qFloor(Utils::calculatePercent(information.bytesReceived, information.bytesTotal)) : 0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		MainWindow *mainWindow(mainWindows.at(i));
+
+		if (information.activeTransfersAmount > 0)
+		{
+			if (!m_taskbarButtons.contains(mainWindow))
+			{
+				m_taskbarButtons[mainWindow] = new QWinTaskbarButton(mainWindow);
+				m_taskbarButtons[mainWindow]->setWindow(mainWindow->windowHandle());
+				m_taskbarButtons[mainWindow]->progress()->show();
+			}
+
+			QWinTaskbarProgress *taskbarProgress(m_taskbarButtons[mainWindow]->progress());
+
+			if (taskbarProgress->value() != progress)
+			{
+				taskbarProgress->setValue(progress);
+			}
+		}
+		else if (m_taskbarButtons.contains(mainWindow))
+		{
+			m_taskbarButtons[mainWindow]->progress()->reset();
+			m_taskbarButtons[mainWindow]->progress()->hide();
+			m_taskbarButtons[mainWindow]->deleteLater();
+			m_taskbarButtons.remove(mainWindow);
+		}
+	}
 }
 
 void WindowsPlatformIntegration::showNotification(Notification *notification)
@@ -255,6 +278,18 @@ QString WindowsPlatformIntegration::getPlatformName() const
 	return QLatin1String("win32");
 }
 
+quint64 WindowsPlatformIntegration::getResidentMemorySize() const
+{
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return static_cast<quint64>(counters.WorkingSetSize);
+	}
+
+	return 0;
+}
+
 ApplicationInformation WindowsPlatformIntegration::getApplicationInformation(const QString &command) const
 {
 	const QString rootPath(command.left(command.indexOf(QLatin1String("\\"))).remove(QLatin1Char('%')));
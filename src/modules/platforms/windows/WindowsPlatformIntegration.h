@@ -91,6 +91,7 @@ public:
 	Style* createStyle(const QString &name) const override;
 	QVector<ApplicationInformation> getApplicationsForMimeType(const QMimeType &mimeType) override;
 	QString getPlatformName() const override;
+	quint64 getResidentMemorySize() const override;
 	bool canShowNotifications() const override;
 	bool canSetAsDefaultBrowser() const override;
 	bool isDefaultBrowser() const override;
@@ -106,7 +107,13 @@ protected:
 		ProtocolType
 	};
 
+	enum TaskbarParameter
+	{
+		TaskbarUpdateInterval = 500
+	};
+
 	void timerEvent(QTimerEvent *event) override;
+	void updateTaskbarButtons();
 	ApplicationInformation getApplicationInformation(const QString &command) const;
 	QString getUpdaterBinary() const override;
 	bool registerToSystem();
@@ -119,6 +126,7 @@ private:
 	QVector<QPair<QString, RegistrationType> > m_registrationPairs;
 	QHash<MainWindow*, QWinTaskbarButton*> m_taskbarButtons;
 	int m_cleanupTimer;
+	int m_taskbarTimer;
 
 	static QProcessEnvironment m_environment;
 	static bool m_isVistaOrNewer;
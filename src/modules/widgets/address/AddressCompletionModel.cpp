@@ -27,8 +27,12 @@
 #include "../../../core/ThemesManager.h"
 #include "../../../core/Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeDatabase>
 #include <QtWidgets/QFileIconProvider>
 
@@ -37,11 +41,17 @@ namespace Otter
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
 	m_types(NoCompletionType),
+	m_localPathsPosition(-1),
 	m_updateTimer(0),
 	m_showCompletionCategories(true)
 {
 }
 
+AddressCompletionModel::~AddressCompletionModel()
+{
+	cancelLocalPaths();
+}
+
 void AddressCompletionModel::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_updateTimer)
@@ -61,9 +71,13 @@ void AddressCompletionModel::timerEvent(QTimerEvent *event)
 
 void AddressCompletionModel::updateModel()
 {
+	cancelLocalPaths();
+
 	QVector<CompletionEntry> completions;
 	completions.reserve(10);
 
+	m_localPathsPosition = -1;
+
 	if (m_types.testFlag(SearchSuggestionsCompletionType))
 	{
 		const QString keyword(m_filter.section(QLatin1Char(' '), 0, 0));
@@ -102,19 +116,43 @@ void AddressCompletionModel::updateModel()
 		completions.append(completionEntry);
 	}
 
+	HistoryManager::CompletionSources sources(HistoryManager::NoSource);
+
 	if (m_types.testFlag(BookmarksCompletionType))
 	{
-		const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::findBookmarks(m_filter));
+		sources |= HistoryManager::BookmarksSource;
+	}
+
+	if (m_types.testFlag(HistoryCompletionType))
+	{
+		sources |= HistoryManager::HistorySource;
+	}
 
-		if (m_showCompletionCategories && !bookmarks.isEmpty())
-		{
-			completions.append(CompletionEntry({}, tr("Bookmarks"), {}, {}, {}, CompletionEntry::HeaderType));
-		}
+	const QVector<HistoryManager::CompletionMatch> matches((sources == HistoryManager::NoSource) ? QVector<HistoryManager::CompletionMatch>() : HistoryManager::findCompletions(m_filter, sources, 50, 50));
 
-		for (int i = 0; i < bookmarks.count(); ++i)
+	if (m_types.testFlag(BookmarksCompletionType))
+	{
+		bool headerWasAdded(!m_showCompletionCategories);
+
+		for (int i = 0; i < matches.count(); ++i)
 		{
-			CompletionEntry completionEntry(bookmarks.at(i).bookmark->getUrl(), bookmarks.at(i).bookmark->getTitle(), bookmarks.at(i).match, bookmarks.at(i).bookmark->getIcon(), {}, CompletionEntry::BookmarkType);
-			completionEntry.keyword = bookmarks.at(i).bookmark->getKeyword();
+			BookmarksModel::Bookmark *bookmark(matches.at(i).bookmark);
+
+			if (!bookmark)
+			{
+				continue;
+			}
+
+			if (!headerWasAdded)
+			{
+				completions.append(CompletionEntry({}, tr("Bookmarks"), {}, {}, {}, CompletionEntry::HeaderType));
+
+				headerWasAdded = true;
+			}
+
+			CompletionEntry completionEntry(bookmark->getUrl(), bookmark->getTitle(), matches.at(i).match, bookmark->getIcon(), {}, CompletionEntry::BookmarkType);
+			completionEntry.keyword = bookmark->getKeyword();
+			completionEntry.score = matches.at(i).score;
 
 			if (completionEntry.keyword.startsWith(m_filter))
 			{
@@ -127,43 +165,33 @@ void AddressCompletionModel::updateModel()
 
 	if (m_types.testFlag(LocalPathSuggestionsCompletionType) && (m_filter == QString(QLatin1Char('~')) || m_filter.contains(QDir::separator())))
 	{
-		const QString directory((m_filter == QString(QLatin1Char('~'))) ? QDir::homePath() : m_filter.section(QDir::separator(), 0, -2) + QDir::separator());
-		const QString prefix(m_filter.contains(QDir::separator()) ? m_filter.section(QDir::separator(), -1, -1) : QString());
-		const QList<QFileInfo> entries(QDir(Utils::normalizePath(directory)).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot));
-		const QFileIconProvider iconProvider;
-		const QMimeDatabase mimeDatabase;
+		m_localPathsPosition = completions.count();
+	}
+
+	if (m_types.testFlag(HistoryCompletionType))
+	{
 		bool headerWasAdded(!m_showCompletionCategories);
 
-		for (int i = 0; i < entries.count(); ++i)
+		for (int i = 0; i < matches.count(); ++i)
 		{
-			if (entries.at(i).fileName().startsWith(prefix, Qt::CaseInsensitive))
-			{
-				const QString path(directory + entries.at(i).fileName());
+			const HistoryModel::Entry &entry(matches.at(i).entry);
 
-				if (!headerWasAdded)
-				{
-					completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
+			if (!entry.isValid())
+			{
+				continue;
+			}
 
-					headerWasAdded = true;
-				}
+			if (!headerWasAdded)
+			{
+				completions.append(CompletionEntry({}, tr("History"), {}, {}, {}, CompletionEntry::HeaderType));
 
-				completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(path)), path, path, QIcon::fromTheme(mimeDatabase.mimeTypeForFile(entries.at(i), QMimeDatabase::MatchExtension).iconName(), iconProvider.icon(entries.at(i))), {}, CompletionEntry::LocalPathType));
+				headerWasAdded = true;
 			}
-		}
-	}
-
-	if (m_types.testFlag(HistoryCompletionType))
-	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter));
 
-		if (m_showCompletionCategories && !entries.isEmpty())
-		{
-			completions.append(CompletionEntry({}, tr("History"), {}, {}, {}, CompletionEntry::HeaderType));
-		}
+			CompletionEntry completionEntry(entry.getUrl(), entry.getTitle(), matches.at(i).match, entry.getIcon(), entry.getTimeVisited(), (matches.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType));
+			completionEntry.score = matches.at(i).score;
 
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), (entries.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType)));
+			completions.append(completionEntry);
 		}
 	}
 
@@ -178,7 +206,9 @@ void AddressCompletionModel::updateModel()
 
 		for (int i = 0; i < entries.count(); ++i)
 		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), CompletionEntry::TypedHistoryType, entries.at(i).entry->getIdentifier()));
+			const HistoryModel::Entry &entry(entries.at(i).entry);
+
+			completions.append(CompletionEntry(entry.getUrl(), entry.getTitle(), entries.at(i).match, entry.getIcon(), entry.getTimeVisited(), CompletionEntry::TypedHistoryType, entry.getIdentifier()));
 		}
 	}
 
@@ -212,6 +242,115 @@ void AddressCompletionModel::updateModel()
 	m_completions = completions;
 
 	endResetModel();
+
+	if (m_localPathsPosition >= 0)
+	{
+		updateLocalPaths();
+	}
+}
+
+void AddressCompletionModel::updateLocalPaths()
+{
+	const QString filter(m_filter);
+	const QString directory((filter == QString(QLatin1Char('~'))) ? QDir::homePath() : filter.section(QDir::separator(), 0, -2) + QDir::separator());
+	const QString prefix(filter.contains(QDir::separator()) ? filter.section(QDir::separator(), -1, -1) : QString());
+	std::shared_ptr<std::atomic<bool> > isCancelled(std::make_shared<std::atomic<bool> >(false));
+	QFutureWatcher<QVector<LocalPathMatch> > *watcher(new QFutureWatcher<QVector<LocalPathMatch> >(this));
+
+	m_localPathsCancellation = isCancelled;
+
+	connect(watcher, &QFutureWatcher<QVector<LocalPathMatch> >::finished, this, [=]()
+	{
+		watcher->deleteLater();
+
+		if (isCancelled->load() || filter != m_filter || m_localPathsPosition < 0 || m_localPathsPosition > m_completions.count())
+		{
+			return;
+		}
+
+		m_localPathsCancellation.reset();
+
+		const QVector<LocalPathMatch> matches(watcher->result());
+
+		if (matches.isEmpty())
+		{
+			return;
+		}
+
+		const QFileIconProvider iconProvider;
+		const QIcon directoryIcon(iconProvider.icon(QFileIconProvider::Folder));
+		const QIcon fileIcon(iconProvider.icon(QFileIconProvider::File));
+		QVector<CompletionEntry> completions;
+		completions.reserve(matches.count() + 1);
+
+		if (m_showCompletionCategories)
+		{
+			completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
+		}
+
+		for (int i = 0; i < matches.count(); ++i)
+		{
+			const LocalPathMatch &match(matches.at(i));
+
+			completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(match.path)), match.path, match.path, QIcon::fromTheme(match.iconName, (match.isDirectory ? directoryIcon : fileIcon)), {}, CompletionEntry::LocalPathType));
+		}
+
+		beginInsertRows({}, m_localPathsPosition, (m_localPathsPosition + completions.count() - 1));
+
+		for (int i = 0; i < completions.count(); ++i)
+		{
+			m_completions.insert((m_localPathsPosition + i), completions.at(i));
+		}
+
+		endInsertRows();
+
+		emit completionReady(m_filter);
+	});
+
+	watcher->setFuture(QtConcurrent::run(&AddressCompletionModel::findLocalPaths, directory, prefix, isCancelled));
+}
+
+void AddressCompletionModel::cancelLocalPaths()
+{
+	if (m_localPathsCancellation)
+	{
+		m_localPathsCancellation->store(true);
+		m_localPathsCancellation.reset();
+	}
+}
+
+QVector<AddressCompletionModel::LocalPathMatch> AddressCompletionModel::findLocalPaths(const QString &directory, const QString &prefix, std::shared_ptr<std::atomic<bool> > isCancelled)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	const QMimeDatabase mimeDatabase;
+	QVector<LocalPathMatch> matches;
+	QDirIterator iterator(Utils::normalizePath(directory), (QDir::AllEntries | QDir::NoDotAndDotDot));
+
+	while (iterator.hasNext() && !isCancelled->load() && matches.count() < LocalPathsLimit && timer.elapsed() < LocalPathsTimeBudget)
+	{
+		iterator.next();
+
+		const QFileInfo fileInformation(iterator.fileInfo());
+
+		if (fileInformation.fileName().startsWith(prefix, Qt::CaseInsensitive))
+		{
+			LocalPathMatch match;
+			match.path = directory + fileInformation.fileName();
+			match.iconName = mimeDatabase.mimeTypeForFile(fileInformation, QMimeDatabase::MatchExtension).iconName();
+			match.isDirectory = fileInformation.isDir();
+
+			matches.append(match);
+		}
+	}
+
+	std::sort(matches.begin(), matches.end(), [&](const LocalPathMatch &first, const LocalPathMatch &second)
+	{
+		return (QString::compare(first.path, second.path, Qt::CaseInsensitive) < 0);
+	});
+
+	return matches;
 }
 
 void AddressCompletionModel::setFilter(const QString &filter)
@@ -221,6 +360,8 @@ void AddressCompletionModel::setFilter(const QString &filter)
 
 	if (m_filter.isEmpty())
 	{
+		cancelLocalPaths();
+
 		if (m_updateTimer != 0)
 		{
 			killTimer(m_updateTimer);
@@ -286,6 +427,8 @@ QVariant AddressCompletionModel::data(const QModelIndex &index, int role) const
 				return (m_completions.at(index.row()).match.isEmpty() ? m_completions.at(index.row()).url.toString() : m_completions.at(index.row()).match);
 			case TimeVisitedRole:
 				return m_completions.at(index.row()).timeVisited;
+			case ScoreRole:
+				return m_completions.at(index.row()).score;
 			case TypeRole:
 				return static_cast<int>(m_completions.at(index.row()).type);
 			default:
@@ -27,6 +27,9 @@
 #include <QtCore/QAbstractListModel>
 #include <QtCore/QUrl>
 
+#include <atomic>
+#include <memory>
+
 namespace Otter
 {
 
@@ -58,7 +61,8 @@ public:
 		MatchRole,
 		KeywordRole,
 		TypeRole,
-		TimeVisitedRole
+		TimeVisitedRole,
+		ScoreRole
 	};
 
 	struct CompletionEntry final
@@ -82,6 +86,7 @@ public:
 		QUrl url;
 		QIcon icon;
 		QDateTime timeVisited;
+		double score = 0;
 		quint64 historyIdentifier = 0;
 		EntryType type = UnknownType;
 
@@ -93,6 +98,7 @@ public:
 	};
 
 	explicit AddressCompletionModel(QObject *parent = nullptr);
+	~AddressCompletionModel();
 
 	void setTypes(CompletionTypes types, bool force = false);
 	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -105,14 +111,32 @@ public slots:
 	void setFilter(const QString &filter = {});
 
 protected:
+	enum LocalPathsParameter
+	{
+		LocalPathsLimit = 100,
+		LocalPathsTimeBudget = 250
+	};
+
+	struct LocalPathMatch final
+	{
+		QString path;
+		QString iconName;
+		bool isDirectory = false;
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void updateModel();
+	void updateLocalPaths();
+	void cancelLocalPaths();
+	static QVector<LocalPathMatch> findLocalPaths(const QString &directory, const QString &prefix, std::shared_ptr<std::atomic<bool> > isCancelled);
 
 private:
 	QVector<CompletionEntry> m_completions;
+	std::shared_ptr<std::atomic<bool> > m_localPathsCancellation;
 	QString m_filter;
 	SearchEnginesManager::SearchEngineDefinition m_defaultSearchEngine;
 	AddressCompletionModel::CompletionTypes m_types;
+	int m_localPathsPosition;
 	int m_updateTimer;
 	bool m_showCompletionCategories;
 
@@ -47,6 +47,7 @@
 namespace Otter
 {
 
+QCache<QString, QVector<AddressDelegate::TextRun> > AddressDelegate::m_layoutsCache(AddressDelegate::LayoutsCacheLimit);
 int AddressWidget::m_entryIdentifierEnumerator(-1);
 
 AddressDelegate::AddressDelegate(const QString &highlight, ViewMode mode, QObject *parent) : QStyledItemDelegate(parent),
@@ -61,6 +62,10 @@ AddressDelegate::AddressDelegate(const QString &highlight, ViewMode mode, QObjec
 			m_displayMode = ((value.toString() == QLatin1String("columns")) ? ColumnsMode : CompactMode);
 		}
 	});
+	connect(ThemesManager::getInstance(), &ThemesManager::widgetStyleChanged, this, [&]()
+	{
+		m_layoutsCache.clear();
+	});
 }
 
 void AddressDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -151,68 +156,69 @@ void AddressDelegate::paint(QPainter *painter, const QStyleOptionViewItem &optio
 		QRect urlRectangle(textRectangle);
 		urlRectangle.setRight(textRectangle.right() - 2 - sectionWidth);
 
-		drawCompletionText(painter, option.font, highlightSegments(highlight, {urlSegment}), urlRectangle, isRightToLeft);
+		drawCompletionText(painter, option.font, highlight, {urlSegment}, urlRectangle, isRightToLeft);
 
 		if (!description.isEmpty())
 		{
 			QRect descriptionRectangle(textRectangle);
 			descriptionRectangle.setLeft(urlRectangle.right() + 4);
 
-			drawCompletionText(painter, option.font, highlightSegments(highlight, {descriptionSegment}), descriptionRectangle, isRightToLeft);
+			drawCompletionText(painter, option.font, highlight, {descriptionSegment}, descriptionRectangle, isRightToLeft);
 		}
 	}
 	else
 	{
 		if (description.isEmpty())
 		{
-			drawCompletionText(painter, option.font, highlightSegments(highlight, {urlSegment}), textRectangle, isRightToLeft);
+			drawCompletionText(painter, option.font, highlight, {urlSegment}, textRectangle, isRightToLeft);
 		}
 		else
 		{
 			descriptionSegment.text = QLatin1Char(' ') + QChar(8212) + QLatin1Char(' ') + descriptionSegment.text;
 
-			drawCompletionText(painter, option.font, highlightSegments(highlight, {urlSegment, descriptionSegment}), textRectangle, isRightToLeft);
+			drawCompletionText(painter, option.font, highlight, {urlSegment, descriptionSegment}, textRectangle, isRightToLeft);
 		}
 	}
 }
 
-void AddressDelegate::drawCompletionText(QPainter *painter, const QFont &font, const QVector<TextSegment> &segments, const QRect &rectangle, bool isRightToLeft) const
+void AddressDelegate::drawCompletionText(QPainter *painter, const QFont &font, const QString &highlight, const QVector<TextSegment> &segments, const QRect &rectangle, bool isRightToLeft) const
 {
-	QRect availableRectangle(rectangle);
-	QFont highlightFont(font);
-	highlightFont.setBold(true);
-
-	const QFontMetrics fontMetrics(font);
-	const QFontMetrics highlightFontMetrics(highlightFont);
-	const int xLength(Utils::calculateTextWidth(QString(QLatin1Char('X')), highlightFontMetrics));
+	QString key(font.key() + QLatin1Char('\n') + QString::number(rectangle.width()) + QLatin1Char('\n') + highlight);
 
 	for (int i = 0; i < segments.count(); ++i)
 	{
-		const TextSegment segment(segments.at(i));
-		const QFontMetrics segmentFontMetrics(segment.isHighlighted ? highlightFontMetrics : fontMetrics);
-		const int maximumLength(availableRectangle.width() - xLength);
-		const int length(Utils::calculateTextWidth(segment.text, segmentFontMetrics));
+		key += QLatin1Char('\n') + QString::number(segments.at(i).color.rgba(), 16) + QLatin1Char(':') + segments.at(i).text;
+	}
 
-		painter->setFont(segment.isHighlighted ? highlightFont : font);
-		painter->setPen(segment.color);
+	QVector<TextRun> *runs(m_layoutsCache.object(key));
 
-		if (length >= maximumLength)
-		{
-			painter->drawText(availableRectangle, Qt::AlignVCenter, Utils::elideText(segment.text, segmentFontMetrics, nullptr, maximumLength));
+	if (!runs)
+	{
+		runs = new QVector<TextRun>(layoutCompletionText(font, highlightSegments(highlight, segments), rectangle.width()));
 
-			break;
-		}
+		m_layoutsCache.insert(key, runs);
+	}
 
-		painter->drawText(availableRectangle, Qt::AlignVCenter, segment.text);
+	QFont highlightFont(font);
+	highlightFont.setBold(true);
+
+	for (int i = 0; i < runs->count(); ++i)
+	{
+		const TextRun &run(runs->at(i));
+		QRect availableRectangle(rectangle);
 
 		if (isRightToLeft)
 		{
-			availableRectangle.setRight(availableRectangle.right() - length);
+			availableRectangle.setRight(rectangle.right() - run.offset);
 		}
 		else
 		{
-			availableRectangle.setLeft(availableRectangle.left() + length);
+			availableRectangle.setLeft(rectangle.left() + run.offset);
 		}
+
+		painter->setFont(run.isHighlighted ? highlightFont : font);
+		painter->setPen(run.color);
+		painter->drawText(availableRectangle, Qt::AlignVCenter, run.text);
 	}
 }
 
@@ -261,6 +267,48 @@ QVector<AddressDelegate::TextSegment> AddressDelegate::highlightSegments(const Q
 	return highlightedSegments;
 }
 
+QVector<AddressDelegate::TextRun> AddressDelegate::layoutCompletionText(const QFont &font, const QVector<TextSegment> &segments, int width) const
+{
+	QFont highlightFont(font);
+	highlightFont.setBold(true);
+
+	const QFontMetrics fontMetrics(font);
+	const QFontMetrics highlightFontMetrics(highlightFont);
+	const int xLength(Utils::calculateTextWidth(QString(QLatin1Char('X')), highlightFontMetrics));
+	QVector<TextRun> runs;
+	runs.reserve(segments.count());
+	int offset(0);
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		const TextSegment &segment(segments.at(i));
+		const QFontMetrics segmentFontMetrics(segment.isHighlighted ? highlightFontMetrics : fontMetrics);
+		const int maximumLength(width - offset - xLength);
+		const int length(Utils::calculateTextWidth(segment.text, segmentFontMetrics));
+		TextRun run;
+		run.color = segment.color;
+		run.offset = offset;
+		run.isHighlighted = segment.isHighlighted;
+
+		if (length >= maximumLength)
+		{
+			run.text = Utils::elideText(segment.text, segmentFontMetrics, nullptr, maximumLength);
+
+			runs.append(run);
+
+			break;
+		}
+
+		run.text = segment.text;
+
+		runs.append(run);
+
+		offset += length;
+	}
+
+	return runs;
+}
+
 QSize AddressDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
 	QSize size(index.data(Qt::SizeHintRole).toSize());
@@ -733,6 +781,23 @@ void AddressWidget::dragEnterEvent(QDragEnterEvent *event)
 	LineEditWidget::dragEnterEvent(event);
 }
 
+void AddressWidget::preconnect(const QModelIndex &index)
+{
+	if (!m_window || m_window->isPrivate() || !m_window->getWebWidget())
+	{
+		return;
+	}
+
+	const AddressCompletionModel::CompletionEntry::EntryType type(static_cast<AddressCompletionModel::CompletionEntry::EntryType>(index.data(AddressCompletionModel::TypeRole).toInt()));
+
+	if (type != AddressCompletionModel::CompletionEntry::BookmarkType && type != AddressCompletionModel::CompletionEntry::HistoryType && type != AddressCompletionModel::CompletionEntry::TypedHistoryType)
+	{
+		return;
+	}
+
+	m_window->getWebWidget()->preconnect(index.data(AddressCompletionModel::UrlRole).toUrl(), (index.data(AddressCompletionModel::ScoreRole).toDouble() >= PrefetchScoreThreshold));
+}
+
 void AddressWidget::showCompletion(bool isTypedHistory)
 {
 	PopupViewWidget *popupWidget(getPopup());
@@ -789,6 +854,8 @@ void AddressWidget::showCompletion(bool isTypedHistory)
 
 				setText(index.data(AddressCompletionModel::TextRole).toString());
 			}
+
+			preconnect(index);
 		});
 
 		showPopup();
@@ -958,6 +1025,11 @@ void AddressWidget::handleUserInput(const QString &text, SessionsManager::OpenHi
 				case InputInterpreter::InterpreterResult::SearchType:
 					emit requestedSearch(result.searchQuery, result.searchEngine, hints);
 
+					if (mainWindow && !hints.testFlag(SessionsManager::BackgroundOpen))
+					{
+						InputInterpreter::redirectOnHostLookup(result, mainWindow->getActiveWindow());
+					}
+
 					break;
 				default:
 					break;
@@ -1329,6 +1401,18 @@ void AddressWidget::setCompletion(const QString &filter)
 		showCompletion(false);
 	}
 
+	for (int i = 0; i < m_completionModel->rowCount(); ++i)
+	{
+		const QModelIndex index(m_completionModel->index(i));
+
+		if (static_cast<AddressCompletionModel::CompletionEntry::EntryType>(index.data(AddressCompletionModel::TypeRole).toInt()) != AddressCompletionModel::CompletionEntry::HeaderType)
+		{
+			preconnect(index);
+
+			break;
+		}
+	}
+
 	if (m_completionModes.testFlag(InlineCompletionMode))
 	{
 		for (int i = 0; i < m_completionModel->rowCount(); ++i)
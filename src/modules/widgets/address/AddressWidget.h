@@ -26,6 +26,7 @@
 #include "../../../ui/LineEditWidget.h"
 #include "../../../ui/WebWidget.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QPointer>
 #include <QtCore/QUrl>
 #include <QtWidgets/QStyledItemDelegate>
@@ -60,6 +61,19 @@ public:
 	QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
 protected:
+	enum LayoutsCacheParameter
+	{
+		LayoutsCacheLimit = 500
+	};
+
+	struct TextRun final
+	{
+		QString text;
+		QColor color;
+		int offset = 0;
+		bool isHighlighted = false;
+	};
+
 	struct TextSegment final
 	{
 		QString text;
@@ -73,13 +87,16 @@ protected:
 		}
 	};
 
-	void drawCompletionText(QPainter *painter, const QFont &font, const QVector<TextSegment> &segments, const QRect &rectangle, bool isRightToLeft) const;
+	void drawCompletionText(QPainter *painter, const QFont &font, const QString &highlight, const QVector<TextSegment> &segments, const QRect &rectangle, bool isRightToLeft) const;
 	QVector<TextSegment> highlightSegments(const QString &highlight, const QVector<TextSegment> &segments) const;
+	QVector<TextRun> layoutCompletionText(const QFont &font, const QVector<TextSegment> &segments, int width) const;
 
 private:
 	QString m_highlight;
 	DisplayMode m_displayMode;
 	ViewMode m_viewMode;
+
+	static QCache<QString, QVector<TextRun> > m_layoutsCache;
 };
 
 class AddressWidget final : public LineEditWidget
@@ -137,6 +154,11 @@ public slots:
 	void setUrl(const QUrl &url, bool force = false);
 
 protected:
+	enum SpeculativeLoadParameter
+	{
+		PrefetchScoreThreshold = 10
+	};
+
 	void changeEvent(QEvent *event) override;
 	void paintEvent(QPaintEvent *event) override;
 	void resizeEvent(QResizeEvent *event) override;
@@ -147,6 +169,7 @@ protected:
 	void mouseMoveEvent(QMouseEvent *event) override;
 	void mouseReleaseEvent(QMouseEvent *event) override;
 	void dragEnterEvent(QDragEnterEvent *event) override;
+	void preconnect(const QModelIndex &index);
 	EntryIdentifier getEntry(const QPoint &position) const;
 
 protected slots:
@@ -92,6 +92,8 @@ ErrorConsoleWidget::ErrorConsoleWidget(QWidget *parent) : QWidget(parent),
 		{
 			m_model->clear();
 		}
+
+		m_messageItems.clear();
 	});
 	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, &ErrorConsoleWidget::filterMessages);
 	connect(m_ui->consoleView, &QTreeView::customContextMenuRequested, this, &ErrorConsoleWidget::showContextMenu);
@@ -116,28 +118,35 @@ void ErrorConsoleWidget::showEvent(QShowEvent *event)
 		m_model = new QStandardItemModel(this);
 		m_model->setSortRole(TimeRole);
 
-		const QVector<Console::Message> messages(Console::getMessages());
-
-		for (int i = 0; i < messages.count(); ++i)
-		{
-			addMessage(messages.at(i));
-		}
-
 		m_ui->consoleView->setModel(m_model);
 
-		connect(Console::getInstance(), &Console::messageAdded, this, &ErrorConsoleWidget::addMessage);
+		addMessages(Console::getMessages());
+
+		connect(Console::getInstance(), &Console::messagesAdded, this, &ErrorConsoleWidget::addMessages);
 	}
 
 	QWidget::showEvent(event);
 }
 
-void ErrorConsoleWidget::addMessage(const Console::Message &message)
+void ErrorConsoleWidget::addMessages(const QVector<Console::Message> &messages)
 {
-	if (!m_model)
+	if (!m_model || messages.isEmpty())
 	{
 		return;
 	}
 
+	for (int i = 0; i < messages.count(); ++i)
+	{
+		addMessage(messages.at(i));
+	}
+
+	m_model->sort(0, Qt::DescendingOrder);
+
+	filterMessages(m_ui->filterLineEditWidget->text());
+}
+
+void ErrorConsoleWidget::addMessage(const Console::Message &message)
+{
 	QIcon icon;
 	QString category;
 
@@ -186,7 +195,23 @@ void ErrorConsoleWidget::addMessage(const Console::Message &message)
 		entry.append(QLatin1String(" - ") + source);
 	}
 
-	QStandardItem *messageItem(new QStandardItem(icon, entry));
+	if (message.amount > 1)
+	{
+		entry = tr("%1 (repeated %n times)", nullptr, message.amount).arg(entry);
+	}
+
+	QStandardItem *messageItem(m_messageItems.value(message.identifier));
+
+	if (messageItem)
+	{
+		messageItem->setText(entry);
+		messageItem->setData(entry, Qt::ToolTipRole);
+		messageItem->setData(message.time.toMSecsSinceEpoch(), TimeRole);
+
+		return;
+	}
+
+	messageItem = new QStandardItem(icon, entry);
 	messageItem->setData(entry, Qt::ToolTipRole);
 	messageItem->setData(message.time.toMSecsSinceEpoch(), TimeRole);
 	messageItem->setData(message.category, CategoryRole);
@@ -200,9 +225,8 @@ void ErrorConsoleWidget::addMessage(const Console::Message &message)
 	messageItem->appendRow(descriptionItem);
 
 	m_model->appendRow(messageItem);
-	m_model->sort(0, Qt::DescendingOrder);
 
-	applyFilters(messageItem->index(), m_ui->filterLineEditWidget->text(), getCategories(), getActiveWindow());
+	m_messageItems[message.identifier] = messageItem;
 }
 
 void ErrorConsoleWidget::filterCategories()
@@ -61,18 +61,20 @@ protected:
 	Q_DECLARE_FLAGS(MessagesScopes, MessagesScope)
 
 	void showEvent(QShowEvent *event) override;
+	void addMessage(const Console::Message &message);
 	void applyFilters(const QModelIndex &index, const QString &filter, const QVector<Console::MessageCategory> &categories, quint64 activeWindow);
 	QVector<Console::MessageCategory> getCategories() const;
 	quint64 getActiveWindow();
 
 protected slots:
-	void addMessage(const Console::Message &message);
+	void addMessages(const QVector<Console::Message> &messages);
 	void filterCategories();
 	void filterMessages(const QString &filter);
 	void showContextMenu(const QPoint &position);
 
 private:
 	QStandardItemModel *m_model;
+	QHash<quint64, QStandardItem*> m_messageItems;
 	MessagesScopes m_messageScopes;
 	Ui::ErrorConsoleWidget *m_ui;
 };
@@ -49,7 +49,7 @@ TransfersWidget::TransfersWidget(const ToolBarsManager::ToolBarDefinition::Entry
 	setToolTip(tr("Downloads"));
 	updateState();
 
-	connect(TransfersManager::getInstance(), &TransfersManager::transferChanged, this, &TransfersWidget::updateState);
+	connect(TransfersManager::getInstance(), &TransfersManager::transfersModified, this, &TransfersWidget::updateState);
 	connect(TransfersManager::getInstance(), &TransfersManager::transferStarted, this, [&](Transfer *transfer)
 	{
 		if ((!transfer->isArchived() || transfer->getState() == Transfer::RunningState) && menu()->isVisible())
@@ -19,11 +19,13 @@
 
 #include "BookmarksContentsWidget.h"
 #include "../../../core/Application.h"
+#include "../../../core/NetworkManagerFactory.h"
 #include "../../../core/SessionsManager.h"
 #include "../../../core/SettingsManager.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../ui/Action.h"
 #include "../../../ui/BookmarkPropertiesDialog.h"
+#include "../../../ui/BookmarksCheckDialog.h"
 #include "../../../ui/MainWindow.h"
 #include "../../../ui/ProxyModel.h"
 #include "../../../ui/Window.h"
@@ -41,6 +43,7 @@ namespace Otter
 
 BookmarksContentsWidget::BookmarksContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
 	m_model(nullptr),
+	m_hoverTimer(0),
 	m_ui(new Ui::BookmarksContentsWidget)
 {
 	m_ui->setupUi(this);
@@ -78,6 +81,7 @@ BookmarksContentsWidget::BookmarksContentsWidget(const QVariantMap &parameters,
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::doubleClicked, this, &BookmarksContentsWidget::openBookmark);
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::customContextMenuRequested, this, &BookmarksContentsWidget::showContextMenu);
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::needsActionsUpdate, this, &BookmarksContentsWidget::updateActions);
+	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::entered, this, &BookmarksContentsWidget::updateHoveredBookmark);
 }
 
 BookmarksContentsWidget::~BookmarksContentsWidget()
@@ -85,6 +89,39 @@ BookmarksContentsWidget::~BookmarksContentsWidget()
 	delete m_ui;
 }
 
+void BookmarksContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_hoverTimer)
+	{
+		killTimer(m_hoverTimer);
+
+		m_hoverTimer = 0;
+
+		const QUrl url(m_hoveredIndex.data(BookmarksModel::UrlRole).toUrl());
+
+		if (!m_hoveredIndex.isValid() || !url.isValid())
+		{
+			return;
+		}
+
+		const MainWindow *mainWindow(MainWindow::findMainWindow(this));
+		Window *window(mainWindow ? mainWindow->getActiveWindow() : nullptr);
+
+		if (window && window != getWindow() && window->getWebWidget())
+		{
+			window->getWebWidget()->preconnect(url);
+		}
+		else if (NetworkManagerFactory::reserveSpeculativeLoad(url, false))
+		{
+			NetworkManagerFactory::prefetchHost(url.host());
+		}
+	}
+	else
+	{
+		ContentsWidget::timerEvent(event);
+	}
+}
+
 void BookmarksContentsWidget::changeEvent(QEvent *event)
 {
 	ContentsWidget::changeEvent(event);
@@ -146,6 +183,12 @@ void BookmarksContentsWidget::bookmarkProperties()
 	}
 }
 
+void BookmarksContentsWidget::checkBookmarks()
+{
+	BookmarksCheckDialog *dialog(new BookmarksCheckDialog(this));
+	dialog->show();
+}
+
 void BookmarksContentsWidget::showContextMenu(const QPoint &position)
 {
 	const QModelIndex index(m_ui->bookmarksViewWidget->indexAt(position));
@@ -162,6 +205,8 @@ void BookmarksContentsWidget::showContextMenu(const QPoint &position)
 			menu.addAction(ThemesManager::createIcon(QLatin1String("inode-directory")), tr("Add Folder…"), this, &BookmarksContentsWidget::addFolder);
 			menu.addAction(tr("Add Bookmark…"), this, &BookmarksContentsWidget::addBookmark);
 			menu.addAction(tr("Add Separator"), this, &BookmarksContentsWidget::addSeparator);
+			menu.addSeparator();
+			menu.addAction(tr("Check Bookmarks…"), this, &BookmarksContentsWidget::checkBookmarks);
 
 			break;
 		default:
@@ -229,6 +274,11 @@ void BookmarksContentsWidget::showContextMenu(const QPoint &position)
 						menu.addAction(tr("Properties…"), this, &BookmarksContentsWidget::bookmarkProperties);
 					}
 				}
+				else
+				{
+					menu.addSeparator();
+					menu.addAction(tr("Check Bookmarks…"), this, &BookmarksContentsWidget::checkBookmarks);
+				}
 			}
 
 			break;
@@ -268,6 +318,28 @@ void BookmarksContentsWidget::triggerAction(int identifier, const QVariantMap &p
 	}
 }
 
+void BookmarksContentsWidget::updateHoveredBookmark(const QModelIndex &index)
+{
+	if (m_hoveredIndex == index)
+	{
+		return;
+	}
+
+	if (m_hoverTimer != 0)
+	{
+		killTimer(m_hoverTimer);
+
+		m_hoverTimer = 0;
+	}
+
+	m_hoveredIndex = index;
+
+	if (index.isValid() && !isPrivate() && index.data(BookmarksModel::TypeRole).toInt() == BookmarksModel::UrlBookmark)
+	{
+		m_hoverTimer = startTimer(BookmarkHoverDelay);
+	}
+}
+
 void BookmarksContentsWidget::updateActions()
 {
 	const bool hasSelecion(!m_ui->bookmarksViewWidget->selectionModel()->selectedIndexes().isEmpty());
@@ -394,6 +466,10 @@ bool BookmarksContentsWidget::eventFilter(QObject *object, QEvent *event)
 			}
 		}
 	}
+	else if (object == m_ui->bookmarksViewWidget->viewport() && event->type() == QEvent::Leave)
+	{
+		updateHoveredBookmark({});
+	}
 	else if (object == m_ui->bookmarksViewWidget->viewport() && event->type() == QEvent::ToolTip)
 	{
 		const QHelpEvent *helpEvent(static_cast<QHelpEvent*>(event));
@@ -56,12 +56,18 @@ public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
 
 protected:
+	enum HoverIntentParameter
+	{
+		BookmarkHoverDelay = 200
+	};
+
 	struct BookmarkLocation final
 	{
 		BookmarksModel::Bookmark *folder = nullptr;
 		int row = -1;
 	};
 
+	void timerEvent(QTimerEvent *event) override;
 	void changeEvent(QEvent *event) override;
 	BookmarksModel::Bookmark* getBookmark(const QModelIndex &index) const;
 	BookmarkLocation getBookmarkCreationLocation();
@@ -73,11 +79,15 @@ protected slots:
 	void removeBookmark();
 	void openBookmark();
 	void bookmarkProperties();
+	void checkBookmarks();
 	void showContextMenu(const QPoint &position);
 	void updateActions();
+	void updateHoveredBookmark(const QModelIndex &index);
 
 private:
 	ProxyModel *m_model;
+	QPersistentModelIndex m_hoveredIndex;
+	int m_hoverTimer;
 	Ui::BookmarksContentsWidget *m_ui;
 };
 
@@ -40,6 +40,7 @@ namespace Otter
 
 CacheContentsWidget::CacheContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
 	m_model(new QStandardItemModel(this)),
+	m_populationTimer(0),
 	m_isLoading(true),
 	m_ui(new Ui::CacheContentsWidget)
 {
@@ -80,6 +81,35 @@ void CacheContentsWidget::changeEvent(QEvent *event)
 	}
 }
 
+void CacheContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_populationTimer)
+	{
+		const int amount(qMin(static_cast<int>(PopulationBatchSize), m_pendingEntries.count()));
+
+		for (int i = 0; i < amount; ++i)
+		{
+			handleEntryAdded(m_pendingEntries.takeLast());
+		}
+
+		if (m_pendingEntries.isEmpty())
+		{
+			killTimer(m_populationTimer);
+
+			m_populationTimer = 0;
+			m_isLoading = false;
+
+			m_pendingEntries.squeeze();
+
+			emit loadingStateChanged(WebWidget::FinishedLoadingState);
+		}
+	}
+	else
+	{
+		ContentsWidget::timerEvent(event);
+	}
+}
+
 void CacheContentsWidget::print(QPrinter *printer)
 {
 	m_ui->cacheViewWidget->render(printer);
@@ -117,27 +147,33 @@ void CacheContentsWidget::populateCache()
 	m_model->setHeaderData(2, Qt::Horizontal, 150, HeaderViewWidget::WidthRole);
 	m_model->setSortRole(Qt::DisplayRole);
 
+	m_domainItems.clear();
+	m_entryItems.clear();
+
 	const NetworkCache *cache(NetworkManagerFactory::getCache());
-	const QVector<QUrl> entries(cache->getEntries());
 
-	for (int i = 0; i < entries.count(); ++i)
+	m_pendingEntries = cache->getEntries();
+
+	if (m_populationTimer == 0)
 	{
-		handleEntryAdded(entries.at(i));
+		m_populationTimer = startTimer(0);
 	}
 
-	m_model->sort(0);
+	if (!m_isLoading)
+	{
+		m_isLoading = true;
 
-	if (m_isLoading)
+		emit loadingStateChanged(WebWidget::OngoingLoadingState);
+	}
+
+	if (!m_ui->cacheViewWidget->getSourceModel())
 	{
 		m_ui->cacheViewWidget->setModel(m_model);
 		m_ui->cacheViewWidget->setLayoutDirection(Qt::LeftToRight);
 		m_ui->cacheViewWidget->setFilterRoles({Qt::DisplayRole, Qt::UserRole});
 
-		m_isLoading = false;
-
-		emit loadingStateChanged(WebWidget::FinishedLoadingState);
-
 		connect(cache, &NetworkCache::cleared, this, &CacheContentsWidget::populateCache);
+		connect(cache, &NetworkCache::indexRebuilt, this, &CacheContentsWidget::populateCache);
 		connect(cache, &NetworkCache::entryAdded, this, &CacheContentsWidget::handleEntryAdded);
 		connect(cache, &NetworkCache::entryRemoved, this, &CacheContentsWidget::handleEntryRemoved);
 		connect(m_model, &QStandardItemModel::modelReset, this, &CacheContentsWidget::updateActions);
@@ -212,119 +248,91 @@ void CacheContentsWidget::openEntry()
 
 void CacheContentsWidget::handleEntryAdded(const QUrl &entry)
 {
-	const QString domain(entry.host());
-	QStandardItem *domainItem(findDomainItem(domain));
-
-	if (domainItem)
+	if (m_entryItems.contains(entry))
 	{
-		for (int i = 0; i < domainItem->rowCount(); ++i)
-		{
-			if (ItemModel::getItemData(domainItem->child(i, 0), Qt::UserRole).toUrl() == entry)
-			{
-				return;
-			}
-		}
+		return;
 	}
-	else
-	{
-		domainItem = new QStandardItem(HistoryManager::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
-		domainItem->setToolTip(domain);
 
-		m_model->appendRow(domainItem);
-		m_model->setItem(domainItem->row(), 2, new QStandardItem());
+	const NetworkCache::EntryInformation information(NetworkManagerFactory::getCache()->getEntryInformation(entry));
 
-		if (sender())
-		{
-			m_model->sort(0);
-		}
+	if (!information.isValid())
+	{
+		return;
 	}
 
-	NetworkCache *cache(NetworkManagerFactory::getCache());
-	QIODevice *device(cache->data(entry));
-	const QNetworkCacheMetaData metaData(cache->metaData(entry));
-	const QList<QPair<QByteArray, QByteArray> > headers(metaData.rawHeaders());
-	QString type;
+	const QString domain(entry.host());
+	QStandardItem *domainItem(findDomainItem(domain));
 
-	for (int i = 0; i < headers.count(); ++i)
+	if (!domainItem)
 	{
-		if (headers.at(i).first == QByteArrayLiteral("Content-Type"))
-		{
-			type = QString::fromLatin1(headers.at(i).second);
+		domainItem = new QStandardItem(HistoryManager::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
+		domainItem->setToolTip(domain);
 
-			break;
-		}
+		m_model->insertRow(findDomainRow(domain), {domainItem, new QStandardItem()});
+
+		m_domainItems[domain] = domainItem;
 	}
 
-	const QMimeType mimeType((device && type.isEmpty()) ? QMimeDatabase().mimeTypeForData(device) : QMimeDatabase().mimeTypeForName(type));
-	QList<QStandardItem*> entryItems({new QStandardItem(entry.path()), new QStandardItem(mimeType.name()), new QStandardItem(device ? Utils::formatUnit(device->size()) : QString()), new QStandardItem(Utils::formatDateTime(metaData.lastModified())), new QStandardItem(Utils::formatDateTime(metaData.expirationDate()))});
+	const QMimeType mimeType(information.mimeType.isEmpty() ? QMimeDatabase().mimeTypeForUrl(entry) : QMimeDatabase().mimeTypeForName(information.mimeType));
+	const bool hasSize(information.size >= 0);
+	QList<QStandardItem*> entryItems({new QStandardItem(entry.path()), new QStandardItem(mimeType.name()), new QStandardItem(hasSize ? Utils::formatUnit(information.size) : QString()), new QStandardItem(Utils::formatDateTime(information.lastModified)), new QStandardItem(Utils::formatDateTime(information.expirationDate))});
 	entryItems[0]->setData(entry, Qt::UserRole);
 	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setData((device ? device->size() : 0), Qt::UserRole);
+	entryItems[2]->setData((hasSize ? information.size : 0), Qt::UserRole);
 	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[3]->setFlags(entryItems[3]->flags() | Qt::ItemNeverHasChildren);
 	entryItems[4]->setFlags(entryItems[4]->flags() | Qt::ItemNeverHasChildren);
 
-	if (device)
+	if (hasSize)
 	{
 		QStandardItem *sizeItem(m_model->item(domainItem->row(), 2));
 
 		if (sizeItem)
 		{
-			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + device->size()), Qt::UserRole);
+			sizeItem->setData((sizeItem->data(Qt::UserRole).toLongLong() + information.size), Qt::UserRole);
 			sizeItem->setText(Utils::formatUnit(sizeItem->data(Qt::UserRole).toLongLong()));
 		}
-
-		device->deleteLater();
 	}
 
-	domainItem->appendRow(entryItems);
+	domainItem->insertRow(findEntryRow(domainItem, entry.path()), entryItems);
 	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
 
-	if (sender())
-	{
-		domainItem->sortChildren(0, Qt::DescendingOrder);
-	}
+	m_entryItems[entry] = entryItems[0];
 }
 
 void CacheContentsWidget::handleEntryRemoved(const QUrl &entry)
 {
-	QStandardItem *domainItem(findDomainItem(Utils::extractHost(entry)));
+	const QStandardItem *entryItem(m_entryItems.take(entry));
+	QStandardItem *domainItem(entryItem ? entryItem->parent() : nullptr);
 
 	if (!domainItem)
 	{
 		return;
 	}
 
-	for (int i = 0; i < domainItem->rowCount(); ++i)
-	{
-		QStandardItem *entryItem(domainItem->child(i, 0));
-
-		if (entryItem && entryItem->data(Qt::UserRole).toUrl() == entry)
-		{
-			const qint64 size(ItemModel::getItemData(domainItem->child(entryItem->row(), 2), Qt::UserRole).toLongLong());
-
-			m_model->removeRow(entryItem->row(), domainItem->index());
+	const QString domain(domainItem->toolTip());
+	const qint64 size(ItemModel::getItemData(domainItem->child(entryItem->row(), 2), Qt::UserRole).toLongLong());
 
-			if (domainItem->rowCount() == 0)
-			{
-				m_model->invisibleRootItem()->removeRow(domainItem->row());
-			}
-			else
-			{
-				QStandardItem *domainSizeItem(m_model->item(domainItem->row(), 2));
+	m_model->removeRow(entryItem->row(), domainItem->index());
 
-				if (domainSizeItem && size > 0)
-				{
-					domainSizeItem->setData((domainSizeItem->data(Qt::UserRole).toLongLong() - size), Qt::UserRole);
-					domainSizeItem->setText(Utils::formatUnit(domainSizeItem->data(Qt::UserRole).toLongLong()));
-				}
+	if (domainItem->rowCount() == 0)
+	{
+		m_domainItems.remove(domain);
 
-				domainItem->setText(QStringLiteral("%1 (%2)").arg(entry.host()).arg(domainItem->rowCount()));
-			}
+		m_model->invisibleRootItem()->removeRow(domainItem->row());
+	}
+	else
+	{
+		QStandardItem *domainSizeItem(m_model->item(domainItem->row(), 2));
 
-			break;
+		if (domainSizeItem && size > 0)
+		{
+			domainSizeItem->setData((domainSizeItem->data(Qt::UserRole).toLongLong() - size), Qt::UserRole);
+			domainSizeItem->setText(Utils::formatUnit(domainSizeItem->data(Qt::UserRole).toLongLong()));
 		}
+
+		domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
 	}
 }
 
@@ -510,17 +518,53 @@ void CacheContentsWidget::updateActions()
 
 QStandardItem* CacheContentsWidget::findDomainItem(const QString &domain)
 {
-	for (int i = 0; i < m_model->rowCount(); ++i)
+	return m_domainItems.value(domain);
+}
+
+int CacheContentsWidget::findDomainRow(const QString &domain) const
+{
+	int low(0);
+	int high(m_model->rowCount());
+
+	while (low < high)
+	{
+		const int middle((low + high) / 2);
+		const QStandardItem *domainItem(m_model->item(middle, 0));
+
+		if (domainItem && domainItem->toolTip() < domain)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+int CacheContentsWidget::findEntryRow(const QStandardItem *domainItem, const QString &path) const
+{
+	int low(0);
+	int high(domainItem->rowCount());
+
+	while (low < high)
 	{
-		QStandardItem *domainItem(m_model->item(i, 0));
+		const int middle((low + high) / 2);
+		const QStandardItem *entryItem(domainItem->child(middle, 0));
 
-		if (domainItem && domain == domainItem->toolTip())
+		if (entryItem && entryItem->text() > path)
+		{
+			low = (middle + 1);
+		}
+		else
 		{
-			return domainItem;
+			high = middle;
 		}
 	}
 
-	return nullptr;
+	return low;
 }
 
 QString CacheContentsWidget::getTitle() const
@@ -55,8 +55,16 @@ public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
 
 protected:
+	enum PopulationParameter
+	{
+		PopulationBatchSize = 250
+	};
+
 	void changeEvent(QEvent *event) override;
+	void timerEvent(QTimerEvent *event) override;
 	QStandardItem* findDomainItem(const QString &domain);
+	int findDomainRow(const QString &domain) const;
+	int findEntryRow(const QStandardItem *domainItem, const QString &path) const;
 	QUrl getEntry(const QModelIndex &index) const;
 
 protected slots:
@@ -72,6 +80,10 @@ protected slots:
 
 private:
 	QStandardItemModel *m_model;
+	QVector<QUrl> m_pendingEntries;
+	QHash<QString, QStandardItem*> m_domainItems;
+	QHash<QUrl, QStandardItem*> m_entryItems;
+	int m_populationTimer;
 	bool m_isLoading;
 	Ui::CacheContentsWidget *m_ui;
 };
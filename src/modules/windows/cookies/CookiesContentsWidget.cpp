@@ -38,7 +38,7 @@ namespace Otter
 {
 
 CookiesContentsWidget::CookiesContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
-	m_model(new QStandardItemModel(this)),
+	m_model(new CookiesModel(NetworkManagerFactory::getCookieJar(), this)),
 	m_isLoading(true),
 	m_ui(new Ui::CookiesContentsWidget)
 {
@@ -53,7 +53,15 @@ CookiesContentsWidget::CookiesContentsWidget(const QVariantMap &parameters, Wind
 
 	QTimer::singleShot(100, this, &CookiesContentsWidget::populateCookies);
 
-	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->cookiesViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, [&](const QString &filter)
+	{
+		if (!filter.isEmpty())
+		{
+			m_model->fetchAll();
+		}
+
+		m_ui->cookiesViewWidget->setFilterString(filter);
+	});
 	connect(m_ui->cookiesViewWidget, &ItemViewWidget::customContextMenuRequested, this, &CookiesContentsWidget::showContextMenu);
 	connect(m_ui->propertiesButton, &QPushButton::clicked, this, &CookiesContentsWidget::cookieProperties);
 	connect(m_ui->deleteButton, &QPushButton::clicked, this, &CookiesContentsWidget::removeCookies);
@@ -77,15 +85,7 @@ void CookiesContentsWidget::changeEvent(QEvent *event)
 
 void CookiesContentsWidget::populateCookies()
 {
-	const CookieJar *cookieJar(NetworkManagerFactory::getCookieJar());
-	const QVector<QNetworkCookie> cookies(cookieJar->getCookies());
-
-	for (int i = 0; i < cookies.count(); ++i)
-	{
-		handleCookieAdded(cookies.at(i));
-	}
-
-	m_model->sort(0);
+	m_model->reload();
 
 	m_ui->cookiesViewWidget->setViewMode(ItemViewWidget::TreeView);
 	m_ui->cookiesViewWidget->setModel(m_model);
@@ -95,9 +95,10 @@ void CookiesContentsWidget::populateCookies()
 
 	emit loadingStateChanged(WebWidget::FinishedLoadingState);
 
-	connect(cookieJar, &CookieJar::cookieAdded, this, &CookiesContentsWidget::handleCookieAdded);
-	connect(cookieJar, &CookieJar::cookieRemoved, this, &CookiesContentsWidget::handleCookieRemoved);
-	connect(m_model, &QStandardItemModel::modelReset, this, &CookiesContentsWidget::updateActions);
+	connect(m_model, &CookiesModel::modelReset, this, &CookiesContentsWidget::updateActions);
+	connect(m_model, &CookiesModel::dataChanged, this, &CookiesContentsWidget::updateActions);
+	connect(m_model, &CookiesModel::rowsAboutToBeRemoved, this, &CookiesContentsWidget::handleRowsAboutToBeRemoved);
+	connect(m_model, &CookiesModel::rowsRemoved, this, &CookiesContentsWidget::handleRowsRemoved);
 	connect(m_ui->cookiesViewWidget, &ItemViewWidget::needsActionsUpdate, this, &CookiesContentsWidget::updateActions);
 }
 
@@ -135,14 +136,9 @@ void CookiesContentsWidget::removeCookies()
 		{
 			const QStandardItem *domainItem(m_model->itemFromIndex(indexes.at(i)));
 
-			if (!domainItem)
-			{
-				continue;
-			}
-
-			for (int j = 0; j < domainItem->rowCount(); ++j)
+			if (domainItem)
 			{
-				cookies.append(getCookie(ItemModel::getItemData(domainItem->child(j, 0), Qt::UserRole)));
+				cookies.append(cookieJar->getDomainCookies(domainItem->toolTip()));
 			}
 		}
 		else
@@ -176,17 +172,17 @@ void CookiesContentsWidget::removeDomainCookies()
 
 	for (int i = 0; i < indexes.count(); ++i)
 	{
-		const QStandardItem *domainItem((indexes.at(i).isValid() && indexes.at(i).parent() == m_model->invisibleRootItem()->index()) ? findDomainItem(indexes.at(i).sibling(indexes.at(i).row(), 0).data(Qt::ToolTipRole).toString()) : m_model->itemFromIndex(indexes.at(i).parent()));
+		const QStandardItem *domainItem((indexes.at(i).isValid() && indexes.at(i).parent() == m_model->invisibleRootItem()->index()) ? m_model->getDomainItem(indexes.at(i).sibling(indexes.at(i).row(), 0).data(Qt::ToolTipRole).toString()) : m_model->itemFromIndex(indexes.at(i).parent()));
 
 		if (domainItem)
 		{
-			for (int j = 0; j < domainItem->rowCount(); ++j)
-			{
-				const QNetworkCookie cookie(getCookie(ItemModel::getItemData(domainItem->child(j, 0), Qt::UserRole)));
+			const QVector<QNetworkCookie> domainCookies(NetworkManagerFactory::getCookieJar()->getDomainCookies(domainItem->toolTip()));
 
-				if (!cookies.contains(cookie))
+			for (int j = 0; j < domainCookies.count(); ++j)
+			{
+				if (!cookies.contains(domainCookies.at(j)))
 				{
-					cookies.append(cookie);
+					cookies.append(domainCookies.at(j));
 				}
 			}
 		}
@@ -243,92 +239,29 @@ void CookiesContentsWidget::cookieProperties()
 	}
 }
 
-void CookiesContentsWidget::handleCookieAdded(const QNetworkCookie &cookie)
+void CookiesContentsWidget::handleRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
 {
-	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-	QStandardItem *domainItem(findDomainItem(domain));
-
-	if (domainItem)
-	{
-		for (int i = 0; i < domainItem->rowCount(); ++i)
-		{
-			QStandardItem *childItem(domainItem->child(i, 0));
-
-			if (childItem && cookie.hasSameIdentifier(getCookie(childItem->index().data(Qt::UserRole))))
-			{
-				childItem->setData(cookie.toRawForm());
+	const QModelIndex index(m_ui->cookiesViewWidget->currentIndex());
 
-				updateActions();
-
-				return;
-			}
-		}
-	}
-	else
+	if (index.isValid() && index.parent() == parent && index.row() >= first && index.row() <= last)
 	{
-		domainItem = new QStandardItem(HistoryManager::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain);
-		domainItem->setToolTip(domain);
-
-		m_model->appendRow(domainItem);
-
-		if (sender())
-		{
-			m_model->sort(0);
-		}
+		m_removedCookiePosition = m_ui->cookiesViewWidget->visualRect(index).center();
 	}
-
-	QStandardItem *cookieItem(new QStandardItem(QString::fromLatin1(cookie.name())));
-	cookieItem->setData(cookie.toRawForm(), Qt::UserRole);
-	cookieItem->setToolTip(QString::fromLatin1(cookie.name()));
-	cookieItem->setFlags(cookieItem->flags() | Qt::ItemNeverHasChildren);
-
-	domainItem->appendRow(cookieItem);
-	domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
 }
 
-void CookiesContentsWidget::handleCookieRemoved(const QNetworkCookie &cookie)
+void CookiesContentsWidget::handleRowsRemoved()
 {
-	const QString domain(cookie.domain().startsWith(QLatin1Char('.')) ? cookie.domain().mid(1) : cookie.domain());
-	QStandardItem *domainItem(findDomainItem(domain));
-
-	if (domainItem)
+	if (m_removedCookiePosition.isNull())
 	{
-		QPoint point;
-
-		for (int j = 0; j < domainItem->rowCount(); ++j)
-		{
-			if (cookie.hasSameIdentifier(getCookie(ItemModel::getItemData(domainItem->child(j, 0), Qt::UserRole))))
-			{
-				const QStandardItem *cookieItem(domainItem->child(j, 0));
+		return;
+	}
 
-				if (cookieItem)
-				{
-					point = m_ui->cookiesViewWidget->visualRect(cookieItem->index()).center();
-				}
+	const QModelIndex index(m_ui->cookiesViewWidget->indexAt(m_removedCookiePosition));
 
-				domainItem->removeRow(j);
+	m_removedCookiePosition = {};
 
-				break;
-			}
-		}
-
-		if (domainItem->rowCount() == 0)
-		{
-			m_model->invisibleRootItem()->removeRow(domainItem->row());
-		}
-		else
-		{
-			domainItem->setText(QStringLiteral("%1 (%2)").arg(domain).arg(domainItem->rowCount()));
-		}
-
-		if (!point.isNull())
-		{
-			const QModelIndex index(m_ui->cookiesViewWidget->indexAt(point));
-
-			m_ui->cookiesViewWidget->setCurrentIndex(index);
-			m_ui->cookiesViewWidget->selectionModel()->select(index, QItemSelectionModel::Select);
-		}
-	}
+	m_ui->cookiesViewWidget->setCurrentIndex(index);
+	m_ui->cookiesViewWidget->selectionModel()->select(index, QItemSelectionModel::Select);
 }
 
 void CookiesContentsWidget::showContextMenu(const QPoint &position)
@@ -425,21 +358,6 @@ void CookiesContentsWidget::updateActions()
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::EditingCategory});
 }
 
-QStandardItem* CookiesContentsWidget::findDomainItem(const QString &domain)
-{
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *item(m_model->item(i, 0));
-
-		if (item && domain == item->toolTip())
-		{
-			return item;
-		}
-	}
-
-	return nullptr;
-}
-
 QString CookiesContentsWidget::getTitle() const
 {
 	return tr("Cookies");
@@ -20,11 +20,9 @@
 #ifndef OTTER_COOKIESCONTENTSWIDGET_H
 #define OTTER_COOKIESCONTENTSWIDGET_H
 
+#include "CookiesModel.h"
 #include "../../../ui/ContentsWidget.h"
 
-#include <QtGui/QStandardItemModel>
-#include <QtNetwork/QNetworkCookie>
-
 namespace Otter
 {
 
@@ -57,7 +55,6 @@ public slots:
 
 protected:
 	void changeEvent(QEvent *event) override;
-	QStandardItem* findDomainItem(const QString &domain);
 	QNetworkCookie getCookie(const QVariant &data) const;
 
 protected slots:
@@ -67,13 +64,14 @@ protected slots:
 	void removeDomainCookies();
 	void removeAllCookies();
 	void cookieProperties();
-	void handleCookieAdded(const QNetworkCookie &cookie);
-	void handleCookieRemoved(const QNetworkCookie &cookie);
+	void handleRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+	void handleRowsRemoved();
 	void showContextMenu(const QPoint &position);
 	void updateActions();
 
 private:
-	QStandardItemModel *m_model;
+	CookiesModel *m_model;
+	QPoint m_removedCookiePosition;
 	bool m_isLoading;
 	Ui::CookiesContentsWidget *m_ui;
 };
@@ -0,0 +1,318 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "CookiesModel.h"
+#include "../../../core/CookieJar.h"
+#include "../../../core/HistoryManager.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+CookiesModel::CookiesModel(CookieJar *cookieJar, QObject *parent) : QStandardItemModel(parent),
+	m_cookieJar(cookieJar),
+	m_updateTimer(0)
+{
+	connect(cookieJar, &CookieJar::cookieAdded, this, &CookiesModel::handleCookieChanged);
+	connect(cookieJar, &CookieJar::cookieRemoved, this, &CookiesModel::handleCookieChanged);
+}
+
+void CookiesModel::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+
+		const QSet<QString> domains(m_modifiedDomains);
+
+		m_modifiedDomains.clear();
+
+		QSet<QString>::const_iterator iterator;
+
+		for (iterator = domains.constBegin(); iterator != domains.constEnd(); ++iterator)
+		{
+			updateDomain(*iterator);
+		}
+	}
+}
+
+void CookiesModel::reload()
+{
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+
+	clear();
+
+	m_domainItems.clear();
+	m_modifiedDomains.clear();
+
+	QStringList domains(m_cookieJar->getDomains());
+	domains.sort();
+
+	QList<QStandardItem*> domainItems;
+	domainItems.reserve(domains.count());
+
+	m_domainItems.reserve(domains.count());
+
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		QStandardItem *domainItem(createDomainItem(domains.at(i)));
+
+		setCookiesAmount(domainItem, m_cookieJar->getDomainCookies(domains.at(i)).count());
+
+		domainItems.append(domainItem);
+
+		m_domainItems[domains.at(i)] = domainItem;
+	}
+
+	invisibleRootItem()->appendRows(domainItems);
+}
+
+void CookiesModel::fetchAll()
+{
+	for (int i = 0; i < rowCount(); ++i)
+	{
+		const QModelIndex domainIndex(index(i, 0));
+
+		if (canFetchMore(domainIndex))
+		{
+			populateDomain(itemFromIndex(domainIndex));
+		}
+	}
+}
+
+void CookiesModel::fetchMore(const QModelIndex &parent)
+{
+	if (canFetchMore(parent))
+	{
+		populateDomain(itemFromIndex(parent));
+	}
+}
+
+void CookiesModel::populateDomain(QStandardItem *domainItem)
+{
+	QVector<QNetworkCookie> cookies(m_cookieJar->getDomainCookies(domainItem->toolTip()));
+
+	std::sort(cookies.begin(), cookies.end(), [&](const QNetworkCookie &first, const QNetworkCookie &second)
+	{
+		return (first.name() < second.name());
+	});
+
+	QList<QStandardItem*> cookieItems;
+	cookieItems.reserve(cookies.count());
+
+	for (int i = 0; i < cookies.count(); ++i)
+	{
+		cookieItems.append(createCookieItem(cookies.at(i)));
+	}
+
+	domainItem->setData(true, IsPopulatedRole);
+	domainItem->appendRows(cookieItems);
+}
+
+void CookiesModel::updateDomain(const QString &domain)
+{
+	const QVector<QNetworkCookie> cookies(m_cookieJar->getDomainCookies(domain));
+	QStandardItem *domainItem(m_domainItems.value(domain));
+
+	if (cookies.isEmpty())
+	{
+		if (domainItem)
+		{
+			m_domainItems.remove(domain);
+
+			removeRow(domainItem->row());
+		}
+
+		return;
+	}
+
+	if (!domainItem)
+	{
+		domainItem = createDomainItem(domain);
+
+		insertRow(findDomainRow(domain), domainItem);
+
+		m_domainItems[domain] = domainItem;
+	}
+
+	if (domainItem->data(IsPopulatedRole).toBool())
+	{
+		QHash<QString, QNetworkCookie> addedCookies;
+		addedCookies.reserve(cookies.count());
+
+		for (int i = 0; i < cookies.count(); ++i)
+		{
+			addedCookies[getCookieIdentifier(cookies.at(i))] = cookies.at(i);
+		}
+
+		for (int i = (domainItem->rowCount() - 1); i >= 0; --i)
+		{
+			QStandardItem *cookieItem(domainItem->child(i, 0));
+			const QString identifier(cookieItem ? cookieItem->data(IdentifierRole).toString() : QString());
+
+			if (!addedCookies.contains(identifier))
+			{
+				domainItem->removeRow(i);
+
+				continue;
+			}
+
+			const QByteArray rawCookie(addedCookies.take(identifier).toRawForm());
+
+			if (cookieItem->data(CookieRole).toByteArray() != rawCookie)
+			{
+				cookieItem->setData(rawCookie, CookieRole);
+			}
+		}
+
+		QHash<QString, QNetworkCookie>::const_iterator iterator;
+
+		for (iterator = addedCookies.constBegin(); iterator != addedCookies.constEnd(); ++iterator)
+		{
+			domainItem->insertRow(findCookieRow(domainItem, QString::fromLatin1(iterator.value().name())), createCookieItem(iterator.value()));
+		}
+	}
+
+	setCookiesAmount(domainItem, cookies.count());
+}
+
+void CookiesModel::setCookiesAmount(QStandardItem *domainItem, int amount)
+{
+	domainItem->setData(amount, CookiesAmountRole);
+	domainItem->setText(QStringLiteral("%1 (%2)").arg(domainItem->toolTip()).arg(amount));
+}
+
+void CookiesModel::handleCookieChanged(const QNetworkCookie &cookie)
+{
+	m_modifiedDomains.insert(getDomainKey(cookie.domain()));
+
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(UpdateInterval);
+	}
+}
+
+QStandardItem* CookiesModel::createDomainItem(const QString &domain) const
+{
+	QStandardItem *domainItem(new QStandardItem(HistoryManager::getIcon(QUrl(QStringLiteral("http://%1/").arg(domain))), domain));
+	domainItem->setToolTip(domain);
+
+	return domainItem;
+}
+
+QStandardItem* CookiesModel::createCookieItem(const QNetworkCookie &cookie) const
+{
+	QStandardItem *cookieItem(new QStandardItem(QString::fromLatin1(cookie.name())));
+	cookieItem->setData(cookie.toRawForm(), CookieRole);
+	cookieItem->setData(getCookieIdentifier(cookie), IdentifierRole);
+	cookieItem->setToolTip(QString::fromLatin1(cookie.name()));
+	cookieItem->setFlags(cookieItem->flags() | Qt::ItemNeverHasChildren);
+
+	return cookieItem;
+}
+
+QStandardItem* CookiesModel::getDomainItem(const QString &domain) const
+{
+	return m_domainItems.value(getDomainKey(domain));
+}
+
+QString CookiesModel::getDomainKey(const QString &domain)
+{
+	return (domain.startsWith(QLatin1Char('.')) ? domain.mid(1) : domain).toLower();
+}
+
+QString CookiesModel::getCookieIdentifier(const QNetworkCookie &cookie)
+{
+	return QString::fromLatin1(cookie.name()) + QLatin1Char('\n') + cookie.domain() + QLatin1Char('\n') + cookie.path();
+}
+
+int CookiesModel::findDomainRow(const QString &domain) const
+{
+	int low(0);
+	int high(rowCount());
+
+	while (low < high)
+	{
+		const int middle((low + high) / 2);
+		const QStandardItem *domainItem(item(middle, 0));
+
+		if (domainItem && domainItem->toolTip() < domain)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+int CookiesModel::findCookieRow(const QStandardItem *domainItem, const QString &name)
+{
+	int low(0);
+	int high(domainItem->rowCount());
+
+	while (low < high)
+	{
+		const int middle((low + high) / 2);
+		const QStandardItem *cookieItem(domainItem->child(middle, 0));
+
+		if (cookieItem && cookieItem->text() < name)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+bool CookiesModel::canFetchMore(const QModelIndex &parent) const
+{
+	const QStandardItem *domainItem(itemFromIndex(parent));
+
+	return (domainItem && !domainItem->parent() && !domainItem->data(IsPopulatedRole).toBool() && domainItem->data(CookiesAmountRole).toInt() > 0);
+}
+
+bool CookiesModel::hasChildren(const QModelIndex &parent) const
+{
+	const QStandardItem *domainItem(itemFromIndex(parent));
+
+	if (domainItem && !domainItem->parent() && !domainItem->data(IsPopulatedRole).toBool())
+	{
+		return (domainItem->data(CookiesAmountRole).toInt() > 0);
+	}
+
+	return QStandardItemModel::hasChildren(parent);
+}
+
+}
@@ -0,0 +1,83 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_COOKIESMODEL_H
+#define OTTER_COOKIESMODEL_H
+
+#include <QtCore/QSet>
+#include <QtGui/QStandardItemModel>
+#include <QtNetwork/QNetworkCookie>
+
+namespace Otter
+{
+
+class CookieJar;
+
+class CookiesModel final : public QStandardItemModel
+{
+	Q_OBJECT
+
+public:
+	enum DataRole
+	{
+		CookieRole = Qt::UserRole,
+		IdentifierRole,
+		CookiesAmountRole,
+		IsPopulatedRole
+	};
+
+	explicit CookiesModel(CookieJar *cookieJar, QObject *parent = nullptr);
+
+	void reload();
+	void fetchAll();
+	void fetchMore(const QModelIndex &parent) override;
+	QStandardItem* getDomainItem(const QString &domain) const;
+	bool canFetchMore(const QModelIndex &parent) const override;
+	bool hasChildren(const QModelIndex &parent = {}) const override;
+
+protected:
+	enum UpdateParameter
+	{
+		UpdateInterval = 100
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void populateDomain(QStandardItem *domainItem);
+	void updateDomain(const QString &domain);
+	void setCookiesAmount(QStandardItem *domainItem, int amount);
+	QStandardItem* createDomainItem(const QString &domain) const;
+	QStandardItem* createCookieItem(const QNetworkCookie &cookie) const;
+	static QString getDomainKey(const QString &domain);
+	static QString getCookieIdentifier(const QNetworkCookie &cookie);
+	int findDomainRow(const QString &domain) const;
+	static int findCookieRow(const QStandardItem *domainItem, const QString &name);
+
+protected slots:
+	void handleCookieChanged(const QNetworkCookie &cookie);
+
+private:
+	CookieJar *m_cookieJar;
+	QHash<QString, QStandardItem*> m_domainItems;
+	QSet<QString> m_modifiedDomains;
+	int m_updateTimer;
+};
+
+}
+
+#endif
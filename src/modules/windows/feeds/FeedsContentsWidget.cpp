@@ -107,7 +107,7 @@ FeedsContentsWidget::FeedsContentsWidget(const QVariantMap &parameters, QWidget
 	}
 
 	connect(FeedsManager::getInstance(), &FeedsManager::feedModified, this, &FeedsContentsWidget::handleFeedModified);
-	connect(m_ui->entriesFilterLineEditWidget, &LineEditWidget::textChanged, m_ui->entriesViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_ui->entriesFilterLineEditWidget, &LineEditWidget::textChanged, this, &FeedsContentsWidget::filterEntries);
 	connect(m_ui->entriesViewWidget, &ItemViewWidget::doubleClicked, this, &FeedsContentsWidget::openEntry);
 	connect(m_ui->entriesViewWidget, &ItemViewWidget::customContextMenuRequested, this, &FeedsContentsWidget::showEntriesContextMenu);
 	connect(m_ui->entriesViewWidget, &ItemViewWidget::needsActionsUpdate, this, &FeedsContentsWidget::updateEntry);
@@ -314,6 +314,27 @@ void FeedsContentsWidget::removeEntry()
 	}
 }
 
+void FeedsContentsWidget::filterEntries(const QString &filter)
+{
+	const QStringList identifiers((m_feed && !filter.isEmpty()) ? m_feed->findEntries(filter) : QStringList());
+
+	if (identifiers.isEmpty())
+	{
+		m_ui->entriesViewWidget->setFilterMatcher(nullptr);
+	}
+	else
+	{
+		const QSet<QString> matchingIdentifiers(identifiers.toSet());
+
+		m_ui->entriesViewWidget->setFilterMatcher([=](const QModelIndex &index)
+		{
+			return matchingIdentifiers.contains(index.sibling(index.row(), 0).data(IdentifierRole).toString());
+		});
+	}
+
+	m_ui->entriesViewWidget->setFilterString(filter);
+}
+
 void FeedsContentsWidget::selectCategory()
 {
 	const QToolButton *toolButton(qobject_cast<QToolButton*>(sender()));
@@ -345,8 +366,6 @@ void FeedsContentsWidget::handleFeedModified(const QUrl &url)
 
 		m_updateAnimation->start();
 	}
-
-	m_ui->feedsViewWidget->getViewportWidget()->updateDirtyIndexesList();
 }
 
 void FeedsContentsWidget::showEntriesContextMenu(const QPoint &position)
@@ -445,11 +464,12 @@ void FeedsContentsWidget::updateActions()
 void FeedsContentsWidget::updateEntry()
 {
 	const QModelIndex index(m_ui->entriesViewWidget->currentIndex().sibling(m_ui->entriesViewWidget->currentIndex().row(), 0));
-	QString content(index.data(ContentRole).toString());
+	const Feed::EntryBody body((m_feed && index.isValid()) ? m_feed->getEntryBody(index.data(IdentifierRole).toString()) : Feed::EntryBody());
+	QString content(body.content);
 
-	if (!index.data(SummaryRole).isNull())
+	if (!body.summary.isEmpty())
 	{
-		QString summary(index.data(SummaryRole).toString());
+		QString summary(body.summary);
 
 		if (!summary.contains(QLatin1Char('<')))
 		{
@@ -533,6 +553,8 @@ void FeedsContentsWidget::updateFeedModel()
 
 	const QString identifier(m_ui->entriesViewWidget->currentIndex().data(IdentifierRole).toString());
 
+	filterEntries(m_ui->entriesFilterLineEditWidget->text());
+
 	m_feedModel->clear();
 	m_feedModel->setHorizontalHeaderLabels({tr("Title"), tr("From"), tr("Published")});
 	m_feedModel->setHeaderData(0, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
@@ -667,8 +689,6 @@ void FeedsContentsWidget::updateFeedModel()
 		QList<QStandardItem*> items({new QStandardItem(entry.title.isEmpty() ? tr("(Untitled)") : entry.title), new QStandardItem(entry.author.isEmpty() ? tr("(Untitled)") : entry.author), new QStandardItem(Utils::formatDateTime(entry.updateTime.isNull() ? entry.publicationTime : entry.updateTime))});
 		items[0]->setData(entry.url, UrlRole);
 		items[0]->setData(entry.identifier, IdentifierRole);
-		items[0]->setData(entry.summary, SummaryRole);
-		items[0]->setData(entry.content, ContentRole);
 		items[0]->setData(entry.publicationTime, PublicationTimeRole);
 		items[0]->setData(entry.updateTime, UpdateTimeRole);
 		items[0]->setData(entry.author, AuthorRole);
@@ -61,8 +61,6 @@ public:
 		TitleRole = Qt::DisplayRole,
 		UrlRole = Qt::StatusTipRole,
 		IdentifierRole = Qt::UserRole,
-		SummaryRole,
-		ContentRole,
 		AuthorRole,
 		EmailRole,
 		LastReadTimeRole,
@@ -101,6 +99,7 @@ protected slots:
 	void feedProperties();
 	void openEntry();
 	void removeEntry();
+	void filterEntries(const QString &filter);
 	void selectCategory();
 	void handleFeedModified(const QUrl &url);
 	void showEntriesContextMenu(const QPoint &position);
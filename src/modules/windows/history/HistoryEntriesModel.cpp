@@ -0,0 +1,450 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryEntriesModel.h"
+#include "../../../core/ThemesManager.h"
+#include "../../../core/Utils.h"
+#include "../../../ui/ItemViewWidget.h"
+
+namespace Otter
+{
+
+HistoryEntriesModel::HistoryEntriesModel(HistoryModel *model, QObject *parent) : QAbstractItemModel(parent),
+	m_model(model),
+	m_groups(7)
+{
+	connect(model, &HistoryModel::entryAdded, this, &HistoryEntriesModel::handleEntryAdded);
+	connect(model, &HistoryModel::entryModified, this, &HistoryEntriesModel::handleEntryModified);
+	connect(model, &HistoryModel::entryRemoved, this, &HistoryEntriesModel::handleEntryRemoved);
+}
+
+void HistoryEntriesModel::reload()
+{
+	beginResetModel();
+
+	const QDate date(QDate::currentDate());
+	const QVector<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365)});
+
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		EntriesGroup &group(m_groups[i]);
+
+		group.date = dates.value(i, QDate());
+		group.from = (group.date.isValid() ? QDateTime(group.date, QTime(0, 0), Qt::UTC) : QDateTime());
+		group.to = ((i > 0) ? m_groups.at(i - 1).from : QDateTime());
+		group.entries.clear();
+		group.entries.squeeze();
+		group.amount = m_model->getEntriesAmount(group.from, group.to);
+		group.rowsAmount = 0;
+		group.isPopulated = false;
+	}
+
+	endResetModel();
+}
+
+void HistoryEntriesModel::retranslate()
+{
+	emit headerDataChanged(Qt::Horizontal, 0, (columnCount() - 1));
+	emit dataChanged(index(0, 0), index((m_groups.count() - 1), 0));
+}
+
+void HistoryEntriesModel::fetchAll()
+{
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		populateGroup(i, -1);
+	}
+}
+
+void HistoryEntriesModel::fetchMore(const QModelIndex &parent)
+{
+	if (canFetchMore(parent))
+	{
+		populateGroup(parent.row(), FetchLimit);
+	}
+}
+
+void HistoryEntriesModel::populateGroup(int group, int limit)
+{
+	if (group < 0 || group >= m_groups.count())
+	{
+		return;
+	}
+
+	EntriesGroup &entriesGroup(m_groups[group]);
+
+	if (!entriesGroup.isPopulated)
+	{
+		entriesGroup.entries = m_model->getEntries(entriesGroup.from, entriesGroup.to);
+		entriesGroup.amount = entriesGroup.entries.count();
+		entriesGroup.isPopulated = true;
+	}
+
+	const int amount((limit < 0) ? (entriesGroup.amount - entriesGroup.rowsAmount) : qMin(limit, (entriesGroup.amount - entriesGroup.rowsAmount)));
+
+	if (amount <= 0)
+	{
+		return;
+	}
+
+	beginInsertRows(index(group, 0), entriesGroup.rowsAmount, (entriesGroup.rowsAmount + amount - 1));
+
+	entriesGroup.rowsAmount += amount;
+
+	endInsertRows();
+}
+
+void HistoryEntriesModel::handleEntryAdded(const HistoryModel::Entry &entry)
+{
+	const int group(getGroup(entry.getTimeVisited()));
+
+	if (entry.getIdentifier() == 0 || group < 0)
+	{
+		return;
+	}
+
+	EntriesGroup &entriesGroup(m_groups[group]);
+
+	if (!entriesGroup.isPopulated)
+	{
+		if (entriesGroup.amount > 0)
+		{
+			++entriesGroup.amount;
+
+			return;
+		}
+
+		entriesGroup.isPopulated = true;
+	}
+
+	if (entriesGroup.entries.contains(entry.getIdentifier()))
+	{
+		return;
+	}
+
+	const int row(findRow(group, entry.getTimeVisited()));
+	const bool isFetched(row < entriesGroup.rowsAmount || entriesGroup.rowsAmount == entriesGroup.amount);
+
+	if (isFetched)
+	{
+		beginInsertRows(index(group, 0), row, row);
+	}
+
+	entriesGroup.entries.insert(row, entry.getIdentifier());
+
+	++entriesGroup.amount;
+
+	if (isFetched)
+	{
+		++entriesGroup.rowsAmount;
+
+		endInsertRows();
+	}
+}
+
+void HistoryEntriesModel::handleEntryModified(const HistoryModel::Entry &entry)
+{
+	const int group(getGroup(entry.getTimeVisited()));
+
+	if (entry.getIdentifier() == 0 || group < 0 || !m_groups.at(group).isPopulated)
+	{
+		return;
+	}
+
+	const int row(m_groups.at(group).entries.indexOf(entry.getIdentifier()));
+
+	if (row < 0)
+	{
+		handleEntryAdded(entry);
+	}
+	else if (row < m_groups.at(group).rowsAmount)
+	{
+		const QModelIndex parent(index(group, 0));
+
+		emit dataChanged(index(row, 0, parent), index(row, (columnCount() - 1), parent));
+	}
+}
+
+void HistoryEntriesModel::handleEntryRemoved(const HistoryModel::Entry &entry)
+{
+	const int group(getGroup(entry.getTimeVisited()));
+
+	if (entry.getIdentifier() == 0 || group < 0)
+	{
+		return;
+	}
+
+	EntriesGroup &entriesGroup(m_groups[group]);
+
+	if (!entriesGroup.isPopulated)
+	{
+		if (entriesGroup.amount > 0)
+		{
+			--entriesGroup.amount;
+
+			if (entriesGroup.amount == 0)
+			{
+				const QModelIndex groupIndex(index(group, 0));
+
+				emit dataChanged(groupIndex, groupIndex);
+			}
+		}
+
+		return;
+	}
+
+	const int row(entriesGroup.entries.indexOf(entry.getIdentifier()));
+
+	if (row < 0)
+	{
+		return;
+	}
+
+	const bool isFetched(row < entriesGroup.rowsAmount);
+
+	if (isFetched)
+	{
+		beginRemoveRows(index(group, 0), row, row);
+	}
+
+	entriesGroup.entries.remove(row);
+
+	--entriesGroup.amount;
+
+	if (isFetched)
+	{
+		--entriesGroup.rowsAmount;
+
+		endRemoveRows();
+	}
+}
+
+QModelIndex HistoryEntriesModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (!hasIndex(row, column, parent))
+	{
+		return {};
+	}
+
+	return createIndex(row, column, (parent.isValid() ? static_cast<quintptr>(parent.row() + 1) : 0));
+}
+
+QModelIndex HistoryEntriesModel::parent(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return {};
+	}
+
+	return createIndex(static_cast<int>(index.internalId() - 1), 0, static_cast<quintptr>(0));
+}
+
+QVariant HistoryEntriesModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return {};
+	}
+
+	if (index.internalId() == 0)
+	{
+		if (index.column() != 0)
+		{
+			return {};
+		}
+
+		switch (role)
+		{
+			case Qt::DisplayRole:
+				{
+					const QStringList titles({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
+
+					return titles.value(index.row());
+				}
+			case Qt::DecorationRole:
+				return ThemesManager::createIcon(QLatin1String("inode-directory"));
+			case GroupDateRole:
+				return m_groups.value(index.row()).date;
+			default:
+				break;
+		}
+
+		return {};
+	}
+
+	const quint64 identifier(m_groups.value(static_cast<int>(index.internalId() - 1)).entries.value(index.row()));
+	const HistoryModel::Entry entry(m_model->getEntry(identifier));
+
+	if (!entry.isValid())
+	{
+		return {};
+	}
+
+	switch (index.column())
+	{
+		case 0:
+			switch (role)
+			{
+				case Qt::DisplayRole:
+					return entry.getUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')));
+				case Qt::DecorationRole:
+					return entry.getIcon();
+				case IdentifierRole:
+					return identifier;
+				default:
+					break;
+			}
+
+			break;
+		case 1:
+			if (role == Qt::DisplayRole)
+			{
+				return entry.getTitle();
+			}
+
+			break;
+		case 2:
+			switch (role)
+			{
+				case Qt::DisplayRole:
+					return Utils::formatDateTime(entry.getTimeVisited());
+				case Qt::ToolTipRole:
+					return Utils::formatDateTime(entry.getTimeVisited(), {}, false);
+				case TimeVisitedRole:
+					return entry.getTimeVisited();
+				default:
+					break;
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return {};
+}
+
+QVariant HistoryEntriesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal)
+	{
+		switch (role)
+		{
+			case Qt::DisplayRole:
+				{
+					const QStringList titles({tr("Address"), tr("Title"), tr("Date")});
+
+					return titles.value(section);
+				}
+			case HeaderViewWidget::WidthRole:
+				if (section < 2)
+				{
+					return 300;
+				}
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags HistoryEntriesModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
+
+	return ((index.internalId() == 0) ? (Qt::ItemIsEnabled | Qt::ItemIsSelectable) : (Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren));
+}
+
+int HistoryEntriesModel::columnCount(const QModelIndex &index) const
+{
+	Q_UNUSED(index)
+
+	return 3;
+}
+
+int HistoryEntriesModel::rowCount(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return m_groups.count();
+	}
+
+	if (index.internalId() == 0 && index.column() == 0)
+	{
+		return m_groups.value(index.row()).rowsAmount;
+	}
+
+	return 0;
+}
+
+bool HistoryEntriesModel::canFetchMore(const QModelIndex &parent) const
+{
+	if (!parent.isValid() || parent.internalId() != 0 || parent.column() != 0 || parent.row() >= m_groups.count())
+	{
+		return false;
+	}
+
+	const EntriesGroup &group(m_groups.at(parent.row()));
+
+	return (group.rowsAmount < group.amount);
+}
+
+bool HistoryEntriesModel::hasChildren(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return !m_groups.isEmpty();
+	}
+
+	return (parent.internalId() == 0 && parent.column() == 0 && m_groups.value(parent.row()).amount > 0);
+}
+
+int HistoryEntriesModel::getGroup(const QDateTime &dateTime) const
+{
+	const QDate date(dateTime.date());
+
+	for (int i = 0; i < m_groups.count(); ++i)
+	{
+		if (!m_groups.at(i).date.isValid() || date >= m_groups.at(i).date)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int HistoryEntriesModel::findRow(int group, const QDateTime &dateTime) const
+{
+	const QVector<quint64> &entries(m_groups.at(group).entries);
+	const qint64 time(dateTime.toMSecsSinceEpoch());
+
+	return static_cast<int>(std::lower_bound(entries.constBegin(), entries.constEnd(), time, [&](quint64 identifier, qint64 referenceTime)
+	{
+		return (m_model->getEntry(identifier).getTimeVisited().toMSecsSinceEpoch() > referenceTime);
+	}) - entries.constBegin());
+}
+
+}
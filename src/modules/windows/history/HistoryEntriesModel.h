@@ -0,0 +1,91 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYENTRIESMODEL_H
+#define OTTER_HISTORYENTRIESMODEL_H
+
+#include "../../../core/HistoryModel.h"
+
+#include <QtCore/QAbstractItemModel>
+
+namespace Otter
+{
+
+class HistoryEntriesModel final : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	enum DataRole
+	{
+		IdentifierRole = Qt::UserRole,
+		TimeVisitedRole,
+		GroupDateRole
+	};
+
+	explicit HistoryEntriesModel(HistoryModel *model, QObject *parent = nullptr);
+
+	void reload();
+	void retranslate();
+	void fetchAll();
+	void fetchMore(const QModelIndex &parent) override;
+	QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+	QModelIndex parent(const QModelIndex &index) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex &index) const override;
+	int columnCount(const QModelIndex &index = {}) const override;
+	int rowCount(const QModelIndex &index = {}) const override;
+	bool canFetchMore(const QModelIndex &parent) const override;
+	bool hasChildren(const QModelIndex &parent = {}) const override;
+
+protected:
+	enum FetchParameter
+	{
+		FetchLimit = 500
+	};
+
+	struct EntriesGroup final
+	{
+		QDate date;
+		QDateTime from;
+		QDateTime to;
+		QVector<quint64> entries;
+		int amount = 0;
+		int rowsAmount = 0;
+		bool isPopulated = false;
+	};
+
+	void populateGroup(int group, int limit);
+	int getGroup(const QDateTime &dateTime) const;
+	int findRow(int group, const QDateTime &dateTime) const;
+
+protected slots:
+	void handleEntryAdded(const HistoryModel::Entry &entry);
+	void handleEntryModified(const HistoryModel::Entry &entry);
+	void handleEntryRemoved(const HistoryModel::Entry &entry);
+
+private:
+	HistoryModel *m_model;
+	QVector<EntriesGroup> m_groups;
+};
+
+}
+
+#endif
@@ -20,7 +20,6 @@
 #include "LinksContentsWidget.h"
 #include "../../../core/Application.h"
 #include "../../../core/BookmarksManager.h"
-#include "../../../core/ItemModel.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../ui/Action.h"
 #include "../../../ui/MainWindow.h"
@@ -36,13 +35,15 @@ namespace Otter
 {
 
 LinksContentsWidget::LinksContentsWidget(const QVariantMap &parameters, QWidget *parent) : ActiveWindowObserverContentsWidget(parameters, nullptr, parent),
+	m_model(new LinksModel(this)),
+	m_updateTimer(0),
 	m_isLocked(false),
 	m_ui(new Ui::LinksContentsWidget)
 {
 	m_ui->setupUi(this);
 	m_ui->filterLineEditWidget->setClearOnEscape(true);
 	m_ui->linksViewWidget->setViewMode(ItemViewWidget::TreeView);
-	m_ui->linksViewWidget->setModel(new QStandardItemModel(this));
+	m_ui->linksViewWidget->setModel(m_model);
 	m_ui->linksViewWidget->setFilterRoles({Qt::DisplayRole, Qt::StatusTipRole});
 	m_ui->linksViewWidget->viewport()->installEventFilter(this);
 	m_ui->linksViewWidget->viewport()->setMouseTracking(true);
@@ -51,7 +52,7 @@ LinksContentsWidget::LinksContentsWidget(const QVariantMap &parameters, QWidget
 	{
 		if (previousWindow)
 		{
-			disconnect(previousWindow, &Window::loadingStateChanged, this, &LinksContentsWidget::updateLinks);
+			disconnect(previousWindow, &Window::loadingStateChanged, this, &LinksContentsWidget::scheduleLinksUpdate);
 
 			if (previousWindow->getWebWidget())
 			{
@@ -63,7 +64,7 @@ LinksContentsWidget::LinksContentsWidget(const QVariantMap &parameters, QWidget
 
 		if (window)
 		{
-			connect(window, &Window::loadingStateChanged, this, &LinksContentsWidget::updateLinks);
+			connect(window, &Window::loadingStateChanged, this, &LinksContentsWidget::scheduleLinksUpdate);
 
 			if (window->getWebWidget())
 			{
@@ -100,6 +101,22 @@ LinksContentsWidget::~LinksContentsWidget()
 	delete m_ui;
 }
 
+void LinksContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+
+		updateLinks();
+	}
+	else
+	{
+		ContentsWidget::timerEvent(event);
+	}
+}
+
 void LinksContentsWidget::changeEvent(QEvent *event)
 {
 	ContentsWidget::changeEvent(event);
@@ -159,14 +176,6 @@ void LinksContentsWidget::triggerAction(int identifier, const QVariantMap &param
 	}
 }
 
-void LinksContentsWidget::addLink(const QString &title, const QUrl &url)
-{
-	QStandardItem *item(new QStandardItem(title.isEmpty() ? url.toDisplayString(QUrl::RemovePassword) : title));
-	item->setData(url, Qt::StatusTipRole);
-
-	m_ui->linksViewWidget->getSourceModel()->appendRow(item);
-}
-
 void LinksContentsWidget::openLink()
 {
 	const QAction *action(qobject_cast<QAction*>(sender()));
@@ -186,7 +195,15 @@ void LinksContentsWidget::handleWatchedDataChanged(WebWidget::ChangeWatcher watc
 {
 	if (watcher == WebWidget::LinksWatcher)
 	{
-		updateLinks();
+		scheduleLinksUpdate();
+	}
+}
+
+void LinksContentsWidget::scheduleLinksUpdate()
+{
+	if (m_updateTimer == 0 && !m_isLocked)
+	{
+		m_updateTimer = startTimer(UpdateInterval);
 	}
 }
 
@@ -197,27 +214,16 @@ void LinksContentsWidget::updateLinks()
 		return;
 	}
 
-	m_ui->linksViewWidget->getSourceModel()->clear();
-
 	Window *window(getActiveWindow());
 
 	if (window && window->getWebWidget())
 	{
-		const QVector<WebWidget::LinkUrl> links(window->getWebWidget()->getLinks());
-
-		addLink(window->getTitle(), window->getUrl());
-
-		if (!links.isEmpty())
-		{
-			m_ui->linksViewWidget->getSourceModel()->appendRow(new ItemModel::Item(ItemModel::SeparatorType));
-
-			for (int i = 0; i < links.count(); ++i)
-			{
-				addLink(links.at(i).title, links.at(i).url);
-			}
-		}
-
-		m_ui->linksViewWidget->expandAll();
+		m_model->setPage(window->getTitle(), window->getUrl());
+		m_model->setLinks(window->getWebWidget()->getLinks());
+	}
+	else
+	{
+		m_model->clear();
 	}
 }
 
@@ -20,10 +20,9 @@
 #ifndef OTTER_LINKSCONTENTSWIDGET_H
 #define OTTER_LINKSCONTENTSWIDGET_H
 
+#include "LinksModel.h"
 #include "../../../ui/ContentsWidget.h"
 
-#include <QtGui/QStandardItem>
-
 namespace Otter
 {
 
@@ -53,8 +52,14 @@ public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
 
 protected:
+	enum UpdateParameter
+	{
+		UpdateInterval = 100
+	};
+
+	void timerEvent(QTimerEvent *event) override;
 	void changeEvent(QEvent *event) override;
-	void addLink(const QString &title, const QUrl &url);
+	void scheduleLinksUpdate();
 	void updateLinks();
 
 protected slots:
@@ -63,6 +68,8 @@ protected slots:
 	void showContextMenu(const QPoint &position);
 
 private:
+	LinksModel *m_model;
+	int m_updateTimer;
 	bool m_isLocked;
 	Ui::LinksContentsWidget *m_ui;
 };
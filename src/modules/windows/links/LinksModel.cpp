@@ -0,0 +1,234 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "LinksModel.h"
+
+namespace Otter
+{
+
+LinksModel::LinksModel(QObject *parent) : QAbstractListModel(parent),
+	m_hasPage(false)
+{
+}
+
+void LinksModel::clear()
+{
+	beginResetModel();
+
+	m_page = {};
+	m_hasPage = false;
+
+	m_links.clear();
+	m_positions.clear();
+
+	endResetModel();
+}
+
+void LinksModel::setPage(const QString &title, const QUrl &url)
+{
+	if (m_hasPage && url == m_page.url)
+	{
+		if (title != m_page.title)
+		{
+			m_page.title = title;
+
+			emit dataChanged(index(0, 0), index(0, 0));
+		}
+
+		return;
+	}
+
+	beginResetModel();
+
+	m_page.title = title;
+	m_page.url = url;
+	m_hasPage = true;
+
+	m_links.clear();
+	m_positions.clear();
+
+	endResetModel();
+}
+
+void LinksModel::setLinks(const QVector<WebWidget::LinkUrl> &links)
+{
+	if (!m_hasPage)
+	{
+		return;
+	}
+
+	QHash<QUrl, int> positions;
+	positions.reserve(links.count());
+
+	for (int i = 0; i < links.count(); ++i)
+	{
+		if (!positions.contains(links.at(i).url))
+		{
+			positions.insert(links.at(i).url, i);
+		}
+	}
+
+	int last(m_links.count() - 1);
+
+	while (last >= 0)
+	{
+		if (positions.contains(m_links.at(last).url))
+		{
+			--last;
+
+			continue;
+		}
+
+		int first(last);
+
+		while (first > 0 && !positions.contains(m_links.at(first - 1).url))
+		{
+			--first;
+		}
+
+		const bool isRemovingAll(first == 0 && last == (m_links.count() - 1));
+
+		beginRemoveRows({}, (isRemovingAll ? SeparatorRow : (first + FirstLinkRow)), (last + FirstLinkRow));
+
+		m_links.remove(first, (last - first + 1));
+
+		endRemoveRows();
+
+		last = (first - 1);
+	}
+
+	m_positions.clear();
+	m_positions.reserve(m_links.count());
+
+	for (int i = 0; i < m_links.count(); ++i)
+	{
+		m_positions.insert(m_links.at(i).url, i);
+	}
+
+	QVector<WebWidget::LinkUrl> addedLinks;
+	int firstModifiedRow(-1);
+	int lastModifiedRow(-1);
+
+	for (int i = 0; i < links.count(); ++i)
+	{
+		const WebWidget::LinkUrl &link(links.at(i));
+
+		if (positions.value(link.url) != i)
+		{
+			continue;
+		}
+
+		const QHash<QUrl, int>::const_iterator iterator(m_positions.constFind(link.url));
+
+		if (iterator == m_positions.constEnd())
+		{
+			addedLinks.append(link);
+
+			continue;
+		}
+
+		WebWidget::LinkUrl &existingLink(m_links[iterator.value()]);
+
+		if (existingLink.title != link.title || existingLink.mimeType != link.mimeType)
+		{
+			const int row(iterator.value() + FirstLinkRow);
+
+			existingLink = link;
+
+			firstModifiedRow = ((firstModifiedRow < 0) ? row : qMin(firstModifiedRow, row));
+			lastModifiedRow = qMax(lastModifiedRow, row);
+		}
+	}
+
+	if (firstModifiedRow >= 0)
+	{
+		emit dataChanged(index(firstModifiedRow, 0), index(lastModifiedRow, 0));
+	}
+
+	if (addedLinks.isEmpty())
+	{
+		return;
+	}
+
+	beginInsertRows({}, (m_links.isEmpty() ? SeparatorRow : (m_links.count() + FirstLinkRow)), (m_links.count() + FirstLinkRow + addedLinks.count() - 1));
+
+	m_links.reserve(m_links.count() + addedLinks.count());
+
+	for (int i = 0; i < addedLinks.count(); ++i)
+	{
+		m_positions.insert(addedLinks.at(i).url, m_links.count());
+		m_links.append(addedLinks.at(i));
+	}
+
+	endInsertRows();
+}
+
+QVariant LinksModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.column() != 0 || index.row() >= rowCount())
+	{
+		return {};
+	}
+
+	if (index.row() == SeparatorRow)
+	{
+		return ((role == Qt::AccessibleDescriptionRole) ? QVariant(QLatin1String("separator")) : QVariant());
+	}
+
+	const WebWidget::LinkUrl &link((index.row() == 0) ? m_page : m_links.at(index.row() - FirstLinkRow));
+
+	switch (role)
+	{
+		case Qt::DisplayRole:
+			return (link.title.isEmpty() ? link.url.toDisplayString(QUrl::RemovePassword) : link.title);
+		case Qt::StatusTipRole:
+			return link.url;
+		default:
+			break;
+	}
+
+	return {};
+}
+
+Qt::ItemFlags LinksModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
+
+	if (index.row() == SeparatorRow)
+	{
+		return (Qt::ItemIsEnabled | Qt::ItemNeverHasChildren);
+	}
+
+	return (Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren);
+}
+
+int LinksModel::rowCount(const QModelIndex &index) const
+{
+	if (index.isValid() || !m_hasPage)
+	{
+		return 0;
+	}
+
+	return (m_links.isEmpty() ? 1 : (m_links.count() + FirstLinkRow));
+}
+
+}
@@ -0,0 +1,60 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_LINKSMODEL_H
+#define OTTER_LINKSMODEL_H
+
+#include "../../../ui/WebWidget.h"
+
+#include <QtCore/QAbstractListModel>
+
+namespace Otter
+{
+
+class LinksModel final : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	explicit LinksModel(QObject *parent = nullptr);
+
+	void clear();
+	void setPage(const QString &title, const QUrl &url);
+	void setLinks(const QVector<WebWidget::LinkUrl> &links);
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex &index) const override;
+	int rowCount(const QModelIndex &index = {}) const override;
+
+protected:
+	enum RowParameter
+	{
+		SeparatorRow = 1,
+		FirstLinkRow = 2
+	};
+
+private:
+	WebWidget::LinkUrl m_page;
+	QVector<WebWidget::LinkUrl> m_links;
+	QHash<QUrl, int> m_positions;
+	bool m_hasPage;
+};
+
+}
+
+#endif
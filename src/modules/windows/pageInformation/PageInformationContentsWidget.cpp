@@ -18,7 +18,9 @@
 **************************************************************************/
 
 #include "PageInformationContentsWidget.h"
+#include "../../../core/NetworkManager.h"
 #include "../../../core/ThemesManager.h"
+#include "../../../core/Utils.h"
 #include "../../../ui/Action.h"
 #include "../../../ui/MainWindow.h"
 #include "../../../ui/Window.h"
@@ -26,6 +28,7 @@
 #include "ui_PageInformationContentsWidget.h"
 
 #include <QtGui/QClipboard>
+#include <QtWidgets/QMessageBox>
 
 namespace Otter
 {
@@ -36,7 +39,7 @@ PageInformationContentsWidget::PageInformationContentsWidget(const QVariantMap &
 	m_ui->setupUi(this);
 	m_ui->filterLineEditWidget->setClearOnEscape(true);
 
-	const QVector<SectionName> sections({GeneralSection, SecuritySection, PermissionsSection, MetaSection, HeadersSection});
+	const QVector<SectionName> sections({GeneralSection, SecuritySection, PermissionsSection, MetaSection, HeadersSection, RequestsSection});
 	QStandardItemModel *model(new QStandardItemModel(this));
 	model->setHorizontalHeaderLabels({tr("Name"), tr("Value")});
 
@@ -219,6 +222,58 @@ void PageInformationContentsWidget::updateSections()
 			case PermissionsSection:
 				m_ui->informationViewWidget->setData(index, tr("Permissions"), Qt::DisplayRole);
 
+				break;
+			case RequestsSection:
+				m_ui->informationViewWidget->setData(index, tr("Requests"), Qt::DisplayRole);
+
+				if (sectionItem && window && window->getWebWidget())
+				{
+					const QVector<NetworkManager::RequestTiming> timings(window->getWebWidget()->getRequestTimings());
+
+					for (int j = 0; j < timings.count(); ++j)
+					{
+						const NetworkManager::RequestTiming &timing(timings.at(j));
+						QStringList details;
+
+						if (timing.isBlocked)
+						{
+							details.append(tr("Blocked"));
+						}
+						else if (timing.finishedTime < 0)
+						{
+							details.append(tr("Pending"));
+						}
+						else
+						{
+							if (timing.statusCode > 0)
+							{
+								details.append(QString::number(timing.statusCode));
+							}
+
+							details.append(tr("%1 ms").arg(timing.getDuration()));
+
+							if (timing.firstByteTime >= timing.startTime)
+							{
+								details.append(tr("first byte after %1 ms").arg(timing.firstByteTime - timing.startTime));
+							}
+
+							if (timing.encryptedTime >= timing.startTime)
+							{
+								details.append(tr("secure connection after %1 ms").arg(timing.encryptedTime - timing.startTime));
+							}
+
+							details.append(Utils::formatUnit(timing.bytesReceived, false, 1));
+
+							if (timing.isCached)
+							{
+								details.append(tr("from cache"));
+							}
+						}
+
+						addEntry(sectionItem, timing.url.toDisplayString(), details.join(QLatin1String(", ")));
+					}
+				}
+
 				break;
 			case SecuritySection:
 				m_ui->informationViewWidget->setData(index, tr("Security"), Qt::DisplayRole);
@@ -253,6 +308,23 @@ void PageInformationContentsWidget::handleWatchedDataChanged(WebWidget::ChangeWa
 	}
 }
 
+void PageInformationContentsWidget::exportRequestTimings()
+{
+	Window *window(getActiveWindow());
+
+	if (!window || !window->getWebWidget())
+	{
+		return;
+	}
+
+	const QString path(Utils::getSavePath(QLatin1String("requests.har"), {}, {tr("HTTP Archive files (*.har)")}).path);
+
+	if (!path.isEmpty() && !NetworkManager::exportRequestTimings(window->getWebWidget()->getRequestTimings(), path, window->getTitle()))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Failed to open file for writing."), QMessageBox::Close);
+	}
+}
+
 void PageInformationContentsWidget::showContextMenu(const QPoint &position)
 {
 	const QModelIndex index(m_ui->informationViewWidget->indexAt(position));
@@ -261,6 +333,15 @@ void PageInformationContentsWidget::showContextMenu(const QPoint &position)
 	{
 		QMenu menu(this);
 		menu.addAction(new Action(ActionsManager::CopyAction, {}, ActionExecutor::Object(this, this), &menu));
+
+		const QModelIndex sectionIndex(index.parent().isValid() ? index.parent() : index.sibling(index.row(), 0));
+
+		if (static_cast<SectionName>(sectionIndex.data(Qt::UserRole).toInt()) == RequestsSection)
+		{
+			menu.addSeparator();
+			menu.addAction(tr("Export as HAR…"), this, &PageInformationContentsWidget::exportRequestTimings);
+		}
+
 		menu.exec(m_ui->informationViewWidget->mapToGlobal(position));
 	}
 }
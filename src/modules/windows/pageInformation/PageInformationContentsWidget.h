@@ -46,6 +46,7 @@ public:
 		HeadersSection,
 		MetaSection,
 		PermissionsSection,
+		RequestsSection,
 		SecuritySection
 	};
 
@@ -68,6 +69,7 @@ protected:
 
 protected slots:
 	void handleWatchedDataChanged(WebWidget::ChangeWatcher watcher);
+	void exportRequestTimings();
 	void showContextMenu(const QPoint &position);
 
 private:
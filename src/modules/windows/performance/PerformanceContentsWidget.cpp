@@ -0,0 +1,370 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PerformanceContentsWidget.h"
+#include "../../../core/Application.h"
+#include "../../../core/ContentFiltersManager.h"
+#include "../../../core/EventLoopWatchdog.h"
+#include "../../../core/NetworkCache.h"
+#include "../../../core/NetworkManagerFactory.h"
+#include "../../../core/PlatformIntegration.h"
+#include "../../../core/ThemesManager.h"
+#include "../../../core/UserScript.h"
+#include "../../../core/Utils.h"
+#include "../../../ui/MainWindow.h"
+#include "../../../ui/Window.h"
+
+#include "ui_PerformanceContentsWidget.h"
+
+namespace Otter
+{
+
+PerformanceContentsWidget::PerformanceContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
+	m_tabsModel(new QStandardItemModel(this)),
+	m_cachesModel(new QStandardItemModel(this)),
+	m_updateTimer(0),
+	m_ui(new Ui::PerformanceContentsWidget)
+{
+	m_ui->setupUi(this);
+	m_ui->filterLineEditWidget->setClearOnEscape(true);
+	m_ui->tabsViewWidget->setViewMode(ItemViewWidget::ListView);
+	m_ui->tabsViewWidget->setModel(m_tabsModel, true);
+	m_ui->tabsViewWidget->setFilterRoles({Qt::DisplayRole, Qt::ToolTipRole});
+	m_ui->cachesViewWidget->setViewMode(ItemViewWidget::ListView);
+	m_ui->cachesViewWidget->setModel(m_cachesModel);
+
+	m_tabsModel->setHorizontalHeaderLabels({tr("Title"), tr("State"), tr("Memory"), tr("Received"), tr("Requests"), tr("Blocked"), tr("Content Filters")});
+	m_tabsModel->setHeaderData(0, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
+	m_cachesModel->setHorizontalHeaderLabels({tr("Cache"), tr("Entries"), tr("Limit"), tr("Hits"), tr("Misses"), tr("Time")});
+	m_cachesModel->setHeaderData(0, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
+
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->tabsViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_ui->tabsViewWidget, &ItemViewWidget::doubleClicked, this, &PerformanceContentsWidget::activateTab);
+}
+
+PerformanceContentsWidget::~PerformanceContentsWidget()
+{
+	delete m_ui;
+}
+
+void PerformanceContentsWidget::changeEvent(QEvent *event)
+{
+	ContentsWidget::changeEvent(event);
+
+	if (event->type() == QEvent::LanguageChange)
+	{
+		m_ui->retranslateUi(this);
+
+		m_tabsModel->setHorizontalHeaderLabels({tr("Title"), tr("State"), tr("Memory"), tr("Received"), tr("Requests"), tr("Blocked"), tr("Content Filters")});
+		m_cachesModel->setHorizontalHeaderLabels({tr("Cache"), tr("Entries"), tr("Limit"), tr("Hits"), tr("Misses"), tr("Time")});
+
+		updateTabs();
+		updateCaches();
+	}
+}
+
+void PerformanceContentsWidget::showEvent(QShowEvent *event)
+{
+	ContentsWidget::showEvent(event);
+
+	updateTabs();
+	updateCaches();
+
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(UpdateInterval);
+	}
+}
+
+void PerformanceContentsWidget::hideEvent(QHideEvent *event)
+{
+	ContentsWidget::hideEvent(event);
+
+	if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+}
+
+void PerformanceContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer)
+	{
+		updateTabs();
+		updateCaches();
+	}
+	else
+	{
+		ContentsWidget::timerEvent(event);
+	}
+}
+
+void PerformanceContentsWidget::print(QPrinter *printer)
+{
+	m_ui->tabsViewWidget->render(printer);
+}
+
+void PerformanceContentsWidget::triggerAction(int identifier, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
+{
+	switch (identifier)
+	{
+		case ActionsManager::FindAction:
+		case ActionsManager::QuickFindAction:
+			m_ui->filterLineEditWidget->setFocus();
+
+			break;
+		case ActionsManager::ActivateContentAction:
+			m_ui->tabsViewWidget->setFocus();
+
+			break;
+		case ActionsManager::ReloadAction:
+			updateTabs();
+			updateCaches();
+
+			break;
+		default:
+			ContentsWidget::triggerAction(identifier, parameters, trigger);
+
+			break;
+	}
+}
+
+void PerformanceContentsWidget::updateTabs()
+{
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+	const PlatformIntegration *platformIntegration(Application::getPlatformIntegration());
+	const quint64 usage(platformIntegration ? platformIntegration->getResidentMemorySize() : 0);
+	int loadedAmount(0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		for (int j = 0; j < mainWindows.at(i)->getWindowCount(); ++j)
+		{
+			const Window *window(mainWindows.at(i)->getWindowByIndex(j));
+
+			if (window && window->getLoadingState() != WebWidget::DeferredLoadingState)
+			{
+				++loadedAmount;
+			}
+		}
+	}
+
+	const quint64 windowUsage(usage / static_cast<quint64>(qMax(1, loadedAmount)));
+
+	if (usage > 0)
+	{
+		m_ui->memoryLabel->setText(tr("Resident memory: %1 (%2 loaded tabs, around %3 each)").arg(Utils::formatUnit(static_cast<qint64>(usage))).arg(loadedAmount).arg(Utils::formatUnit(static_cast<qint64>(windowUsage))));
+	}
+	else
+	{
+		m_ui->memoryLabel->setText(tr("Resident memory: unknown"));
+	}
+
+	int row(0);
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		MainWindow *mainWindow(mainWindows.at(i));
+
+		for (int j = 0; j < mainWindow->getWindowCount(); ++j)
+		{
+			Window *window(mainWindow->getWindowByIndex(j));
+
+			if (!window)
+			{
+				continue;
+			}
+
+			const WebWidget::LoadingState loadingState(window->getLoadingState());
+			const WebWidget *webWidget((loadingState == WebWidget::DeferredLoadingState) ? nullptr : window->getContentsWidget()->getWebWidget());
+			QString state;
+
+			switch (loadingState)
+			{
+				case WebWidget::DeferredLoadingState:
+					state = (window->isSuspended() ? tr("Suspended") : tr("Deferred"));
+
+					break;
+				case WebWidget::OngoingLoadingState:
+					state = tr("Loading");
+
+					break;
+				case WebWidget::CrashedLoadingState:
+					state = tr("Crashed");
+
+					break;
+				default:
+					state = tr("Loaded");
+
+					break;
+			}
+
+			QList<QStandardItem*> items({new QStandardItem(window->getIcon(), window->getTitle()), new QStandardItem(state), new QStandardItem(), new QStandardItem(), new QStandardItem(), new QStandardItem(), new QStandardItem()});
+			items[0]->setData(mainWindow->getIdentifier(), MainWindowRole);
+			items[0]->setData(window->getIdentifier(), WindowRole);
+			items[0]->setToolTip(window->getUrl().toDisplayString());
+
+			if (loadingState != WebWidget::DeferredLoadingState)
+			{
+				items[2]->setText(QLatin1String("~") + Utils::formatUnit(static_cast<qint64>(windowUsage)));
+			}
+
+			if (webWidget)
+			{
+				const QVariant contentFilteringTime(webWidget->getPageInformation(WebWidget::ContentFilteringTimeInformation));
+
+				items[3]->setText(Utils::formatUnit(webWidget->getPageInformation(WebWidget::TotalBytesReceivedInformation).toLongLong()));
+				items[4]->setText(QString::number(webWidget->getPageInformation(WebWidget::RequestsStartedInformation).toInt()));
+				items[5]->setText(QString::number(webWidget->getPageInformation(WebWidget::RequestsBlockedInformation).toInt()));
+
+				if (contentFilteringTime.isValid())
+				{
+					items[6]->setText(formatTime(contentFilteringTime.toULongLong()));
+				}
+			}
+
+			for (int k = 0; k < items.count(); ++k)
+			{
+				items[k]->setFlags(items[k]->flags() | Qt::ItemNeverHasChildren);
+			}
+
+			if (row < m_tabsModel->rowCount())
+			{
+				for (int k = 0; k < items.count(); ++k)
+				{
+					m_tabsModel->setItem(row, k, items.at(k));
+				}
+			}
+			else
+			{
+				m_tabsModel->appendRow(items);
+			}
+
+			++row;
+		}
+	}
+
+	if (row < m_tabsModel->rowCount())
+	{
+		m_tabsModel->removeRows(row, (m_tabsModel->rowCount() - row));
+	}
+}
+
+void PerformanceContentsWidget::updateCaches()
+{
+	const ContentFiltersManager::ResultsCacheStatistics contentFiltersStatistics(ContentFiltersManager::getResultsCacheStatistics());
+	const ThemesManager::IconsCacheStatistics iconsStatistics(ThemesManager::getIconsCacheStatistics());
+	const UserScript::CachesStatistics userScriptsStatistics(UserScript::getCachesStatistics());
+	const NetworkCache::LookupStatistics networkCacheLookupStatistics(NetworkManagerFactory::getCache()->getLookupStatistics());
+	const NetworkCache::MemoryTierStatistics networkCacheStatistics(NetworkManagerFactory::getCache()->getMemoryTierStatistics());
+
+	m_cachesModel->removeRows(0, m_cachesModel->rowCount());
+
+	addCacheRow(tr("Content filters results"), contentFiltersStatistics.amount, contentFiltersStatistics.limit, QString::number(contentFiltersStatistics.hits), QString::number(contentFiltersStatistics.misses), formatTime(contentFiltersStatistics.matchingTime));
+	addCacheRow(tr("Theme icons"), iconsStatistics.iconsAmount, -1);
+	addCacheRow(tr("Data URI icons"), iconsStatistics.dataUriIconsAmount, iconsStatistics.dataUriIconsLimit);
+	addCacheRow(tr("User scripts per URL"), userScriptsStatistics.urlsAmount, userScriptsStatistics.urlsLimit, {}, {}, formatTime(userScriptsStatistics.resolvingTime));
+	addCacheRow(tr("User scripts bundles"), userScriptsStatistics.bundlesAmount, userScriptsStatistics.bundlesLimit);
+	addCacheRow(tr("Network cache lookups (%1 normalized keys, %2 hits thanks to normalization)").arg(networkCacheLookupStatistics.normalizedKeys).arg(networkCacheLookupStatistics.normalizedHits), NetworkManagerFactory::getCache()->getEntriesAmount(), -1, QString::number(networkCacheLookupStatistics.hits), QString::number(networkCacheLookupStatistics.misses));
+	addCacheRow(tr("Network cache memory tier (%1 of %2)").arg(Utils::formatUnit(networkCacheStatistics.size), Utils::formatUnit(networkCacheStatistics.limit)), networkCacheStatistics.amount, -1, QString::number(networkCacheStatistics.hits), QString::number(networkCacheStatistics.misses));
+
+	updateStalls();
+}
+
+void PerformanceContentsWidget::updateStalls()
+{
+	if (!EventLoopWatchdog::isEnabled())
+	{
+		m_ui->stallsLabel->setText(tr("Event loop stalls: watchdog disabled"));
+
+		return;
+	}
+
+	const EventLoopWatchdog::StallsStatistics statistics(EventLoopWatchdog::getStallsStatistics());
+	const QVector<int> bounds(EventLoopWatchdog::getHistogramBounds());
+	QStringList buckets;
+	buckets.reserve(statistics.histogram.count());
+
+	for (int i = 0; i < statistics.histogram.count(); ++i)
+	{
+		buckets.append(((i < bounds.count()) ? tr("under %1 ms: %2") : tr("over %1 ms: %2")).arg(bounds.at(qMin(i, (bounds.count() - 1)))).arg(statistics.histogram.at(i)));
+	}
+
+	m_ui->stallsLabel->setText(tr("Event loop stalls: %1, longest %2 ms (%3)").arg(statistics.amount).arg(statistics.longestDuration).arg(buckets.join(QLatin1String(", "))));
+}
+
+void PerformanceContentsWidget::addCacheRow(const QString &name, int amount, int limit, const QString &hits, const QString &misses, const QString &time)
+{
+	QList<QStandardItem*> items({new QStandardItem(name), new QStandardItem(QString::number(amount)), new QStandardItem((limit < 0) ? tr("Unlimited") : QString::number(limit)), new QStandardItem(hits), new QStandardItem(misses), new QStandardItem(time)});
+
+	for (int i = 0; i < items.count(); ++i)
+	{
+		items[i]->setFlags(items[i]->flags() | Qt::ItemNeverHasChildren);
+	}
+
+	m_cachesModel->appendRow(items);
+}
+
+void PerformanceContentsWidget::activateTab(const QModelIndex &index)
+{
+	const QModelIndex titleIndex(index.sibling(index.row(), 0));
+	const quint64 mainWindowIdentifier(titleIndex.data(MainWindowRole).toULongLong());
+	const quint64 windowIdentifier(titleIndex.data(WindowRole).toULongLong());
+	const QVector<MainWindow*> mainWindows(Application::getWindows());
+
+	for (int i = 0; i < mainWindows.count(); ++i)
+	{
+		if (mainWindows.at(i)->getIdentifier() == mainWindowIdentifier)
+		{
+			Application::getInstance()->triggerAction(ActionsManager::ActivateWindowAction, {{QLatin1String("window"), mainWindowIdentifier}});
+			Application::triggerAction(ActionsManager::ActivateTabAction, {{QLatin1String("tab"), windowIdentifier}}, mainWindows.at(i));
+
+			break;
+		}
+	}
+}
+
+QString PerformanceContentsWidget::formatTime(quint64 time)
+{
+	return tr("%1 ms").arg((static_cast<double>(time) / 1000), 0, 'f', 1);
+}
+
+QString PerformanceContentsWidget::getTitle() const
+{
+	return tr("Performance");
+}
+
+QLatin1String PerformanceContentsWidget::getType() const
+{
+	return QLatin1String("performance");
+}
+
+QUrl PerformanceContentsWidget::getUrl() const
+{
+	return QUrl(QLatin1String("about:performance"));
+}
+
+QIcon PerformanceContentsWidget::getIcon() const
+{
+	return ThemesManager::createIcon(QLatin1String("task-ongoing"), false);
+}
+
+}
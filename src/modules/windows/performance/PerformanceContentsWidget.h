@@ -0,0 +1,88 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PERFORMANCECONTENTSWIDGET_H
+#define OTTER_PERFORMANCECONTENTSWIDGET_H
+
+#include "../../../ui/ContentsWidget.h"
+
+#include <QtGui/QStandardItemModel>
+
+namespace Otter
+{
+
+namespace Ui
+{
+	class PerformanceContentsWidget;
+}
+
+class Window;
+
+class PerformanceContentsWidget final : public ContentsWidget
+{
+	Q_OBJECT
+
+public:
+	explicit PerformanceContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent);
+	~PerformanceContentsWidget();
+
+	void print(QPrinter *printer) override;
+	QString getTitle() const override;
+	QLatin1String getType() const override;
+	QUrl getUrl() const override;
+	QIcon getIcon() const override;
+
+public slots:
+	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
+
+protected:
+	enum DataRole
+	{
+		MainWindowRole = Qt::UserRole,
+		WindowRole
+	};
+
+	enum UpdateParameter
+	{
+		UpdateInterval = 1000
+	};
+
+	void changeEvent(QEvent *event) override;
+	void showEvent(QShowEvent *event) override;
+	void hideEvent(QHideEvent *event) override;
+	void timerEvent(QTimerEvent *event) override;
+	void updateTabs();
+	void updateCaches();
+	void updateStalls();
+	void addCacheRow(const QString &name, int amount, int limit, const QString &hits = {}, const QString &misses = {}, const QString &time = {});
+	static QString formatTime(quint64 time);
+
+protected slots:
+	void activateTab(const QModelIndex &index);
+
+private:
+	QStandardItemModel *m_tabsModel;
+	QStandardItemModel *m_cachesModel;
+	int m_updateTimer;
+	Ui::PerformanceContentsWidget *m_ui;
+};
+
+}
+
+#endif
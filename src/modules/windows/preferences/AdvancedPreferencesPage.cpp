@@ -1592,6 +1592,10 @@ void AdvancedPreferencesPage::save()
 		notificationsSettings.endGroup();
 	}
 
+	notificationsSettings.sync();
+
+	NotificationsManager::reloadEventDefinitions();
+
 	SettingsManager::setOption(SettingsManager::Interface_UseNativeNotificationsOption, m_ui->preferNativeNotificationsCheckBox->isChecked());
 
 	const QString widgetStyle((m_ui->appearranceWidgetStyleComboBox->currentIndex() == 0) ? QString() : m_ui->appearranceWidgetStyleComboBox->currentText());
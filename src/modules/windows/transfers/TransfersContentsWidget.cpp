@@ -28,6 +28,7 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
 #include <QtCore/QtMath>
 #include <QtGui/QClipboard>
 #include <QtGui/QKeyEvent>
@@ -72,6 +73,7 @@ QWidget* ProgressBarDelegate::createEditor(QWidget *parent, const QStyleOptionVi
 
 TransfersContentsWidget::TransfersContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
 	m_model(new QStandardItemModel(this)),
+	m_archivedTransfersAmount(0),
 	m_isLoading(false),
 	m_ui(new Ui::TransfersContentsWidget)
 {
@@ -97,7 +99,19 @@ TransfersContentsWidget::TransfersContentsWidget(const QVariantMap &parameters,
 
 	for (int i = 0; i < transfers.count(); ++i)
 	{
-		handleTransferAdded(transfers.at(i));
+		if (transfers.at(i)->isArchived())
+		{
+			m_archivedTransfers.append(transfers.at(i));
+		}
+		else
+		{
+			addTransfer(transfers.at(i));
+		}
+	}
+
+	if (!m_archivedTransfers.isEmpty())
+	{
+		QTimer::singleShot(0, this, &TransfersContentsWidget::loadArchivedTransfers);
 	}
 
 	if (isSidebarPanel())
@@ -108,6 +122,8 @@ TransfersContentsWidget::TransfersContentsWidget(const QVariantMap &parameters,
 	connect(TransfersManager::getInstance(), &TransfersManager::transferStarted, this, &TransfersContentsWidget::handleTransferAdded);
 	connect(TransfersManager::getInstance(), &TransfersManager::transferRemoved, this, [&](Transfer *transfer)
 	{
+		m_archivedTransfers.removeAll(transfer);
+
 		const int row(findTransferRow(transfer));
 
 		if (row >= 0)
@@ -115,7 +131,7 @@ TransfersContentsWidget::TransfersContentsWidget(const QVariantMap &parameters,
 			m_model->removeRow(row);
 		}
 	});
-	connect(TransfersManager::getInstance(), &TransfersManager::transferChanged, this, &TransfersContentsWidget::handleTransferChanged);
+	connect(TransfersManager::getInstance(), &TransfersManager::transfersModified, this, &TransfersContentsWidget::handleTransfersModified);
 	connect(m_model, &QStandardItemModel::modelReset, this, &TransfersContentsWidget::updateActions);
 	connect(m_ui->transfersViewWidget, &ItemViewWidget::doubleClicked, this, &TransfersContentsWidget::openTransfer);
 	connect(m_ui->transfersViewWidget, &ItemViewWidget::customContextMenuRequested, this, &TransfersContentsWidget::showContextMenu);
@@ -230,7 +246,7 @@ void TransfersContentsWidget::redownloadTransfer()
 	}
 }
 
-void TransfersContentsWidget::handleTransferAdded(Transfer *transfer)
+void TransfersContentsWidget::addTransfer(Transfer *transfer, int row)
 {
 	QList<QStandardItem*> items({new QStandardItem(), new QStandardItem(QFileInfo(transfer->getTarget()).fileName())});
 	items[0]->setData(QVariant::fromValue(static_cast<void*>(transfer)), InstanceRole);
@@ -246,100 +262,97 @@ void TransfersContentsWidget::handleTransferAdded(Transfer *transfer)
 		items.append(item);
 	}
 
-	m_model->appendRow(items);
+	if (row < 0)
+	{
+		m_model->appendRow(items);
+	}
+	else
+	{
+		m_model->insertRow(row, items);
+	}
 
 	m_ui->transfersViewWidget->openPersistentEditor(items[3]->index());
 
-	handleTransferChanged(transfer);
+	handleTransfersModified({transfer});
 }
 
-void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
+void TransfersContentsWidget::loadArchivedTransfers()
 {
-	const int row(findTransferRow(transfer));
+	const int amount(qMin(m_archivedTransfers.count(), static_cast<int>(LoadingBatchSize)));
 
-	if (row < 0)
+	for (int i = 0; i < amount; ++i)
 	{
-		return;
-	}
+		Transfer *transfer(m_archivedTransfers.at(i));
 
-	QString iconName(QLatin1String("task-reject"));
-	const bool isIndeterminate(transfer->getBytesTotal() <= 0);
+		if (transfer)
+		{
+			addTransfer(transfer, qMin(m_archivedTransfersAmount, m_model->rowCount()));
 
-	switch (transfer->getState())
-	{
-		case Transfer::RunningState:
-			iconName = QLatin1String("task-ongoing");
+			++m_archivedTransfersAmount;
+		}
+	}
 
-			break;
-		case Transfer::FinishedState:
-			iconName = QLatin1String("task-complete");
+	m_archivedTransfers.remove(0, amount);
 
-			break;
-		default:
-			break;
+	if (!m_archivedTransfers.isEmpty())
+	{
+		QTimer::singleShot(0, this, &TransfersContentsWidget::loadArchivedTransfers);
 	}
+}
 
-	const QString toolTip(tr("<div style=\"white-space:pre;\">Source: %1\nTarget: %2\nSize: %3\nDownloaded: %4\nProgress: %5</div>").arg(transfer->getSource().toDisplayString().toHtmlEscaped(), transfer->getTarget().toHtmlEscaped(), (isIndeterminate ? tr("Unknown") : Utils::formatUnit(transfer->getBytesTotal(), false, 1, true)), Utils::formatUnit(transfer->getBytesReceived(), false, 1, true), (isIndeterminate ? tr("Unknown") : QStringLiteral("%1%").arg(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal()), 0, 'f', 1))));
+void TransfersContentsWidget::handleTransferAdded(Transfer *transfer)
+{
+	m_archivedTransfers.removeAll(transfer);
 
-	for (int i = 0; i < m_model->columnCount(); ++i)
+	if (findTransferRow(transfer) < 0)
 	{
-		const QModelIndex &index(m_model->index(row, i));
-
-		m_model->setData(index, toolTip, Qt::ToolTipRole);
+		addTransfer(transfer);
+	}
+}
 
-		switch (i)
-		{
-			case 0:
-				m_model->setData(index, ThemesManager::createIcon(iconName), Qt::DecorationRole);
-				m_model->setData(index, transfer->getState(), StateRole);
+void TransfersContentsWidget::handleTransfersModified(const QVector<Transfer*> &transfers)
+{
+	int firstRow(-1);
+	int lastRow(-1);
+	bool isRunning(false);
 
-				break;
-			case 1:
-				m_model->setData(index, QFileInfo(transfer->getTarget()).fileName(), Qt::DisplayRole);
+	m_model->blockSignals(true);
 
-				break;
-			case 2:
-				m_model->setData(index, Utils::formatUnit(transfer->getBytesTotal(), false, 1), Qt::DisplayRole);
-				m_model->setData(index, transfer->getBytesTotal(), BytesTotalRole);
+	for (int i = 0; i < transfers.count(); ++i)
+	{
+		Transfer *transfer(transfers.at(i));
+		const int row(findTransferRow(transfer));
 
-				break;
-			case 3:
-				m_model->setData(index, transfer->getBytesReceived(), BytesReceivedRole);
-				m_model->setData(index, transfer->getBytesTotal(), BytesTotalRole);
-				m_model->setData(index, ((transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal())) : -1), ProgressRole);
-				m_model->setData(index, transfer->getState(), StateRole);
+		if (row < 0)
+		{
+			continue;
+		}
 
-				break;
-			case 4:
-				m_model->setData(index, ((isIndeterminate || transfer->getRemainingTime() <= 0) ? QString() : Utils::formatElapsedTime(transfer->getRemainingTime())), Qt::DisplayRole);
+		updateTransfer(transfer, row);
 
-				break;
-			case 5:
-				m_model->setData(index, ((transfer->getState() == Transfer::RunningState) ? Utils::formatUnit(transfer->getSpeed(), true, 1) : QString()), Qt::DisplayRole);
+		firstRow = ((firstRow < 0) ? row : qMin(firstRow, row));
+		lastRow = qMax(lastRow, row);
 
-				break;
-			case 6:
-				m_model->setData(index, Utils::formatDateTime(transfer->getTimeStarted()), Qt::DisplayRole);
-				m_model->setData(index, transfer->getTimeStarted(), TimeStartedRole);
+		if (transfer->getState() == Transfer::RunningState)
+		{
+			isRunning = true;
+		}
+	}
 
-				break;
-			case 7:
-				m_model->setData(index, Utils::formatDateTime(transfer->getTimeFinished()), Qt::DisplayRole);
-				m_model->setData(index, transfer->getTimeFinished(), TimeFinishedRole);
+	m_model->blockSignals(false);
 
-				break;
-			default:
-				break;
-		}
+	if (firstRow < 0)
+	{
+		return;
 	}
 
+	emit m_model->dataChanged(m_model->index(firstRow, 0), m_model->index(lastRow, (m_model->columnCount() - 1)));
+
 	if (m_ui->transfersViewWidget->selectionModel()->hasSelection())
 	{
 		updateActions();
 	}
 
-	const bool isRunning(transfer && transfer->getState() == Transfer::RunningState);
-
 	if (isRunning != m_isLoading)
 	{
 		if (isRunning)
@@ -359,7 +372,7 @@ void TransfersContentsWidget::handleTransferChanged(Transfer *transfer)
 
 void TransfersContentsWidget::showContextMenu(const QPoint &position)
 {
-	const Transfer *transfer(getTransfer(m_ui->transfersViewWidget->indexAt(position)));
+	Transfer *transfer(getTransfer(m_ui->transfersViewWidget->indexAt(position)));
 	QMenu menu(this);
 
 	if (transfer)
@@ -379,6 +392,21 @@ void TransfersContentsWidget::showContextMenu(const QPoint &position)
 		menu.addSeparator();
 		menu.addAction(((transfer->getState() == Transfer::ErrorState) ? tr("Resume") : tr("Stop")), this, &TransfersContentsWidget::stopResumeTransfer)->setEnabled(transfer->getState() == Transfer::RunningState || transfer->getState() == Transfer::ErrorState);
 		menu.addAction(tr("Redownload"), this, &TransfersContentsWidget::redownloadTransfer);
+
+		QMenu *priorityMenu(menu.addMenu(tr("Priority")));
+		const QVector<QPair<Transfer::TransferPriority, QString> > priorities({{Transfer::HighPriority, tr("High")}, {Transfer::NormalPriority, tr("Normal")}, {Transfer::LowPriority, tr("Low")}});
+
+		for (int i = 0; i < priorities.count(); ++i)
+		{
+			const Transfer::TransferPriority priority(priorities.at(i).first);
+			QAction *action(priorityMenu->addAction(priorities.at(i).second, this, [=]()
+			{
+				transfer->setPriority(priority);
+			}));
+			action->setCheckable(true);
+			action->setChecked(transfer->getPriority() == priority);
+		}
+
 		menu.addSeparator();
 		menu.addAction(tr("Copy Transfer Information"), this, &TransfersContentsWidget::copyTransferInformation);
 		menu.addSeparator();
@@ -551,6 +579,80 @@ WebWidget::LoadingState TransfersContentsWidget::getLoadingState() const
 	return (m_isLoading ? WebWidget::OngoingLoadingState : WebWidget::FinishedLoadingState);
 }
 
+void TransfersContentsWidget::updateTransfer(Transfer *transfer, int row)
+{
+	QString iconName(QLatin1String("task-reject"));
+	const bool isIndeterminate(transfer->getBytesTotal() <= 0);
+
+	switch (transfer->getState())
+	{
+		case Transfer::RunningState:
+			iconName = QLatin1String("task-ongoing");
+
+			break;
+		case Transfer::FinishedState:
+			iconName = QLatin1String("task-complete");
+
+			break;
+		default:
+			break;
+	}
+
+	const QString toolTip(tr("<div style=\"white-space:pre;\">Source: %1\nTarget: %2\nSize: %3\nDownloaded: %4\nProgress: %5</div>").arg(transfer->getSource().toDisplayString().toHtmlEscaped(), transfer->getTarget().toHtmlEscaped(), (isIndeterminate ? tr("Unknown") : Utils::formatUnit(transfer->getBytesTotal(), false, 1, true)), Utils::formatUnit(transfer->getBytesReceived(), false, 1, true), (isIndeterminate ? tr("Unknown") : QStringLiteral("%1%").arg(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal()), 0, 'f', 1))));
+
+	for (int i = 0; i < m_model->columnCount(); ++i)
+	{
+		const QModelIndex &index(m_model->index(row, i));
+
+		m_model->setData(index, toolTip, Qt::ToolTipRole);
+
+		switch (i)
+		{
+			case 0:
+				m_model->setData(index, ThemesManager::createIcon(iconName), Qt::DecorationRole);
+				m_model->setData(index, transfer->getState(), StateRole);
+
+				break;
+			case 1:
+				m_model->setData(index, QFileInfo(transfer->getTarget()).fileName(), Qt::DisplayRole);
+
+				break;
+			case 2:
+				m_model->setData(index, Utils::formatUnit(transfer->getBytesTotal(), false, 1), Qt::DisplayRole);
+				m_model->setData(index, transfer->getBytesTotal(), BytesTotalRole);
+
+				break;
+			case 3:
+				m_model->setData(index, transfer->getBytesReceived(), BytesReceivedRole);
+				m_model->setData(index, transfer->getBytesTotal(), BytesTotalRole);
+				m_model->setData(index, ((transfer->getBytesTotal() > 0) ? qFloor(Utils::calculatePercent(transfer->getBytesReceived(), transfer->getBytesTotal())) : -1), ProgressRole);
+				m_model->setData(index, transfer->getState(), StateRole);
+
+				break;
+			case 4:
+				m_model->setData(index, ((isIndeterminate || transfer->getRemainingTime() <= 0) ? QString() : Utils::formatElapsedTime(transfer->getRemainingTime())), Qt::DisplayRole);
+
+				break;
+			case 5:
+				m_model->setData(index, ((transfer->getState() == Transfer::RunningState) ? Utils::formatUnit(transfer->getSpeed(), true, 1) : QString()), Qt::DisplayRole);
+
+				break;
+			case 6:
+				m_model->setData(index, Utils::formatDateTime(transfer->getTimeStarted()), Qt::DisplayRole);
+				m_model->setData(index, transfer->getTimeStarted(), TimeStartedRole);
+
+				break;
+			case 7:
+				m_model->setData(index, Utils::formatDateTime(transfer->getTimeFinished()), Qt::DisplayRole);
+				m_model->setData(index, transfer->getTimeFinished(), TimeFinishedRole);
+
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 int TransfersContentsWidget::findTransferRow(Transfer *transfer) const
 {
 	if (!transfer)
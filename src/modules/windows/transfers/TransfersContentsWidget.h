@@ -23,6 +23,7 @@
 #include "../../../ui/ContentsWidget.h"
 #include "../../../ui/ItemDelegate.h"
 
+#include <QtCore/QPointer>
 #include <QtGui/QStandardItemModel>
 
 namespace Otter
@@ -77,8 +78,15 @@ public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
 
 protected:
+	enum LoadingParameter
+	{
+		LoadingBatchSize = 100
+	};
+
 	void changeEvent(QEvent *event) override;
+	void addTransfer(Transfer *transfer, int row = -1);
 	Transfer* getTransfer(const QModelIndex &index) const;
+	void updateTransfer(Transfer *transfer, int row);
 	int findTransferRow(Transfer *transfer) const;
 
 protected slots:
@@ -88,13 +96,16 @@ protected slots:
 	void copyTransferInformation();
 	void stopResumeTransfer();
 	void redownloadTransfer();
+	void loadArchivedTransfers();
 	void handleTransferAdded(Transfer *transfer);
-	void handleTransferChanged(Transfer *transfer);
+	void handleTransfersModified(const QVector<Transfer*> &transfers);
 	void showContextMenu(const QPoint &position);
 	void updateActions();
 
 private:
 	QStandardItemModel *m_model;
+	QVector<QPointer<Transfer> > m_archivedTransfers;
+	int m_archivedTransfersAmount;
 	bool m_isLoading;
 	Ui::TransfersContentsWidget *m_ui;
 };
@@ -90,7 +90,7 @@ void SearchBarWidget::notifyFlagsChanged()
 {
 	const WebWidget::FindFlags flags(getFlags());
 
-	if (flags.testFlag(WebWidget::HighlightAllFind) != SettingsManager::getOption(SettingsManager::Search_EnableFindInPageHighlightAllOption).toBool())
+	if (sender() == m_ui->highlightButton)
 	{
 		SettingsManager::setOption(SettingsManager::Search_EnableFindInPageHighlightAllOption, flags.testFlag(WebWidget::HighlightAllFind));
 	}
@@ -126,6 +126,14 @@ void SearchBarWidget::updateResults(const QString &query, int matchesAmount, int
 		{
 			resultsText = tr("%1 of %n result(s)", "", matchesAmount).arg(activeResult);
 		}
+		else if (matchesAmount > 0 && activeResult < 0)
+		{
+			resultsText = tr("%n result(s) so far", "", matchesAmount);
+		}
+		else if (matchesAmount > 0)
+		{
+			resultsText = tr("%n result(s)", "", matchesAmount);
+		}
 		else if (matchesAmount == 0)
 		{
 			resultsText = tr("Phrase not found");
@@ -24,8 +24,10 @@
 #include "../../../core/SettingsManager.h"
 #include "../../../core/WebBackend.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeData>
 #include <QtCore/QTimer>
 #include <QtGui/QPainter>
@@ -33,9 +35,15 @@
 namespace Otter
 {
 
+QCache<quint64, QImage> StartPageModel::m_thumbnails(ThumbnailsCacheLimit);
+QSet<quint64> StartPageModel::m_thumbnailFiles;
+bool StartPageModel::m_areThumbnailFilesListed(false);
+
 StartPageModel::StartPageModel(QObject *parent) : QStandardItemModel(parent),
-	m_bookmark(nullptr)
+	m_bookmark(nullptr),
+	m_thumbnailJobsAmount(0)
 {
+	handleOptionChanged(SettingsManager::StartPage_TileWidthOption);
 	handleOptionChanged(SettingsManager::Backends_WebOption);
 	reloadModel();
 
@@ -60,33 +68,9 @@ void StartPageModel::reloadModel()
 		{
 			const BookmarksModel::Bookmark *bookmark(m_bookmark->getChild(i));
 
-			if (bookmark)
+			if (isTile(bookmark))
 			{
-				const BookmarksModel::BookmarkType type(bookmark->getType());
-
-				if (type != BookmarksModel::UrlBookmark && type != BookmarksModel::FolderBookmark)
-				{
-					continue;
-				}
-
-				const quint64 identifier(bookmark->getIdentifier());
-				const QUrl url(bookmark->getUrl());
-				QStandardItem *item(bookmark->clone());
-				item->setData(identifier, BookmarksModel::IdentifierRole);
-				item->setData(bookmark->getTitle(), Qt::ToolTipRole);
-				item->setFlags(item->flags() | Qt::ItemNeverHasChildren);
-
-				if (type == BookmarksModel::FolderBookmark && bookmark->rowCount() == 0)
-				{
-					item->setData(true, IsEmptyRole);
-				}
-
-				if (url.isValid() && !QFile::exists(getThumbnailPath(identifier)))
-				{
-					requestThumbnail(url, identifier);
-				}
-
-				appendRow(item);
+				appendRow(createTile(bookmark));
 			}
 		}
 	}
@@ -115,6 +99,11 @@ void StartPageModel::handleOptionChanged(int identifier)
 		case SettingsManager::StartPage_ShowAddTileOption:
 			reloadModel();
 
+			break;
+		case SettingsManager::StartPage_TileHeightOption:
+		case SettingsManager::StartPage_TileWidthOption:
+			m_tileSize = {SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt()};
+
 			break;
 		default:
 			break;
@@ -145,10 +134,24 @@ void StartPageModel::handleBookmarkModified(BookmarksModel::Bookmark *bookmark)
 		m_bookmark = BookmarksManager::getModel()->getBookmarkByPath(SettingsManager::getOption(SettingsManager::StartPage_BookmarksFolderOption).toString());
 	}
 
-	if (m_bookmark && (bookmark == m_bookmark || m_bookmark->isAncestorOf(bookmark)))
+	if (!m_bookmark)
+	{
+		return;
+	}
+
+	if (bookmark == m_bookmark)
 	{
 		reloadModel();
 	}
+	else if (m_bookmark->isAncestorOf(bookmark))
+	{
+		while (bookmark && bookmark->getParent() != m_bookmark)
+		{
+			bookmark = bookmark->getParent();
+		}
+
+		updateTile(bookmark);
+	}
 }
 
 void StartPageModel::handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, BookmarksModel::Bookmark *previousParent)
@@ -162,12 +165,7 @@ void StartPageModel::handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, Boo
 	{
 		if (bookmark->parent() != m_bookmark)
 		{
-			const QString path(getThumbnailPath(bookmark->getIdentifier()));
-
-			if (QFile::exists(path))
-			{
-				QFile::remove(path);
-			}
+			removeThumbnail(bookmark->getIdentifier());
 		}
 
 		if (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(bookmark) || m_bookmark->isAncestorOf(previousParent))
@@ -179,15 +177,36 @@ void StartPageModel::handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, Boo
 
 void StartPageModel::handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark, BookmarksModel::Bookmark *previousParent)
 {
-	if (m_bookmark && (bookmark == m_bookmark || previousParent == m_bookmark || m_bookmark->isAncestorOf(previousParent)))
+	if (!m_bookmark)
+	{
+		return;
+	}
+
+	if (previousParent == m_bookmark)
 	{
-		const QString path(getThumbnailPath(bookmark->getIdentifier()));
+		const quint64 identifier(bookmark->getIdentifier());
+		const QModelIndex index(getIndex(identifier));
+
+		removeThumbnail(identifier);
+
+		if (index.isValid())
+		{
+			removeRow(index.row());
 
-		if (QFile::exists(path))
+			emit modelModified();
+		}
+	}
+	else if (m_bookmark->isAncestorOf(previousParent))
+	{
+		while (previousParent && previousParent->getParent() != m_bookmark)
 		{
-			QFile::remove(path);
+			previousParent = previousParent->getParent();
 		}
 
+		updateTile(previousParent);
+	}
+	else if (bookmark == m_bookmark)
+	{
 		QTimer::singleShot(100, this, &StartPageModel::reloadModel);
 	}
 }
@@ -206,9 +225,18 @@ void StartPageModel::handleThumbnailCreated(quint64 identifier, const QPixmap &t
 
 	if (!SessionsManager::isReadOnly() && !thumbnail.isNull() && bookmark)
 	{
-		QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")));
+		const QImage image(thumbnail.toImage());
+		const QString path(getThumbnailPath(identifier));
+
+		m_thumbnails.insert(identifier, new QImage(image), getThumbnailCost(image));
+		m_thumbnailFiles.insert(identifier);
 
-		thumbnail.save(getThumbnailPath(identifier), "png");
+		QtConcurrent::run([=]()
+		{
+			QDir().mkpath(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")));
+
+			image.save(path, "png", ThumbnailQuality);
+		});
 	}
 
 	if (bookmark)
@@ -222,6 +250,156 @@ void StartPageModel::handleThumbnailCreated(quint64 identifier, const QPixmap &t
 	}
 }
 
+void StartPageModel::handleThumbnailLoaded(quint64 identifier, const QImage &thumbnail)
+{
+	m_loadingThumbnails.remove(identifier);
+
+	if (thumbnail.isNull() || m_thumbnails.contains(identifier))
+	{
+		return;
+	}
+
+	m_thumbnails.insert(identifier, new QImage(thumbnail), getThumbnailCost(thumbnail));
+
+	const QModelIndex index(getIndex(identifier));
+
+	if (index.isValid())
+	{
+		emit thumbnailChanged(index);
+	}
+}
+
+void StartPageModel::startThumbnailJobs()
+{
+	while (m_thumbnailJobsAmount < ThumbnailJobsLimit && !m_thumbnailRequests.isEmpty())
+	{
+		const ThumbnailRequest request(m_thumbnailRequests.takeFirst());
+		WebPageThumbnailJob *job(AddonsManager::getWebBackend()->createPageThumbnailJob(request.url, m_tileSize));
+
+		if (!job)
+		{
+			m_reloads.remove(request.identifier);
+
+			emit isReloadingTileChanged(getIndex(request.identifier));
+
+			continue;
+		}
+
+		++m_thumbnailJobsAmount;
+
+		connect(job, &WebPageThumbnailJob::jobFinished, this, [=]()
+		{
+			--m_thumbnailJobsAmount;
+
+			handleThumbnailCreated(request.identifier, job->getThumbnail(), job->getTitle());
+			startThumbnailJobs();
+		});
+
+		job->start();
+	}
+}
+
+void StartPageModel::loadThumbnail(quint64 identifier)
+{
+	if (m_loadingThumbnails.contains(identifier) || SettingsManager::getOption(SettingsManager::StartPage_TileBackgroundModeOption) != QLatin1String("thumbnail"))
+	{
+		return;
+	}
+
+	const QString path(getThumbnailPath(identifier));
+	QFutureWatcher<QImage> *watcher(new QFutureWatcher<QImage>(this));
+
+	m_loadingThumbnails.insert(identifier);
+
+	connect(watcher, &QFutureWatcher<QImage>::finished, this, [=]()
+	{
+		handleThumbnailLoaded(identifier, watcher->result());
+
+		watcher->deleteLater();
+	});
+
+	watcher->setFuture(QtConcurrent::run([=]()
+	{
+		return QImage(path);
+	}));
+}
+
+void StartPageModel::removeThumbnail(quint64 identifier)
+{
+	const QString path(getThumbnailPath(identifier));
+
+	m_thumbnails.remove(identifier);
+
+	if (hasThumbnailFile(identifier))
+	{
+		m_thumbnailFiles.remove(identifier);
+
+		QFile::remove(path);
+	}
+}
+
+void StartPageModel::updateTile(BookmarksModel::Bookmark *bookmark)
+{
+	if (!bookmark || bookmark->getParent() != m_bookmark)
+	{
+		return;
+	}
+
+	const QModelIndex index(getIndex(bookmark->getIdentifier()));
+
+	if (!isTile(bookmark))
+	{
+		if (index.isValid())
+		{
+			removeRow(index.row());
+
+			emit modelModified();
+		}
+
+		return;
+	}
+
+	if (index.isValid())
+	{
+		setItem(index.row(), createTile(bookmark));
+	}
+	else
+	{
+		insertRow(getTileRow(bookmark), createTile(bookmark));
+
+		emit modelModified();
+	}
+}
+
+QStandardItem* StartPageModel::createTile(const BookmarksModel::Bookmark *bookmark)
+{
+	const quint64 identifier(bookmark->getIdentifier());
+	const QUrl url(bookmark->getUrl());
+	QStandardItem *item(bookmark->clone());
+	item->setData(identifier, BookmarksModel::IdentifierRole);
+	item->setData(bookmark->getTitle(), Qt::ToolTipRole);
+	item->setFlags(item->flags() | Qt::ItemNeverHasChildren);
+
+	if (bookmark->getType() == BookmarksModel::FolderBookmark && bookmark->rowCount() == 0)
+	{
+		item->setData(true, IsEmptyRole);
+	}
+
+	if (url.isValid() && !m_thumbnails.contains(identifier))
+	{
+		if (hasThumbnailFile(identifier))
+		{
+			loadThumbnail(identifier);
+		}
+		else
+		{
+			requestThumbnail(url, identifier);
+		}
+	}
+
+	return item;
+}
+
 QMimeData* StartPageModel::mimeData(const QModelIndexList &indexes) const
 {
 	QMimeData *mimeData(new QMimeData());
@@ -267,6 +445,79 @@ QString StartPageModel::getThumbnailPath(quint64 identifier)
 	return SessionsManager::getWritableDataPath(QLatin1String("thumbnails/")) + QString::number(identifier) + QLatin1String(".png");
 }
 
+QModelIndex StartPageModel::getIndex(quint64 identifier) const
+{
+	for (int i = 0; i < rowCount(); ++i)
+	{
+		const QModelIndex index(this->index(i, 0));
+
+		if (index.data(BookmarksModel::IdentifierRole).toULongLong() == identifier)
+		{
+			return index;
+		}
+	}
+
+	return {};
+}
+
+int StartPageModel::getThumbnailCost(const QImage &thumbnail)
+{
+	return qMax(1, ((thumbnail.bytesPerLine() * thumbnail.height()) / 1024));
+}
+
+int StartPageModel::getTileRow(const BookmarksModel::Bookmark *bookmark) const
+{
+	const int row(bookmark->row());
+	int tileRow(0);
+
+	for (int i = 0; i < row; ++i)
+	{
+		if (isTile(m_bookmark->getChild(i)))
+		{
+			++tileRow;
+		}
+	}
+
+	return tileRow;
+}
+
+bool StartPageModel::hasThumbnailFile(quint64 identifier)
+{
+	if (!m_areThumbnailFilesListed)
+	{
+		const QStringList entries(QDir(SessionsManager::getWritableDataPath(QLatin1String("thumbnails/"))).entryList({QLatin1String("*.png")}, QDir::Files));
+
+		m_thumbnailFiles.reserve(entries.count());
+
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			bool isValid(false);
+			const quint64 fileIdentifier(entries.at(i).section(QLatin1Char('.'), 0, 0).toULongLong(&isValid));
+
+			if (isValid)
+			{
+				m_thumbnailFiles.insert(fileIdentifier);
+			}
+		}
+
+		m_areThumbnailFilesListed = true;
+	}
+
+	return m_thumbnailFiles.contains(identifier);
+}
+
+bool StartPageModel::isTile(const BookmarksModel::Bookmark *bookmark)
+{
+	if (!bookmark)
+	{
+		return false;
+	}
+
+	const BookmarksModel::BookmarkType type(bookmark->getType());
+
+	return (type == BookmarksModel::UrlBookmark || type == BookmarksModel::FolderBookmark);
+}
+
 QVariant StartPageModel::data(const QModelIndex &index, int role) const
 {
 	if (role == IsReloadingRole)
@@ -274,6 +525,27 @@ QVariant StartPageModel::data(const QModelIndex &index, int role) const
 		return m_reloads.contains(index.data(BookmarksModel::IdentifierRole).toULongLong());
 	}
 
+	if (role == ThumbnailRole)
+	{
+		const quint64 identifier(index.data(BookmarksModel::IdentifierRole).toULongLong());
+
+		if (!m_thumbnails.contains(identifier) && !m_loadingThumbnails.contains(identifier))
+		{
+			const QImage thumbnail(getThumbnailPath(identifier));
+
+			if (thumbnail.isNull())
+			{
+				return {};
+			}
+
+			m_thumbnails.insert(identifier, new QImage(thumbnail), getThumbnailCost(thumbnail));
+		}
+
+		const QImage *thumbnail(m_thumbnails.object(identifier));
+
+		return (thumbnail ? QVariant(*thumbnail) : QVariant());
+	}
+
 	return QStandardItemModel::data(index, role);
 }
 
@@ -324,23 +596,23 @@ bool StartPageModel::requestThumbnail(const QUrl &url, quint64 identifier, bool
 		return false;
 	}
 
-	WebPageThumbnailJob *job(AddonsManager::getWebBackend()->createPageThumbnailJob(url, {SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt()}));
-
-	if (job)
+	if (m_reloads.contains(identifier))
 	{
-		connect(job, &WebPageThumbnailJob::jobFinished, this, [=]()
-		{
-			handleThumbnailCreated(identifier, job->getThumbnail(), job->getTitle());
-		});
-
-		m_reloads[identifier] = needsTitleUpdate;
-
-		job->start();
+		m_reloads[identifier] = (m_reloads[identifier] || needsTitleUpdate);
 
 		return true;
 	}
 
-	return false;
+	ThumbnailRequest request;
+	request.url = url;
+	request.identifier = identifier;
+
+	m_thumbnailRequests.append(request);
+	m_reloads[identifier] = needsTitleUpdate;
+
+	startThumbnailJobs();
+
+	return true;
 }
 
 bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
@@ -370,7 +642,7 @@ bool StartPageModel::reloadTile(const QModelIndex &index, bool needsTitleUpdate)
 			return false;
 		}
 
-		const QSize size(SettingsManager::getOption(SettingsManager::StartPage_TileWidthOption).toInt(), SettingsManager::getOption(SettingsManager::StartPage_TileHeightOption).toInt());
+		const QSize size(m_tileSize);
 		QPixmap thumbnail(size);
 		thumbnail.fill(Qt::white);
 
@@ -22,6 +22,9 @@
 
 #include "../../../core/BookmarksModel.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QSet>
+
 namespace Otter
 {
 
@@ -34,7 +37,8 @@ public:
 	{
 		IsDraggedRole = BookmarksModel::UserRole,
 		IsEmptyRole,
-		IsReloadingRole
+		IsReloadingRole,
+		ThumbnailRole
 	};
 
 	explicit StartPageModel(QObject *parent = nullptr);
@@ -53,10 +57,34 @@ public slots:
 	QModelIndex addTile(const QUrl &url);
 
 protected:
+	enum ThumbnailsParameter
+	{
+		ThumbnailJobsLimit = 1,
+		ThumbnailsCacheLimit = 16384,
+		ThumbnailQuality = 90
+	};
+
+	struct ThumbnailRequest final
+	{
+		QUrl url;
+		quint64 identifier = 0;
+	};
+
+	void startThumbnailJobs();
+	void loadThumbnail(quint64 identifier);
+	void removeThumbnail(quint64 identifier);
+	void updateTile(BookmarksModel::Bookmark *bookmark);
+	QStandardItem* createTile(const BookmarksModel::Bookmark *bookmark);
+	QModelIndex getIndex(quint64 identifier) const;
+	static int getThumbnailCost(const QImage &thumbnail);
+	int getTileRow(const BookmarksModel::Bookmark *bookmark) const;
+	static bool hasThumbnailFile(quint64 identifier);
+	static bool isTile(const BookmarksModel::Bookmark *bookmark);
 	bool requestThumbnail(const QUrl &url, quint64 identifier, bool needsTitleUpdate = false);
 
 protected slots:
 	void handleOptionChanged(int identifier);
+	void handleThumbnailLoaded(quint64 identifier, const QImage &thumbnail);
 	void handleDragEnded();
 	void handleBookmarkModified(BookmarksModel::Bookmark *bookmark);
 	void handleBookmarkMoved(BookmarksModel::Bookmark *bookmark, BookmarksModel::Bookmark *previousParent);
@@ -65,11 +93,20 @@ protected slots:
 
 private:
 	BookmarksModel::Bookmark *m_bookmark;
+	QVector<ThumbnailRequest> m_thumbnailRequests;
+	QSet<quint64> m_loadingThumbnails;
 	QHash<quint64, bool> m_reloads;
+	QSize m_tileSize;
+	int m_thumbnailJobsAmount;
+
+	static QCache<quint64, QImage> m_thumbnails;
+	static QSet<quint64> m_thumbnailFiles;
+	static bool m_areThumbnailFilesListed;
 
 signals:
 	void modelModified();
 	void isReloadingTileChanged(const QModelIndex &index);
+	void thumbnailChanged(const QModelIndex &index);
 };
 
 }
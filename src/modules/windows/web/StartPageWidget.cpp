@@ -181,7 +181,7 @@ void TileDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
 				pixmapPainter.setBrush(Qt::white);
 				pixmapPainter.setPen(Qt::transparent);
 				pixmapPainter.drawRect(rectangle);
-				pixmapPainter.drawPixmap(rectangle, QPixmap(StartPageModel::getThumbnailPath(identifier)), rectangle.translated(-rectangle.topLeft()));
+				pixmapPainter.drawImage(rectangle, index.data(StartPageModel::ThumbnailRole).value<QImage>(), rectangle.translated(-rectangle.topLeft()));
 				pixmapPainter.restore();
 
 				break;
@@ -222,15 +222,18 @@ void TileDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
 
 void TileDelegate::drawAnimation(QPainter *painter, const QRect &rectangle) const
 {
-	const Animation *animation(StartPageWidget::getLoadingAnimation());
+	Animation *animation(StartPageWidget::getLoadingAnimation());
 
 	if (animation)
 	{
+		const QAbstractItemView *view(qobject_cast<QAbstractItemView*>(m_widget));
 		const QPixmap pixmap(animation->getCurrentPixmap());
 		QRect pixmapRectangle({0, 0}, pixmap.size());
 		pixmapRectangle.moveCenter(rectangle.center());
 
 		painter->drawPixmap(pixmapRectangle, pixmap);
+
+		animation->addRegion((view ? view->viewport() : m_widget), pixmapRectangle);
 	}
 }
 
@@ -242,29 +245,12 @@ void TileDelegate::drawBlurBehind(QPainter *painter, const QRect &rectangle) con
 		return;
 	}
 
-	QRect parentRectangle;
-	parentRectangle.setTopLeft(m_widget->mapToParent(rectangle.topLeft()));
-	parentRectangle.setBottomRight(m_widget->mapToParent(rectangle.bottomRight()));
-	parentRectangle.adjust(-8, -8, 8, 8);
-
-	QPixmap parentPixmap(parentRectangle.size());
-	parentPixmap.fill(Qt::transparent);
-
-	m_widget->parentWidget()->render(&parentPixmap, {}, QRegion(parentRectangle), (QWidget::DrawWindowBackground | QWidget::IgnoreMask));
-
-	QPixmap blurredPixmap(parentRectangle.size());
-	blurredPixmap.fill(Qt::transparent);
+	StartPageContentsWidget *contentsWidget(qobject_cast<StartPageContentsWidget*>(m_widget->parentWidget()));
 
-	QPainter blurredPainter(&blurredPixmap);
-	QPixmapBlurFilter filter;
-	filter.setBlurHints(QGraphicsBlurEffect::PerformanceHint);
-	filter.setRadius(5);
-	filter.draw(&blurredPainter, {}, parentPixmap);
-
-	QRect blurredRectangle(rectangle);
-	blurredRectangle.moveTo(8, 8);
-
-	painter->drawPixmap(rectangle, blurredPixmap, blurredRectangle);
+	if (contentsWidget)
+	{
+		painter->drawPixmap(rectangle, contentsWidget->getBackgroundPixmap(true), QRect(m_widget->mapToParent(rectangle.topLeft()), rectangle.size()));
+	}
 #else
 	Q_UNUSED(painter)
 	Q_UNUSED(rectangle)
@@ -361,65 +347,21 @@ StartPageContentsWidget::StartPageContentsWidget(QWidget *parent) : QWidget(pare
 
 void StartPageContentsWidget::paintEvent(QPaintEvent *event)
 {
-	Q_UNUSED(event)
-
 	QPainter painter(this);
-	painter.fillRect(contentsRect(), m_color);
-
-	if (m_mode == NoBackground || m_path.isEmpty() || !QFile::exists(m_path))
-	{
-		return;
-	}
-
-	const QString key(getPixmapCachePrefix() + QLatin1String("-background"));
-	QPixmap cachedPixmap;
-
-	if (QPixmapCache::find(key, &cachedPixmap))
-	{
-		painter.drawPixmap(contentsRect(), cachedPixmap);
-
-		return;
-	}
-
-	const QPixmap pixmap(m_path);
-
-	if (pixmap.isNull())
-	{
-		return;
-	}
-
-	switch (m_mode)
-	{
-		case DefaultBackground:
-		case BestFitBackground:
-			cachedPixmap = pixmap.scaled(size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-			cachedPixmap = cachedPixmap.copy(contentsRect().translated(((cachedPixmap.width() - width()) / 2), ((cachedPixmap.height() - height()) / 2)));
-
-			painter.drawPixmap(contentsRect(), cachedPixmap);
-
-			break;
-		case CenterBackground:
-			painter.drawPixmap((contentsRect().center() - pixmap.rect().center()), pixmap);
-
-			break;
-		case StretchBackground:
-			cachedPixmap = pixmap.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-
-			painter.drawPixmap(contentsRect(), cachedPixmap);
+	painter.drawPixmap(event->rect(), getBackgroundPixmap(), event->rect());
+}
 
-			break;
-		case TileBackground:
-			painter.drawTiledPixmap(contentsRect(), pixmap);
+void StartPageContentsWidget::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
 
-			break;
-		default:
-			break;
-	}
+	clearBackgroundPixmap();
+}
 
-	if (!cachedPixmap.isNull())
-	{
-		QPixmapCache::insert(key, cachedPixmap);
-	}
+void StartPageContentsWidget::clearBackgroundPixmap()
+{
+	m_backgroundPixmap = {};
+	m_blurredBackgroundPixmap = {};
 }
 
 void StartPageContentsWidget::handleOptionChanged(int identifier)
@@ -428,6 +370,7 @@ void StartPageContentsWidget::handleOptionChanged(int identifier)
 	{
 		QPixmapCache::clear();
 
+		clearBackgroundPixmap();
 		update();
 	}
 }
@@ -457,9 +400,82 @@ void StartPageContentsWidget::setBackgroundMode(BackgroundMode mode)
 
 	m_mode = mode;
 
+	clearBackgroundPixmap();
 	update();
 }
 
+QPixmap StartPageContentsWidget::getBackgroundPixmap(bool isBlurred)
+{
+	if (size().isEmpty())
+	{
+		return {};
+	}
+
+	if (m_backgroundPixmap.isNull())
+	{
+		m_backgroundPixmap = QPixmap(size());
+		m_backgroundPixmap.fill(Qt::transparent);
+
+		QPainter painter(&m_backgroundPixmap);
+		painter.fillRect(rect(), m_color);
+
+		const QPixmap pixmap((m_mode == NoBackground || m_path.isEmpty()) ? QPixmap() : QPixmap(m_path));
+
+		if (!pixmap.isNull())
+		{
+			switch (m_mode)
+			{
+				case DefaultBackground:
+				case BestFitBackground:
+					{
+						const QPixmap scaledPixmap(pixmap.scaled(size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+
+						painter.drawPixmap(rect(), scaledPixmap, rect().translated(((scaledPixmap.width() - width()) / 2), ((scaledPixmap.height() - height()) / 2)));
+					}
+
+					break;
+				case CenterBackground:
+					painter.drawPixmap((rect().center() - pixmap.rect().center()), pixmap);
+
+					break;
+				case StretchBackground:
+					painter.drawPixmap(rect(), pixmap.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+
+					break;
+				case TileBackground:
+					painter.drawTiledPixmap(rect(), pixmap);
+
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+#ifdef OTTER_ENABLE_STARTPAGEBLUR
+	if (isBlurred)
+	{
+		if (m_blurredBackgroundPixmap.isNull())
+		{
+			m_blurredBackgroundPixmap = QPixmap(size());
+			m_blurredBackgroundPixmap.fill(Qt::transparent);
+
+			QPainter painter(&m_blurredBackgroundPixmap);
+			QPixmapBlurFilter filter;
+			filter.setBlurHints(QGraphicsBlurEffect::PerformanceHint);
+			filter.setRadius(5);
+			filter.draw(&painter, {}, m_backgroundPixmap);
+		}
+
+		return m_blurredBackgroundPixmap;
+	}
+#else
+	Q_UNUSED(isBlurred)
+#endif
+
+	return m_backgroundPixmap;
+}
+
 QString StartPageContentsWidget::getPixmapCachePrefix() const
 {
 	QString prefix;
@@ -492,6 +508,7 @@ StartPageWidget::StartPageWidget(Window *parent) : QScrollArea(parent),
 	m_searchWidget(nullptr),
 	m_tileDelegate(new TileDelegate(m_listView)),
 	m_deleteTimer(0),
+	m_hoverTimer(0),
 	m_isIgnoringEnter(false)
 {
 	if (!m_model)
@@ -534,6 +551,12 @@ StartPageWidget::StartPageWidget(Window *parent) : QScrollArea(parent),
 
 	connect(m_model, &StartPageModel::modelModified, this, &StartPageWidget::updateSize);
 	connect(m_model, &StartPageModel::isReloadingTileChanged, this, &StartPageWidget::handleIsReloadingTileChanged);
+	connect(m_model, &StartPageModel::thumbnailChanged, this, [&](const QModelIndex &index)
+	{
+		QPixmapCache::remove(m_tileDelegate->createPixmapCacheKey(m_listView->visualRect(index), index.data(BookmarksModel::IdentifierRole).toULongLong()));
+
+		m_listView->update(index);
+	});
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &StartPageWidget::handleOptionChanged);
 }
 
@@ -554,6 +577,19 @@ void StartPageWidget::timerEvent(QTimerEvent *event)
 
 		deleteLater();
 	}
+	else if (event->timerId() == m_hoverTimer)
+	{
+		killTimer(m_hoverTimer);
+
+		m_hoverTimer = 0;
+
+		WebWidget *webWidget(m_window->getWebWidget());
+
+		if (webWidget && m_hoveredIndex.isValid() && m_hoveredIndex.data(BookmarksModel::TypeRole).toInt() == BookmarksModel::UrlBookmark)
+		{
+			webWidget->preconnect(m_hoveredIndex.data(BookmarksModel::UrlRole).toUrl());
+		}
+	}
 }
 
 void StartPageWidget::resizeEvent(QResizeEvent *event)
@@ -621,6 +657,8 @@ void StartPageWidget::dropEvent(QDropEvent *event)
 					case InputInterpreter::InterpreterResult::SearchType:
 						m_window->search(result.searchQuery, result.searchEngine);
 
+						InputInterpreter::redirectOnHostLookup(result, m_window);
+
 						break;
 					default:
 						break;
@@ -886,8 +924,6 @@ void StartPageWidget::startReloadingAnimation()
 
 		m_spinnerAnimation->start();
 	}
-
-	connect(m_spinnerAnimation, &Animation::frameChanged, m_listView, static_cast<void(QListView::*)()>(&QListView::update), Qt::UniqueConnection);
 }
 
 void StartPageWidget::handleOptionChanged(int identifier, const QVariant &value)
@@ -1101,6 +1137,28 @@ QPixmap StartPageWidget::createThumbnail()
 	return m_thumbnail;
 }
 
+void StartPageWidget::updateHoveredTile(const QModelIndex &index)
+{
+	if (m_hoveredIndex == index)
+	{
+		return;
+	}
+
+	if (m_hoverTimer != 0)
+	{
+		killTimer(m_hoverTimer);
+
+		m_hoverTimer = 0;
+	}
+
+	m_hoveredIndex = index;
+
+	if (index.isValid() && !m_window->isPrivate() && index.data(BookmarksModel::TypeRole).toInt() == BookmarksModel::UrlBookmark)
+	{
+		m_hoverTimer = startTimer(TileHoverDelay);
+	}
+}
+
 bool StartPageWidget::event(QEvent *event)
 {
 	if (!GesturesManager::isTracking())
@@ -1123,6 +1181,11 @@ bool StartPageWidget::event(QEvent *event)
 
 bool StartPageWidget::eventFilter(QObject *object, QEvent *event)
 {
+	if (object == m_listView->viewport() && (event->type() == QEvent::MouseMove || event->type() == QEvent::Leave))
+	{
+		updateHoveredTile((event->type() == QEvent::MouseMove && static_cast<QMouseEvent*>(event)->buttons() == Qt::NoButton) ? m_listView->indexAt(static_cast<QMouseEvent*>(event)->pos()) : QModelIndex());
+	}
+
 	if ((object == m_contentsWidget || object == m_listView || object == m_listView->viewport()) && (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::MouseButtonDblClick || event->type() == QEvent::Wheel))
 	{
 		if (event->type() == QEvent::Wheel)
@@ -89,15 +89,20 @@ public:
 	explicit StartPageContentsWidget(QWidget *parent);
 
 	void setBackgroundMode(BackgroundMode mode);
+	QPixmap getBackgroundPixmap(bool isBlurred = false);
 	QString getPixmapCachePrefix() const;
 
 protected:
 	void paintEvent(QPaintEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+	void clearBackgroundPixmap();
 
 protected slots:
 	void handleOptionChanged(int identifier);
 
 private:
+	QPixmap m_backgroundPixmap;
+	QPixmap m_blurredBackgroundPixmap;
 	QString m_path;
 	QColor m_color;
 	BackgroundMode m_mode;
@@ -120,6 +125,11 @@ public:
 	bool eventFilter(QObject *object, QEvent *event) override;
 
 protected:
+	enum HoverIntentParameter
+	{
+		TileHoverDelay = 200
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void resizeEvent(QResizeEvent *event) override;
 	void contextMenuEvent(QContextMenuEvent *event) override;
@@ -127,6 +137,7 @@ protected:
 	void dragEnterEvent(QDragEnterEvent *event) override;
 	void dropEvent(QDropEvent *event) override;
 	void startReloadingAnimation();
+	void updateHoveredTile(const QModelIndex &index);
 
 protected slots:
 	void configure();
@@ -149,7 +160,9 @@ private:
 	QPixmap m_thumbnail;
 	QTime m_urlOpenTime;
 	QModelIndex m_currentIndex;
+	QPersistentModelIndex m_hoveredIndex;
 	int m_deleteTimer;
+	int m_hoverTimer;
 	bool m_isIgnoringEnter;
 
 	static StartPageModel *m_model;
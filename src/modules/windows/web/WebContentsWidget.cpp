@@ -71,11 +71,14 @@ WebContentsWidget::WebContentsWidget(const QVariantMap &parameters, const QHash<
 	m_popupsBarWidget(nullptr),
 	m_scrollMode(NoScroll),
 	m_createStartPageTimer(0),
+	m_findHighlightTimer(0),
 	m_quickFindTimer(0),
 	m_scrollTimer(0),
+	m_throttlingTimer(0),
 	m_isTabPreferencesMenuVisible(false),
 	m_isStartPageEnabled(!isSidebarPanel() && SettingsManager::getOption(SettingsManager::StartPage_EnableStartPageOption).toBool()),
-	m_isIgnoringMouseRelease(false)
+	m_isIgnoringMouseRelease(false),
+	m_isThrottled(false)
 {
 	m_splitter->setObjectName(QLatin1String("web"));
 	m_splitter->hide();
@@ -100,6 +103,17 @@ void WebContentsWidget::timerEvent(QTimerEvent *event)
 
 		handleUrlChange(m_webWidget->getRequestedUrl());
 	}
+	else if (event->timerId() == m_findHighlightTimer)
+	{
+		killTimer(m_findHighlightTimer);
+
+		m_findHighlightTimer = 0;
+
+		if (m_searchBarWidget && m_searchBarWidget->getQuery() == m_quickFindQuery)
+		{
+			updateFindHighlight(m_searchBarWidget->getFlags());
+		}
+	}
 	else if (event->timerId() == m_quickFindTimer)
 	{
 		killTimer(m_quickFindTimer);
@@ -111,6 +125,26 @@ void WebContentsWidget::timerEvent(QTimerEvent *event)
 			m_searchBarWidget->hide();
 		}
 	}
+	else if (event->timerId() == m_throttlingTimer)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+
+		if (!isVisible() && !m_isThrottled)
+		{
+			if (getLoadingState() == WebWidget::OngoingLoadingState || m_webWidget->isAudible())
+			{
+				m_throttlingTimer = startTimer(ThrottlingDelay);
+			}
+			else
+			{
+				m_isThrottled = true;
+
+				m_webWidget->setThrottled(true);
+			}
+		}
+	}
 	else if (event->timerId() == m_scrollTimer)
 	{
 		const QPoint scrollDelta((QCursor::pos() - m_beginCursorPosition) / 20);
@@ -179,12 +213,36 @@ void WebContentsWidget::showEvent(QShowEvent *event)
 {
 	ContentsWidget::showEvent(event);
 
+	if (m_throttlingTimer != 0)
+	{
+		killTimer(m_throttlingTimer);
+
+		m_throttlingTimer = 0;
+	}
+
+	if (m_isThrottled)
+	{
+		m_isThrottled = false;
+
+		m_webWidget->setThrottled(false);
+	}
+
 	if (m_window && !m_progressBarWidget && getLoadingState() == WebWidget::OngoingLoadingState && ToolBarsManager::getToolBarDefinition(ToolBarsManager::ProgressBar).normalVisibility == ToolBarsManager::AlwaysVisibleToolBar)
 	{
 		m_progressBarWidget = new ProgressToolBarWidget(m_window, m_webWidget);
 	}
 }
 
+void WebContentsWidget::hideEvent(QHideEvent *event)
+{
+	ContentsWidget::hideEvent(event);
+
+	if (m_throttlingTimer == 0 && !m_isThrottled && !isSidebarPanel())
+	{
+		m_throttlingTimer = startTimer(ThrottlingDelay);
+	}
+}
+
 void WebContentsWidget::focusInEvent(QFocusEvent *event)
 {
 	ContentsWidget::focusInEvent(event);
@@ -679,6 +737,13 @@ void WebContentsWidget::triggerAction(int identifier, const QVariantMap &paramet
 
 void WebContentsWidget::findInPage(WebWidget::FindFlags flags)
 {
+	if (m_findHighlightTimer != 0 && flags.testFlag(WebWidget::HighlightAllFind))
+	{
+		killTimer(m_findHighlightTimer);
+
+		m_findHighlightTimer = 0;
+	}
+
 	if (m_quickFindTimer != 0)
 	{
 		killTimer(m_quickFindTimer);
@@ -1015,7 +1080,25 @@ void WebContentsWidget::handleLoadingStateChange(WebWidget::LoadingState state)
 
 void WebContentsWidget::handleFindInPageQueryChanged()
 {
-	findInPage(m_searchBarWidget ? m_searchBarWidget->getFlags() : WebWidget::HighlightAllFind);
+	WebWidget::FindFlags flags(m_searchBarWidget ? m_searchBarWidget->getFlags() : WebWidget::HighlightAllFind);
+
+	if (!flags.testFlag(WebWidget::HighlightAllFind))
+	{
+		findInPage(flags);
+
+		return;
+	}
+
+	flags &= ~WebWidget::HighlightAllFind;
+
+	findInPage(flags);
+
+	if (m_findHighlightTimer != 0)
+	{
+		killTimer(m_findHighlightTimer);
+	}
+
+	m_findHighlightTimer = startTimer(FindHighlightDelay);
 }
 
 void WebContentsWidget::notifyPermissionChanged(WebWidget::PermissionPolicies policies)
@@ -1137,6 +1220,8 @@ void WebContentsWidget::setWidget(WebWidget *widget, const QVariantMap &paramete
 		handleLoadingStateChange(WebWidget::FinishedLoadingState);
 	}
 
+	m_isThrottled = false;
+
 	if (widget)
 	{
 		widget->setParent(this);
@@ -1417,6 +1502,13 @@ QPixmap WebContentsWidget::createThumbnail()
 	return m_webWidget->createThumbnail();
 }
 
+PrintJob* WebContentsWidget::createPrintJob(QPrinter *printer)
+{
+	PrintJob *job(m_webWidget->createPrintJob(printer));
+
+	return (job ? job : ContentsWidget::createPrintJob(printer));
+}
+
 ActionsManager::ActionDefinition::State WebContentsWidget::getActionState(int identifier, const QVariantMap &parameters) const
 {
 	return m_webWidget->getActionState(identifier, parameters);
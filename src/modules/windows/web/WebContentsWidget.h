@@ -59,6 +59,7 @@ public:
 	QUrl getUrl() const override;
 	QIcon getIcon() const override;
 	QPixmap createThumbnail() override;
+	PrintJob* createPrintJob(QPrinter *printer) override;
 	ActionsManager::ActionDefinition::State getActionState(int identifier, const QVariantMap &parameters = {}) const override;
 	Session::Window::History getHistory() const override;
 	QHash<int, QVariant> getOptions() const;
@@ -96,8 +97,19 @@ protected:
 
 	Q_DECLARE_FLAGS(ScrollDirections, ScrollDirection)
 
+	enum FindInPageParameter
+	{
+		FindHighlightDelay = 250
+	};
+
+	enum ThrottlingParameter
+	{
+		ThrottlingDelay = 5000
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void showEvent(QShowEvent *event) override;
+	void hideEvent(QHideEvent *event) override;
 	void focusInEvent(QFocusEvent *event) override;
 	void resizeEvent(QResizeEvent *event) override;
 	void contextMenuEvent(QContextMenuEvent *event) override;
@@ -143,11 +155,14 @@ private:
 	QVector<PermissionBarWidget*> m_permissionBarWidgets;
 	ScrollMode m_scrollMode;
 	int m_createStartPageTimer;
+	int m_findHighlightTimer;
 	int m_quickFindTimer;
 	int m_scrollTimer;
+	int m_throttlingTimer;
 	bool m_isTabPreferencesMenuVisible;
 	bool m_isStartPageEnabled;
 	bool m_isIgnoringMouseRelease;
+	bool m_isThrottled;
 
 	static QString m_sharedQuickFindQuery;
 	static QMap<ScrollDirections, QPixmap> m_scrollCursors;
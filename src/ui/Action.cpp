@@ -24,14 +24,20 @@
 #include "../core/ThemesManager.h"
 
 #include <QtCore/QMetaMethod>
+#include <QtCore/QTimer>
 
 namespace Otter
 {
 
+QVector<QPointer<Action> > Action::m_pendingActions;
+QHash<QPair<QObject*, int>, QVector<Action::StateCacheEntry> > Action::m_statesCache;
+bool Action::m_isUpdatingPendingStates(false);
+
 Action::Action(int identifier, const QVariantMap &parameters, QObject *parent) : QAction(parent),
 	m_parameters(parameters),
 	m_flags(NoFlags),
-	m_identifier(identifier)
+	m_identifier(identifier),
+	m_isStateUpdatePending(false)
 {
 	initialize();
 }
@@ -39,7 +45,8 @@ Action::Action(int identifier, const QVariantMap &parameters, QObject *parent) :
 Action::Action(int identifier, const QVariantMap &parameters, const ActionExecutor::Object &executor, QObject *parent) : QAction(parent),
 	m_parameters(parameters),
 	m_flags(NoFlags),
-	m_identifier(identifier)
+	m_identifier(identifier),
+	m_isStateUpdatePending(false)
 {
 	initialize();
 	setExecutor(executor);
@@ -48,7 +55,8 @@ Action::Action(int identifier, const QVariantMap &parameters, const ActionExecut
 Action::Action(int identifier, const QVariantMap &parameters, const QVariantMap &options, const ActionExecutor::Object &executor, QObject *parent) : QAction(parent),
 	m_parameters(parameters),
 	m_flags(NoFlags),
-	m_identifier(identifier)
+	m_identifier(identifier),
+	m_isStateUpdatePending(false)
 {
 	initialize();
 	setExecutor(executor);
@@ -150,7 +158,7 @@ void Action::handleArbitraryActionsStateChanged(const QVector<int> &identifiers)
 {
 	if (identifiers.contains(m_identifier))
 	{
-		updateState();
+		scheduleStateUpdate();
 	}
 }
 
@@ -158,7 +166,7 @@ void Action::handleCategorizedActionsStateChanged(const QVector<int> &categories
 {
 	if (categories.contains(getDefinition().category))
 	{
-		updateState();
+		scheduleStateUpdate();
 	}
 }
 
@@ -202,7 +210,35 @@ void Action::updateState()
 	const ActionsManager::ActionDefinition definition(getDefinition());
 	ActionsManager::ActionDefinition::State state;
 
-	if (m_executor.isValid())
+	if (m_executor.isValid() && m_isUpdatingPendingStates)
+	{
+		QVector<StateCacheEntry> &entries(m_statesCache[qMakePair(m_executor.getObject(), m_identifier)]);
+		bool isCached(false);
+
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			if (entries.at(i).parameters == m_parameters)
+			{
+				state = entries.at(i).state;
+
+				isCached = true;
+
+				break;
+			}
+		}
+
+		if (!isCached)
+		{
+			StateCacheEntry entry;
+			entry.parameters = m_parameters;
+			entry.state = m_executor.getActionState(m_identifier, m_parameters);
+
+			entries.append(entry);
+
+			state = entry.state;
+		}
+	}
+	else if (m_executor.isValid())
 	{
 		state = m_executor.getActionState(m_identifier, m_parameters);
 	}
@@ -226,10 +262,48 @@ void Action::updateState()
 	setState(state);
 }
 
+void Action::scheduleStateUpdate()
+{
+	if (m_isStateUpdatePending)
+	{
+		return;
+	}
+
+	m_isStateUpdatePending = true;
+
+	if (m_pendingActions.isEmpty())
+	{
+		QTimer::singleShot(0, QCoreApplication::instance(), &Action::updatePendingStates);
+	}
+
+	m_pendingActions.append(this);
+}
+
+void Action::updatePendingStates()
+{
+	const QVector<QPointer<Action> > actions(m_pendingActions);
+
+	m_pendingActions.clear();
+	m_isUpdatingPendingStates = true;
+
+	for (int i = 0; i < actions.count(); ++i)
+	{
+		if (actions.at(i))
+		{
+			actions.at(i)->m_isStateUpdatePending = false;
+			actions.at(i)->updateState();
+		}
+	}
+
+	m_isUpdatingPendingStates = false;
+
+	m_statesCache.clear();
+}
+
 void Action::setExecutor(ActionExecutor::Object executor)
 {
 	const ActionsManager::ActionDefinition definition(getDefinition());
-	const QMetaMethod updateStateMethod(metaObject()->method(metaObject()->indexOfMethod("updateState()")));
+	const QMetaMethod updateStateMethod(metaObject()->method(metaObject()->indexOfMethod("scheduleStateUpdate()")));
 	const QMetaMethod handleArbitraryActionsStateChangedMethod(metaObject()->method(metaObject()->indexOfMethod("handleArbitraryActionsStateChanged(QVector<int>)")));
 	const QMetaMethod handleCategorizedActionsStateChangeddMethod(metaObject()->method(metaObject()->indexOfMethod("handleCategorizedActionsStateChanged(QVector<int>)")));
 
@@ -22,6 +22,7 @@
 
 #include "../core/ActionExecutor.h"
 
+#include <QtCore/QPointer>
 #include <QtWidgets/QAction>
 
 namespace Otter
@@ -52,10 +53,17 @@ public:
 	bool event(QEvent *event) override;
 
 protected:
+	struct StateCacheEntry final
+	{
+		QVariantMap parameters;
+		ActionsManager::ActionDefinition::State state;
+	};
+
 	void initialize();
 	void updateIcon();
 	void setState(const ActionsManager::ActionDefinition::State &state);
 	ActionsManager::ActionDefinition::State getState() const;
+	static void updatePendingStates();
 
 protected slots:
 	void triggerAction(bool isChecked = false);
@@ -63,6 +71,7 @@ protected slots:
 	void handleCategorizedActionsStateChanged(const QVector<int> &categories);
 	void updateShortcut();
 	void updateState();
+	void scheduleStateUpdate();
 
 private:
 	ActionExecutor::Object m_executor;
@@ -70,6 +79,11 @@ private:
 	QVariantMap m_parameters;
 	ActionFlags m_flags;
 	int m_identifier;
+	bool m_isStateUpdatePending;
+
+	static QVector<QPointer<Action> > m_pendingActions;
+	static QHash<QPair<QObject*, int>, QVector<StateCacheEntry> > m_statesCache;
+	static bool m_isUpdatingPendingStates;
 };
 
 }
@@ -20,14 +20,130 @@
 #include "Animation.h"
 #include "../core/Application.h"
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtGui/QPainter>
 
 namespace Otter
 {
 
+AnimationClock* AnimationClock::m_instance(nullptr);
+
+AnimationClock::AnimationClock(QObject *parent) : QObject(parent),
+	m_frame(0),
+	m_updateTimer(0)
+{
+}
+
+AnimationClock::~AnimationClock()
+{
+	m_instance = nullptr;
+}
+
+void AnimationClock::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer)
+	{
+		++m_frame;
+
+		emit frameAdvanced();
+	}
+}
+
+void AnimationClock::addConsumer(QObject *consumer)
+{
+	if (!m_instance)
+	{
+		m_instance = new AnimationClock(QCoreApplication::instance());
+	}
+
+	if (!m_instance->m_consumers.contains(consumer))
+	{
+		m_instance->m_consumers.insert(consumer);
+
+		connect(consumer, &QObject::destroyed, m_instance, [=]()
+		{
+			removeConsumer(consumer);
+		});
+	}
+
+	if (m_instance->m_updateTimer == 0)
+	{
+		m_instance->m_updateTimer = m_instance->startTimer(16);
+	}
+}
+
+void AnimationClock::removeConsumer(QObject *consumer)
+{
+	if (!m_instance)
+	{
+		return;
+	}
+
+	m_instance->m_consumers.remove(consumer);
+
+	disconnect(m_instance, nullptr, consumer, nullptr);
+	disconnect(consumer, nullptr, m_instance, nullptr);
+
+	if (m_instance->m_consumers.isEmpty() && m_instance->m_updateTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_updateTimer);
+		m_instance->m_updateTimer = 0;
+	}
+}
+
+AnimationClock* AnimationClock::getInstance()
+{
+	return m_instance;
+}
+
+int AnimationClock::getFrame()
+{
+	return (m_instance ? m_instance->m_frame : 0);
+}
+
 Animation::Animation(QObject *parent) : QObject(parent)
 {
+	connect(this, &Animation::frameChanged, this, &Animation::updateRegions);
+}
+
+void Animation::addRegion(QWidget *widget, const QRect &rectangle)
+{
+	for (int i = 0; i < m_regions.count(); ++i)
+	{
+		if (m_regions.at(i).first == widget && m_regions.at(i).second == rectangle)
+		{
+			return;
+		}
+	}
+
+	m_regions.append({widget, rectangle});
+}
+
+void Animation::updateRegions()
+{
+	const QVector<QPair<QPointer<QWidget>, QRect> > regions(m_regions);
+
+	m_regions.clear();
+
+	for (int i = 0; i < regions.count(); ++i)
+	{
+		QWidget *widget(regions.at(i).first.data());
+
+		if (!widget)
+		{
+			continue;
+		}
+
+		if (regions.at(i).second.isValid())
+		{
+			widget->update(regions.at(i).second);
+		}
+		else
+		{
+			widget->update();
+		}
+	}
 }
 
 GenericAnimation::GenericAnimation(const QString &path, QObject *parent) : Animation(parent),
@@ -207,32 +323,16 @@ bool GenericAnimation::isRunning() const
 SpinnerAnimation::SpinnerAnimation(QObject *parent) : Animation(parent),
 	m_color(0, 0, 0, 200),
 	m_scaledSize(16, 16),
-	m_step(0),
-	m_updateTimer(0)
+	m_isRunning(false)
 {
 }
 
-void SpinnerAnimation::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_updateTimer)
-	{
-		m_step -= 6;
-
-		if (m_step == -360)
-		{
-			m_step = 0;
-		}
-
-		emit frameChanged();
-	}
-}
-
 void SpinnerAnimation::paint(QPainter *painter, const QRect &rectangle) const
 {
 	const QSize size(rectangle.isValid() ? rectangle.size() : m_scaledSize);
 	const qreal offset(size.width() / 8.0);
 	const QRectF targetRectangle((rectangle.x() + offset), (rectangle.y() + offset), (size.width() - (offset * 2)), (size.height() - (offset * 2)));
-	QConicalGradient gradient(targetRectangle.center(), m_step);
+	QConicalGradient gradient(targetRectangle.center(), -((AnimationClock::getFrame() * 6) % 360));
 	gradient.setColorAt(0, m_color);
 	gradient.setColorAt(1, Qt::transparent);
 
@@ -245,21 +345,23 @@ void SpinnerAnimation::paint(QPainter *painter, const QRect &rectangle) const
 
 void SpinnerAnimation::start()
 {
-	if (m_updateTimer == 0)
+	if (!m_isRunning)
 	{
-		m_updateTimer = startTimer(15);
-	}
+		m_isRunning = true;
 
-	m_step = 0;
+		AnimationClock::addConsumer(this);
+
+		connect(AnimationClock::getInstance(), &AnimationClock::frameAdvanced, this, &SpinnerAnimation::frameChanged);
+	}
 }
 
 void SpinnerAnimation::stop()
 {
-	if (m_updateTimer != 0)
+	if (m_isRunning)
 	{
-		killTimer(m_updateTimer);
+		m_isRunning = false;
 
-		m_updateTimer = 0;
+		AnimationClock::removeConsumer(this);
 	}
 }
 
@@ -278,7 +380,7 @@ QPixmap SpinnerAnimation::getCurrentPixmap() const
 
 bool SpinnerAnimation::isRunning() const
 {
-	return (m_updateTimer != 0);
+	return m_isRunning;
 }
 
 void SpinnerAnimation::setColor(const QColor &color)
@@ -20,13 +20,44 @@
 #ifndef OTTER_ANIMATION_H
 #define OTTER_ANIMATION_H
 
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
 #include <QtGui/QColor>
 #include <QtGui/QMovie>
 #include <QtSvg/QSvgRenderer>
+#include <QtWidgets/QWidget>
 
 namespace Otter
 {
 
+class AnimationClock final : public QObject
+{
+	Q_OBJECT
+
+public:
+	~AnimationClock();
+
+	static void addConsumer(QObject *consumer);
+	static void removeConsumer(QObject *consumer);
+	static AnimationClock* getInstance();
+	static int getFrame();
+
+protected:
+	explicit AnimationClock(QObject *parent);
+
+	void timerEvent(QTimerEvent *event) override;
+
+private:
+	QSet<QObject*> m_consumers;
+	int m_frame;
+	int m_updateTimer;
+
+	static AnimationClock *m_instance;
+
+signals:
+	void frameAdvanced();
+};
+
 class Animation : public QObject
 {
 	Q_OBJECT
@@ -34,6 +65,7 @@ class Animation : public QObject
 public:
 	explicit Animation(QObject *parent = nullptr);
 
+	void addRegion(QWidget *widget, const QRect &rectangle = {});
 	virtual void paint(QPainter *painter, const QRect &rectangle = {}) const = 0;
 	virtual QPixmap getCurrentPixmap() const = 0;
 	virtual bool isRunning() const = 0;
@@ -44,6 +76,12 @@ public slots:
 	virtual void start() = 0;
 	virtual void stop() = 0;
 
+protected slots:
+	void updateRegions();
+
+private:
+	QVector<QPair<QPointer<QWidget>, QRect> > m_regions;
+
 signals:
 	void frameChanged();
 };
@@ -102,14 +140,10 @@ public slots:
 	void start() override;
 	void stop() override;
 
-protected:
-	void timerEvent(QTimerEvent *event) override;
-
 private:
 	QColor m_color;
 	QSize m_scaledSize;
-	int m_step;
-	int m_updateTimer;
+	bool m_isRunning;
 };
 
 }
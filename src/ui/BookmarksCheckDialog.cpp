@@ -0,0 +1,247 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BookmarksCheckDialog.h"
+#include "../core/BookmarksManager.h"
+
+#include "ui_BookmarksCheckDialog.h"
+
+namespace Otter
+{
+
+BookmarksCheckDialog::BookmarksCheckDialog(QWidget *parent) : Dialog(parent),
+	m_job(new BookmarksCheckJob(this)),
+	m_model(new QStandardItemModel(this)),
+	m_brokenItem(new QStandardItem(tr("Broken Links"))),
+	m_redirectedItem(new QStandardItem(tr("Moved Links"))),
+	m_duplicatesItem(new QStandardItem(tr("Duplicates"))),
+	m_ui(new Ui::BookmarksCheckDialog)
+{
+	m_ui->setupUi(this);
+	m_ui->progressBar->setAlignment(Qt::AlignCenter);
+
+	m_model->setHorizontalHeaderLabels({tr("Title"), tr("Address"), tr("Status")});
+	m_model->appendRow({m_brokenItem, new QStandardItem(), new QStandardItem()});
+	m_model->appendRow({m_redirectedItem, new QStandardItem(), new QStandardItem()});
+	m_model->appendRow({m_duplicatesItem, new QStandardItem(), new QStandardItem()});
+
+	m_ui->bookmarksViewWidget->setViewMode(ItemViewWidget::TreeView);
+	m_ui->bookmarksViewWidget->setModel(m_model);
+	m_ui->bookmarksViewWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+	addDuplicates();
+
+	connect(this, &BookmarksCheckDialog::finished, this, &BookmarksCheckDialog::deleteLater);
+	connect(m_job, &BookmarksCheckJob::linkChecked, this, &BookmarksCheckDialog::handleLinkChecked);
+	connect(m_job, &BookmarksCheckJob::progressChanged, m_ui->progressBar, &QProgressBar::setValue);
+	connect(m_job, &BookmarksCheckJob::jobFinished, this, &BookmarksCheckDialog::handleJobFinished);
+	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::needsActionsUpdate, this, &BookmarksCheckDialog::updateActions);
+	connect(m_ui->trashButton, &QPushButton::clicked, this, &BookmarksCheckDialog::trashBookmarks);
+	connect(m_ui->updateButton, &QPushButton::clicked, this, &BookmarksCheckDialog::updateBookmarks);
+
+	m_job->start();
+
+	if (m_job->isRunning())
+	{
+		m_ui->label->setText(tr("Checking %n address(es)…", "", m_job->getLinksAmount()));
+	}
+
+	updateActions();
+}
+
+BookmarksCheckDialog::~BookmarksCheckDialog()
+{
+	delete m_ui;
+}
+
+void BookmarksCheckDialog::changeEvent(QEvent *event)
+{
+	QDialog::changeEvent(event);
+
+	if (event->type() == QEvent::LanguageChange)
+	{
+		m_ui->retranslateUi(this);
+	}
+}
+
+void BookmarksCheckDialog::addDuplicates()
+{
+	const QVector<QVector<BookmarksModel::Bookmark*> > duplicates(BookmarksManager::getModel()->getDuplicates());
+
+	for (int i = 0; i < duplicates.count(); ++i)
+	{
+		QStandardItem *urlItem(new QStandardItem(duplicates.at(i).first()->getUrl().toDisplayString()));
+
+		for (int j = 0; j < duplicates.at(i).count(); ++j)
+		{
+			const BookmarksModel::Bookmark *folder(static_cast<BookmarksModel::Bookmark*>(duplicates.at(i).at(j)->parent()));
+
+			urlItem->appendRow(createBookmarkRow(duplicates.at(i).at(j)->getIdentifier(), (folder ? folder->getTitle() : QString())));
+		}
+
+		m_duplicatesItem->appendRow({urlItem, new QStandardItem(), new QStandardItem(tr("%n bookmark(s)", "", duplicates.at(i).count()))});
+	}
+
+	m_duplicatesItem->setText(tr("Duplicates (%1)").arg(duplicates.count()));
+}
+
+void BookmarksCheckDialog::trashBookmarks()
+{
+	const QModelIndexList indexes(m_ui->bookmarksViewWidget->selectionModel()->selectedRows());
+	QVector<QPersistentModelIndex> removedIndexes;
+
+	for (int i = 0; i < indexes.count(); ++i)
+	{
+		BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(indexes.at(i).data(IdentifierRole).toULongLong()));
+
+		if (bookmark)
+		{
+			BookmarksManager::getModel()->trashBookmark(bookmark);
+
+			removedIndexes.append(indexes.at(i));
+		}
+	}
+
+	for (int i = 0; i < removedIndexes.count(); ++i)
+	{
+		if (removedIndexes.at(i).isValid())
+		{
+			m_model->removeRow(removedIndexes.at(i).row(), removedIndexes.at(i).parent());
+		}
+	}
+
+	updateActions();
+}
+
+void BookmarksCheckDialog::updateBookmarks()
+{
+	const QModelIndexList indexes(m_ui->bookmarksViewWidget->selectionModel()->selectedRows());
+	QVector<QPersistentModelIndex> updatedIndexes;
+
+	for (int i = 0; i < indexes.count(); ++i)
+	{
+		const QUrl url(indexes.at(i).data(RedirectionUrlRole).toUrl());
+		BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(indexes.at(i).data(IdentifierRole).toULongLong()));
+
+		if (bookmark && url.isValid())
+		{
+			bookmark->setData(url, BookmarksModel::UrlRole);
+
+			updatedIndexes.append(indexes.at(i));
+		}
+	}
+
+	for (int i = 0; i < updatedIndexes.count(); ++i)
+	{
+		if (updatedIndexes.at(i).isValid())
+		{
+			m_model->removeRow(updatedIndexes.at(i).row(), updatedIndexes.at(i).parent());
+		}
+	}
+
+	updateActions();
+}
+
+void BookmarksCheckDialog::handleLinkChecked(int index)
+{
+	const BookmarksCheckJob::LinkInformation link(m_job->getLink(index));
+	QStandardItem *parent(nullptr);
+	QString status;
+
+	switch (link.state)
+	{
+		case BookmarksCheckJob::BrokenLinkState:
+			parent = m_brokenItem;
+			status = ((link.statusCode > 0) ? QStringLiteral("%1 %2").arg(link.statusCode).arg(link.errorString) : link.errorString);
+
+			break;
+		case BookmarksCheckJob::UnreachableLinkState:
+			parent = m_brokenItem;
+			status = link.errorString;
+
+			break;
+		case BookmarksCheckJob::RedirectedLinkState:
+			parent = m_redirectedItem;
+			status = link.redirectionUrl.toDisplayString();
+
+			break;
+		default:
+			return;
+	}
+
+	for (int i = 0; i < link.bookmarks.count(); ++i)
+	{
+		parent->appendRow(createBookmarkRow(link.bookmarks.at(i), status, ((link.state == BookmarksCheckJob::RedirectedLinkState) ? link.redirectionUrl : QUrl())));
+	}
+
+	m_brokenItem->setText(tr("Broken Links (%1)").arg(m_brokenItem->rowCount()));
+	m_redirectedItem->setText(tr("Moved Links (%1)").arg(m_redirectedItem->rowCount()));
+}
+
+void BookmarksCheckDialog::handleJobFinished(bool isSuccess)
+{
+	m_ui->progressBar->hide();
+	m_ui->label->setText(isSuccess ? tr("Bookmarks check finished.") : tr("Bookmarks check was cancelled."));
+}
+
+void BookmarksCheckDialog::updateActions()
+{
+	const QModelIndexList indexes(m_ui->bookmarksViewWidget->selectionModel() ? m_ui->bookmarksViewWidget->selectionModel()->selectedRows() : QModelIndexList());
+	bool canTrash(false);
+	bool canUpdate(false);
+
+	for (int i = 0; i < indexes.count(); ++i)
+	{
+		if (indexes.at(i).data(IdentifierRole).isValid())
+		{
+			canTrash = true;
+		}
+
+		if (indexes.at(i).data(RedirectionUrlRole).isValid())
+		{
+			canUpdate = true;
+		}
+	}
+
+	m_ui->trashButton->setEnabled(canTrash);
+	m_ui->updateButton->setEnabled(canUpdate);
+}
+
+QList<QStandardItem*> BookmarksCheckDialog::createBookmarkRow(quint64 identifier, const QString &status, const QUrl &redirectionUrl) const
+{
+	const BookmarksModel::Bookmark *bookmark(BookmarksManager::getModel()->getBookmark(identifier));
+	QList<QStandardItem*> items({new QStandardItem(bookmark ? bookmark->getTitle() : QString()), new QStandardItem(bookmark ? bookmark->getUrl().toDisplayString() : QString()), new QStandardItem(status)});
+
+	for (int i = 0; i < items.count(); ++i)
+	{
+		items[i]->setData(identifier, IdentifierRole);
+
+		if (redirectionUrl.isValid())
+		{
+			items[i]->setData(redirectionUrl, RedirectionUrlRole);
+		}
+	}
+
+	items[0]->setIcon(bookmark ? bookmark->getIcon() : QIcon());
+	items[2]->setToolTip(status);
+
+	return items;
+}
+
+}
@@ -0,0 +1,73 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_BOOKMARKSCHECKDIALOG_H
+#define OTTER_BOOKMARKSCHECKDIALOG_H
+
+#include "Dialog.h"
+#include "../core/Job.h"
+
+#include <QtGui/QStandardItemModel>
+
+namespace Otter
+{
+
+namespace Ui
+{
+	class BookmarksCheckDialog;
+}
+
+class BookmarksCheckDialog final : public Dialog
+{
+	Q_OBJECT
+
+public:
+	explicit BookmarksCheckDialog(QWidget *parent = nullptr);
+	~BookmarksCheckDialog();
+
+protected:
+	enum DataRole
+	{
+		IdentifierRole = Qt::UserRole,
+		RedirectionUrlRole
+	};
+
+	void changeEvent(QEvent *event) override;
+	void addDuplicates();
+	QList<QStandardItem*> createBookmarkRow(quint64 identifier, const QString &status, const QUrl &redirectionUrl = {}) const;
+
+protected slots:
+	void trashBookmarks();
+	void updateBookmarks();
+	void handleLinkChecked(int index);
+	void handleJobFinished(bool isSuccess);
+	void updateActions();
+
+private:
+	BookmarksCheckJob *m_job;
+	QStandardItemModel *m_model;
+	QStandardItem *m_brokenItem;
+	QStandardItem *m_redirectedItem;
+	QStandardItem *m_duplicatesItem;
+	Ui::BookmarksCheckDialog *m_ui;
+};
+
+}
+
+#endif
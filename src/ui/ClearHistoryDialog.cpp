@@ -26,16 +26,19 @@
 
 #include "ui_ClearHistoryDialog.h"
 
+#include <QtCore/QTimer>
 #include <QtWidgets/QPushButton>
 
 namespace Otter
 {
 
 ClearHistoryDialog::ClearHistoryDialog(const QStringList &clearSettings, bool isConfiguring, QWidget *parent) : Dialog(parent),
+	m_isCancelled(false),
 	m_isConfiguring(isConfiguring),
 	m_ui(new Ui::ClearHistoryDialog)
 {
 	m_ui->setupUi(this);
+	m_ui->progressBar->hide();
 
 	QStringList settings(clearSettings);
 	settings.removeAll({});
@@ -48,13 +51,19 @@ ClearHistoryDialog::ClearHistoryDialog(const QStringList &clearSettings, bool is
 	if (m_isConfiguring)
 	{
 		m_ui->periodWidget->hide();
+
+		connect(m_ui->buttonBox, &QDialogButtonBox::accepted, this, &ClearHistoryDialog::accept);
 	}
 	else
 	{
 		m_ui->buttonBox->button(QDialogButtonBox::Ok)->setText(tr("Clear Now"));
 		m_ui->periodSpinBox->setValue(SettingsManager::getOption(SettingsManager::History_ManualClearPeriodOption).toInt());
 
-		connect(this, &ClearHistoryDialog::accepted, this, &ClearHistoryDialog::clearHistory);
+		connect(m_ui->buttonBox, &QDialogButtonBox::accepted, this, &ClearHistoryDialog::clearHistory);
+		connect(this, &ClearHistoryDialog::rejected, [&]()
+		{
+			m_isCancelled = true;
+		});
 	}
 
 	m_ui->clearBrowsingHistoryCheckBox->setChecked(settings.contains(QLatin1String("browsing")));
@@ -89,33 +98,102 @@ void ClearHistoryDialog::changeEvent(QEvent *event)
 
 void ClearHistoryDialog::clearHistory()
 {
+	SettingsManager::setOption(SettingsManager::History_ManualClearOptionsOption, getClearSettings());
+	SettingsManager::setOption(SettingsManager::History_ManualClearPeriodOption, m_ui->periodSpinBox->value());
+
+	m_pendingSteps.clear();
+
 	if (m_ui->clearBrowsingHistoryCheckBox->isChecked())
 	{
-		HistoryManager::clearHistory(static_cast<uint>(m_ui->periodSpinBox->value()));
+		m_pendingSteps.append(BrowsingHistoryStep);
 	}
 
 	if (m_ui->clearCookiesCheckBox->isChecked())
 	{
-		NetworkManagerFactory::clearCookies(m_ui->periodSpinBox->value());
+		m_pendingSteps.append(CookiesStep);
 	}
 
 	if (m_ui->clearDownloadsHistoryCheckBox->isChecked())
 	{
-		TransfersManager::clearTransfers(m_ui->periodSpinBox->value());
+		m_pendingSteps.append(DownloadsHistoryStep);
 	}
 
 	if (m_ui->clearCachesCheckBox->isChecked())
 	{
-		NetworkManagerFactory::clearCache(m_ui->periodSpinBox->value());
+		m_pendingSteps.append(CachesStep);
 	}
 
 	if (m_ui->clearPasswordsCheckBox->isChecked())
 	{
-		PasswordsManager::clearPasswords(m_ui->periodSpinBox->value());
+		m_pendingSteps.append(PasswordsStep);
 	}
 
-	SettingsManager::setOption(SettingsManager::History_ManualClearOptionsOption, getClearSettings());
-	SettingsManager::setOption(SettingsManager::History_ManualClearPeriodOption, m_ui->periodSpinBox->value());
+	if (m_pendingSteps.isEmpty())
+	{
+		accept();
+
+		return;
+	}
+
+	const QList<QCheckBox*> checkBoxes(findChildren<QCheckBox*>());
+
+	for (int i = 0; i < checkBoxes.count(); ++i)
+	{
+		checkBoxes.at(i)->setEnabled(false);
+	}
+
+	m_ui->periodWidget->setEnabled(false);
+	m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+	m_ui->progressBar->setRange(0, m_pendingSteps.count());
+	m_ui->progressBar->setValue(0);
+	m_ui->progressBar->show();
+
+	QTimer::singleShot(0, this, &ClearHistoryDialog::runNextStep);
+}
+
+void ClearHistoryDialog::runNextStep()
+{
+	if (m_isCancelled)
+	{
+		return;
+	}
+
+	if (m_pendingSteps.isEmpty())
+	{
+		accept();
+
+		return;
+	}
+
+	const int period(m_ui->periodSpinBox->value());
+
+	switch (m_pendingSteps.takeFirst())
+	{
+		case BrowsingHistoryStep:
+			HistoryManager::clearHistory(static_cast<uint>(period));
+
+			break;
+		case CookiesStep:
+			NetworkManagerFactory::clearCookies(period);
+
+			break;
+		case DownloadsHistoryStep:
+			TransfersManager::clearTransfers(period);
+
+			break;
+		case CachesStep:
+			NetworkManagerFactory::clearCache(period);
+
+			break;
+		case PasswordsStep:
+			PasswordsManager::clearPasswords(period);
+
+			break;
+	}
+
+	m_ui->progressBar->setValue(m_ui->progressBar->maximum() - m_pendingSteps.count());
+
+	QTimer::singleShot(0, this, &ClearHistoryDialog::runNextStep);
 }
 
 QStringList ClearHistoryDialog::getClearSettings() const
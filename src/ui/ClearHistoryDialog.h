@@ -22,6 +22,8 @@
 
 #include "Dialog.h"
 
+#include <QtCore/QVector>
+
 namespace Otter
 {
 
@@ -42,12 +44,24 @@ public:
 	static QStringList getDefaultClearSettings();
 
 protected:
+	enum ClearingStep
+	{
+		BrowsingHistoryStep = 0,
+		CookiesStep,
+		DownloadsHistoryStep,
+		CachesStep,
+		PasswordsStep
+	};
+
 	void changeEvent(QEvent *event) override;
 
 protected slots:
 	void clearHistory();
+	void runNextStep();
 
 private:
+	QVector<ClearingStep> m_pendingSteps;
+	bool m_isCancelled;
 	bool m_isConfiguring;
 	Ui::ClearHistoryDialog *m_ui;
 };
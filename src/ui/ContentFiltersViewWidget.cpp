@@ -25,7 +25,10 @@
 #include "../core/ThemesManager.h"
 #include "../core/Utils.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
 #include <QtWidgets/QCheckBox>
@@ -199,6 +202,7 @@ Animation* ContentFiltersViewWidget::m_updateAnimation = nullptr;
 
 ContentFiltersViewWidget::ContentFiltersViewWidget(QWidget *parent) : ItemViewWidget(parent),
 	m_model(new ItemModel(this)),
+	m_rulesInformationRequest(0),
 	m_areProfilesModified(false)
 {
 	setModel(m_model);
@@ -208,7 +212,7 @@ ContentFiltersViewWidget::ContentFiltersViewWidget(QWidget *parent) : ItemViewWi
 	getViewportWidget()->setMouseTracking(true);
 	getViewportWidget()->setUpdateDataRole(IsShowingProgressIndicatorRole);
 
-	m_model->setHorizontalHeaderLabels({tr("Title"), tr("Update Interval"), tr("Last Update"), tr("Active Rules"), tr("All Rules")});
+	m_model->setHorizontalHeaderLabels({tr("Title"), tr("Update Interval"), tr("Last Update"), tr("Active Rules"), tr("All Rules"), tr("Matched Rules")});
 	m_model->setHeaderData(0, Qt::Horizontal, true, HeaderViewWidget::IsShowingCheckBoxIndicatorRole);
 	m_model->setHeaderData(0, Qt::Horizontal, 250, HeaderViewWidget::WidthRole);
 
@@ -224,11 +228,9 @@ ContentFiltersViewWidget::ContentFiltersViewWidget(QWidget *parent) : ItemViewWi
 
 		if (!profileItems.isEmpty())
 		{
-			const QHash<AdblockContentFiltersProfile::RuleType, quint32> information(getRulesInformation(profile->getProfileSummary(), profile->getPath()));
-
 			profileItems[0]->setData(createLanguagesList(profile), LanguagesRole);
-			profileItems[3]->setText(QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)));
-			profileItems[4]->setText(QString::number(information.value(AdblockContentFiltersProfile::AnyRule)));
+
+			requestRulesInformation(profileItems[3], profileItems[4], profile->getProfileSummary(), profile->getPath());
 
 			if (!categoryEntries.contains(category))
 			{
@@ -282,7 +284,7 @@ void ContentFiltersViewWidget::changeEvent(QEvent *event)
 
 	if (event->type() == QEvent::LanguageChange)
 	{
-		m_model->setHorizontalHeaderLabels({tr("Title"), tr("Update Interval"), tr("Last Update"), tr("Active Rules"), tr("All Rules")});
+		m_model->setHorizontalHeaderLabels({tr("Title"), tr("Update Interval"), tr("Last Update"), tr("Active Rules"), tr("All Rules"), tr("Matched Rules")});
 
 		for (int i = 0; i < getRowCount(); ++i)
 		{
@@ -319,6 +321,7 @@ void ContentFiltersViewWidget::contextMenuEvent(QContextMenuEvent *event)
 		menu.addSeparator();
 		menu.addAction(tr("Edit…"), this, &ContentFiltersViewWidget::editProfile);
 		menu.addAction(tr("Update"), this, &ContentFiltersViewWidget::updateProfile)->setEnabled(index.isValid() && index.data(UpdateUrlRole).toUrl().isValid());
+		menu.addAction(tr("Export Compacted Profile…"), this, &ContentFiltersViewWidget::exportCompactedProfile)->setEnabled(ContentFiltersManager::areRuleStatisticsEnabled() && getProfile(index) != nullptr);
 		menu.addSeparator();
 		menu.addAction(ThemesManager::createIcon(QLatin1String("edit-delete")), tr("Remove"), this, &ContentFiltersViewWidget::removeProfile);
 	}
@@ -501,8 +504,6 @@ void ContentFiltersViewWidget::editProfile()
 		{
 			profileSummary = dialog.getProfile();
 
-			const QHash<AdblockContentFiltersProfile::RuleType, quint32> information(getRulesInformation(profileSummary, path));
-
 			m_model->setData(index, true, IsModifiedRole);
 			m_model->setData(index, profileSummary.title, TitleRole);
 			m_model->setData(index, profileSummary.updateUrl, UpdateUrlRole);
@@ -511,10 +512,11 @@ void ContentFiltersViewWidget::editProfile()
 			m_model->setData(index.sibling(index.row(), 1), profileSummary.updateInterval, Qt::DisplayRole);
 			m_model->setData(index.sibling(index.row(), 1), profileSummary.updateUrl, UpdateUrlRole);
 			m_model->setData(index.sibling(index.row(), 2), profileSummary.updateUrl, UpdateUrlRole);
-			m_model->setData(index.sibling(index.row(), 3), QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)), Qt::DisplayRole);
 			m_model->setData(index.sibling(index.row(), 3), profileSummary.updateUrl, UpdateUrlRole);
-			m_model->setData(index.sibling(index.row(), 4), QString::number(information.value(AdblockContentFiltersProfile::AnyRule)), Qt::DisplayRole);
 			m_model->setData(index.sibling(index.row(), 4), profileSummary.updateUrl, UpdateUrlRole);
+			m_model->setData(index.sibling(index.row(), 5), profileSummary.updateUrl, UpdateUrlRole);
+
+			requestRulesInformation(m_model->itemFromIndex(index.sibling(index.row(), 3)), m_model->itemFromIndex(index.sibling(index.row(), 4)), profileSummary, path);
 
 			if (index.parent().data(CategoryRole).toInt() != profileSummary.category)
 			{
@@ -526,6 +528,23 @@ void ContentFiltersViewWidget::editProfile()
 	}
 }
 
+void ContentFiltersViewWidget::exportCompactedProfile()
+{
+	const ContentFiltersProfile *profile(getProfile(currentIndex().sibling(currentIndex().row(), 0)));
+
+	if (!profile)
+	{
+		return;
+	}
+
+	const QString path(QFileDialog::getSaveFileName(this, tr("Select File"), QDir(QStandardPaths::standardLocations(QStandardPaths::HomeLocation).value(0)).filePath(profile->getName() + QLatin1String("-compacted.txt")), tr("AdBlock files (*.txt)")));
+
+	if (!path.isEmpty() && !ContentFiltersManager::exportCompactedProfile(profile->getName(), path))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Failed to export compacted profile."), QMessageBox::Close);
+	}
+}
+
 void ContentFiltersViewWidget::removeProfile()
 {
 	const QModelIndex index(currentIndex().sibling(currentIndex().row(), 0));
@@ -585,8 +604,6 @@ void ContentFiltersViewWidget::updateProfile()
 		}
 
 		m_updateAnimation->start();
-
-		getViewportWidget()->updateDirtyIndexesList();
 	}
 
 	profile->update();
@@ -602,6 +619,71 @@ void ContentFiltersViewWidget::updateSelection()
 	}
 }
 
+void ContentFiltersViewWidget::requestRulesInformation(QStandardItem *activeRulesItem, QStandardItem *allRulesItem, const ContentFiltersProfile::ProfileSummary &profileSummary, const QString &path)
+{
+	if (!activeRulesItem || !allRulesItem)
+	{
+		return;
+	}
+
+	const AdblockContentFiltersProfile *profile(qobject_cast<AdblockContentFiltersProfile*>(ContentFiltersManager::getProfile(profileSummary.name)));
+	const QHash<AdblockContentFiltersProfile::RuleType, quint32> information((profile && profile->getPath() == path) ? profile->getRulesInformation(profileSummary) : QHash<AdblockContentFiltersProfile::RuleType, quint32>());
+
+	if (!information.isEmpty())
+	{
+		m_rulesInformationRequests.remove(profileSummary.name);
+
+		activeRulesItem->setText(QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)));
+		allRulesItem->setText(QString::number(information.value(AdblockContentFiltersProfile::AnyRule)));
+
+		return;
+	}
+
+	activeRulesItem->setText(QString(QChar(0x2026)));
+	allRulesItem->setText(QString(QChar(0x2026)));
+
+	const QString name(profileSummary.name);
+	const int request(++m_rulesInformationRequest);
+	QFutureWatcher<QHash<AdblockContentFiltersProfile::RuleType, quint32> > *watcher(new QFutureWatcher<QHash<AdblockContentFiltersProfile::RuleType, quint32> >(this));
+
+	m_rulesInformationRequests[name] = request;
+
+	connect(watcher, &QFutureWatcher<QHash<AdblockContentFiltersProfile::RuleType, quint32> >::finished, this, [=]()
+	{
+		if (m_rulesInformationRequests.value(name) == request)
+		{
+			m_rulesInformationRequests.remove(name);
+
+			setRulesInformation(name, watcher->result());
+		}
+
+		watcher->deleteLater();
+	});
+
+	watcher->setFuture(QtConcurrent::run(&ContentFiltersViewWidget::getRulesInformation, profileSummary, path));
+}
+
+void ContentFiltersViewWidget::setRulesInformation(const QString &name, const QHash<AdblockContentFiltersProfile::RuleType, quint32> &information)
+{
+	for (int i = 0; i < getRowCount(); ++i)
+	{
+		const QModelIndex categoryIndex(getIndex(i));
+
+		for (int j = 0; j < getRowCount(categoryIndex); ++j)
+		{
+			const QModelIndex entryIndex(getIndex(j, 0, categoryIndex));
+
+			if (entryIndex.data(NameRole).toString() == name)
+			{
+				m_model->setData(entryIndex.sibling(j, 3), QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)), Qt::DisplayRole);
+				m_model->setData(entryIndex.sibling(j, 4), QString::number(information.value(AdblockContentFiltersProfile::AnyRule)), Qt::DisplayRole);
+
+				return;
+			}
+		}
+	}
+}
+
 void ContentFiltersViewWidget::handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
 {
 	Q_UNUSED(topLeft)
@@ -636,11 +718,9 @@ void ContentFiltersViewWidget::handleProfileAdded(const QString &name)
 
 				if (categoryItem)
 				{
-					const QHash<AdblockContentFiltersProfile::RuleType, quint32> information(getRulesInformation(profile->getProfileSummary(), profile->getPath()));
-
 					profileItems[0]->setData(createLanguagesList(profile), LanguagesRole);
-					profileItems[3]->setText(QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)));
-					profileItems[4]->setText(QString::number(information.value(AdblockContentFiltersProfile::AnyRule)));
+
+					requestRulesInformation(profileItems[3], profileItems[4], profile->getProfileSummary(), profile->getPath());
 
 					categoryItem->appendRow(profileItems);
 
@@ -729,10 +809,8 @@ void ContentFiltersViewWidget::handleProfileModified(const QString &name)
 				}
 
 				const QModelIndex entryIndex(entryItem->index());
-				const QHash<AdblockContentFiltersProfile::RuleType, quint32> information(getRulesInformation(getProfileSummary(entryIndex), getProfilePath(entryIndex)));
 
-				m_model->setData(entryIndex.sibling(entryIndex.row(), 3), QString::number(information.value(AdblockContentFiltersProfile::ActiveRule)), Qt::DisplayRole);
-				m_model->setData(entryIndex.sibling(entryIndex.row(), 4), QString::number(information.value(AdblockContentFiltersProfile::AnyRule)), Qt::DisplayRole);
+				requestRulesInformation(m_model->itemFromIndex(entryIndex.sibling(entryIndex.row(), 3)), m_model->itemFromIndex(entryIndex.sibling(entryIndex.row(), 4)), getProfileSummary(entryIndex), getProfilePath(entryIndex));
 
 				QTimer::singleShot(2500, this, [=]()
 				{
@@ -1021,7 +1099,7 @@ QStringList ContentFiltersViewWidget::getProfileNames() const
 
 QList<QStandardItem*> ContentFiltersViewWidget::createEntry(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &profiles, bool isModified) const
 {
-	QList<QStandardItem*> items({new QStandardItem(profileSummary.title), new QStandardItem(QString::number(profileSummary.updateInterval)), new QStandardItem(Utils::formatDateTime(profileSummary.lastUpdate)), new QStandardItem(), new QStandardItem()});
+	QList<QStandardItem*> items({new QStandardItem(profileSummary.title), new QStandardItem(QString::number(profileSummary.updateInterval)), new QStandardItem(Utils::formatDateTime(profileSummary.lastUpdate)), new QStandardItem(), new QStandardItem(), new QStandardItem()});
 	items[0]->setData(profileSummary.name, NameRole);
 	items[0]->setData(profileSummary.areWildcardsEnabled, AreWildcardsEnabledRole);
 	items[0]->setData(profileSummary.cosmeticFiltersMode, CosmeticFiltersModeRole);
@@ -1043,6 +1121,30 @@ QList<QStandardItem*> ContentFiltersViewWidget::createEntry(const ContentFilters
 	items[3]->setFlags(Qt::ItemNeverHasChildren | Qt::ItemIsSelectable | Qt::ItemIsEnabled);
 	items[4]->setData(profileSummary.updateUrl, UpdateUrlRole);
 	items[4]->setFlags(Qt::ItemNeverHasChildren | Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+	items[5]->setData(profileSummary.updateUrl, UpdateUrlRole);
+	items[5]->setFlags(Qt::ItemNeverHasChildren | Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+
+	if (ContentFiltersManager::areRuleStatisticsEnabled())
+	{
+		const QHash<QString, ContentFiltersManager::RuleStatistics> statistics(ContentFiltersManager::getRuleStatistics(profileSummary.name));
+		const qint64 threshold((QDateTime::currentMSecsSinceEpoch() / 1000) - (static_cast<qint64>(qMax(0, SettingsManager::getOption(SettingsManager::ContentBlocking_RuleStatisticsPeriodOption).toInt())) * 86400));
+		QHash<QString, ContentFiltersManager::RuleStatistics>::const_iterator iterator;
+		quint64 hits(0);
+		int amount(0);
+
+		for (iterator = statistics.constBegin(); iterator != statistics.constEnd(); ++iterator)
+		{
+			hits += iterator.value().hits;
+
+			if (iterator.value().lastHitTime >= threshold)
+			{
+				++amount;
+			}
+		}
+
+		items[5]->setText(QString::number(amount));
+		items[5]->setToolTip(tr("Total hits: %1").arg(hits));
+	}
 
 	return items;
 }
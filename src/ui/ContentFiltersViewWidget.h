@@ -87,6 +87,7 @@ public slots:
 	void importProfileFromFile();
 	void importProfileFromUrl();
 	void editProfile();
+	void exportCompactedProfile();
 	void removeProfile();
 	void updateProfile();
 	void setHost(const QString &host);
@@ -98,9 +99,11 @@ protected:
 	void markProfilesAsModified();
 	void appendProfile(QList<QStandardItem*> items, ContentFiltersProfile::ProfileCategory category);
 	void moveProfile(QStandardItem *entryItem, ContentFiltersProfile::ProfileCategory newCategory);
+	void requestRulesInformation(QStandardItem *activeRulesItem, QStandardItem *allRulesItem, const ContentFiltersProfile::ProfileSummary &profileSummary, const QString &path);
+	void setRulesInformation(const QString &name, const QHash<AdblockContentFiltersProfile::RuleType, quint32> &information);
 	QString getProfilePath(const QModelIndex &index) const;
 	ContentFiltersProfile::ProfileSummary getProfileSummary(const QModelIndex &index) const;
-	QHash<AdblockContentFiltersProfile::RuleType, quint32> getRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary, const QString &path);
+	static QHash<AdblockContentFiltersProfile::RuleType, quint32> getRulesInformation(const ContentFiltersProfile::ProfileSummary &profileSummary, const QString &path);
 	QStringList createLanguagesList(const ContentFiltersProfile *profile) const;
 	QStringList getProfileNames() const;
 	QList<QStandardItem*> createEntry(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &profiles = {}, bool isModified = true) const;
@@ -118,6 +121,8 @@ private:
 	QString m_host;
 	QHash<QString, bool> m_profilesToRemove;
 	QStringList m_filesToRemove;
+	QHash<QString, int> m_rulesInformationRequests;
+	int m_rulesInformationRequest;
 	bool m_areProfilesModified;
 
 	static Animation* m_updateAnimation;
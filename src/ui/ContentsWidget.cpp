@@ -24,6 +24,7 @@
 #include "Window.h"
 #include "../core/Application.h"
 
+#include <QtCore/QTimer>
 #include <QtPrintSupport/QPrintDialog>
 #include <QtPrintSupport/QPrintPreviewDialog>
 
@@ -141,16 +142,20 @@ void ContentsWidget::triggerAction(int identifier, const QVariantMap &parameters
 	{
 		case ActionsManager::PrintAction:
 			{
-				QPrinter printer;
-				printer.setCreator(QStringLiteral("Otter Browser %1").arg(Application::getFullVersion()));
-				printer.setDocName(getTitle());
+				QPrinter *printer(new QPrinter());
+				printer->setCreator(QStringLiteral("Otter Browser %1").arg(Application::getFullVersion()));
+				printer->setDocName(getTitle());
 
-				QPrintDialog printDialog(&printer, this);
+				QPrintDialog printDialog(printer, this);
 				printDialog.setWindowTitle(tr("Print Page"));
 
 				if (printDialog.exec() == QDialog::Accepted)
 				{
-					print(&printer);
+					PrintJob::schedule(createPrintJob(printer));
+				}
+				else
+				{
+					delete printer;
 				}
 			}
 
@@ -395,6 +400,11 @@ QPixmap ContentsWidget::createThumbnail()
 	return {};
 }
 
+PrintJob* ContentsWidget::createPrintJob(QPrinter *printer)
+{
+	return new ContentsWidgetPrintJob(printer, this);
+}
+
 ActionsManager::ActionDefinition::State ContentsWidget::getActionState(int identifier, const QVariantMap &parameters) const
 {
 	Q_UNUSED(parameters)
@@ -529,4 +539,48 @@ Window* ActiveWindowObserverContentsWidget::getActiveWindow() const
 	return m_activeWindow;
 }
 
+ContentsWidgetPrintJob::ContentsWidgetPrintJob(QPrinter *printer, ContentsWidget *parent) : PrintJob(printer, parent),
+	m_widget(parent),
+	m_isRunning(false)
+{
+}
+
+void ContentsWidgetPrintJob::start()
+{
+	m_isRunning = true;
+
+	setProgress(0);
+
+	QTimer::singleShot(0, this, [&]()
+	{
+		if (!m_isRunning)
+		{
+			return;
+		}
+
+		m_isRunning = false;
+
+		if (m_widget)
+		{
+			m_widget->print(getPrinter());
+		}
+
+		setProgress(100);
+
+		emit jobFinished(!m_widget.isNull());
+	});
+}
+
+void ContentsWidgetPrintJob::cancel()
+{
+	m_isRunning = false;
+
+	emit jobFinished(false);
+}
+
+bool ContentsWidgetPrintJob::isRunning() const
+{
+	return m_isRunning;
+}
+
 }
@@ -21,6 +21,7 @@
 #define OTTER_CONTENTSWIDGET_H
 
 #include "WebWidget.h"
+#include "../core/Job.h"
 
 #include <QtCore/QPointer>
 
@@ -51,6 +52,7 @@ public:
 	virtual QUrl getUrl() const = 0;
 	virtual QIcon getIcon() const = 0;
 	virtual QPixmap createThumbnail();
+	virtual PrintJob* createPrintJob(QPrinter *printer);
 	ActionsManager::ActionDefinition::State getActionState(int identifier, const QVariantMap &parameters = {}) const override;
 	virtual Session::Window::History getHistory() const;
 	virtual WebWidget::ContentStates getContentState() const;
@@ -135,6 +137,24 @@ signals:
 	void activeWindowChanged(Window *window, Window *previousWindow);
 };
 
+class ContentsWidgetPrintJob final : public PrintJob
+{
+	Q_OBJECT
+
+public:
+	explicit ContentsWidgetPrintJob(QPrinter *printer, ContentsWidget *parent);
+
+	bool isRunning() const override;
+
+public slots:
+	void start() override;
+	void cancel() override;
+
+private:
+	QPointer<ContentsWidget> m_widget;
+	bool m_isRunning;
+};
+
 }
 
 #endif
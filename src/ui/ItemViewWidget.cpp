@@ -20,12 +20,16 @@
 **************************************************************************/
 
 #include "ItemViewWidget.h"
+#include "Animation.h"
 #include "ItemDelegate.h"
 #include "Menu.h"
 #include "../core/IniSettings.h"
+#include "../core/PersistenceManager.h"
 #include "../core/SessionsManager.h"
 #include "../core/ThemesManager.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTimer>
 #include <QtGui/QDropEvent>
 #include <QtGui/QPainter>
@@ -37,8 +41,7 @@ namespace Otter
 ViewportWidget::ViewportWidget(ItemViewWidget *parent) : QWidget(parent),
 	m_view(parent),
 	m_updateDataRole(-1),
-	m_recheckTimer(0),
-	m_updateTimer(0)
+	m_recheckTimer(0)
 {
 	setAcceptDrops(true);
 	setAutoFillBackground(true);
@@ -49,53 +52,182 @@ void ViewportWidget::timerEvent(QTimerEvent *event)
 {
 	if (event->timerId() == m_recheckTimer)
 	{
-		updateDirtyIndexesList();
+		const QList<QPersistentModelIndex> indexes(m_dirtyIndexes.values());
+
+		for (int i = 0; i < indexes.count(); ++i)
+		{
+			updateDirtyIndex(indexes.at(i));
+		}
+
+		updateTimers();
 	}
-	else if (event->timerId() == m_updateTimer)
+}
+
+void ViewportWidget::updateDirtyRegion()
+{
+	const QRect visibleRectangle(rect());
+	QRegion region;
+	QSet<QPersistentModelIndex>::iterator iterator(m_dirtyIndexes.begin());
+
+	while (iterator != m_dirtyIndexes.end())
 	{
-		QRegion region;
+		if (!iterator->isValid())
+		{
+			iterator = m_dirtyIndexes.erase(iterator);
+
+			continue;
+		}
+
+		const QRect indexRectangle(m_view->visualRect(*iterator));
 
-		for (int i = 0; i < m_dirtyIndexes.count(); ++i)
+		if (indexRectangle.intersects(visibleRectangle))
 		{
-			region += m_view->visualRect(m_dirtyIndexes.at(i));
+			region += indexRectangle;
 		}
 
-		if (!region.isEmpty())
+		++iterator;
+	}
+
+	if (!region.isEmpty())
+	{
+		update(region);
+	}
+
+	if (m_dirtyIndexes.isEmpty())
+	{
+		updateTimers();
+	}
+}
+
+void ViewportWidget::updateDirtyIndexes(const QModelIndex &parent, int from, int to, bool isRecursive)
+{
+	if (!m_model)
+	{
+		return;
+	}
+
+	for (int i = from; i <= to; ++i)
+	{
+		const QModelIndex index(m_model->index(i, 0, parent));
+
+		updateDirtyIndex(index);
+
+		if (isRecursive && m_model->hasChildren(index))
 		{
-			update(region);
+			updateDirtyIndexes(index, 0, (m_model->rowCount(index) - 1), true);
 		}
 	}
 }
 
-void ViewportWidget::updateDirtyIndexesList()
+void ViewportWidget::updateDirtyIndex(const QModelIndex &index)
 {
-	const QVector<QModelIndex> previousDirtyIndexes(m_dirtyIndexes);
+	if (!index.isValid())
+	{
+		return;
+	}
 
-	m_dirtyIndexes = m_view->model()->match(m_view->model()->index(0, 0), m_updateDataRole, true, -1, (Qt::MatchExactly | Qt::MatchRecursive)).toVector();
+	const bool isDirty(index.data(m_updateDataRole).toBool());
+	const QPersistentModelIndex persistentIndex(index);
 
-	if (previousDirtyIndexes != m_dirtyIndexes)
+	if (isDirty == m_dirtyIndexes.contains(persistentIndex))
 	{
-		update();
+		return;
+	}
 
-		if (m_dirtyIndexes.isEmpty() && m_updateTimer > 0)
+	if (isDirty)
+	{
+		m_dirtyIndexes.insert(persistentIndex);
+	}
+	else
+	{
+		m_dirtyIndexes.remove(persistentIndex);
+	}
+
+	update(m_view->visualRect(index));
+}
+
+void ViewportWidget::updateDirtyIndexesList()
+{
+	m_dirtyIndexes.clear();
+
+	if (m_model && m_updateDataRole >= 0)
+	{
+		updateDirtyIndexes({}, 0, (m_model->rowCount() - 1), true);
+	}
+
+	update();
+	updateTimers();
+}
+
+void ViewportWidget::updateTimers()
+{
+	if (m_dirtyIndexes.isEmpty())
+	{
+		if (m_recheckTimer != 0)
 		{
 			killTimer(m_recheckTimer);
-			killTimer(m_updateTimer);
 
 			m_recheckTimer = 0;
-			m_updateTimer = 0;
-		}
-		else if (previousDirtyIndexes.isEmpty() && m_updateTimer == 0)
-		{
-			m_recheckTimer = startTimer(1000);
-			m_updateTimer = startTimer(15);
+
+			AnimationClock::removeConsumer(this);
+
+			update();
 		}
 	}
+	else if (m_recheckTimer == 0)
+	{
+		m_recheckTimer = startTimer(1000);
+
+		AnimationClock::addConsumer(this);
+
+		connect(AnimationClock::getInstance(), &AnimationClock::frameAdvanced, this, &ViewportWidget::updateDirtyRegion);
+	}
+}
+
+void ViewportWidget::handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+	if (m_updateDataRole < 0 || topLeft.column() > 0 || (!roles.isEmpty() && !roles.contains(m_updateDataRole)))
+	{
+		return;
+	}
+
+	updateDirtyIndexes(topLeft.parent(), topLeft.row(), bottomRight.row(), false);
+	updateTimers();
+}
+
+void ViewportWidget::handleRowsInserted(const QModelIndex &parent, int first, int last)
+{
+	if (m_updateDataRole >= 0)
+	{
+		updateDirtyIndexes(parent, first, last, true);
+		updateTimers();
+	}
+}
+
+void ViewportWidget::setModel(QAbstractItemModel *model)
+{
+	if (m_model)
+	{
+		disconnect(m_model, nullptr, this, nullptr);
+	}
+
+	m_model = model;
+
+	if (model)
+	{
+		connect(model, &QAbstractItemModel::dataChanged, this, &ViewportWidget::handleDataChanged);
+		connect(model, &QAbstractItemModel::rowsInserted, this, &ViewportWidget::handleRowsInserted);
+		connect(model, &QAbstractItemModel::modelReset, this, &ViewportWidget::updateDirtyIndexesList);
+	}
+
+	updateDirtyIndexesList();
 }
 
 void ViewportWidget::setUpdateDataRole(int updateDataRole)
 {
 	m_updateDataRole = updateDataRole;
+
+	updateDirtyIndexesList();
 }
 
 HeaderViewWidget::HeaderViewWidget(Qt::Orientation orientation, QWidget *parent) : QHeaderView(orientation, parent),
@@ -388,6 +520,8 @@ bool HeaderViewWidget::viewportEvent(QEvent *event)
 	return QHeaderView::viewportEvent(event);
 }
 
+IniSettings* ItemViewWidget::m_viewsSettings(nullptr);
+
 ItemViewWidget::ItemViewWidget(QWidget *parent) : QTreeView(parent),
 	m_headerWidget(new HeaderViewWidget(Qt::Horizontal, this)),
 	m_viewportWidget(new ViewportWidget(this)),
@@ -397,8 +531,11 @@ ItemViewWidget::ItemViewWidget(QWidget *parent) : QTreeView(parent),
 	m_sortOrder(Qt::AscendingOrder),
 	m_sortColumn(-1),
 	m_dragRow(-1),
+	m_filterTimer(0),
 	m_areRowsMovable(false),
 	m_canGatherExpanded(false),
+	m_canRefineFilter(false),
+	m_isFilterRefinement(false),
 	m_isExclusive(false),
 	m_isModified(false),
 	m_isInitialized(false)
@@ -418,6 +555,18 @@ ItemViewWidget::ItemViewWidget(QWidget *parent) : QTreeView(parent),
 	connect(m_headerWidget, &HeaderViewWidget::sectionMoved, this, &ItemViewWidget::saveState);
 }
 
+void ItemViewWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_filterTimer)
+	{
+		applyFilter();
+	}
+	else
+	{
+		QTreeView::timerEvent(event);
+	}
+}
+
 void ItemViewWidget::showEvent(QShowEvent *event)
 {
 	ensureInitialized();
@@ -584,12 +733,17 @@ void ItemViewWidget::ensureInitialized()
 
 	updateSize();
 
-	IniSettings settings(SessionsManager::getReadableDataPath(QLatin1String("views.ini")));
-	settings.beginGroup(name);
+	IniSettings *settings(getViewsSettings());
+	settings->beginGroup(name);
+
+	const int sortColumn(settings->getValue(QLatin1String("sortColumn"), -1).toInt());
+	const Qt::SortOrder sortOrder((settings->getValue(QLatin1String("sortOrder"), QLatin1String("ascending")).toString() == QLatin1String("ascending")) ? Qt::AscendingOrder : Qt::DescendingOrder);
+	const QStringList columns(settings->getValue(QLatin1String("columns")).toString().split(QLatin1Char(','), QString::SkipEmptyParts));
+
+	settings->endGroup();
 
-	setSort(settings.getValue(QLatin1String("sortColumn"), -1).toInt(), ((settings.getValue(QLatin1String("sortOrder"), QLatin1String("ascending")).toString() == QLatin1String("ascending")) ? Qt::AscendingOrder : Qt::DescendingOrder));
+	setSort(sortColumn, sortOrder);
 
-	const QStringList columns(settings.getValue(QLatin1String("columns")).toString().split(QLatin1Char(','), QString::SkipEmptyParts));
 	bool shouldStretchLastSection(true);
 
 	if (!columns.isEmpty())
@@ -780,9 +934,6 @@ void ItemViewWidget::saveState()
 		return;
 	}
 
-	IniSettings settings(SessionsManager::getWritableDataPath(QLatin1String("views.ini")));
-	settings.beginGroup(name);
-
 	QStringList columns;
 	columns.reserve(getColumnCount());
 
@@ -796,10 +947,14 @@ void ItemViewWidget::saveState()
 		}
 	}
 
-	settings.setValue(QLatin1String("columns"), columns.join(QLatin1Char(',')));
-	settings.setValue(QLatin1String("sortColumn"), ((m_sortColumn >= 0) ? QVariant(m_sortColumn) : QVariant()));
-	settings.setValue(QLatin1String("sortOrder"), ((m_sortColumn >= 0) ? QVariant((m_sortOrder == Qt::AscendingOrder) ? QLatin1String("ascending") : QLatin1String("descending")) : QVariant()));
-	settings.save();
+	IniSettings *settings(getViewsSettings());
+	settings->beginGroup(name);
+	settings->setValue(QLatin1String("columns"), columns.join(QLatin1Char(',')));
+	settings->setValue(QLatin1String("sortColumn"), ((m_sortColumn >= 0) ? QVariant(m_sortColumn) : QVariant()));
+	settings->setValue(QLatin1String("sortOrder"), ((m_sortColumn >= 0) ? QVariant((m_sortOrder == Qt::AscendingOrder) ? QLatin1String("ascending") : QLatin1String("descending")) : QVariant()));
+	settings->endGroup();
+
+	PersistenceManager::markAsDirty(settings);
 }
 
 void ItemViewWidget::handleOptionChanged(int identifier, const QVariant &value)
@@ -824,10 +979,7 @@ void ItemViewWidget::notifySelectionChanged()
 
 void ItemViewWidget::updateFilter()
 {
-	for (int i = 0; i < getRowCount(); ++i)
-	{
-		applyFilter(getIndex(i, 0));
-	}
+	startFilter(false);
 }
 
 void ItemViewWidget::updateSize()
@@ -958,15 +1110,15 @@ void ItemViewWidget::setFilterString(const QString &filter)
 		connect(model(), &QAbstractItemModel::rowsRemoved, this, &ItemViewWidget::updateFilter);
 	}
 
+	const bool isRefinement(!m_filterString.isEmpty() && filter.contains(m_filterString, Qt::CaseInsensitive));
+
 	m_canGatherExpanded = m_filterString.isEmpty();
 	m_filterString = filter;
 
-	updateFilter();
+	startFilter(isRefinement);
 
 	if (m_filterString.isEmpty())
 	{
-		m_expandedBranches.clear();
-
 		disconnect(model(), &QAbstractItemModel::rowsInserted, this, &ItemViewWidget::updateFilter);
 		disconnect(model(), &QAbstractItemModel::rowsMoved, this, &ItemViewWidget::updateFilter);
 		disconnect(model(), &QAbstractItemModel::rowsRemoved, this, &ItemViewWidget::updateFilter);
@@ -978,6 +1130,11 @@ void ItemViewWidget::setFilterRoles(const QSet<int> &roles)
 	m_filterRoles = roles;
 }
 
+void ItemViewWidget::setFilterMatcher(const std::function<bool(const QModelIndex &index)> &matcher)
+{
+	m_filterMatcher = matcher;
+}
+
 void ItemViewWidget::setRowsMovable(bool areMovable)
 {
 	m_areRowsMovable = areMovable;
@@ -1000,6 +1157,16 @@ void ItemViewWidget::setModel(QAbstractItemModel *model, bool useSortProxy)
 {
 	QAbstractItemModel *activeModel(model);
 
+	m_filterFrames.clear();
+	m_canRefineFilter = false;
+
+	if (m_filterTimer != 0)
+	{
+		killTimer(m_filterTimer);
+
+		m_filterTimer = 0;
+	}
+
 	if (model && useSortProxy)
 	{
 		m_proxyModel = new QSortFilterProxyModel(this);
@@ -1018,6 +1185,8 @@ void ItemViewWidget::setModel(QAbstractItemModel *model, bool useSortProxy)
 
 	QTreeView::setModel(activeModel);
 
+	m_viewportWidget->setModel(activeModel);
+
 	if (!model)
 	{
 		emit needsActionsUpdate();
@@ -1169,6 +1338,21 @@ QSize ItemViewWidget::sizeHint() const
 	return size;
 }
 
+IniSettings* ItemViewWidget::getViewsSettings()
+{
+	if (!m_viewsSettings)
+	{
+		m_viewsSettings = new IniSettings(SessionsManager::getReadableDataPath(QLatin1String("views.ini")), QCoreApplication::instance());
+
+		PersistenceManager::registerTarget(m_viewsSettings, [](bool)
+		{
+			return m_viewsSettings->save(SessionsManager::getWritableDataPath(QLatin1String("views.ini")));
+		});
+	}
+
+	return m_viewsSettings;
+}
+
 ItemViewWidget::ViewMode ItemViewWidget::getViewMode() const
 {
 	return m_viewMode;
@@ -1239,81 +1423,169 @@ bool ItemViewWidget::isExclusive() const
 	return m_isExclusive;
 }
 
-bool ItemViewWidget::applyFilter(const QModelIndex &index, bool parentHasMatch)
+void ItemViewWidget::startFilter(bool isRefinement)
 {
 	if (!model())
 	{
-		return false;
+		return;
+	}
+
+	m_isFilterRefinement = (isRefinement && m_canRefineFilter);
+
+	if (!m_isFilterRefinement)
+	{
+		m_canRefineFilter = false;
 	}
 
-	const bool isFolder(!index.flags().testFlag(Qt::ItemNeverHasChildren));
+	FilterFrame frame;
+
+	m_filterFrames = {frame};
+
+	applyFilter();
+}
+
+void ItemViewWidget::applyFilter()
+{
+	if (!model() || m_filterFrames.isEmpty())
+	{
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
 	const bool hasFilter(!m_filterString.isEmpty());
-	bool hasMatch(!hasFilter || (isFolder && parentHasMatch));
+	const bool wereUpdatesEnabled(updatesEnabled());
+
+	setUpdatesEnabled(false);
 
-	if (!hasMatch)
+	while (!m_filterFrames.isEmpty() && timer.elapsed() < FilterTimeSlice)
 	{
-		for (int i = 0; i < getColumnCount(index.parent()); ++i)
+		FilterFrame &frame(m_filterFrames.last());
+		const QModelIndex parent(frame.parent);
+
+		if (frame.row < getRowCount(parent))
 		{
-			const QModelIndex childIndex(index.sibling(index.row(), i));
+			const QModelIndex index(model()->index(frame.row, 0, parent));
+			const bool parentHasMatch(frame.hasMatch);
 
-			if (!childIndex.isValid())
+			++frame.row;
+
+			if (!index.flags().testFlag(Qt::ItemNeverHasChildren))
 			{
+				if (m_canGatherExpanded && isExpanded(index))
+				{
+					m_expandedBranches.insert(index);
+				}
+
+				FilterFrame folderFrame;
+				folderFrame.parent = index;
+				folderFrame.parentHasMatch = parentHasMatch;
+				folderFrame.hasMatch = (!hasFilter || parentHasMatch || matchesFilter(index));
+
+				m_filterFrames.append(folderFrame);
+
 				continue;
 			}
 
-			QSet<int>::iterator iterator;
+			const bool wasHidden(isRowHidden(index.row(), parent));
+			bool hasMatch(!hasFilter);
 
-			for (iterator = m_filterRoles.begin(); iterator != m_filterRoles.end(); ++iterator)
+			if (!hasMatch && !(m_isFilterRefinement && wasHidden && !parentHasMatch))
 			{
-				const QVariant roleData(childIndex.data(*iterator));
+				hasMatch = matchesFilter(index);
+			}
 
-				if (!roleData.isNull() && roleData.toString().contains(m_filterString, Qt::CaseInsensitive))
-				{
-					hasMatch = true;
+			const bool isHidden(hasFilter && !(hasMatch || parentHasMatch));
 
-					break;
-				}
+			if (isHidden != wasHidden)
+			{
+				setRowHidden(index.row(), parent, isHidden);
 			}
 
 			if (hasMatch)
 			{
-				break;
+				frame.childrenHaveMatch = true;
 			}
+
+			continue;
 		}
-	}
 
-	if (isFolder)
-	{
-		if (m_canGatherExpanded && isExpanded(index))
+		const FilterFrame folderFrame(frame);
+
+		m_filterFrames.removeLast();
+
+		if (!folderFrame.parent.isValid())
 		{
-			m_expandedBranches.insert(index);
+			continue;
 		}
 
-		const int rowCount(getRowCount(index));
-		bool folderHasMatch(false);
+		const QModelIndex index(folderFrame.parent);
+		const bool hasMatch(folderFrame.hasMatch || folderFrame.childrenHaveMatch);
+		const bool isHidden(hasFilter ? (!(hasMatch || folderFrame.parentHasMatch) || getRowCount(index) == 0) : false);
 
-		for (int i = 0; i < rowCount; ++i)
+		if (isHidden != isRowHidden(index.row(), index.parent()))
 		{
-			if (applyFilter(model()->index(i, 0, index), hasMatch))
-			{
-				folderHasMatch = true;
-			}
+			setRowHidden(index.row(), index.parent(), isHidden);
 		}
 
-		if (!hasMatch)
+		setExpanded(index, ((hasMatch && hasFilter) || (!hasFilter && m_expandedBranches.contains(index))));
+
+		if (hasMatch && !m_filterFrames.isEmpty())
 		{
-			hasMatch = folderHasMatch;
+			m_filterFrames.last().childrenHaveMatch = true;
 		}
 	}
 
-	setRowHidden(index.row(), index.parent(), (hasFilter ? (!(hasMatch || parentHasMatch) || (isFolder && getRowCount(index) == 0)) : false));
+	setUpdatesEnabled(wereUpdatesEnabled);
 
-	if (isFolder)
+	if (m_filterFrames.isEmpty())
 	{
-		setExpanded(index, ((hasMatch && hasFilter) || (!hasFilter && m_expandedBranches.contains(index))));
+		if (m_filterTimer != 0)
+		{
+			killTimer(m_filterTimer);
+
+			m_filterTimer = 0;
+		}
+
+		m_canRefineFilter = hasFilter;
+
+		if (!hasFilter)
+		{
+			m_expandedBranches.clear();
+		}
+	}
+	else if (m_filterTimer == 0)
+	{
+		m_filterTimer = startTimer(0);
+	}
+}
+
+bool ItemViewWidget::matchesFilter(const QModelIndex &index) const
+{
+	for (int i = 0; i < getColumnCount(index.parent()); ++i)
+	{
+		const QModelIndex childIndex(index.sibling(index.row(), i));
+
+		if (!childIndex.isValid())
+		{
+			continue;
+		}
+
+		QSet<int>::const_iterator iterator;
+
+		for (iterator = m_filterRoles.constBegin(); iterator != m_filterRoles.constEnd(); ++iterator)
+		{
+			const QVariant roleData(childIndex.data(*iterator));
+
+			if (!roleData.isNull() && roleData.toString().contains(m_filterString, Qt::CaseInsensitive))
+			{
+				return true;
+			}
+		}
 	}
 
-	return hasMatch;
+	return (m_filterMatcher && m_filterMatcher(index));
 }
 
 bool ItemViewWidget::isModified() const
@@ -24,15 +24,19 @@
 
 #include "../core/ActionExecutor.h"
 
+#include <QtCore/QPointer>
 #include <QtCore/QSortFilterProxyModel>
 #include <QtGui/QContextMenuEvent>
 #include <QtGui/QStandardItemModel>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QTreeView>
 
+#include <functional>
+
 namespace Otter
 {
 
+class IniSettings;
 class ItemViewWidget;
 
 class ViewportWidget final : public QWidget
@@ -42,6 +46,7 @@ class ViewportWidget final : public QWidget
 public:
 	explicit ViewportWidget(ItemViewWidget *parent);
 
+	void setModel(QAbstractItemModel *model);
 	void setUpdateDataRole(int updateDataRole);
 
 public slots:
@@ -49,13 +54,21 @@ public slots:
 
 protected:
 	void timerEvent(QTimerEvent *event) override;
+	void updateDirtyIndexes(const QModelIndex &parent, int from, int to, bool isRecursive);
+	void updateDirtyIndex(const QModelIndex &index);
+	void updateTimers();
+
+protected slots:
+	void handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+	void handleRowsInserted(const QModelIndex &parent, int first, int last);
+	void updateDirtyRegion();
 
 private:
 	ItemViewWidget *m_view;
-	QVector<QModelIndex> m_dirtyIndexes;
+	QPointer<QAbstractItemModel> m_model;
+	QSet<QPersistentModelIndex> m_dirtyIndexes;
 	int m_updateDataRole;
 	int m_recheckTimer;
-	int m_updateTimer;
 };
 
 class HeaderViewWidget final : public QHeaderView
@@ -154,9 +167,25 @@ public slots:
 	void setExclusive(bool isExclusive);
 	void setFilterString(const QString &filter);
 	void setFilterRoles(const QSet<int> &roles);
+	void setFilterMatcher(const std::function<bool(const QModelIndex &index)> &matcher);
 	void setRowsMovable(bool areMovable);
 
 protected:
+	enum FilterParameter
+	{
+		FilterTimeSlice = 20
+	};
+
+	struct FilterFrame final
+	{
+		QPersistentModelIndex parent;
+		int row = 0;
+		bool parentHasMatch = false;
+		bool hasMatch = false;
+		bool childrenHaveMatch = false;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
 	void showEvent(QShowEvent *event) override;
 	void resizeEvent(QResizeEvent *event) override;
 	void keyPressEvent(QKeyEvent *event) override;
@@ -166,7 +195,10 @@ protected:
 	void ensureInitialized();
 	void moveRow(bool moveUp);
 	void selectRow(const QModelIndex &index);
-	bool applyFilter(const QModelIndex &index, bool parentHasMatch = false);
+	void startFilter(bool isRefinement);
+	void applyFilter();
+	bool matchesFilter(const QModelIndex &index) const;
+	static IniSettings* getViewsSettings();
 
 protected slots:
 	void currentChanged(const QModelIndex &current, const QModelIndex &previous) override;
@@ -185,16 +217,23 @@ private:
 	QMap<int, int> m_sortRoleMapping;
 	QSet<QModelIndex> m_expandedBranches;
 	QSet<int> m_filterRoles;
+	std::function<bool(const QModelIndex &index)> m_filterMatcher;
+	QVector<FilterFrame> m_filterFrames;
 	ViewMode m_viewMode;
 	Qt::SortOrder m_sortOrder;
 	int m_sortColumn;
 	int m_dragRow;
+	int m_filterTimer;
 	bool m_areRowsMovable;
 	bool m_canGatherExpanded;
+	bool m_canRefineFilter;
+	bool m_isFilterRefinement;
 	bool m_isExclusive;
 	bool m_isModified;
 	bool m_isInitialized;
 
+	static IniSettings *m_viewsSettings;
+
 signals:
 	void canMoveRowUpChanged(bool isAllowed);
 	void canMoveRowDownChanged(bool isAllowed);
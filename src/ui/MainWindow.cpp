@@ -39,12 +39,14 @@
 #include "../core/ActionsManager.h"
 #include "../core/Application.h"
 #include "../core/BookmarksManager.h"
+#include "../core/ClosedWindowsStorage.h"
 #include "../core/FeedsManager.h"
 #include "../core/InputInterpreter.h"
 #include "../core/ItemModel.h"
 #include "../core/SessionModel.h"
 #include "../core/SettingsManager.h"
 #include "../core/ThemesManager.h"
+#include "../core/Tracer.h"
 #include "../core/TransfersManager.h"
 #include "../core/Utils.h"
 #include "../core/WebBackend.h"
@@ -72,6 +74,7 @@ MainWindow::MainWindow(const QVariantMap &parameters, const Session::MainWindow
 	m_activeWindow(nullptr),
 	m_identifier(++m_identifierCounter),
 	m_mouseTrackerTimer(0),
+	m_restoringTimer(0),
 	m_tabSwitchingOrderIndex(-1),
 	m_isAboutToClose(false),
 	m_isDraggingToolBar(false),
@@ -79,6 +82,8 @@ MainWindow::MainWindow(const QVariantMap &parameters, const Session::MainWindow
 	m_isSessionRestored(false),
 	m_ui(new Ui::MainWindow)
 {
+	const Tracer::Span span("MainWindow::MainWindow");
+
 	m_ui->setupUi(this);
 
 	installGesturesFilter(this, this);
@@ -282,6 +287,10 @@ void MainWindow::timerEvent(QTimerEvent *event)
 			}
 		}
 	}
+	else if (event->timerId() == m_restoringTimer)
+	{
+		restoreDeferredWindows();
+	}
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
@@ -644,7 +653,16 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 
 								break;
 							case InputInterpreter::InterpreterResult::SearchType:
-								search(result.searchQuery, result.searchEngine, SessionsManager::calculateOpenHints(parameters, (trigger == ActionsManager::KeyboardTrigger || trigger == ActionsManager::MouseTrigger)));
+								{
+									const SessionsManager::OpenHints hints(SessionsManager::calculateOpenHints(parameters, (trigger == ActionsManager::KeyboardTrigger || trigger == ActionsManager::MouseTrigger)));
+
+									search(result.searchQuery, result.searchEngine, hints);
+
+									if (!hints.testFlag(SessionsManager::BackgroundOpen))
+									{
+										InputInterpreter::redirectOnHostLookup(result, getActiveWindow());
+									}
+								}
 
 								return;
 							default:
@@ -691,10 +709,19 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 					return;
 				}
 
+				const bool isDeferred(parameters.value(QLatin1String("isDeferred"), false).toBool() && !url.isEmpty());
+
 				if (index >= 0)
 				{
 					Window *window(new Window(mutableParameters, nullptr, this));
 
+					if (isDeferred)
+					{
+						addDeferredWindow(window, url, parameters.value(QLatin1String("title")).toString(), hints, index);
+
+						return;
+					}
+
 					addWindow(window, hints, index);
 
 					window->setUrl(((url.isEmpty() && SettingsManager::getOption(SettingsManager::StartPage_EnableStartPageOption).toBool()) ? QUrl(QLatin1String("about:start")) : url), false);
@@ -730,6 +757,13 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 
 					window = new Window(mutableParameters, nullptr, this);
 
+					if (isDeferred)
+					{
+						addDeferredWindow(window, url, parameters.value(QLatin1String("title")).toString(), hints, index);
+
+						return;
+					}
+
 					addWindow(window, hints, index);
 				}
 
@@ -875,29 +909,17 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 								break;
 							}
 
-							const SessionsManager::OpenHints hints(SessionsManager::calculateOpenHints(parameters));
-							int index(parameters.value(QLatin1String("index"), -1).toInt());
+							QStringList titles;
+							titles.reserve(urls.count());
 
-							if (index < 0)
+							for (int i = 0; i < urls.count(); ++i)
 							{
-								index = ((!hints.testFlag(SessionsManager::EndOpen) && SettingsManager::getOption(SettingsManager::TabBar_OpenNextToActiveOption).toBool()) ? (getCurrentWindowIndex() + 1) : (m_windows.count() - 1));
-							}
-
-							mutableParameters[QLatin1String("url")] = urls.at(0);
-							mutableParameters[QLatin1String("hints")] = QVariant(hints);
-							mutableParameters[QLatin1String("index")] = index;
-
-							triggerAction(ActionsManager::OpenUrlAction, mutableParameters, trigger);
+								const QVector<BookmarksModel::Bookmark*> bookmarks(BookmarksManager::getModel()->getBookmarks(urls.at(i)));
 
-							mutableParameters[QLatin1String("hints")] = QVariant((hints == SessionsManager::DefaultOpen || hints.testFlag(SessionsManager::CurrentTabOpen)) ? SessionsManager::NewTabOpen : hints);
-
-							for (int i = 1; i < urls.count(); ++i)
-							{
-								mutableParameters[QLatin1String("url")] = urls.at(i);
-								mutableParameters[QLatin1String("index")] = (index + i);
-
-								triggerAction(ActionsManager::OpenUrlAction, mutableParameters, trigger);
+								titles.append(bookmarks.isEmpty() ? QString() : bookmarks.first()->getTitle());
 							}
+
+							openUrls(urls, titles, mutableParameters, trigger);
 						}
 
 						break;
@@ -916,6 +938,31 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 				{
 					const FeedsModel::Entry *entry(FeedsManager::getModel()->getEntry(parameters[QLatin1String("entry")].toULongLong()));
 
+					if (entry && (entry->getType() == FeedsModel::FolderEntry || entry->getType() == FeedsModel::RootEntry))
+					{
+						const QVector<Feed*> feeds(entry->getFeeds());
+						QVector<QUrl> urls;
+						QStringList titles;
+						urls.reserve(feeds.count());
+						titles.reserve(feeds.count());
+
+						for (int i = 0; i < feeds.count(); ++i)
+						{
+							if (feeds.at(i))
+							{
+								urls.append(FeedsManager::createFeedReaderUrl(feeds.at(i)->getUrl()));
+								titles.append(feeds.at(i)->getTitle());
+							}
+						}
+
+						if (!urls.isEmpty())
+						{
+							openUrls(urls, titles, mutableParameters, trigger);
+						}
+
+						return;
+					}
+
 					if (!entry || entry->getType() != FeedsModel::FeedEntry || !entry->getFeed())
 					{
 						return;
@@ -1026,7 +1073,7 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 						break;
 				}
 
-				SessionsManager::markSessionAsModified();
+				SessionsManager::markSessionAsModified(this);
 
 				emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 				emit toolBarStateChanged(toolBarIdentifier, getToolBarState(toolBarIdentifier));
@@ -1264,6 +1311,10 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 	}
 	else
 	{
+		const bool isDeferred(SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool());
+		QVector<QPointer<Window> > visibleWindows;
+		QVector<QPointer<Window> > hiddenWindows;
+
 		for (int i = 0; i < session.windows.count(); ++i)
 		{
 			QVariantMap parameters({{QLatin1String("size"), ((session.windows.at(i).state.state == Qt::WindowMaximized || !session.windows.at(i).state.geometry.isValid()) ? m_workspace->size() : session.windows.at(i).state.geometry.size())}});
@@ -1274,7 +1325,23 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 			}
 
 			Window *window(new Window(parameters, nullptr, this));
-			window->setSession(session.windows.at(i), SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool());
+			window->setSession(session.windows.at(i), true);
+
+			if (!isDeferred)
+			{
+				if (session.windows.at(i).isPinned)
+				{
+					m_restoringWindows.append(window);
+				}
+				else if (session.windows.at(i).state.state != Qt::WindowMinimized)
+				{
+					visibleWindows.append(window);
+				}
+				else
+				{
+					hiddenWindows.append(window);
+				}
+			}
 
 			if (index < 0 && session.windows.at(i).state.state != Qt::WindowMinimized)
 			{
@@ -1284,6 +1351,9 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 			addWindow(window, SessionsManager::DefaultOpen, -1, session.windows.at(i).state, session.windows.at(i).isAlwaysOnTop);
 		}
 
+		m_restoringWindows += visibleWindows;
+		m_restoringWindows += hiddenWindows;
+
 		emit arbitraryActionsStateChanged({ActionsManager::MaximizeAllAction, ActionsManager::MinimizeAllAction, ActionsManager::RestoreAllAction, ActionsManager::CascadeAllAction, ActionsManager::TileAllAction});
 	}
 
@@ -1291,11 +1361,101 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 
 	setActiveWindowByIndex(index);
 
+	if (!m_restoringWindows.isEmpty() && m_restoringTimer == 0)
+	{
+		m_restoringTimer = startTimer(250);
+	}
+
 	m_workspace->markAsRestored();
 
 	emit sessionRestored();
 }
 
+void MainWindow::openUrls(const QVector<QUrl> &urls, const QStringList &titles, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
+{
+	const SessionsManager::OpenHints hints(SessionsManager::calculateOpenHints(parameters));
+	QVariantMap mutableParameters(parameters);
+	int index(parameters.value(QLatin1String("index"), -1).toInt());
+
+	if (index < 0)
+	{
+		index = ((!hints.testFlag(SessionsManager::EndOpen) && SettingsManager::getOption(SettingsManager::TabBar_OpenNextToActiveOption).toBool()) ? (getCurrentWindowIndex() + 1) : (m_windows.count() - 1));
+	}
+
+	mutableParameters[QLatin1String("url")] = urls.at(0);
+	mutableParameters[QLatin1String("hints")] = QVariant(hints);
+	mutableParameters[QLatin1String("index")] = index;
+
+	triggerAction(ActionsManager::OpenUrlAction, mutableParameters, trigger);
+
+	mutableParameters[QLatin1String("hints")] = QVariant(((hints == SessionsManager::DefaultOpen || hints.testFlag(SessionsManager::CurrentTabOpen)) ? SessionsManager::NewTabOpen : hints) | SessionsManager::BackgroundOpen);
+	mutableParameters[QLatin1String("isDeferred")] = true;
+
+	for (int i = 1; i < urls.count(); ++i)
+	{
+		mutableParameters[QLatin1String("url")] = urls.at(i);
+		mutableParameters[QLatin1String("title")] = titles.value(i);
+		mutableParameters[QLatin1String("index")] = (index + i);
+
+		triggerAction(ActionsManager::OpenUrlAction, mutableParameters, trigger);
+	}
+}
+
+void MainWindow::addDeferredWindow(Window *window, const QUrl &url, const QString &title, SessionsManager::OpenHints hints, int index)
+{
+	Session::Window::History::Entry entry;
+	entry.url = url.toString();
+	entry.title = (title.isEmpty() ? url.toDisplayString() : title);
+
+	Session::Window session;
+	session.history.entries = {entry};
+	session.history.index = 0;
+
+	window->setSession(session, true);
+
+	addWindow(window, hints, index);
+
+	m_restoringWindows.append(window);
+
+	if (m_restoringTimer == 0)
+	{
+		m_restoringTimer = startTimer(250);
+	}
+}
+
+void MainWindow::restoreDeferredWindows()
+{
+	QHash<quint64, Window*>::const_iterator iterator;
+	int loadingAmount(0);
+
+	for (iterator = m_windows.constBegin(); iterator != m_windows.constEnd(); ++iterator)
+	{
+		if (iterator.value()->getLoadingState() == WebWidget::OngoingLoadingState)
+		{
+			++loadingAmount;
+		}
+	}
+
+	while (loadingAmount < RestoringWindowsLimit && !m_restoringWindows.isEmpty())
+	{
+		Window *window(m_restoringWindows.takeFirst());
+
+		if (window && !window->isAboutToClose() && window->getLoadingState() == WebWidget::DeferredLoadingState)
+		{
+			window->getContentsWidget();
+
+			++loadingAmount;
+		}
+	}
+
+	if (m_restoringWindows.isEmpty())
+	{
+		killTimer(m_restoringTimer);
+
+		m_restoringTimer = 0;
+	}
+}
+
 void MainWindow::restoreClosedWindow(int index)
 {
 	if (index < 0 || index >= m_closedWindows.count())
@@ -1303,7 +1463,9 @@ void MainWindow::restoreClosedWindow(int index)
 		return;
 	}
 
-	const Session::ClosedWindow closedWindow(m_closedWindows.takeAt(index));
+	Session::ClosedWindow closedWindow(m_closedWindows.takeAt(index));
+
+	ClosedWindowsStorage::restoreHistory(closedWindow.window.history);
 
 	if (closedWindow.previousWindow == 0)
 	{
@@ -1447,6 +1609,15 @@ void MainWindow::addWindow(Window *window, SessionsManager::OpenHints hints, int
 	connect(window, &Window::requestedCloseWindow, this, &MainWindow::handleRequestedCloseWindow);
 	connect(window, &Window::isPinnedChanged, this, &MainWindow::handleWindowIsPinnedChanged);
 	connect(window, &Window::requestedNewWindow, this, &MainWindow::openWindow);
+	connect(window, &Window::urlChanged, this, [=]()
+	{
+		if (m_windows.value(window->getIdentifier()) == window)
+		{
+			SessionsManager::updateOpenUrl(window);
+		}
+	});
+
+	SessionsManager::updateOpenUrl(window);
 
 	emit windowAdded(window->getIdentifier());
 }
@@ -1481,6 +1652,8 @@ void MainWindow::moveWindow(Window *window, MainWindow *mainWindow, const QVaria
 
 	m_windows.remove(window->getIdentifier());
 
+	SessionsManager::removeOpenUrl(window);
+
 	if (!m_isPrivate && window->isPrivate())
 	{
 		m_privateWindows.removeAll(window);
@@ -1530,7 +1703,7 @@ void MainWindow::setSplitterSizes(const QString &identifier, const QVector<int>
 	{
 		m_splitters[identifier] = sizes;
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 	}
 }
 
@@ -1655,6 +1828,11 @@ void MainWindow::handleRequestedCloseWindow(Window *window)
 				removeStoredUrl(closedWindow.window.getUrl());
 			}
 
+			if (!closedWindow.isPrivate)
+			{
+				ClosedWindowsStorage::storeHistory(closedWindow.window.history);
+			}
+
 			m_closedWindows.prepend(closedWindow);
 
 			if (m_closedWindows.count() > limit)
@@ -1715,6 +1893,8 @@ void MainWindow::handleRequestedCloseWindow(Window *window)
 
 	m_windows.remove(window->getIdentifier());
 
+	SessionsManager::removeOpenUrl(window);
+
 	if (!m_isPrivate && window->isPrivate())
 	{
 		m_privateWindows.removeAll(window);
@@ -1826,7 +2006,7 @@ void MainWindow::handleToolBarAdded(int identifier)
 
 	m_toolBars[identifier] = toolBar;
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 
 	emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 }
@@ -1842,7 +2022,7 @@ void MainWindow::handleToolBarRemoved(int identifier)
 
 		toolBar->deleteLater();
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 	}
@@ -1880,28 +2060,20 @@ void MainWindow::updateWindowTitle()
 
 void MainWindow::updateShortcuts()
 {
-	qDeleteAll(m_shortcuts);
-
-	m_shortcuts.clear();
-
-	const QVector<KeyboardProfile::Action> definitions(ActionsManager::getShortcutDefinitions());
+	const QVector<QKeySequence> allowedShortcuts(ActionsManager::getAllowedShortcuts());
+	QHash<QKeySequence, Shortcut*> shortcuts;
+	shortcuts.reserve(allowedShortcuts.count());
 
-	m_shortcuts.reserve(definitions.count() * 2);
-
-	for (int i = 0; i < definitions.count(); ++i)
+	for (int i = 0; i < allowedShortcuts.count(); ++i)
 	{
-		const KeyboardProfile::Action &definition(definitions.at(i));
+		const QKeySequence &sequence(allowedShortcuts.at(i));
 
-		for (int j = 0; j < definition.shortcuts.count(); ++j)
-		{
-			if (ActionsManager::isShortcutAllowed(definition.shortcuts.at(j)))
-			{
-				m_shortcuts.append(new Shortcut(definition.action, definition.shortcuts.at(j), definition.parameters, this));
-			}
-		}
+		shortcuts[sequence] = (m_shortcuts.contains(sequence) ? m_shortcuts.take(sequence) : new Shortcut(sequence, this));
 	}
 
-	m_shortcuts.squeeze();
+	qDeleteAll(m_shortcuts);
+
+	m_shortcuts = shortcuts;
 }
 
 void MainWindow::setOption(int identifier, const QVariant &value)
@@ -2618,28 +2790,6 @@ int MainWindow::getWindowIndex(quint64 identifier) const
 	return -1;
 }
 
-bool MainWindow::hasUrl(const QUrl &url, bool activate)
-{
-	const QVector<quint64> windows(createOrderedWindowList(true));
-
-	for (int i = (windows.count() - 1); i >= 0; --i)
-	{
-		const Window *window(getWindowByIdentifier(windows.at(i)));
-
-		if (window && window->getUrl() == url)
-		{
-			if (activate)
-			{
-				setActiveWindowByIdentifier(windows.at(i));
-			}
-
-			return true;
-		}
-	}
-
-	return false;
-}
-
 bool MainWindow::isAboutToClose() const
 {
 	return m_isAboutToClose;
@@ -2666,7 +2816,7 @@ bool MainWindow::event(QEvent *event)
 
 			break;
 		case QEvent::Move:
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			break;
 		case QEvent::Resize:
@@ -2675,7 +2825,7 @@ bool MainWindow::event(QEvent *event)
 				m_tabSwitcher->resize(size());
 			}
 
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			break;
 		case QEvent::StatusTip:
@@ -2684,7 +2834,7 @@ bool MainWindow::event(QEvent *event)
 			break;
 		case QEvent::WindowStateChange:
 			{
-				SessionsManager::markSessionAsModified();
+				SessionsManager::markSessionAsModified(this);
 
 				if (windowState().testFlag(Qt::WindowFullScreen) != static_cast<QWindowStateChangeEvent*>(event)->oldState().testFlag(Qt::WindowFullScreen))
 				{
@@ -2747,7 +2897,7 @@ bool MainWindow::event(QEvent *event)
 
 			break;
 		case QEvent::WindowActivate:
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			emit activated();
 
@@ -2796,31 +2946,36 @@ bool MainWindow::eventFilter(QObject *object, QEvent *event)
 	return QMainWindow::eventFilter(object, event);
 }
 
-Shortcut::Shortcut(int identifier, const QKeySequence &sequence, const QVariantMap &parameters, MainWindow *parent) : QShortcut(sequence, parent),
-	m_mainWindow(parent),
-	m_parameters(parameters),
-	m_identifier(identifier)
+Shortcut::Shortcut(const QKeySequence &sequence, MainWindow *parent) : QShortcut(sequence, parent),
+	m_mainWindow(parent)
 {
 	connect(this, &Shortcut::activated, this, &Shortcut::triggerAction);
 }
 
 void Shortcut::triggerAction()
 {
-	const ActionsManager::ActionDefinition definition(ActionsManager::getActionDefinition(m_identifier));
-	QVariantMap parameters(m_parameters);
+	const KeyboardProfile::Action shortcutAction(ActionsManager::getShortcutAction(key()));
+
+	if (shortcutAction.action < 0)
+	{
+		return;
+	}
+
+	const ActionsManager::ActionDefinition definition(ActionsManager::getActionDefinition(shortcutAction.action));
+	QVariantMap parameters(shortcutAction.parameters);
 
 	if (definition.isValid() && definition.flags.testFlag(ActionsManager::ActionDefinition::IsCheckableFlag))
 	{
-		parameters[QLatin1String("isChecked")] = !m_mainWindow->getActionState(m_identifier, parameters).isChecked;
+		parameters[QLatin1String("isChecked")] = !m_mainWindow->getActionState(shortcutAction.action, parameters).isChecked;
 	}
 
 	if (definition.scope == ActionsManager::ActionDefinition::ApplicationScope)
 	{
-		Application::getInstance()->triggerAction(m_identifier, parameters, ActionsManager::KeyboardTrigger);
+		Application::getInstance()->triggerAction(shortcutAction.action, parameters, ActionsManager::KeyboardTrigger);
 	}
 	else
 	{
-		m_mainWindow->triggerAction(m_identifier, parameters, ActionsManager::KeyboardTrigger);
+		m_mainWindow->triggerAction(shortcutAction.action, parameters, ActionsManager::KeyboardTrigger);
 	}
 }
 
@@ -81,7 +81,6 @@ public:
 	int getCurrentWindowIndex() const;
 	int getWindowCount() const;
 	int getWindowIndex(quint64 identifier) const;
-	bool hasUrl(const QUrl &url, bool activate = false);
 	bool isAboutToClose() const override;
 	bool isPrivate() const;
 	bool isSessionRestored() const;
@@ -101,6 +100,11 @@ public slots:
 	Window* openWindow(ContentsWidget *widget, SessionsManager::OpenHints hints = SessionsManager::DefaultOpen, const QVariantMap &parameters = {});
 
 protected:
+	enum RestoringParameter
+	{
+		RestoringWindowsLimit = 3
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void closeEvent(QCloseEvent *event) override;
 	void keyPressEvent(QKeyEvent *event) override;
@@ -110,6 +114,9 @@ protected:
 	void beginToolBarDragging(bool isSidebar = false);
 	void endToolBarDragging();
 	void openSpecialPage(const QUrl &url, ActionsManager::TriggerType trigger);
+	void openUrls(const QVector<QUrl> &urls, const QStringList &titles, const QVariantMap &parameters, ActionsManager::TriggerType trigger);
+	void addDeferredWindow(Window *window, const QUrl &url, const QString &title, SessionsManager::OpenHints hints, int index);
+	void restoreDeferredWindows();
 	QWidget* findVisibleWidget(const QVector<QPointer<QWidget> > &widgets) const;
 	TabBarWidget* getTabBar() const;
 	QVector<quint64> createOrderedWindowList(bool includeMinimized) const;
@@ -138,8 +145,9 @@ private:
 	QPointer<Window> m_activeWindow;
 	QString m_windowTitle;
 	ActionExecutor::Object m_editorExecutor;
-	QVector<Shortcut*> m_shortcuts;
+	QHash<QKeySequence, Shortcut*> m_shortcuts;
 	QVector<Window*> m_privateWindows;
+	QVector<QPointer<Window> > m_restoringWindows;
 	QVector<Session::ClosedWindow> m_closedWindows;
 	QVector<quint64> m_tabSwitchingOrderList;
 	QHash<quint64, Window*> m_windows;
@@ -150,6 +158,7 @@ private:
 	Qt::WindowStates m_previousRaisedState;
 	quint64 m_identifier;
 	int m_mouseTrackerTimer;
+	int m_restoringTimer;
 	int m_tabSwitchingOrderIndex;
 	bool m_isAboutToClose;
 	bool m_isDraggingToolBar;
@@ -185,15 +194,13 @@ class Shortcut final : public QShortcut
 	Q_OBJECT
 
 public:
-	explicit Shortcut(int identifier, const QKeySequence &sequence, const QVariantMap &parameters, MainWindow *parent);
+	explicit Shortcut(const QKeySequence &sequence, MainWindow *parent);
 
 protected slots:
 	void triggerAction();
 
 private:
 	MainWindow *m_mainWindow;
-	QVariantMap m_parameters;
-	int m_identifier;
 };
 
 }
@@ -37,23 +37,27 @@
 #include "../core/ToolBarsManager.h"
 #include "../core/Utils.h"
 
+#include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QMetaEnum>
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QTextCodec>
+#include <QtCore/QTimer>
 #include <QtGui/QMouseEvent>
 
 namespace Otter
 {
 
+QHash<QString, Menu::MenuDefinition> Menu::m_definitions;
 int Menu::m_menuRoleIdentifierEnumerator(-1);
 
 Menu::Menu(QWidget *parent) : QMenu(parent),
 	m_actionGroup(nullptr),
 	m_clickedAction(nullptr),
 	m_role(UnknownMenu),
-	m_option(-1)
+	m_option(-1),
+	m_populatedBookmarksAmount(-1)
 {
 }
 
@@ -61,7 +65,8 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 	m_actionGroup(nullptr),
 	m_clickedAction(nullptr),
 	m_role(role),
-	m_option(-1)
+	m_option(-1),
+	m_populatedBookmarksAmount(-1)
 {
 	Q_UNUSED(QT_TRANSLATE_NOOP("actions", "File"))
 	Q_UNUSED(QT_TRANSLATE_NOOP("actions", "Edit"))
@@ -82,19 +87,21 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 				setTitle(QT_TRANSLATE_NOOP("actions", "Bookmarks"));
 				installEventFilter(this);
 
-				const Menu *parentMenu(qobject_cast<Menu*>(parent));
-
-				if (!parentMenu || parentMenu->getRole() != m_role)
-				{
-					connect(BookmarksManager::getModel(), &BookmarksModel::modelModified, this, &Menu::clearBookmarksMenu);
-				}
-
 				if (role == BookmarksMenu)
 				{
+					connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkModified, this, &Menu::handleBookmarkModified);
+					connect(BookmarksManager::getModel(), &BookmarksModel::modelReset, this, &Menu::clearBookmarksMenu);
 					connect(this, &Menu::aboutToShow, this, &Menu::populateBookmarksMenu);
 				}
 				else
 				{
+					const Menu *parentMenu(qobject_cast<Menu*>(parent));
+
+					if (!parentMenu || parentMenu->getRole() != m_role)
+					{
+						connect(BookmarksManager::getModel(), &BookmarksModel::modelModified, this, &Menu::clearBookmarksMenu);
+					}
+
 					connect(this, &Menu::aboutToShow, this, &Menu::populateBookmarkSelectorMenu);
 				}
 			}
@@ -371,13 +378,11 @@ void Menu::contextMenuEvent(QContextMenuEvent *event)
 
 void Menu::load(const QString &path, const QStringList &includeSections, const ActionExecutor::Object &executor)
 {
-	QFile file(SessionsManager::getReadableDataPath(path));
+	const QJsonObject definition(getDefinition(path));
 
-	if (file.open(QIODevice::ReadOnly))
+	if (!definition.isEmpty())
 	{
-		load(QJsonDocument::fromJson(file.readAll()).object(), includeSections, executor);
-
-		file.close();
+		load(definition, includeSections, executor);
 	}
 }
 
@@ -636,7 +641,7 @@ void Menu::populateBookmarksMenu()
 {
 	const BookmarksModel::Bookmark *folderBookmark(BookmarksManager::getModel()->getBookmark(m_menuOptions.value(QLatin1String("bookmark")).toULongLong()));
 
-	if (!actions().isEmpty() && !(folderBookmark->getType() == BookmarksModel::RootBookmark && actions().count() == 3))
+	if (!folderBookmark || m_populatedBookmarksAmount >= folderBookmark->rowCount())
 	{
 		return;
 	}
@@ -644,13 +649,20 @@ void Menu::populateBookmarksMenu()
 	MainWindow *mainWindow(MainWindow::findMainWindow(parent()));
 	ActionExecutor::Object executor(mainWindow, mainWindow);
 
-	if (folderBookmark->rowCount() > 1)
+	if (m_populatedBookmarksAmount < 0)
 	{
-		addAction(new Action(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), folderBookmark->getIdentifier()}}, {{QLatin1String("icon"), QLatin1String("document-open-folder")}, {QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Open All")}}, executor, this));
-		addSeparator();
+		m_populatedBookmarksAmount = 0;
+
+		if (folderBookmark->rowCount() > 1)
+		{
+			addAction(new Action(ActionsManager::OpenBookmarkAction, {{QLatin1String("bookmark"), folderBookmark->getIdentifier()}}, {{QLatin1String("icon"), QLatin1String("document-open-folder")}, {QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Open All")}}, executor, this));
+			addSeparator();
+		}
 	}
 
-	for (int i = 0; i < folderBookmark->rowCount(); ++i)
+	const int amount(qMin(folderBookmark->rowCount(), (m_populatedBookmarksAmount + BookmarksChunkSize)));
+
+	for (int i = m_populatedBookmarksAmount; i < amount; ++i)
 	{
 		const BookmarksModel::Bookmark *bookmark(folderBookmark->getChild(i));
 
@@ -695,6 +707,13 @@ void Menu::populateBookmarksMenu()
 				break;
 		}
 	}
+
+	m_populatedBookmarksAmount = amount;
+
+	if (m_populatedBookmarksAmount < folderBookmark->rowCount())
+	{
+		QTimer::singleShot(0, this, &Menu::populateBookmarksMenu);
+	}
 }
 
 void Menu::populateBookmarkSelectorMenu()
@@ -1490,16 +1509,38 @@ void Menu::populateWindowsMenu()
 
 void Menu::clearBookmarksMenu()
 {
-	const int offset((m_menuOptions.value(QLatin1String("bookmark")).toULongLong() == 0) ? 3 : 0);
+	const int offset((m_role == BookmarksMenu && m_menuOptions.value(QLatin1String("bookmark")).toULongLong() == 0) ? 3 : 0);
 
 	for (int i = (actions().count() - 1); i >= offset; --i)
 	{
-		actions().at(i)->deleteLater();
+		QAction *action(actions().at(i));
+
+		if (action->menu() && action->menu()->parent() == this)
+		{
+			action->menu()->deleteLater();
+		}
+
+		action->deleteLater();
 
-		removeAction(actions().at(i));
+		removeAction(action);
 	}
 
-	connect(this, &Menu::aboutToShow, this, &Menu::populateBookmarksMenu);
+	m_populatedBookmarksAmount = -1;
+}
+
+void Menu::handleBookmarkModified(BookmarksModel::Bookmark *bookmark)
+{
+	if (m_populatedBookmarksAmount < 0 || !bookmark)
+	{
+		return;
+	}
+
+	const BookmarksModel::Bookmark *folderBookmark(BookmarksManager::getModel()->getBookmark(m_menuOptions.value(QLatin1String("bookmark")).toULongLong()));
+
+	if (!folderBookmark || bookmark == folderBookmark || bookmark->parent() == folderBookmark)
+	{
+		clearBookmarksMenu();
+	}
 }
 
 void Menu::clearClosedWindows()
@@ -1584,6 +1625,38 @@ ActionExecutor::Object Menu::getExecutor() const
 	return ActionExecutor::Object(Application::getInstance(), Application::getInstance());
 }
 
+QJsonObject Menu::getDefinition(const QString &path)
+{
+	const QString readablePath(SessionsManager::getReadableDataPath(path));
+	const QDateTime lastModified(readablePath.startsWith(QLatin1String(":/")) ? QDateTime() : QFileInfo(readablePath).lastModified());
+	const QHash<QString, MenuDefinition>::const_iterator iterator(m_definitions.constFind(path));
+
+	if (iterator != m_definitions.constEnd() && iterator.value().path == readablePath && iterator.value().lastModified == lastModified)
+	{
+		return iterator.value().definition;
+	}
+
+	QFile file(readablePath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		m_definitions.remove(path);
+
+		return {};
+	}
+
+	MenuDefinition definition;
+	definition.definition = QJsonDocument::fromJson(file.readAll()).object();
+	definition.path = readablePath;
+	definition.lastModified = lastModified;
+
+	file.close();
+
+	m_definitions[path] = definition;
+
+	return definition.definition;
+}
+
 int Menu::getRole() const
 {
 	return m_role;
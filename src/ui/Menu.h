@@ -21,7 +21,9 @@
 #define OTTER_MENU_H
 
 #include "../core/ActionExecutor.h"
+#include "../core/BookmarksModel.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
 #include <QtWidgets/QMenu>
 
@@ -71,6 +73,18 @@ public:
 	static int getMenuRoleIdentifier(const QString &name);
 
 protected:
+	enum BookmarksMenuParameter
+	{
+		BookmarksChunkSize = 100
+	};
+
+	struct MenuDefinition final
+	{
+		QJsonObject definition;
+		QString path;
+		QDateTime lastModified;
+	};
+
 	void changeEvent(QEvent *event) override;
 	void hideEvent(QHideEvent *event) override;
 	void mousePressEvent(QMouseEvent *event) override;
@@ -78,6 +92,7 @@ protected:
 	void contextMenuEvent(QContextMenuEvent *event) override;
 	void appendAction(const QJsonValue &definition, const QStringList &sections, const ActionExecutor::Object &executor);
 	ActionExecutor::Object getExecutor() const;
+	static QJsonObject getDefinition(const QString &path);
 	bool canInclude(const QJsonObject &definition, const QStringList &sections);
 	bool hasIncludeMatch(const QJsonObject &definition, const QString &key, const QStringList &sections);
 
@@ -100,6 +115,7 @@ protected slots:
 	void populateUserAgentMenu();
 	void populateWindowsMenu();
 	void clearBookmarksMenu();
+	void handleBookmarkModified(BookmarksModel::Bookmark *bookmark);
 	void clearClosedWindows();
 	void clearNotesMenu();
 	void selectOption(QAction *action);
@@ -115,7 +131,9 @@ private:
 	QVariantMap m_menuOptions;
 	int m_role;
 	int m_option;
+	int m_populatedBookmarksAmount;
 
+	static QHash<QString, MenuDefinition> m_definitions;
 	static int m_menuRoleIdentifierEnumerator;
 };
 
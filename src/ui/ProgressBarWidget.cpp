@@ -18,6 +18,7 @@
 **************************************************************************/
 
 #include "ProgressBarWidget.h"
+#include "Animation.h"
 #include "Style.h"
 #include "../core/Application.h"
 
@@ -28,30 +29,10 @@ namespace Otter
 
 ProgressBarWidget::ProgressBarWidget(QWidget *parent) : QProgressBar(parent),
 	m_mode(NormalMode),
-	m_updateTimer(0),
+	m_isAnimating(false),
 	m_hasError(false)
 {
-	connect(this, &ProgressBarWidget::valueChanged, this, [&](int value)
-	{
-		if (value < 0 && m_mode == ThinMode && m_updateTimer == 0)
-		{
-			m_updateTimer = startTimer(15);
-		}
-		else if (value >= 0 && m_updateTimer != 0)
-		{
-			killTimer(m_updateTimer);
-
-			m_updateTimer = 0;
-		}
-	});
-}
-
-void ProgressBarWidget::timerEvent(QTimerEvent *event)
-{
-	if (event->timerId() == m_updateTimer)
-	{
-		update();
-	}
+	connect(this, &ProgressBarWidget::valueChanged, this, &ProgressBarWidget::updateAnimation);
 }
 
 void ProgressBarWidget::paintEvent(QPaintEvent *event)
@@ -75,12 +56,31 @@ void ProgressBarWidget::setMode(ProgressBarWidget::StyleMode mode)
 {
 	m_mode = mode;
 
-	if (value() < 0 && mode == ThinMode && m_updateTimer == 0)
+	updateAnimation();
+	update();
+}
+
+void ProgressBarWidget::updateAnimation()
+{
+	const bool needsAnimation(value() < 0 && m_mode == ThinMode);
+
+	if (needsAnimation == m_isAnimating)
 	{
-		m_updateTimer = startTimer(100);
+		return;
 	}
 
-	update();
+	m_isAnimating = needsAnimation;
+
+	if (needsAnimation)
+	{
+		AnimationClock::addConsumer(this);
+
+		connect(AnimationClock::getInstance(), &AnimationClock::frameAdvanced, this, static_cast<void(ProgressBarWidget::*)()>(&ProgressBarWidget::update));
+	}
+	else
+	{
+		AnimationClock::removeConsumer(this);
+	}
 }
 
 void ProgressBarWidget::setHasError(bool hasError)
@@ -45,12 +45,14 @@ public:
 	bool hasError() const;
 
 protected:
-	void timerEvent(QTimerEvent *event) override;
 	void paintEvent(QPaintEvent *event) override;
 
+protected slots:
+	void updateAnimation();
+
 private:
 	StyleMode m_mode;
-	int m_updateTimer;
+	bool m_isAnimating;
 	bool m_hasError;
 };
 
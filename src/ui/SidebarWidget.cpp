@@ -29,13 +29,17 @@
 #include "../core/AddonsManager.h"
 #include "../core/BookmarksModel.h"
 #include "../core/HistoryManager.h"
+#include "../core/SettingsManager.h"
 #include "../core/ThemesManager.h"
 #include "../modules/widgets/action/ActionWidget.h"
 #include "../modules/widgets/panelChooser/PanelChooserWidget.h"
 
 #include "ui_SidebarWidget.h"
 
+#include <QtCore/QTimer>
+#include <QtWidgets/QAbstractItemView>
 #include <QtWidgets/QMenu>
+#include <QtWidgets/QScrollBar>
 
 namespace Otter
 {
@@ -88,6 +92,17 @@ SidebarWidget::~SidebarWidget()
 	delete m_ui;
 }
 
+void SidebarWidget::timerEvent(QTimerEvent *event)
+{
+	const QString identifier(m_releaseTimers.key(event->timerId()));
+
+	if (!identifier.isEmpty())
+	{
+		cancelReleasePanel(identifier);
+		releasePanel(identifier);
+	}
+}
+
 void SidebarWidget::changeEvent(QEvent *event)
 {
 	QWidget::changeEvent(event);
@@ -234,7 +249,21 @@ void SidebarWidget::selectPanel(const QString &identifier)
 
 	if (!identifier.isEmpty() && definition.panels.contains(identifier))
 	{
-		contentsWidget = ((m_panels.contains(identifier) && m_panels[identifier]) ? m_panels[identifier] : WidgetFactory::createSidebarPanel(identifier, m_toolBarWidget->getIdentifier(), mainWindow, this));
+		cancelReleasePanel(identifier);
+
+		if (m_panels.contains(identifier) && m_panels[identifier])
+		{
+			contentsWidget = m_panels[identifier];
+		}
+		else
+		{
+			contentsWidget = WidgetFactory::createSidebarPanel(identifier, m_toolBarWidget->getIdentifier(), mainWindow, this);
+
+			if (contentsWidget)
+			{
+				restorePanelState(identifier, contentsWidget);
+			}
+		}
 	}
 
 	if (contentsWidget && mainWindow)
@@ -248,6 +277,8 @@ void SidebarWidget::selectPanel(const QString &identifier)
 		m_ui->panelLayout->removeWidget(m_panels[m_currentPanel]);
 
 		m_panels[m_currentPanel]->hide();
+
+		scheduleReleasePanel(m_currentPanel);
 	}
 
 	if (m_buttons.contains(m_currentPanel) && m_buttons[m_currentPanel])
@@ -283,6 +314,107 @@ void SidebarWidget::selectPanel(const QString &identifier)
 	}
 }
 
+void SidebarWidget::scheduleReleasePanel(const QString &identifier)
+{
+	const int releaseTime(SettingsManager::getOption(SettingsManager::Interface_HiddenPanelTimeUntilReleaseOption).toInt());
+
+	if (releaseTime >= 0 && !identifier.startsWith(QLatin1String("web:")) && !m_releaseTimers.contains(identifier))
+	{
+		m_releaseTimers[identifier] = startTimer(releaseTime * 1000);
+	}
+}
+
+void SidebarWidget::cancelReleasePanel(const QString &identifier)
+{
+	if (m_releaseTimers.contains(identifier))
+	{
+		killTimer(m_releaseTimers.take(identifier));
+	}
+}
+
+void SidebarWidget::releasePanel(const QString &identifier)
+{
+	ContentsWidget *widget(m_panels.value(identifier));
+
+	if (!widget || identifier == m_currentPanel)
+	{
+		return;
+	}
+
+	QHash<QString, ViewState> states;
+	const QList<QAbstractItemView*> views(widget->findChildren<QAbstractItemView*>());
+
+	for (int i = 0; i < views.count(); ++i)
+	{
+		const QAbstractItemView *view(views.at(i));
+
+		if (view->objectName().isEmpty())
+		{
+			continue;
+		}
+
+		ViewState state;
+		state.scrollPosition = view->verticalScrollBar()->value();
+
+		QModelIndex index(view->currentIndex());
+
+		while (index.isValid())
+		{
+			state.currentPath.prepend(index.row());
+
+			index = index.parent();
+		}
+
+		states[view->objectName()] = state;
+	}
+
+	m_panelStates[identifier] = states;
+
+	m_panels.remove(identifier);
+
+	widget->deleteLater();
+}
+
+void SidebarWidget::restorePanelState(const QString &identifier, ContentsWidget *widget)
+{
+	if (!m_panelStates.contains(identifier))
+	{
+		return;
+	}
+
+	const QHash<QString, ViewState> states(m_panelStates.take(identifier));
+
+	QTimer::singleShot(0, widget, [=]()
+	{
+		const QList<QAbstractItemView*> views(widget->findChildren<QAbstractItemView*>());
+
+		for (int i = 0; i < views.count(); ++i)
+		{
+			QAbstractItemView *view(views.at(i));
+
+			if (!view->model() || !states.contains(view->objectName()))
+			{
+				continue;
+			}
+
+			const ViewState state(states.value(view->objectName()));
+			QModelIndex index;
+
+			for (int j = 0; j < state.currentPath.count(); ++j)
+			{
+				index = view->model()->index(state.currentPath.at(j), 0, index);
+			}
+
+			if (index.isValid())
+			{
+				view->setCurrentIndex(index);
+			}
+
+			view->verticalScrollBar()->setValue(state.scrollPosition);
+		}
+	});
+}
+
 void SidebarWidget::saveSize()
 {
 	ToolBarsManager::ToolBarDefinition definition(m_toolBarWidget->getDefinition());
@@ -383,10 +515,22 @@ void SidebarWidget::updatePanels()
 
 			widget->deleteLater();
 
+			cancelReleasePanel(panel);
+
 			m_panels.remove(panel);
 		}
 	}
 
+	const QStringList storedPanels(m_panelStates.keys());
+
+	for (int i = 0; i < storedPanels.count(); ++i)
+	{
+		if (!panels.contains(storedPanels.at(i)))
+		{
+			m_panelStates.remove(storedPanels.at(i));
+		}
+	}
+
 	const QStringList specialPages(AddonsManager::getSpecialPages(AddonsManager::SpecialPageInformation::SidebarPanelType));
 	QMenu *menu(nullptr);
 
@@ -50,8 +50,19 @@ public:
 	QSize sizeHint() const override;
 
 protected:
+	struct ViewState final
+	{
+		QVector<int> currentPath;
+		int scrollPosition = 0;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
 	void changeEvent(QEvent *event) override;
 	void selectPanel(const QString &identifier);
+	void scheduleReleasePanel(const QString &identifier);
+	void cancelReleasePanel(const QString &identifier);
+	void releasePanel(const QString &identifier);
+	void restorePanelState(const QString &identifier, ContentsWidget *widget);
 
 protected slots:
 	void addWebPanel();
@@ -66,6 +77,8 @@ private:
 	QString m_currentPanel;
 	QHash<QString, QToolButton*> m_buttons;
 	QHash<QString, ContentsWidget*> m_panels;
+	QHash<QString, QHash<QString, ViewState> > m_panelStates;
+	QHash<QString, int> m_releaseTimers;
 	Ui::SidebarWidget *m_ui;
 };
 
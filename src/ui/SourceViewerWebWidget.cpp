@@ -288,7 +288,7 @@ void SourceViewerWebWidget::handleViewSourceReplyFinished()
 
 void SourceViewerWebWidget::handleZoomChanged()
 {
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void SourceViewerWebWidget::notifyEditingActionsStateChanged()
@@ -346,7 +346,7 @@ void SourceViewerWebWidget::setZoom(int zoom)
 	{
 		m_sourceEditWidget->setZoom(zoom);
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 	}
@@ -535,6 +535,11 @@ bool SourceViewerWebWidget::hasSelection() const
 	return m_sourceEditWidget->textCursor().hasSelection();
 }
 
+bool SourceViewerWebWidget::isModified() const
+{
+	return m_sourceEditWidget->document()->isModified();
+}
+
 bool SourceViewerWebWidget::isPrivate() const
 {
 	return m_isPrivate;
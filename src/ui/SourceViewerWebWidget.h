@@ -52,6 +52,7 @@ public:
 	bool canRedo() const override;
 	bool canUndo() const override;
 	bool hasSelection() const override;
+	bool isModified() const override;
 	bool isPrivate() const override;
 
 public slots:
@@ -32,6 +32,7 @@
 #include "../core/SettingsManager.h"
 #include "../core/ThemesManager.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMimeData>
 #include <QtCore/QtMath>
 #include <QtGui/QContextMenuEvent>
@@ -63,7 +64,8 @@ TabHandleWidget::TabHandleWidget(Window *window, TabBarWidget *parent) : QWidget
 	m_dragTimer(0),
 	m_isActiveWindow(false),
 	m_isCloseButtonUnderMouse(false),
-	m_wasCloseButtonPressed(false)
+	m_wasCloseButtonPressed(false),
+	m_needsThumbnailUpdate(true)
 {
 	handleLoadingStateChanged(window->getLoadingState());
 	setAcceptDrops(true);
@@ -73,6 +75,9 @@ TabHandleWidget::TabHandleWidget(Window *window, TabBarWidget *parent) : QWidget
 	connect(window, &Window::titleChanged, this, &TabHandleWidget::updateTitle);
 	connect(window, &Window::iconChanged, this, static_cast<void(TabHandleWidget::*)()>(&TabHandleWidget::update));
 	connect(window, &Window::loadingStateChanged, this, &TabHandleWidget::handleLoadingStateChanged);
+	connect(window, &Window::urlChanged, this, &TabHandleWidget::markThumbnailAsOutdated);
+	connect(window, &Window::contentStateChanged, this, &TabHandleWidget::markThumbnailAsOutdated);
+	connect(window, &Window::zoomChanged, this, &TabHandleWidget::markThumbnailAsOutdated);
 	connect(parent, &TabBarWidget::currentChanged, this, &TabHandleWidget::updateGeometries);
 	connect(parent, &TabBarWidget::tabsAmountChanged, this, &TabHandleWidget::updateGeometries);
 	connect(parent, &TabBarWidget::needsGeometriesUpdate, this, &TabHandleWidget::updateGeometries);
@@ -146,6 +151,7 @@ void TabHandleWidget::paintEvent(QPaintEvent *event)
 		if (m_window->getLoadingState() == WebWidget::OngoingLoadingState && m_spinnerAnimation)
 		{
 			m_spinnerAnimation->paint(&painter, m_urlIconRectangle);
+			m_spinnerAnimation->addRegion(this, m_urlIconRectangle);
 		}
 		else
 		{
@@ -155,7 +161,7 @@ void TabHandleWidget::paintEvent(QPaintEvent *event)
 
 	if (m_thumbnailRectangle.isValid())
 	{
-		const QPixmap thumbnail(m_window->createThumbnail());
+		const QPixmap thumbnail(getThumbnail());
 
 		if (thumbnail.isNull())
 		{
@@ -165,7 +171,10 @@ void TabHandleWidget::paintEvent(QPaintEvent *event)
 			{
 				if (m_window->getLoadingState() == WebWidget::OngoingLoadingState && m_spinnerAnimation)
 				{
-					m_spinnerAnimation->paint(&painter, {(m_thumbnailRectangle.left() + ((m_thumbnailRectangle.width() - 16) / 2)), (m_thumbnailRectangle.top() + ((m_thumbnailRectangle.height() - 16) / 2)), 16, 16});
+					const QRect spinnerRectangle((m_thumbnailRectangle.left() + ((m_thumbnailRectangle.width() - 16) / 2)), (m_thumbnailRectangle.top() + ((m_thumbnailRectangle.height() - 16) / 2)), 16, 16);
+
+					m_spinnerAnimation->paint(&painter, spinnerRectangle);
+					m_spinnerAnimation->addRegion(this, spinnerRectangle);
 				}
 				else
 				{
@@ -253,7 +262,7 @@ void TabHandleWidget::mouseMoveEvent(QMouseEvent *event)
 	{
 		if (wasCloseButtonUnderMouse && !m_isCloseButtonUnderMouse)
 		{
-			m_tabBarWidget->showPreview(-1, SettingsManager::getOption(SettingsManager::TabBar_PreviewsAnimationDurationOption).toInt());
+			m_tabBarWidget->showPreview(-1, SettingsManager::getOption<int>(SettingsManager::TabBar_PreviewsAnimationDurationOption));
 
 			QToolTip::hideText();
 
@@ -306,8 +315,20 @@ void TabHandleWidget::markAsNeedingAttention()
 	}
 }
 
+void TabHandleWidget::markThumbnailAsOutdated()
+{
+	m_needsThumbnailUpdate = true;
+
+	m_tabBarWidget->scheduleThumbnailsUpdate();
+}
+
 void TabHandleWidget::handleLoadingStateChanged(WebWidget::LoadingState state)
 {
+	if (state != WebWidget::OngoingLoadingState)
+	{
+		markThumbnailAsOutdated();
+	}
+
 	if (state == WebWidget::OngoingLoadingState)
 	{
 		if (!m_spinnerAnimation)
@@ -326,7 +347,7 @@ void TabHandleWidget::handleLoadingStateChanged(WebWidget::LoadingState state)
 			m_spinnerAnimation->start();
 		}
 
-		connect(m_spinnerAnimation, &Animation::frameChanged, this, static_cast<void(TabHandleWidget::*)()>(&TabHandleWidget::update));
+		update();
 	}
 	else if (m_spinnerAnimation)
 	{
@@ -551,12 +572,31 @@ void TabHandleWidget::updateTitle()
 	}
 }
 
+void TabHandleWidget::updateThumbnail()
+{
+	m_needsThumbnailUpdate = false;
+
+	if (!m_window)
+	{
+		return;
+	}
+
+	m_thumbnail = m_window->createThumbnail();
+
+	if (m_thumbnailRectangle.isValid())
+	{
+		update();
+	}
+}
+
 void TabHandleWidget::setIsActiveWindow(bool isActive)
 {
 	if (isActive != m_isActiveWindow)
 	{
 		m_isActiveWindow = isActive;
 
+		markThumbnailAsOutdated();
+
 		if (isActive)
 		{
 			setFont(parentWidget()->font());
@@ -574,19 +614,44 @@ Window* TabHandleWidget::getWindow() const
 	return m_window;
 }
 
+QPixmap TabHandleWidget::getThumbnail()
+{
+	if (m_thumbnail.isNull() && m_needsThumbnailUpdate && m_window && m_window->getLoadingState() != WebWidget::OngoingLoadingState)
+	{
+		updateThumbnail();
+	}
+
+	return m_thumbnail;
+}
+
+bool TabHandleWidget::needsAttention() const
+{
+	return (!m_isActiveWindow && font().bold());
+}
+
+bool TabHandleWidget::needsThumbnailUpdate() const
+{
+	return m_needsThumbnailUpdate;
+}
+
 TabBarWidget::TabBarWidget(QWidget *parent) : QTabBar(parent),
 	m_previewWidget(nullptr),
 	m_activeTabHandleWidget(nullptr),
 	m_movableTabWidget(nullptr),
+	m_previewsAnimationDuration(SettingsManager::TabBar_PreviewsAnimationDurationOption),
+	m_requiresModifierToSwitchTabOnScroll(SettingsManager::TabBar_RequireModifierToSwitchTabOnScrollOption),
 	m_tabWidth(0),
 	m_clickedTab(-1),
 	m_hoveredTab(-1),
 	m_pinnedTabsAmount(0),
 	m_previewTimer(0),
+	m_tabHandlesTimer(0),
+	m_thumbnailsTimer(0),
 	m_arePreviewsEnabled(SettingsManager::getOption(SettingsManager::TabBar_EnablePreviewsOption).toBool()),
 	m_isDraggingTab(false),
 	m_isDetachingTab(false),
 	m_isIgnoringTabDrag(false),
+	m_isUpdatingTabHandles(false),
 	m_needsUpdateOnLeave(false)
 {
 	m_areThumbnailsEnabled = SettingsManager::getOption(SettingsManager::TabBar_EnableThumbnailsOption).toBool();
@@ -668,6 +733,22 @@ void TabBarWidget::timerEvent(QTimerEvent *event)
 
 		showPreview(tabAt(mapFromGlobal(QCursor::pos())));
 	}
+	else if (event->timerId() == m_tabHandlesTimer)
+	{
+		killTimer(m_tabHandlesTimer);
+
+		m_tabHandlesTimer = 0;
+
+		updateTabHandles();
+	}
+	else if (event->timerId() == m_thumbnailsTimer)
+	{
+		killTimer(m_thumbnailsTimer);
+
+		m_thumbnailsTimer = 0;
+
+		updateThumbnails();
+	}
 }
 
 void TabBarWidget::paintEvent(QPaintEvent *event)
@@ -676,6 +757,7 @@ void TabBarWidget::paintEvent(QPaintEvent *event)
 
 	QStylePainter painter(this);
 	const int selectedIndex(currentIndex());
+	bool needsTabHandlesUpdate(false);
 
 	for (int i = 0; i < count(); ++i)
 	{
@@ -689,9 +771,19 @@ void TabBarWidget::paintEvent(QPaintEvent *event)
 		if (rect().intersects(tabOption.rect))
 		{
 			painter.drawControl(QStyle::CE_TabBarTab, tabOption);
+
+			if (!tabButton(i, QTabBar::LeftSide))
+			{
+				needsTabHandlesUpdate = true;
+			}
 		}
 	}
 
+	if (needsTabHandlesUpdate && m_tabHandlesTimer == 0)
+	{
+		m_tabHandlesTimer = startTimer(0);
+	}
+
 	if (selectedIndex >= 0)
 	{
 		const QStyleOptionTab tabOption(createStyleOptionTab(selectedIndex));
@@ -738,7 +830,7 @@ void TabBarWidget::enterEvent(QEvent *event)
 {
 	QTabBar::enterEvent(event);
 
-	showPreview(-1, SettingsManager::getOption(SettingsManager::TabBar_PreviewsAnimationDurationOption).toInt());
+	showPreview(-1, m_previewsAnimationDuration.getValue());
 }
 
 void TabBarWidget::leaveEvent(QEvent *event)
@@ -852,7 +944,7 @@ void TabBarWidget::contextMenuEvent(QContextMenuEvent *event)
 
 	if (underMouse())
 	{
-		m_previewTimer = startTimer(SettingsManager::getOption(SettingsManager::TabBar_PreviewsAnimationDurationOption).toInt());
+		m_previewTimer = startTimer(m_previewsAnimationDuration.getValue());
 	}
 }
 
@@ -957,7 +1049,7 @@ void TabBarWidget::wheelEvent(QWheelEvent *event)
 {
 	QWidget::wheelEvent(event);
 
-	if (event->modifiers().testFlag(Qt::ControlModifier) || !SettingsManager::getOption(SettingsManager::TabBar_RequireModifierToSwitchTabOnScrollOption).toBool())
+	if (event->modifiers().testFlag(Qt::ControlModifier) || !m_requiresModifierToSwitchTabOnScroll.getValue())
 	{
 		Application::triggerAction(((event->angleDelta().y() > 0) ? ActionsManager::ActivateTabOnLeftAction : ActionsManager::ActivateTabOnRightAction), {}, parentWidget());
 	}
@@ -1071,6 +1163,8 @@ void TabBarWidget::dropEvent(QDropEvent *event)
 						case InputInterpreter::InterpreterResult::SearchType:
 							mainWindow->search(result.searchQuery, result.searchEngine, SessionsManager::NewTabOpen);
 
+							InputInterpreter::redirectOnHostLookup(result, mainWindow->getActiveWindow());
+
 							break;
 						default:
 							break;
@@ -1132,18 +1226,9 @@ void TabBarWidget::tabLayoutChange()
 {
 	QTabBar::tabLayoutChange();
 
-	for (int i = 0; i < count(); ++i)
+	if (!m_isUpdatingTabHandles)
 	{
-		QWidget *tabHandleWidget(tabButton(i, QTabBar::LeftSide));
-
-		if (tabHandleWidget)
-		{
-			QStyleOptionTab tabOption;
-
-			initStyleOption(&tabOption, i);
-
-			tabHandleWidget->resize(style()->subElementRect(QStyle::SE_TabBarTabLeftButton, &tabOption, this).size());
-		}
+		updateTabHandles();
 	}
 
 	tabHovered(tabAt(mapFromGlobal(QCursor::pos())));
@@ -1213,7 +1298,7 @@ void TabBarWidget::addTab(int index, Window *window)
 	blockSignals(true);
 	insertTab(index, {});
 	blockSignals(false);
-	setTabButton(index, QTabBar::LeftSide, new TabHandleWidget(window, this));
+	setTabData(index, QVariant::fromValue(window));
 	setTabButton(index, QTabBar::RightSide, nullptr);
 
 	if (selectedIndex != currentIndex() || count() == 1)
@@ -1222,6 +1307,31 @@ void TabBarWidget::addTab(int index, Window *window)
 	}
 
 	connect(window, &Window::isPinnedChanged, this, &TabBarWidget::updatePinnedTabsAmount);
+	connect(window, &Window::needsAttention, this, [=]()
+	{
+		for (int i = 0; i < count(); ++i)
+		{
+			if (getWindow(i) == window)
+			{
+				if (!tabButton(i, QTabBar::LeftSide))
+				{
+					TabHandleWidget *tabHandleWidget(getTabHandleWidget(i, true));
+
+					if (tabHandleWidget)
+					{
+						tabHandleWidget->markAsNeedingAttention();
+					}
+				}
+
+				break;
+			}
+		}
+	});
+
+	if (m_tabHandlesTimer == 0)
+	{
+		m_tabHandlesTimer = startTimer(0);
+	}
 
 	if (window->isPinned())
 	{
@@ -1298,8 +1408,16 @@ void TabBarWidget::showPreview(int index, int delay)
 		rectangle.moveTo(mapToGlobal(rectangle.topLeft()));
 
 		const bool isActive(index == currentIndex());
+		QPixmap thumbnail;
+
+		if (!isActive && !m_areThumbnailsEnabled)
+		{
+			TabHandleWidget *tabHandleWidget(getTabHandleWidget(index));
+
+			thumbnail = (tabHandleWidget ? tabHandleWidget->getThumbnail() : window->createThumbnail());
+		}
 
-		m_previewWidget->setPreview(window->getTitle(), ((isActive || m_areThumbnailsEnabled) ? QPixmap() : window->createThumbnail()), isActive);
+		m_previewWidget->setPreview(window->getTitle(), thumbnail, isActive);
 
 		switch (shape())
 		{
@@ -1362,6 +1480,133 @@ void TabBarWidget::hidePreview()
 	}
 }
 
+void TabBarWidget::updateTabHandles()
+{
+	if (m_isDraggingTab || m_isUpdatingTabHandles)
+	{
+		return;
+	}
+
+	m_isUpdatingTabHandles = true;
+
+	const QRect visibleRectangle(rect().adjusted(-TabHandlesMargin, -TabHandlesMargin, TabHandlesMargin, TabHandlesMargin));
+
+	for (int i = 0; i < count(); ++i)
+	{
+		QWidget *widget(tabButton(i, QTabBar::LeftSide));
+
+		if (visibleRectangle.intersects(tabRect(i)) || i == currentIndex())
+		{
+			TabHandleWidget *tabHandleWidget(widget ? qobject_cast<TabHandleWidget*>(widget) : getTabHandleWidget(i, true));
+
+			if (tabHandleWidget)
+			{
+				QStyleOptionTab tabOption;
+
+				initStyleOption(&tabOption, i);
+
+				tabHandleWidget->resize(style()->subElementRect(QStyle::SE_TabBarTabLeftButton, &tabOption, this).size());
+			}
+		}
+		else if (widget)
+		{
+			const TabHandleWidget *tabHandleWidget(qobject_cast<TabHandleWidget*>(widget));
+
+			if (!tabHandleWidget || widget == m_activeTabHandleWidget || tabHandleWidget->needsAttention() || widget->underMouse())
+			{
+				continue;
+			}
+
+			setTabButton(i, QTabBar::LeftSide, nullptr);
+
+			widget->hide();
+			widget->deleteLater();
+		}
+	}
+
+	m_isUpdatingTabHandles = false;
+}
+
+void TabBarWidget::scheduleThumbnailsUpdate()
+{
+	if (m_thumbnailsTimer == 0 && (m_areThumbnailsEnabled || m_arePreviewsEnabled))
+	{
+		m_thumbnailsTimer = startTimer(ThumbnailsUpdateInterval);
+	}
+}
+
+void TabBarWidget::updateThumbnails()
+{
+	if (!m_areThumbnailsEnabled && !m_arePreviewsEnabled)
+	{
+		return;
+	}
+
+	if (m_isDraggingTab || QGuiApplication::mouseButtons() != Qt::NoButton)
+	{
+		scheduleThumbnailsUpdate();
+
+		return;
+	}
+
+	QVector<TabHandleWidget*> visibleTabHandleWidgets;
+	QVector<TabHandleWidget*> hiddenTabHandleWidgets;
+	const int hoveredIndex(tabAt(mapFromGlobal(QCursor::pos())));
+	bool needsUpdate(false);
+
+	for (int i = 0; i < count(); ++i)
+	{
+		TabHandleWidget *tabHandleWidget(getTabHandleWidget(i));
+
+		if (!tabHandleWidget || !tabHandleWidget->needsThumbnailUpdate() || (!m_areThumbnailsEnabled && i == currentIndex()))
+		{
+			continue;
+		}
+
+		const Window *window(tabHandleWidget->getWindow());
+
+		if (!window || window->getLoadingState() != WebWidget::FinishedLoadingState)
+		{
+			continue;
+		}
+
+		if (i == hoveredIndex)
+		{
+			visibleTabHandleWidgets.prepend(tabHandleWidget);
+		}
+		else if (m_areThumbnailsEnabled && rect().intersects(tabRect(i)))
+		{
+			visibleTabHandleWidgets.append(tabHandleWidget);
+		}
+		else
+		{
+			hiddenTabHandleWidgets.append(tabHandleWidget);
+		}
+	}
+
+	const QVector<TabHandleWidget*> tabHandleWidgets(visibleTabHandleWidgets + hiddenTabHandleWidgets);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int i = 0; i < tabHandleWidgets.count(); ++i)
+	{
+		if (i > 0 && timer.elapsed() >= ThumbnailsUpdateTimeBudget)
+		{
+			needsUpdate = true;
+
+			break;
+		}
+
+		tabHandleWidgets.at(i)->updateThumbnail();
+	}
+
+	if (needsUpdate)
+	{
+		scheduleThumbnailsUpdate();
+	}
+}
+
 void TabBarWidget::handleOptionChanged(int identifier, const QVariant &value)
 {
 	switch (identifier)
@@ -1506,7 +1751,7 @@ void TabBarWidget::handleCurrentChanged(int index)
 		showPreview(tabAt(mapFromGlobal(QCursor::pos())));
 	}
 
-	TabHandleWidget *tabHandleWidget(qobject_cast<TabHandleWidget*>(tabButton(index, QTabBar::LeftSide)));
+	TabHandleWidget *tabHandleWidget(getTabHandleWidget(index, true));
 
 	if (tabHandleWidget)
 	{
@@ -1589,18 +1834,42 @@ void TabBarWidget::setArea(Qt::ToolBarArea area)
 	setSizePolicy(QSizePolicy::Preferred, ((area != Qt::LeftToolBarArea && area != Qt::RightToolBarArea) ? QSizePolicy::Maximum : QSizePolicy::Preferred));
 }
 
-Window* TabBarWidget::getWindow(int index) const
+TabHandleWidget* TabBarWidget::getTabHandleWidget(int index, bool canCreate)
 {
-	if (index >= 0 && index < count())
+	if (index < 0 || index >= count())
 	{
-		const TabHandleWidget *widget(qobject_cast<TabHandleWidget*>(tabButton(index, QTabBar::LeftSide)));
+		return nullptr;
+	}
 
-		if (widget)
+	TabHandleWidget *tabHandleWidget(qobject_cast<TabHandleWidget*>(tabButton(index, QTabBar::LeftSide)));
+
+	if (!tabHandleWidget && canCreate && !m_isDraggingTab)
+	{
+		Window *window(getWindow(index));
+
+		if (window)
 		{
-			return widget->getWindow();
+			QStyleOptionTab tabOption;
+
+			initStyleOption(&tabOption, index);
+
+			tabHandleWidget = new TabHandleWidget(window, this);
+			tabHandleWidget->resize(style()->subElementRect(QStyle::SE_TabBarTabLeftButton, &tabOption, this).size());
+
+			setTabButton(index, QTabBar::LeftSide, tabHandleWidget);
 		}
 	}
 
+	return tabHandleWidget;
+}
+
+Window* TabBarWidget::getWindow(int index) const
+{
+	if (index >= 0 && index < count())
+	{
+		return tabData(index).value<Window*>();
+	}
+
 	return nullptr;
 }
 
@@ -23,6 +23,7 @@
 
 #include "WebWidget.h"
 #include "../core/GesturesController.h"
+#include "../core/SettingsManager.h"
 
 #include <QtWidgets/QTabBar>
 
@@ -41,8 +42,15 @@ class TabHandleWidget final : public QWidget
 public:
 	explicit TabHandleWidget(Window *window, TabBarWidget *parent);
 
+	void updateThumbnail();
 	void setIsActiveWindow(bool isActive);
 	Window* getWindow() const;
+	QPixmap getThumbnail();
+	bool needsAttention() const;
+	bool needsThumbnailUpdate() const;
+
+public slots:
+	void markAsNeedingAttention();
 
 protected:
 	void timerEvent(QTimerEvent *event) override;
@@ -56,7 +64,7 @@ protected:
 	void dragEnterEvent(QDragEnterEvent *event) override;
 
 protected slots:
-	void markAsNeedingAttention();
+	void markThumbnailAsOutdated();
 	void handleLoadingStateChanged(WebWidget::LoadingState state);
 	void updateGeometries();
 	void updateTitle();
@@ -64,6 +72,7 @@ protected slots:
 private:
 	Window *m_window;
 	TabBarWidget *m_tabBarWidget;
+	QPixmap m_thumbnail;
 	QString m_title;
 	QRect m_closeButtonRectangle;
 	QRect m_urlIconRectangle;
@@ -74,6 +83,7 @@ private:
 	bool m_isActiveWindow;
 	bool m_isCloseButtonUnderMouse;
 	bool m_wasCloseButtonPressed;
+	bool m_needsThumbnailUpdate;
 
 	static Animation *m_spinnerAnimation;
 	static QIcon m_lockedIcon;
@@ -90,6 +100,7 @@ public:
 	void removeTab(int index);
 	void showPreview(int index, int delay = 0);
 	void hidePreview();
+	void scheduleThumbnailsUpdate();
 	Window* getWindow(int index) const;
 	GestureContext getGestureContext(const QPoint &position = {}) const override;
 	QSize minimumSizeHint() const override;
@@ -103,6 +114,17 @@ public slots:
 	void updateSize();
 
 protected:
+	enum TabHandlesParameter
+	{
+		TabHandlesMargin = 200
+	};
+
+	enum ThumbnailsParameter
+	{
+		ThumbnailsUpdateInterval = 500,
+		ThumbnailsUpdateTimeBudget = 20
+	};
+
 	void changeEvent(QEvent *event) override;
 	void childEvent(QChildEvent *event) override;
 	void timerEvent(QTimerEvent *event) override;
@@ -122,12 +144,15 @@ protected:
 	void tabInserted(int index) override;
 	void tabRemoved(int index) override;
 	void tabHovered(int index);
+	TabHandleWidget* getTabHandleWidget(int index, bool canCreate = false);
 	QStyleOptionTab createStyleOptionTab(int index) const;
 	QSize tabSizeHint(int index) const override;
 	int getDropIndex() const;
 	bool event(QEvent *event) override;
 
 protected slots:
+	void updateTabHandles();
+	void updateThumbnails();
 	void handleOptionChanged(int identifier, const QVariant &value);
 	void handleCurrentChanged(int index);
 	void updatePinnedTabsAmount();
@@ -142,16 +167,21 @@ private:
 	QPoint m_dragStartPosition;
 	QSize m_maximumTabSize;
 	QSize m_minimumTabSize;
+	CachedOption<int> m_previewsAnimationDuration;
+	CachedOption<bool> m_requiresModifierToSwitchTabOnScroll;
 	quint64 m_draggedWindow;
 	int m_tabWidth;
 	int m_clickedTab;
 	int m_hoveredTab;
 	int m_pinnedTabsAmount;
 	int m_previewTimer;
+	int m_tabHandlesTimer;
+	int m_thumbnailsTimer;
 	bool m_arePreviewsEnabled;
 	bool m_isDraggingTab;
 	bool m_isDetachingTab;
 	bool m_isIgnoringTabDrag;
+	bool m_isUpdatingTabHandles;
 	bool m_needsUpdateOnLeave;
 
 	static bool m_areThumbnailsEnabled;
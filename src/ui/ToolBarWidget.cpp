@@ -54,6 +54,7 @@ ToolBarWidget::ToolBarWidget(int identifier, Window *window, QWidget *parent) :
 	m_reloadTimer(0),
 	m_identifier(identifier),
 	m_dropIndex(-1),
+	m_areEntriesPopulated(false),
 	m_isCollapsed(false),
 	m_isInitialized(false)
 {
@@ -379,6 +380,11 @@ void ToolBarWidget::dropEvent(QDropEvent *event)
 
 void ToolBarWidget::clearEntries()
 {
+	m_entries.clear();
+	m_entryActions.clear();
+
+	m_areEntriesPopulated = false;
+
 	if (getDefinition().type == ToolBarsManager::SideBarType && m_sidebarWidget)
 	{
 		m_sidebarWidget->reload();
@@ -427,39 +433,95 @@ void ToolBarWidget::populateEntries()
 
 			break;
 		default:
-			m_addressFields.clear();
-			m_searchFields.clear();
+			updateEntries(definition.entries);
 
-			for (int i = 0; i < definition.entries.count(); ++i)
+			for (int i = 0; i < m_entryActions.count(); ++i)
 			{
-				if (definition.entries.at(i).action == QLatin1String("separator"))
+				QWidget *widget(m_entryActions.at(i) ? widgetForAction(m_entryActions.at(i)) : nullptr);
+
+				if (!widget)
 				{
-					addSeparator();
+					continue;
 				}
-				else if (definition.entries.at(i).action != QLatin1String("TabBarWidget"))
+
+				if (m_entries.at(i).action == QLatin1String("AddressWidget"))
+				{
+					m_addressFields.append(widget);
+				}
+				else if (m_entries.at(i).action == QLatin1String("SearchWidget"))
 				{
-					QWidget *widget(WidgetFactory::createToolBarItem(definition.entries.at(i), m_window, this));
+					m_searchFields.append(widget);
+				}
 
-					if (widget)
-					{
-						addWidget(widget);
+				layout()->setAlignment(widget, (isHorizontal ? Qt::AlignVCenter : Qt::AlignHCenter));
+			}
 
-						if (definition.entries.at(i).action == QLatin1String("AddressWidget"))
-						{
-							m_addressFields.append(widget);
-						}
-						else if (definition.entries.at(i).action == QLatin1String("SearchWidget"))
-						{
-							m_searchFields.append(widget);
-						}
+			break;
+	}
+}
 
-						layout()->setAlignment(widget, (isHorizontal ? Qt::AlignVCenter : Qt::AlignHCenter));
-					}
-				}
-			}
+void ToolBarWidget::updateEntries(const QVector<ToolBarsManager::ToolBarDefinition::Entry> &entries)
+{
+	int amountOfCommonLeading(0);
+	int amountOfCommonTrailing(0);
+
+	if (m_areEntriesPopulated)
+	{
+		const int amountOfCommon(qMin(m_entries.count(), entries.count()));
+
+		while (amountOfCommonLeading < amountOfCommon && m_entries.at(amountOfCommonLeading) == entries.at(amountOfCommonLeading))
+		{
+			++amountOfCommonLeading;
+		}
+
+		while (amountOfCommonTrailing < (amountOfCommon - amountOfCommonLeading) && m_entries.at(m_entries.count() - amountOfCommonTrailing - 1) == entries.at(entries.count() - amountOfCommonTrailing - 1))
+		{
+			++amountOfCommonTrailing;
+		}
+	}
+	else
+	{
+		m_entries.clear();
+		m_entryActions.clear();
+	}
+
+	QAction *before(nullptr);
+
+	for (int i = (m_entryActions.count() - amountOfCommonTrailing); i < m_entryActions.count(); ++i)
+	{
+		if (m_entryActions.at(i))
+		{
+			before = m_entryActions.at(i);
 
 			break;
+		}
+	}
+
+	for (int i = amountOfCommonLeading; i < (m_entryActions.count() - amountOfCommonTrailing); ++i)
+	{
+		QAction *action(m_entryActions.at(i));
+
+		if (action)
+		{
+			removeAction(action);
+
+			action->deleteLater();
+		}
 	}
+
+	QVector<QAction*> entryActions(m_entryActions.mid(0, amountOfCommonLeading));
+	entryActions.reserve(entries.count());
+
+	for (int i = amountOfCommonLeading; i < (entries.count() - amountOfCommonTrailing); ++i)
+	{
+		entryActions.append(insertEntry(entries.at(i), before));
+	}
+
+	entryActions += m_entryActions.mid(m_entryActions.count() - amountOfCommonTrailing);
+
+	m_entries = entries;
+	m_entryActions = entryActions;
+	m_areEntriesPopulated = true;
 }
 
 void ToolBarWidget::updateDropIndex(const QPoint &position)
@@ -842,7 +904,11 @@ void ToolBarWidget::setDefinition(const ToolBarsManager::ToolBarDefinition &defi
 
 	setVisible(shouldBeVisible(mode));
 	setOrientation((m_area != Qt::LeftToolBarArea && m_area != Qt::RightToolBarArea) ? Qt::Horizontal : Qt::Vertical);
-	clearEntries();
+
+	if (!canUpdateEntries(definition))
+	{
+		clearEntries();
+	}
 
 	if (definition.hasToggle)
 	{
@@ -877,6 +943,7 @@ void ToolBarWidget::setDefinition(const ToolBarsManager::ToolBarDefinition &defi
 
 	emit buttonStyleChanged(definition.buttonStyle);
 	emit iconSizeChanged(iconSize);
+	emit maximumButtonSizeChanged(definition.maximumButtonSize);
 
 	populateEntries();
 }
@@ -941,6 +1008,23 @@ QMenu* ToolBarWidget::createCustomizationMenu(int identifier, const QVector<QAct
 	return menu;
 }
 
+QAction* ToolBarWidget::insertEntry(const ToolBarsManager::ToolBarDefinition::Entry &entry, QAction *before)
+{
+	if (entry.action == QLatin1String("separator"))
+	{
+		return insertSeparator(before);
+	}
+
+	if (entry.action == QLatin1String("TabBarWidget"))
+	{
+		return nullptr;
+	}
+
+	QWidget *widget(WidgetFactory::createToolBarItem(entry, m_window, this));
+
+	return (widget ? insertWidget(before, widget) : nullptr);
+}
+
 QString ToolBarWidget::getTitle() const
 {
 	return getDefinition().getTitle();
@@ -1042,6 +1126,11 @@ bool ToolBarWidget::canDrop(QDropEvent *event) const
 	return (m_bookmark && event->mimeData()->hasUrls() && (event->keyboardModifiers().testFlag(Qt::ShiftModifier) || !ToolBarsManager::areToolBarsLocked()));
 }
 
+bool ToolBarWidget::canUpdateEntries(const ToolBarsManager::ToolBarDefinition &definition) const
+{
+	return (m_areEntriesPopulated && !m_isCollapsed && definition.type != ToolBarsManager::BookmarksBarType && definition.type != ToolBarsManager::SideBarType);
+}
+
 bool ToolBarWidget::isCollapsed() const
 {
 	return m_isCollapsed;
@@ -92,9 +92,12 @@ protected:
 	virtual void clearEntries();
 	virtual void populateEntries();
 	void updateDropIndex(const QPoint &position);
+	void updateEntries(const QVector<ToolBarsManager::ToolBarDefinition::Entry> &entries);
 	void updateToggleGeometry();
 	void setAddressFields(const QVector<QPointer<QWidget> > &addressFields);
 	void setSearchFields(const QVector<QPointer<QWidget> > &searchFields);
+	QAction* insertEntry(const ToolBarsManager::ToolBarDefinition::Entry &entry, QAction *before);
+	bool canUpdateEntries(const ToolBarsManager::ToolBarDefinition &definition) const;
 	bool isDragHandle(const QPoint &position) const;
 
 protected slots:
@@ -120,11 +123,14 @@ private:
 	QPoint m_dragStartPosition;
 	QVector<QPointer<QWidget> > m_addressFields;
 	QVector<QPointer<QWidget> > m_searchFields;
+	QVector<ToolBarsManager::ToolBarDefinition::Entry> m_entries;
+	QVector<QAction*> m_entryActions;
 	Session::MainWindow::ToolBarState m_state;
 	Qt::ToolBarArea m_area;
 	int m_reloadTimer;
 	int m_identifier;
 	int m_dropIndex;
+	bool m_areEntriesPopulated;
 	bool m_isCollapsed;
 	bool m_isInitialized;
 
@@ -30,6 +30,7 @@
 #include "../core/BookmarksManager.h"
 #include "../core/ContentFiltersManager.h"
 #include "../core/HandlersManager.h"
+#include "../core/HistoryContentsIndex.h"
 #include "../core/HistoryManager.h"
 #include "../core/IniSettings.h"
 #include "../core/NotesManager.h"
@@ -42,6 +43,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QPointer>
 #include <QtGui/QClipboard>
 #include <QtWidgets/QToolTip>
 
@@ -57,14 +59,18 @@ WebWidget::WebWidget(const QVariantMap &parameters, WebBackend *backend, Content
 	m_windowIdentifier(0),
 	m_loadingTime(0),
 	m_loadingTimer(0),
+	m_pageInformationTimer(0),
 	m_reloadTimer(0),
 	m_toolTipTimer(0),
-	m_toolTipEntryEnumerator(metaObject()->indexOfEnumerator(QLatin1String("ToolTipEntry").data()))
+	m_toolTipEntryEnumerator(metaObject()->indexOfEnumerator(QLatin1String("ToolTipEntry").data())),
+	m_isContentStatePending(false)
 {
 	Q_UNUSED(parameters)
 
 	connect(this, &WebWidget::loadingStateChanged, this, [&](LoadingState state)
 	{
+		flushPageInformation();
+
 		if (m_loadingTimer != 0)
 		{
 			killTimer(m_loadingTimer);
@@ -77,7 +83,11 @@ WebWidget::WebWidget(const QVariantMap &parameters, WebBackend *backend, Content
 			m_loadingTime = 0;
 			m_loadingTimer = startTimer(1000);
 
-			emit pageInformationChanged(LoadingTimeInformation, 0);
+			notifyPageInformationChanged(LoadingTimeInformation, 0);
+		}
+		else if (state == FinishedLoadingState)
+		{
+			HistoryContentsIndex::scheduleIndexing(this);
 		}
 	});
 	connect(BookmarksManager::getModel(), &BookmarksModel::modelModified, this, [&]()
@@ -96,7 +106,11 @@ void WebWidget::timerEvent(QTimerEvent *event)
 	{
 		++m_loadingTime;
 
-		emit pageInformationChanged(LoadingTimeInformation, m_loadingTime);
+		notifyPageInformationChanged(LoadingTimeInformation, m_loadingTime);
+	}
+	else if (event->timerId() == m_pageInformationTimer)
+	{
+		flushPageInformation();
 	}
 	else if (event->timerId() == m_reloadTimer)
 	{
@@ -122,6 +136,33 @@ void WebWidget::timerEvent(QTimerEvent *event)
 	}
 }
 
+void WebWidget::flushPageInformation()
+{
+	if (m_pageInformationTimer != 0)
+	{
+		killTimer(m_pageInformationTimer);
+
+		m_pageInformationTimer = 0;
+	}
+
+	const QHash<PageInformation, QVariant> pageInformation(m_pendingPageInformation);
+	QHash<PageInformation, QVariant>::const_iterator iterator;
+
+	m_pendingPageInformation.clear();
+
+	for (iterator = pageInformation.constBegin(); iterator != pageInformation.constEnd(); ++iterator)
+	{
+		emit pageInformationChanged(iterator.key(), iterator.value());
+	}
+
+	if (m_isContentStatePending)
+	{
+		m_isContentStatePending = false;
+
+		emit contentStateChanged(getContentState());
+	}
+}
+
 void WebWidget::triggerAction(int identifier, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
 {
 	Q_UNUSED(identifier)
@@ -135,6 +176,12 @@ void WebWidget::search(const QString &query, const QString &searchEngine)
 	Q_UNUSED(searchEngine)
 }
 
+void WebWidget::preconnect(const QUrl &url, bool canPrefetch)
+{
+	Q_UNUSED(url)
+	Q_UNUSED(canPrefetch)
+}
+
 void WebWidget::startWatchingChanges(QObject *object, ChangeWatcher watcher)
 {
 	if (!m_changeWatchers.contains(watcher))
@@ -293,13 +340,23 @@ void WebWidget::openUrl(const QUrl &url, SessionsManager::OpenHints hints)
 
 void WebWidget::handleToolTipEvent(QHelpEvent *event, QWidget *widget)
 {
-	const HitTestResult hitResult(getHitTestResult(event->pos()));
+	const QPoint position(event->globalPos());
+	const QPointer<QWidget> parentWidget(widget);
+
+	event->accept();
+
+	requestHitTestResult(event->pos(), [=](const HitTestResult &hitResult)
+	{
+		showHitTestToolTip(hitResult, position, parentWidget.data());
+	});
+}
+
+void WebWidget::showHitTestToolTip(const HitTestResult &hitResult, const QPoint &position, QWidget *widget)
+{
 	const QUrl link(hitResult.linkUrl.isValid() ? hitResult.linkUrl : hitResult.formUrl);
 
 	setStatusMessageOverride(link.isEmpty() ? hitResult.title : link.toString());
 
-	event->accept();
-
 	if (!SettingsManager::getOption(SettingsManager::Interface_EnableToolTipsOption).toBool())
 	{
 		return;
@@ -385,7 +442,7 @@ void WebWidget::handleToolTipEvent(QHelpEvent *event, QWidget *widget)
 	{
 		m_toolTipParentWidget = widget;
 		m_toolTipRectangle = hitResult.elementGeometry;
-		m_toolTipPosition = event->globalPos();
+		m_toolTipPosition = position;
 		m_toolTipTimer = startTimer(style()->styleHint(QStyle::SH_ToolTip_WakeUpDelay));
 	}
 	else if (m_toolTipTimer != 0 && m_toolTip.isEmpty())
@@ -446,11 +503,41 @@ void WebWidget::notifyRedoActionStateChanged()
 	emit arbitraryActionsStateChanged({ActionsManager::RedoAction});
 }
 
+void WebWidget::notifyContentStateChanged()
+{
+	m_isContentStatePending = true;
+
+	if (m_pageInformationTimer == 0)
+	{
+		m_pageInformationTimer = startTimer(16);
+	}
+}
+
+void WebWidget::notifyPageInformationChanged(PageInformation key, const QVariant &value)
+{
+	m_pendingPageInformation[key] = value;
+
+	if (m_pageInformationTimer == 0)
+	{
+		m_pageInformationTimer = startTimer(16);
+	}
+}
+
 void WebWidget::notifyUndoActionStateChanged()
 {
 	emit arbitraryActionsStateChanged({ActionsManager::UndoAction});
 }
 
+void WebWidget::requestHitTestResult(const QPoint &position, const std::function<void(const HitTestResult &hitResult)> &callback)
+{
+	callback(getHitTestResult(position));
+}
+
+void WebWidget::requestDocumentText(const std::function<void(const QString &text)> &callback)
+{
+	callback({});
+}
+
 void WebWidget::updateHitTestResult(const QPoint &position)
 {
 	m_hitResult = getHitTestResult(position);
@@ -485,7 +572,15 @@ void WebWidget::showContextMenu(const QPoint &position)
 		return;
 	}
 
-	updateHitTestResult(hitPosition);
+	requestHitTestResult(hitPosition, [=](const HitTestResult &hitResult)
+	{
+		showHitTestContextMenu(hitResult, hitPosition, hasSelection);
+	});
+}
+
+void WebWidget::showHitTestContextMenu(const HitTestResult &hitResult, const QPoint &position, bool hasSelection)
+{
+	m_hitResult = hitResult;
 
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::EditingCategory});
 
@@ -563,7 +658,7 @@ void WebWidget::showContextMenu(const QPoint &position)
 
 	Menu menu(this);
 	menu.load(QLatin1String("menu/webWidget.json"), includeSections, executor);
-	menu.exec(mapToGlobal(hitPosition));
+	menu.exec(mapToGlobal(position));
 }
 
 void WebWidget::setParent(QWidget *parent)
@@ -682,7 +777,7 @@ void WebWidget::setOption(int identifier, const QVariant &value)
 		m_options[identifier] = value;
 	}
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 
 	switch (identifier)
 	{
@@ -769,6 +864,11 @@ void WebWidget::setOptions(const QHash<int, QVariant> &options, const QStringLis
 	emit arbitraryActionsStateChanged({ActionsManager::ResetQuickPreferencesAction});
 }
 
+void WebWidget::setThrottled(bool isThrottled)
+{
+	Q_UNUSED(isThrottled)
+}
+
 void WebWidget::setRequestedUrl(const QUrl &url, bool isTypedIn, bool updateOnly)
 {
 	m_requestedUrl = url;
@@ -1021,6 +1121,13 @@ QPixmap WebWidget::createThumbnail(const QSize &size)
 	return {};
 }
 
+PrintJob* WebWidget::createPrintJob(QPrinter *printer)
+{
+	Q_UNUSED(printer)
+
+	return nullptr;
+}
+
 QPoint WebWidget::getClickPosition() const
 {
 	return m_clickPosition;
@@ -1529,6 +1636,16 @@ QVector<NetworkManager::ResourceInformation> WebWidget::getBlockedRequests() con
 	return {};
 }
 
+QHash<int, int> WebWidget::getBlockedProfilesAmounts() const
+{
+	return {};
+}
+
+QVector<NetworkManager::RequestTiming> WebWidget::getRequestTimings() const
+{
+	return {};
+}
+
 QHash<int, QVariant> WebWidget::getOptions() const
 {
 	return m_options;
@@ -1793,6 +1910,11 @@ bool WebWidget::isFullScreen() const
 	return false;
 }
 
+bool WebWidget::isModified() const
+{
+	return false;
+}
+
 bool WebWidget::isWatchingChanges(ChangeWatcher watcher) const
 {
 	return m_changeWatchers.contains(watcher);
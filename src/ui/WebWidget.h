@@ -36,11 +36,14 @@
 #include <QtPrintSupport/QPrinter>
 #include <QtWidgets/QWidget>
 
+#include <functional>
+
 namespace Otter
 {
 
 class ContentsDialog;
 class ContentsWidget;
+class PrintJob;
 class Transfer;
 class WebBackend;
 
@@ -139,7 +142,8 @@ public:
 		LoadingSpeedInformation,
 		LoadingFinishedInformation,
 		LoadingTimeInformation,
-		LoadingMessageInformation
+		LoadingMessageInformation,
+		ContentFilteringTimeInformation
 	};
 
 	enum ToolTipEntry
@@ -207,12 +211,16 @@ public:
 	};
 
 	virtual void search(const QString &query, const QString &searchEngine);
+	virtual void preconnect(const QUrl &url, bool canPrefetch = false);
 	virtual void print(QPrinter *printer) = 0;
+	virtual void requestHitTestResult(const QPoint &position, const std::function<void(const HitTestResult &hitResult)> &callback);
+	virtual void requestDocumentText(const std::function<void(const QString &text)> &callback);
 	void startWatchingChanges(QObject *object, ChangeWatcher watcher);
 	void stopWatchingChanges(QObject *object, ChangeWatcher watcher);
 	void showDialog(ContentsDialog *dialog, bool lockEventLoop = true);
 	void setParent(QWidget *parent);
 	virtual void setOptions(const QHash<int, QVariant> &options, const QStringList &excludedOptions = {});
+	virtual void setThrottled(bool isThrottled);
 	void setWindowIdentifier(quint64 identifier);
 	virtual WebWidget* clone(bool cloneHistory = true, bool isPrivate = false, const QStringList &excludedOptions = {}) const = 0;
 	virtual QWidget* getInspector();
@@ -230,6 +238,7 @@ public:
 	QUrl getRequestedUrl() const;
 	virtual QIcon getIcon() const = 0;
 	virtual QPixmap createThumbnail(const QSize &size = {});
+	virtual PrintJob* createPrintJob(QPrinter *printer);
 	QPoint getClickPosition() const;
 	virtual QPoint getScrollPosition() const = 0;
 	virtual QRect getGeometry(bool excludeScrollBars = false) const;
@@ -247,6 +256,8 @@ public:
 	virtual QVector<LinkUrl> getLinks() const;
 	virtual QVector<LinkUrl> getSearchEngines() const;
 	virtual QVector<NetworkManager::ResourceInformation> getBlockedRequests() const;
+	virtual QVector<NetworkManager::RequestTiming> getRequestTimings() const;
+	virtual QHash<int, int> getBlockedProfilesAmounts() const;
 	QHash<int, QVariant> getOptions() const;
 	virtual QMap<QByteArray, QByteArray> getHeaders() const;
 	virtual QMultiMap<QString, QString> getMetaData() const;
@@ -260,6 +271,7 @@ public:
 	virtual bool isAudible() const;
 	virtual bool isAudioMuted() const;
 	virtual bool isFullScreen() const;
+	virtual bool isModified() const;
 	virtual bool isPrivate() const = 0;
 	bool isWatchingChanges(ChangeWatcher watcher) const;
 
@@ -282,10 +294,13 @@ protected:
 	explicit WebWidget(const QVariantMap &parameters, WebBackend *backend, ContentsWidget *parent = nullptr);
 
 	void timerEvent(QTimerEvent *event) override;
+	void flushPageInformation();
 	void openUrl(const QUrl &url, SessionsManager::OpenHints hints);
 	void startReloadTimer();
 	void startTransfer(Transfer *transfer);
 	void handleToolTipEvent(QHelpEvent *event, QWidget *widget);
+	void showHitTestContextMenu(const HitTestResult &hitResult, const QPoint &position, bool hasSelection);
+	void showHitTestToolTip(const HitTestResult &hitResult, const QPoint &position, QWidget *widget);
 	void updateHitTestResult(const QPoint &position);
 	virtual void updateWatchedData(ChangeWatcher watcher);
 	void setClickPosition(const QPoint &position);
@@ -313,6 +328,8 @@ protected:
 
 protected slots:
 	void handleWindowCloseRequest();
+	void notifyContentStateChanged();
+	void notifyPageInformationChanged(PageInformation key, const QVariant &value);
 	void notifyRedoActionStateChanged();
 	void notifyUndoActionStateChanged();
 	void setStatusMessage(const QString &message);
@@ -330,14 +347,17 @@ private:
 	QPoint m_toolTipPosition;
 	QStringList m_toolTip;
 	QHash<int, QVariant> m_options;
+	QHash<PageInformation, QVariant> m_pendingPageInformation;
 	QHash<ChangeWatcher, QVector<QObject*> > m_changeWatchers;
 	HitTestResult m_hitResult;
 	quint64 m_windowIdentifier;
 	int m_loadingTime;
 	int m_loadingTimer;
+	int m_pageInformationTimer;
 	int m_reloadTimer;
 	int m_toolTipTimer;
 	int m_toolTipEntryEnumerator;
+	bool m_isContentStatePending;
 
 	static QString m_fastForwardScript;
 
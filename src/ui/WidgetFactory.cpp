@@ -50,6 +50,7 @@
 #include "../modules/windows/notes/NotesContentsWidget.h"
 #include "../modules/windows/pageInformation/PageInformationContentsWidget.h"
 #include "../modules/windows/passwords/PasswordsContentsWidget.h"
+#include "../modules/windows/performance/PerformanceContentsWidget.h"
 #include "../modules/windows/preferences/PreferencesContentsWidget.h"
 #include "../modules/windows/tabHistory/TabHistoryContentsWidget.h"
 #include "../modules/windows/transfers/TransfersContentsWidget.h"
@@ -260,6 +261,11 @@ ContentsWidget* createContentsWidget(const QString &identifier, const QVariantMa
 		return new PasswordsContentsWidget(parameters, window, parent);
 	}
 
+	if (identifier == QLatin1String("performance"))
+	{
+		return new PerformanceContentsWidget(parameters, window, parent);
+	}
+
 	if (identifier == QLatin1String("preferences"))
 	{
 		return new PreferencesContentsWidget(parameters, window, parent);
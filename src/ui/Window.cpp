@@ -30,6 +30,7 @@
 #include "../modules/widgets/search/SearchWidget.h"
 #include "../modules/windows/web/WebContentsWidget.h"
 
+#include <QtCore/QBuffer>
 #include <QtCore/QTimer>
 #include <QtGui/QPainter>
 #include <QtWidgets/QBoxLayout>
@@ -63,11 +64,14 @@ Window::Window(const QVariantMap &parameters, ContentsWidget *widget, MainWindow
 	m_mainWindow(mainWindow),
 	m_addressBarWidget(nullptr),
 	m_contentsWidget(nullptr),
+	m_snapshotLabel(nullptr),
 	m_parameters(parameters),
 	m_identifier(++m_identifierCounter),
+	m_snapshotTimer(0),
 	m_suspendTimer(0),
 	m_isAboutToClose(false),
-	m_isPinned(false)
+	m_isPinned(false),
+	m_isSuspended(false)
 {
 	QBoxLayout *layout(new QBoxLayout(QBoxLayout::TopToBottom, this));
 	layout->setContentsMargins(0, 0, 0, 0);
@@ -94,6 +98,10 @@ void Window::timerEvent(QTimerEvent *event)
 
 		triggerAction(ActionsManager::SuspendTabAction);
 	}
+	else if (event->timerId() == m_snapshotTimer)
+	{
+		hideSnapshot();
+	}
 }
 
 void Window::hideEvent(QHideEvent *event)
@@ -122,6 +130,16 @@ void Window::focusInEvent(QFocusEvent *event)
 	updateFocus();
 }
 
+void Window::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+
+	if (m_snapshotLabel && m_contentsWidget)
+	{
+		m_snapshotLabel->setGeometry(m_contentsWidget->geometry());
+	}
+}
+
 void Window::triggerAction(int identifier, const QVariantMap &parameters, ActionsManager::TriggerType trigger)
 {
 	switch (identifier)
@@ -157,11 +175,20 @@ void Window::triggerAction(int identifier, const QVariantMap &parameters, Action
 
 			break;
 		case ActionsManager::SuspendTabAction:
-			if (!m_contentsWidget || m_contentsWidget->close())
 			{
+				const QByteArray snapshot(m_contentsWidget ? createSnapshot() : QByteArray());
+
+				if (m_contentsWidget && !m_contentsWidget->close())
+				{
+					break;
+				}
+
 				m_session = getSession();
+				m_snapshot = snapshot;
 
 				setContentsWidget(nullptr);
+
+				m_isSuspended = true;
 			}
 
 			break;
@@ -246,6 +273,7 @@ void Window::markAsActive(bool updateLastActivity)
 	if (!m_contentsWidget)
 	{
 		setUrl(m_session.getUrl(), false);
+		showSnapshot();
 	}
 
 	if (updateLastActivity)
@@ -334,7 +362,7 @@ void Window::setOption(int identifier, const QVariant &value)
 			m_session.options[identifier] = value;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit optionChanged(identifier, value);
 	}
@@ -397,6 +425,63 @@ void Window::setUrl(const QUrl &url, bool isTypedIn)
 	}
 }
 
+void Window::showSnapshot()
+{
+	const QByteArray snapshot(m_snapshot);
+
+	m_snapshot.clear();
+
+	if (snapshot.isEmpty() || !m_contentsWidget || m_contentsWidget->getLoadingState() != WebWidget::OngoingLoadingState)
+	{
+		return;
+	}
+
+	QPixmap pixmap;
+
+	if (!pixmap.loadFromData(snapshot, "JPG"))
+	{
+		return;
+	}
+
+	hideSnapshot();
+
+	layout()->activate();
+
+	m_snapshotLabel = new QLabel(this);
+	m_snapshotLabel->setPixmap(pixmap);
+	m_snapshotLabel->setScaledContents(true);
+	m_snapshotLabel->setGeometry(m_contentsWidget->geometry());
+	m_snapshotLabel->show();
+	m_snapshotLabel->raise();
+
+	m_snapshotTimer = startTimer(SnapshotTimeout);
+
+	connect(m_contentsWidget, &ContentsWidget::loadingStateChanged, m_snapshotLabel, [&](WebWidget::LoadingState state)
+	{
+		if (state != WebWidget::OngoingLoadingState)
+		{
+			hideSnapshot();
+		}
+	});
+}
+
+void Window::hideSnapshot()
+{
+	if (m_snapshotTimer != 0)
+	{
+		killTimer(m_snapshotTimer);
+
+		m_snapshotTimer = 0;
+	}
+
+	if (m_snapshotLabel)
+	{
+		m_snapshotLabel->hide();
+		m_snapshotLabel->deleteLater();
+		m_snapshotLabel = nullptr;
+	}
+}
+
 void Window::setZoom(int zoom)
 {
 	if (m_contentsWidget)
@@ -430,6 +515,7 @@ void Window::setContentsWidget(ContentsWidget *widget)
 	}
 
 	m_contentsWidget = widget;
+	m_isSuspended = false;
 
 	if (!m_contentsWidget)
 	{
@@ -592,6 +678,24 @@ QIcon Window::getIcon() const
 	return ((m_contentsWidget && !m_isAboutToClose) ? m_contentsWidget->getIcon() : HistoryManager::getIcon(m_session.getUrl()));
 }
 
+QByteArray Window::createSnapshot() const
+{
+	const QPixmap pixmap(m_contentsWidget->grab());
+
+	if (pixmap.isNull())
+	{
+		return {};
+	}
+
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+
+	pixmap.scaled((pixmap.size() / 2), Qt::IgnoreAspectRatio, Qt::SmoothTransformation).save(&buffer, "JPG", 80);
+
+	return data;
+}
+
 QPixmap Window::createThumbnail() const
 {
 	return ((m_contentsWidget && !m_isAboutToClose) ? m_contentsWidget->createThumbnail() : QPixmap());
@@ -764,4 +868,9 @@ bool Window::isPrivate() const
 	return ((m_contentsWidget && !m_isAboutToClose) ? m_contentsWidget->isPrivate() : SessionsManager::calculateOpenHints(m_parameters).testFlag(SessionsManager::PrivateOpen));
 }
 
+bool Window::isSuspended() const
+{
+	return (m_isSuspended && !m_contentsWidget);
+}
+
 }
@@ -29,6 +29,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
 #include <QtGui/QIcon>
+#include <QtWidgets/QLabel>
 
 namespace Otter
 {
@@ -81,6 +82,7 @@ public:
 	bool isActive() const;
 	bool isPinned() const;
 	bool isPrivate() const;
+	bool isSuspended() const;
 
 public slots:
 	void triggerAction(int identifier, const QVariantMap &parameters = {}, ActionsManager::TriggerType trigger = ActionsManager::UnknownTrigger) override;
@@ -92,11 +94,20 @@ public slots:
 	void setPinned(bool isPinned);
 
 protected:
+	enum SnapshotParameter
+	{
+		SnapshotTimeout = 10000
+	};
+
 	void timerEvent(QTimerEvent *event) override;
 	void hideEvent(QHideEvent *event) override;
 	void focusInEvent(QFocusEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+	void showSnapshot();
+	void hideSnapshot();
 	void updateFocus();
 	void setContentsWidget(ContentsWidget *widget);
+	QByteArray createSnapshot() const;
 
 protected slots:
 	void handleSearchRequest(const QString &query, const QString &searchEngine, SessionsManager::OpenHints hints = SessionsManager::DefaultOpen);
@@ -109,13 +120,17 @@ private:
 	MainWindow *m_mainWindow;
 	WindowToolBarWidget *m_addressBarWidget;
 	QPointer<ContentsWidget> m_contentsWidget;
+	QLabel *m_snapshotLabel;
+	QByteArray m_snapshot;
 	QDateTime m_lastActivity;
 	Session::Window m_session;
 	QVariantMap m_parameters;
 	quint64 m_identifier;
+	int m_snapshotTimer;
 	int m_suspendTimer;
 	bool m_isAboutToClose;
 	bool m_isPinned;
+	bool m_isSuspended;
 
 	static quint64 m_identifierCounter;
 